@@ -1,11 +1,19 @@
+use async_trait::async_trait;
 use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
 use rvoip_infra_common::events::api::EventSystem;
 use rvoip_infra_common::events::builder::{EventSystemBuilder, ImplementationType};
+use rvoip_infra_common::events::coordinator::CrossCrateEventHandler;
+use rvoip_infra_common::events::cross_crate::{CrossCrateEvent, EventTypeId};
 use rvoip_infra_common::events::registry::GlobalTypeRegistry;
 use rvoip_infra_common::events::types::{Event, EventPriority, StaticEvent};
+use rvoip_infra_common::events::{
+    EventCoordinatorConfig, GlobalEventCoordinator, HandlerDispatch, HandlerQueueConfig,
+    OverflowPolicy,
+};
+use rvoip_infra_common::planes::PlaneType;
 use serde::{Deserialize, Serialize};
 use std::sync::Arc;
-use std::time::Duration;
+use std::time::{Duration, Instant};
 use tokio::runtime::Runtime;
 
 // --- Common benchmark configuration ---
@@ -261,5 +269,102 @@ fn bench_api_static_fast_path(c: &mut Criterion) {
     group.finish();
 }
 
-criterion_group!(benches, bench_api_zero_copy, bench_api_static_fast_path);
+/// Cross-crate event used by the coordinator benchmark
+#[derive(Debug)]
+struct CoordinatorBenchEvent;
+
+impl CrossCrateEvent for CoordinatorBenchEvent {
+    fn event_type(&self) -> EventTypeId {
+        "bench_coordinator"
+    }
+
+    fn source_plane(&self) -> PlaneType {
+        PlaneType::Signaling
+    }
+
+    fn target_plane(&self) -> PlaneType {
+        PlaneType::Signaling
+    }
+
+    fn priority(&self) -> EventPriority {
+        EventPriority::Normal
+    }
+
+    fn as_any(&self) -> &dyn std::any::Any {
+        self
+    }
+}
+
+/// Handler that takes 1ms per event, like an audit sink on a slow disk
+struct SlowHandler;
+
+#[async_trait]
+impl CrossCrateEventHandler for SlowHandler {
+    async fn handle(&self, event: Arc<dyn CrossCrateEvent>) -> anyhow::Result<()> {
+        black_box(event);
+        tokio::time::sleep(Duration::from_millis(1)).await;
+        Ok(())
+    }
+}
+
+/// Benchmarks the time from `GlobalEventCoordinator::publish` until a
+/// subscriber receives the event while a slow handler is registered
+fn bench_api_coordinator_slow_handler(c: &mut Criterion) {
+    let rt = Runtime::new().unwrap();
+
+    let mut group = c.benchmark_group("api_coordinator_publish_to_subscriber");
+    group.measurement_time(Duration::from_secs(10));
+    group.sample_size(20);
+
+    // The slow handler keeps up with 1000 events/s, so a blocking queue
+    // would fill during warm-up; dropping keeps this about the subscriber.
+    let queue = HandlerQueueConfig::default().with_overflow(OverflowPolicy::Drop);
+    let modes = [
+        ("inline", HandlerDispatch::Inline),
+        ("queued_drop", HandlerDispatch::Queued(queue)),
+    ];
+
+    for (name, dispatch) in modes {
+        group.throughput(Throughput::Elements(1));
+        let (coordinator, mut subscriber) = rt.block_on(async {
+            let coordinator = GlobalEventCoordinator::new(EventCoordinatorConfig::monolithic())
+                .await
+                .unwrap();
+            coordinator
+                .register_handler_with("bench_coordinator", SlowHandler, dispatch)
+                .await
+                .unwrap();
+            let subscriber = coordinator.subscribe("bench_coordinator").await.unwrap();
+            (coordinator, subscriber)
+        });
+
+        group.bench_function(BenchmarkId::from_parameter(name), |b| {
+            b.iter_custom(|iters| {
+                rt.block_on(async {
+                    let mut total = Duration::ZERO;
+                    for _ in 0..iters {
+                        let started = Instant::now();
+                        coordinator
+                            .publish(Arc::new(CoordinatorBenchEvent))
+                            .await
+                            .unwrap();
+                        black_box(subscriber.recv().await.unwrap());
+                        total += started.elapsed();
+                    }
+                    total
+                })
+            });
+        });
+        rt.block_on(coordinator.shutdown()).unwrap();
+    }
+
+    group.finish();
+}
+
+criterion_group!(
+    benches,
+    bench_api_zero_copy,
+    bench_api_static_fast_path,
+    bench_api_coordinator_slow_handler
+);
 criterion_main!(benches);
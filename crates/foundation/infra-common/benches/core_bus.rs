@@ -2,11 +2,18 @@ use async_trait::async_trait;
 use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
 use rvoip_infra_common::events::bus::Publisher;
 use rvoip_infra_common::events::bus::{EventBus, EventBusConfig};
+use rvoip_infra_common::events::coordinator::CrossCrateEventHandler;
+use rvoip_infra_common::events::cross_crate::{CrossCrateEvent, EventTypeId};
 use rvoip_infra_common::events::publisher::FastPublisher;
 use rvoip_infra_common::events::types::{Event, EventHandler, EventPriority, StaticEvent};
+use rvoip_infra_common::events::{
+    EventCoordinatorConfig, GlobalEventCoordinator, HandlerDispatch, HandlerQueueConfig,
+    OverflowPolicy,
+};
+use rvoip_infra_common::planes::PlaneType;
 use serde::{Deserialize, Serialize};
 use std::sync::Arc;
-use std::time::Duration;
+use std::time::{Duration, Instant};
 use tokio::runtime::Runtime;
 
 // --- Common benchmark configuration ---
@@ -570,6 +577,102 @@ fn bench_batch_processing(c: &mut Criterion) {
     group.finish();
 }
 
+/// Cross-crate event used by the coordinator benchmarks
+#[derive(Debug)]
+struct CoordinatorBenchEvent;
+
+impl CrossCrateEvent for CoordinatorBenchEvent {
+    fn event_type(&self) -> EventTypeId {
+        "bench_coordinator"
+    }
+
+    fn source_plane(&self) -> PlaneType {
+        PlaneType::Signaling
+    }
+
+    fn target_plane(&self) -> PlaneType {
+        PlaneType::Signaling
+    }
+
+    fn priority(&self) -> EventPriority {
+        EventPriority::Normal
+    }
+
+    fn as_any(&self) -> &dyn std::any::Any {
+        self
+    }
+}
+
+/// Handler that sleeps before returning, like an audit sink on a slow disk
+struct SlowHandler {
+    delay: Duration,
+}
+
+#[async_trait]
+impl CrossCrateEventHandler for SlowHandler {
+    async fn handle(&self, event: Arc<dyn CrossCrateEvent>) -> anyhow::Result<()> {
+        black_box(event);
+        if !self.delay.is_zero() {
+            tokio::time::sleep(self.delay).await;
+        }
+        Ok(())
+    }
+}
+
+/// Benchmarks `GlobalEventCoordinator::publish` with one fast and one
+/// deliberately slow (1ms) handler registered, per dispatch mode
+fn bench_coordinator_slow_handler(c: &mut Criterion) {
+    let rt = Runtime::new().unwrap();
+
+    let mut group = c.benchmark_group("coordinator_publish_slow_handler");
+    group.measurement_time(Duration::from_secs(10));
+    group.sample_size(20);
+
+    let queue = HandlerQueueConfig::default().with_capacity(CHANNEL_CAPACITY);
+    let modes = [
+        ("inline", HandlerDispatch::Inline),
+        ("queued_block", HandlerDispatch::Queued(queue)),
+        (
+            "queued_drop",
+            HandlerDispatch::Queued(queue.with_overflow(OverflowPolicy::Drop)),
+        ),
+    ];
+
+    for (name, dispatch) in modes {
+        group.throughput(Throughput::Elements(1));
+        let coordinator = rt.block_on(async {
+            let coordinator = GlobalEventCoordinator::new(EventCoordinatorConfig::monolithic())
+                .await
+                .unwrap();
+            for delay in [Duration::ZERO, Duration::from_millis(1)] {
+                coordinator
+                    .register_handler_with("bench_coordinator", SlowHandler { delay }, dispatch)
+                    .await
+                    .unwrap();
+            }
+            coordinator
+        });
+
+        group.bench_function(BenchmarkId::from_parameter(name), |b| {
+            b.iter_custom(|iters| {
+                rt.block_on(async {
+                    let started = Instant::now();
+                    for _ in 0..iters {
+                        coordinator
+                            .publish(Arc::new(CoordinatorBenchEvent))
+                            .await
+                            .unwrap();
+                    }
+                    started.elapsed()
+                })
+            });
+        });
+        rt.block_on(coordinator.shutdown()).unwrap();
+    }
+
+    group.finish();
+}
+
 criterion_group!(
     benches,
     bench_event_bus_single_publisher,
@@ -577,7 +680,8 @@ criterion_group!(
     bench_event_priority,
     bench_zero_copy_event_bus,
     bench_static_event_fast_path,
-    bench_batch_processing
+    bench_batch_processing,
+    bench_coordinator_slow_handler
 );
 criterion_main!(benches);
 
@@ -0,0 +1,72 @@
+//! CPU affinity helpers for dedicated worker threads
+//!
+//! Thread pools that pin their workers (media transcoding workers,
+//! transaction shards) pick cores from the process's own affinity mask, so
+//! a process confined by `taskset`, cpusets or a container CPU limit never
+//! pins a thread to a core it may not run on. Pinning is only implemented
+//! on Linux; elsewhere no cores are reported and pinning is a no-op.
+
+/// CPUs this process may run on, in ascending order. Empty when the mask
+/// cannot be read or the platform has no affinity API.
+#[cfg(target_os = "linux")]
+pub fn allowed_cores() -> Vec<usize> {
+    // SAFETY: an all-zero `cpu_set_t` is a valid empty set, and
+    // `sched_getaffinity` writes at most `size_of::<cpu_set_t>()` bytes.
+    unsafe {
+        let mut set: libc::cpu_set_t = std::mem::zeroed();
+        if libc::sched_getaffinity(0, std::mem::size_of::<libc::cpu_set_t>(), &mut set) != 0 {
+            return Vec::new();
+        }
+        (0..libc::CPU_SETSIZE as usize)
+            .filter(|&cpu| libc::CPU_ISSET(cpu, &set))
+            .collect()
+    }
+}
+
+/// CPUs this process may run on, in ascending order. Empty when the mask
+/// cannot be read or the platform has no affinity API.
+#[cfg(not(target_os = "linux"))]
+pub fn allowed_cores() -> Vec<usize> {
+    Vec::new()
+}
+
+/// Pin the calling thread to `core`, one of [`allowed_cores`]
+#[cfg(target_os = "linux")]
+pub fn pin_current_thread(core: usize) -> std::io::Result<()> {
+    if core >= libc::CPU_SETSIZE as usize {
+        return Err(std::io::Error::from(std::io::ErrorKind::InvalidInput));
+    }
+    // SAFETY: `set` is a valid `cpu_set_t` and `core` is below
+    // CPU_SETSIZE; sched_setaffinity(0, ..) affects only this thread.
+    let rc = unsafe {
+        let mut set: libc::cpu_set_t = std::mem::zeroed();
+        libc::CPU_SET(core, &mut set);
+        libc::sched_setaffinity(0, std::mem::size_of::<libc::cpu_set_t>(), &set)
+    };
+    if rc != 0 {
+        return Err(std::io::Error::last_os_error());
+    }
+    Ok(())
+}
+
+/// Pin the calling thread to `core`, one of [`allowed_cores`]
+#[cfg(not(target_os = "linux"))]
+pub fn pin_current_thread(_core: usize) -> std::io::Result<()> {
+    Ok(())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_pin_to_an_allowed_core() {
+        let cores = allowed_cores();
+        if let Some(&core) = cores.last() {
+            std::thread::spawn(move || pin_current_thread(core))
+                .join()
+                .expect("pinning thread")
+                .expect("pin to allowed core");
+        }
+    }
+}
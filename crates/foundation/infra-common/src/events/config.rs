@@ -15,6 +15,10 @@ pub struct EventCoordinatorConfig {
     pub service_name: String,
     /// Capacity for global event broadcast and subscription bridge channels.
     pub channel_capacity: usize,
+    /// How registered handlers run when an event is published, unless a
+    /// handler is registered with its own dispatch.
+    #[serde(default)]
+    pub handler_dispatch: HandlerDispatch,
 }
 
 impl Default for EventCoordinatorConfig {
@@ -23,10 +27,72 @@ impl Default for EventCoordinatorConfig {
             deployment: DeploymentConfig::Monolithic,
             service_name: "rvoip-monolithic".to_string(),
             channel_capacity: 10_000,
+            handler_dispatch: HandlerDispatch::Inline,
         }
     }
 }
 
+/// How `GlobalEventCoordinator::publish` runs a registered handler
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq, Serialize, Deserialize)]
+#[serde(tag = "mode", rename_all = "lowercase")]
+pub enum HandlerDispatch {
+    /// Await the handler inside `publish`, one handler after another.
+    /// `publish` returns once every handler has run.
+    #[default]
+    Inline,
+    /// Hand the event to the handler's own bounded queue, drained by its
+    /// own tasks. A slow handler then only delays its own queue.
+    Queued(HandlerQueueConfig),
+}
+
+/// Per-handler queue used by [`HandlerDispatch::Queued`]
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Serialize, Deserialize)]
+pub struct HandlerQueueConfig {
+    /// Events that may wait for the handler.
+    pub capacity: usize,
+    /// Events the handler processes at once. 1 keeps events in publish order.
+    pub concurrency: usize,
+    /// What `publish` does when the queue is full.
+    pub overflow: OverflowPolicy,
+}
+
+impl Default for HandlerQueueConfig {
+    fn default() -> Self {
+        Self {
+            capacity: 1024,
+            concurrency: 1,
+            overflow: OverflowPolicy::Block,
+        }
+    }
+}
+
+impl HandlerQueueConfig {
+    pub fn with_capacity(mut self, capacity: usize) -> Self {
+        self.capacity = capacity.max(1);
+        self
+    }
+
+    pub fn with_concurrency(mut self, concurrency: usize) -> Self {
+        self.concurrency = concurrency.max(1);
+        self
+    }
+
+    pub fn with_overflow(mut self, overflow: OverflowPolicy) -> Self {
+        self.overflow = overflow;
+        self
+    }
+}
+
+/// Behaviour of a full handler queue
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Serialize, Deserialize)]
+#[serde(rename_all = "lowercase")]
+pub enum OverflowPolicy {
+    /// `publish` waits for room, pushing back on the publisher.
+    Block,
+    /// The event is dropped for this handler and counted.
+    Drop,
+}
+
 /// Deployment configuration
 #[derive(Debug, Clone, Serialize, Deserialize)]
 pub enum DeploymentConfig {
@@ -130,6 +196,7 @@ impl EventCoordinatorConfig {
             },
             service_name: service_name.into(),
             channel_capacity: 10_000,
+            handler_dispatch: HandlerDispatch::Inline,
         }
     }
 
@@ -139,6 +206,12 @@ impl EventCoordinatorConfig {
         self
     }
 
+    /// Set how handlers registered without their own dispatch run.
+    pub fn with_handler_dispatch(mut self, dispatch: HandlerDispatch) -> Self {
+        self.handler_dispatch = dispatch;
+        self
+    }
+
     /// Load configuration from environment variables
     pub fn from_env() -> Result<Self, ConfigError> {
         // Check if distributed mode is enabled
@@ -155,6 +228,7 @@ impl EventCoordinatorConfig {
         {
             config.channel_capacity = capacity.max(1);
         }
+        config.handler_dispatch = handler_dispatch_from_env()?;
 
         Ok(config)
     }
@@ -179,6 +253,39 @@ fn env_usize(name: &str) -> Option<usize> {
     std::env::var(name).ok().and_then(|s| s.parse().ok())
 }
 
+/// `RVOIP_EVENT_HANDLER_DISPATCH=inline|queued`, with the queue shaped by
+/// `RVOIP_EVENT_HANDLER_QUEUE_CAPACITY`, `RVOIP_EVENT_HANDLER_CONCURRENCY`
+/// and `RVOIP_EVENT_HANDLER_OVERFLOW=block|drop`.
+fn handler_dispatch_from_env() -> Result<HandlerDispatch, ConfigError> {
+    let mode = std::env::var("RVOIP_EVENT_HANDLER_DISPATCH").unwrap_or_default();
+    match mode.to_ascii_lowercase().as_str() {
+        "" | "inline" => Ok(HandlerDispatch::Inline),
+        "queued" => {
+            let mut queue = HandlerQueueConfig::default();
+            if let Some(capacity) = env_usize("RVOIP_EVENT_HANDLER_QUEUE_CAPACITY") {
+                queue = queue.with_capacity(capacity);
+            }
+            if let Some(concurrency) = env_usize("RVOIP_EVENT_HANDLER_CONCURRENCY") {
+                queue = queue.with_concurrency(concurrency);
+            }
+            let overflow = std::env::var("RVOIP_EVENT_HANDLER_OVERFLOW").unwrap_or_default();
+            match overflow.to_ascii_lowercase().as_str() {
+                "" | "block" => {}
+                "drop" => queue = queue.with_overflow(OverflowPolicy::Drop),
+                other => {
+                    return Err(ConfigError::Parse(format!(
+                        "RVOIP_EVENT_HANDLER_OVERFLOW must be block or drop, got {other}"
+                    )))
+                }
+            }
+            Ok(HandlerDispatch::Queued(queue))
+        }
+        other => Err(ConfigError::Parse(format!(
+            "RVOIP_EVENT_HANDLER_DISPATCH must be inline or queued, got {other}"
+        ))),
+    }
+}
+
 /// Configuration errors
 #[derive(Debug, thiserror::Error)]
 pub enum ConfigError {
@@ -202,6 +309,28 @@ mod tests {
         assert!(matches!(config.deployment, DeploymentConfig::Monolithic));
         assert_eq!(config.service_name, "rvoip-monolithic");
         assert_eq!(config.channel_capacity, 10_000);
+        assert_eq!(config.handler_dispatch, HandlerDispatch::Inline);
+    }
+
+    #[test]
+    fn test_handler_dispatch_serde() {
+        let dispatch = HandlerDispatch::Queued(
+            HandlerQueueConfig::default()
+                .with_concurrency(4)
+                .with_overflow(OverflowPolicy::Drop),
+        );
+        let json = serde_json::to_string(&dispatch).unwrap();
+        assert_eq!(
+            serde_json::from_str::<HandlerDispatch>(&json).unwrap(),
+            dispatch
+        );
+
+        // Configs written before handler dispatch existed still load.
+        let config: EventCoordinatorConfig = serde_json::from_str(
+            r#"{"deployment":"Monolithic","service_name":"svc","channel_capacity":8}"#,
+        )
+        .unwrap();
+        assert_eq!(config.handler_dispatch, HandlerDispatch::Inline);
     }
 
     #[test]
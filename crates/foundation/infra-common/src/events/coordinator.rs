@@ -25,9 +25,13 @@ use crate::events::cross_crate::{
     CrossCrateEvent, EventTypeId, OrchestrationCrossCrateEvent, RvoipCoreCrossCrateEvent,
 };
 
-use super::config::{DeploymentConfig, EventCoordinatorConfig};
+use super::config::{DeploymentConfig, EventCoordinatorConfig, HandlerDispatch};
+use super::dispatch::{HandlerSlot, HandlerStats};
 use super::transport::NetworkTransport;
 
+/// How long shutdown waits for each queued handler to drain
+const HANDLER_DRAIN_TIMEOUT: std::time::Duration = std::time::Duration::from_secs(5);
+
 /// Global singleton instance for monolithic deployments
 static GLOBAL_COORDINATOR: OnceCell<Arc<GlobalEventCoordinator>> = OnceCell::const_new();
 
@@ -101,8 +105,9 @@ pub struct GlobalEventCoordinator {
     /// Event type registry for cross-crate event management
     event_registry: Arc<EventTypeRegistry>,
 
-    /// Registered event handlers by type
-    handlers: Arc<DashMap<EventTypeId, Vec<Arc<dyn CrossCrateEventHandler>>>>,
+    /// Registered event handlers by type. Registration replaces the list,
+    /// so `publish` can take it without holding a map lock across awaits.
+    handlers: Arc<DashMap<EventTypeId, Arc<Vec<Arc<HandlerSlot>>>>>,
 
     /// Active event subscriptions
     subscriptions: Arc<RwLock<HashMap<EventTypeId, Vec<EventSubscription>>>>,
@@ -350,20 +355,42 @@ impl GlobalEventCoordinator {
         &self.config.service_name
     }
 
-    /// Register an event handler for a specific event type
+    /// Register an event handler for a specific event type, dispatched as
+    /// configured by [`EventCoordinatorConfig::handler_dispatch`]
     pub async fn register_handler<H>(&self, event_type: EventTypeId, handler: H) -> Result<()>
     where
         H: CrossCrateEventHandler + 'static,
     {
-        let handler = Arc::new(handler);
+        self.register_handler_with(event_type, handler, self.config.handler_dispatch)
+            .await
+    }
+
+    /// Register an event handler with its own dispatch, e.g. a queue that
+    /// drops events for an audit sink that must never hold up `publish`
+    pub async fn register_handler_with<H>(
+        &self,
+        event_type: EventTypeId,
+        handler: H,
+        dispatch: HandlerDispatch,
+    ) -> Result<()>
+    where
+        H: CrossCrateEventHandler + 'static,
+    {
+        let slot = Arc::new(HandlerSlot::new(
+            event_type,
+            std::any::type_name::<H>(),
+            Arc::new(handler),
+            dispatch,
+        ));
 
         // Add to handlers registry
-        self.handlers
-            .entry(event_type)
-            .or_insert_with(Vec::new)
-            .push(handler.clone());
+        let mut handlers = self.handlers.entry(event_type).or_default();
+        Arc::make_mut(handlers.value_mut()).push(slot);
 
-        debug!("Registered handler for event type: {}", event_type);
+        debug!(
+            "Registered handler for event type: {} ({:?})",
+            event_type, dispatch
+        );
         Ok(())
     }
 
@@ -387,17 +414,19 @@ impl GlobalEventCoordinator {
 
         debug!("Publishing event type: {}", event_type);
 
-        // Call registered handlers for this event type
-        if let Some(handlers) = self.handlers.get(event_type) {
+        // Run inline handlers and enqueue for queued ones
+        let handlers = self
+            .handlers
+            .get(event_type)
+            .map(|entry| entry.value().clone());
+        if let Some(handlers) = handlers {
             debug!(
                 "Found {} handlers for event type: {}",
                 handlers.len(),
                 event_type
             );
             for handler in handlers.iter() {
-                if let Err(e) = handler.handle(event.clone()).await {
-                    warn!("Handler failed for event type {}: {}", event_type, e);
-                }
+                handler.dispatch(&event).await;
             }
         } else {
             debug!("No handlers registered for event type: {}", event_type);
@@ -471,9 +500,34 @@ impl GlobalEventCoordinator {
         Ok(())
     }
 
+    /// Per-handler latency histograms, queue depth and drop counters
+    pub fn handler_stats(&self) -> Vec<HandlerStats> {
+        self.handlers
+            .iter()
+            .flat_map(|entry| {
+                entry
+                    .value()
+                    .iter()
+                    .map(|slot| slot.stats())
+                    .collect::<Vec<_>>()
+            })
+            .collect()
+    }
+
     /// Get statistics about the event coordinator
     pub async fn stats(&self) -> EventCoordinatorStats {
         let handler_count: usize = self.handlers.iter().map(|entry| entry.value().len()).sum();
+        let events_handled: u64 = self
+            .handlers
+            .iter()
+            .flat_map(|entry| {
+                entry
+                    .value()
+                    .iter()
+                    .map(|slot| slot.handled())
+                    .collect::<Vec<_>>()
+            })
+            .sum();
         let subscription_count: usize = self
             .subscriptions
             .read()
@@ -489,7 +543,7 @@ impl GlobalEventCoordinator {
             registered_handlers: handler_count,
             active_subscriptions: subscription_count,
             active_tasks: task_stats.active_tasks,
-            total_events_processed: 0, // TODO: Add metrics
+            total_events_processed: events_handled,
         }
     }
 
@@ -504,9 +558,31 @@ impl GlobalEventCoordinator {
         self.task_manager.shutdown_all().await?;
 
         // Clear handlers and subscriptions
+        let workers: Vec<_> = self
+            .handlers
+            .iter()
+            .flat_map(|entry| {
+                entry
+                    .value()
+                    .iter()
+                    .flat_map(|slot| slot.take_workers())
+                    .collect::<Vec<_>>()
+            })
+            .collect();
         self.handlers.clear();
         self.subscriptions.write().await.clear();
 
+        // Queued handlers finish what is already queued
+        for mut worker in workers {
+            if tokio::time::timeout(HANDLER_DRAIN_TIMEOUT, &mut worker)
+                .await
+                .is_err()
+            {
+                warn!("Handler queue did not drain during shutdown; aborting it");
+                worker.abort();
+            }
+        }
+
         info!("Global event coordinator shutdown complete");
         Ok(())
     }
@@ -740,6 +816,128 @@ mod tests {
         coordinator.shutdown().await.unwrap();
     }
 
+    struct SlowHandler {
+        delay: std::time::Duration,
+        handled: Arc<std::sync::atomic::AtomicU64>,
+    }
+
+    #[async_trait]
+    impl CrossCrateEventHandler for SlowHandler {
+        async fn handle(&self, _event: Arc<dyn CrossCrateEvent>) -> Result<()> {
+            tokio::time::sleep(self.delay).await;
+            self.handled
+                .fetch_add(1, std::sync::atomic::Ordering::Relaxed);
+            Ok(())
+        }
+    }
+
+    async fn coordinator() -> GlobalEventCoordinator {
+        GlobalEventCoordinator::new(EventCoordinatorConfig::monolithic())
+            .await
+            .unwrap()
+    }
+
+    fn slow(millis: u64) -> (SlowHandler, Arc<std::sync::atomic::AtomicU64>) {
+        let handled = Arc::new(std::sync::atomic::AtomicU64::new(0));
+        let handler = SlowHandler {
+            delay: std::time::Duration::from_millis(millis),
+            handled: handled.clone(),
+        };
+        (handler, handled)
+    }
+
+    #[tokio::test]
+    async fn queued_handler_does_not_delay_publish() {
+        use crate::events::config::HandlerQueueConfig;
+
+        let coordinator = coordinator().await;
+        let (handler, handled) = slow(200);
+        coordinator
+            .register_handler_with(
+                "test_lag",
+                handler,
+                HandlerDispatch::Queued(HandlerQueueConfig::default()),
+            )
+            .await
+            .unwrap();
+
+        let started = std::time::Instant::now();
+        for id in 0..3 {
+            coordinator
+                .publish(Arc::new(TestLagEvent { id }))
+                .await
+                .unwrap();
+        }
+        assert!(started.elapsed() < std::time::Duration::from_millis(150));
+
+        let stats = &coordinator.handler_stats()[0];
+        assert!(stats.handler.ends_with("SlowHandler"));
+        assert!(stats.max_queue_depth >= 2);
+
+        // Shutdown drains what was queued.
+        coordinator.shutdown().await.unwrap();
+        assert_eq!(handled.load(std::sync::atomic::Ordering::Relaxed), 3);
+    }
+
+    #[tokio::test]
+    async fn full_queue_drops_or_blocks_per_policy() {
+        use crate::events::config::{HandlerQueueConfig, OverflowPolicy};
+
+        let coordinator = coordinator().await;
+        let queue = HandlerQueueConfig::default().with_capacity(1);
+        let (dropping, _) = slow(100);
+        let (blocking, _) = slow(20);
+        coordinator
+            .register_handler_with(
+                "test_lag",
+                dropping,
+                HandlerDispatch::Queued(queue.with_overflow(OverflowPolicy::Drop)),
+            )
+            .await
+            .unwrap();
+        coordinator
+            .register_handler_with("test_lag", blocking, HandlerDispatch::Queued(queue))
+            .await
+            .unwrap();
+
+        for id in 0..5 {
+            coordinator
+                .publish(Arc::new(TestLagEvent { id }))
+                .await
+                .unwrap();
+        }
+
+        let stats = coordinator.handler_stats();
+        assert!(stats[0].dropped >= 2, "dropping handler: {:?}", stats[0]);
+        assert_eq!(stats[1].dropped, 0);
+        assert!(stats[1].blocked >= 1, "blocking handler: {:?}", stats[1]);
+        coordinator.shutdown().await.unwrap();
+        let stats = coordinator.stats().await;
+        assert_eq!(stats.registered_handlers, 0);
+    }
+
+    #[tokio::test]
+    async fn inline_handler_latency_is_recorded() {
+        let coordinator = coordinator().await;
+        let (handler, handled) = slow(5);
+        coordinator
+            .register_handler("test_lag", handler)
+            .await
+            .unwrap();
+        coordinator
+            .publish(Arc::new(TestLagEvent { id: 0 }))
+            .await
+            .unwrap();
+
+        // Inline handlers have run by the time publish returns.
+        assert_eq!(handled.load(std::sync::atomic::Ordering::Relaxed), 1);
+        let stats = &coordinator.handler_stats()[0];
+        assert_eq!(stats.dispatch, HandlerDispatch::Inline);
+        assert_eq!(stats.handle_latency.count, 1);
+        assert!(stats.handle_latency.max_us >= 5_000);
+        assert_eq!(coordinator.stats().await.total_events_processed, 1);
+    }
+
     #[tokio::test]
     async fn test_event_type_registry() {
         let registry = EventTypeRegistry::new();
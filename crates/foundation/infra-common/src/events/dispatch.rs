@@ -0,0 +1,309 @@
+//! Per-handler dispatch for the Global Event Coordinator
+//!
+//! Every registered handler gets a [`HandlerSlot`] that either runs it
+//! inline in `publish` or feeds a bounded queue drained by the handler's own
+//! tasks, and records how long the handler takes, how long events wait for
+//! it and how full its queue gets.
+
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::{Arc, Mutex as StdMutex};
+use std::time::{Duration, Instant};
+
+use tokio::sync::{mpsc, Mutex};
+use tokio::task::JoinHandle;
+use tracing::{debug, warn};
+
+use super::config::{HandlerDispatch, HandlerQueueConfig, OverflowPolicy};
+use super::coordinator::CrossCrateEventHandler;
+use super::cross_crate::{CrossCrateEvent, EventTypeId};
+
+const LATENCY_BUCKET_UPPER_US: [u64; 18] = [
+    10, 25, 50, 100, 250, 500, 1_000, 2_500, 5_000, 10_000, 25_000, 50_000, 100_000, 250_000,
+    500_000, 1_000_000, 2_500_000, 5_000_000,
+];
+
+/// Lock-free latency histogram over fixed microsecond buckets
+#[derive(Debug, Default)]
+pub(crate) struct LatencyHistogram {
+    buckets: [AtomicU64; 18],
+    count: AtomicU64,
+    sum_us: AtomicU64,
+    max_us: AtomicU64,
+}
+
+/// Point-in-time view of a [`LatencyHistogram`]. Percentiles are the upper
+/// bound of the bucket they fall in.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct LatencySnapshot {
+    pub count: u64,
+    pub avg_us: u64,
+    pub p50_us: u64,
+    pub p95_us: u64,
+    pub p99_us: u64,
+    pub p999_us: u64,
+    pub max_us: u64,
+}
+
+impl LatencyHistogram {
+    pub(crate) fn record(&self, elapsed: Duration) {
+        let elapsed_us = elapsed.as_micros().min(u128::from(u64::MAX)) as u64;
+        self.count.fetch_add(1, Ordering::Relaxed);
+        self.sum_us.fetch_add(elapsed_us, Ordering::Relaxed);
+        self.max_us.fetch_max(elapsed_us, Ordering::Relaxed);
+        let bucket = LATENCY_BUCKET_UPPER_US
+            .iter()
+            .position(|upper| elapsed_us <= *upper)
+            .unwrap_or(LATENCY_BUCKET_UPPER_US.len() - 1);
+        self.buckets[bucket].fetch_add(1, Ordering::Relaxed);
+    }
+
+    pub(crate) fn snapshot(&self) -> LatencySnapshot {
+        let count = self.count.load(Ordering::Relaxed);
+        let sum_us = self.sum_us.load(Ordering::Relaxed);
+        LatencySnapshot {
+            count,
+            avg_us: if count == 0 { 0 } else { sum_us / count },
+            p50_us: self.percentile_per_mille_us(count, 500),
+            p95_us: self.percentile_per_mille_us(count, 950),
+            p99_us: self.percentile_per_mille_us(count, 990),
+            p999_us: self.percentile_per_mille_us(count, 999),
+            max_us: self.max_us.load(Ordering::Relaxed),
+        }
+    }
+
+    fn percentile_per_mille_us(&self, observed: u64, per_mille: u64) -> u64 {
+        if observed == 0 {
+            return 0;
+        }
+        let target = (observed * per_mille).div_ceil(1000).max(1);
+        let mut seen = 0;
+        for (idx, bucket) in self.buckets.iter().enumerate() {
+            seen += bucket.load(Ordering::Relaxed);
+            if seen >= target {
+                return LATENCY_BUCKET_UPPER_US[idx];
+            }
+        }
+        *LATENCY_BUCKET_UPPER_US.last().unwrap()
+    }
+}
+
+/// Counters and histograms of one registered handler
+#[derive(Debug, Default)]
+struct HandlerMetrics {
+    handled: AtomicU64,
+    failed: AtomicU64,
+    dropped: AtomicU64,
+    /// Publishes that found the queue full and waited for room.
+    blocked: AtomicU64,
+    max_queue_depth: AtomicU64,
+    handle_latency: LatencyHistogram,
+    queue_wait: LatencyHistogram,
+}
+
+/// Metrics of one registered handler, as reported by
+/// `GlobalEventCoordinator::handler_stats`
+#[derive(Debug, Clone)]
+pub struct HandlerStats {
+    pub event_type: EventTypeId,
+    /// Type name of the handler.
+    pub handler: &'static str,
+    pub dispatch: HandlerDispatch,
+    pub handled: u64,
+    pub failed: u64,
+    /// Events dropped because the queue was full ([`OverflowPolicy::Drop`]).
+    pub dropped: u64,
+    /// Publishes that waited for queue room ([`OverflowPolicy::Block`]).
+    pub blocked: u64,
+    /// Events currently queued; always 0 for inline handlers.
+    pub queue_depth: usize,
+    pub max_queue_depth: u64,
+    /// Time spent in the handler.
+    pub handle_latency: LatencySnapshot,
+    /// Time from publish until the handler picked the event up.
+    pub queue_wait: LatencySnapshot,
+}
+
+type Queued = (Arc<dyn CrossCrateEvent>, Instant);
+
+/// A registered handler and the way it is dispatched
+pub(crate) struct HandlerSlot {
+    event_type: EventTypeId,
+    name: &'static str,
+    handler: Arc<dyn CrossCrateEventHandler>,
+    dispatch: HandlerDispatch,
+    queue: Option<mpsc::Sender<Queued>>,
+    workers: StdMutex<Vec<JoinHandle<()>>>,
+    metrics: Arc<HandlerMetrics>,
+}
+
+impl HandlerSlot {
+    /// Create a slot, spawning the queue's workers for queued dispatch.
+    pub(crate) fn new(
+        event_type: EventTypeId,
+        name: &'static str,
+        handler: Arc<dyn CrossCrateEventHandler>,
+        dispatch: HandlerDispatch,
+    ) -> Self {
+        let metrics = Arc::new(HandlerMetrics::default());
+        let (queue, workers) = match dispatch {
+            HandlerDispatch::Inline => (None, Vec::new()),
+            HandlerDispatch::Queued(config) => {
+                let (tx, workers) = spawn_workers(event_type, &handler, &metrics, config);
+                (Some(tx), workers)
+            }
+        };
+        Self {
+            event_type,
+            name,
+            handler,
+            dispatch,
+            queue,
+            workers: StdMutex::new(workers),
+            metrics,
+        }
+    }
+
+    /// Run or enqueue `event` for this handler.
+    pub(crate) async fn dispatch(&self, event: &Arc<dyn CrossCrateEvent>) {
+        let Some(queue) = &self.queue else {
+            run_handler(
+                &*self.handler,
+                &self.metrics,
+                self.event_type,
+                event.clone(),
+            )
+            .await;
+            return;
+        };
+        let item = (event.clone(), Instant::now());
+        match queue.try_send(item) {
+            Ok(()) => {}
+            Err(mpsc::error::TrySendError::Full(item)) => match self.overflow() {
+                OverflowPolicy::Drop => {
+                    self.metrics.dropped.fetch_add(1, Ordering::Relaxed);
+                    debug!(
+                        "Handler {} queue full, dropping {} event",
+                        self.name, self.event_type
+                    );
+                }
+                OverflowPolicy::Block => {
+                    self.metrics.blocked.fetch_add(1, Ordering::Relaxed);
+                    if queue.send(item).await.is_err() {
+                        return;
+                    }
+                }
+            },
+            Err(mpsc::error::TrySendError::Closed(_)) => return,
+        }
+        let depth = (queue.max_capacity() - queue.capacity()) as u64;
+        self.metrics
+            .max_queue_depth
+            .fetch_max(depth, Ordering::Relaxed);
+    }
+
+    fn overflow(&self) -> OverflowPolicy {
+        match self.dispatch {
+            HandlerDispatch::Queued(config) => config.overflow,
+            HandlerDispatch::Inline => OverflowPolicy::Block,
+        }
+    }
+
+    pub(crate) fn stats(&self) -> HandlerStats {
+        let metrics = &self.metrics;
+        HandlerStats {
+            event_type: self.event_type,
+            handler: self.name,
+            dispatch: self.dispatch,
+            handled: metrics.handled.load(Ordering::Relaxed),
+            failed: metrics.failed.load(Ordering::Relaxed),
+            dropped: metrics.dropped.load(Ordering::Relaxed),
+            blocked: metrics.blocked.load(Ordering::Relaxed),
+            queue_depth: self
+                .queue
+                .as_ref()
+                .map_or(0, |queue| queue.max_capacity() - queue.capacity()),
+            max_queue_depth: metrics.max_queue_depth.load(Ordering::Relaxed),
+            handle_latency: metrics.handle_latency.snapshot(),
+            queue_wait: metrics.queue_wait.snapshot(),
+        }
+    }
+
+    pub(crate) fn handled(&self) -> u64 {
+        self.metrics.handled.load(Ordering::Relaxed)
+    }
+
+    /// Take the queue workers; they finish once the slot is dropped and
+    /// its queue drained.
+    pub(crate) fn take_workers(&self) -> Vec<JoinHandle<()>> {
+        std::mem::take(&mut *self.workers.lock().unwrap_or_else(|e| e.into_inner()))
+    }
+}
+
+fn spawn_workers(
+    event_type: EventTypeId,
+    handler: &Arc<dyn CrossCrateEventHandler>,
+    metrics: &Arc<HandlerMetrics>,
+    config: HandlerQueueConfig,
+) -> (mpsc::Sender<Queued>, Vec<JoinHandle<()>>) {
+    let (tx, rx) = mpsc::channel::<Queued>(config.capacity.max(1));
+    let rx = Arc::new(Mutex::new(rx));
+    let workers = (0..config.concurrency.max(1))
+        .map(|_| {
+            let rx = rx.clone();
+            let handler = handler.clone();
+            let metrics = metrics.clone();
+            tokio::spawn(async move {
+                loop {
+                    // Only the worker holding the lock waits on the queue;
+                    // it lets go before running the handler.
+                    let next = rx.lock().await.recv().await;
+                    let Some((event, queued_at)) = next else {
+                        break;
+                    };
+                    metrics.queue_wait.record(queued_at.elapsed());
+                    run_handler(&*handler, &metrics, event_type, event).await;
+                }
+            })
+        })
+        .collect();
+    (tx, workers)
+}
+
+async fn run_handler(
+    handler: &dyn CrossCrateEventHandler,
+    metrics: &HandlerMetrics,
+    event_type: EventTypeId,
+    event: Arc<dyn CrossCrateEvent>,
+) {
+    let started = Instant::now();
+    let result = handler.handle(event).await;
+    metrics.handle_latency.record(started.elapsed());
+    metrics.handled.fetch_add(1, Ordering::Relaxed);
+    if let Err(e) = result {
+        metrics.failed.fetch_add(1, Ordering::Relaxed);
+        warn!("Handler failed for event type {}: {}", event_type, e);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn histogram_reports_bucket_percentiles() {
+        let histogram = LatencyHistogram::default();
+        for _ in 0..98 {
+            histogram.record(Duration::from_micros(40));
+        }
+        histogram.record(Duration::from_millis(3));
+        histogram.record(Duration::from_secs(9));
+
+        let snapshot = histogram.snapshot();
+        assert_eq!(snapshot.count, 100);
+        assert_eq!(snapshot.p50_us, 50);
+        assert_eq!(snapshot.p95_us, 50);
+        assert_eq!(snapshot.p99_us, 5_000);
+        assert_eq!(snapshot.p999_us, 5_000_000);
+        assert_eq!(snapshot.max_us, 9_000_000);
+    }
+}
@@ -189,8 +189,12 @@ pub mod zero_copy;
 pub mod config;
 pub mod coordinator;
 pub mod cross_crate;
+pub mod dispatch;
 pub mod transport;
 
 // Re-export commonly used items
-pub use config::{DeploymentConfig, EventCoordinatorConfig};
+pub use config::{
+    DeploymentConfig, EventCoordinatorConfig, HandlerDispatch, HandlerQueueConfig, OverflowPolicy,
+};
 pub use coordinator::{global_coordinator, GlobalEventCoordinator};
+pub use dispatch::{HandlerStats, LatencySnapshot};
@@ -19,6 +19,7 @@ RVOIP stack can leverage to ensure consistency and reduce duplication.
 #[global_allocator]
 static GLOBAL: mimalloc::MiMalloc = mimalloc::MiMalloc;
 
+pub mod affinity;
 pub mod config;
 pub mod errors;
 pub mod events;
@@ -12,13 +12,23 @@
 //! Send-across-await trap; the memory cost is one extra Transcoder per
 //! bridge.
 //!
+//! With a [`MediaWorkerPool`] ([`spawn_pump_with_pool`]) the transcoder
+//! moves onto a pool lane the first time the pump has a frame to
+//! transcode: the pump only queues frames, and the pool's worker thread
+//! transcodes them and sends them on, keeping CPU-heavy codec work off
+//! the async runtime. Telephone-events and post-swap frames go through
+//! the same lane so ordering is preserved.
+//!
 //! Exits cleanly when:
 //! - The source channel closes (peer hung up).
 //! - The destination channel closes (we hung up; `send` returns Err).
 //! - The task is aborted via the [`super::CrossBridgeHandle`] abort handle
 //!   (i.e. `unbridge_connections` was called).
 
+use std::sync::Arc;
+
 use rvoip_media_core::codec::transcoding::Transcoder;
+use rvoip_media_core::codec::worker_pool::{LaneError, LaneOutput, MediaWorkerPool, TranscodeLane};
 use tokio::sync::mpsc;
 use tokio::task::JoinHandle;
 use tracing::{debug, trace, warn};
@@ -37,7 +47,9 @@ pub const DEFAULT_TELEPHONE_EVENT_PT: u8 = 101;
 /// transcoding under the old codec settings, then the pump replaces
 /// its local `transcoder` / `from_pt` / `to_pt` with the swap's
 /// values for all subsequent frames. The "single-frame gap" comes
-/// from this race — see the gap plan's risk discussion.
+/// from this race — see the gap plan's risk discussion. A pump running
+/// on a [`MediaWorkerPool`] lane forwards the swap into the lane, where
+/// it applies after the frames already queued.
 pub struct TranscoderSwap {
     pub new_transcoder: Option<Transcoder>,
     pub new_from_pt: u8,
@@ -92,6 +104,29 @@ pub fn spawn_pump(
 /// for all subsequent frames. The documented "single-frame gap" is
 /// the worst case — usually nothing is in flight at the swap point.
 pub fn spawn_pump_with_swap(
+    direction: &'static str,
+    from: mpsc::Receiver<MediaFrame>,
+    to: mpsc::Sender<MediaFrame>,
+    transcoder: Option<Transcoder>,
+    from_pt: u8,
+    to_pt: u8,
+    swap_rx: mpsc::Receiver<TranscoderSwap>,
+) -> JoinHandle<()> {
+    spawn_pump_with_pool(
+        direction, from, to, transcoder, from_pt, to_pt, swap_rx, None,
+    )
+}
+
+/// Variant of [`spawn_pump_with_swap`] that transcodes on `pool` when
+/// one is given (see the module docs); `None` transcodes inline on the
+/// pump task.
+///
+/// Pooled frames that find their lane full are dropped and counted in
+/// `rvoip_bridge_pool_frames_dropped_total`, as are transcoded frames
+/// the destination channel has no room for: the worker never waits on
+/// a slow peer.
+#[allow(clippy::too_many_arguments)]
+pub fn spawn_pump_with_pool(
     direction: &'static str,
     mut from: mpsc::Receiver<MediaFrame>,
     to: mpsc::Sender<MediaFrame>,
@@ -99,13 +134,21 @@ pub fn spawn_pump_with_swap(
     mut from_pt: u8,
     mut to_pt: u8,
     mut swap_rx: mpsc::Receiver<TranscoderSwap>,
+    pool: Option<Arc<MediaWorkerPool>>,
 ) -> JoinHandle<()> {
     tokio::spawn(async move {
         let mut need_transcode = transcoder.is_some() && from_pt != to_pt;
         debug!(
             direction,
-            from_pt, to_pt, need_transcode, "rvoip-core::frame_pump: started"
+            from_pt,
+            to_pt,
+            need_transcode,
+            pooled = pool.is_some(),
+            "rvoip-core::frame_pump: started"
         );
+        // Opened on the first frame that needs transcoding; from then on
+        // every frame and swap goes through it.
+        let mut lane: Option<TranscodeLane<MediaFrame>> = None;
 
         let mut swap_open = true;
         loop {
@@ -119,10 +162,18 @@ pub fn spawn_pump_with_swap(
                     swap = swap_rx.recv() => {
                         match swap {
                             Some(s) => {
-                                transcoder = s.new_transcoder;
                                 from_pt = s.new_from_pt;
                                 to_pt = s.new_to_pt;
-                                need_transcode = transcoder.is_some() && from_pt != to_pt;
+                                need_transcode = s.new_transcoder.is_some() && from_pt != to_pt;
+                                match lane.as_ref() {
+                                    Some(lane) => {
+                                        if lane.swap(s.new_transcoder, from_pt, to_pt).is_err() {
+                                            debug!(direction, "rvoip-core::frame_pump: peer closed; exiting");
+                                            return;
+                                        }
+                                    }
+                                    None => transcoder = s.new_transcoder,
+                                }
                                 metrics::counter!(
                                     "uctp_bridge_transcoder_swaps_total",
                                     "direction" => direction,
@@ -159,6 +210,47 @@ pub fn spawn_pump_with_swap(
                 debug!(direction, "rvoip-core::frame_pump: source closed; exiting");
                 return;
             };
+            if lane.is_none() && need_transcode {
+                if let Some(pool) = pool.as_ref() {
+                    lane = Some(open_lane(
+                        pool,
+                        direction,
+                        transcoder.take(),
+                        from_pt,
+                        to_pt,
+                        to.clone(),
+                    ));
+                }
+            }
+            if let Some(lane) = lane.as_ref() {
+                let queued = if frame.payload_type == Some(DEFAULT_TELEPHONE_EVENT_PT) {
+                    metrics::counter!(
+                        "rvoip_bridge_dtmf_passthrough_total",
+                        "direction" => direction,
+                    )
+                    .increment(1);
+                    lane.pass(frame)
+                } else {
+                    let payload = frame.payload.clone();
+                    lane.submit(payload, frame)
+                };
+                match queued {
+                    Ok(()) => {}
+                    Err(LaneError::Full) => {
+                        metrics::counter!(
+                            "rvoip_bridge_pool_frames_dropped_total",
+                            "direction" => direction,
+                            "reason" => "lane_full",
+                        )
+                        .increment(1);
+                    }
+                    Err(LaneError::Closed) => {
+                        debug!(direction, "rvoip-core::frame_pump: peer closed; exiting");
+                        return;
+                    }
+                }
+                continue;
+            }
             {
                 // Gap plan §4.3 — PT-aware DTMF routing. If the inbound
                 // pump labelled this frame with the telephone-event PT,
@@ -191,36 +283,7 @@ pub fn spawn_pump_with_swap(
                     match t.transcode(&frame.payload, from_pt, to_pt).await {
                         Ok(bytes) => frame.payload = bytes.into(),
                         Err(e) => {
-                            // Pre-§4.3 fallback: a transcode failure on a
-                            // 4-byte payload is almost certainly an RFC 4733
-                            // telephone-event whose PT wasn't carried in
-                            // the MediaFrame. Pass it through verbatim.
-                            if frame.payload.len() == 4 {
-                                metrics::counter!(
-                                    "rvoip_bridge_dtmf_passthrough_total",
-                                    "direction" => direction,
-                                )
-                                .increment(1);
-                                trace!(
-                                direction,
-                                "rvoip-core::frame_pump: 4-byte transcode failure — likely RFC 4733 DTMF without PT label; passing through"
-                            );
-                                // Fall through to the `to.send(frame)` call
-                                // below with the original payload.
-                            } else {
-                                warn!(
-                                    direction,
-                                    from_pt,
-                                    to_pt,
-                                    error = %e,
-                                    bytes = frame.payload.len(),
-                                    "rvoip-core::frame_pump: transcode failed; dropping frame"
-                                );
-                                metrics::counter!(
-                                    "rvoip_bridge_transcode_errors_total",
-                                    "direction" => direction,
-                                )
-                                .increment(1);
+                            if !failed_frame_passes(direction, from_pt, to_pt, &frame, &e) {
                                 continue;
                             }
                         }
@@ -236,6 +299,90 @@ pub fn spawn_pump_with_swap(
     })
 }
 
+/// Decide what happens to a frame whose transcode failed: `true` to
+/// forward it untouched, `false` to drop it.
+///
+/// Pre-§4.3 fallback: a transcode failure on a 4-byte payload is almost
+/// certainly an RFC 4733 telephone-event whose PT wasn't carried in the
+/// MediaFrame, so it passes through verbatim.
+fn failed_frame_passes(
+    direction: &'static str,
+    from_pt: u8,
+    to_pt: u8,
+    frame: &MediaFrame,
+    error: &rvoip_media_core::Error,
+) -> bool {
+    if frame.payload.len() == 4 {
+        metrics::counter!(
+            "rvoip_bridge_dtmf_passthrough_total",
+            "direction" => direction,
+        )
+        .increment(1);
+        trace!(
+            direction,
+            "rvoip-core::frame_pump: 4-byte transcode failure — likely RFC 4733 DTMF without PT label; passing through"
+        );
+        true
+    } else {
+        warn!(
+            direction,
+            from_pt,
+            to_pt,
+            error = %error,
+            bytes = frame.payload.len(),
+            "rvoip-core::frame_pump: transcode failed; dropping frame"
+        );
+        metrics::counter!(
+            "rvoip_bridge_transcode_errors_total",
+            "direction" => direction,
+        )
+        .increment(1);
+        false
+    }
+}
+
+/// Open a pool lane that delivers into `to` from the worker thread.
+/// `from_pt`/`to_pt` only label failure logs; the lane tracks swaps
+/// itself.
+fn open_lane(
+    pool: &MediaWorkerPool,
+    direction: &'static str,
+    transcoder: Option<Transcoder>,
+    from_pt: u8,
+    to_pt: u8,
+    to: mpsc::Sender<MediaFrame>,
+) -> TranscodeLane<MediaFrame> {
+    pool.open_lane(
+        transcoder,
+        from_pt,
+        to_pt,
+        move |mut frame: MediaFrame, output| {
+            match output {
+                LaneOutput::Transcoded(bytes) => frame.payload = bytes.into(),
+                LaneOutput::Passthrough => {}
+                LaneOutput::Failed(e) => {
+                    if !failed_frame_passes(direction, from_pt, to_pt, &frame, &e) {
+                        return true;
+                    }
+                }
+            }
+            match to.try_send(frame) {
+                Ok(()) => true,
+                Err(mpsc::error::TrySendError::Full(_)) => {
+                    metrics::counter!(
+                        "rvoip_bridge_pool_frames_dropped_total",
+                        "direction" => direction,
+                        "reason" => "destination_full",
+                    )
+                    .increment(1);
+                    true
+                }
+                Err(mpsc::error::TrySendError::Closed(_)) => false,
+            }
+        },
+    )
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -384,6 +531,65 @@ mod tests {
         pump.await.unwrap();
     }
 
+    /// With a worker pool, transcoding runs on the pool and frames
+    /// (telephone-events included) arrive in order.
+    #[tokio::test]
+    async fn pooled_pump_transcodes_on_the_worker_pool() {
+        use rvoip_media_core::codec::worker_pool::MediaWorkerConfig;
+        use rvoip_media_core::processing::format::FormatConverter;
+        use tokio::sync::RwLock;
+
+        let new_transcoder = || Transcoder::new(Arc::new(RwLock::new(FormatConverter::new())));
+        let pool = Arc::new(
+            MediaWorkerPool::new(MediaWorkerConfig {
+                workers: 1,
+                tick: std::time::Duration::from_millis(5),
+                lane_depth: 16,
+                pin_to_cores: false,
+            })
+            .unwrap(),
+        );
+        let (tx_from, rx_from) = mpsc::channel::<MediaFrame>(8);
+        let (tx_to, mut rx_to) = mpsc::channel::<MediaFrame>(8);
+        let (_swap_tx, swap_rx) = mpsc::channel::<TranscoderSwap>(1);
+        let pump = spawn_pump_with_pool(
+            "pool_test",
+            rx_from,
+            tx_to,
+            Some(new_transcoder()),
+            0, // PCMU
+            8, // PCMA
+            swap_rx,
+            Some(pool.clone()),
+        );
+
+        let pcmu = vec![0xFFu8; 160];
+        let pcma = new_transcoder().pcmu_to_pcma(&pcmu).await.unwrap();
+        let mut dtmf = mk_frame(0);
+        dtmf.payload = Bytes::from(vec![0x01, 0x0F, 0x00, 0x50]);
+        dtmf.payload_type = Some(DEFAULT_TELEPHONE_EVENT_PT);
+        for _ in 0..2 {
+            let mut frame = mk_frame(0);
+            frame.payload = Bytes::from(pcmu.clone());
+            tx_from.send(frame).await.unwrap();
+        }
+        tx_from.send(dtmf.clone()).await.unwrap();
+        drop(tx_from);
+
+        let mut received = Vec::new();
+        while let Some(frame) =
+            tokio::time::timeout(std::time::Duration::from_secs(2), rx_to.recv())
+                .await
+                .expect("pool delivers")
+        {
+            received.push(frame.payload.to_vec());
+        }
+        assert_eq!(received, vec![pcma.clone(), pcma, dtmf.payload.to_vec()]);
+        assert_eq!(pool.stats().frames, 3);
+
+        pump.await.unwrap();
+    }
+
     /// When destination closes, the pump exits without panic.
     #[tokio::test]
     async fn pump_exits_when_destination_closes() {
@@ -2,6 +2,8 @@ use std::sync::Arc;
 use std::thread;
 use std::time::Duration;
 
+use rvoip_media_core::codec::worker_pool::MediaWorkerPool;
+
 use crate::store::{
     ConversationStore, MemoryConversationStore, MemoryMessageStore, MemoryVconStore, MessageStore,
     VconStore,
@@ -43,6 +45,12 @@ pub struct Config {
     /// P6 — `Event::CapacityReport` emit cadence. None disables the
     /// scheduler entirely.
     pub capacity_report_interval: Option<Duration>,
+    /// Dedicated transcoding threads for cross-transport bridges. When
+    /// set, bridge frame pumps hand codec work to this pool instead of
+    /// transcoding on the async runtime (see
+    /// [`crate::bridge::frame_pump::spawn_pump_with_pool`]). Default
+    /// `None`: transcode inline.
+    pub media_workers: Option<Arc<MediaWorkerPool>>,
 }
 
 impl Default for Config {
@@ -57,6 +65,7 @@ impl Default for Config {
             message_store: Arc::new(MemoryMessageStore::new()),
             bridge_stream_deadline: Duration::from_secs(5),
             capacity_report_interval: Some(Duration::from_secs(30)),
+            media_workers: None,
         }
     }
 }
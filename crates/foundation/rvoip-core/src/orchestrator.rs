@@ -3080,11 +3080,13 @@ impl Orchestrator {
         // Gap plan §4.2 v1 punch list — wire each pump with a swap
         // channel so `Orchestrator::renegotiate_media` can hot-swap
         // the transcoders after a successful codec renegotiation.
+        // Transcoding runs on the media worker pool when one is
+        // configured.
         let (swap_a_to_b_tx, swap_a_to_b_rx) =
             tokio::sync::mpsc::channel::<frame_pump::TranscoderSwap>(4);
         let (swap_b_to_a_tx, swap_b_to_a_rx) =
             tokio::sync::mpsc::channel::<frame_pump::TranscoderSwap>(4);
-        let a_to_b = frame_pump::spawn_pump_with_swap(
+        let a_to_b = frame_pump::spawn_pump_with_pool(
             "a->b",
             a_in,
             b_out,
@@ -3092,8 +3094,9 @@ impl Orchestrator {
             a_pt,
             b_pt,
             swap_a_to_b_rx,
+            self.config.media_workers.clone(),
         );
-        let b_to_a = frame_pump::spawn_pump_with_swap(
+        let b_to_a = frame_pump::spawn_pump_with_pool(
             "b->a",
             b_in,
             a_out,
@@ -3101,6 +3104,7 @@ impl Orchestrator {
             b_pt,
             a_pt,
             swap_b_to_a_rx,
+            self.config.media_workers.clone(),
         );
 
         let id = BridgeId::new();
@@ -12,6 +12,8 @@
 //! responses. [`DigestClient`] computes UAC responses for challenges. They are
 //! used by `rvoip-sip` for SIP Digest over `401 WWW-Authenticate` /
 //! `Authorization` and `407 Proxy-Authenticate` / `Proxy-Authorization`.
+//! [`DigestNonceSigner`] mints HMAC-signed nonces that a UAS can verify
+//! without remembering them.
 //!
 //! Supported Digest algorithms are MD5, MD5-sess, SHA-256, SHA-256-sess,
 //! SHA-512-256, and SHA-512-256-sess. An omitted Digest `algorithm` defaults
@@ -77,5 +79,5 @@ pub use sig9421::{
 };
 pub use sip_digest::{
     DigestAlgorithm, DigestAuthenticator, DigestChallenge, DigestChallengeDetails, DigestClient,
-    DigestComputed, DigestResponse,
+    DigestComputed, DigestNonceSigner, DigestResponse,
 };
@@ -13,11 +13,12 @@
 //! incrementing counter plus the request body (for `auth-int`).
 
 use crate::error::{AuthError, Result};
-use crate::providers::DigestSecret;
+use crate::providers::{DigestNonceStatus, DigestSecret};
 use hex;
 use rand::Rng;
+use ring::hmac;
 use sha2::{Digest as Sha2Digest, Sha256, Sha512_256};
-use std::time::{SystemTime, UNIX_EPOCH};
+use std::time::{Duration, SystemTime, UNIX_EPOCH};
 
 /// Digest authentication algorithm.
 ///
@@ -224,9 +225,15 @@ impl DigestAuthenticator {
     }
 
     pub fn generate_challenge(&self) -> DigestChallenge {
+        self.generate_challenge_with_nonce(Self::generate_nonce())
+    }
+
+    /// Generate a challenge carrying a caller-minted nonce, e.g. one from
+    /// [`DigestNonceSigner::issue`].
+    pub fn generate_challenge_with_nonce(&self, nonce: impl Into<String>) -> DigestChallenge {
         DigestChallenge {
             realm: self.realm.clone(),
-            nonce: Self::generate_nonce(),
+            nonce: nonce.into(),
             algorithm: self.algorithm,
             qop: Some(vec!["auth".to_string()]),
             opaque: Some(Self::generate_opaque()),
@@ -515,6 +522,142 @@ impl DigestAuthenticator {
     }
 }
 
+// Signed nonce layout: issue time (ms) + salt + truncated HMAC-SHA256 tag.
+const SIGNED_NONCE_STAMP_LEN: usize = 8;
+const SIGNED_NONCE_SALT_LEN: usize = 4;
+const SIGNED_NONCE_TAG_LEN: usize = 16;
+const SIGNED_NONCE_LEN: usize =
+    SIGNED_NONCE_STAMP_LEN + SIGNED_NONCE_SALT_LEN + SIGNED_NONCE_TAG_LEN;
+
+/// Clock skew tolerated on nonces minted by a peer node
+const SIGNED_NONCE_MAX_SKEW: Duration = Duration::from_secs(5);
+
+/// Self-validating Digest nonces (RFC 7616 §3.3 "nonce" suggestion).
+///
+/// A nonce is `hex(issued_ms || salt || HMAC-SHA256(key, realm || issued_ms
+/// || salt)[..16])`. Issuing one needs no shared state and verifying one is a
+/// single HMAC, so a UAS does not have to remember the nonces it handed out.
+/// Nodes that share a key (see [`Self::with_key`]) accept each other's
+/// nonces. Nonce-count replay tracking stays with the caller.
+#[derive(Clone)]
+pub struct DigestNonceSigner {
+    key: hmac::Key,
+    realm: String,
+    ttl: Duration,
+}
+
+impl DigestNonceSigner {
+    /// Signer with a random per-process key.
+    pub fn new(realm: impl Into<String>, ttl: Duration) -> Self {
+        let key: [u8; 32] = rand::thread_rng().gen();
+        Self::with_key(realm, &key, ttl)
+    }
+
+    /// Signer with an explicit key, shared by every node that must accept
+    /// the same nonces. Use at least 32 random bytes.
+    pub fn with_key(realm: impl Into<String>, key: &[u8], ttl: Duration) -> Self {
+        Self {
+            key: hmac::Key::new(hmac::HMAC_SHA256, key),
+            realm: realm.into(),
+            ttl,
+        }
+    }
+
+    /// Replace the nonce lifetime, keeping the key.
+    pub fn with_ttl(mut self, ttl: Duration) -> Self {
+        self.ttl = ttl;
+        self
+    }
+
+    /// How long issued nonces stay [`DigestNonceStatus::Active`].
+    pub fn ttl(&self) -> Duration {
+        self.ttl
+    }
+
+    /// Longest span over which one nonce can verify as active: the TTL plus
+    /// the clock skew tolerated between nodes sharing a key. Replay state
+    /// for a nonce must be kept at least this long.
+    pub fn max_lifetime(&self) -> Duration {
+        self.ttl.saturating_add(SIGNED_NONCE_MAX_SKEW)
+    }
+
+    /// Mint a nonce issued now.
+    pub fn issue(&self) -> String {
+        self.issue_at(SystemTime::now())
+    }
+
+    /// Mint a nonce issued at `now`.
+    pub fn issue_at(&self, now: SystemTime) -> String {
+        let mut raw = [0u8; SIGNED_NONCE_LEN];
+        raw[..SIGNED_NONCE_STAMP_LEN].copy_from_slice(&unix_millis(now).to_be_bytes());
+        rand::thread_rng()
+            .fill(&mut raw[SIGNED_NONCE_STAMP_LEN..SIGNED_NONCE_STAMP_LEN + SIGNED_NONCE_SALT_LEN]);
+        let tag = self.tag(&raw[..SIGNED_NONCE_STAMP_LEN + SIGNED_NONCE_SALT_LEN]);
+        raw[SIGNED_NONCE_STAMP_LEN + SIGNED_NONCE_SALT_LEN..]
+            .copy_from_slice(&tag.as_ref()[..SIGNED_NONCE_TAG_LEN]);
+        hex::encode(raw)
+    }
+
+    /// Classify `nonce` at `now`: `Active` if this signer minted it within
+    /// the TTL, `Expired` if it did so earlier, `Unknown` otherwise
+    /// (including nonces minted for another realm or with another key).
+    pub fn verify(&self, nonce: &str, now: SystemTime) -> DigestNonceStatus {
+        let mut raw = [0u8; SIGNED_NONCE_LEN];
+        if hex::decode_to_slice(nonce, &mut raw).is_err() {
+            return DigestNonceStatus::Unknown;
+        }
+        let (signed, tag) = raw.split_at(SIGNED_NONCE_STAMP_LEN + SIGNED_NONCE_SALT_LEN);
+        let expected = self.tag(signed);
+        // Constant time: a timing oracle on the tag would let a client
+        // forge nonces byte by byte.
+        let diff = tag
+            .iter()
+            .zip(expected.as_ref())
+            .fold(0u8, |acc, (a, b)| acc | (a ^ b));
+        if diff != 0 {
+            return DigestNonceStatus::Unknown;
+        }
+        let mut stamp = [0u8; SIGNED_NONCE_STAMP_LEN];
+        stamp.copy_from_slice(&signed[..SIGNED_NONCE_STAMP_LEN]);
+        let issued_ms = u64::from_be_bytes(stamp);
+        let now_ms = unix_millis(now);
+        let ttl_ms = u64::try_from(self.ttl.as_millis()).unwrap_or(u64::MAX);
+        // A peer node's clock may run slightly ahead of ours; a nonce from
+        // further in the future was not minted honestly.
+        if issued_ms > now_ms.saturating_add(SIGNED_NONCE_MAX_SKEW.as_millis() as u64) {
+            return DigestNonceStatus::Unknown;
+        }
+        if now_ms.saturating_sub(issued_ms) < ttl_ms {
+            DigestNonceStatus::Active
+        } else {
+            DigestNonceStatus::Expired
+        }
+    }
+
+    fn tag(&self, signed: &[u8]) -> hmac::Tag {
+        let mut context = hmac::Context::with_key(&self.key);
+        context.update(self.realm.as_bytes());
+        context.update(&[0]);
+        context.update(signed);
+        context.sign()
+    }
+}
+
+impl std::fmt::Debug for DigestNonceSigner {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("DigestNonceSigner")
+            .field("realm", &self.realm)
+            .field("ttl", &self.ttl)
+            .finish_non_exhaustive()
+    }
+}
+
+fn unix_millis(time: SystemTime) -> u64 {
+    time.duration_since(UNIX_EPOCH)
+        .map(|elapsed| u64::try_from(elapsed.as_millis()).unwrap_or(u64::MAX))
+        .unwrap_or(0)
+}
+
 /// Client-side digest authentication helper.
 pub struct DigestClient;
 
@@ -1257,4 +1400,71 @@ mod tests {
         assert!(header.contains(r#"realm="testrealm""#));
         assert!(header.contains(r#"nonce="nonce123""#));
     }
+
+    #[test]
+    fn signed_nonce_round_trips_and_expires() {
+        let signer = DigestNonceSigner::new("example.test", Duration::from_secs(30));
+        let issued = UNIX_EPOCH + Duration::from_secs(1_700_000_000);
+        let nonce = signer.issue_at(issued);
+        assert_eq!(nonce.len(), 2 * SIGNED_NONCE_LEN);
+        assert_ne!(nonce, signer.issue_at(issued), "salt must differ");
+
+        assert_eq!(signer.verify(&nonce, issued), DigestNonceStatus::Active);
+        assert_eq!(
+            signer.verify(&nonce, issued + Duration::from_millis(29_999)),
+            DigestNonceStatus::Active
+        );
+        assert_eq!(
+            signer.verify(&nonce, issued + Duration::from_secs(30)),
+            DigestNonceStatus::Expired
+        );
+        // Slight clock skew between nodes is tolerated, a far-future stamp is not.
+        assert_eq!(
+            signer.verify(&nonce, issued - Duration::from_secs(5)),
+            DigestNonceStatus::Active
+        );
+        assert_eq!(
+            signer.verify(&nonce, issued - Duration::from_secs(6)),
+            DigestNonceStatus::Unknown
+        );
+        assert_eq!(signer.max_lifetime(), Duration::from_secs(35));
+    }
+
+    #[test]
+    fn signed_nonce_rejects_forgeries() {
+        let key = [7u8; 32];
+        let signer = DigestNonceSigner::with_key("example.test", &key, Duration::from_secs(30));
+        let now = SystemTime::now();
+        let nonce = signer.issue_at(now);
+
+        let peer = DigestNonceSigner::with_key("example.test", &key, Duration::from_secs(30));
+        assert_eq!(peer.verify(&nonce, now), DigestNonceStatus::Active);
+
+        let other_key = DigestNonceSigner::new("example.test", Duration::from_secs(30));
+        assert_eq!(other_key.verify(&nonce, now), DigestNonceStatus::Unknown);
+        let other_realm = DigestNonceSigner::with_key("other.test", &key, Duration::from_secs(30));
+        assert_eq!(other_realm.verify(&nonce, now), DigestNonceStatus::Unknown);
+
+        // Moving the issue time forward invalidates the tag.
+        let mut tampered = hex::decode(&nonce).unwrap();
+        tampered[7] ^= 1;
+        assert_eq!(
+            signer.verify(&hex::encode(tampered), now),
+            DigestNonceStatus::Unknown
+        );
+        assert_eq!(signer.verify("not-issued", now), DigestNonceStatus::Unknown);
+        assert_eq!(signer.verify(&nonce[2..], now), DigestNonceStatus::Unknown);
+    }
+
+    #[test]
+    fn challenge_carries_signed_nonce() {
+        let auth = DigestAuthenticator::new("example.test");
+        let signer = DigestNonceSigner::new("example.test", Duration::from_secs(30));
+        let challenge = auth.generate_challenge_with_nonce(signer.issue());
+        assert_eq!(
+            signer.verify(&challenge.nonce, SystemTime::now()),
+            DigestNonceStatus::Active
+        );
+        assert_eq!(challenge.realm, "example.test");
+    }
 }
@@ -1,13 +1,15 @@
 //! G.711 codec hot-path micro-benchmarks.
 //!
 //! These benches compare the public codec buffer APIs against scalar reference
-//! helpers and the existing cross-platform SIMD dispatcher. On AArch64 today
-//! the NEON dispatcher still falls back to scalar, so this bench is the guardrail
-//! before promoting any future NEON or encode-table experiment.
+//! helpers and the cross-platform SIMD dispatcher. The `g711_*_isa` groups run
+//! each kernel the host supports (scalar, SSE2, AVX2, NEON) next to the ITU
+//! reference in `codecs/g711/reference.rs`; criterion reports samples/sec via
+//! `Throughput::Elements`.
 
+use codec_core::codecs::g711::{alaw_compress, ulaw_compress};
 use codec_core::codecs::g711::{alaw_expand, ulaw_expand, G711Codec};
 use codec_core::types::{AudioCodecExt, CodecConfig, CodecType, SampleRate};
-use codec_core::utils::simd::{encode_alaw_optimized, encode_mulaw_optimized};
+use codec_core::utils::simd::{self, encode_alaw_optimized, encode_mulaw_optimized};
 use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
 
 const FRAME_SIZES: [(&str, usize); 3] =
@@ -51,19 +53,15 @@ fn bench_decode_to_buffer(c: &mut Criterion) {
         let mut output = vec![0i16; size];
         group.throughput(Throughput::Elements(size as u64));
 
-        group.bench_with_input(
-            BenchmarkId::new("pcmu_codec_scalar", name),
-            &size,
-            |b, _| {
-                let mut codec = pcmu_codec();
-                b.iter(|| {
-                    let decoded = codec
-                        .decode_to_buffer(black_box(&encoded), black_box(&mut output))
-                        .expect("decode");
-                    black_box(decoded);
-                });
-            },
-        );
+        group.bench_with_input(BenchmarkId::new("pcmu_codec", name), &size, |b, _| {
+            let mut codec = pcmu_codec();
+            b.iter(|| {
+                let decoded = codec
+                    .decode_to_buffer(black_box(&encoded), black_box(&mut output))
+                    .expect("decode");
+                black_box(decoded);
+            });
+        });
 
         group.bench_with_input(
             BenchmarkId::new("pcmu_reference_scalar", name),
@@ -78,19 +76,15 @@ fn bench_decode_to_buffer(c: &mut Criterion) {
             },
         );
 
-        group.bench_with_input(
-            BenchmarkId::new("pcma_codec_scalar", name),
-            &size,
-            |b, _| {
-                let mut codec = pcma_codec();
-                b.iter(|| {
-                    let decoded = codec
-                        .decode_to_buffer(black_box(&encoded), black_box(&mut output))
-                        .expect("decode");
-                    black_box(decoded);
-                });
-            },
-        );
+        group.bench_with_input(BenchmarkId::new("pcma_codec", name), &size, |b, _| {
+            let mut codec = pcma_codec();
+            b.iter(|| {
+                let decoded = codec
+                    .decode_to_buffer(black_box(&encoded), black_box(&mut output))
+                    .expect("decode");
+                black_box(decoded);
+            });
+        });
 
         group.bench_with_input(
             BenchmarkId::new("pcma_reference_scalar", name),
@@ -115,19 +109,15 @@ fn bench_encode_to_buffer(c: &mut Criterion) {
         let mut output = vec![0u8; size];
         group.throughput(Throughput::Elements(size as u64));
 
-        group.bench_with_input(
-            BenchmarkId::new("pcmu_codec_scalar", name),
-            &size,
-            |b, _| {
-                let mut codec = pcmu_codec();
-                b.iter(|| {
-                    let encoded = codec
-                        .encode_to_buffer(black_box(&samples), black_box(&mut output))
-                        .expect("encode");
-                    black_box(encoded);
-                });
-            },
-        );
+        group.bench_with_input(BenchmarkId::new("pcmu_codec", name), &size, |b, _| {
+            let mut codec = pcmu_codec();
+            b.iter(|| {
+                let encoded = codec
+                    .encode_to_buffer(black_box(&samples), black_box(&mut output))
+                    .expect("encode");
+                black_box(encoded);
+            });
+        });
 
         group.bench_with_input(
             BenchmarkId::new("pcmu_optimized_dispatch", name),
@@ -140,19 +130,15 @@ fn bench_encode_to_buffer(c: &mut Criterion) {
             },
         );
 
-        group.bench_with_input(
-            BenchmarkId::new("pcma_codec_scalar", name),
-            &size,
-            |b, _| {
-                let mut codec = pcma_codec();
-                b.iter(|| {
-                    let encoded = codec
-                        .encode_to_buffer(black_box(&samples), black_box(&mut output))
-                        .expect("encode");
-                    black_box(encoded);
-                });
-            },
-        );
+        group.bench_with_input(BenchmarkId::new("pcma_codec", name), &size, |b, _| {
+            let mut codec = pcma_codec();
+            b.iter(|| {
+                let encoded = codec
+                    .encode_to_buffer(black_box(&samples), black_box(&mut output))
+                    .expect("encode");
+                black_box(encoded);
+            });
+        });
 
         group.bench_with_input(
             BenchmarkId::new("pcma_optimized_dispatch", name),
@@ -168,5 +154,192 @@ fn bench_encode_to_buffer(c: &mut Criterion) {
     group.finish();
 }
 
-criterion_group!(benches, bench_decode_to_buffer, bench_encode_to_buffer);
+type EncodeKernel = fn(&[i16], &mut [u8]);
+type DecodeKernel = fn(&[u8], &mut [i16]);
+
+/// Encode kernels available on this host, keyed by ISA.
+fn encode_kernels() -> Vec<(&'static str, EncodeKernel, EncodeKernel)> {
+    let mut kernels: Vec<(&'static str, EncodeKernel, EncodeKernel)> = vec![(
+        "scalar",
+        simd::encode_mulaw_scalar,
+        simd::encode_alaw_scalar,
+    )];
+    let support = simd::get_simd_support();
+    #[cfg(target_arch = "x86_64")]
+    {
+        if support.sse2 {
+            kernels.push((
+                "sse2",
+                simd::encode_mulaw_simd_sse2,
+                simd::encode_alaw_simd_sse2,
+            ));
+        }
+        if support.avx2 {
+            kernels.push((
+                "avx2",
+                simd::encode_mulaw_simd_avx2,
+                simd::encode_alaw_simd_avx2,
+            ));
+        }
+    }
+    #[cfg(target_arch = "aarch64")]
+    {
+        if support.neon {
+            kernels.push((
+                "neon",
+                simd::encode_mulaw_simd_neon,
+                simd::encode_alaw_simd_neon,
+            ));
+        }
+    }
+    let _ = support;
+    kernels
+}
+
+/// Decode kernels available on this host, keyed by ISA.
+fn decode_kernels() -> Vec<(&'static str, DecodeKernel, DecodeKernel)> {
+    let mut kernels: Vec<(&'static str, DecodeKernel, DecodeKernel)> = vec![(
+        "scalar",
+        simd::decode_mulaw_scalar,
+        simd::decode_alaw_scalar,
+    )];
+    let support = simd::get_simd_support();
+    #[cfg(target_arch = "x86_64")]
+    {
+        if support.sse2 {
+            kernels.push((
+                "sse2",
+                simd::decode_mulaw_simd_sse2,
+                simd::decode_alaw_simd_sse2,
+            ));
+        }
+        if support.avx2 {
+            kernels.push((
+                "avx2",
+                simd::decode_mulaw_simd_avx2,
+                simd::decode_alaw_simd_avx2,
+            ));
+        }
+    }
+    #[cfg(target_arch = "aarch64")]
+    {
+        if support.neon {
+            kernels.push((
+                "neon",
+                simd::decode_mulaw_simd_neon,
+                simd::decode_alaw_simd_neon,
+            ));
+        }
+    }
+    let _ = support;
+    kernels
+}
+
+fn bench_encode_isa(c: &mut Criterion) {
+    let mut group = c.benchmark_group("g711_encode_isa");
+    for (name, size) in FRAME_SIZES {
+        let samples = pcm_samples(size);
+        let mut output = vec![0u8; size];
+        group.throughput(Throughput::Elements(size as u64));
+
+        group.bench_with_input(BenchmarkId::new("pcmu_reference", name), &size, |b, _| {
+            b.iter(|| {
+                for (out, &sample) in output.iter_mut().zip(samples.iter()) {
+                    *out = ulaw_compress(sample);
+                }
+                black_box(&output);
+            });
+        });
+        group.bench_with_input(BenchmarkId::new("pcma_reference", name), &size, |b, _| {
+            b.iter(|| {
+                for (out, &sample) in output.iter_mut().zip(samples.iter()) {
+                    *out = alaw_compress(sample);
+                }
+                black_box(&output);
+            });
+        });
+
+        for (isa, mulaw, alaw) in encode_kernels() {
+            group.bench_with_input(
+                BenchmarkId::new(format!("pcmu_{isa}"), name),
+                &size,
+                |b, _| {
+                    b.iter(|| {
+                        mulaw(black_box(&samples), black_box(&mut output));
+                        black_box(&output);
+                    });
+                },
+            );
+            group.bench_with_input(
+                BenchmarkId::new(format!("pcma_{isa}"), name),
+                &size,
+                |b, _| {
+                    b.iter(|| {
+                        alaw(black_box(&samples), black_box(&mut output));
+                        black_box(&output);
+                    });
+                },
+            );
+        }
+    }
+    group.finish();
+}
+
+fn bench_decode_isa(c: &mut Criterion) {
+    let mut group = c.benchmark_group("g711_decode_isa");
+    for (name, size) in FRAME_SIZES {
+        let encoded = encoded_bytes(size);
+        let mut output = vec![0i16; size];
+        group.throughput(Throughput::Elements(size as u64));
+
+        group.bench_with_input(BenchmarkId::new("pcmu_reference", name), &size, |b, _| {
+            b.iter(|| {
+                for (out, &byte) in output.iter_mut().zip(encoded.iter()) {
+                    *out = ulaw_expand(byte);
+                }
+                black_box(&output);
+            });
+        });
+        group.bench_with_input(BenchmarkId::new("pcma_reference", name), &size, |b, _| {
+            b.iter(|| {
+                for (out, &byte) in output.iter_mut().zip(encoded.iter()) {
+                    *out = alaw_expand(byte);
+                }
+                black_box(&output);
+            });
+        });
+
+        for (isa, mulaw, alaw) in decode_kernels() {
+            group.bench_with_input(
+                BenchmarkId::new(format!("pcmu_{isa}"), name),
+                &size,
+                |b, _| {
+                    b.iter(|| {
+                        mulaw(black_box(&encoded), black_box(&mut output));
+                        black_box(&output);
+                    });
+                },
+            );
+            group.bench_with_input(
+                BenchmarkId::new(format!("pcma_{isa}"), name),
+                &size,
+                |b, _| {
+                    b.iter(|| {
+                        alaw(black_box(&encoded), black_box(&mut output));
+                        black_box(&output);
+                    });
+                },
+            );
+        }
+    }
+    group.finish();
+}
+
+criterion_group!(
+    benches,
+    bench_decode_to_buffer,
+    bench_encode_to_buffer,
+    bench_encode_isa,
+    bench_decode_isa
+);
 criterion_main!(benches);
@@ -0,0 +1,104 @@
+//! Opus codec hot-path micro-benchmarks.
+//!
+//! Measures libopus encode, decode and packet-loss concealment for one 20 ms
+//! mono frame at 48 kHz across low, default and maximum encoder complexity.
+//! All groups use the zero-allocation buffer APIs so the numbers reflect
+//! codec cost only. Requires the `opus` feature.
+
+use codec_core::codecs::opus::{OpusCodec, MAX_PACKET_SIZE};
+use codec_core::types::{AudioCodecExt, CodecConfig, CodecType, SampleRate};
+use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+
+const FRAME_SAMPLES: usize = 960;
+const COMPLEXITIES: [u8; 3] = [0, 5, 10];
+
+fn pcm_samples(size: usize) -> Vec<i16> {
+    (0..size)
+        .map(|i| {
+            let phase = (i as f32 * 440.0 * std::f32::consts::TAU / 48_000.0).sin();
+            (phase * 12_000.0) as i16
+        })
+        .collect()
+}
+
+fn opus_codec(complexity: u8) -> OpusCodec {
+    OpusCodec::new(
+        CodecConfig::new(CodecType::Opus)
+            .with_sample_rate(SampleRate::Rate48000)
+            .with_channels(1)
+            .with_frame_size_ms(20.0)
+            .with_opus_complexity(complexity),
+    )
+    .expect("Opus codec")
+}
+
+fn bench_encode(c: &mut Criterion) {
+    let mut group = c.benchmark_group("opus_encode");
+    group.throughput(Throughput::Elements(FRAME_SAMPLES as u64));
+    let samples = pcm_samples(FRAME_SAMPLES);
+
+    for complexity in COMPLEXITIES {
+        let mut codec = opus_codec(complexity);
+        let mut packet = [0u8; MAX_PACKET_SIZE];
+        group.bench_with_input(
+            BenchmarkId::new("complexity", complexity),
+            &samples,
+            |b, samples| {
+                b.iter(|| {
+                    codec
+                        .encode_to_buffer(black_box(samples), black_box(&mut packet))
+                        .unwrap()
+                })
+            },
+        );
+    }
+
+    group.finish();
+}
+
+fn bench_decode(c: &mut Criterion) {
+    let mut group = c.benchmark_group("opus_decode");
+    group.throughput(Throughput::Elements(FRAME_SAMPLES as u64));
+    let samples = pcm_samples(FRAME_SAMPLES);
+
+    for complexity in COMPLEXITIES {
+        let mut codec = opus_codec(complexity);
+        let mut packet = [0u8; MAX_PACKET_SIZE];
+        let len = codec.encode_to_buffer(&samples, &mut packet).unwrap();
+        let mut output = [0i16; FRAME_SAMPLES];
+        group.bench_with_input(
+            BenchmarkId::new("complexity", complexity),
+            &packet[..len],
+            |b, packet| {
+                b.iter(|| {
+                    codec
+                        .decode_to_buffer(black_box(packet), black_box(&mut output))
+                        .unwrap()
+                })
+            },
+        );
+    }
+
+    group.finish();
+}
+
+fn bench_plc(c: &mut Criterion) {
+    let mut group = c.benchmark_group("opus_plc");
+    group.throughput(Throughput::Elements(FRAME_SAMPLES as u64));
+
+    let mut codec = opus_codec(5);
+    let samples = pcm_samples(FRAME_SAMPLES);
+    let mut packet = [0u8; MAX_PACKET_SIZE];
+    let mut output = [0i16; FRAME_SAMPLES];
+    let len = codec.encode_to_buffer(&samples, &mut packet).unwrap();
+    codec.decode_to_buffer(&packet[..len], &mut output).unwrap();
+
+    group.bench_function("decode_missing", |b| {
+        b.iter(|| codec.decode_missing(black_box(&mut output)).unwrap())
+    });
+
+    group.finish();
+}
+
+criterion_group!(benches, bench_encode, bench_decode, bench_plc);
+criterion_main!(benches);
@@ -9,6 +9,7 @@
 //! - Both A-law and μ-law encoding/decoding
 //! - Simple single-sample functions
 //! - Lookup table optimized for performance
+//! - SSE2/AVX2/NEON buffer kernels for `encode_to_buffer`/`decode_to_buffer`
 //!
 //! ## Usage
 //!
@@ -59,6 +60,7 @@
 //! ```
 
 use crate::error::CodecError;
+use crate::utils::simd;
 
 mod reference;
 
@@ -153,30 +155,22 @@ impl G711Codec {
 
     /// Compress samples using the configured variant
     pub fn compress(&self, samples: &[i16]) -> Result<Vec<u8>, CodecError> {
+        let mut output = vec![0u8; samples.len()];
         match self.variant {
-            G711Variant::ALaw => Ok(samples
-                .iter()
-                .map(|&sample| alaw_compress(sample))
-                .collect()),
-            G711Variant::MuLaw => Ok(samples
-                .iter()
-                .map(|&sample| ulaw_compress(sample))
-                .collect()),
+            G711Variant::ALaw => simd::encode_alaw_optimized(samples, &mut output),
+            G711Variant::MuLaw => simd::encode_mulaw_optimized(samples, &mut output),
         }
+        Ok(output)
     }
 
     /// Expand samples using the configured variant
     pub fn expand(&self, compressed: &[u8]) -> Result<Vec<i16>, CodecError> {
+        let mut output = vec![0i16; compressed.len()];
         match self.variant {
-            G711Variant::ALaw => Ok(compressed
-                .iter()
-                .map(|&sample| alaw_expand(sample))
-                .collect()),
-            G711Variant::MuLaw => Ok(compressed
-                .iter()
-                .map(|&sample| ulaw_expand(sample))
-                .collect()),
+            G711Variant::ALaw => simd::decode_alaw_optimized(compressed, &mut output),
+            G711Variant::MuLaw => simd::decode_mulaw_optimized(compressed, &mut output),
         }
+        Ok(output)
     }
 
     /// Compress samples using A-law
@@ -266,17 +260,11 @@ impl crate::types::AudioCodecExt for G711Codec {
             });
         }
 
+        // The SIMD kernels are bit-exact with the reference functions.
+        let output = &mut output[..samples.len()];
         match self.variant {
-            G711Variant::ALaw => {
-                for (i, &sample) in samples.iter().enumerate() {
-                    output[i] = alaw_compress(sample);
-                }
-            }
-            G711Variant::MuLaw => {
-                for (i, &sample) in samples.iter().enumerate() {
-                    output[i] = ulaw_compress(sample);
-                }
-            }
+            G711Variant::ALaw => simd::encode_alaw_optimized(samples, output),
+            G711Variant::MuLaw => simd::encode_mulaw_optimized(samples, output),
         }
 
         Ok(samples.len())
@@ -290,17 +278,10 @@ impl crate::types::AudioCodecExt for G711Codec {
             });
         }
 
+        let output = &mut output[..data.len()];
         match self.variant {
-            G711Variant::ALaw => {
-                for (i, &encoded) in data.iter().enumerate() {
-                    output[i] = alaw_expand(encoded);
-                }
-            }
-            G711Variant::MuLaw => {
-                for (i, &encoded) in data.iter().enumerate() {
-                    output[i] = ulaw_expand(encoded);
-                }
-            }
+            G711Variant::ALaw => simd::decode_alaw_optimized(data, output),
+            G711Variant::MuLaw => simd::decode_mulaw_optimized(data, output),
         }
 
         Ok(data.len())
@@ -433,3 +433,32 @@ fn test_itu_reference_equivalence() {
 
     println!("✅ All ITU-T reference equivalence tests passed!");
 }
+
+/// The buffer APIs dispatch to SIMD kernels; they must stay bit-exact with
+/// the per-sample reference for every input.
+#[test]
+fn test_buffer_kernels_match_reference_exhaustively() {
+    use crate::codecs::g711::{G711Codec, G711Variant};
+    use crate::types::AudioCodecExt;
+
+    let samples: Vec<i16> = (i16::MIN..=i16::MAX).collect();
+    let codes: Vec<u8> = (0..=255u8).cycle().take(256 * 4 + 3).collect();
+
+    for variant in [G711Variant::ALaw, G711Variant::MuLaw] {
+        let (compress, expand): (fn(i16) -> u8, fn(u8) -> i16) = match variant {
+            G711Variant::ALaw => (alaw_compress, alaw_expand),
+            G711Variant::MuLaw => (ulaw_compress, ulaw_expand),
+        };
+        let mut codec = G711Codec::new(variant);
+
+        let mut encoded = vec![0u8; samples.len()];
+        codec.encode_to_buffer(&samples, &mut encoded).unwrap();
+        let expected: Vec<u8> = samples.iter().map(|&s| compress(s)).collect();
+        assert_eq!(encoded, expected, "{:?} encode_to_buffer mismatch", variant);
+
+        let mut decoded = vec![0i16; codes.len()];
+        codec.decode_to_buffer(&codes, &mut decoded).unwrap();
+        let expected: Vec<i16> = codes.iter().map(|&c| expand(c)).collect();
+        assert_eq!(decoded, expected, "{:?} decode_to_buffer mismatch", variant);
+    }
+}
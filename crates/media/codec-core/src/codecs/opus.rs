@@ -3,25 +3,55 @@
 //! This module implements the Opus codec, a modern audio codec standardized
 //! by the Internet Engineering Task Force (IETF) in RFC 6716. Opus combines
 //! the best features of both speech and music codecs with very low latency.
+//!
+//! ## Backends
+//!
+//! - **`opus` feature** — real encoding/decoding through libopus
+//!   (`audiopus_sys`, the same binding media-core's `opus` crate links). All
+//!   [`OpusConfig`] knobs are applied as encoder CTLs, packet-loss concealment
+//!   is available through [`OpusCodec::decode_missing`] and in-band FEC
+//!   recovery through [`OpusCodec::decode_fec`]. `encode_to_buffer` and
+//!   `decode_to_buffer` call straight into libopus with the caller's buffers
+//!   and allocate nothing per frame.
+//! - **`opus-sim` feature only** — a bitrate-shaped simulator for tests that
+//!   must not link a C library.
 
 use crate::error::{CodecError, Result};
 use crate::types::{AudioCodec, AudioCodecExt, CodecConfig, CodecInfo, SampleRate};
 use crate::utils::validate_opus_frame;
-use tracing::{debug, trace, warn};
+use tracing::debug;
+#[cfg(not(feature = "opus"))]
+use tracing::trace;
 
 // Re-export OpusApplication from types to avoid duplication
 pub use crate::types::OpusApplication;
 
+/// Output buffer size libopus recommends for a single `opus_encode` call.
+pub const MAX_PACKET_SIZE: usize = 4000;
+
+/// Longest frame Opus can carry in one packet (120 ms).
+const MAX_FRAME_MS: u32 = 120;
+
 /// Opus codec implementation
 pub struct OpusCodec {
     /// Sample rate (8, 12, 16, 24, or 48 kHz)
     sample_rate: u32,
     /// Number of channels (1 or 2)
     channels: u8,
-    /// Frame size in samples
+    /// Frame size in samples (per channel)
     frame_size: usize,
     /// Codec configuration
     config: OpusConfig,
+    /// libopus encoder state
+    #[cfg(feature = "opus")]
+    encoder: ffi::Encoder,
+    /// libopus decoder state
+    #[cfg(feature = "opus")]
+    decoder: ffi::Decoder,
+    /// Packet buffer `encode` runs libopus into before copying out the
+    /// encoded bytes
+    #[cfg(feature = "opus")]
+    encode_scratch: Vec<u8>,
 }
 
 /// Opus codec configuration
@@ -94,10 +124,11 @@ impl OpusCodec {
             (sample_rate * 20 / 1000) as usize
         };
 
-        // Create Opus configuration
+        // Create Opus configuration; a top-level bitrate overrides the
+        // Opus-specific default.
         let opus_config = OpusConfig {
             application: config.parameters.opus.application,
-            bitrate: config.parameters.opus.bitrate,
+            bitrate: config.bitrate.unwrap_or(config.parameters.opus.bitrate),
             vbr: config.parameters.opus.vbr,
             cvbr: config.parameters.opus.cvbr,
             complexity: config.parameters.opus.complexity,
@@ -107,19 +138,58 @@ impl OpusCodec {
             force_mono: config.parameters.opus.force_mono,
         };
 
+        validate_bitrate(opus_config.bitrate)?;
+        if opus_config.complexity > 10 {
+            return Err(CodecError::invalid_config("Complexity must be 0-10"));
+        }
+        if opus_config.packet_loss_perc > 100 {
+            return Err(CodecError::invalid_config("Packet loss must be 0-100%"));
+        }
+
         debug!(
             "Creating Opus codec: {}Hz, {}ch, {}bps, {:?} mode",
             sample_rate, config.channels, opus_config.bitrate, opus_config.application
         );
 
+        #[cfg(feature = "opus")]
+        let (encoder, decoder) = {
+            let mut encoder = ffi::Encoder::new(
+                sample_rate,
+                config.channels,
+                ffi::application(opus_config.application),
+            )
+            .map_err(|code| CodecError::InitializationFailed {
+                reason: format!("opus_encoder_create: {}", ffi::error_string(code)),
+            })?;
+            apply_encoder_config(&mut encoder, &opus_config)?;
+
+            let decoder = ffi::Decoder::new(sample_rate, config.channels).map_err(|code| {
+                CodecError::InitializationFailed {
+                    reason: format!("opus_decoder_create: {}", ffi::error_string(code)),
+                }
+            })?;
+            (encoder, decoder)
+        };
+
         Ok(Self {
             sample_rate,
             channels: config.channels,
             frame_size,
             config: opus_config,
+            #[cfg(feature = "opus")]
+            encoder,
+            #[cfg(feature = "opus")]
+            decoder,
+            #[cfg(feature = "opus")]
+            encode_scratch: vec![0u8; MAX_PACKET_SIZE],
         })
     }
 
+    /// Current encoder configuration
+    pub fn config(&self) -> &OpusConfig {
+        &self.config
+    }
+
     /// Get the compression ratio (variable for Opus)
     pub fn compression_ratio(&self) -> f32 {
         let uncompressed_bits = self.frame_size as f32 * 16.0 * self.channels as f32;
@@ -130,13 +200,15 @@ impl OpusCodec {
 
     /// Set the bitrate
     pub fn set_bitrate(&mut self, bitrate: u32) -> Result<()> {
-        if bitrate < 6000 || bitrate > 510000 {
-            return Err(CodecError::InvalidBitrate {
-                bitrate,
-                min: 6000,
-                max: 510000,
-            });
-        }
+        validate_bitrate(bitrate)?;
+
+        #[cfg(feature = "opus")]
+        encoder_ctl(
+            &mut self.encoder,
+            ffi::SET_BITRATE,
+            bitrate as i32,
+            "bitrate",
+        )?;
 
         self.config.bitrate = bitrate;
         debug!("Opus bitrate set to {} bps", bitrate);
@@ -149,12 +221,167 @@ impl OpusCodec {
             return Err(CodecError::invalid_config("Complexity must be 0-10"));
         }
 
+        #[cfg(feature = "opus")]
+        encoder_ctl(
+            &mut self.encoder,
+            ffi::SET_COMPLEXITY,
+            complexity as i32,
+            "complexity",
+        )?;
+
         self.config.complexity = complexity;
         debug!("Opus complexity set to {}", complexity);
         Ok(())
     }
 
+    /// Set the expected packet loss (0-100%), which steers how much
+    /// redundancy in-band FEC spends
+    pub fn set_packet_loss_perc(&mut self, packet_loss_perc: u8) -> Result<()> {
+        if packet_loss_perc > 100 {
+            return Err(CodecError::invalid_config("Packet loss must be 0-100%"));
+        }
+
+        #[cfg(feature = "opus")]
+        encoder_ctl(
+            &mut self.encoder,
+            ffi::SET_PACKET_LOSS_PERC,
+            packet_loss_perc as i32,
+            "packet loss",
+        )?;
+
+        self.config.packet_loss_perc = packet_loss_perc;
+        debug!("Opus expected packet loss set to {}%", packet_loss_perc);
+        Ok(())
+    }
+
+    /// Enable or disable in-band FEC
+    pub fn set_inband_fec(&mut self, enabled: bool) -> Result<()> {
+        #[cfg(feature = "opus")]
+        encoder_ctl(
+            &mut self.encoder,
+            ffi::SET_INBAND_FEC,
+            enabled as i32,
+            "in-band FEC",
+        )?;
+
+        self.config.inband_fec = enabled;
+        Ok(())
+    }
+
+    /// Enable or disable DTX
+    pub fn set_dtx(&mut self, enabled: bool) -> Result<()> {
+        #[cfg(feature = "opus")]
+        encoder_ctl(&mut self.encoder, ffi::SET_DTX, enabled as i32, "DTX")?;
+
+        self.config.dtx = enabled;
+        Ok(())
+    }
+
+    /// Whether the encoder is currently in DTX (its last packets carried no
+    /// speech and need not be sent)
+    pub fn is_in_dtx(&mut self) -> bool {
+        #[cfg(feature = "opus")]
+        {
+            self.encoder.get(ffi::GET_IN_DTX).is_ok_and(|v| v != 0)
+        }
+
+        #[cfg(not(feature = "opus"))]
+        {
+            false
+        }
+    }
+
+    /// Conceal one lost frame (packet-loss concealment).
+    ///
+    /// Writes `frame_size() * channels` samples into `output` and returns
+    /// the number of samples written. Call once per missing packet, in
+    /// sequence order, so the decoder state stays continuous.
+    pub fn decode_missing(&mut self, output: &mut [i16]) -> Result<usize> {
+        let needed = self.frame_size * self.channels as usize;
+        if output.len() < needed {
+            return Err(CodecError::BufferTooSmall {
+                needed,
+                actual: output.len(),
+            });
+        }
+
+        #[cfg(feature = "opus")]
+        {
+            let decoded = self
+                .decoder
+                .decode(None, &mut output[..needed], self.frame_size, false)
+                .map_err(|code| CodecError::DecodingFailed {
+                    reason: format!("opus PLC: {}", ffi::error_string(code)),
+                })?;
+            Ok(decoded * self.channels as usize)
+        }
+
+        #[cfg(not(feature = "opus"))]
+        {
+            output[..needed].fill(0);
+            Ok(needed)
+        }
+    }
+
+    /// Recover a lost frame from the in-band FEC data carried by the packet
+    /// that followed it.
+    ///
+    /// Decode the lost frame with this call first, then decode `next_packet`
+    /// normally. Falls back to plain concealment if the packet carries no
+    /// FEC data.
+    pub fn decode_fec(&mut self, next_packet: &[u8], output: &mut [i16]) -> Result<usize> {
+        #[cfg(feature = "opus")]
+        {
+            let needed = self.frame_size * self.channels as usize;
+            if output.len() < needed {
+                return Err(CodecError::BufferTooSmall {
+                    needed,
+                    actual: output.len(),
+                });
+            }
+            if next_packet.is_empty() {
+                return self.decode_missing(output);
+            }
+
+            let decoded = self
+                .decoder
+                .decode(
+                    Some(next_packet),
+                    &mut output[..needed],
+                    self.frame_size,
+                    true,
+                )
+                .map_err(|code| CodecError::DecodingFailed {
+                    reason: format!("opus FEC: {}", ffi::error_string(code)),
+                })?;
+            Ok(decoded * self.channels as usize)
+        }
+
+        #[cfg(not(feature = "opus"))]
+        {
+            let _ = next_packet;
+            self.decode_missing(output)
+        }
+    }
+
+    /// Validate an interleaved input frame and return its per-channel length
+    fn samples_per_channel(&self, samples: &[i16]) -> Result<usize> {
+        let channels = self.channels as usize;
+        if samples.len() % channels != 0 {
+            return Err(CodecError::invalid_format(
+                "Interleaved sample count must be a multiple of the channel count",
+            ));
+        }
+        let per_channel = samples.len() / channels;
+        validate_opus_frame(
+            &samples[..per_channel],
+            SampleRate::from_hz(self.sample_rate),
+        )?;
+        Ok(per_channel)
+    }
+
     /// Simulate Opus encoding
+    #[cfg(not(feature = "opus"))]
     fn simulate_encode(&mut self, samples: &[i16]) -> Result<Vec<u8>> {
         // Calculate target size based on bitrate
         let frame_duration_ms =
@@ -173,6 +400,7 @@ impl OpusCodec {
     }
 
     /// Simulate Opus decoding
+    #[cfg(not(feature = "opus"))]
     fn simulate_decode(&mut self, data: &[u8]) -> Result<Vec<i16>> {
         let mut samples = vec![0i16; self.frame_size * self.channels as usize];
 
@@ -186,21 +414,91 @@ impl OpusCodec {
     }
 }
 
+fn validate_bitrate(bitrate: u32) -> Result<()> {
+    if !(6000..=510000).contains(&bitrate) {
+        return Err(CodecError::InvalidBitrate {
+            bitrate,
+            min: 6000,
+            max: 510000,
+        });
+    }
+    Ok(())
+}
+
+#[cfg(feature = "opus")]
+fn encoder_ctl(encoder: &mut ffi::Encoder, request: i32, value: i32, what: &str) -> Result<()> {
+    encoder
+        .ctl(request, value)
+        .map_err(|code| CodecError::InvalidConfig {
+            details: format!("Failed to set Opus {}: {}", what, ffi::error_string(code)),
+        })
+}
+
+/// Push every `OpusConfig` field into the encoder
+#[cfg(feature = "opus")]
+fn apply_encoder_config(encoder: &mut ffi::Encoder, config: &OpusConfig) -> Result<()> {
+    encoder_ctl(encoder, ffi::SET_BITRATE, config.bitrate as i32, "bitrate")?;
+    encoder_ctl(encoder, ffi::SET_VBR, config.vbr as i32, "VBR")?;
+    encoder_ctl(
+        encoder,
+        ffi::SET_VBR_CONSTRAINT,
+        config.cvbr as i32,
+        "constrained VBR",
+    )?;
+    encoder_ctl(
+        encoder,
+        ffi::SET_COMPLEXITY,
+        config.complexity as i32,
+        "complexity",
+    )?;
+    encoder_ctl(
+        encoder,
+        ffi::SET_INBAND_FEC,
+        config.inband_fec as i32,
+        "in-band FEC",
+    )?;
+    encoder_ctl(
+        encoder,
+        ffi::SET_PACKET_LOSS_PERC,
+        config.packet_loss_perc as i32,
+        "packet loss",
+    )?;
+    encoder_ctl(encoder, ffi::SET_DTX, config.dtx as i32, "DTX")?;
+    encoder_ctl(
+        encoder,
+        ffi::SET_FORCE_CHANNELS,
+        if config.force_mono { 1 } else { ffi::AUTO },
+        "forced channels",
+    )
+}
+
 impl AudioCodec for OpusCodec {
     fn encode(&mut self, samples: &[i16]) -> Result<Vec<u8>> {
-        // Validate input
-        validate_opus_frame(samples, SampleRate::from_hz(self.sample_rate))?;
+        #[cfg(feature = "opus")]
+        {
+            let mut scratch = std::mem::take(&mut self.encode_scratch);
+            let encoded = self
+                .encode_to_buffer(samples, &mut scratch)
+                .map(|len| scratch[..len].to_vec());
+            self.encode_scratch = scratch;
+            encoded
+        }
 
-        // Simulate Opus encoding
-        let encoded = self.simulate_encode(samples)?;
+        #[cfg(not(feature = "opus"))]
+        {
+            self.samples_per_channel(samples)?;
 
-        trace!(
-            "Opus encoded {} samples to {} bytes",
-            samples.len(),
-            encoded.len()
-        );
+            // Simulate Opus encoding
+            let encoded = self.simulate_encode(samples)?;
 
-        Ok(encoded)
+            trace!(
+                "Opus encoded {} samples to {} bytes",
+                samples.len(),
+                encoded.len()
+            );
+
+            Ok(encoded)
+        }
     }
 
     fn decode(&mut self, data: &[u8]) -> Result<Vec<i16>> {
@@ -210,16 +508,32 @@ impl AudioCodec for OpusCodec {
             });
         }
 
-        // Simulate Opus decoding
-        let decoded = self.simulate_decode(data)?;
+        #[cfg(feature = "opus")]
+        {
+            let per_channel = ffi::packet_samples(data, self.sample_rate).map_err(|code| {
+                CodecError::InvalidPayload {
+                    details: format!("Malformed Opus packet: {}", ffi::error_string(code)),
+                }
+            })?;
+            let mut decoded = vec![0i16; per_channel * self.channels as usize];
+            let len = self.decode_to_buffer(data, &mut decoded)?;
+            decoded.truncate(len);
+            Ok(decoded)
+        }
 
-        trace!(
-            "Opus decoded {} bytes to {} samples",
-            data.len(),
-            decoded.len()
-        );
+        #[cfg(not(feature = "opus"))]
+        {
+            // Simulate Opus decoding
+            let decoded = self.simulate_decode(data)?;
+
+            trace!(
+                "Opus decoded {} bytes to {} samples",
+                data.len(),
+                decoded.len()
+            );
 
-        Ok(decoded)
+            Ok(decoded)
+        }
     }
 
     fn info(&self) -> CodecInfo {
@@ -234,6 +548,15 @@ impl AudioCodec for OpusCodec {
     }
 
     fn reset(&mut self) -> Result<()> {
+        #[cfg(feature = "opus")]
+        {
+            let reset_failed = |code| CodecError::ResetFailed {
+                reason: ffi::error_string(code),
+            };
+            self.encoder.reset().map_err(reset_failed)?;
+            self.decoder.reset().map_err(reset_failed)?;
+        }
+
         debug!("Opus codec reset");
         Ok(())
     }
@@ -249,28 +572,50 @@ impl AudioCodec for OpusCodec {
 
 impl AudioCodecExt for OpusCodec {
     fn encode_to_buffer(&mut self, samples: &[i16], output: &mut [u8]) -> Result<usize> {
-        // Validate input
-        validate_opus_frame(samples, SampleRate::from_hz(self.sample_rate))?;
+        let per_channel = self.samples_per_channel(samples)?;
+
+        #[cfg(feature = "opus")]
+        {
+            self.encoder
+                .encode(samples, per_channel, output)
+                .map_err(|code| {
+                    if code == ffi::BUFFER_TOO_SMALL {
+                        CodecError::BufferTooSmall {
+                            needed: MAX_PACKET_SIZE,
+                            actual: output.len(),
+                        }
+                    } else {
+                        CodecError::EncodingFailed {
+                            reason: format!("opus_encode: {}", ffi::error_string(code)),
+                        }
+                    }
+                })
+        }
 
-        // Simulate Opus encoding
-        let encoded = self.simulate_encode(samples)?;
+        #[cfg(not(feature = "opus"))]
+        {
+            let _ = per_channel;
 
-        if output.len() < encoded.len() {
-            return Err(CodecError::BufferTooSmall {
-                needed: encoded.len(),
-                actual: output.len(),
-            });
-        }
+            // Simulate Opus encoding
+            let encoded = self.simulate_encode(samples)?;
 
-        output[..encoded.len()].copy_from_slice(&encoded);
+            if output.len() < encoded.len() {
+                return Err(CodecError::BufferTooSmall {
+                    needed: encoded.len(),
+                    actual: output.len(),
+                });
+            }
 
-        trace!(
-            "Opus encoded {} samples to {} bytes (zero-alloc)",
-            samples.len(),
-            encoded.len()
-        );
+            output[..encoded.len()].copy_from_slice(&encoded);
+
+            trace!(
+                "Opus encoded {} samples to {} bytes (zero-alloc)",
+                samples.len(),
+                encoded.len()
+            );
 
-        Ok(encoded.len())
+            Ok(encoded.len())
+        }
     }
 
     fn decode_to_buffer(&mut self, data: &[u8], output: &mut [i16]) -> Result<usize> {
@@ -280,38 +625,280 @@ impl AudioCodecExt for OpusCodec {
             });
         }
 
-        // Simulate Opus decoding
-        let decoded = self.simulate_decode(data)?;
-
-        if output.len() < decoded.len() {
-            return Err(CodecError::BufferTooSmall {
-                needed: decoded.len(),
-                actual: output.len(),
-            });
+        #[cfg(feature = "opus")]
+        {
+            let channels = self.channels as usize;
+            let capacity =
+                (output.len() / channels).min((self.sample_rate * MAX_FRAME_MS / 1000) as usize);
+            let decoded = self
+                .decoder
+                .decode(
+                    Some(data),
+                    &mut output[..capacity * channels],
+                    capacity,
+                    false,
+                )
+                .map_err(|code| {
+                    if code == ffi::BUFFER_TOO_SMALL {
+                        CodecError::BufferTooSmall {
+                            needed: self.max_decoded_size(data.len()),
+                            actual: output.len(),
+                        }
+                    } else {
+                        CodecError::DecodingFailed {
+                            reason: format!("opus_decode: {}", ffi::error_string(code)),
+                        }
+                    }
+                })?;
+            Ok(decoded * channels)
         }
 
-        output[..decoded.len()].copy_from_slice(&decoded);
+        #[cfg(not(feature = "opus"))]
+        {
+            // Simulate Opus decoding
+            let decoded = self.simulate_decode(data)?;
 
-        trace!(
-            "Opus decoded {} bytes to {} samples (zero-alloc)",
-            data.len(),
-            decoded.len()
-        );
+            if output.len() < decoded.len() {
+                return Err(CodecError::BufferTooSmall {
+                    needed: decoded.len(),
+                    actual: output.len(),
+                });
+            }
+
+            output[..decoded.len()].copy_from_slice(&decoded);
 
-        Ok(decoded.len())
+            trace!(
+                "Opus decoded {} bytes to {} samples (zero-alloc)",
+                data.len(),
+                decoded.len()
+            );
+
+            Ok(decoded.len())
+        }
     }
 
-    fn max_encoded_size(&self, input_samples: usize) -> usize {
-        // Opus maximum frame size is 1275 bytes
-        let bits_per_sample = self.config.bitrate as f32 / self.sample_rate as f32;
-        let max_bytes = (input_samples as f32 * bits_per_sample / 8.0) as usize;
-        max_bytes.min(1275)
+    fn max_encoded_size(&self, _input_samples: usize) -> usize {
+        MAX_PACKET_SIZE
     }
 
     fn max_decoded_size(&self, _input_bytes: usize) -> usize {
-        // Opus can decode to various frame sizes
-        let max_frame_ms = 60.0; // 60ms is the maximum
-        ((self.sample_rate as f32 * max_frame_ms / 1000.0) as usize) * self.channels as usize
+        // A single packet carries at most 120 ms per channel
+        ((self.sample_rate * MAX_FRAME_MS / 1000) as usize) * self.channels as usize
+    }
+}
+
+/// Thin RAII wrapper over the libopus C API.
+#[cfg(feature = "opus")]
+mod ffi {
+    use crate::types::OpusApplication;
+    use audiopus_sys as sys;
+    use std::ffi::CStr;
+    use std::os::raw::c_int;
+    use std::ptr::NonNull;
+
+    // Return codes and CTL request ids from opus_defines.h.
+    const OK: c_int = 0;
+    pub(super) const BUFFER_TOO_SMALL: c_int = -2;
+    pub(super) const AUTO: c_int = -1000;
+
+    pub(super) const SET_BITRATE: c_int = 4002;
+    pub(super) const SET_VBR: c_int = 4006;
+    pub(super) const SET_COMPLEXITY: c_int = 4010;
+    pub(super) const SET_INBAND_FEC: c_int = 4012;
+    pub(super) const SET_PACKET_LOSS_PERC: c_int = 4014;
+    pub(super) const SET_DTX: c_int = 4016;
+    pub(super) const SET_VBR_CONSTRAINT: c_int = 4020;
+    pub(super) const SET_FORCE_CHANNELS: c_int = 4022;
+    const RESET_STATE: c_int = 4028;
+    pub(super) const GET_IN_DTX: c_int = 4049;
+
+    pub(super) fn application(application: OpusApplication) -> c_int {
+        match application {
+            OpusApplication::Voip => 2048,
+            OpusApplication::Audio => 2049,
+            OpusApplication::RestrictedLowDelay => 2051,
+        }
+    }
+
+    pub(super) fn error_string(code: c_int) -> String {
+        // SAFETY: opus_strerror returns a pointer to a static C string for
+        // every input value.
+        unsafe { CStr::from_ptr(sys::opus_strerror(code)) }
+            .to_string_lossy()
+            .into_owned()
+    }
+
+    fn check(ret: c_int) -> Result<usize, c_int> {
+        if ret < OK {
+            Err(ret)
+        } else {
+            Ok(ret as usize)
+        }
+    }
+
+    /// Number of samples per channel in a packet
+    pub(super) fn packet_samples(packet: &[u8], sample_rate: u32) -> Result<usize, c_int> {
+        // SAFETY: pointer/length come from a live slice.
+        check(unsafe {
+            sys::opus_packet_get_nb_samples(
+                packet.as_ptr(),
+                packet.len().min(i32::MAX as usize) as i32,
+                sample_rate as i32,
+            )
+        })
+    }
+
+    pub(super) struct Encoder(NonNull<sys::OpusEncoder>);
+
+    // SAFETY: the encoder state is only touched through `&mut self`.
+    unsafe impl Send for Encoder {}
+    unsafe impl Sync for Encoder {}
+
+    impl Encoder {
+        pub(super) fn new(
+            sample_rate: u32,
+            channels: u8,
+            application: c_int,
+        ) -> Result<Self, c_int> {
+            let mut error = OK;
+            // SAFETY: plain constructor call; `error` outlives the call.
+            let state = unsafe {
+                sys::opus_encoder_create(
+                    sample_rate as i32,
+                    channels as c_int,
+                    application,
+                    &mut error,
+                )
+            };
+            match NonNull::new(state) {
+                Some(state) if error == OK => Ok(Self(state)),
+                Some(state) => {
+                    // SAFETY: state was just created and is not shared.
+                    unsafe { sys::opus_encoder_destroy(state.as_ptr()) };
+                    Err(error)
+                }
+                None => Err(error),
+            }
+        }
+
+        pub(super) fn ctl(&mut self, request: c_int, value: i32) -> Result<(), c_int> {
+            // SAFETY: every SET request used here takes one opus_int32.
+            check(unsafe { sys::opus_encoder_ctl(self.0.as_ptr(), request, value) }).map(|_| ())
+        }
+
+        pub(super) fn get(&mut self, request: c_int) -> Result<i32, c_int> {
+            let mut value: i32 = 0;
+            // SAFETY: GET requests take one `opus_int32*` that outlives the call.
+            check(unsafe {
+                sys::opus_encoder_ctl(self.0.as_ptr(), request, &mut value as *mut i32)
+            })?;
+            Ok(value)
+        }
+
+        pub(super) fn reset(&mut self) -> Result<(), c_int> {
+            // SAFETY: RESET_STATE takes no argument.
+            check(unsafe { sys::opus_encoder_ctl(self.0.as_ptr(), RESET_STATE) }).map(|_| ())
+        }
+
+        /// Encode `frame_size` samples per channel from interleaved `pcm`
+        pub(super) fn encode(
+            &mut self,
+            pcm: &[i16],
+            frame_size: usize,
+            output: &mut [u8],
+        ) -> Result<usize, c_int> {
+            // SAFETY: the caller validated `pcm` holds `frame_size` samples
+            // per channel; the output bound is passed explicitly.
+            check(unsafe {
+                sys::opus_encode(
+                    self.0.as_ptr(),
+                    pcm.as_ptr(),
+                    frame_size as c_int,
+                    output.as_mut_ptr(),
+                    output.len().min(i32::MAX as usize) as i32,
+                )
+            })
+        }
+    }
+
+    impl Drop for Encoder {
+        fn drop(&mut self) {
+            // SAFETY: we own the state and never hand it out.
+            unsafe { sys::opus_encoder_destroy(self.0.as_ptr()) }
+        }
+    }
+
+    pub(super) struct Decoder {
+        state: NonNull<sys::OpusDecoder>,
+        channels: usize,
+    }
+
+    // SAFETY: the decoder state is only touched through `&mut self`.
+    unsafe impl Send for Decoder {}
+    unsafe impl Sync for Decoder {}
+
+    impl Decoder {
+        pub(super) fn new(sample_rate: u32, channels: u8) -> Result<Self, c_int> {
+            let mut error = OK;
+            // SAFETY: plain constructor call; `error` outlives the call.
+            let state = unsafe {
+                sys::opus_decoder_create(sample_rate as i32, channels as c_int, &mut error)
+            };
+            match NonNull::new(state) {
+                Some(state) if error == OK => Ok(Self {
+                    state,
+                    channels: channels as usize,
+                }),
+                Some(state) => {
+                    // SAFETY: state was just created and is not shared.
+                    unsafe { sys::opus_decoder_destroy(state.as_ptr()) };
+                    Err(error)
+                }
+                None => Err(error),
+            }
+        }
+
+        pub(super) fn reset(&mut self) -> Result<(), c_int> {
+            // SAFETY: RESET_STATE takes no argument.
+            check(unsafe { sys::opus_decoder_ctl(self.state.as_ptr(), RESET_STATE) }).map(|_| ())
+        }
+
+        /// Decode into at most `frame_size` samples per channel.
+        ///
+        /// `packet == None` runs packet-loss concealment; `fec` decodes the
+        /// redundant copy of the previous frame carried by `packet`.
+        pub(super) fn decode(
+            &mut self,
+            packet: Option<&[u8]>,
+            output: &mut [i16],
+            frame_size: usize,
+            fec: bool,
+        ) -> Result<usize, c_int> {
+            assert!(output.len() >= frame_size * self.channels);
+            let (data, len) = match packet {
+                Some(packet) => (packet.as_ptr(), packet.len().min(i32::MAX as usize) as i32),
+                None => (std::ptr::null(), 0),
+            };
+            // SAFETY: `output` holds `frame_size` samples per channel
+            // (asserted above); a null packet is the documented PLC input.
+            check(unsafe {
+                sys::opus_decode(
+                    self.state.as_ptr(),
+                    data,
+                    len,
+                    output.as_mut_ptr(),
+                    frame_size as c_int,
+                    fec as c_int,
+                )
+            })
+        }
+    }
+
+    impl Drop for Decoder {
+        fn drop(&mut self) {
+            // SAFETY: we own the state and never hand it out.
+            unsafe { sys::opus_decoder_destroy(self.state.as_ptr()) }
+        }
     }
 }
 
@@ -327,6 +914,15 @@ mod tests {
             .with_frame_size_ms(20.0)
     }
 
+    fn tone(len: usize) -> Vec<i16> {
+        (0..len)
+            .map(|i| {
+                let t = i as f32 / 48000.0;
+                ((2.0 * std::f32::consts::PI * 1000.0 * t).sin() * 16000.0) as i16
+            })
+            .collect()
+    }
+
     #[test]
     fn test_opus_creation() {
         let config = create_test_config();
@@ -348,12 +944,7 @@ mod tests {
         let mut codec = OpusCodec::new(config).unwrap();
 
         // Create test signal
-        let mut samples = Vec::new();
-        for i in 0..960 {
-            let t = i as f32 / 48000.0;
-            let sample = ((2.0 * std::f32::consts::PI * 1000.0 * t).sin() * 16000.0) as i16;
-            samples.push(sample);
-        }
+        let samples = tone(960);
 
         // Encode
         let encoded = codec.encode(&samples).unwrap();
@@ -391,4 +982,101 @@ mod tests {
         // Test invalid complexity
         assert!(codec.set_complexity(11).is_err());
     }
+
+    #[test]
+    fn test_decode_missing_fills_one_frame() {
+        let mut codec = OpusCodec::new(create_test_config()).unwrap();
+        let packet = codec.encode(&tone(960)).unwrap();
+        codec.decode(&packet).unwrap();
+
+        let mut output = vec![0i16; 960];
+        assert_eq!(codec.decode_missing(&mut output).unwrap(), 960);
+
+        let mut short = vec![0i16; 100];
+        assert!(codec.decode_missing(&mut short).is_err());
+    }
+
+    #[cfg(feature = "opus")]
+    #[test]
+    fn test_real_roundtrip_preserves_tone() {
+        let mut codec = OpusCodec::new(create_test_config()).unwrap();
+        let samples = tone(960);
+        let mut packet = [0u8; MAX_PACKET_SIZE];
+        let mut decoded = [0i16; 960];
+
+        // Let the encoder/decoder settle past the codec look-ahead.
+        let mut energy = 0f64;
+        for _ in 0..10 {
+            let len = codec.encode_to_buffer(&samples, &mut packet).unwrap();
+            assert!(len > 0 && len < 1275);
+            assert_eq!(
+                codec
+                    .decode_to_buffer(&packet[..len], &mut decoded)
+                    .unwrap(),
+                960
+            );
+            energy = decoded.iter().map(|&s| (s as f64).powi(2)).sum::<f64>() / 960.0;
+        }
+        assert!(
+            energy.sqrt() > 5000.0,
+            "decoded tone too quiet: {}",
+            energy.sqrt()
+        );
+    }
+
+    #[cfg(feature = "opus")]
+    #[test]
+    fn test_dtx_on_silence() {
+        let config = create_test_config().with_opus_dtx(true);
+        let mut codec = OpusCodec::new(config).unwrap();
+
+        let silence = vec![0i16; 960];
+        let mut packet = [0u8; MAX_PACKET_SIZE];
+        let mut last_len = usize::MAX;
+        for _ in 0..50 {
+            last_len = codec.encode_to_buffer(&silence, &mut packet).unwrap();
+        }
+        assert!(
+            last_len <= 2,
+            "DTX should emit empty frames, got {last_len} bytes"
+        );
+        assert!(codec.is_in_dtx());
+    }
+
+    #[cfg(feature = "opus")]
+    #[test]
+    fn test_fec_recovers_lost_frame() {
+        let config = create_test_config().with_opus_fec(true).with_bitrate(32000);
+        let mut codec = OpusCodec::new(config).unwrap();
+        codec.set_packet_loss_perc(20).unwrap();
+
+        let samples = tone(960);
+        let mut packets = Vec::new();
+        for _ in 0..5 {
+            packets.push(codec.encode(&samples).unwrap());
+        }
+
+        let mut output = vec![0i16; 960];
+        codec.decode_to_buffer(&packets[0], &mut output).unwrap();
+        // packets[1] is lost; recover it from packets[2]'s FEC payload.
+        assert_eq!(codec.decode_fec(&packets[2], &mut output).unwrap(), 960);
+        assert_eq!(
+            codec.decode_to_buffer(&packets[2], &mut output).unwrap(),
+            960
+        );
+    }
+
+    #[cfg(feature = "opus")]
+    #[test]
+    fn test_stereo_frames_are_interleaved() {
+        let config = create_test_config().with_channels(2);
+        let mut codec = OpusCodec::new(config).unwrap();
+
+        let stereo: Vec<i16> = tone(960).iter().flat_map(|&s| [s, s]).collect();
+        let packet = codec.encode(&stereo).unwrap();
+        assert_eq!(codec.decode(&packet).unwrap().len(), 1920);
+
+        // An odd sample count cannot be split across two channels.
+        assert!(codec.encode(&stereo[..1919]).is_err());
+    }
 }
@@ -455,6 +455,12 @@ impl CodecConfig {
         self
     }
 
+    /// Set Opus DTX (discontinuous transmission)
+    pub fn with_opus_dtx(mut self, dtx: bool) -> Self {
+        self.parameters.opus.dtx = dtx;
+        self
+    }
+
     /// Set whether G.729 Annex A reduced-complexity mode is enabled.
     ///
     /// Setting this to `false` requests full-complexity base G.729, which is
@@ -2,6 +2,24 @@
 //!
 //! This module provides SIMD capability detection and optimized operations
 //! for audio processing across different architectures.
+//!
+//! ## G.711 kernels
+//!
+//! The μ-law/A-law encoders and decoders below are bit-exact with the ITU-T
+//! G.711 reference in `codecs::g711::reference` for every input value. Each
+//! ISA gets a real vector kernel:
+//!
+//! - **SSE2 / AVX2** — the segment is found with a ladder of vector compares
+//!   against the segment thresholds; the per-lane variable shift is done with
+//!   an unsigned high multiply by a power of two derived from the same masks.
+//!   Decoding rebuilds the linear value arithmetically (`mullo` by `2^exp`).
+//! - **NEON** — the segment comes straight from `vclzq_u16` and the shift is a
+//!   per-lane `vshlq_u16`. Decoding is a table gather over the 256-entry
+//!   decode tables with `vqtbl4q_u8`/`vqtbx4q_u8`, one byte plane at a time.
+//!
+//! The `*_optimized` dispatchers pick the widest kernel reported by
+//! [`get_simd_support()`]. The per-ISA entry points are public so benches can
+//! measure each one; they fall back to scalar when the ISA is unavailable.
 
 use std::sync::OnceLock;
 
@@ -63,53 +81,53 @@ pub fn has_simd_support() -> bool {
     support.sse2 || support.avx2 || support.neon
 }
 
+// ---------------------------------------------------------------------------
+// μ-law encode
+// ---------------------------------------------------------------------------
+
 /// SIMD-optimized μ-law encoding (x86_64 SSE2)
+///
+/// # Panics
+///
+/// Panics if `output` is shorter than `samples`.
 #[cfg(target_arch = "x86_64")]
 pub fn encode_mulaw_simd_sse2(samples: &[i16], output: &mut [u8]) {
-    use std::arch::x86_64::*;
-
+    assert!(output.len() >= samples.len(), "output buffer too small");
     if !get_simd_support().sse2 {
         return encode_mulaw_scalar(samples, output);
     }
+    // SAFETY: SSE2 availability checked above; bounds asserted above.
+    unsafe { x86::encode_mulaw_sse2(samples, output) }
+}
 
-    let mut chunks = samples.chunks_exact(8);
-    let mut out_idx = 0;
-
-    unsafe {
-        for chunk in chunks.by_ref() {
-            // Load 8 samples at once
-            let samples_vec = _mm_loadu_si128(chunk.as_ptr() as *const __m128i);
-
-            // Process each sample - need to unroll or use different approach
-            // _mm_extract_epi16 requires compile-time constant, so we unroll
-            output[out_idx] = linear_to_mulaw_scalar(_mm_extract_epi16(samples_vec, 0) as i16);
-            output[out_idx + 1] = linear_to_mulaw_scalar(_mm_extract_epi16(samples_vec, 1) as i16);
-            output[out_idx + 2] = linear_to_mulaw_scalar(_mm_extract_epi16(samples_vec, 2) as i16);
-            output[out_idx + 3] = linear_to_mulaw_scalar(_mm_extract_epi16(samples_vec, 3) as i16);
-            output[out_idx + 4] = linear_to_mulaw_scalar(_mm_extract_epi16(samples_vec, 4) as i16);
-            output[out_idx + 5] = linear_to_mulaw_scalar(_mm_extract_epi16(samples_vec, 5) as i16);
-            output[out_idx + 6] = linear_to_mulaw_scalar(_mm_extract_epi16(samples_vec, 6) as i16);
-            output[out_idx + 7] = linear_to_mulaw_scalar(_mm_extract_epi16(samples_vec, 7) as i16);
-            out_idx += 8;
-        }
-    }
-
-    // Handle remainder
-    for &sample in chunks.remainder() {
-        output[out_idx] = linear_to_mulaw_scalar(sample);
-        out_idx += 1;
+/// SIMD-optimized μ-law encoding (x86_64 AVX2)
+///
+/// # Panics
+///
+/// Panics if `output` is shorter than `samples`.
+#[cfg(target_arch = "x86_64")]
+pub fn encode_mulaw_simd_avx2(samples: &[i16], output: &mut [u8]) {
+    assert!(output.len() >= samples.len(), "output buffer too small");
+    if !get_simd_support().avx2 {
+        return encode_mulaw_simd_sse2(samples, output);
     }
+    // SAFETY: AVX2 availability checked above; bounds asserted above.
+    unsafe { x86::encode_mulaw_avx2(samples, output) }
 }
 
 /// SIMD-optimized μ-law encoding (AArch64 NEON)
+///
+/// # Panics
+///
+/// Panics if `output` is shorter than `samples`.
 #[cfg(target_arch = "aarch64")]
 pub fn encode_mulaw_simd_neon(samples: &[i16], output: &mut [u8]) {
+    assert!(output.len() >= samples.len(), "output buffer too small");
     if !get_simd_support().neon {
         return encode_mulaw_scalar(samples, output);
     }
-
-    // For now, fall back to scalar implementation for simplicity
-    encode_mulaw_scalar(samples, output);
+    // SAFETY: NEON availability checked above; bounds asserted above.
+    unsafe { neon::encode_mulaw(samples, output) }
 }
 
 /// Scalar μ-law encoding fallback
@@ -119,53 +137,53 @@ pub fn encode_mulaw_scalar(samples: &[i16], output: &mut [u8]) {
     }
 }
 
+// ---------------------------------------------------------------------------
+// A-law encode
+// ---------------------------------------------------------------------------
+
 /// SIMD-optimized A-law encoding (x86_64 SSE2)
+///
+/// # Panics
+///
+/// Panics if `output` is shorter than `samples`.
 #[cfg(target_arch = "x86_64")]
 pub fn encode_alaw_simd_sse2(samples: &[i16], output: &mut [u8]) {
-    use std::arch::x86_64::*;
-
+    assert!(output.len() >= samples.len(), "output buffer too small");
     if !get_simd_support().sse2 {
         return encode_alaw_scalar(samples, output);
     }
+    // SAFETY: SSE2 availability checked above; bounds asserted above.
+    unsafe { x86::encode_alaw_sse2(samples, output) }
+}
 
-    let mut chunks = samples.chunks_exact(8);
-    let mut out_idx = 0;
-
-    unsafe {
-        for chunk in chunks.by_ref() {
-            // Load 8 samples at once
-            let samples_vec = _mm_loadu_si128(chunk.as_ptr() as *const __m128i);
-
-            // Process each sample - need to unroll or use different approach
-            // _mm_extract_epi16 requires compile-time constant, so we unroll
-            output[out_idx] = linear_to_alaw_scalar(_mm_extract_epi16(samples_vec, 0) as i16);
-            output[out_idx + 1] = linear_to_alaw_scalar(_mm_extract_epi16(samples_vec, 1) as i16);
-            output[out_idx + 2] = linear_to_alaw_scalar(_mm_extract_epi16(samples_vec, 2) as i16);
-            output[out_idx + 3] = linear_to_alaw_scalar(_mm_extract_epi16(samples_vec, 3) as i16);
-            output[out_idx + 4] = linear_to_alaw_scalar(_mm_extract_epi16(samples_vec, 4) as i16);
-            output[out_idx + 5] = linear_to_alaw_scalar(_mm_extract_epi16(samples_vec, 5) as i16);
-            output[out_idx + 6] = linear_to_alaw_scalar(_mm_extract_epi16(samples_vec, 6) as i16);
-            output[out_idx + 7] = linear_to_alaw_scalar(_mm_extract_epi16(samples_vec, 7) as i16);
-            out_idx += 8;
-        }
-    }
-
-    // Handle remainder
-    for &sample in chunks.remainder() {
-        output[out_idx] = linear_to_alaw_scalar(sample);
-        out_idx += 1;
+/// SIMD-optimized A-law encoding (x86_64 AVX2)
+///
+/// # Panics
+///
+/// Panics if `output` is shorter than `samples`.
+#[cfg(target_arch = "x86_64")]
+pub fn encode_alaw_simd_avx2(samples: &[i16], output: &mut [u8]) {
+    assert!(output.len() >= samples.len(), "output buffer too small");
+    if !get_simd_support().avx2 {
+        return encode_alaw_simd_sse2(samples, output);
     }
+    // SAFETY: AVX2 availability checked above; bounds asserted above.
+    unsafe { x86::encode_alaw_avx2(samples, output) }
 }
 
 /// SIMD-optimized A-law encoding (AArch64 NEON)
+///
+/// # Panics
+///
+/// Panics if `output` is shorter than `samples`.
 #[cfg(target_arch = "aarch64")]
 pub fn encode_alaw_simd_neon(samples: &[i16], output: &mut [u8]) {
+    assert!(output.len() >= samples.len(), "output buffer too small");
     if !get_simd_support().neon {
         return encode_alaw_scalar(samples, output);
     }
-
-    // For now, fall back to scalar implementation for simplicity
-    encode_alaw_scalar(samples, output);
+    // SAFETY: NEON availability checked above; bounds asserted above.
+    unsafe { neon::encode_alaw(samples, output) }
 }
 
 /// Scalar A-law encoding fallback
@@ -175,11 +193,127 @@ pub fn encode_alaw_scalar(samples: &[i16], output: &mut [u8]) {
     }
 }
 
+// ---------------------------------------------------------------------------
+// μ-law / A-law decode
+// ---------------------------------------------------------------------------
+
+/// SIMD-optimized μ-law decoding (x86_64 SSE2)
+///
+/// # Panics
+///
+/// Panics if `output` is shorter than `encoded`.
+#[cfg(target_arch = "x86_64")]
+pub fn decode_mulaw_simd_sse2(encoded: &[u8], output: &mut [i16]) {
+    assert!(output.len() >= encoded.len(), "output buffer too small");
+    if !get_simd_support().sse2 {
+        return decode_mulaw_scalar(encoded, output);
+    }
+    // SAFETY: SSE2 availability checked above; bounds asserted above.
+    unsafe { x86::decode_mulaw_sse2(encoded, output) }
+}
+
+/// SIMD-optimized μ-law decoding (x86_64 AVX2)
+///
+/// # Panics
+///
+/// Panics if `output` is shorter than `encoded`.
+#[cfg(target_arch = "x86_64")]
+pub fn decode_mulaw_simd_avx2(encoded: &[u8], output: &mut [i16]) {
+    assert!(output.len() >= encoded.len(), "output buffer too small");
+    if !get_simd_support().avx2 {
+        return decode_mulaw_simd_sse2(encoded, output);
+    }
+    // SAFETY: AVX2 availability checked above; bounds asserted above.
+    unsafe { x86::decode_mulaw_avx2(encoded, output) }
+}
+
+/// SIMD-optimized μ-law decoding (AArch64 NEON table gather)
+///
+/// # Panics
+///
+/// Panics if `output` is shorter than `encoded`.
+#[cfg(target_arch = "aarch64")]
+pub fn decode_mulaw_simd_neon(encoded: &[u8], output: &mut [i16]) {
+    assert!(output.len() >= encoded.len(), "output buffer too small");
+    if !get_simd_support().neon {
+        return decode_mulaw_scalar(encoded, output);
+    }
+    // SAFETY: NEON availability checked above; bounds asserted above.
+    unsafe { neon::decode_table(encoded, output, &neon::MULAW_PLANES) }
+}
+
+/// Scalar μ-law decoding fallback
+pub fn decode_mulaw_scalar(encoded: &[u8], output: &mut [i16]) {
+    for (i, &byte) in encoded.iter().enumerate() {
+        output[i] = mulaw_to_linear_scalar(byte);
+    }
+}
+
+/// SIMD-optimized A-law decoding (x86_64 SSE2)
+///
+/// # Panics
+///
+/// Panics if `output` is shorter than `encoded`.
+#[cfg(target_arch = "x86_64")]
+pub fn decode_alaw_simd_sse2(encoded: &[u8], output: &mut [i16]) {
+    assert!(output.len() >= encoded.len(), "output buffer too small");
+    if !get_simd_support().sse2 {
+        return decode_alaw_scalar(encoded, output);
+    }
+    // SAFETY: SSE2 availability checked above; bounds asserted above.
+    unsafe { x86::decode_alaw_sse2(encoded, output) }
+}
+
+/// SIMD-optimized A-law decoding (x86_64 AVX2)
+///
+/// # Panics
+///
+/// Panics if `output` is shorter than `encoded`.
+#[cfg(target_arch = "x86_64")]
+pub fn decode_alaw_simd_avx2(encoded: &[u8], output: &mut [i16]) {
+    assert!(output.len() >= encoded.len(), "output buffer too small");
+    if !get_simd_support().avx2 {
+        return decode_alaw_simd_sse2(encoded, output);
+    }
+    // SAFETY: AVX2 availability checked above; bounds asserted above.
+    unsafe { x86::decode_alaw_avx2(encoded, output) }
+}
+
+/// SIMD-optimized A-law decoding (AArch64 NEON table gather)
+///
+/// # Panics
+///
+/// Panics if `output` is shorter than `encoded`.
+#[cfg(target_arch = "aarch64")]
+pub fn decode_alaw_simd_neon(encoded: &[u8], output: &mut [i16]) {
+    assert!(output.len() >= encoded.len(), "output buffer too small");
+    if !get_simd_support().neon {
+        return decode_alaw_scalar(encoded, output);
+    }
+    // SAFETY: NEON availability checked above; bounds asserted above.
+    unsafe { neon::decode_table(encoded, output, &neon::ALAW_PLANES) }
+}
+
+/// Scalar A-law decoding fallback
+pub fn decode_alaw_scalar(encoded: &[u8], output: &mut [i16]) {
+    for (i, &byte) in encoded.iter().enumerate() {
+        output[i] = alaw_to_linear_scalar(byte);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Dispatchers
+// ---------------------------------------------------------------------------
+
 /// Cross-platform μ-law encoding dispatcher
 pub fn encode_mulaw_optimized(samples: &[i16], output: &mut [u8]) {
     #[cfg(target_arch = "x86_64")]
     {
-        if get_simd_support().sse2 {
+        let support = get_simd_support();
+        if support.avx2 {
+            return encode_mulaw_simd_avx2(samples, output);
+        }
+        if support.sse2 {
             return encode_mulaw_simd_sse2(samples, output);
         }
     }
@@ -198,7 +332,11 @@ pub fn encode_mulaw_optimized(samples: &[i16], output: &mut [u8]) {
 pub fn encode_alaw_optimized(samples: &[i16], output: &mut [u8]) {
     #[cfg(target_arch = "x86_64")]
     {
-        if get_simd_support().sse2 {
+        let support = get_simd_support();
+        if support.avx2 {
+            return encode_alaw_simd_avx2(samples, output);
+        }
+        if support.sse2 {
             return encode_alaw_simd_sse2(samples, output);
         }
     }
@@ -213,151 +351,678 @@ pub fn encode_alaw_optimized(samples: &[i16], output: &mut [u8]) {
     encode_alaw_scalar(samples, output);
 }
 
+/// Cross-platform μ-law decoding dispatcher
+pub fn decode_mulaw_optimized(encoded: &[u8], output: &mut [i16]) {
+    #[cfg(target_arch = "x86_64")]
+    {
+        let support = get_simd_support();
+        if support.avx2 {
+            return decode_mulaw_simd_avx2(encoded, output);
+        }
+        if support.sse2 {
+            return decode_mulaw_simd_sse2(encoded, output);
+        }
+    }
+
+    #[cfg(target_arch = "aarch64")]
+    {
+        if get_simd_support().neon {
+            return decode_mulaw_simd_neon(encoded, output);
+        }
+    }
+
+    decode_mulaw_scalar(encoded, output);
+}
+
+/// Cross-platform A-law decoding dispatcher
+pub fn decode_alaw_optimized(encoded: &[u8], output: &mut [i16]) {
+    #[cfg(target_arch = "x86_64")]
+    {
+        let support = get_simd_support();
+        if support.avx2 {
+            return decode_alaw_simd_avx2(encoded, output);
+        }
+        if support.sse2 {
+            return decode_alaw_simd_sse2(encoded, output);
+        }
+    }
+
+    #[cfg(target_arch = "aarch64")]
+    {
+        if get_simd_support().neon {
+            return decode_alaw_simd_neon(encoded, output);
+        }
+    }
+
+    decode_alaw_scalar(encoded, output);
+}
+
+// ---------------------------------------------------------------------------
+// Scalar conversions
+// ---------------------------------------------------------------------------
+
 /// Scalar μ-law conversion (ITU-T G.711)
-pub fn linear_to_mulaw_scalar(sample: i16) -> u8 {
-    const CLIP: i16 = 32635;
-    const BIAS: i16 = 0x84;
-    const MULAW_MAX: u8 = 0x7F;
-
-    let mut sample = sample;
-    let sign = if sample < 0 {
-        // Handle i16::MIN case to avoid overflow
-        sample = if sample == i16::MIN {
-            i16::MAX
-        } else {
-            -sample
-        };
-        0x80
-    } else {
-        0x00
-    };
-
-    if sample > CLIP {
-        sample = CLIP;
-    }
-
-    sample = sample + BIAS;
-
-    let exponent = if sample <= 0x1F {
-        0
-    } else if sample <= 0x3F {
-        1
-    } else if sample <= 0x7F {
-        2
-    } else if sample <= 0xFF {
-        3
-    } else if sample <= 0x1FF {
-        4
-    } else if sample <= 0x3FF {
-        5
-    } else if sample <= 0x7FF {
-        6
-    } else {
-        7
-    };
+///
+/// Bit-exact with `codecs::g711::ulaw_compress`.
+pub const fn linear_to_mulaw_scalar(sample: i16) -> u8 {
+    // One's-complement magnitude, as in the ITU reference (`!sample` for
+    // negative inputs), then the 14-bit μ-law bias of 33.
+    let magnitude = (sample ^ (sample >> 15)) as u16;
+    let mut absno = (magnitude >> 2) + 33;
+    if absno > 0x1FFF {
+        absno = 0x1FFF;
+    }
 
-    let mantissa = (sample >> (exponent + 3)) & 0x0F;
-    let mulaw = ((exponent << 4) | mantissa) as u8;
+    // Segment = bit length of (absno >> 6), in 0..=7.
+    let segment = 16 - (absno >> 6).leading_zeros() as u16;
+    let mantissa = (absno >> (segment + 1)) & 0x0F;
+    let code = ((segment << 4) | mantissa) as u8 ^ 0x7F;
 
-    (mulaw ^ MULAW_MAX) | sign
+    if sample >= 0 {
+        code | 0x80
+    } else {
+        code
+    }
 }
 
 /// Scalar A-law conversion (ITU-T G.711)
-pub fn linear_to_alaw_scalar(sample: i16) -> u8 {
-    const CLIP: i16 = 32635;
-    const ALAW_MAX: u8 = 0x7F;
-
-    let mut sample = sample;
-    let sign = if sample < 0 {
-        // Handle i16::MIN case to avoid overflow
-        sample = if sample == i16::MIN {
-            i16::MAX
-        } else {
-            -sample
-        };
-        0x80
+///
+/// Bit-exact with `codecs::g711::alaw_compress`.
+pub const fn linear_to_alaw_scalar(sample: i16) -> u8 {
+    let ix = ((sample ^ (sample >> 15)) as u16) >> 4;
+
+    // Segment = bit length of ix minus 4 (0 for the linear segment), and the
+    // mantissa is taken one bit lower than the segment's leading one.
+    let bits = 16 - ix.leading_zeros() as u16;
+    let segment = bits.saturating_sub(4);
+    let mantissa = (ix >> segment.saturating_sub(1)) & 0x0F;
+    let code = ((segment << 4) | mantissa) as u8;
+
+    if sample >= 0 {
+        (code | 0x80) ^ 0x55
     } else {
-        0x00
-    };
-
-    if sample > CLIP {
-        sample = CLIP;
+        code ^ 0x55
     }
+}
 
-    let alaw = if sample < 256 {
-        sample >> 4
+/// Scalar μ-law to linear conversion (ITU-T G.711)
+///
+/// Bit-exact with `codecs::g711::ulaw_expand`.
+pub const fn mulaw_to_linear_scalar(mulaw: u8) -> i16 {
+    let inverted = !mulaw;
+    let exponent = (inverted >> 4) & 0x07;
+    let mantissa = (inverted & 0x0F) as i16;
+    let magnitude = (((mantissa << 3) + 0x84) << exponent) - 0x84;
+
+    if mulaw & 0x80 != 0 {
+        magnitude
     } else {
-        let exponent = if sample < 512 {
-            1
-        } else if sample < 1024 {
-            2
-        } else if sample < 2048 {
-            3
-        } else if sample < 4096 {
-            4
-        } else if sample < 8192 {
-            5
-        } else if sample < 16384 {
-            6
-        } else {
-            7
-        };
-
-        let mantissa = (sample >> (exponent + 3)) & 0x0F;
-        ((exponent << 4) | mantissa) + 16
-    };
-
-    ((alaw as u8) ^ ALAW_MAX) | sign
-}
-
-/// Scalar μ-law to linear conversion
-pub fn mulaw_to_linear_scalar(mulaw: u8) -> i16 {
-    const BIAS: i16 = 0x84;
-    const MULAW_MAX: u8 = 0x7F;
-
-    let mulaw = mulaw ^ MULAW_MAX;
-    let sign = mulaw & 0x80;
-    let exponent = (mulaw >> 4) & 0x07;
-    let mantissa = mulaw & 0x0F;
-
-    let mut sample = ((mantissa as i16) << (exponent + 3)) + BIAS;
+        -magnitude
+    }
+}
+
+/// Scalar A-law to linear conversion (ITU-T G.711)
+///
+/// Bit-exact with `codecs::g711::alaw_expand`.
+pub const fn alaw_to_linear_scalar(alaw: u8) -> i16 {
+    let ix = (alaw ^ 0x55) & 0x7F;
+    let exponent = ix >> 4;
+    let mut mantissa = (ix & 0x0F) as i16;
 
     if exponent > 0 {
-        sample += 1i16 << (exponent + 2);
+        mantissa += 16;
+    }
+    mantissa = (mantissa << 4) + 8;
+    if exponent > 1 {
+        mantissa <<= exponent - 1;
     }
 
-    if sign != 0 {
-        -sample
+    if alaw & 0x80 != 0 {
+        mantissa
     } else {
-        sample
+        -mantissa
     }
 }
 
-/// Scalar A-law to linear conversion
-pub fn alaw_to_linear_scalar(alaw: u8) -> i16 {
-    const ALAW_MAX: u8 = 0x7F;
+// ---------------------------------------------------------------------------
+// x86_64 kernels
+// ---------------------------------------------------------------------------
 
-    let alaw = alaw ^ ALAW_MAX;
-    let sign = alaw & 0x80;
-    let magnitude = alaw & 0x7F;
+#[cfg(target_arch = "x86_64")]
+mod x86 {
+    use super::*;
+    use std::arch::x86_64::*;
 
-    let sample = if magnitude < 16 {
-        (magnitude as u16) << 4
-    } else {
-        let exponent = (magnitude >> 4) & 0x07;
-        let mantissa = magnitude & 0x0F;
+    /// μ-law on 8 lanes: returns the codes in the low byte of each lane.
+    #[inline]
+    #[target_feature(enable = "sse2")]
+    unsafe fn mulaw_lanes_sse2(s: __m128i) -> __m128i {
+        let sign = _mm_srai_epi16(s, 15);
+        let magnitude = _mm_xor_si128(s, sign);
+        let absno = _mm_min_epi16(
+            _mm_add_epi16(_mm_srli_epi16(magnitude, 2), _mm_set1_epi16(33)),
+            _mm_set1_epi16(0x1FFF),
+        );
 
-        // Prevent overflow by clamping shift amounts and using wider types
-        let exp_shift = ((exponent + 3) as u32).min(15);
-        let gain_shift = ((exponent + 2) as u32).min(15);
+        // Segment search: each threshold crossed adds one segment and halves
+        // the multiplier used for the per-lane right shift below.
+        let mut segment = _mm_setzero_si128();
+        let mut multiplier = _mm_set1_epi16(0x8000u16 as i16);
+        let mut threshold = 63i16;
+        let mut step = 0x4000i16;
+        for _ in 0..7 {
+            let mask = _mm_cmpgt_epi16(absno, _mm_set1_epi16(threshold));
+            segment = _mm_sub_epi16(segment, mask);
+            multiplier = _mm_sub_epi16(multiplier, _mm_and_si128(mask, _mm_set1_epi16(step)));
+            threshold = (threshold << 1) | 1;
+            step >>= 1;
+        }
 
-        ((mantissa as u16) << exp_shift) + ((1u16) << gain_shift)
-    } + 8;
+        // (absno * 2^(15 - segment)) >> 16 == absno >> (segment + 1)
+        let mantissa = _mm_and_si128(_mm_mulhi_epu16(absno, multiplier), _mm_set1_epi16(0x0F));
+        let code = _mm_xor_si128(
+            _mm_or_si128(_mm_slli_epi16(segment, 4), mantissa),
+            _mm_set1_epi16(0x7F),
+        );
+        _mm_or_si128(code, _mm_andnot_si128(sign, _mm_set1_epi16(0x80)))
+    }
 
-    if sign != 0 {
-        -(sample as i16)
-    } else {
-        sample as i16
+    /// A-law on 8 lanes: returns the codes in the low byte of each lane.
+    #[inline]
+    #[target_feature(enable = "sse2")]
+    unsafe fn alaw_lanes_sse2(s: __m128i) -> __m128i {
+        let sign = _mm_srai_epi16(s, 15);
+        let ix = _mm_srli_epi16(_mm_xor_si128(s, sign), 4);
+
+        // Segment 1 starts at 16; the mantissa shift only starts at segment 2.
+        let first = _mm_cmpgt_epi16(ix, _mm_set1_epi16(15));
+        let mut segment = _mm_sub_epi16(_mm_setzero_si128(), first);
+        let mut multiplier = _mm_set1_epi16(0x8000u16 as i16);
+        let mut threshold = 31i16;
+        let mut step = 0x4000i16;
+        for _ in 0..6 {
+            let mask = _mm_cmpgt_epi16(ix, _mm_set1_epi16(threshold));
+            segment = _mm_sub_epi16(segment, mask);
+            multiplier = _mm_sub_epi16(multiplier, _mm_and_si128(mask, _mm_set1_epi16(step)));
+            threshold = (threshold << 1) | 1;
+            step >>= 1;
+        }
+
+        // ((ix << 1) * 2^(15 - shift)) >> 16 == ix >> shift
+        let mantissa = _mm_and_si128(
+            _mm_mulhi_epu16(_mm_slli_epi16(ix, 1), multiplier),
+            _mm_set1_epi16(0x0F),
+        );
+        let code = _mm_or_si128(_mm_slli_epi16(segment, 4), mantissa);
+        let code = _mm_or_si128(code, _mm_andnot_si128(sign, _mm_set1_epi16(0x80)));
+        _mm_xor_si128(code, _mm_set1_epi16(0x55))
+    }
+
+    /// Per-lane `1 << e` for `e` in 0..=7 without variable shifts.
+    #[inline]
+    #[target_feature(enable = "sse2")]
+    unsafe fn pow2_lanes_sse2(e: __m128i) -> __m128i {
+        let mut pow = _mm_set1_epi16(1);
+        for (bit, factor) in [(1i16, 1i16), (2, 3), (4, 15)] {
+            let set = _mm_cmpeq_epi16(_mm_and_si128(e, _mm_set1_epi16(bit)), _mm_set1_epi16(bit));
+            // pow * (1 + factor) when the bit is set: 2x, 4x, 16x.
+            let scaled = _mm_mullo_epi16(pow, _mm_set1_epi16(factor));
+            pow = _mm_add_epi16(pow, _mm_and_si128(set, scaled));
+        }
+        pow
+    }
+
+    /// Apply the G.711 sign: bytes with bit 7 clear decode to negative values.
+    #[inline]
+    #[target_feature(enable = "sse2")]
+    unsafe fn apply_sign_sse2(codes: __m128i, magnitude: __m128i) -> __m128i {
+        let negative = _mm_cmpeq_epi16(
+            _mm_and_si128(codes, _mm_set1_epi16(0x80)),
+            _mm_setzero_si128(),
+        );
+        _mm_sub_epi16(_mm_xor_si128(magnitude, negative), negative)
+    }
+
+    #[inline]
+    #[target_feature(enable = "sse2")]
+    unsafe fn mulaw_expand_lanes_sse2(codes: __m128i) -> __m128i {
+        let inverted = _mm_xor_si128(codes, _mm_set1_epi16(0xFF));
+        let exponent = _mm_and_si128(_mm_srli_epi16(inverted, 4), _mm_set1_epi16(0x07));
+        let mantissa = _mm_and_si128(inverted, _mm_set1_epi16(0x0F));
+        let base = _mm_add_epi16(_mm_slli_epi16(mantissa, 3), _mm_set1_epi16(0x84));
+        let magnitude = _mm_sub_epi16(
+            _mm_mullo_epi16(base, pow2_lanes_sse2(exponent)),
+            _mm_set1_epi16(0x84),
+        );
+        apply_sign_sse2(codes, magnitude)
+    }
+
+    #[inline]
+    #[target_feature(enable = "sse2")]
+    unsafe fn alaw_expand_lanes_sse2(codes: __m128i) -> __m128i {
+        let ix = _mm_and_si128(
+            _mm_xor_si128(codes, _mm_set1_epi16(0x55)),
+            _mm_set1_epi16(0x7F),
+        );
+        let exponent = _mm_srli_epi16(ix, 4);
+        let mantissa = _mm_and_si128(ix, _mm_set1_epi16(0x0F));
+        let nonlinear = _mm_cmpgt_epi16(exponent, _mm_setzero_si128());
+        let base = _mm_add_epi16(
+            _mm_slli_epi16(mantissa, 4),
+            _mm_add_epi16(
+                _mm_set1_epi16(8),
+                _mm_and_si128(nonlinear, _mm_set1_epi16(256)),
+            ),
+        );
+        // shift = max(exponent - 1, 0)
+        let shift = _mm_add_epi16(exponent, nonlinear);
+        let magnitude = _mm_mullo_epi16(base, pow2_lanes_sse2(shift));
+        apply_sign_sse2(codes, magnitude)
+    }
+
+    #[target_feature(enable = "sse2")]
+    pub(super) unsafe fn encode_mulaw_sse2(samples: &[i16], output: &mut [u8]) {
+        let mut chunks = samples.chunks_exact(16);
+        let mut out = output.as_mut_ptr();
+        for chunk in chunks.by_ref() {
+            let lo = mulaw_lanes_sse2(_mm_loadu_si128(chunk.as_ptr() as *const __m128i));
+            let hi = mulaw_lanes_sse2(_mm_loadu_si128(chunk.as_ptr().add(8) as *const __m128i));
+            _mm_storeu_si128(out as *mut __m128i, _mm_packus_epi16(lo, hi));
+            out = out.add(16);
+        }
+        let done = samples.len() - chunks.remainder().len();
+        encode_mulaw_scalar(chunks.remainder(), &mut output[done..]);
+    }
+
+    #[target_feature(enable = "sse2")]
+    pub(super) unsafe fn encode_alaw_sse2(samples: &[i16], output: &mut [u8]) {
+        let mut chunks = samples.chunks_exact(16);
+        let mut out = output.as_mut_ptr();
+        for chunk in chunks.by_ref() {
+            let lo = alaw_lanes_sse2(_mm_loadu_si128(chunk.as_ptr() as *const __m128i));
+            let hi = alaw_lanes_sse2(_mm_loadu_si128(chunk.as_ptr().add(8) as *const __m128i));
+            _mm_storeu_si128(out as *mut __m128i, _mm_packus_epi16(lo, hi));
+            out = out.add(16);
+        }
+        let done = samples.len() - chunks.remainder().len();
+        encode_alaw_scalar(chunks.remainder(), &mut output[done..]);
+    }
+
+    #[target_feature(enable = "sse2")]
+    pub(super) unsafe fn decode_mulaw_sse2(encoded: &[u8], output: &mut [i16]) {
+        let mut chunks = encoded.chunks_exact(16);
+        let mut out = output.as_mut_ptr();
+        let zero = _mm_setzero_si128();
+        for chunk in chunks.by_ref() {
+            let bytes = _mm_loadu_si128(chunk.as_ptr() as *const __m128i);
+            let lo = mulaw_expand_lanes_sse2(_mm_unpacklo_epi8(bytes, zero));
+            let hi = mulaw_expand_lanes_sse2(_mm_unpackhi_epi8(bytes, zero));
+            _mm_storeu_si128(out as *mut __m128i, lo);
+            _mm_storeu_si128(out.add(8) as *mut __m128i, hi);
+            out = out.add(16);
+        }
+        let done = encoded.len() - chunks.remainder().len();
+        decode_mulaw_scalar(chunks.remainder(), &mut output[done..]);
+    }
+
+    #[target_feature(enable = "sse2")]
+    pub(super) unsafe fn decode_alaw_sse2(encoded: &[u8], output: &mut [i16]) {
+        let mut chunks = encoded.chunks_exact(16);
+        let mut out = output.as_mut_ptr();
+        let zero = _mm_setzero_si128();
+        for chunk in chunks.by_ref() {
+            let bytes = _mm_loadu_si128(chunk.as_ptr() as *const __m128i);
+            let lo = alaw_expand_lanes_sse2(_mm_unpacklo_epi8(bytes, zero));
+            let hi = alaw_expand_lanes_sse2(_mm_unpackhi_epi8(bytes, zero));
+            _mm_storeu_si128(out as *mut __m128i, lo);
+            _mm_storeu_si128(out.add(8) as *mut __m128i, hi);
+            out = out.add(16);
+        }
+        let done = encoded.len() - chunks.remainder().len();
+        decode_alaw_scalar(chunks.remainder(), &mut output[done..]);
+    }
+
+    /// μ-law on 16 lanes (AVX2 counterpart of `mulaw_lanes_sse2`).
+    #[inline]
+    #[target_feature(enable = "avx2")]
+    unsafe fn mulaw_lanes_avx2(s: __m256i) -> __m256i {
+        let sign = _mm256_srai_epi16(s, 15);
+        let magnitude = _mm256_xor_si256(s, sign);
+        let absno = _mm256_min_epi16(
+            _mm256_add_epi16(_mm256_srli_epi16(magnitude, 2), _mm256_set1_epi16(33)),
+            _mm256_set1_epi16(0x1FFF),
+        );
+
+        let mut segment = _mm256_setzero_si256();
+        let mut multiplier = _mm256_set1_epi16(0x8000u16 as i16);
+        let mut threshold = 63i16;
+        let mut step = 0x4000i16;
+        for _ in 0..7 {
+            let mask = _mm256_cmpgt_epi16(absno, _mm256_set1_epi16(threshold));
+            segment = _mm256_sub_epi16(segment, mask);
+            multiplier =
+                _mm256_sub_epi16(multiplier, _mm256_and_si256(mask, _mm256_set1_epi16(step)));
+            threshold = (threshold << 1) | 1;
+            step >>= 1;
+        }
+
+        let mantissa = _mm256_and_si256(
+            _mm256_mulhi_epu16(absno, multiplier),
+            _mm256_set1_epi16(0x0F),
+        );
+        let code = _mm256_xor_si256(
+            _mm256_or_si256(_mm256_slli_epi16(segment, 4), mantissa),
+            _mm256_set1_epi16(0x7F),
+        );
+        _mm256_or_si256(code, _mm256_andnot_si256(sign, _mm256_set1_epi16(0x80)))
+    }
+
+    /// A-law on 16 lanes (AVX2 counterpart of `alaw_lanes_sse2`).
+    #[inline]
+    #[target_feature(enable = "avx2")]
+    unsafe fn alaw_lanes_avx2(s: __m256i) -> __m256i {
+        let sign = _mm256_srai_epi16(s, 15);
+        let ix = _mm256_srli_epi16(_mm256_xor_si256(s, sign), 4);
+
+        let first = _mm256_cmpgt_epi16(ix, _mm256_set1_epi16(15));
+        let mut segment = _mm256_sub_epi16(_mm256_setzero_si256(), first);
+        let mut multiplier = _mm256_set1_epi16(0x8000u16 as i16);
+        let mut threshold = 31i16;
+        let mut step = 0x4000i16;
+        for _ in 0..6 {
+            let mask = _mm256_cmpgt_epi16(ix, _mm256_set1_epi16(threshold));
+            segment = _mm256_sub_epi16(segment, mask);
+            multiplier =
+                _mm256_sub_epi16(multiplier, _mm256_and_si256(mask, _mm256_set1_epi16(step)));
+            threshold = (threshold << 1) | 1;
+            step >>= 1;
+        }
+
+        let mantissa = _mm256_and_si256(
+            _mm256_mulhi_epu16(_mm256_slli_epi16(ix, 1), multiplier),
+            _mm256_set1_epi16(0x0F),
+        );
+        let code = _mm256_or_si256(_mm256_slli_epi16(segment, 4), mantissa);
+        let code = _mm256_or_si256(code, _mm256_andnot_si256(sign, _mm256_set1_epi16(0x80)));
+        _mm256_xor_si256(code, _mm256_set1_epi16(0x55))
+    }
+
+    #[inline]
+    #[target_feature(enable = "avx2")]
+    unsafe fn pow2_lanes_avx2(e: __m256i) -> __m256i {
+        // AVX2 has a per-lane variable shift for 32-bit lanes only; the
+        // multiply ladder keeps everything in 16-bit lanes.
+        let mut pow = _mm256_set1_epi16(1);
+        for (bit, factor) in [(1i16, 1i16), (2, 3), (4, 15)] {
+            let set = _mm256_cmpeq_epi16(
+                _mm256_and_si256(e, _mm256_set1_epi16(bit)),
+                _mm256_set1_epi16(bit),
+            );
+            let scaled = _mm256_mullo_epi16(pow, _mm256_set1_epi16(factor));
+            pow = _mm256_add_epi16(pow, _mm256_and_si256(set, scaled));
+        }
+        pow
+    }
+
+    #[inline]
+    #[target_feature(enable = "avx2")]
+    unsafe fn apply_sign_avx2(codes: __m256i, magnitude: __m256i) -> __m256i {
+        let negative = _mm256_cmpeq_epi16(
+            _mm256_and_si256(codes, _mm256_set1_epi16(0x80)),
+            _mm256_setzero_si256(),
+        );
+        _mm256_sub_epi16(_mm256_xor_si256(magnitude, negative), negative)
+    }
+
+    #[inline]
+    #[target_feature(enable = "avx2")]
+    unsafe fn mulaw_expand_lanes_avx2(codes: __m256i) -> __m256i {
+        let inverted = _mm256_xor_si256(codes, _mm256_set1_epi16(0xFF));
+        let exponent = _mm256_and_si256(_mm256_srli_epi16(inverted, 4), _mm256_set1_epi16(0x07));
+        let mantissa = _mm256_and_si256(inverted, _mm256_set1_epi16(0x0F));
+        let base = _mm256_add_epi16(_mm256_slli_epi16(mantissa, 3), _mm256_set1_epi16(0x84));
+        let magnitude = _mm256_sub_epi16(
+            _mm256_mullo_epi16(base, pow2_lanes_avx2(exponent)),
+            _mm256_set1_epi16(0x84),
+        );
+        apply_sign_avx2(codes, magnitude)
+    }
+
+    #[inline]
+    #[target_feature(enable = "avx2")]
+    unsafe fn alaw_expand_lanes_avx2(codes: __m256i) -> __m256i {
+        let ix = _mm256_and_si256(
+            _mm256_xor_si256(codes, _mm256_set1_epi16(0x55)),
+            _mm256_set1_epi16(0x7F),
+        );
+        let exponent = _mm256_srli_epi16(ix, 4);
+        let mantissa = _mm256_and_si256(ix, _mm256_set1_epi16(0x0F));
+        let nonlinear = _mm256_cmpgt_epi16(exponent, _mm256_setzero_si256());
+        let base = _mm256_add_epi16(
+            _mm256_slli_epi16(mantissa, 4),
+            _mm256_add_epi16(
+                _mm256_set1_epi16(8),
+                _mm256_and_si256(nonlinear, _mm256_set1_epi16(256)),
+            ),
+        );
+        let shift = _mm256_add_epi16(exponent, nonlinear);
+        let magnitude = _mm256_mullo_epi16(base, pow2_lanes_avx2(shift));
+        apply_sign_avx2(codes, magnitude)
+    }
+
+    #[target_feature(enable = "avx2")]
+    pub(super) unsafe fn encode_mulaw_avx2(samples: &[i16], output: &mut [u8]) {
+        let mut chunks = samples.chunks_exact(32);
+        let mut out = output.as_mut_ptr();
+        for chunk in chunks.by_ref() {
+            let lo = mulaw_lanes_avx2(_mm256_loadu_si256(chunk.as_ptr() as *const __m256i));
+            let hi = mulaw_lanes_avx2(_mm256_loadu_si256(chunk.as_ptr().add(16) as *const __m256i));
+            // packus works per 128-bit lane; restore sample order afterwards.
+            let packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0b11_01_10_00);
+            _mm256_storeu_si256(out as *mut __m256i, packed);
+            out = out.add(32);
+        }
+        let done = samples.len() - chunks.remainder().len();
+        encode_mulaw_sse2(chunks.remainder(), &mut output[done..]);
+    }
+
+    #[target_feature(enable = "avx2")]
+    pub(super) unsafe fn encode_alaw_avx2(samples: &[i16], output: &mut [u8]) {
+        let mut chunks = samples.chunks_exact(32);
+        let mut out = output.as_mut_ptr();
+        for chunk in chunks.by_ref() {
+            let lo = alaw_lanes_avx2(_mm256_loadu_si256(chunk.as_ptr() as *const __m256i));
+            let hi = alaw_lanes_avx2(_mm256_loadu_si256(chunk.as_ptr().add(16) as *const __m256i));
+            let packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0b11_01_10_00);
+            _mm256_storeu_si256(out as *mut __m256i, packed);
+            out = out.add(32);
+        }
+        let done = samples.len() - chunks.remainder().len();
+        encode_alaw_sse2(chunks.remainder(), &mut output[done..]);
+    }
+
+    #[target_feature(enable = "avx2")]
+    pub(super) unsafe fn decode_mulaw_avx2(encoded: &[u8], output: &mut [i16]) {
+        let mut chunks = encoded.chunks_exact(16);
+        let mut out = output.as_mut_ptr();
+        for chunk in chunks.by_ref() {
+            let codes = _mm256_cvtepu8_epi16(_mm_loadu_si128(chunk.as_ptr() as *const __m128i));
+            _mm256_storeu_si256(out as *mut __m256i, mulaw_expand_lanes_avx2(codes));
+            out = out.add(16);
+        }
+        let done = encoded.len() - chunks.remainder().len();
+        decode_mulaw_scalar(chunks.remainder(), &mut output[done..]);
+    }
+
+    #[target_feature(enable = "avx2")]
+    pub(super) unsafe fn decode_alaw_avx2(encoded: &[u8], output: &mut [i16]) {
+        let mut chunks = encoded.chunks_exact(16);
+        let mut out = output.as_mut_ptr();
+        for chunk in chunks.by_ref() {
+            let codes = _mm256_cvtepu8_epi16(_mm_loadu_si128(chunk.as_ptr() as *const __m128i));
+            _mm256_storeu_si256(out as *mut __m256i, alaw_expand_lanes_avx2(codes));
+            out = out.add(16);
+        }
+        let done = encoded.len() - chunks.remainder().len();
+        decode_alaw_scalar(chunks.remainder(), &mut output[done..]);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// AArch64 kernels
+// ---------------------------------------------------------------------------
+
+#[cfg(target_arch = "aarch64")]
+mod neon {
+    use super::*;
+    use std::arch::aarch64::*;
+
+    /// A 256-entry i16 decode table split into low/high byte planes, so each
+    /// plane can be gathered with four 64-byte `tbl`/`tbx` lookups.
+    pub(super) struct BytePlanes {
+        lo: [u8; 256],
+        hi: [u8; 256],
+    }
+
+    const fn build_planes(mulaw: bool) -> BytePlanes {
+        let mut lo = [0u8; 256];
+        let mut hi = [0u8; 256];
+        let mut i = 0;
+        while i < 256 {
+            let value = if mulaw {
+                mulaw_to_linear_scalar(i as u8)
+            } else {
+                alaw_to_linear_scalar(i as u8)
+            } as u16;
+            lo[i] = value as u8;
+            hi[i] = (value >> 8) as u8;
+            i += 1;
+        }
+        BytePlanes { lo, hi }
+    }
+
+    pub(super) static MULAW_PLANES: BytePlanes = build_planes(true);
+    pub(super) static ALAW_PLANES: BytePlanes = build_planes(false);
+
+    #[inline]
+    #[target_feature(enable = "neon")]
+    unsafe fn load_table(plane: &[u8; 256], quarter: usize) -> uint8x16x4_t {
+        vld1q_u8_x4(plane.as_ptr().add(quarter * 64))
+    }
+
+    /// Gather 16 bytes from a 256-byte plane.
+    #[inline]
+    #[target_feature(enable = "neon")]
+    unsafe fn gather(tables: &[uint8x16x4_t; 4], idx: uint8x16_t) -> uint8x16_t {
+        let sixty_four = vdupq_n_u8(64);
+        // Out-of-range indices leave the lane untouched, so each quarter
+        // fills in only the lanes whose index falls inside it.
+        let mut i = idx;
+        let mut out = vqtbl4q_u8(tables[0], i);
+        i = vsubq_u8(i, sixty_four);
+        out = vqtbx4q_u8(out, tables[1], i);
+        i = vsubq_u8(i, sixty_four);
+        out = vqtbx4q_u8(out, tables[2], i);
+        i = vsubq_u8(i, sixty_four);
+        vqtbx4q_u8(out, tables[3], i)
+    }
+
+    #[target_feature(enable = "neon")]
+    pub(super) unsafe fn decode_table(encoded: &[u8], output: &mut [i16], planes: &BytePlanes) {
+        let lo_tables = [
+            load_table(&planes.lo, 0),
+            load_table(&planes.lo, 1),
+            load_table(&planes.lo, 2),
+            load_table(&planes.lo, 3),
+        ];
+        let hi_tables = [
+            load_table(&planes.hi, 0),
+            load_table(&planes.hi, 1),
+            load_table(&planes.hi, 2),
+            load_table(&planes.hi, 3),
+        ];
+
+        let mut chunks = encoded.chunks_exact(16);
+        let mut out = output.as_mut_ptr() as *mut u8;
+        for chunk in chunks.by_ref() {
+            let idx = vld1q_u8(chunk.as_ptr());
+            let lo = gather(&lo_tables, idx);
+            let hi = gather(&hi_tables, idx);
+            // Interleaving store rebuilds little-endian i16 lanes.
+            vst2q_u8(out, uint8x16x2_t(lo, hi));
+            out = out.add(32);
+        }
+        let done = encoded.len() - chunks.remainder().len();
+        for (i, &byte) in chunks.remainder().iter().enumerate() {
+            output[done + i] =
+                i16::from_le_bytes([planes.lo[byte as usize], planes.hi[byte as usize]]);
+        }
+    }
+
+    /// μ-law on 8 lanes, returned narrowed to bytes.
+    #[inline]
+    #[target_feature(enable = "neon")]
+    unsafe fn mulaw_lanes(s: int16x8_t) -> uint8x8_t {
+        let sign = vshrq_n_s16::<15>(s);
+        let magnitude = vreinterpretq_u16_s16(veorq_s16(s, sign));
+        let absno = vminq_u16(
+            vaddq_u16(vshrq_n_u16::<2>(magnitude), vdupq_n_u16(33)),
+            vdupq_n_u16(0x1FFF),
+        );
+        // Segment = bit length of absno minus 6, saturating at 0.
+        let bits = vsubq_u16(vdupq_n_u16(16), vclzq_u16(absno));
+        let segment = vqsubq_u16(bits, vdupq_n_u16(6));
+        let shift = vnegq_s16(vreinterpretq_s16_u16(vaddq_u16(segment, vdupq_n_u16(1))));
+        let mantissa = vandq_u16(vshlq_u16(absno, shift), vdupq_n_u16(0x0F));
+        let code = veorq_u16(
+            vorrq_u16(vshlq_n_u16::<4>(segment), mantissa),
+            vdupq_n_u16(0x7F),
+        );
+        let positive = vbicq_u16(vdupq_n_u16(0x80), vreinterpretq_u16_s16(sign));
+        vmovn_u16(vorrq_u16(code, positive))
+    }
+
+    /// A-law on 8 lanes, returned narrowed to bytes.
+    #[inline]
+    #[target_feature(enable = "neon")]
+    unsafe fn alaw_lanes(s: int16x8_t) -> uint8x8_t {
+        let sign = vshrq_n_s16::<15>(s);
+        let ix = vshrq_n_u16::<4>(vreinterpretq_u16_s16(veorq_s16(s, sign)));
+        let bits = vsubq_u16(vdupq_n_u16(16), vclzq_u16(ix));
+        let segment = vqsubq_u16(bits, vdupq_n_u16(4));
+        let shift = vnegq_s16(vreinterpretq_s16_u16(vqsubq_u16(segment, vdupq_n_u16(1))));
+        let mantissa = vandq_u16(vshlq_u16(ix, shift), vdupq_n_u16(0x0F));
+        let code = vorrq_u16(vshlq_n_u16::<4>(segment), mantissa);
+        let positive = vbicq_u16(vdupq_n_u16(0x80), vreinterpretq_u16_s16(sign));
+        vmovn_u16(veorq_u16(vorrq_u16(code, positive), vdupq_n_u16(0x55)))
+    }
+
+    #[target_feature(enable = "neon")]
+    pub(super) unsafe fn encode_mulaw(samples: &[i16], output: &mut [u8]) {
+        let mut chunks = samples.chunks_exact(16);
+        let mut out = output.as_mut_ptr();
+        for chunk in chunks.by_ref() {
+            let lo = mulaw_lanes(vld1q_s16(chunk.as_ptr()));
+            let hi = mulaw_lanes(vld1q_s16(chunk.as_ptr().add(8)));
+            vst1q_u8(out, vcombine_u8(lo, hi));
+            out = out.add(16);
+        }
+        let done = samples.len() - chunks.remainder().len();
+        encode_mulaw_scalar(chunks.remainder(), &mut output[done..]);
+    }
+
+    #[target_feature(enable = "neon")]
+    pub(super) unsafe fn encode_alaw(samples: &[i16], output: &mut [u8]) {
+        let mut chunks = samples.chunks_exact(16);
+        let mut out = output.as_mut_ptr();
+        for chunk in chunks.by_ref() {
+            let lo = alaw_lanes(vld1q_s16(chunk.as_ptr()));
+            let hi = alaw_lanes(vld1q_s16(chunk.as_ptr().add(8)));
+            vst1q_u8(out, vcombine_u8(lo, hi));
+            out = out.add(16);
+        }
+        let done = samples.len() - chunks.remainder().len();
+        encode_alaw_scalar(chunks.remainder(), &mut output[done..]);
     }
 }
 
@@ -365,6 +1030,15 @@ pub fn alaw_to_linear_scalar(alaw: u8) -> i16 {
 mod tests {
     use super::*;
 
+    fn all_samples() -> Vec<i16> {
+        (i16::MIN..=i16::MAX).collect()
+    }
+
+    fn all_codes() -> Vec<u8> {
+        // Repeat so every kernel sees full vectors plus a ragged tail.
+        (0..=255u8).cycle().take(256 * 3 + 7).collect()
+    }
+
     #[test]
     fn test_simd_support_detection() {
         init_simd_support();
@@ -414,6 +1088,19 @@ mod tests {
         );
     }
 
+    #[test]
+    fn test_scalar_known_values() {
+        // Same vectors as the ITU reference tests in codecs::g711::reference.
+        assert_eq!(linear_to_alaw_scalar(0), 0xd5);
+        assert_eq!(linear_to_alaw_scalar(1024), 0xe5);
+        assert_eq!(linear_to_alaw_scalar(-1024), 0x7a);
+        assert_eq!(linear_to_mulaw_scalar(0), 0xff);
+        assert_eq!(linear_to_mulaw_scalar(1024), 0xcd);
+        assert_eq!(linear_to_mulaw_scalar(-1024), 0x4d);
+        assert_eq!(alaw_to_linear_scalar(0xd5), 8);
+        assert_eq!(mulaw_to_linear_scalar(0xff), 0);
+    }
+
     #[test]
     fn test_simd_vs_scalar() {
         let samples = vec![0, 1000, -1000, 16000, -16000, 32000, -32000, 12345];
@@ -427,6 +1114,94 @@ mod tests {
         assert_eq!(simd_output, scalar_output);
     }
 
+    #[test]
+    fn test_encode_kernels_exhaustive() {
+        let samples = all_samples();
+        let mut expected_mu = vec![0u8; samples.len()];
+        let mut expected_a = vec![0u8; samples.len()];
+        encode_mulaw_scalar(&samples, &mut expected_mu);
+        encode_alaw_scalar(&samples, &mut expected_a);
+
+        let mut kernels: Vec<(&str, fn(&[i16], &mut [u8]), &[u8])> = vec![
+            (
+                "mulaw_optimized",
+                encode_mulaw_optimized as fn(&[i16], &mut [u8]),
+                &expected_mu[..],
+            ),
+            ("alaw_optimized", encode_alaw_optimized, &expected_a[..]),
+        ];
+        #[cfg(target_arch = "x86_64")]
+        kernels.extend([
+            (
+                "mulaw_sse2",
+                encode_mulaw_simd_sse2 as fn(&[i16], &mut [u8]),
+                &expected_mu[..],
+            ),
+            ("mulaw_avx2", encode_mulaw_simd_avx2, &expected_mu[..]),
+            ("alaw_sse2", encode_alaw_simd_sse2, &expected_a[..]),
+            ("alaw_avx2", encode_alaw_simd_avx2, &expected_a[..]),
+        ]);
+        #[cfg(target_arch = "aarch64")]
+        kernels.extend([
+            (
+                "mulaw_neon",
+                encode_mulaw_simd_neon as fn(&[i16], &mut [u8]),
+                &expected_mu[..],
+            ),
+            ("alaw_neon", encode_alaw_simd_neon, &expected_a[..]),
+        ]);
+
+        for (name, kernel, expected) in kernels {
+            let mut output = vec![0u8; samples.len()];
+            kernel(&samples, &mut output);
+            assert_eq!(output, expected, "{name} differs from scalar");
+        }
+    }
+
+    #[test]
+    fn test_decode_kernels_exhaustive() {
+        let codes = all_codes();
+        let mut expected_mu = vec![0i16; codes.len()];
+        let mut expected_a = vec![0i16; codes.len()];
+        decode_mulaw_scalar(&codes, &mut expected_mu);
+        decode_alaw_scalar(&codes, &mut expected_a);
+
+        let mut kernels: Vec<(&str, fn(&[u8], &mut [i16]), &[i16])> = vec![
+            (
+                "mulaw_optimized",
+                decode_mulaw_optimized as fn(&[u8], &mut [i16]),
+                &expected_mu[..],
+            ),
+            ("alaw_optimized", decode_alaw_optimized, &expected_a[..]),
+        ];
+        #[cfg(target_arch = "x86_64")]
+        kernels.extend([
+            (
+                "mulaw_sse2",
+                decode_mulaw_simd_sse2 as fn(&[u8], &mut [i16]),
+                &expected_mu[..],
+            ),
+            ("mulaw_avx2", decode_mulaw_simd_avx2, &expected_mu[..]),
+            ("alaw_sse2", decode_alaw_simd_sse2, &expected_a[..]),
+            ("alaw_avx2", decode_alaw_simd_avx2, &expected_a[..]),
+        ]);
+        #[cfg(target_arch = "aarch64")]
+        kernels.extend([
+            (
+                "mulaw_neon",
+                decode_mulaw_simd_neon as fn(&[u8], &mut [i16]),
+                &expected_mu[..],
+            ),
+            ("alaw_neon", decode_alaw_simd_neon, &expected_a[..]),
+        ]);
+
+        for (name, kernel, expected) in kernels {
+            let mut output = vec![0i16; codes.len()];
+            kernel(&codes, &mut output);
+            assert_eq!(output, expected, "{name} differs from scalar");
+        }
+    }
+
     #[test]
     fn test_empty_input() {
         let samples: Vec<i16> = vec![];
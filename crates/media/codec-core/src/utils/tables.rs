@@ -1,44 +1,46 @@
 //! Lookup table utilities for codec optimizations
 
-/// Pre-computed μ-law decoding table (8-bit μ-law to 16-bit linear)
+/// Pre-computed μ-law decoding table (8-bit μ-law to 16-bit linear, ITU-T G.711)
 pub static MULAW_DECODE_TABLE: [i16; 256] = [
-    16004, 14980, 13956, 12932, 11908, 10884, 9860, 8836, 7812, 6788, 5764, 4740, 3716, 2692, 1668,
-    644, 8068, 7556, 7044, 6532, 6020, 5508, 4996, 4484, 3972, 3460, 2948, 2436, 1924, 1412, 900,
-    388, 4100, 3844, 3588, 3332, 3076, 2820, 2564, 2308, 2052, 1796, 1540, 1284, 1028, 772, 516,
-    260, 2116, 1988, 1860, 1732, 1604, 1476, 1348, 1220, 1092, 964, 836, 708, 580, 452, 324, 196,
-    1124, 1060, 996, 932, 868, 804, 740, 676, 612, 548, 484, 420, 356, 292, 228, 164, 628, 596,
-    564, 532, 500, 468, 436, 404, 372, 340, 308, 276, 244, 212, 180, 148, 380, 364, 348, 332, 316,
-    300, 284, 268, 252, 236, 220, 204, 188, 172, 156, 140, 252, 244, 236, 228, 220, 212, 204, 196,
-    188, 180, 172, 164, 156, 148, 140, 132, -16004, -14980, -13956, -12932, -11908, -10884, -9860,
-    -8836, -7812, -6788, -5764, -4740, -3716, -2692, -1668, -644, -8068, -7556, -7044, -6532,
-    -6020, -5508, -4996, -4484, -3972, -3460, -2948, -2436, -1924, -1412, -900, -388, -4100, -3844,
-    -3588, -3332, -3076, -2820, -2564, -2308, -2052, -1796, -1540, -1284, -1028, -772, -516, -260,
-    -2116, -1988, -1860, -1732, -1604, -1476, -1348, -1220, -1092, -964, -836, -708, -580, -452,
-    -324, -196, -1124, -1060, -996, -932, -868, -804, -740, -676, -612, -548, -484, -420, -356,
-    -292, -228, -164, -628, -596, -564, -532, -500, -468, -436, -404, -372, -340, -308, -276, -244,
-    -212, -180, -148, -380, -364, -348, -332, -316, -300, -284, -268, -252, -236, -220, -204, -188,
-    -172, -156, -140, -252, -244, -236, -228, -220, -212, -204, -196, -188, -180, -172, -164, -156,
-    -148, -140, -132,
+    -32124, -31100, -30076, -29052, -28028, -27004, -25980, -24956, -23932, -22908, -21884, -20860,
+    -19836, -18812, -17788, -16764, -15996, -15484, -14972, -14460, -13948, -13436, -12924, -12412,
+    -11900, -11388, -10876, -10364, -9852, -9340, -8828, -8316, -7932, -7676, -7420, -7164, -6908,
+    -6652, -6396, -6140, -5884, -5628, -5372, -5116, -4860, -4604, -4348, -4092, -3900, -3772,
+    -3644, -3516, -3388, -3260, -3132, -3004, -2876, -2748, -2620, -2492, -2364, -2236, -2108,
+    -1980, -1884, -1820, -1756, -1692, -1628, -1564, -1500, -1436, -1372, -1308, -1244, -1180,
+    -1116, -1052, -988, -924, -876, -844, -812, -780, -748, -716, -684, -652, -620, -588, -556,
+    -524, -492, -460, -428, -396, -372, -356, -340, -324, -308, -292, -276, -260, -244, -228, -212,
+    -196, -180, -164, -148, -132, -120, -112, -104, -96, -88, -80, -72, -64, -56, -48, -40, -32,
+    -24, -16, -8, 0, 32124, 31100, 30076, 29052, 28028, 27004, 25980, 24956, 23932, 22908, 21884,
+    20860, 19836, 18812, 17788, 16764, 15996, 15484, 14972, 14460, 13948, 13436, 12924, 12412,
+    11900, 11388, 10876, 10364, 9852, 9340, 8828, 8316, 7932, 7676, 7420, 7164, 6908, 6652, 6396,
+    6140, 5884, 5628, 5372, 5116, 4860, 4604, 4348, 4092, 3900, 3772, 3644, 3516, 3388, 3260, 3132,
+    3004, 2876, 2748, 2620, 2492, 2364, 2236, 2108, 1980, 1884, 1820, 1756, 1692, 1628, 1564, 1500,
+    1436, 1372, 1308, 1244, 1180, 1116, 1052, 988, 924, 876, 844, 812, 780, 748, 716, 684, 652,
+    620, 588, 556, 524, 492, 460, 428, 396, 372, 356, 340, 324, 308, 292, 276, 260, 244, 228, 212,
+    196, 180, 164, 148, 132, 120, 112, 104, 96, 88, 80, 72, 64, 56, 48, 40, 32, 24, 16, 8, 0,
 ];
 
-/// Pre-computed A-law decoding table (8-bit A-law to 16-bit linear)
+/// Pre-computed A-law decoding table (8-bit A-law to 16-bit linear, ITU-T G.711)
 pub static ALAW_DECODE_TABLE: [i16; 256] = [
-    15880, 14856, 13832, 12808, 11784, 10760, 9736, 8712, 7688, 6664, 5640, 4616, 3592, 2568, 1544,
-    520, 7944, 7432, 6920, 6408, 5896, 5384, 4872, 4360, 3848, 3336, 2824, 2312, 1800, 1288, 776,
-    264, 3976, 3720, 3464, 3208, 2952, 2696, 2440, 2184, 1928, 1672, 1416, 1160, 904, 648, 392,
-    136, 1992, 1864, 1736, 1608, 1480, 1352, 1224, 1096, 968, 840, 712, 584, 456, 328, 200, 72,
-    1000, 936, 872, 808, 744, 680, 616, 552, 488, 424, 360, 296, 232, 168, 104, 40, 504, 472, 440,
-    408, 376, 344, 312, 280, 248, 216, 184, 152, 120, 88, 56, 24, 256, 240, 224, 208, 192, 176,
-    160, 144, 128, 112, 96, 80, 64, 48, 32, 16, 248, 232, 216, 200, 184, 168, 152, 136, 120, 104,
-    88, 72, 56, 40, 24, 8, -15880, -14856, -13832, -12808, -11784, -10760, -9736, -8712, -7688,
-    -6664, -5640, -4616, -3592, -2568, -1544, -520, -7944, -7432, -6920, -6408, -5896, -5384,
-    -4872, -4360, -3848, -3336, -2824, -2312, -1800, -1288, -776, -264, -3976, -3720, -3464, -3208,
-    -2952, -2696, -2440, -2184, -1928, -1672, -1416, -1160, -904, -648, -392, -136, -1992, -1864,
-    -1736, -1608, -1480, -1352, -1224, -1096, -968, -840, -712, -584, -456, -328, -200, -72, -1000,
-    -936, -872, -808, -744, -680, -616, -552, -488, -424, -360, -296, -232, -168, -104, -40, -504,
-    -472, -440, -408, -376, -344, -312, -280, -248, -216, -184, -152, -120, -88, -56, -24, -256,
-    -240, -224, -208, -192, -176, -160, -144, -128, -112, -96, -80, -64, -48, -32, -16, -248, -232,
-    -216, -200, -184, -168, -152, -136, -120, -104, -88, -72, -56, -40, -24, -8,
+    -5504, -5248, -6016, -5760, -4480, -4224, -4992, -4736, -7552, -7296, -8064, -7808, -6528,
+    -6272, -7040, -6784, -2752, -2624, -3008, -2880, -2240, -2112, -2496, -2368, -3776, -3648,
+    -4032, -3904, -3264, -3136, -3520, -3392, -22016, -20992, -24064, -23040, -17920, -16896,
+    -19968, -18944, -30208, -29184, -32256, -31232, -26112, -25088, -28160, -27136, -11008, -10496,
+    -12032, -11520, -8960, -8448, -9984, -9472, -15104, -14592, -16128, -15616, -13056, -12544,
+    -14080, -13568, -344, -328, -376, -360, -280, -264, -312, -296, -472, -456, -504, -488, -408,
+    -392, -440, -424, -88, -72, -120, -104, -24, -8, -56, -40, -216, -200, -248, -232, -152, -136,
+    -184, -168, -1376, -1312, -1504, -1440, -1120, -1056, -1248, -1184, -1888, -1824, -2016, -1952,
+    -1632, -1568, -1760, -1696, -688, -656, -752, -720, -560, -528, -624, -592, -944, -912, -1008,
+    -976, -816, -784, -880, -848, 5504, 5248, 6016, 5760, 4480, 4224, 4992, 4736, 7552, 7296, 8064,
+    7808, 6528, 6272, 7040, 6784, 2752, 2624, 3008, 2880, 2240, 2112, 2496, 2368, 3776, 3648, 4032,
+    3904, 3264, 3136, 3520, 3392, 22016, 20992, 24064, 23040, 17920, 16896, 19968, 18944, 30208,
+    29184, 32256, 31232, 26112, 25088, 28160, 27136, 11008, 10496, 12032, 11520, 8960, 8448, 9984,
+    9472, 15104, 14592, 16128, 15616, 13056, 12544, 14080, 13568, 344, 328, 376, 360, 280, 264,
+    312, 296, 472, 456, 504, 488, 408, 392, 440, 424, 88, 72, 120, 104, 24, 8, 56, 40, 216, 200,
+    248, 232, 152, 136, 184, 168, 1376, 1312, 1504, 1440, 1120, 1056, 1248, 1184, 1888, 1824, 2016,
+    1952, 1632, 1568, 1760, 1696, 688, 656, 752, 720, 560, 528, 624, 592, 944, 912, 1008, 976, 816,
+    784, 880, 848,
 ];
 
 /// Fast μ-law encoding using direct computation
@@ -117,19 +119,21 @@ mod tests {
         assert_eq!(MULAW_DECODE_TABLE.len(), 256);
         assert_eq!(ALAW_DECODE_TABLE.len(), 256);
 
-        // Test first and last values are reasonable
-        assert_ne!(MULAW_DECODE_TABLE[0], 0);
-        assert_ne!(MULAW_DECODE_TABLE[255], 0);
+        // Full-scale codes decode to the G.711 extremes; μ-law 0xFF/0x7F are
+        // the two encodings of silence.
+        assert_eq!(MULAW_DECODE_TABLE[0], -32124);
+        assert_eq!(MULAW_DECODE_TABLE[128], 32124);
+        assert_eq!(MULAW_DECODE_TABLE[255], 0);
+        assert_eq!(ALAW_DECODE_TABLE[0x2A], -32256);
+        assert_eq!(ALAW_DECODE_TABLE[0xAA], 32256);
         assert_ne!(ALAW_DECODE_TABLE[0], 0);
         assert_ne!(ALAW_DECODE_TABLE[255], 0);
     }
 
     #[test]
     fn test_table_vs_scalar() {
-        // Test decode tables only (they're small and fast)
-        let test_encoded = vec![0, 127, 128, 255];
-
-        for encoded in test_encoded {
+        // Decode tables are small enough to check exhaustively
+        for encoded in 0..=255u8 {
             // Test μ-law decode
             let table_result = decode_mulaw_table(encoded);
             let scalar_result = crate::utils::simd::mulaw_to_linear_scalar(encoded);
@@ -156,13 +160,9 @@ mod tests {
         let encoded = vec![0u8, 127, 128, 255];
         let mut decoded = vec![0i16; encoded.len()];
 
-        // Test μ-law batch decode
+        // Test μ-law batch decode (0x7F/0xFF are μ-law silence)
         decode_mulaw_batch(&encoded, &mut decoded);
-
-        // Verify we got some non-zero results
-        assert_ne!(decoded[1], 0);
-        assert_ne!(decoded[2], 0);
-        assert_ne!(decoded[3], 0);
+        assert_eq!(decoded, vec![-32124, 0, 32124, 0]);
 
         // Test A-law batch decode
         decode_alaw_batch(&encoded, &mut decoded);
@@ -190,13 +190,14 @@ pub fn validate_opus_frame(samples: &[i16], sample_rate: SampleRate) -> Result<(
     let rate_hz = sample_rate.hz();
     let frame_size = samples.len();
 
-    // Opus supports specific frame sizes based on sample rate
-    let valid_frame_sizes = match rate_hz {
-        8000 => vec![20, 40, 80, 160, 320, 480],
-        12000 => vec![30, 60, 120, 240, 480, 720],
-        16000 => vec![40, 80, 160, 320, 640, 960],
-        24000 => vec![60, 120, 240, 480, 960, 1440],
-        48000 => vec![120, 240, 480, 960, 1920, 2880],
+    // Opus supports specific frame sizes based on sample rate (2.5-60 ms).
+    // Static tables keep this check allocation-free on the per-frame path.
+    let valid_frame_sizes: &[usize] = match rate_hz {
+        8000 => &[20, 40, 80, 160, 320, 480],
+        12000 => &[30, 60, 120, 240, 480, 720],
+        16000 => &[40, 80, 160, 320, 640, 960],
+        24000 => &[60, 120, 240, 480, 960, 1440],
+        48000 => &[120, 240, 480, 960, 1920, 2880],
         _ => {
             return Err(CodecError::InvalidSampleRate {
                 rate: rate_hz,
@@ -19,11 +19,17 @@
 //! for all forwarded packets to land on the sink sockets. The
 //! per-iter time is therefore one forward round-trip across N
 //! concurrent bridges.
+//!
+//! Every bridge count runs under both `BridgeForwarding` modes:
+//! `receive_loop` relays from session A's transport receive task
+//! straight out of B's socket; `session_events` goes through A's event
+//! broadcast, the bridge forwarder task and B's send task. The gap
+//! between the two is the latency the broadcast path adds.
 
 use bytes::Bytes;
 use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
 use rvoip_media_core::relay::controller::{
-    bridge::BridgeHandle, MediaConfig, MediaSessionController,
+    bridge::BridgeHandle, BridgeForwarding, MediaConfig, MediaSessionController,
 };
 use rvoip_media_core::types::DialogId;
 use rvoip_rtp_core::{RtpHeader, RtpPacket};
@@ -62,7 +68,7 @@ struct BridgeFixture {
     payload: Bytes,
 }
 
-async fn build_fixture(n_bridges: usize) -> BridgeFixture {
+async fn build_fixture(n_bridges: usize, forwarding: BridgeForwarding) -> BridgeFixture {
     let controller = Arc::new(MediaSessionController::new());
     let mut bridges = Vec::with_capacity(n_bridges);
     let mut handles = Vec::with_capacity(n_bridges);
@@ -134,9 +140,10 @@ async fn build_fixture(n_bridges: usize) -> BridgeFixture {
                 .unwrap();
 
         let handle = controller
-            .bridge_sessions(dialog_a, dialog_b)
+            .bridge_sessions_with(dialog_a, dialog_b, forwarding)
             .await
             .expect("bridge_sessions");
+        assert_eq!(handle.forwarding(), forwarding);
         handles.push(handle);
 
         let sender = UdpSocket::bind("127.0.0.1:0").await.expect("bind sender");
@@ -203,42 +210,47 @@ fn bench_bridge_e2e(c: &mut Criterion) {
         .expect("runtime");
 
     let mut group = c.benchmark_group("bridge_e2e_roundtrip");
-    for &n in &BRIDGE_COUNTS {
-        // Throughput == bridged packets per round trip.
-        group.throughput(Throughput::Elements(n as u64));
-        group.bench_with_input(BenchmarkId::from_parameter(n), &n, |b, &n| {
-            // Build the fixture once outside the timed loop.
-            let mut fix_opt = Some(rt.block_on(build_fixture(n)));
-
-            // Let the bridge forwarder tasks actually start polling
-            // their broadcast receivers (they're tokio::spawn'd
-            // inside bridge_sessions; the spawn returns before the
-            // task has been scheduled).
-            std::thread::sleep(Duration::from_millis(100));
-
-            // Warm-up: send one round so socket buffers / forwarder
-            // tasks are paged in before measurement starts.
-            rt.block_on(drive_one_round(fix_opt.as_ref().unwrap()));
-
-            b.iter_custom(|iters| {
-                rt.block_on(async {
-                    let fix = fix_opt.as_ref().unwrap();
-                    let start = Instant::now();
-                    for _ in 0..iters {
-                        drive_one_round(fix).await;
-                    }
-                    start.elapsed()
-                })
-            });
+    for (mode, forwarding) in [
+        ("receive_loop", BridgeForwarding::ReceiveLoop),
+        ("session_events", BridgeForwarding::SessionEvents),
+    ] {
+        for &n in &BRIDGE_COUNTS {
+            // Throughput == bridged packets per round trip.
+            group.throughput(Throughput::Elements(n as u64));
+            group.bench_with_input(BenchmarkId::new(mode, n), &n, |b, &n| {
+                // Build the fixture once outside the timed loop.
+                let mut fix_opt = Some(rt.block_on(build_fixture(n, forwarding)));
+
+                // Let the bridge forwarder tasks actually start polling
+                // their broadcast receivers (they're tokio::spawn'd
+                // inside bridge_sessions; the spawn returns before the
+                // task has been scheduled).
+                std::thread::sleep(Duration::from_millis(100));
+
+                // Warm-up: send one round so socket buffers / forwarder
+                // tasks are paged in before measurement starts.
+                rt.block_on(drive_one_round(fix_opt.as_ref().unwrap()));
 
-            // `BridgeHandle::Drop` spawns a tokio task to abort the
-            // forwarder, which panics if invoked outside a runtime
-            // context. Drop the fixture inside `rt.block_on` so the
-            // current runtime is available for that spawn.
-            rt.block_on(async move {
-                drop(fix_opt.take());
+                b.iter_custom(|iters| {
+                    rt.block_on(async {
+                        let fix = fix_opt.as_ref().unwrap();
+                        let start = Instant::now();
+                        for _ in 0..iters {
+                            drive_one_round(fix).await;
+                        }
+                        start.elapsed()
+                    })
+                });
+
+                // `BridgeHandle::Drop` spawns a tokio task to abort the
+                // forwarder, which panics if invoked outside a runtime
+                // context. Drop the fixture inside `rt.block_on` so the
+                // current runtime is available for that spawn.
+                rt.block_on(async move {
+                    drop(fix_opt.take());
+                });
             });
-        });
+        }
     }
     group.finish();
 }
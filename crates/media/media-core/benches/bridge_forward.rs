@@ -21,10 +21,22 @@
 //! Use the deltas here to size up the per-bridge lookup contribution;
 //! end-to-end forward throughput will land on top via
 //! `audio_frame_pipeline` and any future full-bridge bench.
+//!
+//! 3. Per-packet CPU of the two forwarding modes, plain and SRTP on both
+//!    legs (`bridge_packet_rewrite`): the session-event path parses the
+//!    datagram into an owned `RtpPacket` and builds and serializes a new
+//!    one for the other leg; the receive-loop path copies it into a
+//!    reused buffer and rewrites SSRC/sequence/timestamp in place
+//!    (`RtpTranslator`). Task hops and broadcast fan-out are not in this
+//!    number — `bridge_e2e` measures those end to end.
 
+use bytes::{Bytes, BytesMut};
 use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
 use dashmap::DashMap;
 use rvoip_media_core::types::DialogId;
+use rvoip_rtp_core::srtp::{SrtpContext, SrtpCryptoKey, SRTP_AES128_CM_SHA1_80};
+use rvoip_rtp_core::transport::RtpTranslator;
+use rvoip_rtp_core::{RtpHeader, RtpPacket};
 use std::collections::HashMap;
 use std::sync::Arc;
 use std::time::{Duration, Instant};
@@ -160,5 +172,130 @@ fn bench_contended_lookup(c: &mut Criterion) {
     group.finish();
 }
 
-criterion_group!(benches, bench_uncontended_lookup, bench_contended_lookup);
+fn srtp_context(key: u8) -> SrtpContext {
+    SrtpContext::new(
+        SRTP_AES128_CM_SHA1_80,
+        SrtpCryptoKey::new(vec![key; 16], vec![key.wrapping_add(1); 14]),
+    )
+    .expect("srtp context")
+}
+
+/// The inbound datagram for packet `seq`: 20 ms of PCMU, SRTP-protected
+/// when `srtp` holds the far end's context.
+fn inbound_datagram(seq: u16, srtp: Option<&mut SrtpContext>, out: &mut BytesMut) {
+    out.clear();
+    let header = RtpHeader::new(0, seq, u32::from(seq) * 160, 0xdead_beef);
+    RtpPacket::new(header, Bytes::from_static(&[0xd5; 160]))
+        .write_to(out)
+        .expect("serialize");
+    if let Some(ctx) = srtp {
+        out.reserve(ctx.rtp_trailer_len());
+        ctx.protect_in_place(out).expect("protect");
+    }
+}
+
+/// Session-event forwarding, as the transport and session send task do
+/// it: unprotect into a scratch buffer and split an owned packet off it,
+/// then build the outbound packet from its payload/timestamp/marker,
+/// serialize it into the send buffer and protect it there.
+fn forward_via_packet(
+    datagram: &[u8],
+    seq: u16,
+    recv_buf: &mut BytesMut,
+    send_buf: &mut BytesMut,
+    srtp: Option<(&mut SrtpContext, &mut SrtpContext)>,
+) {
+    let (inbound, outbound) = match srtp {
+        Some((recv, send)) => {
+            recv_buf.clear();
+            recv_buf.extend_from_slice(datagram);
+            recv.unprotect_in_place(recv_buf).expect("unprotect");
+            let packet = RtpPacket::parse_from_bytes(recv_buf.split().freeze()).expect("parse");
+            (packet, Some(send))
+        }
+        None => (RtpPacket::parse(datagram).expect("parse"), None),
+    };
+    let mut header = RtpHeader::new(0, seq, inbound.header.timestamp, 0x0b0b_0b0b);
+    header.marker = inbound.header.marker;
+    let packet = RtpPacket::new(header, inbound.payload.clone());
+    send_buf.clear();
+    packet.write_to(send_buf).expect("serialize");
+    if let Some(ctx) = outbound {
+        send_buf.reserve(ctx.rtp_trailer_len());
+        ctx.protect_in_place(send_buf).expect("protect");
+    }
+}
+
+/// Receive-loop forwarding: copy into a reused buffer, unprotect, rewrite
+/// in place, protect.
+fn forward_in_place(
+    datagram: &[u8],
+    seq: u16,
+    translator: &mut RtpTranslator,
+    scratch: &mut BytesMut,
+    srtp: Option<(&mut SrtpContext, &mut SrtpContext)>,
+) {
+    scratch.clear();
+    scratch.extend_from_slice(datagram);
+    let outbound = match srtp {
+        Some((recv, send)) => {
+            recv.unprotect_in_place(scratch).expect("unprotect");
+            Some(send)
+        }
+        None => None,
+    };
+    translator.rewrite(scratch, seq, Instant::now());
+    if let Some(ctx) = outbound {
+        scratch.reserve(ctx.rtp_trailer_len());
+        ctx.protect_in_place(scratch).expect("protect");
+    }
+}
+
+fn bench_packet_rewrite(c: &mut Criterion) {
+    let mut group = c.benchmark_group("bridge_packet_rewrite");
+    group.throughput(Throughput::Elements(1));
+    for srtp in [false, true] {
+        let label = if srtp { "srtp" } else { "plain" };
+
+        group.bench_function(BenchmarkId::new("session_events", label), |b| {
+            let mut far_end = srtp.then(|| srtp_context(1));
+            let mut legs = srtp.then(|| (srtp_context(1), srtp_context(2)));
+            let mut datagram = BytesMut::with_capacity(2048);
+            let mut recv_buf = BytesMut::with_capacity(2048);
+            let mut send_buf = BytesMut::with_capacity(2048);
+            let mut seq = 0u16;
+            b.iter(|| {
+                seq = seq.wrapping_add(1);
+                inbound_datagram(seq, far_end.as_mut(), &mut datagram);
+                let legs = legs.as_mut().map(|(recv, send)| (recv, send));
+                forward_via_packet(&datagram, seq, &mut recv_buf, &mut send_buf, legs);
+                black_box(&send_buf);
+            });
+        });
+
+        group.bench_function(BenchmarkId::new("receive_loop", label), |b| {
+            let mut far_end = srtp.then(|| srtp_context(1));
+            let mut legs = srtp.then(|| (srtp_context(1), srtp_context(2)));
+            let mut translator = RtpTranslator::new(0x0b0b_0b0b, 8000);
+            let mut datagram = BytesMut::with_capacity(2048);
+            let mut scratch = BytesMut::with_capacity(2048);
+            let mut seq = 0u16;
+            b.iter(|| {
+                seq = seq.wrapping_add(1);
+                inbound_datagram(seq, far_end.as_mut(), &mut datagram);
+                let legs = legs.as_mut().map(|(recv, send)| (recv, send));
+                forward_in_place(&datagram, seq, &mut translator, &mut scratch, legs);
+                black_box(&scratch);
+            });
+        });
+    }
+    group.finish();
+}
+
+criterion_group!(
+    benches,
+    bench_uncontended_lookup,
+    bench_contended_lookup,
+    bench_packet_rewrite
+);
 criterion_main!(benches);
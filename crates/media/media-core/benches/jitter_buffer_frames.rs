@@ -10,18 +10,21 @@
 //! This bench gives us the pre-refactor baseline so Phase C6's
 //! collapse-to-one-parking-lot-mutex-plus-atomics is measurable.
 //!
-//! Three scenarios mirroring `rtp-core/benches/jitter_buffer.rs`:
+//! Four scenarios mirroring `rtp-core/benches/jitter_buffer.rs`:
 //!
 //! - `add_in_order` — strictly monotonic sequence numbers, the
 //!   dominant production path.
 //! - `add_out_of_order` — small reorder window (±4).
 //! - `add_get_steady` — alternating add + drain at depth N.
+//! - `add_get_lossy` — add + drain with adjacent swaps and one frame in
+//!   20 lost.
 //!
-//! Depth sweep: {0, 10, 100, 1000}.
+//! Depth sweep: {0, 10, 100, 1000}, against both `JitterBufferStorage`
+//! backends; benchmark IDs are `<storage>/<depth>`.
 
 use bytes::Bytes;
 use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
-use rvoip_media_core::buffer::{JitterBuffer, JitterBufferConfig};
+use rvoip_media_core::buffer::{JitterBuffer, JitterBufferConfig, JitterBufferStorage};
 use rvoip_media_core::types::{AudioFrame, MediaPacket};
 use std::time::{Duration, Instant};
 use tokio::runtime::Builder;
@@ -29,6 +32,11 @@ use tokio::runtime::Builder;
 const DEPTHS: [usize; 4] = [0, 10, 100, 1000];
 const SAMPLES_PER_FRAME: usize = 160; // 20 ms @ 8 kHz
 
+const STORAGES: [(&str, JitterBufferStorage); 2] = [
+    ("ring", JitterBufferStorage::Ring),
+    ("btree", JitterBufferStorage::BTreeMap),
+];
+
 fn make_packet_and_frame(seq: u16) -> (MediaPacket, AudioFrame) {
     let payload: Vec<u8> = (0..SAMPLES_PER_FRAME).map(|i| (i & 0xff) as u8).collect();
     let packet = MediaPacket {
@@ -44,7 +52,7 @@ fn make_packet_and_frame(seq: u16) -> (MediaPacket, AudioFrame) {
     (packet, frame)
 }
 
-fn make_buffer() -> JitterBuffer {
+fn make_buffer(storage: JitterBufferStorage) -> JitterBuffer {
     JitterBuffer::new(JitterBufferConfig {
         // Generous depths so pre-population doesn't trip overflow before
         // the timed loop starts.
@@ -52,6 +60,7 @@ fn make_buffer() -> JitterBuffer {
         min_depth: 2,
         max_depth: 4096,
         max_late_packet_age_ms: 60_000,
+        storage,
         ..Default::default()
     })
 }
@@ -60,26 +69,32 @@ fn bench_add_in_order(c: &mut Criterion) {
     let rt = Builder::new_current_thread().enable_all().build().unwrap();
     let mut group = c.benchmark_group("media_jitter_add_in_order");
     group.throughput(Throughput::Elements(1));
-    for depth in DEPTHS {
-        group.bench_with_input(BenchmarkId::from_parameter(depth), &depth, |b, &depth| {
-            b.iter_custom(|iters| {
-                rt.block_on(async {
-                    let buf = make_buffer();
-                    for i in 1..=depth as u16 {
-                        let (p, f) = make_packet_and_frame(i);
-                        let _ = buf.add_frame(p, f).await;
-                    }
-                    let mut seq = depth as u16 + 1;
-                    let start = Instant::now();
-                    for _ in 0..iters {
-                        let (p, f) = make_packet_and_frame(seq);
-                        let _ = buf.add_frame(p, f).await;
-                        seq = seq.wrapping_add(1);
-                    }
-                    start.elapsed()
-                })
-            });
-        });
+    for (storage_name, storage) in STORAGES {
+        for depth in DEPTHS {
+            group.bench_with_input(
+                BenchmarkId::new(storage_name, depth),
+                &depth,
+                |b, &depth| {
+                    b.iter_custom(|iters| {
+                        rt.block_on(async {
+                            let buf = make_buffer(storage);
+                            for i in 1..=depth as u16 {
+                                let (p, f) = make_packet_and_frame(i);
+                                let _ = buf.add_frame(p, f).await;
+                            }
+                            let mut seq = depth as u16 + 1;
+                            let start = Instant::now();
+                            for _ in 0..iters {
+                                let (p, f) = make_packet_and_frame(seq);
+                                let _ = buf.add_frame(p, f).await;
+                                seq = seq.wrapping_add(1);
+                            }
+                            start.elapsed()
+                        })
+                    });
+                },
+            );
+        }
     }
     group.finish();
 }
@@ -88,40 +103,46 @@ fn bench_add_out_of_order(c: &mut Criterion) {
     let rt = Builder::new_current_thread().enable_all().build().unwrap();
     let mut group = c.benchmark_group("media_jitter_add_out_of_order");
     group.throughput(Throughput::Elements(1));
-    for depth in DEPTHS {
-        group.bench_with_input(BenchmarkId::from_parameter(depth), &depth, |b, &depth| {
-            b.iter_custom(|iters| {
-                rt.block_on(async {
-                    let buf = make_buffer();
-                    // Pre-populate with small reorder swaps every 8 frames.
-                    for chunk in (1..=depth as u16).collect::<Vec<_>>().chunks(8) {
-                        let mut g = chunk.to_vec();
-                        if g.len() >= 8 {
-                            g.swap(0, 7);
-                            g.swap(2, 5);
-                        }
-                        for s in g {
-                            let (p, f) = make_packet_and_frame(s);
-                            let _ = buf.add_frame(p, f).await;
-                        }
-                    }
-                    let mut probe = depth as u16 + 1;
-                    let start = Instant::now();
-                    for i in 0..iters {
-                        let seq = if i & 1 == 0 {
-                            probe.wrapping_sub(2)
-                        } else {
-                            let s = probe;
-                            probe = probe.wrapping_add(1);
-                            s
-                        };
-                        let (p, f) = make_packet_and_frame(seq);
-                        let _ = buf.add_frame(p, f).await;
-                    }
-                    start.elapsed()
-                })
-            });
-        });
+    for (storage_name, storage) in STORAGES {
+        for depth in DEPTHS {
+            group.bench_with_input(
+                BenchmarkId::new(storage_name, depth),
+                &depth,
+                |b, &depth| {
+                    b.iter_custom(|iters| {
+                        rt.block_on(async {
+                            let buf = make_buffer(storage);
+                            // Pre-populate with small reorder swaps every 8 frames.
+                            for chunk in (1..=depth as u16).collect::<Vec<_>>().chunks(8) {
+                                let mut g = chunk.to_vec();
+                                if g.len() >= 8 {
+                                    g.swap(0, 7);
+                                    g.swap(2, 5);
+                                }
+                                for s in g {
+                                    let (p, f) = make_packet_and_frame(s);
+                                    let _ = buf.add_frame(p, f).await;
+                                }
+                            }
+                            let mut probe = depth as u16 + 1;
+                            let start = Instant::now();
+                            for i in 0..iters {
+                                let seq = if i & 1 == 0 {
+                                    probe.wrapping_sub(2)
+                                } else {
+                                    let s = probe;
+                                    probe = probe.wrapping_add(1);
+                                    s
+                                };
+                                let (p, f) = make_packet_and_frame(seq);
+                                let _ = buf.add_frame(p, f).await;
+                            }
+                            start.elapsed()
+                        })
+                    });
+                },
+            );
+        }
     }
     group.finish();
 }
@@ -130,28 +151,80 @@ fn bench_add_get_steady(c: &mut Criterion) {
     let rt = Builder::new_current_thread().enable_all().build().unwrap();
     let mut group = c.benchmark_group("media_jitter_add_get_steady");
     group.throughput(Throughput::Elements(1));
-    for depth in DEPTHS {
-        group.bench_with_input(BenchmarkId::from_parameter(depth), &depth, |b, &depth| {
-            b.iter_custom(|iters| {
-                rt.block_on(async {
-                    let buf = make_buffer();
-                    for i in 1..=depth as u16 {
-                        let (p, f) = make_packet_and_frame(i);
-                        let _ = buf.add_frame(p, f).await;
-                    }
-                    let mut seq = depth as u16 + 1;
-                    let start = Instant::now();
-                    for _ in 0..iters {
-                        let (p, f) = make_packet_and_frame(seq);
-                        let _ = buf.add_frame(p, f).await;
-                        seq = seq.wrapping_add(1);
-                        let popped = buf.get_next_frame().await.ok().flatten();
-                        black_box(popped);
-                    }
-                    start.elapsed()
-                })
-            });
-        });
+    for (storage_name, storage) in STORAGES {
+        for depth in DEPTHS {
+            group.bench_with_input(
+                BenchmarkId::new(storage_name, depth),
+                &depth,
+                |b, &depth| {
+                    b.iter_custom(|iters| {
+                        rt.block_on(async {
+                            let buf = make_buffer(storage);
+                            for i in 1..=depth as u16 {
+                                let (p, f) = make_packet_and_frame(i);
+                                let _ = buf.add_frame(p, f).await;
+                            }
+                            let mut seq = depth as u16 + 1;
+                            let start = Instant::now();
+                            for _ in 0..iters {
+                                let (p, f) = make_packet_and_frame(seq);
+                                let _ = buf.add_frame(p, f).await;
+                                seq = seq.wrapping_add(1);
+                                let popped = buf.get_next_frame().await.ok().flatten();
+                                black_box(popped);
+                            }
+                            start.elapsed()
+                        })
+                    });
+                },
+            );
+        }
+    }
+    group.finish();
+}
+
+fn bench_add_get_lossy(c: &mut Criterion) {
+    let rt = Builder::new_current_thread().enable_all().build().unwrap();
+    let mut group = c.benchmark_group("media_jitter_add_get_lossy");
+    group.throughput(Throughput::Elements(1));
+    for (storage_name, storage) in STORAGES {
+        for depth in DEPTHS {
+            group.bench_with_input(
+                BenchmarkId::new(storage_name, depth),
+                &depth,
+                |b, &depth| {
+                    b.iter_custom(|iters| {
+                        rt.block_on(async {
+                            let buf = make_buffer(storage);
+                            for i in 1..=depth as u16 {
+                                let (p, f) = make_packet_and_frame(i);
+                                let _ = buf.add_frame(p, f).await;
+                            }
+                            let mut next = depth as u16 + 1;
+                            let start = Instant::now();
+                            for i in 0..iters {
+                                // Swap each adjacent pair and drop every 20th
+                                // sequence number on the wire.
+                                let seq = if i & 1 == 0 {
+                                    next.wrapping_add(1)
+                                } else {
+                                    let s = next;
+                                    next = next.wrapping_add(2);
+                                    s
+                                };
+                                if seq % 20 != 0 {
+                                    let (p, f) = make_packet_and_frame(seq);
+                                    let _ = buf.add_frame(p, f).await;
+                                }
+                                let popped = buf.get_next_frame().await.ok().flatten();
+                                black_box(popped);
+                            }
+                            start.elapsed()
+                        })
+                    });
+                },
+            );
+        }
     }
     group.finish();
 }
@@ -160,7 +233,8 @@ criterion_group!(
     benches,
     bench_add_in_order,
     bench_add_out_of_order,
-    bench_add_get_steady
+    bench_add_get_steady,
+    bench_add_get_lossy
 );
 criterion_main!(benches);
 // silence unused warning for `Duration` if optimization removes it
@@ -1,18 +1,23 @@
 //! Conference audio mixer micro-benchmark.
 //!
-//! `AudioMixer` (processing/audio/mixer.rs) holds five separate
-//! `tokio::sync::Mutex` instances on its hot path: `stats`,
-//! `output_cache`, `frame_pool`, `format_converter`, `vad`. Each one is
-//! grabbed (with `.await`) on every `mix_participants` cycle, so the
-//! per-cycle scheduler overhead grows with the number of participants.
+//! `AudioMixer` (processing/audio/mixer.rs) mixes only the loudest
+//! `max_active_speakers` participants: it sums them once, derives each
+//! speaker's N-1 mix by subtraction, and gives every other participant one
+//! shared mix. Mix cost should therefore stay nearly flat as the
+//! conference grows, apart from per-participant bookkeeping.
 //!
-//! Two scenarios:
+//! Three scenarios, at N = {3, 10, 25, 50, 100, 200} participants:
 //!
 //! - `mixer_add_stream` — `add_audio_stream` cost at N participants.
-//!   Touches `stats` Mutex and the stream-manager DashMap.
-//! - `mixer_mix_cycle` — full `process_audio_frame` × N inputs →
-//!   `mix_participants` round at N = {2, 4, 8, 16} participants. The
-//!   load-bearing number for conference scalability.
+//! - `mixer_mix_cycle` — one `mix_cycle` after N frames were ingested,
+//!   i.e. the mix cost per 20 ms cycle. Ingestion (`process_audio_frame`)
+//!   is not timed.
+//! - `mixer_mix_participants` — the same cycle through
+//!   `mix_participants`, which copies a frame out per participant.
+//!
+//! Voice-activity mixing is off so speaker selection is by level alone and
+//! does not depend on how long the bench has been running (the VAD treats
+//! new streams as talking for 30 s).
 
 use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
 use rvoip_media_core::processing::audio::AudioMixer;
@@ -22,7 +27,7 @@ use std::time::Instant;
 use tokio::runtime::Builder;
 
 const SAMPLES_PER_FRAME: usize = 160; // 20 ms @ 8 kHz
-const PARTICIPANT_COUNTS: [usize; 4] = [2, 4, 8, 16];
+const PARTICIPANT_COUNTS: [usize; 6] = [3, 10, 25, 50, 100, 200];
 
 fn make_frame(seed: i16) -> AudioFrame {
     let samples: Vec<i16> = (0..SAMPLES_PER_FRAME)
@@ -41,6 +46,7 @@ async fn build_mixer(n: usize) -> AudioMixer {
         output_sample_rate: 8_000,
         output_channels: 1,
         output_samples_per_frame: SAMPLES_PER_FRAME as u32,
+        enable_voice_activity_mixing: false,
         ..Default::default()
     };
     AudioMixer::new(cfg).await.expect("mixer")
@@ -81,11 +87,18 @@ fn bench_add_stream(c: &mut Criterion) {
     group.finish();
 }
 
-fn bench_mix_cycle(c: &mut Criterion) {
+/// Which mixer entry point a mix-cycle bench drives
+#[derive(Clone, Copy)]
+enum MixApi {
+    Shared,
+    Owned,
+}
+
+fn bench_mix(c: &mut Criterion, group_name: &str, api: MixApi) {
     let rt = Builder::new_current_thread().enable_all().build().unwrap();
-    let mut group = c.benchmark_group("mixer_mix_cycle");
+    let mut group = c.benchmark_group(group_name);
     for &n in &PARTICIPANT_COUNTS {
-        // One full mix cycle ingests N frames and produces N mixed outputs.
+        // One mix cycle serves N participants.
         group.throughput(Throughput::Elements(n as u64));
         group.bench_with_input(BenchmarkId::from_parameter(n), &n, |b, &n| {
             b.iter_custom(|iters| {
@@ -97,24 +110,30 @@ fn bench_mix_cycle(c: &mut Criterion) {
                             .add_audio_stream(p.clone(), AudioStream::new(p, 8_000, 1))
                             .await;
                     }
-                    // Pre-build the frames so per-iteration overhead is
-                    // dominated by the mix path, not Vec<i16> allocation.
+                    // Distinct levels per participant so speaker selection
+                    // has a real ranking to do.
                     let frames: Vec<(ParticipantId, AudioFrame)> = (0..n)
                         .map(|i| (participant(i), make_frame((i * 37) as i16)))
                         .collect();
                     let inputs: Vec<AudioFrame> = frames.iter().map(|(_, f)| f.clone()).collect();
 
-                    let start = Instant::now();
+                    let mut total = std::time::Duration::ZERO;
                     for _ in 0..iters {
-                        // 1. Push N frames in.
                         for (pid, f) in &frames {
                             let _ = mixer.process_audio_frame(pid, f.clone()).await;
                         }
-                        // 2. Run the N-way mix → N outputs.
-                        let out = mixer.mix_participants(&inputs).await.expect("mix");
-                        black_box(out);
+                        let start = Instant::now();
+                        match api {
+                            MixApi::Shared => {
+                                black_box(mixer.mix_cycle().await.expect("mix"));
+                            }
+                            MixApi::Owned => {
+                                black_box(mixer.mix_participants(&inputs).await.expect("mix"));
+                            }
+                        }
+                        total += start.elapsed();
                     }
-                    start.elapsed()
+                    total
                 })
             });
         });
@@ -122,5 +141,18 @@ fn bench_mix_cycle(c: &mut Criterion) {
     group.finish();
 }
 
-criterion_group!(benches, bench_add_stream, bench_mix_cycle);
+fn bench_mix_cycle(c: &mut Criterion) {
+    bench_mix(c, "mixer_mix_cycle", MixApi::Shared);
+}
+
+fn bench_mix_participants(c: &mut Criterion) {
+    bench_mix(c, "mixer_mix_participants", MixApi::Owned);
+}
+
+criterion_group!(
+    benches,
+    bench_add_stream,
+    bench_mix_cycle,
+    bench_mix_participants
+);
 criterion_main!(benches);
@@ -0,0 +1,287 @@
+//! Playout-engine jitter-trace replay.
+//!
+//! `buffer/playout::PlayoutEngine` trades latency against concealment: it
+//! sets its target delay from the arrival-delay histogram and
+//! time-stretches towards it. This bench replays jitter traces through
+//! the engine on a virtual 20 ms playout clock and reports, per trace:
+//!
+//! - **added delay** — audio buffered ahead of the playout point after
+//!   each tick (mean and p95, ms), i.e. what the engine adds to
+//!   mouth-to-ear latency;
+//! - **concealment ratio** — fraction of played samples that were
+//!   concealment;
+//! - how often it accelerated / preemptively expanded / concealed.
+//!
+//! The built-in traces are generated from fixed seeds, so every run sees
+//! the same packets:
+//!
+//! - `wired` — 0–4 ms uniform jitter, no loss.
+//! - `wifi` — ~8 ms exponential jitter with periodic 60–120 ms
+//!   retransmission spikes, 1% loss.
+//! - `lte_handover` — low jitter, a 300 ms stall with burst delivery every
+//!   10 s, 2% loss.
+//! - `lossy_mobile` — ~20 ms jitter with Gilbert-Elliott bursty loss
+//!   (~8%).
+//!
+//! A recorded trace can be replayed as well by pointing
+//! `RVOIP_PLAYOUT_TRACE` at a file with one line per packet in sequence
+//! order: the arrival time in ms relative to the first packet's send
+//! time, or `-` for a packet that never arrived. Packet `n` is assumed to
+//! be sent at `n * 20` ms; lines starting with `#` are ignored.
+//!
+//! The Criterion timings are the CPU cost of replaying a whole trace
+//! (insert + get_audio for every frame), reported per 20 ms frame.
+
+use bytes::Bytes;
+use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+use rvoip_media_core::buffer::{PlayoutConfig, PlayoutEngine, PlayoutStats};
+use rvoip_media_core::types::{AudioFrame, MediaPacket};
+use std::time::{Duration, Instant};
+use tokio::runtime::{Builder, Runtime};
+
+const FRAME_MS: u64 = 20;
+const SAMPLES_PER_FRAME: usize = 160; // 20 ms @ 8 kHz
+const TRACE_PACKETS: usize = 3000; // 60 s
+
+/// Arrival time (ms) per packet in sequence order; `None` = lost
+type Trace = Vec<Option<u64>>;
+
+/// xorshift64*, so traces don't depend on an RNG crate's stream
+struct Rng(u64);
+
+impl Rng {
+    fn next_f64(&mut self) -> f64 {
+        self.0 ^= self.0 >> 12;
+        self.0 ^= self.0 << 25;
+        self.0 ^= self.0 >> 27;
+        (self.0.wrapping_mul(0x2545_f491_4f6c_dd1d) >> 11) as f64 / (1u64 << 53) as f64
+    }
+
+    fn exp(&mut self, mean: f64) -> f64 {
+        -mean * (1.0 - self.next_f64()).ln()
+    }
+}
+
+fn send_ms(seq: usize) -> f64 {
+    (seq as u64 * FRAME_MS) as f64
+}
+
+fn wired() -> Trace {
+    let mut rng = Rng(0x5eed_0001);
+    (0..TRACE_PACKETS)
+        .map(|seq| Some((send_ms(seq) + 10.0 + rng.next_f64() * 4.0) as u64))
+        .collect()
+}
+
+fn wifi() -> Trace {
+    let mut rng = Rng(0x5eed_0002);
+    let mut spike_until = 0.0;
+    (0..TRACE_PACKETS)
+        .map(|seq| {
+            if rng.next_f64() < 0.01 {
+                return None;
+            }
+            let sent = send_ms(seq);
+            // Link-layer retransmission: packets queue behind a stall and
+            // leave together.
+            if seq % 50 == 0 {
+                spike_until = sent + 60.0 + rng.next_f64() * 60.0;
+            }
+            let arrival = (sent + 5.0 + rng.exp(8.0)).max(spike_until);
+            Some(arrival as u64)
+        })
+        .collect()
+}
+
+fn lte_handover() -> Trace {
+    let mut rng = Rng(0x5eed_0003);
+    (0..TRACE_PACKETS)
+        .map(|seq| {
+            if rng.next_f64() < 0.02 {
+                return None;
+            }
+            let sent = send_ms(seq);
+            let mut arrival = sent + 30.0 + rng.next_f64() * 6.0;
+            // Every 10 s the bearer stalls for 300 ms and then flushes.
+            let phase = sent % 10_000.0;
+            if (5_000.0..5_300.0).contains(&phase) {
+                arrival = arrival.max(sent - phase + 5_300.0 + 30.0);
+            }
+            Some(arrival as u64)
+        })
+        .collect()
+}
+
+fn lossy_mobile() -> Trace {
+    let mut rng = Rng(0x5eed_0004);
+    let mut bad = false;
+    let mut last = 0.0f64;
+    (0..TRACE_PACKETS)
+        .map(|seq| {
+            // Gilbert-Elliott: good state loses 2%, bad state 50%.
+            bad = if bad {
+                rng.next_f64() > 0.3
+            } else {
+                rng.next_f64() < 0.05
+            };
+            let lost = rng.next_f64() < if bad { 0.5 } else { 0.02 };
+            let sent = send_ms(seq);
+            // Arrivals stay roughly in order, as on a single radio bearer.
+            let arrival = (sent + 40.0 + rng.exp(20.0)).max(last - 10.0);
+            last = arrival;
+            (!lost).then_some(arrival as u64)
+        })
+        .collect()
+}
+
+fn recorded_trace() -> Option<(String, Trace)> {
+    let path = std::env::var("RVOIP_PLAYOUT_TRACE").ok()?;
+    let text = std::fs::read_to_string(&path)
+        .unwrap_or_else(|e| panic!("RVOIP_PLAYOUT_TRACE={}: {}", path, e));
+    let trace = text
+        .lines()
+        .map(str::trim)
+        .filter(|line| !line.is_empty() && !line.starts_with('#'))
+        .map(|line| match line {
+            "-" => None,
+            ms => Some(ms.parse::<f64>().expect("arrival time in ms") as u64),
+        })
+        .collect();
+    Some(("recorded".to_string(), trace))
+}
+
+fn traces() -> Vec<(String, Trace)> {
+    let mut traces = vec![
+        ("wired".to_string(), wired()),
+        ("wifi".to_string(), wifi()),
+        ("lte_handover".to_string(), lte_handover()),
+        ("lossy_mobile".to_string(), lossy_mobile()),
+    ];
+    traces.extend(recorded_trace());
+    traces
+}
+
+/// Voiced-speech stand-in: a 125 Hz harmonic tone in 1 s talkspurts
+fn speech_frame(seq: u16) -> Vec<i16> {
+    (0..SAMPLES_PER_FRAME)
+        .map(|i| {
+            let n = seq as usize * SAMPLES_PER_FRAME + i;
+            if (n / 8000) % 2 == 1 {
+                return 0;
+            }
+            let phase = n as f32 * 2.0 * std::f32::consts::PI / 64.0;
+            (phase.sin() * 6000.0 + (2.0 * phase).sin() * 3000.0 + (3.0 * phase).sin() * 1500.0)
+                as i16
+        })
+        .collect()
+}
+
+/// Packets of `trace` in arrival order
+fn arrivals(trace: &Trace) -> Vec<(u16, u64)> {
+    let mut arrivals: Vec<_> = trace
+        .iter()
+        .enumerate()
+        .filter_map(|(seq, at)| at.map(|at| (seq as u16, at)))
+        .collect();
+    arrivals.sort_by_key(|&(seq, at)| (at, seq));
+    arrivals
+}
+
+/// Replay a trace; returns the final stats and the added delay after
+/// every tick once playout has started
+fn replay(rt: &Runtime, trace: &Trace) -> (PlayoutStats, Vec<f32>) {
+    let arrivals = arrivals(trace);
+    let start = Instant::now();
+    let mut engine = PlayoutEngine::new(PlayoutConfig::default());
+    let mut delays = Vec::with_capacity(trace.len());
+    let mut next = 0;
+
+    rt.block_on(async {
+        for tick in 0.. {
+            let now = tick * FRAME_MS;
+            while next < arrivals.len() && arrivals[next].1 <= now {
+                let (seq, at) = arrivals[next];
+                let packet = MediaPacket {
+                    payload: Bytes::new(),
+                    payload_type: 0,
+                    timestamp: seq as u32 * SAMPLES_PER_FRAME as u32,
+                    sequence_number: seq,
+                    ssrc: 0xdead_beef,
+                    received_at: start + Duration::from_millis(at),
+                };
+                let frame = AudioFrame::new(speech_frame(seq), 8000, 1, packet.timestamp);
+                engine.insert(packet, frame).await.expect("insert");
+                next += 1;
+            }
+            if let Some(frame) = engine.get_audio().expect("get_audio") {
+                black_box(&frame);
+                if engine.stats().samples_out > 0 {
+                    delays.push(engine.buffer_level_ms());
+                }
+            }
+            // Stop once the trace has been played out rather than
+            // concealing past its end.
+            if next == arrivals.len() && engine.jitter_buffer().buffered_frames() == 0 {
+                break;
+            }
+        }
+    });
+    (engine.stats(), delays)
+}
+
+fn report(rt: &Runtime, traces: &[(String, Trace)]) {
+    println!();
+    println!(
+        "{:<14} {:>8} {:>10} {:>10} {:>10} {:>10} {:>8} {:>8} {:>8}",
+        "trace",
+        "lost_%",
+        "delay_avg",
+        "delay_p95",
+        "target_ms",
+        "conceal_%",
+        "accel",
+        "pre_exp",
+        "expand"
+    );
+    for (name, trace) in traces {
+        let (stats, mut delays) = replay(rt, trace);
+        delays.sort_by(f32::total_cmp);
+        let mean = delays.iter().sum::<f32>() / delays.len().max(1) as f32;
+        let p95 = delays
+            .get(delays.len() * 95 / 100)
+            .copied()
+            .unwrap_or_default();
+        let lost = trace.iter().filter(|at| at.is_none()).count();
+        println!(
+            "{:<14} {:>8.2} {:>10.1} {:>10.1} {:>10} {:>10.2} {:>8} {:>8} {:>8}",
+            name,
+            100.0 * lost as f64 / trace.len() as f64,
+            mean,
+            p95,
+            stats.target_delay_ms,
+            100.0 * stats.concealment_ratio(),
+            stats.accelerate_count,
+            stats.preemptive_expand_count,
+            stats.expand_count
+        );
+    }
+    println!();
+}
+
+fn bench_playout_traces(c: &mut Criterion) {
+    let rt = Builder::new_current_thread().enable_all().build().unwrap();
+    let traces = traces();
+    report(&rt, &traces);
+
+    let mut group = c.benchmark_group("playout_trace_replay");
+    for (name, trace) in &traces {
+        group.throughput(Throughput::Elements(trace.len() as u64));
+        group.bench_with_input(BenchmarkId::from_parameter(name), trace, |b, trace| {
+            b.iter(|| black_box(replay(&rt, trace)));
+        });
+    }
+    group.finish();
+}
+
+criterion_group!(benches, bench_playout_traces);
+criterion_main!(benches);
@@ -0,0 +1,216 @@
+//! Sample-rate conversion micro-benchmark.
+//!
+//! Compares the interpolating `Resampler` (linear/cubic plus a biquad
+//! anti-alias cascade) against the windowed-sinc `PolyphaseResampler` on one
+//! 20 ms frame for the telephony ratios (8k ↔ 16k ↔ 48k). Criterion reports
+//! output samples/sec via `Throughput::Elements`.
+//!
+//! Before the timed groups, a one-shot table is printed with, per ratio and
+//! implementation:
+//!
+//! - cycles per output sample (TSC on x86_64, nanoseconds elsewhere), and
+//! - stopband attenuation: for down-sampling the worst alias left by tones
+//!   above the output Nyquist; for up-sampling the worst spectral image of a
+//!   1 kHz tone relative to the tone itself.
+
+use criterion::{black_box, criterion_group, BenchmarkId, Criterion, Throughput};
+use rvoip_media_core::processing::format::{PolyphaseResampler, Resampler};
+
+const RATIOS: [(u32, u32); 6] = [
+    (8_000, 16_000),
+    (16_000, 8_000),
+    (8_000, 48_000),
+    (48_000, 8_000),
+    (16_000, 48_000),
+    (48_000, 16_000),
+];
+const QUALITY: u8 = 5;
+
+trait Resample {
+    fn run(&mut self, input: &[i16]) -> Vec<i16>;
+}
+
+impl Resample for Resampler {
+    fn run(&mut self, input: &[i16]) -> Vec<i16> {
+        self.resample(input).unwrap()
+    }
+}
+
+impl Resample for PolyphaseResampler {
+    fn run(&mut self, input: &[i16]) -> Vec<i16> {
+        self.resample(input).unwrap()
+    }
+}
+
+fn legacy(from: u32, to: u32) -> Box<dyn Resample> {
+    Box::new(Resampler::new(from, to, QUALITY).unwrap())
+}
+
+fn polyphase(from: u32, to: u32) -> Box<dyn Resample> {
+    Box::new(PolyphaseResampler::new(from, to, QUALITY).unwrap())
+}
+
+const IMPLS: [(&str, fn(u32, u32) -> Box<dyn Resample>); 2] =
+    [("legacy", legacy), ("polyphase", polyphase)];
+
+fn sine(freq: f64, rate: u32, len: usize, amp: f64) -> Vec<i16> {
+    (0..len)
+        .map(|i| (amp * (2.0 * std::f64::consts::PI * freq * i as f64 / rate as f64).sin()) as i16)
+        .collect()
+}
+
+fn frame_len(rate: u32) -> usize {
+    (rate / 50) as usize
+}
+
+/// Goertzel magnitude normalised to sine amplitude.
+fn tone_amplitude(samples: &[i16], rate: u32, freq: f64) -> f64 {
+    let n = samples.len() as f64;
+    let coeff = 2.0 * (2.0 * std::f64::consts::PI * freq / rate as f64).cos();
+    let (mut s1, mut s2) = (0.0_f64, 0.0_f64);
+    for &x in samples {
+        let s = x as f64 + coeff * s1 - s2;
+        s2 = s1;
+        s1 = s;
+    }
+    2.0 * (s1 * s1 + s2 * s2 - coeff * s1 * s2).max(0.0).sqrt() / n
+}
+
+fn db(ratio: f64) -> f64 {
+    -20.0 * ratio.max(1e-6).log10()
+}
+
+/// Worst-case stopband attenuation in dB (see module docs).
+fn stopband_attenuation(make: fn(u32, u32) -> Box<dyn Resample>, from: u32, to: u32) -> f64 {
+    const AMP: f64 = 16_000.0;
+    // 250 ms of signal, steady-state half analysed.
+    let len = from as usize / 4;
+    let mut worst = f64::INFINITY;
+
+    if to < from {
+        let nyquist = to as f64 / 2.0;
+        let mut freq = nyquist + 250.0;
+        while freq < from as f64 / 2.0 {
+            let out = make(from, to).run(&sine(freq, from, len, AMP));
+            let steady = &out[out.len() / 2..];
+            let rms = (steady.iter().map(|&s| (s as f64).powi(2)).sum::<f64>()
+                / steady.len() as f64)
+                .sqrt();
+            worst = worst.min(db(rms * std::f64::consts::SQRT_2 / AMP));
+            freq += 250.0;
+        }
+    } else {
+        let out = make(from, to).run(&sine(1_000.0, from, len, AMP));
+        let steady = &out[out.len() / 2..];
+        let tone = tone_amplitude(steady, to, 1_000.0);
+        let mut centre = from as f64;
+        while centre - 1_000.0 < to as f64 / 2.0 {
+            for image in [centre - 1_000.0, centre + 1_000.0] {
+                if image < to as f64 / 2.0 {
+                    worst = worst.min(db(tone_amplitude(steady, to, image) / tone));
+                }
+            }
+            centre += from as f64;
+        }
+    }
+    worst
+}
+
+#[cfg(target_arch = "x86_64")]
+fn ticks() -> u64 {
+    // SAFETY: RDTSC is available on every x86_64 CPU.
+    unsafe { std::arch::x86_64::_rdtsc() }
+}
+
+#[cfg(not(target_arch = "x86_64"))]
+fn ticks() -> u64 {
+    static START: std::sync::OnceLock<std::time::Instant> = std::sync::OnceLock::new();
+    START
+        .get_or_init(std::time::Instant::now)
+        .elapsed()
+        .as_nanos() as u64
+}
+
+fn ticks_per_output(make: fn(u32, u32) -> Box<dyn Resample>, from: u32, to: u32) -> f64 {
+    const FRAMES: usize = 2_000;
+    let mut rs = make(from, to);
+    let input = sine(1_000.0, from, frame_len(from), 10_000.0);
+    for _ in 0..50 {
+        black_box(rs.run(&input));
+    }
+    let mut produced = 0usize;
+    let start = ticks();
+    for _ in 0..FRAMES {
+        produced += black_box(rs.run(black_box(&input))).len();
+    }
+    (ticks() - start) as f64 / produced as f64
+}
+
+fn print_report() {
+    let unit = if cfg!(target_arch = "x86_64") {
+        "cycles/out"
+    } else {
+        "ns/out"
+    };
+    eprintln!(
+        "\n{:>14}  {:>10}  {:>12}  {:>14}",
+        "ratio", "impl", unit, "stopband (dB)"
+    );
+    for (from, to) in RATIOS {
+        for (name, make) in IMPLS {
+            eprintln!(
+                "{:>14}  {:>10}  {:>12.1}  {:>14.1}",
+                format!("{}k->{}k", from / 1000, to / 1000),
+                name,
+                ticks_per_output(make, from, to),
+                stopband_attenuation(make, from, to)
+            );
+        }
+    }
+    eprintln!();
+}
+
+fn bench_resample_frame(c: &mut Criterion) {
+    let mut group = c.benchmark_group("resample_20ms_frame");
+    for (from, to) in RATIOS {
+        let input = sine(1_000.0, from, frame_len(from), 10_000.0);
+        group.throughput(Throughput::Elements(frame_len(to) as u64));
+        let ratio = format!("{}k_to_{}k", from / 1000, to / 1000);
+        for (name, make) in IMPLS {
+            let mut rs = make(from, to);
+            group.bench_with_input(BenchmarkId::new(name, &ratio), &input, |b, input| {
+                b.iter(|| rs.run(black_box(input)))
+            });
+        }
+    }
+    group.finish();
+}
+
+fn bench_resample_into(c: &mut Criterion) {
+    let mut group = c.benchmark_group("resample_into_20ms_frame");
+    for (from, to) in RATIOS {
+        let input = sine(1_000.0, from, frame_len(from), 10_000.0);
+        let mut rs = PolyphaseResampler::new(from, to, QUALITY).unwrap();
+        let mut output = Vec::with_capacity(frame_len(to) + 1);
+        group.throughput(Throughput::Elements(frame_len(to) as u64));
+        group.bench_with_input(
+            BenchmarkId::from_parameter(format!("{}k_to_{}k", from / 1000, to / 1000)),
+            &input,
+            |b, input| {
+                b.iter(|| {
+                    output.clear();
+                    rs.resample_into(black_box(input), &mut output);
+                })
+            },
+        );
+    }
+    group.finish();
+}
+
+criterion_group!(benches, bench_resample_frame, bench_resample_into);
+
+fn main() {
+    print_report();
+    benches();
+    Criterion::default().configure_from_args().final_summary();
+}
@@ -53,6 +53,7 @@ async fn create_conference_controller(
         output_channels: 1,            // Mono
         output_samples_per_frame: 160, // 20ms at 8kHz
         enable_voice_activity_mixing: true,
+        max_active_speakers: 3,
         enable_automatic_gain_control: true,
         enable_noise_reduction: false, // Disabled for demo performance
         enable_simd_optimization: true,
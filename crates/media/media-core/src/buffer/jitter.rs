@@ -3,6 +3,7 @@
 //! This module implements an adaptive jitter buffer for VoIP that handles
 //! packet reordering, network jitter compensation, and smooth audio playback.
 
+use rvoip_rtp_core::buffer::{SeqInsert, SeqRing};
 use std::collections::BTreeMap;
 use std::sync::atomic::{AtomicU64, AtomicUsize, Ordering};
 use std::time::Instant;
@@ -11,6 +12,8 @@ use tracing::{debug, trace, warn};
 use crate::error::Result;
 use crate::types::{AudioFrame, MediaPacket};
 
+pub use rvoip_rtp_core::buffer::JitterBufferStorage;
+
 /// Jitter buffer configuration
 #[derive(Debug, Clone)]
 pub struct JitterBufferConfig {
@@ -28,6 +31,9 @@ pub struct JitterBufferConfig {
     pub adaptation_strategy: AdaptationStrategy,
     /// Enable statistics collection
     pub enable_statistics: bool,
+    /// Frame storage. The ring holds `max_depth` frames (rounded up to a
+    /// power of two) allocated up front.
+    pub storage: JitterBufferStorage,
 }
 
 impl Default for JitterBufferConfig {
@@ -40,6 +46,7 @@ impl Default for JitterBufferConfig {
             max_late_packet_age_ms: 100,
             adaptation_strategy: AdaptationStrategy::Conservative,
             enable_statistics: true,
+            storage: JitterBufferStorage::default(),
         }
     }
 }
@@ -55,6 +62,21 @@ pub enum AdaptationStrategy {
     Aggressive,
 }
 
+/// Result of [`JitterBuffer::pop_next`]
+#[derive(Debug)]
+pub enum PlayoutSlot {
+    /// The frame at the playout cursor
+    Frame(AudioFrame),
+    /// The frame at the playout cursor is missing while later frames are
+    /// buffered; the cursor has moved past it
+    Missing {
+        /// Sequence number of the missing frame
+        sequence: u16,
+    },
+    /// Nothing is buffered; the cursor stays on the frame still expected
+    Empty,
+}
+
 /// Buffered frame with metadata. The arrival-time / RTP-timestamp /
 /// sequence-number fields are captured on insert for the late-arrival
 /// statistics path that's wired in but not yet read on every pull.
@@ -105,7 +127,7 @@ pub struct JitterBufferStats {
 pub struct JitterBuffer {
     /// Configuration
     config: JitterBufferConfig,
-    /// Tightly-coupled per-frame state: the BTreeMap, next-expected
+    /// Tightly-coupled per-frame state: the frame store, next-expected
     /// sequence cursor, RFC 3550 jitter accumulator, and last-playout
     /// timestamp. Lives behind one `parking_lot::Mutex` because every
     /// mutation hits two or more of these fields together.
@@ -131,7 +153,7 @@ pub struct JitterBuffer {
 /// mutex.
 struct JitterBufferInner {
     /// Buffered frames (indexed by sequence number)
-    buffer: BTreeMap<u16, BufferedFrame>,
+    buffer: FrameStore,
     /// Next expected sequence number
     next_sequence: Option<u16>,
     /// Jitter calculation state
@@ -140,6 +162,79 @@ struct JitterBufferInner {
     last_playout_time: Option<Instant>,
 }
 
+/// Frame storage selected by [`JitterBufferConfig::storage`]
+enum FrameStore {
+    Ring(SeqRing<BufferedFrame>),
+    Tree(BTreeMap<u16, BufferedFrame>),
+}
+
+impl FrameStore {
+    fn new(config: &JitterBufferConfig) -> Self {
+        match config.storage {
+            JitterBufferStorage::Ring => Self::Ring(SeqRing::with_capacity(config.max_depth)),
+            JitterBufferStorage::BTreeMap => Self::Tree(BTreeMap::new()),
+        }
+    }
+
+    fn len(&self) -> usize {
+        match self {
+            Self::Ring(ring) => ring.len(),
+            Self::Tree(tree) => tree.len(),
+        }
+    }
+
+    fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    fn first_seq(&self) -> Option<u16> {
+        match self {
+            Self::Ring(ring) => ring.first_seq(),
+            Self::Tree(tree) => tree.keys().next().copied(),
+        }
+    }
+
+    /// Store a frame. Returns the number of older frames the ring had to
+    /// evict to fit it, or `None` if it is older than the ring can hold.
+    /// A duplicate leaves the buffered frame in place.
+    fn insert(&mut self, seq: u16, frame: BufferedFrame) -> Option<usize> {
+        match self {
+            Self::Ring(ring) => match ring.insert(seq, frame) {
+                SeqInsert::Inserted { evicted } => Some(evicted),
+                SeqInsert::Duplicate(_) => Some(0),
+                SeqInsert::TooOld(_) => None,
+            },
+            Self::Tree(tree) => {
+                tree.insert(seq, frame);
+                Some(0)
+            }
+        }
+    }
+
+    fn remove(&mut self, seq: u16) -> Option<BufferedFrame> {
+        match self {
+            Self::Ring(ring) => ring.remove(seq),
+            Self::Tree(tree) => tree.remove(&seq),
+        }
+    }
+
+    /// Oldest buffered sequence number after `seq`
+    fn next_after(&self, seq: u16) -> Option<u16> {
+        let from = seq.wrapping_add(1);
+        match self {
+            Self::Ring(ring) => ring.next_at_or_after(from),
+            Self::Tree(tree) => tree.range(from..).next().map(|(&s, _)| s),
+        }
+    }
+
+    fn clear(&mut self) {
+        match self {
+            Self::Ring(ring) => ring.clear(),
+            Self::Tree(tree) => tree.clear(),
+        }
+    }
+}
+
 /// Jitter calculation state
 #[derive(Debug, Default)]
 struct JitterState {
@@ -162,7 +257,7 @@ impl JitterBuffer {
         Self {
             target_depth: AtomicUsize::new(config.initial_depth),
             state: parking_lot::Mutex::new(JitterBufferInner {
-                buffer: BTreeMap::new(),
+                buffer: FrameStore::new(&config),
                 next_sequence: None,
                 jitter_state: JitterState::default(),
                 last_playout_time: None,
@@ -191,9 +286,15 @@ impl JitterBuffer {
         // single mutex section so we can update atomic counters and
         // log outside the lock.
         enum Outcome {
-            Inserted { depth: usize },
+            Inserted {
+                depth: usize,
+            },
             DroppedLate,
-            InsertedAfterOverflow { depth: usize, evicted_seq: u16 },
+            InsertedAfterOverflow {
+                depth: usize,
+                evicted_seq: u16,
+                count: usize,
+            },
         }
 
         let max_late_ms = self.config.max_late_packet_age_ms as u128;
@@ -241,18 +342,35 @@ impl JitterBuffer {
                     sequence_number: seq,
                 };
 
-                let mut evicted = None;
+                let mut evicted_seq = None;
+                let mut count = 0;
                 if state.buffer.len() >= max_depth {
-                    if let Some((&oldest, _)) = state.buffer.iter().next() {
-                        state.buffer.remove(&oldest);
-                        evicted = Some(oldest);
+                    evicted_seq = state.buffer.first_seq();
+                    if let Some(oldest) = evicted_seq {
+                        state.buffer.remove(oldest);
+                        count = 1;
                     }
                 }
-                state.buffer.insert(seq, buffered_frame);
-                let depth = state.buffer.len();
-                match evicted {
-                    Some(evicted_seq) => Outcome::InsertedAfterOverflow { depth, evicted_seq },
-                    None => Outcome::Inserted { depth },
+                let oldest = state.buffer.first_seq();
+                match state.buffer.insert(seq, buffered_frame) {
+                    None => Outcome::DroppedLate,
+                    Some(window_evicted) => {
+                        // The ring also evicts frames that fall out of its
+                        // sequence window ahead of a long gap.
+                        if window_evicted > 0 {
+                            evicted_seq = evicted_seq.or(oldest);
+                            count += window_evicted;
+                        }
+                        let depth = state.buffer.len();
+                        match evicted_seq {
+                            Some(evicted_seq) => Outcome::InsertedAfterOverflow {
+                                depth,
+                                evicted_seq,
+                                count,
+                            },
+                            None => Outcome::Inserted { depth },
+                        }
+                    }
                 }
             }
         };
@@ -271,9 +389,14 @@ impl JitterBuffer {
                     depth
                 );
             }
-            Outcome::InsertedAfterOverflow { depth, evicted_seq } => {
+            Outcome::InsertedAfterOverflow {
+                depth,
+                evicted_seq,
+                count,
+            } => {
                 self.frames_received.fetch_add(1, Ordering::Relaxed);
-                self.frames_dropped_overflow.fetch_add(1, Ordering::Relaxed);
+                self.frames_dropped_overflow
+                    .fetch_add(count as u64, Ordering::Relaxed);
                 warn!("Buffer overflow, dropped frame: seq={}", evicted_seq);
                 trace!(
                     "Added frame to jitter buffer: seq={}, buffer_depth={}",
@@ -309,7 +432,7 @@ impl JitterBuffer {
             // Lazy init: first call adopts the oldest buffered seq as
             // the playout cursor.
             if state.next_sequence.is_none() {
-                if let Some((&first_seq, _)) = state.buffer.iter().next() {
+                if let Some(first_seq) = state.buffer.first_seq() {
                     state.next_sequence = Some(first_seq);
                 } else {
                     return Ok(None); // Buffer empty
@@ -320,7 +443,7 @@ impl JitterBuffer {
             // Readiness gate: target_depth frames must be buffered.
             if state.buffer.len() < target_depth {
                 Pulled::NotReady
-            } else if let Some(buffered_frame) = state.buffer.remove(&target_seq) {
+            } else if let Some(buffered_frame) = state.buffer.remove(target_seq) {
                 state.next_sequence = Some(target_seq.wrapping_add(1));
                 state.last_playout_time = Some(Instant::now());
                 Pulled::Frame(buffered_frame.frame)
@@ -328,11 +451,9 @@ impl JitterBuffer {
                 // Gap: try the next available frame, or report underrun.
                 let next_available = state
                     .buffer
-                    .range(target_seq.wrapping_add(1)..)
-                    .next()
-                    .map(|(&s, f)| (s, f.clone()));
+                    .next_after(target_seq)
+                    .and_then(|s| state.buffer.remove(s).map(|f| (s, f)));
                 if let Some((next_seq, buffered_frame)) = next_available {
-                    state.buffer.remove(&next_seq);
                     state.next_sequence = Some(target_seq.wrapping_add(1));
                     state.last_playout_time = Some(Instant::now());
                     warn!(
@@ -368,6 +489,45 @@ impl JitterBuffer {
         Ok(frame)
     }
 
+    /// Take the frame at the playout cursor, bypassing the readiness gate
+    /// and depth adaptation.
+    ///
+    /// For callers that manage playout delay themselves (see
+    /// [`super::playout::PlayoutEngine`]): a gap is reported as
+    /// [`PlayoutSlot::Missing`] so it can be concealed instead of being
+    /// papered over with the next frame.
+    pub fn pop_next(&self) -> PlayoutSlot {
+        let slot = {
+            let mut state = self.state.lock();
+            let Some(cursor) = state.next_sequence.or_else(|| state.buffer.first_seq()) else {
+                return PlayoutSlot::Empty;
+            };
+            if let Some(buffered_frame) = state.buffer.remove(cursor) {
+                state.next_sequence = Some(cursor.wrapping_add(1));
+                PlayoutSlot::Frame(buffered_frame.frame)
+            } else if state.buffer.is_empty() {
+                state.next_sequence = Some(cursor);
+                PlayoutSlot::Empty
+            } else {
+                state.next_sequence = Some(cursor.wrapping_add(1));
+                PlayoutSlot::Missing { sequence: cursor }
+            }
+        };
+
+        match slot {
+            PlayoutSlot::Frame(_) => self.frames_played.fetch_add(1, Ordering::Relaxed),
+            PlayoutSlot::Empty => self.underrun_count.fetch_add(1, Ordering::Relaxed),
+            PlayoutSlot::Missing { .. } => 0,
+        };
+        slot
+    }
+
+    /// Number of buffered frames. Synchronous twin of
+    /// [`Self::get_current_depth`].
+    pub fn buffered_frames(&self) -> usize {
+        self.state.lock().buffer.len()
+    }
+
     /// Adapt buffer depth based on network conditions. Synchronous —
     /// no `.await`. Takes a brief read on the inner mutex for the
     /// current jitter, then uses a CAS-style store on the
@@ -543,4 +703,73 @@ mod tests {
         assert!(buffer.is_empty().await);
         assert_eq!(buffer.get_target_depth().await, 4); // Reset to initial
     }
+
+    #[tokio::test]
+    async fn test_storage_backends_agree() {
+        // Reordered arrivals with 1004 lost.
+        let arrivals = [1000u16, 1002, 1001, 1003, 1006, 1005, 1007];
+
+        let mut played = Vec::new();
+        for storage in [JitterBufferStorage::Ring, JitterBufferStorage::BTreeMap] {
+            let buffer = JitterBuffer::new(JitterBufferConfig {
+                initial_depth: 1,
+                min_depth: 1,
+                max_depth: 10,
+                storage,
+                ..Default::default()
+            });
+            for seq in arrivals {
+                let packet = MediaPacket {
+                    payload: vec![1, 2, 3].into(),
+                    payload_type: 0,
+                    sequence_number: seq,
+                    // Constant so the jitter estimate (and target depth)
+                    // stays put while the test drains the buffer.
+                    timestamp: 0,
+                    ssrc: 12345,
+                    received_at: std::time::Instant::now(),
+                };
+                let frame = AudioFrame::new(vec![0; 160], 8000, 1, seq as u32);
+                buffer.add_frame(packet, frame).await.unwrap();
+            }
+            let mut order = Vec::new();
+            while let Some(frame) = buffer.get_next_frame().await.unwrap() {
+                order.push(frame.timestamp);
+            }
+            played.push(order);
+        }
+
+        assert_eq!(played[0], vec![1000, 1001, 1002, 1003, 1005, 1006, 1007]);
+        assert_eq!(played[0], played[1]);
+    }
+
+    #[tokio::test]
+    async fn test_pop_next_reports_gaps() {
+        let buffer = JitterBuffer::new(JitterBufferConfig::default());
+        assert!(matches!(buffer.pop_next(), PlayoutSlot::Empty));
+
+        for seq in [10u16, 12] {
+            let packet = MediaPacket {
+                payload: vec![1, 2, 3].into(),
+                payload_type: 0,
+                sequence_number: seq,
+                timestamp: seq as u32 * 160,
+                ssrc: 12345,
+                received_at: std::time::Instant::now(),
+            };
+            let frame = AudioFrame::new(vec![0; 160], 8000, 1, seq as u32);
+            buffer.add_frame(packet, frame).await.unwrap();
+        }
+
+        // No readiness gate: the first frame plays with two buffered.
+        assert!(matches!(buffer.pop_next(), PlayoutSlot::Frame(f) if f.timestamp == 10));
+        assert!(matches!(
+            buffer.pop_next(),
+            PlayoutSlot::Missing { sequence: 11 }
+        ));
+        assert!(matches!(buffer.pop_next(), PlayoutSlot::Frame(f) if f.timestamp == 12));
+        // An underrun keeps waiting for 13.
+        assert!(matches!(buffer.pop_next(), PlayoutSlot::Empty));
+        assert_eq!(buffer.buffered_frames(), 0);
+    }
 }
@@ -6,10 +6,17 @@
 pub mod adaptive;
 pub mod frame_buffer;
 pub mod jitter;
+pub mod playout;
 pub mod ring_buffer;
 
 // Re-export main types
 pub use adaptive::{AdaptiveBuffer, AdaptiveConfig};
 pub use frame_buffer::{FrameBuffer, FrameBufferConfig};
-pub use jitter::{JitterBuffer, JitterBufferConfig, JitterBufferStats};
+pub use jitter::{
+    JitterBuffer, JitterBufferConfig, JitterBufferStats, JitterBufferStorage, PlayoutSlot,
+};
+pub use playout::{
+    DelayHistogram, DelayHistogramConfig, LossConcealment, PlayoutConfig, PlayoutEngine,
+    PlayoutOperation, PlayoutStats,
+};
 pub use ring_buffer::{RingBuffer, RingBufferError};
@@ -0,0 +1,197 @@
+//! Relative arrival-delay histogram driving the playout target delay
+//!
+//! Each packet's transit time (arrival minus RTP send time) is compared
+//! with the fastest transit seen over a sliding window; the excess is the
+//! delay a buffer would have needed to play that packet on time. Those
+//! delays feed an exponentially forgetting histogram whose upper quantile
+//! is the target delay, so the target follows the recent jitter
+//! distribution rather than its worst-ever peak.
+
+use std::collections::VecDeque;
+use std::time::{Duration, Instant};
+
+/// Delay histogram configuration
+#[derive(Debug, Clone)]
+pub struct DelayHistogramConfig {
+    /// Width of one histogram bucket (ms)
+    pub bucket_ms: u32,
+    /// Largest delay the histogram represents (ms); longer delays land in
+    /// the last bucket
+    pub max_delay_ms: u32,
+    /// Fraction of packets that should arrive in time for playout
+    pub quantile: f32,
+    /// Per-packet weight kept by existing observations; `1 - forget_factor`
+    /// goes to the newest one
+    pub forget_factor: f32,
+    /// Window over which the fastest transit time is tracked
+    pub window: Duration,
+}
+
+impl Default for DelayHistogramConfig {
+    fn default() -> Self {
+        Self {
+            bucket_ms: 10,
+            max_delay_ms: 1000,
+            quantile: 0.95,
+            forget_factor: 0.983,
+            window: Duration::from_secs(2),
+        }
+    }
+}
+
+/// Exponentially forgetting histogram of relative packet delay
+#[derive(Debug)]
+pub struct DelayHistogram {
+    config: DelayHistogramConfig,
+    /// Probability mass per bucket; sums to 1 once the first packet is in
+    buckets: Vec<f32>,
+    /// Transit times in arrival order with strictly increasing transit:
+    /// the front is the minimum over `config.window`
+    min_transit: VecDeque<(Instant, f64)>,
+    /// Arrival instant and RTP timestamp all transits are measured against
+    origin: Option<(Instant, u32)>,
+    target_ms: u32,
+}
+
+impl DelayHistogram {
+    /// Create an empty histogram
+    pub fn new(config: DelayHistogramConfig) -> Self {
+        let bucket_count = (config.max_delay_ms / config.bucket_ms.max(1)).max(1) as usize;
+        let mut buckets = vec![0.0; bucket_count];
+        buckets[0] = 1.0;
+        Self {
+            target_ms: config.bucket_ms,
+            min_transit: VecDeque::with_capacity(64),
+            origin: None,
+            buckets,
+            config,
+        }
+    }
+
+    /// Record a packet sent at RTP `timestamp` (clock `sample_rate`) that
+    /// arrived at `arrival`; returns its relative delay in ms.
+    pub fn update(&mut self, arrival: Instant, timestamp: u32, sample_rate: u32) -> u32 {
+        let (origin_arrival, origin_ts) = *self.origin.get_or_insert((arrival, timestamp));
+        let sent_ms =
+            timestamp.wrapping_sub(origin_ts) as i32 as f64 * 1000.0 / sample_rate.max(1) as f64;
+        let arrived_ms = arrival
+            .checked_duration_since(origin_arrival)
+            .map_or(0.0, |d| d.as_secs_f64() * 1000.0);
+        let transit = arrived_ms - sent_ms;
+
+        while self.min_transit.back().is_some_and(|&(_, t)| t >= transit) {
+            self.min_transit.pop_back();
+        }
+        self.min_transit.push_back((arrival, transit));
+        while self
+            .min_transit
+            .front()
+            .is_some_and(|&(at, _)| arrival.saturating_duration_since(at) > self.config.window)
+        {
+            self.min_transit.pop_front();
+        }
+        let fastest = self.min_transit.front().map_or(transit, |&(_, t)| t);
+        let delay_ms = (transit - fastest).max(0.0) as u32;
+
+        let forget = self.config.forget_factor;
+        for p in &mut self.buckets {
+            *p *= forget;
+        }
+        let last = self.buckets.len() - 1;
+        let bucket = ((delay_ms / self.config.bucket_ms.max(1)) as usize).min(last);
+        self.buckets[bucket] += 1.0 - forget;
+
+        self.target_ms = self.quantile_ms();
+        delay_ms
+    }
+
+    /// Delay (ms) within which [`DelayHistogramConfig::quantile`] of
+    /// recent packets arrived, rounded up to a bucket edge
+    pub fn target_ms(&self) -> u32 {
+        self.target_ms
+    }
+
+    /// Forget all history
+    pub fn reset(&mut self) {
+        self.buckets.fill(0.0);
+        self.buckets[0] = 1.0;
+        self.min_transit.clear();
+        self.origin = None;
+        self.target_ms = self.config.bucket_ms;
+    }
+
+    fn quantile_ms(&self) -> u32 {
+        let total: f32 = self.buckets.iter().sum();
+        let wanted = self.config.quantile * total;
+        let mut cumulative = 0.0;
+        for (i, p) in self.buckets.iter().enumerate() {
+            cumulative += p;
+            if cumulative >= wanted {
+                return (i as u32 + 1) * self.config.bucket_ms;
+            }
+        }
+        self.buckets.len() as u32 * self.config.bucket_ms
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn feed(hist: &mut DelayHistogram, start: Instant, packets: impl Iterator<Item = (u32, u64)>) {
+        for (seq, arrival_ms) in packets {
+            hist.update(start + Duration::from_millis(arrival_ms), seq * 160, 8000);
+        }
+    }
+
+    #[test]
+    fn test_steady_stream_targets_one_bucket() {
+        let mut hist = DelayHistogram::new(DelayHistogramConfig::default());
+        let start = Instant::now();
+        feed(
+            &mut hist,
+            start,
+            (0..200).map(|seq| (seq, seq as u64 * 20 + 35)),
+        );
+        assert_eq!(hist.target_ms(), 10);
+    }
+
+    #[test]
+    fn test_target_tracks_jitter_and_recovers() {
+        let mut hist = DelayHistogram::new(DelayHistogramConfig::default());
+        let start = Instant::now();
+        // Every fourth packet is 60 ms late.
+        feed(
+            &mut hist,
+            start,
+            (0..400).map(|seq| {
+                let late = if seq % 4 == 0 { 60 } else { 0 };
+                (seq, seq as u64 * 20 + late)
+            }),
+        );
+        assert_eq!(hist.target_ms(), 70);
+
+        // The network calms down; the late bucket decays below 5%.
+        feed(
+            &mut hist,
+            start,
+            (400..600).map(|seq| (seq, seq as u64 * 20)),
+        );
+        assert_eq!(hist.target_ms(), 10);
+    }
+
+    #[test]
+    fn test_min_transit_window_slides() {
+        let mut hist = DelayHistogram::new(DelayHistogramConfig::default());
+        let start = Instant::now();
+        hist.update(start, 0, 8000);
+        // Path delay steps up by 100 ms: initially all excess...
+        assert_eq!(
+            hist.update(start + Duration::from_millis(120), 160, 8000),
+            100
+        );
+        // ...until the fast packet leaves the 2 s window.
+        let late = start + Duration::from_millis(2200);
+        assert_eq!(hist.update(late, 2100 * 8, 8000), 0);
+    }
+}
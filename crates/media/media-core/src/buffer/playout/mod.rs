@@ -0,0 +1,682 @@
+//! Adaptive playout with time-stretching
+//!
+//! [`PlayoutEngine`] sits on top of [`JitterBuffer`] and hands out fixed
+//! size frames of decoded PCM on every playout tick, the way WebRTC's
+//! NetEQ does. Instead of holding or dropping whole frames to change the
+//! buffer depth, it:
+//!
+//! - sets a target delay from a histogram of relative packet arrival
+//!   delays ([`DelayHistogram`]), so latency follows current jitter;
+//! - **accelerates** (removes one pitch period, WSOLA-style) when the
+//!   buffer is above target, draining latency after a burst without an
+//!   audible skip;
+//! - **preemptively expands** (repeats one pitch period) when the buffer
+//!   runs below target, building delay before an underrun happens;
+//! - **expands** (conceals) lost or late frames, with the codec's own PLC
+//!   when one is registered ([`LossConcealment`]) and waveform
+//!   substitution otherwise, then **merges** back into real audio with a
+//!   cross-fade.
+//!
+//! Time-stretching needs a single pitch track, so it is applied to mono
+//! streams only; multi-channel streams play out with concealment but no
+//! stretching.
+
+mod delay;
+mod time_stretch;
+
+pub use delay::{DelayHistogram, DelayHistogramConfig};
+
+use std::collections::VecDeque;
+use tracing::{debug, trace};
+
+use super::jitter::{JitterBuffer, JitterBufferConfig, JitterBufferStorage, PlayoutSlot};
+use crate::error::Result;
+use crate::types::{AudioFrame, MediaPacket};
+use time_stretch::{pitch_range, Concealer};
+
+/// Minimum correlation between adjacent pitch periods for a stretch
+const STRETCH_CORRELATION: f32 = 0.85;
+/// Correlation accepted when the buffer is far above target and latency
+/// matters more than a slightly audible seam
+const FAST_ACCELERATE_CORRELATION: f32 = 0.5;
+/// Weight of the newest sample in the smoothed buffer level
+const LEVEL_SMOOTHING: f32 = 0.25;
+
+/// Playout engine configuration
+#[derive(Debug, Clone)]
+pub struct PlayoutConfig {
+    /// Duration of each frame handed out by [`PlayoutEngine::get_audio`] (ms)
+    pub frame_duration_ms: u32,
+    /// Frames the underlying jitter buffer holds before evicting the oldest
+    pub max_buffer_frames: usize,
+    /// Lower bound for the target delay (ms)
+    pub min_delay_ms: u32,
+    /// Upper bound for the target delay (ms)
+    pub max_delay_ms: u32,
+    /// Arrival-delay histogram settings
+    pub histogram: DelayHistogramConfig,
+    /// Frame storage of the underlying jitter buffer
+    pub storage: JitterBufferStorage,
+}
+
+impl Default for PlayoutConfig {
+    fn default() -> Self {
+        Self {
+            frame_duration_ms: 20,
+            max_buffer_frames: 50, // 1s at 20ms frames
+            min_delay_ms: 0,
+            max_delay_ms: 500,
+            histogram: DelayHistogramConfig::default(),
+            storage: JitterBufferStorage::default(),
+        }
+    }
+}
+
+/// Codec-native packet-loss concealment.
+///
+/// Implement this for decoders that can synthesise audio for a missing
+/// packet (e.g. Opus' `decode_missing`); the engine calls it once per
+/// lost or late frame, in playout order. Codecs without native PLC need
+/// nothing: the engine falls back to waveform substitution.
+pub trait LossConcealment: Send {
+    /// Fill `output` with audio for one missing frame and return the number
+    /// of samples written. Returning `Ok(0)` or an error falls back to the
+    /// engine's own concealment.
+    fn conceal(&mut self, output: &mut [i16]) -> Result<usize>;
+}
+
+/// What the engine did to produce audio
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+pub enum PlayoutOperation {
+    /// Played a frame unchanged
+    Normal,
+    /// Played a frame shortened by one pitch period
+    Accelerate,
+    /// Played a frame lengthened by one pitch period
+    PreemptiveExpand,
+    /// Concealed a lost or late frame
+    Expand,
+    /// Played the first frame after concealment, cross-faded into it
+    Merge,
+    /// Still buffering up to the target delay
+    #[default]
+    Silence,
+}
+
+/// Playout statistics
+#[derive(Debug, Clone, Default)]
+pub struct PlayoutStats {
+    /// Frames handed out, including initial buffering silence
+    pub frames_out: u64,
+    /// Frames handed out while buffering before playout started
+    pub silence_frames: u64,
+    /// Decoded frames played unchanged
+    pub normal_count: u64,
+    /// Decoded frames shortened by accelerate
+    pub accelerate_count: u64,
+    /// Decoded frames lengthened by preemptive expand
+    pub preemptive_expand_count: u64,
+    /// Frames of concealment generated
+    pub expand_count: u64,
+    /// Concealment periods merged back into real audio
+    pub merge_count: u64,
+    /// Frames concealed by the codec's own PLC
+    pub native_plc_count: u64,
+    /// Samples handed out since playout started
+    pub samples_out: u64,
+    /// Samples removed by accelerate
+    pub samples_removed: u64,
+    /// Samples inserted by preemptive expand
+    pub samples_inserted: u64,
+    /// Samples of concealment generated
+    pub samples_concealed: u64,
+    /// Current target delay (ms)
+    pub target_delay_ms: u32,
+    /// Current buffer level, decoded frames plus processed audio (ms)
+    pub buffer_level_ms: f32,
+}
+
+impl PlayoutStats {
+    /// Fraction of played samples that were concealment
+    pub fn concealment_ratio(&self) -> f64 {
+        if self.samples_out == 0 {
+            0.0
+        } else {
+            self.samples_concealed as f64 / self.samples_out as f64
+        }
+    }
+}
+
+/// Stream parameters learned from the first decoded frame
+#[derive(Debug, Clone, Copy)]
+struct StreamFormat {
+    sample_rate: u32,
+    channels: u8,
+    /// Interleaved samples per output frame
+    frame_len: usize,
+    /// Interleaved samples per decoded frame
+    packet_len: usize,
+    packet_ms: f32,
+    /// Interleaved samples per millisecond
+    samples_per_ms: f32,
+    min_lag: usize,
+    max_lag: usize,
+}
+
+impl StreamFormat {
+    fn new(frame: &AudioFrame, config: &PlayoutConfig) -> Self {
+        let channels = frame.channels.max(1);
+        let sample_rate = frame.sample_rate.max(1000);
+        let samples_per_ms = (sample_rate / 1000) as f32 * channels as f32;
+        let frame_len = (config.frame_duration_ms as f32 * samples_per_ms) as usize;
+        let packet_len = if frame.samples.is_empty() {
+            frame_len
+        } else {
+            frame.samples.len()
+        };
+        let (min_lag, max_lag) = pitch_range(sample_rate);
+        Self {
+            sample_rate,
+            channels,
+            frame_len,
+            packet_len,
+            packet_ms: packet_len as f32 / samples_per_ms,
+            samples_per_ms,
+            min_lag,
+            max_lag,
+        }
+    }
+}
+
+/// NetEQ-style playout engine over a [`JitterBuffer`].
+///
+/// Feed it every decoded frame with [`Self::insert`] and pull one frame
+/// per playout tick with [`Self::get_audio`]; the returned frames are
+/// always [`PlayoutConfig::frame_duration_ms`] long.
+pub struct PlayoutEngine {
+    config: PlayoutConfig,
+    jitter: JitterBuffer,
+    histogram: DelayHistogram,
+    format: Option<StreamFormat>,
+    /// Processed audio not yet handed out
+    sync: VecDeque<i16>,
+    /// Most recent processed audio, for pitch search at the start of a loss
+    history: VecDeque<i16>,
+    /// Reused output of the time-stretch and concealment operations
+    scratch: Vec<i16>,
+    concealer: Concealer,
+    native_plc: Option<Box<dyn LossConcealment>>,
+    /// Whether buffering has reached the target and playout has started
+    playing: bool,
+    /// Frames concealed on underrun without advancing the jitter buffer
+    /// cursor. If those frames later turn out to be missing, their playout
+    /// time has already been filled and they are skipped.
+    covered_slots: usize,
+    /// Smoothed buffer level (ms)
+    filtered_level_ms: f32,
+    next_timestamp: u32,
+    last_operation: PlayoutOperation,
+    stats: PlayoutStats,
+}
+
+impl PlayoutEngine {
+    /// Create a playout engine
+    pub fn new(config: PlayoutConfig) -> Self {
+        debug!("Creating PlayoutEngine with config: {:?}", config);
+        let jitter = JitterBuffer::new(JitterBufferConfig {
+            initial_depth: 1,
+            min_depth: 1,
+            max_depth: config.max_buffer_frames,
+            frame_duration_ms: config.frame_duration_ms,
+            storage: config.storage,
+            ..Default::default()
+        });
+        Self {
+            jitter,
+            histogram: DelayHistogram::new(config.histogram.clone()),
+            format: None,
+            sync: VecDeque::new(),
+            history: VecDeque::new(),
+            scratch: Vec::new(),
+            concealer: Concealer::new(0),
+            native_plc: None,
+            playing: false,
+            covered_slots: 0,
+            filtered_level_ms: 0.0,
+            next_timestamp: 0,
+            last_operation: PlayoutOperation::default(),
+            stats: PlayoutStats::default(),
+            config,
+        }
+    }
+
+    /// Use the codec's own packet-loss concealment for lost frames
+    pub fn with_loss_concealment(mut self, plc: Box<dyn LossConcealment>) -> Self {
+        self.native_plc = Some(plc);
+        self
+    }
+
+    /// Add a decoded frame. The packet's `received_at` and `timestamp`
+    /// feed the delay histogram; the RTP clock is assumed to run at the
+    /// decoded sample rate.
+    pub async fn insert(&mut self, packet: MediaPacket, frame: AudioFrame) -> Result<()> {
+        let format = match self.format {
+            Some(format) => format,
+            None => self.init_format(&frame),
+        };
+        let delay_ms =
+            self.histogram
+                .update(packet.received_at, packet.timestamp, format.sample_rate);
+        trace!(
+            "Playout insert: seq={}, relative_delay={}ms, target={}ms",
+            packet.sequence_number,
+            delay_ms,
+            self.histogram.target_ms()
+        );
+        self.jitter.add_frame(packet, frame).await
+    }
+
+    /// Produce the next frame of audio.
+    ///
+    /// Returns `None` until the first frame has been inserted, then
+    /// silence until the buffer reaches the target delay; after that
+    /// every call returns real, time-stretched or concealed audio.
+    pub fn get_audio(&mut self) -> Result<Option<AudioFrame>> {
+        let Some(format) = self.format else {
+            return Ok(None);
+        };
+        let target_ms = self.target_delay_ms() as f32;
+        self.stats.frames_out += 1;
+
+        if !self.playing {
+            let level = self.buffer_level_ms();
+            if level < target_ms {
+                self.last_operation = PlayoutOperation::Silence;
+                self.stats.silence_frames += 1;
+                return Ok(Some(self.emit(vec![0; format.frame_len], format)));
+            }
+            self.playing = true;
+            self.filtered_level_ms = level;
+        }
+
+        while self.sync.len() < format.frame_len {
+            let level = self.buffer_level_ms();
+            self.filtered_level_ms += (level - self.filtered_level_ms) * LEVEL_SMOOTHING;
+            self.last_operation = match self.jitter.pop_next() {
+                PlayoutSlot::Frame(frame) => {
+                    self.covered_slots = 0;
+                    self.play(frame.samples, target_ms, format)
+                }
+                PlayoutSlot::Missing { .. } if self.covered_slots > 0 => {
+                    self.covered_slots -= 1;
+                    continue;
+                }
+                PlayoutSlot::Missing { .. } => self.expand(format),
+                PlayoutSlot::Empty => {
+                    self.covered_slots += 1;
+                    self.expand(format)
+                }
+            };
+        }
+
+        let samples: Vec<i16> = self.sync.drain(..format.frame_len).collect();
+        self.stats.samples_out += samples.len() as u64;
+        Ok(Some(self.emit(samples, format)))
+    }
+
+    /// Current target delay (ms)
+    pub fn target_delay_ms(&self) -> u32 {
+        let floor = self
+            .format
+            .map_or(self.config.frame_duration_ms, |f| f.packet_ms.ceil() as u32)
+            .max(self.config.min_delay_ms);
+        self.histogram
+            .target_ms()
+            .max(floor)
+            .min(self.config.max_delay_ms.max(floor))
+    }
+
+    /// Audio buffered ahead of the playout point (ms): decoded frames in
+    /// the jitter buffer plus processed samples not yet handed out
+    pub fn buffer_level_ms(&self) -> f32 {
+        let Some(format) = self.format else {
+            return 0.0;
+        };
+        self.jitter.buffered_frames() as f32 * format.packet_ms
+            + self.sync.len() as f32 / format.samples_per_ms
+    }
+
+    /// Operation behind the most recent [`Self::get_audio`] call
+    pub fn last_operation(&self) -> PlayoutOperation {
+        self.last_operation
+    }
+
+    /// Snapshot of the playout statistics
+    pub fn stats(&self) -> PlayoutStats {
+        PlayoutStats {
+            target_delay_ms: self.target_delay_ms(),
+            buffer_level_ms: self.buffer_level_ms(),
+            ..self.stats.clone()
+        }
+    }
+
+    /// Underlying jitter buffer, for its reception statistics
+    pub fn jitter_buffer(&self) -> &JitterBuffer {
+        &self.jitter
+    }
+
+    /// Drop all buffered audio and delay history
+    pub async fn reset(&mut self) {
+        self.jitter.reset().await;
+        self.histogram.reset();
+        self.sync.clear();
+        self.history.clear();
+        self.concealer.end();
+        self.playing = false;
+        self.covered_slots = 0;
+        self.filtered_level_ms = 0.0;
+        self.last_operation = PlayoutOperation::default();
+    }
+
+    fn init_format(&mut self, frame: &AudioFrame) -> StreamFormat {
+        let format = StreamFormat::new(frame, &self.config);
+        let history_len = (2 * format.max_lag).max(format.packet_len);
+        self.sync = VecDeque::with_capacity(format.frame_len + 2 * format.packet_len);
+        self.history = VecDeque::with_capacity(history_len + format.packet_len * 2);
+        self.scratch = Vec::with_capacity(format.packet_len * 2);
+        self.concealer = Concealer::new(format.max_lag.max(format.packet_len));
+        self.next_timestamp = frame.timestamp;
+        self.format = Some(format);
+        format
+    }
+
+    /// Play a decoded frame, stretching it if the buffer is off target
+    fn play(
+        &mut self,
+        mut samples: Vec<i16>,
+        target_ms: f32,
+        format: StreamFormat,
+    ) -> PlayoutOperation {
+        if self.concealer.is_active() {
+            self.concealer.merge(&mut samples);
+            self.push(&samples, format);
+            self.stats.merge_count += 1;
+            return PlayoutOperation::Merge;
+        }
+
+        let low = target_ms;
+        let high = target_ms + format.packet_ms.max(target_ms / 4.0);
+        let level = self.filtered_level_ms;
+        if format.channels == 1 && (level > high || level < low) {
+            let accelerate = level > high;
+            let threshold = if accelerate && level > 2.0 * high {
+                FAST_ACCELERATE_CORRELATION
+            } else {
+                STRETCH_CORRELATION
+            };
+            let period = time_stretch::find_period(
+                &samples,
+                format.sample_rate,
+                format.min_lag,
+                format.max_lag,
+            )
+            .filter(|p| p.correlation >= threshold);
+            if let Some(period) = period {
+                let mut scratch = std::mem::take(&mut self.scratch);
+                scratch.clear();
+                let op = if accelerate {
+                    time_stretch::accelerate(&samples, period.lag, &mut scratch);
+                    self.stats.accelerate_count += 1;
+                    self.stats.samples_removed += period.lag as u64;
+                    PlayoutOperation::Accelerate
+                } else {
+                    time_stretch::preemptive_expand(&samples, period.lag, &mut scratch);
+                    self.stats.preemptive_expand_count += 1;
+                    self.stats.samples_inserted += period.lag as u64;
+                    PlayoutOperation::PreemptiveExpand
+                };
+                self.push(&scratch, format);
+                self.scratch = scratch;
+                return op;
+            }
+        }
+
+        self.push(&samples, format);
+        self.stats.normal_count += 1;
+        PlayoutOperation::Normal
+    }
+
+    /// Conceal one missing frame
+    fn expand(&mut self, format: StreamFormat) -> PlayoutOperation {
+        let n = format.packet_len;
+        let mut scratch = std::mem::take(&mut self.scratch);
+        scratch.clear();
+
+        let native = self.native_plc.as_mut().and_then(|plc| {
+            scratch.resize(n, 0);
+            match plc.conceal(&mut scratch) {
+                Ok(written) if written > 0 => Some(written.min(n)),
+                Ok(_) => None,
+                Err(e) => {
+                    debug!("Native PLC failed, using waveform substitution: {}", e);
+                    None
+                }
+            }
+        });
+
+        if let Some(written) = native {
+            scratch.truncate(written);
+            self.stats.native_plc_count += 1;
+        } else {
+            scratch.clear();
+            let history = self.history.make_contiguous();
+            let lag = if self.concealer.is_active() {
+                0
+            } else if format.channels == 1 {
+                time_stretch::find_period(
+                    history,
+                    format.sample_rate,
+                    format.min_lag,
+                    format.max_lag,
+                )
+                .map_or(format.max_lag, |p| p.lag)
+            } else {
+                format.packet_len
+            };
+            self.concealer.conceal(history, lag, n, &mut scratch);
+        }
+
+        self.stats.expand_count += 1;
+        self.stats.samples_concealed += scratch.len() as u64;
+        self.push(&scratch, format);
+        self.scratch = scratch;
+        PlayoutOperation::Expand
+    }
+
+    fn push(&mut self, samples: &[i16], format: StreamFormat) {
+        self.sync.extend(samples.iter().copied());
+        self.history.extend(samples.iter().copied());
+        let keep = (2 * format.max_lag).max(format.packet_len);
+        if self.history.len() > keep {
+            self.history.drain(..self.history.len() - keep);
+        }
+    }
+
+    fn emit(&mut self, samples: Vec<i16>, format: StreamFormat) -> AudioFrame {
+        let frame = AudioFrame::new(
+            samples,
+            format.sample_rate,
+            format.channels,
+            self.next_timestamp,
+        );
+        self.next_timestamp = self
+            .next_timestamp
+            .wrapping_add((format.frame_len / format.channels as usize) as u32);
+        frame
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::time::{Duration, Instant};
+
+    const FRAME: usize = 160; // 20 ms @ 8 kHz
+
+    /// Frame `seq` of a continuous 200 Hz tone
+    fn tone_frame(seq: u16) -> AudioFrame {
+        let samples = (0..FRAME)
+            .map(|i| {
+                let n = seq as usize * FRAME + i;
+                ((n as f32 * 2.0 * std::f32::consts::PI / 40.0).sin() * 8000.0) as i16
+            })
+            .collect();
+        AudioFrame::new(samples, 8000, 1, seq as u32 * FRAME as u32)
+    }
+
+    fn packet(seq: u16, received_at: Instant) -> MediaPacket {
+        MediaPacket {
+            payload: vec![0; 160].into(),
+            payload_type: 0,
+            sequence_number: seq,
+            timestamp: seq as u32 * FRAME as u32,
+            ssrc: 0x1234,
+            received_at,
+        }
+    }
+
+    /// Replay arrivals (`(seq, arrival_ms)` in arrival order) against a
+    /// 20 ms playout clock for `ticks` ticks
+    async fn replay(
+        engine: &mut PlayoutEngine,
+        arrivals: &[(u16, u64)],
+        ticks: u64,
+    ) -> Vec<PlayoutOperation> {
+        let start = Instant::now();
+        let mut next = 0;
+        let mut ops = Vec::new();
+        for tick in 0..ticks {
+            let now = tick * 20;
+            while next < arrivals.len() && arrivals[next].1 <= now {
+                let (seq, at) = arrivals[next];
+                engine
+                    .insert(
+                        packet(seq, start + Duration::from_millis(at)),
+                        tone_frame(seq),
+                    )
+                    .await
+                    .unwrap();
+                next += 1;
+            }
+            if let Some(frame) = engine.get_audio().unwrap() {
+                assert_eq!(frame.samples.len(), FRAME);
+                ops.push(engine.last_operation());
+            }
+        }
+        ops
+    }
+
+    #[tokio::test]
+    async fn test_steady_stream_plays_unchanged() {
+        let mut engine = PlayoutEngine::new(PlayoutConfig::default());
+        assert!(engine.get_audio().unwrap().is_none());
+
+        let arrivals: Vec<_> = (0..100u16).map(|s| (s, s as u64 * 20)).collect();
+        let ops = replay(&mut engine, &arrivals, 100).await;
+        assert!(ops.iter().all(|&op| op == PlayoutOperation::Normal));
+
+        let stats = engine.stats();
+        assert_eq!(stats.target_delay_ms, 20);
+        assert_eq!(stats.concealment_ratio(), 0.0);
+    }
+
+    #[tokio::test]
+    async fn test_losses_are_concealed_and_merged() {
+        let mut engine = PlayoutEngine::new(PlayoutConfig::default());
+        let arrivals: Vec<_> = (0..100u16)
+            .filter(|s| s % 10 != 5)
+            .map(|s| (s, s as u64 * 20))
+            .collect();
+        let ops = replay(&mut engine, &arrivals, 100).await;
+
+        let stats = engine.stats();
+        // Each lost frame is concealed; the last one (95) is discovered
+        // only when 96 arrives.
+        assert_eq!(stats.expand_count, 10);
+        assert_eq!(stats.merge_count, 10);
+        assert!((stats.concealment_ratio() - 0.1).abs() < 0.01);
+        let expand = ops
+            .iter()
+            .position(|&op| op == PlayoutOperation::Expand)
+            .unwrap();
+        assert_eq!(ops[expand + 1], PlayoutOperation::Merge);
+    }
+
+    #[tokio::test]
+    async fn test_burst_is_drained_by_accelerate() {
+        let mut engine = PlayoutEngine::new(PlayoutConfig::default());
+        // 200 ms stall, then the stalled frames arrive together.
+        let arrivals: Vec<_> = (0..150u16)
+            .map(|s| {
+                let at = s as u64 * 20;
+                (s, if (20..30).contains(&s) { 600 } else { at })
+            })
+            .collect();
+        replay(&mut engine, &arrivals, 150).await;
+
+        let stats = engine.stats();
+        assert!(stats.expand_count > 0);
+        assert!(stats.accelerate_count > 0);
+        // The stall's latency has been worked off again.
+        assert!(stats.buffer_level_ms <= 2.0 * stats.target_delay_ms as f32);
+        assert!(stats.samples_removed > 0);
+    }
+
+    #[tokio::test]
+    async fn test_rising_jitter_builds_delay() {
+        let mut engine = PlayoutEngine::new(PlayoutConfig::default());
+        // Every third frame is 50 ms late.
+        let arrivals = {
+            let mut a: Vec<_> = (0..200u16)
+                .map(|s| (s, s as u64 * 20 + if s % 3 == 0 && s > 20 { 50 } else { 0 }))
+                .collect();
+            a.sort_by_key(|&(_, at)| at);
+            a
+        };
+        replay(&mut engine, &arrivals, 200).await;
+
+        let stats = engine.stats();
+        assert!(stats.target_delay_ms >= 60);
+        assert!(stats.preemptive_expand_count > 0);
+        // Late frames are concealed only while the delay is being built:
+        // once it has, the remaining late frames all play.
+        assert!(stats.expand_count < 20);
+    }
+
+    struct CountingPlc(usize);
+
+    impl LossConcealment for CountingPlc {
+        fn conceal(&mut self, output: &mut [i16]) -> Result<usize> {
+            self.0 += 1;
+            output.fill(7);
+            Ok(output.len())
+        }
+    }
+
+    #[tokio::test]
+    async fn test_native_plc_is_preferred() {
+        let mut engine = PlayoutEngine::new(PlayoutConfig::default())
+            .with_loss_concealment(Box::new(CountingPlc(0)));
+        let arrivals: Vec<_> = (0..20u16)
+            .filter(|&s| s != 10)
+            .map(|s| (s, s as u64 * 20))
+            .collect();
+        replay(&mut engine, &arrivals, 20).await;
+
+        let stats = engine.stats();
+        assert_eq!(stats.native_plc_count, 1);
+        assert_eq!(stats.expand_count, 1);
+        // The codec handles its own transition back to decoded audio.
+        assert_eq!(stats.merge_count, 0);
+    }
+}
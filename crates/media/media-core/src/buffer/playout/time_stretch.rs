@@ -0,0 +1,323 @@
+//! WSOLA time-stretching and waveform-substitution concealment
+//!
+//! All operations work on mono PCM and are anchored at the *end* of the
+//! signal: the pitch period is the lag at which the last period best
+//! matches the one before it, and samples are removed or repeated there
+//! with a linear cross-fade. Anchoring at the tail keeps the seam away
+//! from audio that has already been played and keeps the first and last
+//! sample continuous with the neighbouring frames.
+
+/// Shortest pitch period searched (ms)
+const MIN_PITCH_MS: u32 = 2;
+/// Longest pitch period searched (ms)
+const MAX_PITCH_MS: u32 = 15;
+/// Below this mean-square level a segment is treated as silence, which can
+/// be stretched at any lag without audible artefacts.
+const SILENCE_ENERGY: f64 = 64.0 * 64.0;
+/// Pitch search runs on every `rate / PITCH_SEARCH_RATE`-th sample before
+/// refining at full rate.
+const PITCH_SEARCH_RATE: u32 = 8000;
+
+/// Pitch search range in samples for `sample_rate`
+pub(crate) fn pitch_range(sample_rate: u32) -> (usize, usize) {
+    let per_ms = (sample_rate / 1000).max(1) as usize;
+    (
+        MIN_PITCH_MS as usize * per_ms,
+        MAX_PITCH_MS as usize * per_ms,
+    )
+}
+
+/// Pitch period found by [`find_period`]
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub(crate) struct Period {
+    /// Period length in samples
+    pub lag: usize,
+    /// Normalized cross-correlation between the last two periods; 1.0 for
+    /// silence
+    pub correlation: f32,
+}
+
+/// Locate the pitch period at the end of `x`.
+///
+/// Compares `x[n-2*lag..n-lag]` with `x[n-lag..]` for every lag in
+/// `min_lag..=max_lag` (clamped to half the signal) and returns the lag
+/// with the highest normalized cross-correlation. The search is first done
+/// on a decimated grid, then refined at full resolution around the winner.
+pub(crate) fn find_period(
+    x: &[i16],
+    sample_rate: u32,
+    min_lag: usize,
+    max_lag: usize,
+) -> Option<Period> {
+    let max_lag = max_lag.min(x.len() / 2);
+    if min_lag == 0 || min_lag > max_lag {
+        return None;
+    }
+
+    if mean_square(&x[x.len() - 2 * max_lag..]) < SILENCE_ENERGY {
+        return Some(Period {
+            lag: max_lag,
+            correlation: 1.0,
+        });
+    }
+
+    let step = (sample_rate / PITCH_SEARCH_RATE).max(1) as usize;
+    let coarse = best_lag(x, (min_lag..=max_lag).step_by(step), step);
+    let (lag, correlation) = if step > 1 {
+        let (lag, _) = coarse?;
+        let lo = lag.saturating_sub(step).max(min_lag);
+        let hi = (lag + step).min(max_lag);
+        best_lag(x, lo..=hi, 1)?
+    } else {
+        coarse?
+    };
+    Some(Period { lag, correlation })
+}
+
+fn best_lag(x: &[i16], lags: impl Iterator<Item = usize>, stride: usize) -> Option<(usize, f32)> {
+    let n = x.len();
+    let mut best: Option<(usize, f32)> = None;
+    for lag in lags {
+        let a = &x[n - 2 * lag..n - lag];
+        let b = &x[n - lag..];
+        let (mut ab, mut aa, mut bb) = (0f64, 0f64, 0f64);
+        for i in (0..lag).step_by(stride) {
+            let (p, q) = (a[i] as f64, b[i] as f64);
+            ab += p * q;
+            aa += p * p;
+            bb += q * q;
+        }
+        let correlation = if aa == 0.0 || bb == 0.0 {
+            0.0
+        } else {
+            (ab / (aa * bb).sqrt()) as f32
+        };
+        if best.is_none_or(|(_, c)| correlation > c) {
+            best = Some((lag, correlation));
+        }
+    }
+    best
+}
+
+fn mean_square(x: &[i16]) -> f64 {
+    if x.is_empty() {
+        return 0.0;
+    }
+    x.iter().map(|&s| (s as f64) * (s as f64)).sum::<f64>() / x.len() as f64
+}
+
+/// Linear cross-fade from `from` to `to`, appended to `out`
+pub(crate) fn crossfade_into(out: &mut Vec<i16>, from: &[i16], to: &[i16]) {
+    let n = from.len().min(to.len());
+    for i in 0..n {
+        let w = (i as i32 * 256) / n as i32;
+        let mixed = (from[i] as i32 * (256 - w) + to[i] as i32 * w) >> 8;
+        out.push(mixed as i16);
+    }
+}
+
+/// Remove one period of `lag` samples from the end of `x`.
+///
+/// The last two periods are replaced by a cross-fade from the first into
+/// the second, so the result is `x.len() - lag` samples long.
+pub(crate) fn accelerate(x: &[i16], lag: usize, out: &mut Vec<i16>) {
+    let n = x.len();
+    debug_assert!(2 * lag <= n);
+    out.extend_from_slice(&x[..n - 2 * lag]);
+    crossfade_into(out, &x[n - 2 * lag..n - lag], &x[n - lag..]);
+}
+
+/// Insert one period of `lag` samples before the end of `x`.
+///
+/// After the first `n - lag` samples, the last period cross-fades back
+/// into the one before it, which then leads into the last period again;
+/// the result is `x.len() + lag` samples long.
+pub(crate) fn preemptive_expand(x: &[i16], lag: usize, out: &mut Vec<i16>) {
+    let n = x.len();
+    debug_assert!(2 * lag <= n);
+    out.extend_from_slice(&x[..n - lag]);
+    crossfade_into(out, &x[n - lag..], &x[n - 2 * lag..n - lag]);
+    out.extend_from_slice(&x[n - lag..]);
+}
+
+/// Waveform-substitution concealment for codecs without native PLC.
+///
+/// Repeats the last pitch period of the played signal with a gain that
+/// decays on every concealed frame, muting after roughly 200 ms.
+#[derive(Debug)]
+pub(crate) struct Concealer {
+    /// One pitch period of the signal preceding the loss
+    cycle: Vec<i16>,
+    /// Read position in `cycle`
+    phase: usize,
+    /// Gain at the start of the next generated sample
+    gain: f32,
+    active: bool,
+}
+
+/// Gain multiplier applied per concealed frame after the first
+const EXPAND_DECAY: f32 = 0.7;
+/// Gain below which concealment output is silence
+const EXPAND_MUTE: f32 = 0.01;
+
+impl Concealer {
+    pub(crate) fn new(max_lag: usize) -> Self {
+        Self {
+            cycle: Vec::with_capacity(max_lag.max(1)),
+            phase: 0,
+            gain: 1.0,
+            active: false,
+        }
+    }
+
+    /// Whether the last frame produced was concealment
+    pub(crate) fn is_active(&self) -> bool {
+        self.active
+    }
+
+    /// Period currently being repeated (0 when inactive)
+    pub(crate) fn period(&self) -> usize {
+        if self.active {
+            self.cycle.len()
+        } else {
+            0
+        }
+    }
+
+    /// Append `n` samples of concealment to `out`. `history` is the most
+    /// recently produced audio, consulted when a loss begins; `lag` is the
+    /// period to repeat (for interleaved multi-channel audio, a whole
+    /// number of frames).
+    pub(crate) fn conceal(&mut self, history: &[i16], lag: usize, n: usize, out: &mut Vec<i16>) {
+        let first = !self.active;
+        if first {
+            let lag = lag.min(history.len());
+            self.cycle.clear();
+            self.cycle
+                .extend_from_slice(&history[history.len() - lag..]);
+            self.phase = 0;
+            self.gain = 1.0;
+            self.active = true;
+        }
+
+        let start = self.gain;
+        let end = if first { start } else { start * EXPAND_DECAY };
+        if self.cycle.is_empty() || start < EXPAND_MUTE {
+            out.extend(std::iter::repeat_n(0, n));
+        } else {
+            for i in 0..n {
+                let g = start + (end - start) * (i as f32 / n as f32);
+                out.push((self.cycle[self.phase] as f32 * g) as i16);
+                self.phase = (self.phase + 1) % self.cycle.len();
+            }
+        }
+        self.gain = end;
+    }
+
+    /// Blend the start of `frame` with the continuing concealment so real
+    /// audio fades in over up to one period, then end the loss.
+    pub(crate) fn merge(&mut self, frame: &mut [i16]) {
+        if !self.active {
+            return;
+        }
+        let overlap = self.cycle.len().min(frame.len() / 4);
+        for (i, sample) in frame.iter_mut().take(overlap).enumerate() {
+            let concealed = if self.cycle.is_empty() {
+                0.0
+            } else {
+                let s = self.cycle[self.phase] as f32 * self.gain;
+                self.phase = (self.phase + 1) % self.cycle.len();
+                s
+            };
+            let w = i as f32 / overlap as f32;
+            *sample = (concealed * (1.0 - w) + *sample as f32 * w) as i16;
+        }
+        self.end();
+    }
+
+    /// Forget the current loss without blending
+    pub(crate) fn end(&mut self) {
+        self.active = false;
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    /// `len` samples of a 200 Hz tone at 8 kHz (period 40)
+    fn tone(len: usize) -> Vec<i16> {
+        (0..len)
+            .map(|i| ((i as f32 * 2.0 * std::f32::consts::PI / 40.0).sin() * 8000.0) as i16)
+            .collect()
+    }
+
+    #[test]
+    fn test_find_period_on_tone() {
+        let x = tone(160);
+        let (min_lag, max_lag) = pitch_range(8000);
+        let period = find_period(&x, 8000, min_lag, max_lag).unwrap();
+        // 40 or a multiple of it, all perfectly correlated.
+        assert_eq!(period.lag % 40, 0);
+        assert!(period.correlation > 0.99);
+    }
+
+    #[test]
+    fn test_find_period_decimated_search() {
+        // 250 Hz at 48 kHz: period 192.
+        let x: Vec<i16> = (0..960)
+            .map(|i| ((i as f32 * 2.0 * std::f32::consts::PI / 192.0).sin() * 8000.0) as i16)
+            .collect();
+        let (min_lag, max_lag) = pitch_range(48000);
+        let period = find_period(&x, 48000, min_lag, max_lag).unwrap();
+        assert_eq!(period.lag % 192, 0);
+        assert!(period.correlation > 0.99);
+    }
+
+    #[test]
+    fn test_silence_is_stretchable() {
+        let x = vec![3i16; 160];
+        let period = find_period(&x, 8000, 16, 120).unwrap();
+        assert_eq!(period.lag, 80);
+        assert_eq!(period.correlation, 1.0);
+    }
+
+    #[test]
+    fn test_accelerate_and_expand_lengths() {
+        let x = tone(160);
+        let mut out = Vec::new();
+        accelerate(&x, 40, &mut out);
+        assert_eq!(out.len(), 120);
+        // Periodic input: removing a whole period is lossless.
+        assert_eq!(&out[..80], &x[..80]);
+
+        out.clear();
+        preemptive_expand(&x, 40, &mut out);
+        assert_eq!(out.len(), 200);
+        assert_eq!(&out[..120], &x[..120]);
+        assert_eq!(&out[160..], &x[120..]);
+    }
+
+    #[test]
+    fn test_concealment_repeats_then_fades() {
+        let history = tone(160);
+        let mut concealer = Concealer::new(120);
+        let mut out = Vec::new();
+        concealer.conceal(&history, 40, 160, &mut out);
+        // First frame repeats the last period at full gain.
+        assert_eq!(&out[..40], &history[120..]);
+        assert_eq!(concealer.period(), 40);
+
+        for _ in 0..20 {
+            concealer.conceal(&history, 40, 160, &mut out);
+        }
+        assert!(out[out.len() - 160..].iter().all(|&s| s == 0));
+
+        let mut frame = tone(160);
+        concealer.merge(&mut frame);
+        assert!(!concealer.is_active());
+        // Muted concealment: the fade-in starts from silence.
+        assert_eq!(frame[0], 0);
+        assert_eq!(&frame[40..], &tone(160)[40..]);
+    }
+}
@@ -7,6 +7,7 @@ pub mod audio;
 pub mod factory;
 pub mod mapping; // Add codec mapping utilities
 pub mod transcoding; // Add transcoding module // Export codec factory
+pub mod worker_pool;
 
 use crate::relay::{G711PcmaCodec, G711PcmuCodec};
 
@@ -16,6 +17,11 @@ pub use audio::common::*;
 // Re-export transcoding types
 pub use transcoding::{Transcoder, TranscodingPath, TranscodingStats};
 
+// Re-export media worker pool types
+pub use worker_pool::{
+    LaneError, LaneOutput, MediaWorkerConfig, MediaWorkerPool, MediaWorkerStats, TranscodeLane,
+};
+
 // Re-export codec mapping types
 pub use mapping::{CodecCapability, CodecMapper};
 
@@ -10,7 +10,7 @@ use crate::codec::audio::{OpusApplication, OpusCodec};
 use crate::codec::factory::CodecFactory;
 use crate::error::{CodecError, Result};
 use crate::processing::format::{ConversionParams, FormatConverter};
-use crate::types::{PayloadType, SampleRate};
+use crate::types::{AudioFrame, PayloadType, SampleRate};
 use std::collections::HashMap;
 use std::sync::Arc;
 use tokio::sync::RwLock;
@@ -120,22 +120,35 @@ impl Transcoder {
         // Perform transcoding
         let result = session.transcode(encoded_data).await;
 
-        // Update statistics
         if enable_stats {
-            let processing_time = start_time.elapsed().as_micros() as u64;
-            session.stats.total_processing_time_us += processing_time;
-
-            match &result {
-                Ok(_) => {
-                    session.stats.frames_transcoded += 1;
-                    session.stats.avg_processing_time_us = session.stats.total_processing_time_us
-                        as f32
-                        / session.stats.frames_transcoded as f32;
-                }
-                Err(_) => session.stats.errors += 1,
-            }
+            session.record(start_time, result.is_ok());
+        }
+
+        result
+    }
+
+    /// Blocking counterpart of [`Self::transcode`] for dedicated media
+    /// threads such as the [`MediaWorkerPool`](super::worker_pool::MediaWorkerPool)
+    /// workers. Output and statistics are identical; the only difference
+    /// is that a contended format converter blocks the calling thread, so
+    /// this must not be called from an async task.
+    pub fn transcode_blocking(
+        &mut self,
+        encoded_data: &[u8],
+        from_codec: PayloadType,
+        to_codec: PayloadType,
+    ) -> Result<Vec<u8>> {
+        if from_codec == to_codec {
+            return Ok(encoded_data.to_vec());
         }
 
+        let start_time = std::time::Instant::now();
+        let enable_stats = self.enable_stats;
+        let session = self.get_or_create_session(from_codec, to_codec)?;
+        let result = session.transcode_blocking(encoded_data);
+        if enable_stats {
+            session.record(start_time, result.is_ok());
+        }
         result
     }
 
@@ -246,44 +259,87 @@ impl TranscodingSession {
         let source_frame = self.source_codec.decode(encoded_data)?;
 
         // Step 2: Format conversion if needed
-        let target_info = self.target_codec.get_info();
-        let converted_frame = if source_frame.sample_rate != target_info.sample_rate
-            || source_frame.channels != target_info.channels
-        {
-            trace!(
-                "Converting format: {}Hz/{}ch -> {}Hz/{}ch",
-                source_frame.sample_rate,
-                source_frame.channels,
-                target_info.sample_rate,
-                target_info.channels
-            );
-
-            // Use FormatConverter's public API
-            let conversion_params = ConversionParams::new(
-                SampleRate::from_hz(target_info.sample_rate).unwrap_or(SampleRate::Rate8000),
-                target_info.channels,
-            );
-
-            let conversion_result = self
-                .format_converter
-                .write()
-                .await
-                .convert_frame(&source_frame, &conversion_params)?;
-            conversion_result.frame
-        } else {
-            source_frame
+        let converted_frame = match self.conversion_for(&source_frame) {
+            Some(conversion_params) => {
+                self.format_converter
+                    .write()
+                    .await
+                    .convert_frame(&source_frame, &conversion_params)?
+                    .frame
+            }
+            None => source_frame,
         };
 
         // Step 3: Encode to target format
-        let encoded = self.target_codec.encode(&converted_frame)?;
+        self.encode_target(encoded_data.len(), &converted_frame)
+    }
+
+    /// Transcode audio data without awaiting; see
+    /// [`Transcoder::transcode_blocking`]
+    pub fn transcode_blocking(&mut self, encoded_data: &[u8]) -> Result<Vec<u8>> {
+        let source_frame = self.source_codec.decode(encoded_data)?;
+
+        let converted_frame = match self.conversion_for(&source_frame) {
+            Some(conversion_params) => {
+                // Converters are normally owned by one transcoder, so the
+                // lock is free and `try_write` never falls through.
+                let mut converter = match self.format_converter.try_write() {
+                    Ok(converter) => converter,
+                    Err(_) => self.format_converter.blocking_write(),
+                };
+                converter
+                    .convert_frame(&source_frame, &conversion_params)?
+                    .frame
+            }
+            None => source_frame,
+        };
+
+        self.encode_target(encoded_data.len(), &converted_frame)
+    }
 
+    /// Conversion needed to feed `source_frame` to the target codec, if any
+    fn conversion_for(&self, source_frame: &AudioFrame) -> Option<ConversionParams> {
+        let target_info = self.target_codec.get_info();
+        if source_frame.sample_rate == target_info.sample_rate
+            && source_frame.channels == target_info.channels
+        {
+            return None;
+        }
         trace!(
-            "Transcoded {} bytes -> {} bytes",
-            encoded_data.len(),
-            encoded.len()
+            "Converting format: {}Hz/{}ch -> {}Hz/{}ch",
+            source_frame.sample_rate,
+            source_frame.channels,
+            target_info.sample_rate,
+            target_info.channels
         );
+
+        // Use FormatConverter's public API
+        Some(ConversionParams::new(
+            SampleRate::from_hz(target_info.sample_rate).unwrap_or(SampleRate::Rate8000),
+            target_info.channels,
+        ))
+    }
+
+    fn encode_target(&mut self, input_len: usize, frame: &AudioFrame) -> Result<Vec<u8>> {
+        let encoded = self.target_codec.encode(frame)?;
+
+        trace!("Transcoded {} bytes -> {} bytes", input_len, encoded.len());
         Ok(encoded)
     }
+
+    /// Update statistics for one frame started at `start_time`
+    fn record(&mut self, start_time: std::time::Instant, ok: bool) {
+        let processing_time = start_time.elapsed().as_micros() as u64;
+        self.stats.total_processing_time_us += processing_time;
+
+        if ok {
+            self.stats.frames_transcoded += 1;
+            self.stats.avg_processing_time_us =
+                self.stats.total_processing_time_us as f32 / self.stats.frames_transcoded as f32;
+        } else {
+            self.stats.errors += 1;
+        }
+    }
 }
 
 /// Utility functions for common transcoding scenarios
@@ -401,6 +457,22 @@ mod tests {
         assert!(stats.avg_processing_time_us >= 0.0);
     }
 
+    #[tokio::test]
+    async fn test_blocking_transcode_matches_async() {
+        let mut transcoder = create_test_transcoder();
+        let mut blocking = create_test_transcoder();
+        let pcmu_data: Vec<u8> = (0..160u8).collect();
+
+        let expected = transcoder.pcmu_to_pcma(&pcmu_data).await.unwrap();
+        let actual = tokio::task::spawn_blocking(move || {
+            let out = blocking.transcode_blocking(&pcmu_data, 0, 8).unwrap();
+            (out, blocking.get_stats(0, 8).unwrap().frames_transcoded)
+        })
+        .await
+        .unwrap();
+        assert_eq!(actual, (expected, 1));
+    }
+
     #[tokio::test]
     async fn test_unsupported_codec() {
         let mut transcoder = create_test_transcoder();
@@ -0,0 +1,787 @@
+//! Media Worker Pool
+//!
+//! Transcoding (decode -> resample -> encode) is CPU work that does not
+//! belong on the async runtime that also drives SIP transactions: a
+//! bridge pump that transcodes inline holds a runtime worker for the
+//! whole frame, and at high transcoding density those frames queue up in
+//! front of signalling tasks. [`MediaWorkerPool`] moves that work onto a
+//! few dedicated OS threads, optionally pinned to their own cores.
+//!
+//! Each transcoding stream is a [`TranscodeLane`] owned by one worker.
+//! The producer (typically a frame pump task) pushes frames into the
+//! lane's bounded lock-free queue without blocking; the worker wakes
+//! once per tick (20 ms by default, one audio frame) and drains every
+//! lane it owns in one pass, handing each result to the lane's delivery
+//! callback on the worker thread. A stream therefore gains at most one
+//! tick of latency, and the worker touches its transcoders back to back
+//! instead of being scheduled once per frame.
+//!
+//! Frames and passthrough frames share the lane's bounded queue. Transcoder
+//! swaps travel on a separate unbounded queue, each tagged with the number
+//! of frames submitted before it, so the worker applies a swap exactly
+//! between the frames around it and a swap never competes with frames for
+//! room. A lane whose frame queue is full rejects the frame
+//! ([`LaneError::Full`]) rather than blocking the producer; a lane whose
+//! delivery callback reported its destination gone rejects everything
+//! ([`LaneError::Closed`]).
+
+use std::collections::VecDeque;
+use std::sync::atomic::{AtomicBool, AtomicU64, AtomicUsize, Ordering};
+use std::sync::Arc;
+use std::thread;
+use std::time::{Duration, Instant};
+
+use bytes::Bytes;
+use crossbeam_queue::{ArrayQueue, SegQueue};
+use rvoip_infra_common::affinity::{allowed_cores, pin_current_thread};
+use thiserror::Error;
+use tracing::{debug, warn};
+
+use super::transcoding::Transcoder;
+use crate::error::{Error, Result};
+use crate::types::PayloadType;
+
+/// Default worker tick: one 20 ms audio frame
+pub const DEFAULT_MEDIA_WORKER_TICK: Duration = Duration::from_millis(20);
+
+/// Default number of frames a lane buffers between ticks
+pub const DEFAULT_LANE_DEPTH: usize = 16;
+
+/// Media worker pool configuration
+#[derive(Debug, Clone)]
+pub struct MediaWorkerConfig {
+    /// Number of worker threads. Default: a quarter of the available
+    /// cores, at least one.
+    pub workers: usize,
+    /// How often each worker drains its lanes
+    pub tick: Duration,
+    /// Frames a lane buffers before rejecting new ones
+    pub lane_depth: usize,
+    /// Pin each worker to its own core (Linux only; ignored elsewhere).
+    /// Workers take cores from the top of the process's affinity mask.
+    pub pin_to_cores: bool,
+}
+
+impl Default for MediaWorkerConfig {
+    fn default() -> Self {
+        let cpus = thread::available_parallelism()
+            .map(|n| n.get())
+            .unwrap_or(1);
+        Self {
+            workers: (cpus / 4).max(1),
+            tick: DEFAULT_MEDIA_WORKER_TICK,
+            lane_depth: DEFAULT_LANE_DEPTH,
+            pin_to_cores: true,
+        }
+    }
+}
+
+/// What a worker did with a submitted frame
+#[derive(Debug)]
+pub enum LaneOutput {
+    /// The payload, transcoded to the lane's target codec
+    Transcoded(Vec<u8>),
+    /// Transcoding failed; the frame is the caller's to drop or forward
+    Failed(Error),
+    /// The frame was submitted as passthrough, or the lane currently has
+    /// no transcoding to do
+    Passthrough,
+}
+
+/// Why a lane refused a frame
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Error)]
+pub enum LaneError {
+    /// The lane already holds `lane_depth` frames
+    #[error("media worker lane is full")]
+    Full,
+    /// The destination is gone or the pool shut down
+    #[error("media worker lane is closed")]
+    Closed,
+}
+
+/// Media worker pool statistics
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct MediaWorkerStats {
+    /// Worker threads
+    pub workers: usize,
+    /// Open lanes
+    pub lanes: usize,
+    /// Ticks run, summed over all workers
+    pub ticks: u64,
+    /// Frames delivered (transcoded, failed or passed through)
+    pub frames: u64,
+    /// Frames whose transcoding failed
+    pub failures: u64,
+    /// Frames rejected because their lane was full
+    pub dropped: u64,
+    /// Ticks whose batch took longer than the tick itself
+    pub overruns: u64,
+    /// Longest batch any worker has run
+    pub longest_batch: Duration,
+}
+
+#[derive(Default)]
+struct PoolCounters {
+    lanes: AtomicUsize,
+    ticks: AtomicU64,
+    frames: AtomicU64,
+    failures: AtomicU64,
+    dropped: AtomicU64,
+    overruns: AtomicU64,
+    longest_batch_ns: AtomicU64,
+}
+
+/// Work done by one worker in one tick, folded into [`PoolCounters`]
+/// once per tick rather than once per frame
+#[derive(Default)]
+struct TickBatch {
+    frames: u64,
+    failures: u64,
+    closed_lanes: usize,
+}
+
+struct LaneFrame<M> {
+    payload: Option<Bytes>,
+    meta: M,
+}
+
+struct LaneSwap {
+    /// Frames submitted before the swap; it applies from the next one on
+    after: u64,
+    transcoder: Option<Transcoder>,
+    from_pt: PayloadType,
+    to_pt: PayloadType,
+}
+
+struct LaneShared<M> {
+    /// One producer (the `TranscodeLane`), one consumer (the worker)
+    queue: ArrayQueue<LaneFrame<M>>,
+    /// Pending transcoder swaps, oldest first
+    swaps: SegQueue<LaneSwap>,
+    /// Frames the producer has queued so far
+    submitted: AtomicU64,
+    /// The `TranscodeLane` was dropped; the worker retires the lane once
+    /// the queue is empty
+    released: AtomicBool,
+    /// Delivery reported the destination gone, or the pool shut down
+    closed: AtomicBool,
+    counters: Arc<PoolCounters>,
+}
+
+/// Producer side of one transcoding stream on a [`MediaWorkerPool`].
+///
+/// Dropping the lane lets its worker finish the queued frames and then
+/// retire it.
+pub struct TranscodeLane<M> {
+    shared: Arc<LaneShared<M>>,
+    worker: usize,
+}
+
+impl<M> TranscodeLane<M> {
+    /// Queue `payload` for transcoding; `meta` travels with it to the
+    /// delivery callback
+    pub fn submit(&self, payload: Bytes, meta: M) -> std::result::Result<(), LaneError> {
+        self.push(Some(payload), meta)
+    }
+
+    /// Queue `meta` for delivery as [`LaneOutput::Passthrough`], in order
+    /// with the frames around it
+    pub fn pass(&self, meta: M) -> std::result::Result<(), LaneError> {
+        self.push(None, meta)
+    }
+
+    /// Replace the lane's transcoder from the next submitted frame on.
+    /// `None` (or equal payload types) turns the lane into passthrough.
+    ///
+    /// A swap is never refused for lack of room and never displaces a
+    /// queued frame.
+    pub fn swap(
+        &self,
+        transcoder: Option<Transcoder>,
+        from_pt: PayloadType,
+        to_pt: PayloadType,
+    ) -> std::result::Result<(), LaneError> {
+        if self.shared.closed.load(Ordering::Acquire) {
+            return Err(LaneError::Closed);
+        }
+        self.shared.swaps.push(LaneSwap {
+            after: self.shared.submitted.load(Ordering::Relaxed),
+            transcoder,
+            from_pt,
+            to_pt,
+        });
+        Ok(())
+    }
+
+    /// Whether the lane stopped accepting frames for good
+    pub fn is_closed(&self) -> bool {
+        self.shared.closed.load(Ordering::Acquire)
+    }
+
+    /// Index of the worker that owns this lane
+    pub fn worker(&self) -> usize {
+        self.worker
+    }
+
+    fn push(&self, payload: Option<Bytes>, meta: M) -> std::result::Result<(), LaneError> {
+        let shared = &self.shared;
+        if shared.closed.load(Ordering::Acquire) {
+            return Err(LaneError::Closed);
+        }
+        if shared.queue.push(LaneFrame { payload, meta }).is_err() {
+            shared.counters.dropped.fetch_add(1, Ordering::Relaxed);
+            return Err(LaneError::Full);
+        }
+        // Single producer: a swap pushed after this frame reads the new
+        // count, and every swap pushed before it is visible to the worker
+        // once it has popped the frame, which is when it drains swaps.
+        shared.submitted.fetch_add(1, Ordering::Relaxed);
+        Ok(())
+    }
+}
+
+impl<M> Drop for TranscodeLane<M> {
+    fn drop(&mut self) {
+        self.shared.released.store(true, Ordering::Release);
+    }
+}
+
+impl<M> std::fmt::Debug for TranscodeLane<M> {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("TranscodeLane")
+            .field("worker", &self.worker)
+            .field("queued", &self.shared.queue.len())
+            .field("closed", &self.is_closed())
+            .finish()
+    }
+}
+
+/// Worker side of a lane, type-erased so one worker can own lanes of
+/// different `M`
+trait LaneTask: Send {
+    /// Drain the queue; `false` once the lane should be retired
+    fn run(&mut self, batch: &mut TickBatch) -> bool;
+
+    /// Refuse further frames (pool shutdown)
+    fn close(&self);
+}
+
+struct Lane<M, F> {
+    shared: Arc<LaneShared<M>>,
+    transcoder: Option<Transcoder>,
+    from_pt: PayloadType,
+    to_pt: PayloadType,
+    deliver: F,
+    /// Frames popped before the current one, compared against
+    /// [`LaneSwap::after`]
+    popped: u64,
+    /// Swaps taken off the shared queue but not yet due
+    swaps: VecDeque<LaneSwap>,
+}
+
+impl<M, F> Lane<M, F> {
+    /// Apply every swap submitted before the frame just popped. Only
+    /// called after the pop: a swap pushed between a drain and the pop of
+    /// the frame behind it would otherwise be missed for that frame.
+    fn apply_swaps(&mut self) {
+        while let Some(swap) = self.shared.swaps.pop() {
+            self.swaps.push_back(swap);
+        }
+        while self
+            .swaps
+            .front()
+            .is_some_and(|swap| swap.after <= self.popped)
+        {
+            let swap = self.swaps.pop_front().expect("front checked");
+            self.transcoder = swap.transcoder;
+            self.from_pt = swap.from_pt;
+            self.to_pt = swap.to_pt;
+        }
+    }
+}
+
+impl<M, F> LaneTask for Lane<M, F>
+where
+    M: Send + 'static,
+    F: FnMut(M, LaneOutput) -> bool + Send + 'static,
+{
+    fn run(&mut self, batch: &mut TickBatch) -> bool {
+        // Read `released` before draining: every item pushed before the
+        // release is then visible to the pops below.
+        let released = self.shared.released.load(Ordering::Acquire);
+        loop {
+            let Some(LaneFrame { payload, meta }) = self.shared.queue.pop() else {
+                break;
+            };
+            self.apply_swaps();
+            self.popped += 1;
+            let output = match (payload, self.transcoder.as_mut()) {
+                (Some(payload), Some(transcoder)) if self.from_pt != self.to_pt => {
+                    match transcoder.transcode_blocking(&payload, self.from_pt, self.to_pt) {
+                        Ok(bytes) => LaneOutput::Transcoded(bytes),
+                        Err(e) => {
+                            batch.failures += 1;
+                            LaneOutput::Failed(e)
+                        }
+                    }
+                }
+                _ => LaneOutput::Passthrough,
+            };
+            batch.frames += 1;
+            if !(self.deliver)(meta, output) {
+                self.close();
+                break;
+            }
+        }
+        let retire = self.shared.closed.load(Ordering::Acquire)
+            || (released && self.shared.queue.is_empty());
+        if retire {
+            batch.closed_lanes += 1;
+        }
+        !retire
+    }
+
+    fn close(&self) {
+        self.shared.closed.store(true, Ordering::Release);
+    }
+}
+
+struct WorkerShared {
+    incoming: SegQueue<Box<dyn LaneTask>>,
+    shutdown: AtomicBool,
+}
+
+struct Worker {
+    shared: Arc<WorkerShared>,
+    thread: Option<thread::JoinHandle<()>>,
+}
+
+/// Dedicated transcoding threads; see the [module docs](self)
+pub struct MediaWorkerPool {
+    workers: Vec<Worker>,
+    next: AtomicUsize,
+    counters: Arc<PoolCounters>,
+    config: MediaWorkerConfig,
+}
+
+impl MediaWorkerPool {
+    /// Start `config.workers` worker threads
+    pub fn new(config: MediaWorkerConfig) -> Result<Self> {
+        if config.workers == 0 || config.lane_depth == 0 || config.tick.is_zero() {
+            return Err(Error::Config(
+                "media worker pool needs at least one worker, a non-zero lane depth and tick"
+                    .to_string(),
+            ));
+        }
+        let cores = if config.pin_to_cores {
+            allowed_cores()
+        } else {
+            Vec::new()
+        };
+        let counters = Arc::new(PoolCounters::default());
+        let mut workers = Vec::with_capacity(config.workers);
+        for index in 0..config.workers {
+            let shared = Arc::new(WorkerShared {
+                incoming: SegQueue::new(),
+                shutdown: AtomicBool::new(false),
+            });
+            // Take cores from the top: low-numbered cores tend to carry
+            // interrupt and housekeeping load.
+            let core = (!cores.is_empty()).then(|| cores[cores.len() - 1 - index % cores.len()]);
+            let thread = {
+                let shared = shared.clone();
+                let counters = counters.clone();
+                let tick = config.tick;
+                thread::Builder::new()
+                    .name(format!("rvoip-media-{}", index))
+                    .spawn(move || {
+                        if let Some(core) = core {
+                            match pin_current_thread(core) {
+                                Ok(()) => debug!("Media worker {} pinned to core {}", index, core),
+                                Err(e) => warn!("Media worker {} not pinned: {}", index, e),
+                            }
+                        }
+                        run_worker(&shared, &counters, tick);
+                    })
+            };
+            let thread = match thread {
+                Ok(thread) => thread,
+                Err(e) => {
+                    // Workers already started stop when `workers` drops.
+                    drop(Self {
+                        workers,
+                        next: AtomicUsize::new(0),
+                        counters,
+                        config,
+                    });
+                    return Err(e.into());
+                }
+            };
+            workers.push(Worker {
+                shared,
+                thread: Some(thread),
+            });
+        }
+        debug!(
+            "Started media worker pool: {} workers, {:?} tick",
+            config.workers, config.tick
+        );
+        Ok(Self {
+            workers,
+            next: AtomicUsize::new(0),
+            counters,
+            config,
+        })
+    }
+
+    /// Open a lane transcoding `from_pt` -> `to_pt` with `transcoder`
+    /// (`None` for passthrough until a [`TranscodeLane::swap`]).
+    ///
+    /// `deliver` runs on the worker thread for every frame, in
+    /// submission order, and returns `false` once the destination is gone,
+    /// which closes the lane. It must not block: a slow callback delays
+    /// every lane on the same worker.
+    pub fn open_lane<M, F>(
+        &self,
+        transcoder: Option<Transcoder>,
+        from_pt: PayloadType,
+        to_pt: PayloadType,
+        deliver: F,
+    ) -> TranscodeLane<M>
+    where
+        M: Send + 'static,
+        F: FnMut(M, LaneOutput) -> bool + Send + 'static,
+    {
+        let worker = self.next.fetch_add(1, Ordering::Relaxed) % self.workers.len();
+        let shared = Arc::new(LaneShared {
+            queue: ArrayQueue::new(self.config.lane_depth),
+            swaps: SegQueue::new(),
+            submitted: AtomicU64::new(0),
+            released: AtomicBool::new(false),
+            closed: AtomicBool::new(false),
+            counters: self.counters.clone(),
+        });
+        let lane = Lane {
+            shared: shared.clone(),
+            transcoder,
+            from_pt,
+            to_pt,
+            deliver,
+            popped: 0,
+            swaps: VecDeque::new(),
+        };
+        self.counters.lanes.fetch_add(1, Ordering::Relaxed);
+        self.workers[worker].shared.incoming.push(Box::new(lane));
+        TranscodeLane { shared, worker }
+    }
+
+    /// Pool configuration
+    pub fn config(&self) -> &MediaWorkerConfig {
+        &self.config
+    }
+
+    /// Snapshot of the pool counters
+    pub fn stats(&self) -> MediaWorkerStats {
+        let c = &self.counters;
+        MediaWorkerStats {
+            workers: self.workers.len(),
+            lanes: c.lanes.load(Ordering::Relaxed),
+            ticks: c.ticks.load(Ordering::Relaxed),
+            frames: c.frames.load(Ordering::Relaxed),
+            failures: c.failures.load(Ordering::Relaxed),
+            dropped: c.dropped.load(Ordering::Relaxed),
+            overruns: c.overruns.load(Ordering::Relaxed),
+            longest_batch: Duration::from_nanos(c.longest_batch_ns.load(Ordering::Relaxed)),
+        }
+    }
+}
+
+impl Drop for MediaWorkerPool {
+    fn drop(&mut self) {
+        for worker in &self.workers {
+            worker.shared.shutdown.store(true, Ordering::Release);
+            if let Some(thread) = &worker.thread {
+                thread.thread().unpark();
+            }
+        }
+        for worker in &mut self.workers {
+            if let Some(thread) = worker.thread.take() {
+                let _ = thread.join();
+            }
+        }
+    }
+}
+
+impl std::fmt::Debug for MediaWorkerPool {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("MediaWorkerPool")
+            .field("config", &self.config)
+            .field("stats", &self.stats())
+            .finish()
+    }
+}
+
+fn run_worker(shared: &WorkerShared, counters: &PoolCounters, tick: Duration) {
+    let mut lanes: Vec<Box<dyn LaneTask>> = Vec::new();
+    let mut deadline = Instant::now() + tick;
+    loop {
+        // `park_timeout` may return early; re-check until the deadline
+        // or shutdown.
+        loop {
+            let now = Instant::now();
+            if now >= deadline || shared.shutdown.load(Ordering::Acquire) {
+                break;
+            }
+            thread::park_timeout(deadline - now);
+        }
+        if shared.shutdown.load(Ordering::Acquire) {
+            break;
+        }
+
+        while let Some(lane) = shared.incoming.pop() {
+            lanes.push(lane);
+        }
+
+        let started = Instant::now();
+        let mut batch = TickBatch::default();
+        lanes.retain_mut(|lane| lane.run(&mut batch));
+        let elapsed = started.elapsed();
+
+        counters.ticks.fetch_add(1, Ordering::Relaxed);
+        if batch.frames > 0 {
+            counters.frames.fetch_add(batch.frames, Ordering::Relaxed);
+            counters
+                .failures
+                .fetch_add(batch.failures, Ordering::Relaxed);
+            counters
+                .longest_batch_ns
+                .fetch_max(elapsed.as_nanos() as u64, Ordering::Relaxed);
+        }
+        if batch.closed_lanes > 0 {
+            counters
+                .lanes
+                .fetch_sub(batch.closed_lanes, Ordering::Relaxed);
+        }
+
+        deadline += tick;
+        let now = Instant::now();
+        if now >= deadline {
+            // Behind schedule: start the next tick now rather than
+            // running a burst of catch-up ticks.
+            counters.overruns.fetch_add(1, Ordering::Relaxed);
+            deadline = now;
+        }
+    }
+
+    // Refuse further frames on every lane this worker owns or was
+    // about to own.
+    while let Some(lane) = shared.incoming.pop() {
+        lanes.push(lane);
+    }
+    for lane in &lanes {
+        lane.close();
+    }
+    counters.lanes.fetch_sub(lanes.len(), Ordering::Relaxed);
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::processing::format::FormatConverter;
+    use std::sync::mpsc;
+    use tokio::sync::RwLock;
+
+    fn pool(tick_ms: u64, lane_depth: usize) -> MediaWorkerPool {
+        MediaWorkerPool::new(MediaWorkerConfig {
+            workers: 2,
+            tick: Duration::from_millis(tick_ms),
+            lane_depth,
+            pin_to_cores: false,
+        })
+        .unwrap()
+    }
+
+    fn transcoder() -> Transcoder {
+        Transcoder::new(Arc::new(RwLock::new(FormatConverter::new())))
+    }
+
+    type Delivered = (u32, Option<Vec<u8>>);
+
+    fn collecting_lane(
+        pool: &MediaWorkerPool,
+        transcoder: Option<Transcoder>,
+        from_pt: PayloadType,
+        to_pt: PayloadType,
+    ) -> (TranscodeLane<u32>, mpsc::Receiver<Delivered>) {
+        let (tx, rx) = mpsc::channel();
+        let lane = pool.open_lane(transcoder, from_pt, to_pt, move |seq, output| {
+            let payload = match output {
+                LaneOutput::Transcoded(bytes) => Some(bytes),
+                LaneOutput::Failed(_) => Some(Vec::new()),
+                LaneOutput::Passthrough => None,
+            };
+            tx.send((seq, payload)).is_ok()
+        });
+        (lane, rx)
+    }
+
+    #[test]
+    fn lanes_transcode_in_order() {
+        let pool = pool(5, 16);
+        let (lane, rx) = collecting_lane(&pool, Some(transcoder()), 0, 8);
+        let pcmu = Bytes::from(vec![0xFFu8; 160]);
+        let mut reference = transcoder();
+        let expected = reference.transcode_blocking(&pcmu, 0, 8).unwrap();
+
+        for seq in 0..4 {
+            lane.submit(pcmu.clone(), seq).unwrap();
+        }
+        lane.pass(4).unwrap();
+        lane.swap(None, 0, 8).unwrap();
+        lane.submit(pcmu.clone(), 5).unwrap();
+
+        let delivered: Vec<Delivered> = (0..6)
+            .map(|_| rx.recv_timeout(Duration::from_secs(2)).unwrap())
+            .collect();
+        let mut want: Vec<Delivered> = (0..4).map(|seq| (seq, Some(expected.clone()))).collect();
+        want.push((4, None));
+        want.push((5, None));
+        assert_eq!(delivered, want);
+
+        let stats = pool.stats();
+        assert_eq!(stats.workers, 2);
+        assert_eq!(stats.frames, 6);
+        assert_eq!(stats.failures, 0);
+    }
+
+    #[test]
+    fn full_lanes_reject_frames() {
+        // A long tick keeps the worker from draining during the test.
+        let pool = pool(10_000, 2);
+        let (lane, _rx) = collecting_lane(&pool, None, 0, 0);
+        lane.pass(0).unwrap();
+        lane.pass(1).unwrap();
+        assert_eq!(lane.pass(2), Err(LaneError::Full));
+        assert_eq!(pool.stats().dropped, 1);
+    }
+
+    #[test]
+    fn swaps_on_a_full_lane_keep_every_frame_and_the_last_codec() {
+        let pool = pool(5, 2);
+        let (started_tx, started_rx) = mpsc::channel();
+        let (gate_tx, gate_rx) = mpsc::channel::<()>();
+        let (tx, rx) = mpsc::channel();
+        let lane = pool.open_lane(Some(transcoder()), 0, 8, move |seq: u32, output| {
+            if seq == 0 {
+                // Hold the worker so the lane fills up behind this frame.
+                started_tx.send(()).unwrap();
+                gate_rx.recv().unwrap();
+            }
+            let payload = match output {
+                LaneOutput::Transcoded(bytes) => Some(bytes),
+                LaneOutput::Failed(_) => Some(Vec::new()),
+                LaneOutput::Passthrough => None,
+            };
+            tx.send((seq, payload)).is_ok()
+        });
+        let pcmu = Bytes::from(vec![0xFFu8; 160]);
+        let expected = transcoder().transcode_blocking(&pcmu, 0, 8).unwrap();
+
+        lane.submit(pcmu.clone(), 0).unwrap();
+        started_rx.recv_timeout(Duration::from_secs(2)).unwrap();
+        lane.submit(pcmu.clone(), 1).unwrap();
+        lane.submit(pcmu.clone(), 2).unwrap();
+        assert_eq!(lane.submit(pcmu.clone(), 99), Err(LaneError::Full));
+        lane.swap(None, 0, 0).unwrap();
+        lane.swap(Some(transcoder()), 0, 8).unwrap();
+        gate_tx.send(()).unwrap();
+
+        let delivered: Vec<Delivered> = (0..3)
+            .map(|_| rx.recv_timeout(Duration::from_secs(2)).unwrap())
+            .collect();
+        let want: Vec<Delivered> = (0..3).map(|seq| (seq, Some(expected.clone()))).collect();
+        assert_eq!(delivered, want);
+
+        lane.submit(pcmu.clone(), 3).unwrap();
+        assert_eq!(
+            rx.recv_timeout(Duration::from_secs(2)).unwrap(),
+            (3, Some(expected))
+        );
+        assert_eq!(pool.stats().dropped, 1);
+    }
+
+    #[test]
+    fn swaps_interleaved_with_a_running_worker_apply_from_the_next_frame() {
+        const FRAMES: u32 = 3_000;
+        // A short tick and a deep lane keep the worker popping while the
+        // producer alternates swaps and frames.
+        let pool = pool(1, FRAMES as usize);
+        let (lane, rx) = collecting_lane(&pool, Some(transcoder()), 0, 8);
+        let pcmu = Bytes::from(vec![0xFFu8; 160]);
+        let expected = transcoder().transcode_blocking(&pcmu, 0, 8).unwrap();
+        // Every third frame flips the lane between transcoding and
+        // passthrough.
+        let transcodes = |seq: u32| (seq / 3) % 2 == 0;
+
+        for seq in 0..FRAMES {
+            if seq % 3 == 0 {
+                if transcodes(seq) {
+                    lane.swap(Some(transcoder()), 0, 8).unwrap();
+                } else {
+                    lane.swap(None, 0, 8).unwrap();
+                }
+            }
+            lane.submit(pcmu.clone(), seq).unwrap();
+        }
+
+        for seq in 0..FRAMES {
+            let want = transcodes(seq).then(|| expected.clone());
+            assert_eq!(
+                rx.recv_timeout(Duration::from_secs(2)).unwrap(),
+                (seq, want),
+                "frame {seq}"
+            );
+        }
+    }
+
+    #[test]
+    fn lanes_close_with_their_destination_and_the_pool() {
+        let pool = pool(5, 16);
+        let (lane, rx) = collecting_lane(&pool, None, 0, 0);
+        drop(rx);
+        lane.pass(0).unwrap();
+        let deadline = Instant::now() + Duration::from_secs(2);
+        while !lane.is_closed() {
+            assert!(Instant::now() < deadline, "lane never closed");
+            thread::sleep(Duration::from_millis(5));
+        }
+        assert_eq!(lane.pass(1), Err(LaneError::Closed));
+
+        let (other, _rx) = collecting_lane(&pool, None, 0, 0);
+        drop(pool);
+        assert!(other.is_closed());
+    }
+
+    #[test]
+    fn released_lanes_are_retired_after_draining() {
+        let pool = pool(5, 16);
+        let (lane, rx) = collecting_lane(&pool, None, 0, 0);
+        lane.pass(7).unwrap();
+        drop(lane);
+        assert_eq!(rx.recv_timeout(Duration::from_secs(2)).unwrap(), (7, None));
+        let deadline = Instant::now() + Duration::from_secs(2);
+        while pool.stats().lanes != 0 {
+            assert!(Instant::now() < deadline, "lane never retired");
+            thread::sleep(Duration::from_millis(5));
+        }
+    }
+
+    #[test]
+    fn empty_pools_are_rejected() {
+        let config = MediaWorkerConfig {
+            workers: 0,
+            ..Default::default()
+        };
+        assert!(MediaWorkerPool::new(config).is_err());
+    }
+}
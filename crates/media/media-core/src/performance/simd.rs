@@ -116,6 +116,128 @@ impl SimdProcessor {
     }
 }
 
+/// Add `input` into the 32-bit accumulator `acc`, sample by sample.
+///
+/// Used by the conference mixer to build the sum of all active speakers
+/// once per cycle. Processes `min(acc.len(), input.len())` samples; eight
+/// lanes at a time with SSE2 on x86_64, elsewhere as a plain loop that
+/// the compiler vectorizes for the target.
+pub fn accumulate_i16(acc: &mut [i32], input: &[i16]) {
+    let len = acc.len().min(input.len());
+    #[cfg(target_arch = "x86_64")]
+    let done = sse2::accumulate_i16(&mut acc[..len], &input[..len]);
+    #[cfg(not(target_arch = "x86_64"))]
+    let done = 0;
+
+    for (a, &x) in acc[done..len].iter_mut().zip(&input[done..len]) {
+        *a += x as i32;
+    }
+}
+
+/// Narrow a 32-bit mix to 16 bits: `out[i] = sat16(round((acc[i] -
+/// exclude[i]) * gain))`.
+///
+/// `exclude` removes one contributor from the sum (the listener's own
+/// voice in an N-1 mix). Rounding is to nearest, ties to even, and
+/// results outside the i16 range saturate. Processes `min(acc.len(),
+/// out.len())` samples; an `exclude` shorter than that is treated as
+/// zero-padded.
+pub fn mix_down_i16(acc: &[i32], exclude: Option<&[i16]>, gain: f32, out: &mut [i16]) {
+    let len = acc.len().min(out.len());
+    let exclude = exclude.map(|e| &e[..e.len().min(len)]);
+
+    #[cfg(target_arch = "x86_64")]
+    let done = sse2::mix_down_i16(&acc[..len], exclude, gain, &mut out[..len]);
+    #[cfg(not(target_arch = "x86_64"))]
+    let done = 0;
+
+    for i in done..len {
+        let own = exclude.and_then(|e| e.get(i)).map_or(0, |&x| x as i32);
+        out[i] = narrow(acc[i] - own, gain);
+    }
+}
+
+#[inline]
+fn narrow(sample: i32, gain: f32) -> i16 {
+    let scaled = if gain == 1.0 {
+        sample
+    } else {
+        (sample as f32 * gain).round_ties_even() as i32
+    };
+    scaled.clamp(i16::MIN as i32, i16::MAX as i32) as i16
+}
+
+/// SSE2 kernels; SSE2 is part of the x86_64 baseline, so no runtime
+/// detection is needed. Each returns how many leading samples it handled
+/// (a multiple of eight); the caller finishes the tail.
+#[cfg(target_arch = "x86_64")]
+mod sse2 {
+    use std::arch::x86_64::*;
+
+    const LANES: usize = 8;
+
+    pub(super) fn accumulate_i16(acc: &mut [i32], input: &[i16]) -> usize {
+        let n = acc.len().min(input.len()) / LANES * LANES;
+        // SAFETY: SSE2 is always available on x86_64; every load/store is
+        // unaligned and covers `i..i + 8` with `i + 8 <= n`.
+        unsafe {
+            for i in (0..n).step_by(LANES) {
+                let x = _mm_loadu_si128(input.as_ptr().add(i) as *const __m128i);
+                let (lo, hi) = widen(x);
+                let a = acc.as_mut_ptr().add(i) as *mut __m128i;
+                _mm_storeu_si128(a, _mm_add_epi32(_mm_loadu_si128(a), lo));
+                let a = a.add(1);
+                _mm_storeu_si128(a, _mm_add_epi32(_mm_loadu_si128(a), hi));
+            }
+        }
+        n
+    }
+
+    pub(super) fn mix_down_i16(
+        acc: &[i32],
+        exclude: Option<&[i16]>,
+        gain: f32,
+        out: &mut [i16],
+    ) -> usize {
+        let covered = exclude.map_or(usize::MAX, <[i16]>::len);
+        let n = acc.len().min(out.len()).min(covered) / LANES * LANES;
+        // SAFETY: as above; `exclude`, when present, covers `0..n`.
+        unsafe {
+            let g = _mm_set1_ps(gain);
+            for i in (0..n).step_by(LANES) {
+                let a = acc.as_ptr().add(i) as *const __m128i;
+                let mut lo = _mm_loadu_si128(a);
+                let mut hi = _mm_loadu_si128(a.add(1));
+                if let Some(exclude) = exclude {
+                    let (x_lo, x_hi) =
+                        widen(_mm_loadu_si128(exclude.as_ptr().add(i) as *const __m128i));
+                    lo = _mm_sub_epi32(lo, x_lo);
+                    hi = _mm_sub_epi32(hi, x_hi);
+                }
+                if gain != 1.0 {
+                    // cvtps rounds with MXCSR's default round-to-nearest-even.
+                    lo = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(lo), g));
+                    hi = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(hi), g));
+                }
+                _mm_storeu_si128(
+                    out.as_mut_ptr().add(i) as *mut __m128i,
+                    _mm_packs_epi32(lo, hi),
+                );
+            }
+        }
+        n
+    }
+
+    /// Sign-extend eight i16 lanes into two vectors of four i32
+    #[inline]
+    unsafe fn widen(x: __m128i) -> (__m128i, __m128i) {
+        (
+            _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16),
+            _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16),
+        )
+    }
+}
+
 impl Default for SimdProcessor {
     fn default() -> Self {
         Self::new()
@@ -199,4 +321,47 @@ mod tests {
 
         assert_eq!(simd_output, scalar_output);
     }
+
+    #[test]
+    fn test_accumulate_and_mix_down_match_scalar() {
+        // 163 samples: exercises the eight-lane body and the scalar tail.
+        let a: Vec<i16> = (0..163)
+            .map(|i| ((i * 977) % 65536 - 32768) as i16)
+            .collect();
+        let b: Vec<i16> = (0..163)
+            .map(|i| ((i * 1531) % 65536 - 32768) as i16)
+            .collect();
+        let mut acc = vec![0i32; 163];
+        accumulate_i16(&mut acc, &a);
+        accumulate_i16(&mut acc, &b);
+        for i in 0..163 {
+            assert_eq!(acc[i], a[i] as i32 + b[i] as i32);
+        }
+
+        for gain in [1.0f32, 0.5, 1.0 / 3.0] {
+            let mut out = vec![0i16; 163];
+            mix_down_i16(&acc, Some(&b), gain, &mut out);
+            for i in 0..163 {
+                let expected = ((a[i] as f32) * gain).round_ties_even() as i32;
+                assert_eq!(
+                    out[i] as i32,
+                    expected.clamp(-32768, 32767),
+                    "gain {}",
+                    gain
+                );
+            }
+        }
+    }
+
+    #[test]
+    fn test_mix_down_saturates() {
+        let acc = vec![40_000i32, -40_000, 32_767, -32_768, 65_534, 3, 5, 7, 9];
+        let mut out = vec![0i16; acc.len()];
+        mix_down_i16(&acc, None, 1.0, &mut out);
+        assert_eq!(out, vec![32767, -32768, 32767, -32768, 32767, 3, 5, 7, 9]);
+
+        // Halving brings the sum back into range; .5 ties go to even.
+        mix_down_i16(&acc, None, 0.5, &mut out);
+        assert_eq!(out, vec![20000, -20000, 16384, -16384, 32767, 2, 2, 4, 4]);
+    }
 }
@@ -3,9 +3,16 @@
 //! This module provides the AudioMixer component that handles real-time mixing
 //! of multiple audio streams for conference calls. Each participant receives
 //! a mix of all other participants (N-1 mixing).
-
-use crate::processing::audio::{AudioStreamConfig, AudioStreamManager, VoiceActivityDetector};
-use crate::processing::format::FormatConverter;
+//!
+//! Only the loudest `max_active_speakers` talking participants are mixed.
+//! Each cycle sums those speakers once into a 32-bit accumulator; a
+//! speaker's N-1 mix is that total minus their own frame, and everyone
+//! else shares a single mix of all speakers. A cycle therefore produces at
+//! most `max_active_speakers + 1` distinct frames however large the
+//! conference, and [`MixCycle`] exposes them so each can be encoded once.
+
+use crate::performance::simd;
+use crate::processing::audio::{AudioStreamConfig, AudioStreamManager, MixInput};
 use crate::types::conference::{
     AudioStream, ConferenceError, ConferenceMixingConfig, ConferenceMixingEvent,
     ConferenceMixingStats, ConferenceResult, MixingQuality, ParticipantId,
@@ -32,32 +39,63 @@ pub struct AudioMixer {
 
     /// Mixed output cache (participant_id -> mixed_frame). `DashMap`
     /// so per-participant insert/lookup is sharded and reads never
-    /// block the mix cycle's writes (and vice versa).
+    /// block the mix cycle's writes (and vice versa). Listeners share
+    /// one `Arc` per cycle.
     output_cache: Arc<DashMap<ParticipantId, Arc<AudioFrame>>>,
 
-    /// Memory pool for audio frames to reduce allocations. Wired in
-    /// at construction; the per-cycle pull path is staged out and
-    /// will be reattached when the alloc-aware mix loop lands.
-    #[allow(dead_code)]
-    frame_pool: Arc<Mutex<Vec<AudioFrame>>>,
-
-    /// Format converter for audio processing. Held by the mixer so
-    /// the conversion happens in-place when an input frame's sample
-    /// rate diverges from the configured mix rate; current callers
-    /// pre-normalise so the converter is unused but kept.
-    #[allow(dead_code)]
-    format_converter: Arc<Mutex<FormatConverter>>,
-
-    /// Voice activity detector for selective mixing. Held so the
-    /// suppression path can come online without re-plumbing the
-    /// mixer.
-    #[allow(dead_code)]
-    vad: Arc<Mutex<VoiceActivityDetector>>,
+    /// Output frames recycled from earlier cycles. Each is uniquely
+    /// owned, so the next cycle overwrites it in place instead of
+    /// allocating.
+    frame_pool: Arc<parking_lot::Mutex<Vec<Arc<AudioFrame>>>>,
+
+    /// Per-cycle working buffers; also serializes mix cycles
+    scratch: parking_lot::Mutex<MixScratch>,
 
     /// Event sender for conference monitoring
     event_sender: Arc<Mutex<Option<tokio::sync::mpsc::UnboundedSender<ConferenceMixingEvent>>>>,
 }
 
+/// Buffers reused from one mix cycle to the next
+#[derive(Default)]
+struct MixScratch {
+    /// This cycle's inputs, one per healthy participant
+    inputs: Vec<MixInput>,
+    /// Indices into `inputs` of the selected speakers, loudest first
+    speakers: Vec<usize>,
+    /// Sum of all speakers' samples
+    total: Vec<i32>,
+    /// Frames handed out by the previous cycle, returned to the frame pool
+    /// once nobody else holds them
+    previous: Vec<Arc<AudioFrame>>,
+}
+
+/// The distinct mixes produced by one [`AudioMixer::mix_cycle`]
+#[derive(Debug, Clone, Default)]
+pub struct MixCycle {
+    /// Mix of all speakers, heard by every participant who is not one.
+    /// `None` when nobody spoke or everyone present is a speaker.
+    pub common: Option<Arc<AudioFrame>>,
+    /// Each speaker with their N-1 mix (all other speakers), loudest
+    /// speaker first
+    pub speakers: Vec<(ParticipantId, Arc<AudioFrame>)>,
+}
+
+impl MixCycle {
+    /// The mix `participant_id` should hear this cycle
+    pub fn mix_for(&self, participant_id: &ParticipantId) -> Option<&Arc<AudioFrame>> {
+        self.speakers
+            .iter()
+            .find(|(id, _)| id == participant_id)
+            .map(|(_, frame)| frame)
+            .or(self.common.as_ref())
+    }
+
+    /// Number of distinct frames (and hence encodes) this cycle produced
+    pub fn unique_mixes(&self) -> usize {
+        self.speakers.len() + self.common.is_some() as usize
+    }
+}
+
 /// Audio mixing algorithms implementation
 struct MixingAlgorithms;
 
@@ -81,26 +119,16 @@ impl AudioMixer {
             stream_config,
         )?);
 
-        let format_converter = Arc::new(Mutex::new(FormatConverter::new()));
-        let vad_config = crate::processing::audio::VadConfig::default();
-        let vad =
-            VoiceActivityDetector::new(vad_config).map_err(|e| ConferenceError::MixingFailed {
-                reason: format!("Failed to create VAD: {}", e),
-            })?;
-        let vad = Arc::new(Mutex::new(vad));
-
         Ok(Self {
             stream_manager,
             config,
             stats: Arc::new(parking_lot::Mutex::new(ConferenceMixingStats::default())),
             output_cache: Arc::new(DashMap::new()),
-            frame_pool: Arc::new(Mutex::new(Vec::new())),
-            format_converter,
-            vad,
+            frame_pool: Arc::new(parking_lot::Mutex::new(Vec::new())),
+            scratch: parking_lot::Mutex::new(MixScratch::default()),
             event_sender: Arc::new(Mutex::new(None)),
         })
     }
-
     /// Set event sender for conference monitoring
     pub async fn set_event_sender(
         &self,
@@ -193,93 +221,212 @@ impl AudioMixer {
         Ok(None)
     }
 
+    /// Like [`get_mixed_audio`](Self::get_mixed_audio), but returns the
+    /// shared frame without copying it. Participants hearing the same mix
+    /// get the same `Arc`, so callers can encode once per distinct frame
+    /// (e.g. keyed by `Arc::as_ptr`).
+    pub fn get_shared_mixed_audio(
+        &self,
+        participant_id: &ParticipantId,
+    ) -> Option<Arc<AudioFrame>> {
+        self.output_cache
+            .get(participant_id)
+            .map(|cached| Arc::clone(cached.value()))
+    }
+
     /// Mix audio from all participants and produce outputs for each
     /// This is the core N-way mixing function: N inputs → N outputs (N-1 mixing)
+    ///
+    /// Copies the shared mixes of [`mix_cycle`](Self::mix_cycle) out per
+    /// participant; prefer `mix_cycle` where the copies are not needed.
     pub async fn mix_participants(
         &self,
         _inputs: &[AudioFrame],
     ) -> ConferenceResult<HashMap<ParticipantId, AudioFrame>> {
+        self.mix_cycle().await?;
+
+        Ok(self
+            .output_cache
+            .iter()
+            .map(|entry| (entry.key().clone(), (**entry.value()).clone()))
+            .collect())
+    }
+
+    /// Run one mix cycle: take the next frame of every participant, select
+    /// the active speakers, and produce the distinct mixes. The per-
+    /// participant assignment is also cached for
+    /// [`get_mixed_audio`](Self::get_mixed_audio).
+    pub async fn mix_cycle(&self) -> ConferenceResult<MixCycle> {
         let start_time = Instant::now();
 
-        // Get synchronized frames from all participants
-        let participant_frames = self.stream_manager.get_synchronized_frames()?;
+        let (cycle, participant_count) = {
+            let mut scratch = self.scratch.lock();
+            let cycle = self.run_mix_cycle(&mut scratch)?;
+            (cycle, scratch.inputs.len())
+        };
 
-        let mut mixed_outputs = HashMap::new();
+        // Always update statistics (even for attempted mixes)
+        self.update_mixing_stats(start_time, participant_count, cycle.unique_mixes())
+            .await;
 
-        if participant_frames.len() >= 2 {
-            // We have enough frames for actual mixing
-            // For each participant, create a mix of all OTHER participants
-            for (target_participant, _) in &participant_frames {
-                let mixed_frame = self
-                    .create_mixed_frame_for_participant(target_participant, &participant_frames)?;
+        Ok(cycle)
+    }
 
-                if let Some(frame) = mixed_frame {
-                    mixed_outputs.insert(target_participant.clone(), frame);
-                }
+    fn run_mix_cycle(&self, scratch: &mut MixScratch) -> ConferenceResult<MixCycle> {
+        let MixScratch {
+            inputs,
+            speakers,
+            total,
+            previous,
+        } = scratch;
+
+        self.stream_manager.collect_mix_inputs(inputs)?;
+        self.select_speakers(inputs, speakers);
+
+        // Sum the speakers once.
+        let frame_len =
+            self.config.output_samples_per_frame as usize * self.config.output_channels as usize;
+        total.clear();
+        total.resize(frame_len, 0);
+        for &index in speakers.iter() {
+            if let Some(frame) = &inputs[index].frame {
+                simd::accumulate_i16(total, &frame.samples);
             }
         }
 
-        // Always update statistics (even for attempted mixes)
-        self.update_mixing_stats(start_time, participant_frames.len(), &mixed_outputs)
-            .await?;
-
-        // Cache outputs (if any). DashMap — no global lock, sharded
-        // inserts. We clear before populating so stale entries from a
-        // previous mix cycle don't survive.
-        if !mixed_outputs.is_empty() {
-            self.output_cache.clear();
-            for (participant_id, frame) in &mixed_outputs {
-                self.output_cache
-                    .insert(participant_id.clone(), Arc::new(frame.clone()));
+        let mut cycle = MixCycle::default();
+        if let Some(&loudest) = speakers.first() {
+            let timestamp = inputs[loudest].frame.as_ref().map_or(0, |f| f.timestamp);
+            let mut pool = self.frame_pool.lock();
+
+            if inputs.len() > speakers.len() {
+                cycle.common =
+                    Some(self.mix_down(&mut pool, total, None, speakers.len(), timestamp));
+            }
+            for &index in speakers.iter() {
+                let input = &inputs[index];
+                let own = input.frame.as_ref().map(|f| f.samples.as_slice());
+                let mix = self.mix_down(&mut pool, total, own, speakers.len() - 1, timestamp);
+                cycle.speakers.push((input.participant_id.clone(), mix));
             }
         }
 
-        Ok(mixed_outputs)
+        self.publish(inputs, &cycle);
+
+        // Last cycle's frames are free once the cache and callers have let
+        // go of them.
+        let mut pool = self.frame_pool.lock();
+        for frame in previous.drain(..) {
+            if Arc::strong_count(&frame) == 1 {
+                pool.push(frame);
+            }
+        }
+        previous.extend(cycle.common.iter().cloned());
+        previous.extend(cycle.speakers.iter().map(|(_, frame)| Arc::clone(frame)));
+
+        Ok(cycle)
     }
 
-    /// Create mixed audio frame for a specific participant (exclude their own audio)
-    fn create_mixed_frame_for_participant(
-        &self,
-        target_participant: &ParticipantId,
-        all_frames: &[(ParticipantId, AudioFrame)],
-    ) -> ConferenceResult<Option<AudioFrame>> {
-        // Filter out the target participant's own audio
-        let other_frames: Vec<&AudioFrame> = all_frames
-            .iter()
-            .filter(|(id, _)| id != target_participant)
-            .map(|(_, frame)| frame)
-            .collect();
+    /// Pick up to `max_active_speakers` of `inputs` with a frame this
+    /// cycle, loudest first. With voice-activity mixing only talking
+    /// participants qualify; otherwise everyone is ranked by level.
+    fn select_speakers(&self, inputs: &[MixInput], speakers: &mut Vec<usize>) {
+        speakers.clear();
+        speakers.extend(
+            inputs
+                .iter()
+                .enumerate()
+                .filter(|(_, input)| input.frame.is_some() && input.is_talking)
+                .map(|(index, _)| index),
+        );
+        // Ties (e.g. during the VAD grace period) break by id so the
+        // selection is stable from cycle to cycle.
+        speakers.sort_unstable_by(|&a, &b| {
+            inputs[b]
+                .speech_level
+                .total_cmp(&inputs[a].speech_level)
+                .then_with(|| inputs[a].participant_id.0.cmp(&inputs[b].participant_id.0))
+        });
+        speakers.truncate(self.config.max_active_speakers.max(1));
+    }
 
-        if other_frames.is_empty() {
-            return Ok(None);
+    /// Produce one mix from the speaker `total`, minus `exclude` if given,
+    /// into a pooled frame. `contributors` is how many speakers remain in
+    /// the mix; with none the frame is silence.
+    fn mix_down(
+        &self,
+        pool: &mut Vec<Arc<AudioFrame>>,
+        total: &[i32],
+        exclude: Option<&[i16]>,
+        contributors: usize,
+        timestamp: u32,
+    ) -> Arc<AudioFrame> {
+        let mut arc = pool.pop().unwrap_or_else(|| {
+            Arc::new(AudioFrame::new(
+                vec![0; total.len()],
+                self.config.output_sample_rate,
+                self.config.output_channels,
+                timestamp,
+            ))
+        });
+        let frame = Arc::get_mut(&mut arc).expect("pooled frames are uniquely owned");
+        frame.timestamp = timestamp;
+        frame.samples.clear();
+        frame.samples.resize(total.len(), 0);
+
+        if contributors > 0 {
+            let gain = if self.config.overflow_protection {
+                1.0 / contributors as f32
+            } else {
+                1.0
+            };
+            simd::mix_down_i16(total, exclude, gain, &mut frame.samples);
+            MixingAlgorithms::post_process(frame, &self.config);
         }
+        arc
+    }
 
-        // Mix the audio frames using the configured algorithm
-        let mixed_frame = match self.config.mixing_quality {
-            MixingQuality::Fast => MixingAlgorithms::fast_mix(&other_frames, &self.config)?,
-            MixingQuality::Balanced => MixingAlgorithms::balanced_mix(&other_frames, &self.config)?,
-            MixingQuality::High => MixingAlgorithms::high_quality_mix(&other_frames, &self.config)?,
-        };
+    /// Point every participant's cache entry at the mix they hear this
+    /// cycle; participants with nothing to hear are removed.
+    fn publish(&self, inputs: &[MixInput], cycle: &MixCycle) {
+        for input in inputs {
+            match cycle.mix_for(&input.participant_id) {
+                Some(mix) => {
+                    // Overwrite in place so steady state does not clone ids.
+                    if let Some(mut entry) = self.output_cache.get_mut(&input.participant_id) {
+                        *entry = Arc::clone(mix);
+                        continue;
+                    }
+                    self.output_cache
+                        .insert(input.participant_id.clone(), Arc::clone(mix));
+                }
+                None => {
+                    self.output_cache.remove(&input.participant_id);
+                }
+            }
+        }
 
-        Ok(Some(mixed_frame))
+        // Participants that went unhealthy keep no stale mix.
+        if self.output_cache.len() > inputs.len() {
+            self.output_cache
+                .retain(|id, _| inputs.iter().any(|input| &input.participant_id == id));
+        }
     }
 
     /// Update mixing statistics
     async fn update_mixing_stats(
         &self,
         start_time: Instant,
-        _participant_count: usize,
-        mixed_outputs: &HashMap<ParticipantId, AudioFrame>,
-    ) -> ConferenceResult<()> {
+        participant_count: usize,
+        unique_mixes: usize,
+    ) {
         let mixing_latency = start_time.elapsed().as_micros() as u64;
 
-        // Get actual active participant count (not just frame count)
-        let actual_active_count = self.stream_manager.get_active_participants()?.len();
-
         {
             let mut stats = self.stats.lock();
             stats.total_mixes += 1;
-            stats.active_participants = actual_active_count; // Use actual count, not frame count
+            // Every healthy participant, not just those with a frame
+            stats.active_participants = participant_count;
             stats.avg_mixing_latency_us = (stats.avg_mixing_latency_us + mixing_latency) / 2;
 
             // Estimate CPU usage based on mixing latency
@@ -288,9 +435,9 @@ impl AudioMixer {
                 * 1_000_000.0;
             stats.cpu_usage = (mixing_latency as f32) / (frame_duration_us as f32);
 
-            // Update memory usage estimate
+            // Update memory usage estimate: one frame per distinct mix
             stats.memory_usage_bytes =
-                mixed_outputs.len() * (self.config.output_samples_per_frame as usize * 2);
+                unique_mixes * (self.config.output_samples_per_frame as usize * 2);
             // i16 samples
         }
 
@@ -304,8 +451,6 @@ impl AudioMixer {
             })
             .await;
         }
-
-        Ok(())
     }
 
     /// Get current mixing statistics
@@ -366,84 +511,22 @@ impl AudioMixer {
 }
 
 impl MixingAlgorithms {
-    /// Fast mixing algorithm - simple additive mixing
-    fn fast_mix(
-        frames: &[&AudioFrame],
-        config: &ConferenceMixingConfig,
-    ) -> ConferenceResult<AudioFrame> {
-        if frames.is_empty() {
-            return Err(ConferenceError::MixingFailed {
-                reason: "No frames to mix".to_string(),
-            });
+    /// Quality-dependent processing of a finished mix: AGC for
+    /// `Balanced` and up, plus noise reduction for `High`
+    fn post_process(frame: &mut AudioFrame, config: &ConferenceMixingConfig) {
+        if config.mixing_quality == MixingQuality::Fast {
+            return;
         }
-
-        let first_frame = frames[0];
-        let mut mixed_samples = vec![0i32; first_frame.samples.len()];
-
-        // Simple additive mixing
-        for frame in frames {
-            for (i, &sample) in frame.samples.iter().enumerate() {
-                mixed_samples[i] += sample as i32;
-            }
-        }
-
-        // Apply overflow protection if enabled
-        let final_samples: Vec<i16> = if config.overflow_protection {
-            let participant_count = frames.len() as i32;
-            mixed_samples
-                .iter()
-                .map(|&sample| {
-                    let normalized = sample / participant_count;
-                    normalized.clamp(-32768, 32767) as i16
-                })
-                .collect()
-        } else {
-            mixed_samples
-                .iter()
-                .map(|&sample| sample.clamp(-32768, 32767) as i16)
-                .collect()
-        };
-
-        Ok(AudioFrame::new(
-            final_samples,
-            config.output_sample_rate,
-            config.output_channels,
-            first_frame.timestamp,
-        ))
-    }
-
-    /// Balanced mixing algorithm - additive with AGC
-    fn balanced_mix(
-        frames: &[&AudioFrame],
-        config: &ConferenceMixingConfig,
-    ) -> ConferenceResult<AudioFrame> {
-        let mut mixed_frame = Self::fast_mix(frames, config)?;
-
-        // Apply automatic gain control if enabled
         if config.enable_automatic_gain_control {
-            Self::apply_agc(&mut mixed_frame)?;
+            Self::apply_agc(frame);
         }
-
-        Ok(mixed_frame)
-    }
-
-    /// High quality mixing algorithm - balanced with noise reduction
-    fn high_quality_mix(
-        frames: &[&AudioFrame],
-        config: &ConferenceMixingConfig,
-    ) -> ConferenceResult<AudioFrame> {
-        let mut mixed_frame = Self::balanced_mix(frames, config)?;
-
-        // Apply noise reduction if enabled
-        if config.enable_noise_reduction {
-            Self::apply_noise_reduction(&mut mixed_frame)?;
+        if config.mixing_quality == MixingQuality::High && config.enable_noise_reduction {
+            Self::apply_noise_reduction(frame);
         }
-
-        Ok(mixed_frame)
     }
 
     /// Apply automatic gain control to mixed audio
-    fn apply_agc(frame: &mut AudioFrame) -> ConferenceResult<()> {
+    fn apply_agc(frame: &mut AudioFrame) {
         // Calculate RMS level
         let rms = Self::calculate_rms(&frame.samples);
         let target_level = 8000.0; // Target RMS level for -20dB
@@ -456,12 +539,10 @@ impl MixingAlgorithms {
                 *sample = ((*sample as f32) * gain).clamp(-32768.0, 32767.0) as i16;
             }
         }
-
-        Ok(())
     }
 
     /// Apply basic noise reduction
-    fn apply_noise_reduction(frame: &mut AudioFrame) -> ConferenceResult<()> {
+    fn apply_noise_reduction(frame: &mut AudioFrame) {
         // Simple noise gate - mute samples below threshold
         let threshold = 500; // Noise gate threshold
 
@@ -470,8 +551,6 @@ impl MixingAlgorithms {
                 *sample = 0;
             }
         }
-
-        Ok(())
     }
 
     /// Calculate RMS (Root Mean Square) of audio samples
@@ -485,3 +564,113 @@ impl MixingAlgorithms {
         (sum_squares / samples.len() as f64).sqrt() as f32
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    /// Mixer with raw sums (no AGC, no scaling) so mixes can be checked
+    /// exactly, and `levels.len()` participants whose frames are constant
+    /// at the given levels
+    async fn mixer_with(levels: &[i16]) -> (AudioMixer, Vec<ParticipantId>) {
+        let config = ConferenceMixingConfig {
+            enable_voice_activity_mixing: false,
+            mixing_quality: MixingQuality::Fast,
+            overflow_protection: false,
+            ..ConferenceMixingConfig::default()
+        };
+        let mixer = AudioMixer::new(config).await.unwrap();
+        let mut ids = Vec::new();
+        for (i, _) in levels.iter().enumerate() {
+            let id = ParticipantId::new(format!("p{}", i));
+            mixer
+                .add_audio_stream(id.clone(), AudioStream::new(id.clone(), 8000, 1))
+                .await
+                .unwrap();
+            ids.push(id);
+        }
+        feed(&mixer, &ids, levels).await;
+        (mixer, ids)
+    }
+
+    async fn feed(mixer: &AudioMixer, ids: &[ParticipantId], levels: &[i16]) {
+        for (id, &level) in ids.iter().zip(levels) {
+            let frame = AudioFrame::new(vec![level; 160], 8000, 1, 0);
+            mixer.process_audio_frame(id, frame).await.unwrap();
+        }
+    }
+
+    fn level(frame: &AudioFrame) -> i16 {
+        assert_eq!(frame.samples.len(), 160);
+        assert!(frame.samples.iter().all(|&s| s == frame.samples[0]));
+        frame.samples[0]
+    }
+
+    #[tokio::test]
+    async fn test_top_speakers_and_n_minus_one_by_subtraction() {
+        let (mixer, ids) = mixer_with(&[100, 400, 300, 200, 50]).await;
+        let cycle = mixer.mix_cycle().await.unwrap();
+
+        // Loudest three, loudest first, each hearing the other two.
+        let speakers: Vec<_> = cycle.speakers.iter().map(|(id, _)| id.clone()).collect();
+        assert_eq!(
+            speakers,
+            vec![ids[1].clone(), ids[2].clone(), ids[3].clone()]
+        );
+        let heard: Vec<_> = cycle.speakers.iter().map(|(_, f)| level(f)).collect();
+        assert_eq!(heard, vec![500, 600, 700]);
+
+        // Everyone else shares the full speaker mix.
+        assert_eq!(level(cycle.common.as_ref().unwrap()), 900);
+        assert_eq!(cycle.unique_mixes(), 4);
+        let a = mixer.get_shared_mixed_audio(&ids[0]).unwrap();
+        let b = mixer.get_shared_mixed_audio(&ids[4]).unwrap();
+        assert!(Arc::ptr_eq(&a, &b));
+        assert_eq!(
+            level(&mixer.get_mixed_audio(&ids[2]).await.unwrap().unwrap()),
+            600
+        );
+    }
+
+    #[tokio::test]
+    async fn test_mix_saturates() {
+        let (mixer, ids) = mixer_with(&[30000, 20000, 0]).await;
+        let cycle = mixer.mix_cycle().await.unwrap();
+        assert_eq!(level(cycle.mix_for(&ids[2]).unwrap()), i16::MAX);
+    }
+
+    #[tokio::test]
+    async fn test_lone_speaker_hears_silence() {
+        let (mixer, ids) = mixer_with(&[1000, 0]).await;
+        mixer.mix_cycle().await.unwrap();
+
+        // Only p0 has audio this cycle; p1 still gets a mix.
+        feed(&mixer, &ids[..1], &[1000]).await;
+        let mixes = mixer.mix_participants(&[]).await.unwrap();
+        assert_eq!(level(&mixes[&ids[0]]), 0);
+        assert_eq!(level(&mixes[&ids[1]]), 1000);
+    }
+
+    #[tokio::test]
+    async fn test_output_frames_are_recycled() {
+        let levels = [100, 200, 300, 400, 500];
+        let (mixer, ids) = mixer_with(&levels).await;
+        let first: Vec<*const AudioFrame> = {
+            let cycle = mixer.mix_cycle().await.unwrap();
+            let mut frames: Vec<_> = cycle.speakers.iter().map(|(_, f)| Arc::as_ptr(f)).collect();
+            frames.extend(cycle.common.as_ref().map(Arc::as_ptr));
+            frames
+        };
+
+        // The second cycle releases the first cycle's frames; the third
+        // reuses them.
+        feed(&mixer, &ids, &levels).await;
+        mixer.mix_cycle().await.unwrap();
+        feed(&mixer, &ids, &levels).await;
+        let third = mixer.mix_cycle().await.unwrap();
+        for (_, frame) in &third.speakers {
+            assert!(first.contains(&Arc::as_ptr(frame)));
+        }
+        assert!(first.contains(&Arc::as_ptr(third.common.as_ref().unwrap())));
+    }
+}
@@ -23,9 +23,9 @@ pub mod vad_v2; // Advanced VAD with spectral features // Frequency-domain AEC w
 // Re-export main types
 pub use aec::{AcousticEchoCanceller, AecConfig, AecResult};
 pub use agc::{AgcConfig, AgcResult, AutomaticGainControl};
-pub use mixer::AudioMixer;
+pub use mixer::{AudioMixer, MixCycle};
 pub use processor::{AudioProcessingConfig, AudioProcessingResult, AudioProcessor};
-pub use stream::{AudioStreamConfig, AudioStreamManager};
+pub use stream::{AudioStreamConfig, AudioStreamManager, MixInput};
 pub use vad::{VadConfig, VadResult, VoiceActivityDetector};
 
 // Re-export advanced v2 types
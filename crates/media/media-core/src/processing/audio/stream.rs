@@ -4,14 +4,15 @@
 //! audio mixing. It handles individual participant audio streams, synchronization,
 //! format conversion, and health monitoring.
 
-use crate::processing::audio::VoiceActivityDetector;
+use crate::performance::simd::SimdProcessor;
+use crate::processing::audio::{VadConfig, VoiceActivityDetector};
 use crate::processing::format::FormatConverter;
 use crate::types::conference::{AudioStream, ConferenceError, ConferenceResult, ParticipantId};
 use crate::types::{AudioFrame, SampleRate};
+use parking_lot::Mutex;
 use std::collections::VecDeque;
 use std::sync::Arc;
 use std::time::{Duration, Instant};
-use tokio::sync::Mutex;
 
 /// Manager for audio streams from conference participants
 pub struct AudioStreamManager {
@@ -28,9 +29,6 @@ pub struct AudioStreamManager {
     #[allow(dead_code)]
     format_converter: Arc<FormatConverter>,
 
-    /// Voice activity detector for stream optimization
-    vad: Arc<Mutex<VoiceActivityDetector>>,
-
     /// Configuration
     config: AudioStreamConfig,
 }
@@ -51,6 +49,34 @@ struct ManagedAudioStream {
 
     /// Processing statistics
     stats: StreamStats,
+
+    /// This participant's voice activity detector (`None` when VAD is
+    /// disabled). Per stream, since the detector tracks the stream's noise
+    /// floor and hangover.
+    vad: Option<VoiceActivityDetector>,
+
+    /// Smoothed speech energy (0.0-1.0), used to rank active speakers
+    speech_level: f32,
+}
+
+/// Weight of the newest frame in [`ManagedAudioStream::speech_level`]
+const SPEECH_LEVEL_ATTACK: f32 = 0.3;
+/// Per-frame decay of the speech level while the VAD reports silence
+const SPEECH_LEVEL_RELEASE: f32 = 0.8;
+
+/// One participant's contribution to a mix cycle, produced by
+/// [`AudioStreamManager::collect_mix_inputs`]
+#[derive(Debug)]
+pub struct MixInput {
+    pub participant_id: ParticipantId,
+    /// Next buffered frame; `None` if the participant is muted or has
+    /// nothing buffered
+    pub frame: Option<AudioFrame>,
+    /// Smoothed speech energy (0.0-1.0)
+    pub speech_level: f32,
+    /// Whether the participant counts as talking (always true when VAD is
+    /// disabled)
+    pub is_talking: bool,
 }
 
 /// Stream synchronization state
@@ -140,26 +166,33 @@ impl AudioStreamManager {
     ) -> ConferenceResult<Self> {
         let format_converter = Arc::new(FormatConverter::new());
 
-        // Create VAD with default config
-        let vad_config = crate::processing::audio::VadConfig::default();
-        let vad =
-            VoiceActivityDetector::new(vad_config).map_err(|e| ConferenceError::MixingFailed {
-                reason: format!("Failed to create VAD: {}", e),
-            })?;
+        // Fail early on a bad VAD configuration rather than on the first
+        // add_stream.
+        if config.enable_voice_activity_detection {
+            Self::create_vad()?;
+        }
 
         Ok(Self {
             streams: Arc::new(Mutex::new(std::collections::HashMap::new())),
             target_sample_rate,
             target_channels,
             format_converter,
-            vad: Arc::new(Mutex::new(vad)),
             config,
         })
     }
 
+    /// Create a voice activity detector with default config
+    fn create_vad() -> ConferenceResult<VoiceActivityDetector> {
+        VoiceActivityDetector::new(VadConfig::default()).map_err(|e| {
+            ConferenceError::MixingFailed {
+                reason: format!("Failed to create VAD: {}", e),
+            }
+        })
+    }
+
     /// Add a new participant audio stream
     pub fn add_stream(&self, stream_info: AudioStream) -> ConferenceResult<()> {
-        let streams = async_std::task::block_on(self.streams.lock());
+        let streams = self.streams.lock();
         let mut streams = streams;
 
         if streams.contains_key(&stream_info.participant_id) {
@@ -168,6 +201,12 @@ impl AudioStreamManager {
             });
         }
 
+        let vad = if self.config.enable_voice_activity_detection {
+            Some(Self::create_vad()?)
+        } else {
+            None
+        };
+
         let managed_stream = ManagedAudioStream {
             stream_info,
             frame_buffer: VecDeque::new(),
@@ -179,6 +218,8 @@ impl AudioStreamManager {
                 sync_quality: 1.0,
             },
             stats: StreamStats::default(),
+            vad,
+            speech_level: 0.0,
         };
 
         streams.insert(
@@ -190,7 +231,7 @@ impl AudioStreamManager {
 
     /// Remove a participant audio stream
     pub fn remove_stream(&self, participant_id: &ParticipantId) -> ConferenceResult<()> {
-        let mut streams = async_std::task::block_on(self.streams.lock());
+        let mut streams = self.streams.lock();
 
         streams
             .remove(participant_id)
@@ -207,7 +248,7 @@ impl AudioStreamManager {
         participant_id: &ParticipantId,
         mut frame: AudioFrame,
     ) -> ConferenceResult<()> {
-        let mut streams = async_std::task::block_on(self.streams.lock());
+        let mut streams = self.streams.lock();
 
         let managed_stream = streams.get_mut(participant_id).ok_or_else(|| {
             ConferenceError::ParticipantNotFound {
@@ -222,8 +263,7 @@ impl AudioStreamManager {
         managed_stream.stream_info.update_frame_received();
 
         // Voice activity detection if enabled
-        if self.config.enable_voice_activity_detection {
-            let mut vad = async_std::task::block_on(self.vad.lock());
+        if let Some(vad) = managed_stream.vad.as_mut() {
             let vad_result =
                 vad.analyze_frame(&frame)
                     .unwrap_or(crate::processing::audio::VadResult {
@@ -243,6 +283,15 @@ impl AudioStreamManager {
                 talking_frames
             };
             managed_stream.stats.voice_activity_ratio = new_talking_frames / (total_frames + 1.0);
+
+            managed_stream.speech_level = if vad_result.is_voice {
+                smooth_level(managed_stream.speech_level, vad_result.energy_level)
+            } else {
+                managed_stream.speech_level * SPEECH_LEVEL_RELEASE
+            };
+        } else {
+            let energy = SimdProcessor::new().calculate_rms(&frame.samples) / 32768.0;
+            managed_stream.speech_level = smooth_level(managed_stream.speech_level, energy);
         }
 
         // Format conversion if needed
@@ -281,7 +330,7 @@ impl AudioStreamManager {
 
     /// Get synchronized audio frames for all active participants
     pub fn get_synchronized_frames(&self) -> ConferenceResult<Vec<(ParticipantId, AudioFrame)>> {
-        let mut streams = async_std::task::block_on(self.streams.lock());
+        let mut streams = self.streams.lock();
 
         let mut frames = Vec::new();
         let _now = Instant::now();
@@ -318,12 +367,67 @@ impl AudioStreamManager {
         Ok(frames)
     }
 
+    /// Pop the next frame of every healthy participant into `inputs`
+    /// (cleared first), together with its speech level and talking state.
+    ///
+    /// Unlike [`get_synchronized_frames`](Self::get_synchronized_frames),
+    /// silent participants are included so their buffers keep draining and
+    /// they still receive a mix; muted participants contribute no frame.
+    /// `inputs` is caller-owned so a mixer can reuse it across cycles; while
+    /// the set of participants is unchanged no ids are cloned.
+    pub fn collect_mix_inputs(&self, inputs: &mut Vec<MixInput>) -> ConferenceResult<()> {
+        let mut streams = self.streams.lock();
+        let mut count = 0;
+
+        for (participant_id, managed_stream) in streams.iter_mut() {
+            if !managed_stream
+                .stream_info
+                .is_healthy(self.config.stream_timeout)
+            {
+                continue;
+            }
+
+            let frame = managed_stream.frame_buffer.pop_front();
+            managed_stream.stats.buffer_depth = managed_stream.frame_buffer.len();
+            let muted = managed_stream.stream_info.is_muted;
+            let frame = frame.filter(|_| !muted);
+            let speech_level = managed_stream.speech_level;
+            let is_talking = !muted
+                && (managed_stream.vad.is_none()
+                    || managed_stream.stream_info.is_effectively_talking());
+
+            match inputs.get_mut(count) {
+                Some(input) if input.participant_id == *participant_id => {
+                    input.frame = frame;
+                    input.speech_level = speech_level;
+                    input.is_talking = is_talking;
+                }
+                slot => {
+                    let input = MixInput {
+                        participant_id: participant_id.clone(),
+                        frame,
+                        speech_level,
+                        is_talking,
+                    };
+                    match slot {
+                        Some(slot) => *slot = input,
+                        None => inputs.push(input),
+                    }
+                }
+            }
+            count += 1;
+        }
+        inputs.truncate(count);
+
+        Ok(())
+    }
+
     /// Get stream statistics for monitoring
     pub fn get_stream_stats(
         &self,
         participant_id: &ParticipantId,
     ) -> ConferenceResult<StreamStats> {
-        let streams = async_std::task::block_on(self.streams.lock());
+        let streams = self.streams.lock();
 
         let managed_stream =
             streams
@@ -337,7 +441,7 @@ impl AudioStreamManager {
 
     /// Get list of active participants
     pub fn get_active_participants(&self) -> ConferenceResult<Vec<ParticipantId>> {
-        let streams = async_std::task::block_on(self.streams.lock());
+        let streams = self.streams.lock();
 
         let _now = Instant::now();
         let active_participants: Vec<ParticipantId> = streams
@@ -402,7 +506,7 @@ impl AudioStreamManager {
 
     /// Clean up inactive streams
     pub fn cleanup_inactive_streams(&self) -> ConferenceResult<Vec<ParticipantId>> {
-        let mut streams = async_std::task::block_on(self.streams.lock());
+        let mut streams = self.streams.lock();
 
         let timeout = self.config.stream_timeout;
         let mut removed_participants = Vec::new();
@@ -419,3 +523,8 @@ impl AudioStreamManager {
         Ok(removed_participants)
     }
 }
+
+/// Exponentially smoothed speech level
+fn smooth_level(level: f32, energy: f32) -> f32 {
+    level + SPEECH_LEVEL_ATTACK * (energy - level)
+}
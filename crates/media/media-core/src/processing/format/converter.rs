@@ -4,7 +4,7 @@
 //! sample rate conversion, channel layout changes, and bit depth conversion.
 
 use super::channel_mixer::{ChannelLayout, ChannelMixer};
-use super::resampler::Resampler;
+use super::polyphase::PolyphaseResampler;
 use crate::error::{AudioProcessingError, Result};
 use crate::types::{AudioFrame, SampleRate};
 use tracing::debug;
@@ -77,7 +77,7 @@ pub struct ConversionMetrics {
 /// Audio format converter
 pub struct FormatConverter {
     /// Resampler for sample rate conversion
-    resampler: Option<Resampler>,
+    resampler: Option<PolyphaseResampler>,
     /// Channel mixer for channel layout conversion
     channel_mixer: ChannelMixer,
     /// Current conversion parameters
@@ -197,7 +197,7 @@ impl FormatConverter {
         };
 
         if needs_update {
-            self.resampler = Some(Resampler::new(
+            self.resampler = Some(PolyphaseResampler::new(
                 input_sample_rate,
                 target_rate,
                 params.quality,
@@ -5,9 +5,11 @@
 
 pub mod channel_mixer;
 pub mod converter;
+pub mod polyphase;
 pub mod resampler;
 
 // Re-export main types
 pub use channel_mixer::{ChannelLayout, ChannelMixer};
 pub use converter::{ConversionParams, ConversionResult, FormatConverter};
+pub use polyphase::PolyphaseResampler;
 pub use resampler::{Resampler, ResamplerConfig};
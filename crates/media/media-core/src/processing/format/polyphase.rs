@@ -0,0 +1,545 @@
+//! Polyphase Resampler - windowed-sinc sample rate conversion
+//!
+//! Converts by the reduced rational ratio `L/M` (`L = out / gcd`,
+//! `M = in / gcd`) with a Kaiser-windowed sinc prototype split into `L`
+//! phases of `taps_per_phase` coefficients. Each output sample is a single
+//! dot product of one phase against the most recent input samples, so the
+//! cost is `taps_per_phase` multiply-adds per output sample regardless of
+//! direction, and the same filter both interpolates (no imaging) and
+//! band-limits (no aliasing).
+//!
+//! Filter banks depend only on `(L, M, quality tier)` and are built once per
+//! process, then shared through an `Arc` by every resampler that needs them —
+//! a thousand 8 kHz ↔ 48 kHz bridge legs hold one bank, not a thousand.
+//!
+//! The dot product runs on AVX2+FMA or SSE2 on x86_64 and NEON on aarch64,
+//! picked once at construction, with a scalar fallback elsewhere.
+//!
+//! Like [`Resampler`](super::Resampler), this operates on a single (mono)
+//! stream; de-interleave multi-channel audio first.
+
+use super::resampler::ResamplerConfig;
+use crate::error::{AudioProcessingError, Result};
+use dashmap::DashMap;
+use once_cell::sync::Lazy;
+use std::sync::Arc;
+use tracing::debug;
+
+/// Upper bound on prototype filter length; protects against pathological
+/// rate pairs (e.g. 44099 → 48000) that reduce to enormous phase counts.
+const MAX_PROTOTYPE_TAPS: usize = 1 << 20;
+
+/// Banks shared process-wide, keyed by reduced ratio and quality tier.
+static FILTER_BANKS: Lazy<DashMap<BankKey, Arc<FilterBank>>> = Lazy::new(DashMap::new);
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+struct BankKey {
+    up: usize,
+    down: usize,
+    tier: usize,
+}
+
+/// Filter design per quality tier: (taps spanning one lower-rate sample
+/// period each, stopband attenuation in dB).
+const TIERS: [(usize, f64); 3] = [
+    (24, 60.0),  // quality 0-3
+    (40, 80.0),  // quality 4-7
+    (80, 100.0), // quality 8-10
+];
+
+fn tier_for_quality(quality: u8) -> usize {
+    match quality {
+        0..=3 => 0,
+        4..=7 => 1,
+        _ => 2,
+    }
+}
+
+/// Precomputed polyphase coefficients for one `(L, M, tier)`.
+#[derive(Debug)]
+struct FilterBank {
+    /// Interpolation factor `L` (number of phases)
+    up: usize,
+    /// Decimation factor `M`
+    down: usize,
+    /// Coefficients per phase (a multiple of 8 for the SIMD kernels)
+    taps: usize,
+    /// `up * taps` coefficients; each phase is stored time-reversed so it
+    /// lines up with ascending input samples.
+    coeffs: Vec<f32>,
+}
+
+impl FilterBank {
+    fn design(up: usize, down: usize, tier: usize) -> Option<Self> {
+        let (base_taps, attenuation_db) = TIERS[tier];
+        let span = up.max(down);
+
+        // Taps per phase cover `base_taps` periods of the lower of the two
+        // rates, rounded up so every phase is a whole number of SIMD lanes.
+        let taps = (base_taps * span).div_ceil(up).next_multiple_of(8);
+        let len = up * taps;
+        if len > MAX_PROTOTYPE_TAPS {
+            return None;
+        }
+
+        // Kaiser design: place the transition band just below the lower
+        // Nyquist so full attenuation is reached at it.
+        let beta = 0.1102 * (attenuation_db - 8.7);
+        let effective_taps = len as f64 / span as f64;
+        let transition =
+            (attenuation_db - 8.0) / (2.285 * 2.0 * std::f64::consts::PI * effective_taps);
+        let cutoff = (0.5 - transition / 2.0) / span as f64; // cycles per upsampled sample
+
+        let centre = (len - 1) as f64 / 2.0;
+        let i0_beta = bessel_i0(beta);
+        let prototype: Vec<f64> = (0..len)
+            .map(|j| {
+                let t = j as f64 - centre;
+                let ratio = t / centre.max(1.0);
+                let window = bessel_i0(beta * (1.0 - ratio * ratio).max(0.0).sqrt()) / i0_beta;
+                2.0 * cutoff * sinc(2.0 * cutoff * t) * window
+            })
+            .collect();
+
+        // Split into phases; normalise each to unity DC gain so every
+        // output phase passes the same level.
+        let mut coeffs = vec![0f32; len];
+        for phase in 0..up {
+            let sum: f64 = (0..taps).map(|k| prototype[phase + k * up]).sum();
+            let row = &mut coeffs[phase * taps..(phase + 1) * taps];
+            for k in 0..taps {
+                row[taps - 1 - k] = (prototype[phase + k * up] / sum) as f32;
+            }
+        }
+
+        Some(Self {
+            up,
+            down,
+            taps,
+            coeffs,
+        })
+    }
+
+    #[inline]
+    fn phase(&self, phase: usize) -> &[f32] {
+        &self.coeffs[phase * self.taps..(phase + 1) * self.taps]
+    }
+}
+
+fn sinc(x: f64) -> f64 {
+    if x == 0.0 {
+        1.0
+    } else {
+        let px = std::f64::consts::PI * x;
+        px.sin() / px
+    }
+}
+
+/// Zeroth-order modified Bessel function of the first kind (power series).
+fn bessel_i0(x: f64) -> f64 {
+    let half = x / 2.0;
+    let mut term = 1.0;
+    let mut sum = 1.0;
+    for k in 1..64 {
+        term *= (half / k as f64).powi(2);
+        sum += term;
+        if term < sum * 1e-12 {
+            break;
+        }
+    }
+    sum
+}
+
+fn gcd(mut a: u32, mut b: u32) -> u32 {
+    while b != 0 {
+        (a, b) = (b, a % b);
+    }
+    a
+}
+
+/// Look up (or build) the shared bank for a rate pair and quality.
+fn shared_bank(input_rate: u32, output_rate: u32, quality: u8) -> Option<Arc<FilterBank>> {
+    let g = gcd(input_rate, output_rate);
+    let key = BankKey {
+        up: (output_rate / g) as usize,
+        down: (input_rate / g) as usize,
+        tier: tier_for_quality(quality),
+    };
+    if let Some(bank) = FILTER_BANKS.get(&key) {
+        return Some(bank.clone());
+    }
+    let bank = Arc::new(FilterBank::design(key.up, key.down, key.tier)?);
+    Some(FILTER_BANKS.entry(key).or_insert(bank).clone())
+}
+
+type DotFn = fn(&[f32], &[f32]) -> f32;
+
+/// Polyphase windowed-sinc resampler
+pub struct PolyphaseResampler {
+    /// Resampler configuration
+    config: ResamplerConfig,
+    /// Shared coefficient bank
+    bank: Arc<FilterBank>,
+    /// Dot-product kernel chosen for this CPU
+    dot: DotFn,
+    /// Last `taps - 1` input samples followed by the frame being processed
+    history: Vec<f32>,
+    /// Input index (relative to the current frame) of the next output
+    index: usize,
+    /// Phase of the next output
+    phase: usize,
+}
+
+impl PolyphaseResampler {
+    /// Create a new polyphase resampler
+    pub fn new(input_rate: u32, output_rate: u32, quality: u8) -> Result<Self> {
+        let failed = || AudioProcessingError::ResamplingFailed {
+            from_rate: input_rate,
+            to_rate: output_rate,
+        };
+        if input_rate == 0 || output_rate == 0 {
+            return Err(failed().into());
+        }
+
+        let quality = quality.min(10);
+        let bank = shared_bank(input_rate, output_rate, quality).ok_or_else(failed)?;
+
+        debug!(
+            "Creating polyphase resampler: {}Hz -> {}Hz ({}/{} phases, {} taps/phase)",
+            input_rate, output_rate, bank.up, bank.down, bank.taps
+        );
+
+        Ok(Self {
+            config: ResamplerConfig {
+                input_rate,
+                output_rate,
+                quality,
+            },
+            history: vec![0.0; bank.taps - 1],
+            bank,
+            dot: select_dot(),
+            index: 0,
+            phase: 0,
+        })
+    }
+
+    /// Resample audio samples.
+    ///
+    /// Produces one output per `M/L` input step carried across calls, so
+    /// 10/20 ms frames at the telephony rates always map to whole frames
+    /// (160 @ 8 kHz ↔ 960 @ 48 kHz).
+    pub fn resample(&mut self, input_samples: &[i16]) -> Result<Vec<i16>> {
+        let mut output = Vec::with_capacity(self.output_len_hint(input_samples.len()));
+        self.resample_into(input_samples, &mut output);
+        Ok(output)
+    }
+
+    /// Resample, appending to `output` (no allocation once `output` has
+    /// capacity).
+    pub fn resample_into(&mut self, input_samples: &[i16], output: &mut Vec<i16>) {
+        if input_samples.is_empty() {
+            return;
+        }
+
+        let bank = &*self.bank;
+        let taps = bank.taps;
+        self.history.extend(input_samples.iter().map(|&s| s as f32));
+
+        let step = bank.down / bank.up;
+        let step_phase = bank.down % bank.up;
+        let frame_len = input_samples.len();
+        output.reserve(self.output_len_hint(frame_len));
+
+        while self.index < frame_len {
+            let window = &self.history[self.index..self.index + taps];
+            let y = (self.dot)(bank.phase(self.phase), window);
+            output.push(y.round().clamp(i16::MIN as f32, i16::MAX as f32) as i16);
+
+            self.index += step;
+            self.phase += step_phase;
+            if self.phase >= bank.up {
+                self.phase -= bank.up;
+                self.index += 1;
+            }
+        }
+
+        self.index -= frame_len;
+        self.history.drain(..frame_len);
+    }
+
+    /// Reset resampler state
+    pub fn reset(&mut self) {
+        self.history.clear();
+        self.history.resize(self.bank.taps - 1, 0.0);
+        self.index = 0;
+        self.phase = 0;
+        debug!("Polyphase resampler reset");
+    }
+
+    /// Get conversion ratio
+    pub fn ratio(&self) -> f64 {
+        self.config.output_rate as f64 / self.config.input_rate as f64
+    }
+
+    /// Get configuration
+    pub fn config(&self) -> &ResamplerConfig {
+        &self.config
+    }
+
+    /// Coefficients applied per output sample
+    pub fn taps_per_phase(&self) -> usize {
+        self.bank.taps
+    }
+
+    /// Filter group delay, in output samples
+    pub fn latency_samples(&self) -> usize {
+        let half_len = (self.bank.up * self.bank.taps - 1) as f64 / 2.0;
+        (half_len / self.bank.down as f64).round() as usize
+    }
+
+    fn output_len_hint(&self, input_len: usize) -> usize {
+        (input_len * self.bank.up).div_ceil(self.bank.down) + 1
+    }
+}
+
+fn select_dot() -> DotFn {
+    #[cfg(target_arch = "x86_64")]
+    {
+        if is_x86_feature_detected!("avx2") && is_x86_feature_detected!("fma") {
+            return dot_avx2;
+        }
+        dot_sse2
+    }
+
+    #[cfg(target_arch = "aarch64")]
+    {
+        dot_neon
+    }
+
+    #[cfg(not(any(target_arch = "x86_64", target_arch = "aarch64")))]
+    {
+        dot_scalar
+    }
+}
+
+/// Portable dot product (four accumulators so the compiler can pipeline).
+#[cfg_attr(any(target_arch = "x86_64", target_arch = "aarch64"), allow(dead_code))]
+fn dot_scalar(coeffs: &[f32], samples: &[f32]) -> f32 {
+    let mut acc = [0f32; 4];
+    for (c, s) in coeffs.chunks_exact(4).zip(samples.chunks_exact(4)) {
+        for lane in 0..4 {
+            acc[lane] += c[lane] * s[lane];
+        }
+    }
+    (acc[0] + acc[1]) + (acc[2] + acc[3])
+}
+
+#[cfg(target_arch = "x86_64")]
+fn dot_sse2(coeffs: &[f32], samples: &[f32]) -> f32 {
+    use std::arch::x86_64::*;
+    assert!(samples.len() >= coeffs.len() && coeffs.len() % 8 == 0);
+    // SAFETY: SSE2 is part of the x86_64 baseline; loads stay within the
+    // asserted bounds.
+    unsafe {
+        let mut acc0 = _mm_setzero_ps();
+        let mut acc1 = _mm_setzero_ps();
+        let (c, s) = (coeffs.as_ptr(), samples.as_ptr());
+        for i in (0..coeffs.len()).step_by(8) {
+            acc0 = _mm_add_ps(
+                acc0,
+                _mm_mul_ps(_mm_loadu_ps(c.add(i)), _mm_loadu_ps(s.add(i))),
+            );
+            acc1 = _mm_add_ps(
+                acc1,
+                _mm_mul_ps(_mm_loadu_ps(c.add(i + 4)), _mm_loadu_ps(s.add(i + 4))),
+            );
+        }
+        let acc = _mm_add_ps(acc0, acc1);
+        let hi = _mm_movehl_ps(acc, acc);
+        let sum2 = _mm_add_ps(acc, hi);
+        let sum1 = _mm_add_ss(sum2, _mm_shuffle_ps(sum2, sum2, 0b01));
+        _mm_cvtss_f32(sum1)
+    }
+}
+
+#[cfg(target_arch = "x86_64")]
+fn dot_avx2(coeffs: &[f32], samples: &[f32]) -> f32 {
+    assert!(samples.len() >= coeffs.len() && coeffs.len() % 8 == 0);
+    // SAFETY: only selected after runtime detection of AVX2 and FMA.
+    unsafe { dot_avx2_fma(coeffs, samples) }
+}
+
+#[cfg(target_arch = "x86_64")]
+#[target_feature(enable = "avx2,fma")]
+unsafe fn dot_avx2_fma(coeffs: &[f32], samples: &[f32]) -> f32 {
+    use std::arch::x86_64::*;
+    let len = coeffs.len();
+    let (c, s) = (coeffs.as_ptr(), samples.as_ptr());
+    let mut acc0 = _mm256_setzero_ps();
+    let mut acc1 = _mm256_setzero_ps();
+    let mut i = 0;
+    while i + 16 <= len {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(c.add(i)), _mm256_loadu_ps(s.add(i)), acc0);
+        acc1 = _mm256_fmadd_ps(
+            _mm256_loadu_ps(c.add(i + 8)),
+            _mm256_loadu_ps(s.add(i + 8)),
+            acc1,
+        );
+        i += 16;
+    }
+    if i < len {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(c.add(i)), _mm256_loadu_ps(s.add(i)), acc0);
+    }
+    let acc = _mm256_add_ps(acc0, acc1);
+    let quad = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    let pair = _mm_add_ps(quad, _mm_movehl_ps(quad, quad));
+    _mm_cvtss_f32(_mm_add_ss(pair, _mm_shuffle_ps(pair, pair, 0b01)))
+}
+
+#[cfg(target_arch = "aarch64")]
+fn dot_neon(coeffs: &[f32], samples: &[f32]) -> f32 {
+    use std::arch::aarch64::*;
+    assert!(samples.len() >= coeffs.len() && coeffs.len() % 8 == 0);
+    // SAFETY: NEON is part of the aarch64 baseline; loads stay within the
+    // asserted bounds.
+    unsafe {
+        let mut acc0 = vdupq_n_f32(0.0);
+        let mut acc1 = vdupq_n_f32(0.0);
+        let (c, s) = (coeffs.as_ptr(), samples.as_ptr());
+        for i in (0..coeffs.len()).step_by(8) {
+            acc0 = vfmaq_f32(acc0, vld1q_f32(c.add(i)), vld1q_f32(s.add(i)));
+            acc1 = vfmaq_f32(acc1, vld1q_f32(c.add(i + 4)), vld1q_f32(s.add(i + 4)));
+        }
+        vaddvq_f32(vaddq_f32(acc0, acc1))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn sine(freq: f64, rate: f64, len: usize, amp: f64) -> Vec<i16> {
+        (0..len)
+            .map(|i| (amp * (2.0 * std::f64::consts::PI * freq * i as f64 / rate).sin()) as i16)
+            .collect()
+    }
+
+    fn rms(samples: &[i16]) -> f64 {
+        (samples.iter().map(|&s| (s as f64).powi(2)).sum::<f64>() / samples.len() as f64).sqrt()
+    }
+
+    #[test]
+    fn test_rejects_zero_rates() {
+        assert!(PolyphaseResampler::new(0, 8000, 5).is_err());
+        assert!(PolyphaseResampler::new(8000, 0, 5).is_err());
+    }
+
+    #[test]
+    fn test_frame_lengths_for_telephony_rates() {
+        for (from, to) in [
+            (8000, 16000),
+            (16000, 8000),
+            (8000, 48000),
+            (48000, 8000),
+            (16000, 48000),
+            (48000, 16000),
+            (44100, 48000),
+        ] {
+            let mut rs = PolyphaseResampler::new(from, to, 5).unwrap();
+            let input = vec![0i16; (from / 50) as usize];
+            for _ in 0..5 {
+                assert_eq!(
+                    rs.resample(&input).unwrap().len(),
+                    (to / 50) as usize,
+                    "{from} -> {to}"
+                );
+            }
+        }
+    }
+
+    #[test]
+    fn test_filter_banks_are_shared() {
+        let a = PolyphaseResampler::new(8000, 48000, 5).unwrap();
+        let b = PolyphaseResampler::new(8000, 48000, 6).unwrap();
+        // 16k -> 96k reduces to the same 6/1 ratio.
+        let c = PolyphaseResampler::new(16000, 96000, 4).unwrap();
+        let d = PolyphaseResampler::new(8000, 48000, 9).unwrap();
+        assert!(Arc::ptr_eq(&a.bank, &b.bank));
+        assert!(Arc::ptr_eq(&a.bank, &c.bank));
+        assert!(!Arc::ptr_eq(&a.bank, &d.bank));
+    }
+
+    #[test]
+    fn test_chunked_matches_one_shot() {
+        let input = sine(1000.0, 8000.0, 1600, 10_000.0);
+        let mut whole = PolyphaseResampler::new(8000, 48000, 5).unwrap();
+        let expected = whole.resample(&input).unwrap();
+
+        let mut chunked = PolyphaseResampler::new(8000, 48000, 5).unwrap();
+        let mut output = Vec::new();
+        for chunk in input.chunks(37) {
+            chunked.resample_into(chunk, &mut output);
+        }
+        assert_eq!(output, expected);
+    }
+
+    #[test]
+    fn test_tone_preserved_both_directions() {
+        for (from, to) in [(8000u32, 48000u32), (48000, 8000), (8000, 16000)] {
+            let mut rs = PolyphaseResampler::new(from, to, 5).unwrap();
+            let input = sine(1000.0, from as f64, from as usize / 5, 10_000.0);
+            let out = rs.resample(&input).unwrap();
+            let steady = &out[rs.latency_samples() * 2..];
+            let level = rms(steady);
+            assert!(
+                (level - 10_000.0 / 2f64.sqrt()).abs() < 150.0,
+                "{from} -> {to}: rms {level}"
+            );
+        }
+    }
+
+    #[test]
+    fn test_stopband_attenuation_on_downsample() {
+        // 5-20 kHz tones at 48 kHz all lie above the 4 kHz output Nyquist.
+        for freq in [5_000.0, 6_000.0, 9_000.0, 15_000.0, 20_000.0] {
+            let mut rs = PolyphaseResampler::new(48_000, 8_000, 5).unwrap();
+            let out = rs.resample(&sine(freq, 48_000.0, 9_600, 20_000.0)).unwrap();
+            let leaked = rms(&out[rs.latency_samples() * 2..]);
+            let attenuation = 20.0 * (20_000.0 / 2f64.sqrt() / leaked.max(0.5)).log10();
+            assert!(
+                attenuation > 60.0,
+                "{freq} Hz only {attenuation:.1} dB down"
+            );
+        }
+    }
+
+    #[test]
+    fn test_simd_kernel_matches_scalar() {
+        let coeffs: Vec<f32> = (0..200)
+            .map(|i| ((i * 37) % 101) as f32 / 50.0 - 1.0)
+            .collect();
+        let samples: Vec<f32> = (0..200)
+            .map(|i| ((i * 53) % 97) as f32 * 100.0 - 4800.0)
+            .collect();
+        for len in [8, 16, 24, 192] {
+            let expected = dot_scalar(&coeffs[..len], &samples[..len]);
+            let actual = select_dot()(&coeffs[..len], &samples[..len]);
+            assert!(
+                (expected - actual).abs() <= expected.abs() * 1e-5 + 1e-2,
+                "len {len}: {expected} vs {actual}"
+            );
+        }
+    }
+
+    #[test]
+    fn test_reset_clears_history() {
+        let mut rs = PolyphaseResampler::new(16000, 8000, 5).unwrap();
+        let first = rs.resample(&sine(500.0, 16000.0, 320, 8000.0)).unwrap();
+        rs.resample(&vec![12_000i16; 320]).unwrap();
+        rs.reset();
+        assert_eq!(
+            rs.resample(&sine(500.0, 16000.0, 320, 8000.0)).unwrap(),
+            first
+        );
+    }
+}
@@ -7,6 +7,10 @@
 //!
 //! The resampler operates on a single (mono) stream; callers must de-interleave
 //! multi-channel audio first (see `FormatConverter`).
+//!
+//! [`PolyphaseResampler`](super::PolyphaseResampler) is the windowed-sinc
+//! alternative used by `FormatConverter`; this one is kept for callers that
+//! want the cheapest possible interpolation.
 
 use crate::error::{AudioProcessingError, Result};
 use tracing::{debug, warn};
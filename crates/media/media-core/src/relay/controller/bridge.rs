@@ -15,9 +15,27 @@
 //! transparently. RTCP is not bridged — each leg keeps generating its own
 //! reports (RFC 3550 §7.2 compliance).
 //!
+//! Packets move in one of two ways, see [`BridgeForwarding`]. By default
+//! each leg's transport receive loop rewrites the SSRC, sequence number and
+//! timestamp of every inbound packet in place, re-keys SRTP if either leg
+//! uses it, and sends it straight out of the other leg's socket — no
+//! broadcast channel, no task hop, no per-packet allocation. Legs without a
+//! dedicated UDP transport (shared-socket or TCP sessions) fall back to a
+//! forwarder task per direction fed by the session event broadcast.
+//!
+//! On Linux, receive-loop bridges can go one step further: with a kernel
+//! relay set ([`MediaSessionController::set_kernel_relay`]), each
+//! forwarder hands its flow to an XDP program once it has seen the first
+//! packet of a source, and the kernel rewrites and redirects the rest
+//! before they reach a socket. Only plain RTP over IPv4 is offloaded;
+//! SRTP legs, RTCP, telephone-events and anything the kernel cannot route
+//! yet stay on the receive-loop path. Per-bridge counters, kernel ones
+//! included, are read back through
+//! [`MediaSessionController::get_bridge_forward_statistics`].
+//!
 //! The returned [`BridgeHandle`] tears the bridge down on drop: the cancel
-//! gate flips synchronously and partner entries are removed, with forwarder
-//! tasks aborted asynchronously.
+//! gate flips synchronously, partner entries are removed and receive-loop
+//! forwarders are uninstalled, with forwarder tasks aborted asynchronously.
 //!
 //! See `crates/session-core/docs/PRE_B2BUA_ROADMAP.md` Item 2 for the
 //! b2bua use case driving this primitive.
@@ -26,6 +44,10 @@ use std::sync::atomic::{AtomicBool, Ordering};
 use std::sync::Arc;
 
 use dashmap::DashMap;
+use rvoip_rtp_core::transport::RtpForwarder;
+#[cfg(target_os = "linux")]
+use rvoip_rtp_core::transport::XdpRelay;
+use rvoip_rtp_core::{RtpForwardGuard, RtpForwardStats};
 use thiserror::Error;
 use tokio::sync::{broadcast, Mutex};
 use tokio::task::JoinHandle;
@@ -71,17 +93,38 @@ impl From<BridgeError> for Error {
     }
 }
 
+/// How a bridge moves RTP between its two legs.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub enum BridgeForwarding {
+    /// Forward from each leg's transport receive loop, rewriting packets in
+    /// place. Media on a bridged leg no longer reaches that session:
+    /// no `PacketReceived` events, receive statistics or jitter buffering.
+    /// Falls back to [`Self::SessionEvents`] when either leg has no
+    /// dedicated UDP transport.
+    #[default]
+    ReceiveLoop,
+    /// Forward from a task per direction subscribed to the source session's
+    /// event broadcast, re-sending each payload through the destination
+    /// session. Every packet still passes through both sessions.
+    SessionEvents,
+}
+
 /// Handle representing an active bridge between two media sessions.
 ///
 /// Dropping this handle tears the bridge down: the cancel gate flips
-/// synchronously, partner map entries are removed immediately, and the
-/// background forwarder tasks are aborted asynchronously.
+/// synchronously, partner map entries are removed immediately, receive-loop
+/// forwarders are uninstalled, and any background forwarder tasks are
+/// aborted asynchronously.
 pub struct BridgeHandle {
     session_a: DialogId,
     session_b: DialogId,
     partner_map: Arc<DashMap<DialogId, DialogId>>,
+    forwarder_map: Arc<DashMap<DialogId, Arc<RtpForwarder>>>,
     cancel: Arc<AtomicBool>,
     tasks: Arc<Mutex<Vec<JoinHandle<()>>>>,
+    /// Receive-loop forwarders, `[a -> b, b -> a]`; empty when the bridge
+    /// runs on session events.
+    forwarders: Vec<RtpForwardGuard>,
 }
 
 impl BridgeHandle {
@@ -89,6 +132,26 @@ impl BridgeHandle {
     pub fn sessions(&self) -> (&DialogId, &DialogId) {
         (&self.session_a, &self.session_b)
     }
+
+    /// How this bridge actually forwards — [`BridgeForwarding::SessionEvents`]
+    /// when a receive-loop bridge had to fall back.
+    pub fn forwarding(&self) -> BridgeForwarding {
+        if self.forwarders.is_empty() {
+            BridgeForwarding::SessionEvents
+        } else {
+            BridgeForwarding::ReceiveLoop
+        }
+    }
+
+    /// Packets relayed (by the receive loop or the kernel relay) and
+    /// dropped by the receive-loop forwarders, as
+    /// `(a -> b, b -> a)`. `None` for session-event bridges.
+    pub fn forward_stats(&self) -> Option<(RtpForwardStats, RtpForwardStats)> {
+        match self.forwarders.as_slice() {
+            [ab, ba] => Some((ab.stats(), ba.stats())),
+            _ => None,
+        }
+    }
 }
 
 impl Drop for BridgeHandle {
@@ -98,6 +161,13 @@ impl Drop for BridgeHandle {
         self.cancel.store(true, Ordering::SeqCst);
         self.partner_map.remove(&self.session_a);
         self.partner_map.remove(&self.session_b);
+        self.forwarder_map.remove(&self.session_a);
+        self.forwarder_map.remove(&self.session_b);
+        // Receive-loop forwarders uninstall when `forwarders` drops; there
+        // are no tasks to abort.
+        if !self.forwarders.is_empty() {
+            return;
+        }
 
         let tasks = self.tasks.clone();
         let a = self.session_a.clone();
@@ -122,10 +192,24 @@ impl MediaSessionController {
     ///
     /// The returned [`BridgeHandle`] owns the bridge lifetime — dropping it
     /// restores normal per-session behavior.
+    ///
+    /// Forwards with [`BridgeForwarding::ReceiveLoop`]; see
+    /// [`Self::bridge_sessions_with`] to choose.
     pub async fn bridge_sessions(
         &self,
         a: DialogId,
         b: DialogId,
+    ) -> std::result::Result<BridgeHandle, BridgeError> {
+        self.bridge_sessions_with(a, b, BridgeForwarding::ReceiveLoop)
+            .await
+    }
+
+    /// [`Self::bridge_sessions`] with an explicit forwarding mode.
+    pub async fn bridge_sessions_with(
+        &self,
+        a: DialogId,
+        b: DialogId,
+        forwarding: BridgeForwarding,
     ) -> std::result::Result<BridgeHandle, BridgeError> {
         if a == b {
             return Err(BridgeError::SameSession(a.to_string()));
@@ -156,6 +240,45 @@ impl MediaSessionController {
         self.bridge_partners.insert(a.clone(), b.clone());
         self.bridge_partners.insert(b.clone(), a.clone());
 
+        let cancel = Arc::new(AtomicBool::new(false));
+
+        if forwarding == BridgeForwarding::ReceiveLoop {
+            #[allow(unused_mut)]
+            if let Some(mut forwarders) =
+                install_receive_loop_forwarders(&a_session_arc, &b_session_arc).await
+            {
+                #[cfg(target_os = "linux")]
+                if let Some(relay) = self.kernel_relay.read().clone() {
+                    for guard in forwarders.iter_mut() {
+                        if let Err(e) = guard.offload(relay.clone()) {
+                            debug!("🔗 bridge {} <-> {}: no kernel offload: {}", a, b, e);
+                        }
+                    }
+                }
+                self.bridge_forwarders
+                    .insert(a.clone(), forwarders[0].forwarder());
+                self.bridge_forwarders
+                    .insert(b.clone(), forwarders[1].forwarder());
+                info!(
+                    "🔗 Bridged RTP sessions: {} <-> {} (PT={}, receive-loop forwarding)",
+                    a, b, a_pt
+                );
+                return Ok(BridgeHandle {
+                    session_a: a,
+                    session_b: b,
+                    partner_map: self.bridge_partners.clone(),
+                    forwarder_map: self.bridge_forwarders.clone(),
+                    cancel,
+                    tasks: Arc::new(Mutex::new(Vec::new())),
+                    forwarders,
+                });
+            }
+            debug!(
+                "🔗 bridge {} <-> {}: no dedicated UDP transport, forwarding via session events",
+                a, b
+            );
+        }
+
         // Subscribe to each session's RTP event broadcast. Subscribing
         // early (before spawning) ensures no packets are lost between
         // handshake and the forwarder task starting to poll.
@@ -168,8 +291,6 @@ impl MediaSessionController {
             guard.subscribe()
         };
 
-        let cancel = Arc::new(AtomicBool::new(false));
-
         // Pre-snapshot the lock-free send handles for both directions
         // so the forwarder tasks never need to lock the destination
         // session per packet — see Phase C16 + `RtpSession::send_handle`.
@@ -205,11 +326,22 @@ impl MediaSessionController {
             session_a: a,
             session_b: b,
             partner_map: self.bridge_partners.clone(),
+            forwarder_map: self.bridge_forwarders.clone(),
             cancel,
             tasks: Arc::new(Mutex::new(vec![task_ab, task_ba])),
+            forwarders: Vec::new(),
         })
     }
 
+    /// Offload plain-RTP receive-loop bridges created from now on to
+    /// `relay`, an XDP relay attached to the interfaces media arrives on;
+    /// `None` stops offloading new bridges. Existing bridges keep their
+    /// setting.
+    #[cfg(target_os = "linux")]
+    pub fn set_kernel_relay(&self, relay: Option<Arc<XdpRelay>>) {
+        *self.kernel_relay.write() = relay;
+    }
+
     /// Return true if the given dialog is currently bridged.
     pub fn is_bridged(&self, dialog: &DialogId) -> bool {
         self.bridge_partners.contains_key(dialog)
@@ -272,6 +404,21 @@ impl MediaSessionController {
     }
 }
 
+/// Install a receive-loop forwarder in each direction, `[a -> b, b -> a]`.
+/// `None` (with nothing left installed) unless both sessions own a
+/// dedicated UDP transport. Each session lock is taken on its own, never
+/// both at once.
+async fn install_receive_loop_forwarders(
+    a: &Arc<Mutex<RtpSession>>,
+    b: &Arc<Mutex<RtpSession>>,
+) -> Option<Vec<RtpForwardGuard>> {
+    let a_target = a.lock().await.forward_target()?;
+    let b_target = b.lock().await.forward_target()?;
+    let ab = a.lock().await.forward_to(b_target)?;
+    let ba = b.lock().await.forward_to(a_target)?;
+    Some(vec![ab, ba])
+}
+
 /// Forwarder task: subscribe to `src`'s RTP events and replay each inbound
 /// packet's payload+timestamp+marker as an outbound packet on `dst`.
 ///
@@ -485,4 +632,106 @@ mod tests {
         assert!(!controller.is_bridged(&a));
         assert!(!controller.is_bridged(&b));
     }
+
+    /// Start a bridged pair whose B leg sends to a local sink socket.
+    /// Returns `(a_local_addr, sink)`.
+    async fn bridged_pair(
+        controller: &MediaSessionController,
+        a: &DialogId,
+        b: &DialogId,
+    ) -> (SocketAddr, tokio::net::UdpSocket) {
+        let sink = tokio::net::UdpSocket::bind("127.0.0.1:0").await.unwrap();
+        let sink_addr = sink.local_addr().unwrap();
+        controller
+            .start_media(a.clone(), test_config("PCMU"))
+            .await
+            .unwrap();
+        controller
+            .start_media(b.clone(), test_config("PCMU"))
+            .await
+            .unwrap();
+        controller
+            .update_rtp_remote_addr(b, sink_addr)
+            .await
+            .unwrap();
+        let a_port = controller
+            .get_session_info(a)
+            .await
+            .unwrap()
+            .rtp_port
+            .unwrap();
+        (format!("127.0.0.1:{a_port}").parse().unwrap(), sink)
+    }
+
+    #[tokio::test]
+    async fn receive_loop_bridge_forwards_with_leg_b_identity() {
+        use rvoip_rtp_core::{RtpHeader, RtpPacket};
+
+        let controller = MediaSessionController::new();
+        let a = DialogId::new("a");
+        let b = DialogId::new("b");
+        let (a_addr, sink) = bridged_pair(&controller, &a, &b).await;
+
+        let handle = expect_ok(controller.bridge_sessions(a.clone(), b.clone()).await);
+        assert_eq!(handle.forwarding(), BridgeForwarding::ReceiveLoop);
+
+        let peer = tokio::net::UdpSocket::bind("127.0.0.1:0").await.unwrap();
+        let payload = bytes::Bytes::from_static(&[0x7f; 160]);
+        let mut received = Vec::new();
+        for i in 0..4u16 {
+            let packet = RtpPacket::new(
+                RtpHeader::new(0, 10 + i, 160 * u32::from(i), 0xa),
+                payload.clone(),
+            );
+            peer.send_to(&packet.serialize().unwrap(), a_addr)
+                .await
+                .unwrap();
+            let mut buf = [0u8; 2048];
+            let (n, _) = tokio::time::timeout(
+                std::time::Duration::from_millis(500),
+                sink.recv_from(&mut buf),
+            )
+            .await
+            .expect("bridged packet")
+            .unwrap();
+            received.push(RtpPacket::parse(&buf[..n]).unwrap());
+        }
+
+        let ssrc = received[0].header.ssrc;
+        assert_ne!(ssrc, 0xa, "leg B's SSRC replaces the source SSRC");
+        for (i, packet) in received.iter().enumerate() {
+            assert_eq!(packet.header.ssrc, ssrc);
+            assert_eq!(
+                packet.header.sequence_number,
+                received[0].header.sequence_number.wrapping_add(i as u16)
+            );
+            assert_eq!(packet.header.timestamp, 160 * i as u32);
+            assert_eq!(packet.payload, payload);
+        }
+        let (ab, ba) = handle.forward_stats().unwrap();
+        assert_eq!(ab.forwarded, 4);
+        assert_eq!(ba.forwarded, 0);
+        assert_eq!(controller.get_bridge_forward_statistics(&a), Some(ab));
+
+        drop(handle);
+        assert_eq!(controller.get_bridge_forward_statistics(&a), None);
+    }
+
+    #[tokio::test]
+    async fn session_event_bridge_still_available() {
+        let controller = MediaSessionController::new();
+        let a = DialogId::new("a");
+        let b = DialogId::new("b");
+        bridged_pair(&controller, &a, &b).await;
+
+        let handle = expect_ok(
+            controller
+                .bridge_sessions_with(a.clone(), b.clone(), BridgeForwarding::SessionEvents)
+                .await,
+        );
+        assert_eq!(handle.forwarding(), BridgeForwarding::SessionEvents);
+        assert!(handle.forward_stats().is_none());
+        drop(handle);
+        assert!(!controller.is_bridged(&a));
+    }
 }
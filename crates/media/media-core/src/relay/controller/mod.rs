@@ -17,6 +17,7 @@
 //! Use `set_audio_muted()` and `is_audio_muted()` for muting functionality.
 
 use dashmap::DashMap;
+use std::net::SocketAddr;
 use std::sync::{Arc, OnceLock};
 use std::time::Instant;
 use tokio::sync::{mpsc, RwLock};
@@ -44,8 +45,11 @@ use crate::types::conference::{ConferenceMixingConfig, ConferenceMixingEvent};
 use crate::types::{AudioFrame, DialogId, MediaDirection, MediaSessionId};
 
 use rvoip_rtp_core as rtp_core;
+#[cfg(target_os = "linux")]
+use rvoip_rtp_core::transport::XdpRelay;
 use rvoip_rtp_core::transport::{
-    AllocationStrategy, GlobalPortAllocator, PortAllocator, PortAllocatorConfig,
+    AllocationStrategy, GlobalPortAllocator, PortAllocator, PortAllocatorConfig, RtpForwarder,
+    SharedRtpSocket,
 };
 use rvoip_rtp_core::{
     RtpSession, RtpSessionBufferConfig, RtpSessionConfig, RtpTransportBufferConfig,
@@ -111,6 +115,10 @@ pub struct MediaSessionControllerConfig {
     pub rtp_session_buffer_config: RtpSessionBufferConfig,
     /// RTP transport event and receive buffer sizing.
     pub rtp_transport_buffer_config: RtpTransportBufferConfig,
+    /// Register every RTP session on this shared socket group instead of
+    /// binding a port (and receive task) per session. The port allocator
+    /// is not consulted while this is set.
+    pub shared_rtp_socket: Option<SharedRtpSocket>,
 }
 
 impl Default for MediaSessionControllerConfig {
@@ -129,6 +137,7 @@ impl Default for MediaSessionControllerConfig {
             rtp_buffer_max_count: 128,
             rtp_session_buffer_config: RtpSessionBufferConfig::default(),
             rtp_transport_buffer_config: RtpTransportBufferConfig::default(),
+            shared_rtp_socket: None,
         }
     }
 }
@@ -166,7 +175,7 @@ mod tests;
 
 // Re-export important types
 pub use audio_generation::{AudioSource, AudioTransmitterConfig};
-pub use bridge::{BridgeError, BridgeHandle};
+pub use bridge::{BridgeError, BridgeForwarding, BridgeHandle};
 pub use types::{
     AdvancedProcessorConfig, AdvancedProcessorSet, MediaConfig, MediaSessionEvent,
     MediaSessionInfo, MediaSessionStatus,
@@ -314,6 +323,17 @@ pub struct MediaSessionController {
     /// on `BridgeHandle` drop or `stop_media` of a bridged session.
     pub(super) bridge_partners: Arc<DashMap<DialogId, DialogId>>,
 
+    /// Receive-loop bridge forwarders keyed by the dialog whose inbound
+    /// RTP they relay. Read by
+    /// [`Self::get_bridge_forward_statistics`]; entries leave with the
+    /// `BridgeHandle`.
+    pub(super) bridge_forwarders: Arc<DashMap<DialogId, Arc<RtpForwarder>>>,
+
+    /// Kernel relay new receive-loop bridges offload to, see
+    /// [`Self::set_kernel_relay`]. Only read at bridge setup.
+    #[cfg(target_os = "linux")]
+    pub(super) kernel_relay: parking_lot::RwLock<Option<Arc<XdpRelay>>>,
+
     /// Sprint 3.6 C1 follow-up — RFC 3389 comfort-noise gate state per
     /// dialog. Lazily populated on first audio frame for sessions
     /// whose controller has [`comfort_noise_enabled`] set; the gate
@@ -348,6 +368,10 @@ pub struct MediaSessionController {
 
     /// RTP transport event and receive buffer sizing for new sessions.
     rtp_transport_buffer_config: RtpTransportBufferConfig,
+
+    /// Shared socket group new sessions register on, replacing per-session
+    /// port allocation. See [`MediaSessionControllerConfig::shared_rtp_socket`].
+    shared_rtp_socket: Option<SharedRtpSocket>,
 }
 
 impl MediaSessionController {
@@ -377,6 +401,7 @@ impl MediaSessionController {
         let capacity_hint = config.capacity_hint;
         let rtp_session_buffer_config = config.rtp_session_buffer_config;
         let rtp_transport_buffer_config = config.rtp_transport_buffer_config;
+        let shared_rtp_socket = config.shared_rtp_socket;
         let (event_tx, _event_rx) = mpsc::unbounded_channel();
         let (conference_event_tx, conference_event_rx) = mpsc::unbounded_channel();
 
@@ -449,6 +474,9 @@ impl MediaSessionController {
             codec_mapper,
             rtp_bridge,
             bridge_partners: Arc::new(DashMap::with_capacity(capacity_hint)),
+            bridge_forwarders: Arc::new(DashMap::with_capacity(capacity_hint)),
+            #[cfg(target_os = "linux")]
+            kernel_relay: parking_lot::RwLock::new(None),
             cn_gate_state: Arc::new(DashMap::with_capacity(capacity_hint)),
             comfort_noise_enabled: Arc::new(std::sync::atomic::AtomicBool::new(false)),
             media_directions: Arc::new(DashMap::with_capacity(capacity_hint)),
@@ -456,6 +484,7 @@ impl MediaSessionController {
             g729_tx_codecs: Arc::new(DashMap::with_capacity(capacity_hint)),
             rtp_session_buffer_config,
             rtp_transport_buffer_config,
+            shared_rtp_socket,
         }
     }
 
@@ -766,6 +795,9 @@ impl MediaSessionController {
             codec_mapper,
             rtp_bridge,
             bridge_partners: Arc::new(DashMap::new()),
+            bridge_forwarders: Arc::new(DashMap::new()),
+            #[cfg(target_os = "linux")]
+            kernel_relay: parking_lot::RwLock::new(None),
             cn_gate_state: Arc::new(DashMap::new()),
             comfort_noise_enabled: Arc::new(std::sync::atomic::AtomicBool::new(false)),
             media_directions: Arc::new(DashMap::new()),
@@ -773,6 +805,7 @@ impl MediaSessionController {
             g729_tx_codecs: Arc::new(DashMap::new()),
             rtp_session_buffer_config: RtpSessionBufferConfig::default(),
             rtp_transport_buffer_config: RtpTransportBufferConfig::default(),
+            shared_rtp_socket: None,
         })
     }
 
@@ -789,15 +822,6 @@ impl MediaSessionController {
             )));
         }
 
-        // Allocate RTP port using either our local allocator or the global one
-        let allocator = if let Some(ref port_alloc) = self.port_allocator {
-            // Use our custom port allocator with configured range
-            port_alloc.clone()
-        } else {
-            // Fall back to global allocator
-            GlobalPortAllocator::instance().await
-        };
-
         // Determine payload type from preferred codec
         let payload_type = config
             .preferred_codec
@@ -812,74 +836,50 @@ impl MediaSessionController {
             .map(|codec| self.codec_mapper.get_clock_rate(codec))
             .unwrap_or(8000);
 
-        let dialog_session_id = format!("dialog_{}", dialog_id);
-        let mut last_bind_error: Option<rtp_core::Error> = None;
-        let mut created_session = None;
-        for attempt in 1..=RTP_SESSION_BIND_RETRIES {
-            let allocate_started = Instant::now();
-            let (local_rtp_addr, _) = allocator
-                .allocate_port_pair(&dialog_session_id, Some(config.local_addr.ip()))
-                .await
-                .map_err(|e| Error::config(format!("Failed to allocate RTP port: {}", e)))?;
-            diagnostics::record_rtp_port_allocate(allocate_started.elapsed());
-
-            // Create RTP session configuration
-            let rtp_config = RtpSessionConfig {
-                local_addr: local_rtp_addr,
-                remote_addr: config.remote_addr,
-                ssrc: Some(rand::random()),    // Generate random SSRC
-                payload_type,                  // Use negotiated payload type
-                clock_rate,                    // Use codec-appropriate clock rate
-                jitter_buffer_size: Some(500), // Increased from 50 to handle burst traffic
-                max_packet_age_ms: Some(1000), // Increased from 200ms to 1s for localhost testing
-                enable_jitter_buffer: false,   // Disabled to reduce processing overhead
-                session_buffer_config: self.rtp_session_buffer_config,
-                transport_buffer_config: self.rtp_transport_buffer_config,
-            };
-
-            let session_started = Instant::now();
-            match RtpSession::new_event_driven(rtp_config).await {
-                Ok(rtp_session) => {
-                    diagnostics::record_rtp_session_new(session_started.elapsed());
-                    created_session = Some((local_rtp_addr, rtp_session));
-                    break;
-                }
-                Err(e) => {
-                    diagnostics::record_rtp_session_new(session_started.elapsed());
-                    let _ = allocator.release_session(&dialog_session_id).await;
-                    let should_retry =
-                        is_retryable_rtp_bind_error(&e) && attempt < RTP_SESSION_BIND_RETRIES;
-                    if should_retry {
-                        // Try the next reserved port. The allocator no longer probe-binds
-                        // for media-controller sessions; the real RTP socket bind is the
-                        // authoritative availability check.
-                        debug!(
-                            "RTP bind failed for {} on {} (attempt {}/{}); retrying with another port: {}",
-                            dialog_id, local_rtp_addr, attempt, RTP_SESSION_BIND_RETRIES, e
-                        );
-                        last_bind_error = Some(e);
-                        continue;
-                    }
+        let rtp_config = |local_addr| RtpSessionConfig {
+            local_addr,
+            remote_addr: config.remote_addr,
+            ssrc: Some(rand::random()),    // Generate random SSRC
+            payload_type,                  // Use negotiated payload type
+            clock_rate,                    // Use codec-appropriate clock rate
+            jitter_buffer_size: Some(500), // Increased from 50 to handle burst traffic
+            max_packet_age_ms: Some(1000), // Increased from 200ms to 1s for localhost testing
+            enable_jitter_buffer: false,   // Disabled to reduce processing overhead
+            session_buffer_config: self.rtp_session_buffer_config,
+            transport_buffer_config: self.rtp_transport_buffer_config,
+        };
 
-                    return Err(Error::config(format!(
-                        "Failed to create RTP session on {}: {}",
-                        local_rtp_addr, e
-                    )));
-                }
+        let (local_rtp_addr, rtp_session) = match &self.shared_rtp_socket {
+            Some(shared) => {
+                // No port to allocate or bind: the session is one more route
+                // on the shared group. Advertise the configured media IP
+                // when the group is bound to the wildcard address.
+                let shared_addr = shared.local_addr();
+                let local_rtp_addr = if shared_addr.ip().is_unspecified() {
+                    SocketAddr::new(config.local_addr.ip(), shared_addr.port())
+                } else {
+                    shared_addr
+                };
+                let session_started = Instant::now();
+                let rtp_session = RtpSession::new_event_driven_on_shared_socket(
+                    rtp_config(local_rtp_addr),
+                    shared,
+                )
+                .await;
+                diagnostics::record_rtp_session_new(session_started.elapsed());
+                let rtp_session = rtp_session.map_err(|e| {
+                    Error::config(format!(
+                        "Failed to register RTP session on shared socket {}: {}",
+                        shared_addr, e
+                    ))
+                })?;
+                (local_rtp_addr, rtp_session)
             }
-        }
-
-        let (local_rtp_addr, rtp_session) = created_session.ok_or_else(|| {
-            Error::config(format!(
-                "Failed to create RTP session after {} bind attempts: {}",
-                RTP_SESSION_BIND_RETRIES,
-                last_bind_error
-                    .map(|e| e.to_string())
-                    .unwrap_or_else(|| "no bind attempt completed".to_string())
-            ))
-        })?;
+            None => self.bind_rtp_session(&dialog_id, &config, rtp_config).await?,
+        };
 
         let rtp_port = local_rtp_addr.port();
+        rtp_session.set_telephone_event_payload_type(config.telephone_event_payload_type());
 
         // Subscribe to RTP session events before wrapping
         let subscribe_started = Instant::now();
@@ -948,6 +948,74 @@ impl MediaSessionController {
         Ok(())
     }
 
+    /// Bind a per-session RTP socket on a port from the controller's
+    /// allocator (or the global one), retrying on the next port when the
+    /// bind loses a race for the reserved port.
+    async fn bind_rtp_session(
+        &self,
+        dialog_id: &DialogId,
+        config: &MediaConfig,
+        rtp_config: impl Fn(SocketAddr) -> RtpSessionConfig,
+    ) -> Result<(SocketAddr, RtpSession)> {
+        // Allocate RTP port using either our local allocator or the global one
+        let allocator = if let Some(ref port_alloc) = self.port_allocator {
+            // Use our custom port allocator with configured range
+            port_alloc.clone()
+        } else {
+            // Fall back to global allocator
+            GlobalPortAllocator::instance().await
+        };
+
+        let dialog_session_id = format!("dialog_{}", dialog_id);
+        let mut last_bind_error: Option<rtp_core::Error> = None;
+        for attempt in 1..=RTP_SESSION_BIND_RETRIES {
+            let allocate_started = Instant::now();
+            let (local_rtp_addr, _) = allocator
+                .allocate_port_pair(&dialog_session_id, Some(config.local_addr.ip()))
+                .await
+                .map_err(|e| Error::config(format!("Failed to allocate RTP port: {}", e)))?;
+            diagnostics::record_rtp_port_allocate(allocate_started.elapsed());
+
+            let session_started = Instant::now();
+            match RtpSession::new_event_driven(rtp_config(local_rtp_addr)).await {
+                Ok(rtp_session) => {
+                    diagnostics::record_rtp_session_new(session_started.elapsed());
+                    return Ok((local_rtp_addr, rtp_session));
+                }
+                Err(e) => {
+                    diagnostics::record_rtp_session_new(session_started.elapsed());
+                    let _ = allocator.release_session(&dialog_session_id).await;
+                    let should_retry =
+                        is_retryable_rtp_bind_error(&e) && attempt < RTP_SESSION_BIND_RETRIES;
+                    if should_retry {
+                        // Try the next reserved port. The allocator no longer probe-binds
+                        // for media-controller sessions; the real RTP socket bind is the
+                        // authoritative availability check.
+                        debug!(
+                            "RTP bind failed for {} on {} (attempt {}/{}); retrying with another port: {}",
+                            dialog_id, local_rtp_addr, attempt, RTP_SESSION_BIND_RETRIES, e
+                        );
+                        last_bind_error = Some(e);
+                        continue;
+                    }
+
+                    return Err(Error::config(format!(
+                        "Failed to create RTP session on {}: {}",
+                        local_rtp_addr, e
+                    )));
+                }
+            }
+        }
+
+        Err(Error::config(format!(
+            "Failed to create RTP session after {} bind attempts: {}",
+            RTP_SESSION_BIND_RETRIES,
+            last_bind_error
+                .map(|e| e.to_string())
+                .unwrap_or_else(|| "no bind attempt completed".to_string())
+        )))
+    }
+
     /// Install RFC 4568 SDES-SRTP contexts on the dialog's RTP
     /// session, switching its transport from plain RTP to encrypted
     /// SRTP for both directions.
@@ -974,22 +1042,13 @@ impl MediaSessionController {
             .map(|r| r.value().session.clone())
             .ok_or_else(|| Error::session_not_found(dialog_id.as_str()))?;
 
-        // RtpSession exposes its transport via a typed accessor; we
-        // need the UdpRtpTransport concrete type to reach
-        // `set_srtp_contexts`. Downcast once — the only transport
-        // type media-core constructs is UDP, so this is the
-        // architecturally-correct narrowing.
-        let session_guard = session_arc.lock().await;
-        let transport = session_guard.transport();
-        let udp_transport = transport
-            .as_any()
-            .downcast_ref::<rvoip_rtp_core::transport::UdpRtpTransport>()
-            .ok_or_else(|| {
-                Error::config(
-                    "install_srtp_contexts: RTP session is not a UdpRtpTransport".to_string(),
-                )
-            })?;
-        udp_transport.set_srtp_contexts(send_ctx, recv_ctx).await;
+        // Per-session UDP and shared-socket transports both carry SRTP;
+        // the trait method reaches either without downcasting.
+        let transport = session_arc.lock().await.transport();
+        transport
+            .install_srtp_contexts(send_ctx, recv_ctx)
+            .await
+            .map_err(|e| Error::config(format!("install_srtp_contexts: {}", e)))?;
         info!("Installed SDES-SRTP contexts on dialog {}", dialog_id);
         Ok(())
     }
@@ -1071,8 +1130,9 @@ impl MediaSessionController {
             info!("✅ Stopped RTP session for dialog: {}", dialog_id);
         }
 
-        // Release port via the appropriate allocator
-        if session_info.rtp_port.is_some() {
+        // Release port via the appropriate allocator; shared-socket
+        // sessions never took one.
+        if session_info.rtp_port.is_some() && self.shared_rtp_socket.is_none() {
             let allocator = if let Some(ref port_alloc) = self.port_allocator {
                 // Use our custom port allocator
                 port_alloc.clone()
@@ -1113,7 +1173,7 @@ impl MediaSessionController {
         // Update the session config and snapshot the old values for
         // change detection. The shard guard is dropped at the end of
         // this block.
-        let (old_remote, old_codec) = {
+        let (old_remote, old_codec, old_telephone_event_pt) = {
             let mut entry = self
                 .sessions
                 .get_mut(&dialog_id)
@@ -1121,8 +1181,9 @@ impl MediaSessionController {
             let session_info = entry.value_mut();
             let old_remote = session_info.config.remote_addr;
             let old_codec = session_info.config.preferred_codec.clone();
+            let old_telephone_event_pt = session_info.config.telephone_event_payload_type();
             session_info.config = config.clone();
-            (old_remote, old_codec)
+            (old_remote, old_codec, old_telephone_event_pt)
         };
 
         // Extract the per-session Arc + update the wrapper's remote
@@ -1165,6 +1226,21 @@ impl MediaSessionController {
             }
         }
 
+        // Apply a renegotiated telephone-event payload type. The transport
+        // reads it for DTMF detection and for kernel relay rules.
+        let telephone_event_pt = config.telephone_event_payload_type();
+        if telephone_event_pt != old_telephone_event_pt {
+            rtp_session_arc
+                .lock()
+                .await
+                .set_telephone_event_payload_type(telephone_event_pt);
+            debug!(
+                "Updated telephone-event payload type for dialog {}: {} -> {}",
+                dialog_id, old_telephone_event_pt, telephone_event_pt
+            );
+            updates_made = true;
+        }
+
         // Apply codec change.
         if config.preferred_codec != old_codec {
             #[cfg(feature = "g729")]
@@ -12,6 +12,7 @@ use crate::types::{
     DialogId, MediaProcessingStats, MediaSessionId, MediaStatistics, QualityMetrics,
 };
 use rvoip_rtp_core::session::{RtpSessionStats, RtpStreamStats};
+use rvoip_rtp_core::RtpForwardStats;
 
 use super::{MediaSessionController, MediaSessionEvent};
 
@@ -38,6 +39,14 @@ impl MediaSessionController {
         Some(session.get_stats())
     }
 
+    /// Packets the bridge forwarder relaying `dialog_id`'s inbound RTP has
+    /// sent, dropped, and handed to the kernel relay. `None` unless the
+    /// dialog is in a receive-loop bridge.
+    pub fn get_bridge_forward_statistics(&self, dialog_id: &DialogId) -> Option<RtpForwardStats> {
+        let forwarder = self.bridge_forwarders.get(dialog_id)?.value().clone();
+        Some(forwarder.stats())
+    }
+
     /// Get all stream statistics for a dialog
     pub async fn get_stream_statistics(&self, dialog_id: &DialogId) -> Vec<RtpStreamStats> {
         if let Some(rtp_session) = self.get_rtp_session(dialog_id).await {
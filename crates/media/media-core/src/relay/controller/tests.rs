@@ -234,6 +234,61 @@ mod tests {
             .expect("session should stop cleanly");
     }
 
+    #[tokio::test]
+    async fn test_shared_socket_sessions_share_one_port_and_take_srtp() {
+        use rvoip_rtp_core::srtp::{SrtpContext, SrtpCryptoKey, SRTP_AES128_CM_SHA1_80};
+        use rvoip_rtp_core::transport::{SharedRtpSocket, SharedRtpSocketConfig};
+
+        let shared = SharedRtpSocket::new(SharedRtpSocketConfig {
+            local_addr: SocketAddr::new(IpAddr::V4(Ipv4Addr::LOCALHOST), 0),
+            socket_count: 1,
+            ..Default::default()
+        })
+        .await
+        .expect("bind shared socket");
+        let controller = MediaSessionController::with_config(MediaSessionControllerConfig {
+            shared_rtp_socket: Some(shared.clone()),
+            ..Default::default()
+        });
+
+        let dialogs = [DialogId::new("shared-a"), DialogId::new("shared-b")];
+        for (index, dialog_id) in dialogs.iter().enumerate() {
+            let config = MediaConfig {
+                local_addr: SocketAddr::new(IpAddr::V4(Ipv4Addr::LOCALHOST), 0),
+                remote_addr: Some(SocketAddr::new(
+                    IpAddr::V4(Ipv4Addr::LOCALHOST),
+                    40_000 + index as u16,
+                )),
+                preferred_codec: None,
+                parameters: HashMap::new(),
+            };
+            controller
+                .start_media(dialog_id.clone(), config)
+                .await
+                .expect("start media on shared socket");
+            let info = controller.get_session_info(dialog_id).await.unwrap();
+            assert_eq!(info.rtp_port, Some(shared.local_addr().port()));
+        }
+        assert_eq!(shared.stats().sessions, 2);
+
+        let context = || {
+            SrtpContext::new(
+                SRTP_AES128_CM_SHA1_80,
+                SrtpCryptoKey::new(vec![7; 16], vec![8; 14]),
+            )
+            .expect("srtp context")
+        };
+        controller
+            .install_srtp_contexts(&dialogs[0], context(), context())
+            .await
+            .expect("shared-socket transports accept SRTP contexts");
+
+        for dialog_id in &dialogs {
+            controller.stop_media(dialog_id).await.expect("stop media");
+        }
+        assert_eq!(shared.stats().sessions, 0);
+    }
+
     #[tokio::test]
     async fn test_pass_through_media_flow_does_not_spawn_transmitter() {
         let controller = MediaSessionController::new();
@@ -29,6 +29,21 @@ pub struct MediaConfig {
     pub parameters: HashMap<String, String>,
 }
 
+impl MediaConfig {
+    /// [`Self::parameters`] key holding the RFC 4733 `telephone-event`
+    /// payload type negotiated in SDP
+    pub const TELEPHONE_EVENT_PAYLOAD_TYPE: &'static str = "telephone-event-pt";
+
+    /// Negotiated `telephone-event` payload type, or the conventional 101
+    /// when SDP did not name one
+    pub fn telephone_event_payload_type(&self) -> u8 {
+        self.parameters
+            .get(Self::TELEPHONE_EVENT_PAYLOAD_TYPE)
+            .and_then(|pt| pt.parse().ok())
+            .unwrap_or(rvoip_rtp_core::DEFAULT_TELEPHONE_EVENT_PAYLOAD_TYPE)
+    }
+}
+
 /// Media session status
 #[derive(Debug, Clone, PartialEq)]
 pub enum MediaSessionStatus {
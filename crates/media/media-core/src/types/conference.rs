@@ -141,6 +141,8 @@ pub struct ConferenceMixingConfig {
 
     /// Mixing behavior settings
     pub enable_voice_activity_mixing: bool, // Only mix talking participants
+    /// Most participants mixed per cycle; the loudest talkers win
+    pub max_active_speakers: usize,
     pub enable_automatic_gain_control: bool,
     pub enable_noise_reduction: bool,
 
@@ -161,6 +163,7 @@ impl Default for ConferenceMixingConfig {
             output_channels: 1,            // Mono
             output_samples_per_frame: 160, // 20ms at 8kHz
             enable_voice_activity_mixing: true,
+            max_active_speakers: 3,
             enable_automatic_gain_control: true,
             enable_noise_reduction: false, // Can be expensive
             enable_simd_optimization: true,
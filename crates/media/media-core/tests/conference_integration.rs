@@ -24,6 +24,7 @@ async fn test_conference_setup_teardown() {
         output_channels: 1,
         output_samples_per_frame: 160,
         enable_voice_activity_mixing: false, // Disabled for simple test
+        max_active_speakers: 3,
         enable_automatic_gain_control: false,
         enable_noise_reduction: false,
         enable_simd_optimization: false,
@@ -13,13 +13,24 @@
 //!    concurrent tasks — the structure used verbatim today vs the
 //!    proposed Phase C2 replacement.
 //!
+//! 3. `SharedRtpSocket::route_datagram` — the `(remote addr, SSRC)`
+//!    lookup that routes every datagram on a shared media socket to its
+//!    session — at 1k/10k/100k registered sessions. Probes are warmed
+//!    first so each resolves on the learned `(addr, ssrc)` route, the
+//!    steady-state receive path.
+//!
 //! Pair the deltas here with the end-to-end deltas in `udp_loopback`
 //! to size up the SSRC-demux contribution.
 
 use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
 use dashmap::DashMap;
-use rvoip_rtp_core::{RtpSsrc, RtpStream};
+use rvoip_rtp_core::packet::{RtpHeader, RtpPacket};
+use rvoip_rtp_core::{
+    DemuxSessionConfig, RtpSsrc, RtpStream, RtpTransportBufferConfig, SharedRtpSocket,
+    SharedRtpSocketConfig,
+};
 use std::collections::HashMap;
+use std::net::{Ipv4Addr, SocketAddr};
 use std::sync::{Arc, Mutex as StdMutex};
 use std::time::{Duration, Instant};
 use tokio::runtime::Builder;
@@ -28,6 +39,7 @@ const STREAM_COUNTS: [usize; 4] = [1, 10, 100, 1_000];
 const CONTENDED_STREAM_COUNT: usize = 1_000;
 const CONTENDED_OPS_PER_TASK: u64 = 200;
 const THREAD_COUNTS: [usize; 4] = [1, 4, 8, 16];
+const SHARED_SOCKET_SESSION_COUNTS: [usize; 3] = [1_000, 10_000, 100_000];
 
 fn ssrc(i: usize) -> RtpSsrc {
     // Spread SSRCs so the hash function isn't doing trivial work; the
@@ -158,5 +170,75 @@ fn bench_contended_lookup(c: &mut Criterion) {
     group.finish();
 }
 
-criterion_group!(benches, bench_uncontended_lookup, bench_contended_lookup);
+/// Remote media address of synthetic session `i`: one address per
+/// session, spread across 10.0.0.0/8.
+fn remote_addr(i: usize) -> SocketAddr {
+    SocketAddr::from((Ipv4Addr::from(0x0A00_0000 | i as u32), 20_000))
+}
+
+fn bench_shared_socket_route(c: &mut Criterion) {
+    let rt = Builder::new_multi_thread()
+        .worker_threads(2)
+        .enable_all()
+        .build()
+        .expect("runtime");
+
+    let mut group = c.benchmark_group("shared_socket_route");
+    for &n in &SHARED_SOCKET_SESSION_COUNTS {
+        let shared = rt
+            .block_on(SharedRtpSocket::new(SharedRtpSocketConfig {
+                local_addr: "127.0.0.1:0".parse().unwrap(),
+                socket_count: 1,
+                buffer_config: RtpTransportBufferConfig {
+                    event_channel_capacity: 1,
+                    ..Default::default()
+                },
+            }))
+            .expect("shared socket");
+        let sessions: Vec<_> = (0..n)
+            .map(|i| {
+                shared
+                    .register_session(DemuxSessionConfig {
+                        remote_rtp_addr: Some(remote_addr(i)),
+                        ..Default::default()
+                    })
+                    .expect("register")
+            })
+            .collect();
+
+        let probe: Vec<(Vec<u8>, SocketAddr)> = (0..256)
+            .map(|i| {
+                let idx = (i * 7919) % n;
+                let packet = RtpPacket::new(
+                    RtpHeader::new(0, i as u16, 160, ssrc(idx)),
+                    bytes::Bytes::from_static(&[0u8; 160]),
+                );
+                (packet.serialize().unwrap().to_vec(), remote_addr(idx))
+            })
+            .collect();
+        for (data, source) in &probe {
+            assert!(shared.route_datagram(data, *source).is_some());
+        }
+
+        group.throughput(Throughput::Elements(probe.len() as u64));
+        group.bench_with_input(BenchmarkId::from_parameter(n), &n, |b, _| {
+            b.iter(|| {
+                for (data, source) in &probe {
+                    black_box(shared.route_datagram(black_box(data), *source));
+                }
+            });
+        });
+
+        drop(sessions);
+        rt.block_on(shared.close());
+    }
+    group.finish();
+}
+
+criterion_group!(
+    benches,
+    bench_uncontended_lookup,
+    bench_contended_lookup,
+    bench_shared_socket_route
+);
 criterion_main!(benches);
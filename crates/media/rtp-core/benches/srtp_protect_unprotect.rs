@@ -8,12 +8,21 @@
 //! parsing — at representative payload sizes so we have a numeric
 //! ceiling for what the optimised transport hot path can reach.
 //!
-//! Suite under test: AES-CM-128 + HMAC-SHA1-80 (the default in this
-//! stack and in WebRTC).
+//! Every group runs once per crypto suite so the AES-CM + HMAC-SHA1
+//! suites (RFC 3711, RFC 6188) can be compared with the AEAD AES-GCM
+//! suites (RFC 7714) in ns/packet; Criterion's benchmark IDs are
+//! `<suite>/<payload>`.
+//!
+//! `srtp_protect_in_place` is the allocation-free path the UDP transport
+//! sends through: serialize into a reused scratch buffer and protect it
+//! in place.
 
-use bytes::Bytes;
+use bytes::{Bytes, BytesMut};
 use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
-use rvoip_rtp_core::srtp::{SrtpContext, SrtpCryptoKey, SRTP_AES128_CM_SHA1_80};
+use rvoip_rtp_core::srtp::{
+    SrtpContext, SrtpCryptoKey, SrtpCryptoSuite, SRTP_AEAD_AES_128_GCM, SRTP_AEAD_AES_256_GCM,
+    SRTP_AES128_CM_SHA1_32, SRTP_AES128_CM_SHA1_80, SRTP_AES256_CM_SHA1_32, SRTP_AES256_CM_SHA1_80,
+};
 use rvoip_rtp_core::{RtpHeader, RtpPacket};
 
 const PAYLOAD_SIZES: [(&str, usize); 4] = [
@@ -23,6 +32,15 @@ const PAYLOAD_SIZES: [(&str, usize); 4] = [
     ("video_1200", 1200),
 ];
 
+const SUITES: [(&str, SrtpCryptoSuite); 6] = [
+    ("aes128_cm_sha1_80", SRTP_AES128_CM_SHA1_80),
+    ("aes128_cm_sha1_32", SRTP_AES128_CM_SHA1_32),
+    ("aes256_cm_sha1_80", SRTP_AES256_CM_SHA1_80),
+    ("aes256_cm_sha1_32", SRTP_AES256_CM_SHA1_32),
+    ("aead_aes128_gcm", SRTP_AEAD_AES_128_GCM),
+    ("aead_aes256_gcm", SRTP_AEAD_AES_256_GCM),
+];
+
 fn make_payload(size: usize) -> Bytes {
     let mut v = Vec::with_capacity(size);
     for i in 0..size {
@@ -36,54 +54,81 @@ fn make_packet(payload_size: usize, seq: u16) -> RtpPacket {
     RtpPacket::new(header, make_payload(payload_size))
 }
 
-fn make_context() -> SrtpContext {
-    // 16-byte master key + 14-byte salt per AES-CM-128 (RFC 3711 §4.1.1).
-    let key = vec![0x42; 16];
-    let salt = vec![0x37; 14];
-    SrtpContext::new(SRTP_AES128_CM_SHA1_80, SrtpCryptoKey::new(key, salt)).expect("srtp context")
+fn make_context(suite: &SrtpCryptoSuite) -> SrtpContext {
+    // Master key per the suite; 14-byte salt for AES-CM (RFC 3711 §4.1.1),
+    // 12-byte salt for AEAD (RFC 7714 §12).
+    let key = vec![0x42; suite.key_length];
+    let salt = vec![0x37; suite.salt_length()];
+    SrtpContext::new(suite.clone(), SrtpCryptoKey::new(key, salt)).expect("srtp context")
 }
 
 fn bench_protect(c: &mut Criterion) {
     let mut group = c.benchmark_group("srtp_protect");
-    for (name, size) in PAYLOAD_SIZES {
-        let packet = make_packet(size, 0);
-        group.throughput(Throughput::Bytes(packet.size() as u64));
-        group.bench_with_input(BenchmarkId::from_parameter(name), &packet, |b, packet| {
-            // Fresh context per benchmark to keep packet_index in a
-            // realistic range and avoid measuring AES re-keying.
-            let mut ctx = make_context();
-            b.iter(|| {
-                let protected = ctx.protect(black_box(packet)).expect("protect");
-                black_box(protected);
+    for (suite_name, suite) in &SUITES {
+        for (name, size) in PAYLOAD_SIZES {
+            let packet = make_packet(size, 0);
+            group.throughput(Throughput::Bytes(packet.size() as u64));
+            group.bench_with_input(BenchmarkId::new(*suite_name, name), &packet, |b, packet| {
+                // Fresh context per benchmark to keep packet_index in a
+                // realistic range and avoid measuring AES re-keying.
+                let mut ctx = make_context(suite);
+                b.iter(|| {
+                    let protected = ctx.protect(black_box(packet)).expect("protect");
+                    black_box(protected);
+                });
             });
-        });
+        }
+    }
+    group.finish();
+}
+
+fn bench_protect_in_place(c: &mut Criterion) {
+    let mut group = c.benchmark_group("srtp_protect_in_place");
+    for (suite_name, suite) in &SUITES {
+        for (name, size) in PAYLOAD_SIZES {
+            let packet = make_packet(size, 0);
+            group.throughput(Throughput::Bytes(packet.size() as u64));
+            group.bench_with_input(BenchmarkId::new(*suite_name, name), &packet, |b, packet| {
+                let mut ctx = make_context(suite);
+                let mut buf = BytesMut::with_capacity(packet.size() + ctx.rtp_trailer_len());
+                b.iter(|| {
+                    buf.clear();
+                    packet.write_to(&mut buf).expect("serialize");
+                    ctx.protect_in_place(black_box(&mut buf))
+                        .expect("protect_in_place");
+                    black_box(&buf);
+                });
+            });
+        }
     }
     group.finish();
 }
 
 fn bench_unprotect(c: &mut Criterion) {
     let mut group = c.benchmark_group("srtp_unprotect");
-    for (name, size) in PAYLOAD_SIZES {
-        // Pre-protect one packet so we have realistic ciphertext.
-        let mut tx_ctx = make_context();
-        let packet = make_packet(size, 0);
-        let protected = tx_ctx.protect(&packet).expect("protect");
-        let wire = protected.serialize().expect("serialize protected");
+    for (suite_name, suite) in &SUITES {
+        for (name, size) in PAYLOAD_SIZES {
+            // Pre-protect one packet so we have realistic ciphertext.
+            let mut tx_ctx = make_context(suite);
+            let packet = make_packet(size, 0);
+            let protected = tx_ctx.protect(&packet).expect("protect");
+            let wire = protected.serialize().expect("serialize protected");
 
-        group.throughput(Throughput::Bytes(wire.len() as u64));
-        group.bench_with_input(BenchmarkId::from_parameter(name), &wire, |b, wire| {
-            // Each iteration unprotects the same ciphertext. A fresh
-            // context every iteration avoids the replay window
-            // rejecting subsequent unprotects with the same seq.
-            b.iter_batched(
-                make_context,
-                |mut ctx| {
-                    let plain = ctx.unprotect(black_box(wire)).expect("unprotect");
-                    black_box(plain);
-                },
-                criterion::BatchSize::SmallInput,
-            );
-        });
+            group.throughput(Throughput::Bytes(wire.len() as u64));
+            group.bench_with_input(BenchmarkId::new(*suite_name, name), &wire, |b, wire| {
+                // Each iteration unprotects the same ciphertext. A fresh
+                // context every iteration avoids the replay window
+                // rejecting subsequent unprotects with the same seq.
+                b.iter_batched(
+                    || make_context(suite),
+                    |mut ctx| {
+                        let plain = ctx.unprotect(black_box(wire)).expect("unprotect");
+                        black_box(plain);
+                    },
+                    criterion::BatchSize::SmallInput,
+                );
+            });
+        }
     }
     group.finish();
 }
@@ -93,17 +138,25 @@ fn bench_protect_rtcp(c: &mut Criterion) {
     // Typical compound RTCP report ~60–100 bytes.
     let rtcp_data: Vec<u8> = (0..96).map(|i| (i & 0xff) as u8).collect();
     group.throughput(Throughput::Bytes(rtcp_data.len() as u64));
-    group.bench_function("compound_96", |b| {
-        let mut ctx = make_context();
-        b.iter(|| {
-            let out = ctx
-                .protect_rtcp(black_box(&rtcp_data))
-                .expect("protect_rtcp");
-            black_box(out);
+    for (suite_name, suite) in &SUITES {
+        group.bench_function(BenchmarkId::new(*suite_name, "compound_96"), |b| {
+            let mut ctx = make_context(suite);
+            b.iter(|| {
+                let out = ctx
+                    .protect_rtcp(black_box(&rtcp_data))
+                    .expect("protect_rtcp");
+                black_box(out);
+            });
         });
-    });
+    }
     group.finish();
 }
 
-criterion_group!(benches, bench_protect, bench_unprotect, bench_protect_rtcp);
+criterion_group!(
+    benches,
+    bench_protect,
+    bench_protect_in_place,
+    bench_unprotect,
+    bench_protect_rtcp
+);
 criterion_main!(benches);
@@ -13,6 +13,11 @@
 //!   dispatch from the crypto.
 //! - `transport_rtp_full_stack_srtp` — same path with SRTP unprotect.
 //!   Isolates the `srtp_recv` `tokio::Mutex` cost on top of the crypto.
+//! - `transport_rtp_burst` — transport-to-transport bursts of
+//!   [`BURST`] packets: per-packet `send_to` vs batched `sendmmsg` sends,
+//!   per-datagram receive vs `recvmmsg` batching, and UDP GSO/GRO on top.
+//!   Throughput is packets/sec; each mode also prints syscalls/packet
+//!   from `UdpRtpTransport::io_stats`.
 //!
 //! Driven from a sender `UdpSocket` that emits a pre-serialised RTP
 //! packet; the transport's receive task parses inbound bytes and emits
@@ -22,7 +27,9 @@ use bytes::Bytes;
 use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
 use rvoip_rtp_core::srtp::{SrtpContext, SrtpCryptoKey, SRTP_AES128_CM_SHA1_80};
 use rvoip_rtp_core::traits::RtpEvent;
-use rvoip_rtp_core::transport::{RtpTransport, RtpTransportConfig, UdpRtpTransport};
+use rvoip_rtp_core::transport::{
+    RtpTransport, RtpTransportBufferConfig, RtpTransportConfig, UdpRtpTransport,
+};
 use rvoip_rtp_core::{RtpHeader, RtpPacket};
 use std::time::Instant;
 use tokio::net::UdpSocket;
@@ -181,5 +188,102 @@ fn bench_full_stack_srtp(c: &mut Criterion) {
     group.finish();
 }
 
-criterion_group!(benches, bench_full_stack_plain, bench_full_stack_srtp);
+/// Packets per burst in `transport_rtp_burst`.
+const BURST: usize = 32;
+
+/// `(name, recv_batch_size, batched send, udp_offload)`
+const IO_MODES: [(&str, usize, bool, bool); 4] = [
+    ("per_datagram", 1, false, false),
+    ("recvmmsg_32", 32, false, false),
+    ("mmsg_32", 32, true, false),
+    ("mmsg_32_gso_gro", 32, true, true),
+];
+
+fn bench_burst_io_modes(c: &mut Criterion) {
+    let rt = Builder::new_multi_thread()
+        .worker_threads(2)
+        .enable_all()
+        .build()
+        .expect("runtime");
+
+    let wires: Vec<Bytes> = (0..BURST as u16)
+        .map(|seq| make_packet_wire(160, seq))
+        .collect();
+    let slices: Vec<&[u8]> = wires.iter().map(|w| &w[..]).collect();
+
+    let mut group = c.benchmark_group("transport_rtp_burst");
+    group.throughput(Throughput::Elements(BURST as u64));
+    for (name, recv_batch_size, batched_send, udp_offload) in IO_MODES {
+        let cfg = RtpTransportConfig {
+            local_rtp_addr: LOOPBACK.parse().unwrap(),
+            buffer_config: RtpTransportBufferConfig {
+                event_channel_capacity: BURST * 4,
+                recv_batch_size,
+                udp_offload,
+                ..Default::default()
+            },
+            ..Default::default()
+        };
+        let (sender, receiver) = rt.block_on(async {
+            (
+                UdpRtpTransport::new(cfg.clone()).await.expect("sender"),
+                UdpRtpTransport::new(cfg).await.expect("receiver"),
+            )
+        });
+        let dest = receiver.local_rtp_addr().expect("local_rtp_addr");
+        let mut rx = receiver.subscribe();
+
+        group.bench_function(BenchmarkId::from_parameter(name), |b| {
+            b.iter_custom(|iters| {
+                rt.block_on(async {
+                    let start = Instant::now();
+                    for _ in 0..iters {
+                        if batched_send {
+                            sender
+                                .send_rtp_bytes_batch(&slices, dest)
+                                .await
+                                .expect("send batch");
+                        } else {
+                            for wire in &slices {
+                                sender.send_rtp_bytes(wire, dest).await.expect("send");
+                            }
+                        }
+                        let mut received = 0;
+                        while received < BURST {
+                            match rx.recv().await {
+                                Ok(RtpEvent::MediaReceived { payload, .. }) => {
+                                    black_box(payload);
+                                    received += 1;
+                                }
+                                Ok(_) => continue,
+                                Err(e) => panic!("recv: {e}"),
+                            }
+                        }
+                    }
+                    start.elapsed()
+                })
+            });
+        });
+
+        let sent = sender.io_stats();
+        let recv = receiver.io_stats();
+        eprintln!(
+            "transport_rtp_burst/{name}: send {:.3} syscalls/packet, recv {:.3} syscalls/packet",
+            sent.send_syscalls as f64 / sent.datagrams_sent.max(1) as f64,
+            recv.recv_syscalls as f64 / recv.datagrams_received.max(1) as f64,
+        );
+        rt.block_on(async {
+            sender.close().await.ok();
+            receiver.close().await.ok();
+        });
+    }
+    group.finish();
+}
+
+criterion_group!(
+    benches,
+    bench_full_stack_plain,
+    bench_full_stack_srtp,
+    bench_burst_io_modes
+);
 criterion_main!(benches);
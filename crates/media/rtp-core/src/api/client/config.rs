@@ -290,6 +290,7 @@ mod tests {
             event_channel_capacity: 12,
             recv_buffer_size: 2048,
             rtcp_recv_buffer_size: 1024,
+            ..Default::default()
         };
 
         let config = ClientConfigBuilder::new()
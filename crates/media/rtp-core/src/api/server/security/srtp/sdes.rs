@@ -19,7 +19,10 @@ use crate::security::{
     sdes::{Sdes, SdesConfig, SdesCryptoAttribute, SdesRole},
     SecurityKeyExchange,
 };
-use crate::srtp::{SrtpContext, SrtpCryptoSuite, SRTP_AES128_CM_SHA1_32, SRTP_AES128_CM_SHA1_80};
+use crate::srtp::{
+    SrtpContext, SrtpCryptoSuite, SRTP_AEAD_AES_128_GCM, SRTP_AEAD_AES_256_GCM,
+    SRTP_AES128_CM_SHA1_32, SRTP_AES128_CM_SHA1_80,
+};
 
 /// SDES server configuration
 #[derive(Debug, Clone)]
@@ -120,21 +123,11 @@ impl SdesServerSession {
     fn convert_srtp_profiles(profiles: &[SrtpProfile]) -> Vec<SrtpCryptoSuite> {
         profiles
             .iter()
-            .filter_map(|profile| {
-                match profile {
-                    SrtpProfile::AesCm128HmacSha1_80 => Some(SRTP_AES128_CM_SHA1_80),
-                    SrtpProfile::AesCm128HmacSha1_32 => Some(SRTP_AES128_CM_SHA1_32),
-                    SrtpProfile::AesGcm128 => {
-                        // AES-GCM not implemented in core yet
-                        debug!("AES-GCM profile not yet supported, skipping");
-                        None
-                    }
-                    SrtpProfile::AesGcm256 => {
-                        // AES-GCM not implemented in core yet
-                        debug!("AES-GCM-256 profile not yet supported, skipping");
-                        None
-                    }
-                }
+            .filter_map(|profile| match profile {
+                SrtpProfile::AesCm128HmacSha1_80 => Some(SRTP_AES128_CM_SHA1_80),
+                SrtpProfile::AesCm128HmacSha1_32 => Some(SRTP_AES128_CM_SHA1_32),
+                SrtpProfile::AesGcm128 => Some(SRTP_AEAD_AES_128_GCM),
+                SrtpProfile::AesGcm256 => Some(SRTP_AEAD_AES_256_GCM),
             })
             .collect()
     }
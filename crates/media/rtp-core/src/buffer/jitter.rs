@@ -11,7 +11,7 @@ use std::time::{Duration, Instant};
 use tokio::sync::Notify;
 use tracing::{debug, trace};
 
-use super::GlobalBufferManager;
+use super::{GlobalBufferManager, JitterBufferStorage, SeqInsert, SeqRing};
 
 /// Default jitter buffer size in milliseconds
 pub const DEFAULT_JITTER_BUFFER_SIZE_MS: u32 = 50;
@@ -54,6 +54,10 @@ pub struct JitterBufferConfig {
 
     /// Whether to adapt buffer size dynamically
     pub adaptive: bool,
+
+    /// Packet storage. The ring holds `max_out_of_order` packets
+    /// (rounded up to a power of two) allocated up front.
+    pub storage: JitterBufferStorage,
 }
 
 impl Default for JitterBufferConfig {
@@ -67,6 +71,7 @@ impl Default for JitterBufferConfig {
             max_packet_age_ms: 200,
             initial_playout_delay_ms: DEFAULT_PLAYOUT_DELAY_MS,
             adaptive: true,
+            storage: JitterBufferStorage::default(),
         }
     }
 }
@@ -112,7 +117,7 @@ pub struct JitterBufferStats {
 ///
 /// This implementation provides:
 /// - Adaptive buffer sizing based on network conditions
-/// - Efficient packet storage using BTreeMap
+/// - Sequence-indexed packet storage ([`JitterBufferStorage`])
 /// - Proper handling of sequence wraparound
 /// - Memory management with global limits
 /// - Real-time statistics collection
@@ -122,7 +127,7 @@ pub struct AdaptiveJitterBuffer {
     config: JitterBufferConfig,
 
     /// Packets stored by sequence number
-    packets: BTreeMap<u32, (RtpPacket, Instant)>,
+    packets: PacketStore,
 
     /// Next sequence number expected
     next_seq: Option<RtpSequenceNumber>,
@@ -180,6 +185,101 @@ pub struct AdaptiveJitterBuffer {
     playout_delay: u32,
 }
 
+/// Packet storage selected by [`JitterBufferConfig::storage`]
+enum PacketStore {
+    Ring(SeqRing<(RtpPacket, Instant)>),
+    Tree(BTreeMap<u32, (RtpPacket, Instant)>),
+}
+
+impl PacketStore {
+    fn new(config: &JitterBufferConfig) -> Self {
+        match config.storage {
+            JitterBufferStorage::Ring => {
+                Self::Ring(SeqRing::with_capacity(config.max_out_of_order))
+            }
+            JitterBufferStorage::BTreeMap => Self::Tree(BTreeMap::new()),
+        }
+    }
+
+    fn len(&self) -> usize {
+        match self {
+            Self::Ring(ring) => ring.len(),
+            Self::Tree(tree) => tree.len(),
+        }
+    }
+
+    fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    fn contains(&self, seq: RtpSequenceNumber) -> bool {
+        match self {
+            Self::Ring(ring) => ring.contains(seq),
+            Self::Tree(tree) => tree.contains_key(&(seq as u32)),
+        }
+    }
+
+    /// Store a packet. Returns the number of older packets the ring had
+    /// to evict to fit it, or `None` if it is older than the ring can
+    /// hold.
+    fn insert(&mut self, seq: RtpSequenceNumber, entry: (RtpPacket, Instant)) -> Option<usize> {
+        match self {
+            Self::Ring(ring) => match ring.insert(seq, entry) {
+                SeqInsert::Inserted { evicted } => Some(evicted),
+                SeqInsert::Duplicate(_) | SeqInsert::TooOld(_) => None,
+            },
+            Self::Tree(tree) => {
+                tree.insert(seq as u32, entry);
+                Some(0)
+            }
+        }
+    }
+
+    fn remove(&mut self, seq: RtpSequenceNumber) -> Option<(RtpPacket, Instant)> {
+        match self {
+            Self::Ring(ring) => ring.remove(seq),
+            Self::Tree(tree) => tree.remove(&(seq as u32)),
+        }
+    }
+
+    fn oldest_seq(&self) -> Option<RtpSequenceNumber> {
+        match self {
+            Self::Ring(ring) => ring.first_seq(),
+            Self::Tree(tree) => tree.keys().next().map(|&seq| seq as u16),
+        }
+    }
+
+    fn pop_oldest(&mut self) {
+        match self {
+            Self::Ring(ring) => {
+                ring.pop_first();
+            }
+            Self::Tree(tree) => {
+                tree.pop_first();
+            }
+        }
+    }
+
+    /// The stored sequence number closest at or ahead of `seq`, with
+    /// wraparound
+    fn closest_ahead(&self, seq: RtpSequenceNumber) -> Option<RtpSequenceNumber> {
+        match self {
+            Self::Ring(ring) => ring.next_at_or_after(seq).or_else(|| ring.first_seq()),
+            Self::Tree(tree) => tree
+                .keys()
+                .map(|&key| key as u16)
+                .min_by_key(|&key| key.wrapping_sub(seq)),
+        }
+    }
+
+    fn clear(&mut self) {
+        match self {
+            Self::Ring(ring) => ring.clear(),
+            Self::Tree(tree) => tree.clear(),
+        }
+    }
+}
+
 impl AdaptiveJitterBuffer {
     /// Create a new adaptive jitter buffer
     pub fn new(config: JitterBufferConfig) -> Self {
@@ -206,8 +306,8 @@ impl AdaptiveJitterBuffer {
         };
 
         Self {
+            packets: PacketStore::new(&config),
             config,
-            packets: BTreeMap::new(),
             next_seq: None,
             ext_seq_base: 0,
             seq_cycles: 0,
@@ -269,7 +369,7 @@ impl AdaptiveJitterBuffer {
             trace!("First packet in buffer, initializing with seq={}", seq);
 
             // Insert the packet using the raw sequence number
-            self.packets.insert(seq as u32, (packet, now));
+            self.packets.insert(seq, (packet, now));
             self.stats.buffered_packets = self.packets.len();
 
             // Notify waiters
@@ -279,7 +379,7 @@ impl AdaptiveJitterBuffer {
         }
 
         // Check for duplicate packet
-        if self.packets.contains_key(&(seq as u32)) {
+        if self.packets.contains(seq) {
             self.stats.duplicates += 1;
             trace!("Duplicate packet detected with seq={}", seq);
             return false;
@@ -344,9 +444,7 @@ impl AdaptiveJitterBuffer {
             self.stats.packets_overflow += 1;
 
             // Drop oldest packet
-            if let Some((&oldest_seq, _)) = self.packets.iter().next() {
-                self.packets.remove(&oldest_seq);
-            }
+            self.packets.pop_oldest();
         }
 
         // Update jitter estimate
@@ -367,7 +465,14 @@ impl AdaptiveJitterBuffer {
         }
 
         // Store the packet
-        self.packets.insert(seq as u32, (packet, now));
+        match self.packets.insert(seq, (packet, now)) {
+            Some(evicted) => self.stats.packets_overflow += evicted as u64,
+            None => {
+                trace!("Packet seq={} is older than the ring window", seq);
+                self.stats.packets_too_late += 1;
+                return false;
+            }
+        }
         self.stats.buffered_packets = self.packets.len();
 
         // Set timestamps for next packet
@@ -399,34 +504,26 @@ impl AdaptiveJitterBuffer {
 
         // Always check for a better (lower) sequence number to start with
         // This ensures we deliver packets in order even when they arrive out of order
-        let lowest_seq = self.packets.keys().copied().min();
-
-        if let Some(lowest) = lowest_seq {
-            if self.next_seq.is_none() {
-                // Initialize next_seq if it's not set
-                self.next_seq = Some(lowest as u16);
-            } else if lowest < self.next_seq.unwrap() as u32 {
-                // Found a packet with lower sequence number than expected
-
-                // Special case for sequence wraparound:
-                // If lowest is very low (close to 0) and next_seq is very high (close to 65535),
-                // this is likely a wraparound condition. In this case, don't reset next_seq.
-                let next_seq = self.next_seq.unwrap();
-                if !(lowest < 1000 && next_seq > 60000) {
-                    self.next_seq = Some(lowest as u16);
-                }
+        let lowest = self.packets.oldest_seq()?;
+
+        match self.next_seq {
+            // Initialize next_seq if it's not set
+            None => self.next_seq = Some(lowest),
+            // Found a packet with lower sequence number than expected.
+            // Serial-number comparison (RFC 1982), so a low sequence
+            // number just after wraparound counts as ahead, not behind.
+            Some(next_seq) if (1..0x8000).contains(&next_seq.wrapping_sub(lowest)) => {
+                self.next_seq = Some(lowest);
             }
-        } else {
-            return None;
+            Some(_) => {}
         }
 
         let next_seq = self.next_seq.unwrap();
-        let next_seq_u32 = next_seq as u32;
 
         trace!("Getting next packet, expecting seq={}", next_seq);
 
         // Check if the next packet is available
-        if let Some((packet, arrival_time)) = self.packets.remove(&next_seq_u32) {
+        if let Some((packet, arrival_time)) = self.packets.remove(next_seq) {
             // Update next expected sequence with wraparound
             self.next_seq = Some(next_seq.wrapping_add(1));
             trace!(
@@ -457,42 +554,22 @@ impl AdaptiveJitterBuffer {
         );
         self.stats.discontinuities += 1;
 
-        // Skip forward to the next available packet
-        let mut keys: Vec<_> = self.packets.keys().copied().collect();
-        if keys.is_empty() {
+        // Skip forward to the next available packet: the closest
+        // sequence number ahead of next_seq, with wraparound handling
+        let Some(next_available) = self.packets.closest_ahead(next_seq) else {
             self.stats.underruns += 1;
             debug!("Buffer underrun, no packets available");
             return None;
-        }
-
-        // Sort the keys
-        keys.sort();
-
-        // Find the next key that is greater than next_seq with wraparound handling
-        let next_available = keys
-            .iter()
-            .min_by(|&&a, &&b| {
-                // Calculate distance from next_seq to a and b with wraparound handling
-                let dist_a = ((a as u16).wrapping_sub(next_seq) as u32) & 0xFFFF;
-                let dist_b = ((b as u16).wrapping_sub(next_seq) as u32) & 0xFFFF;
-
-                // The one with smaller distance (closest ahead) wins
-                dist_a.cmp(&dist_b)
-            })
-            .copied()
-            .unwrap_or(keys[0]);
+        };
 
-        trace!("Skipping to packet with seq={}", next_available as u16);
+        trace!("Skipping to packet with seq={}", next_available);
 
         // Update next sequence expectation
-        self.next_seq = Some((next_available as u16).wrapping_add(1));
-        debug!(
-            "Handling packet loss, skipping to seq={}",
-            next_available as u16
-        );
+        self.next_seq = Some(next_available.wrapping_add(1));
+        debug!("Handling packet loss, skipping to seq={}", next_available);
 
         // Return the packet
-        let (packet, arrival_time) = self.packets.remove(&next_available).unwrap();
+        let (packet, arrival_time) = self.packets.remove(next_available)?;
 
         // Update stats
         self.stats.packets_played += 1;
@@ -836,4 +913,43 @@ mod tests {
             "Fourth packet should have seq=1"
         );
     }
+
+    #[tokio::test]
+    async fn test_duplicate_packets() {
+        let mut jitter = AdaptiveJitterBuffer::new(JitterBufferConfig::default());
+
+        assert!(jitter.add_packet(create_test_packet(10, 0)));
+        assert!(jitter.add_packet(create_test_packet(11, 160)));
+        assert!(!jitter.add_packet(create_test_packet(11, 160)));
+        assert_eq!(jitter.get_stats().duplicates, 1);
+        assert_eq!(jitter.get_stats().buffered_packets, 2);
+    }
+
+    #[tokio::test]
+    async fn test_storage_backends_agree() {
+        // Reordering, a duplicate, a lost packet (65535) and wraparound.
+        let arrivals = [65530u16, 65532, 65531, 65533, 65532, 65534, 1, 0, 3, 2, 4];
+
+        let mut played = Vec::new();
+        for storage in [JitterBufferStorage::Ring, JitterBufferStorage::BTreeMap] {
+            let mut jitter = AdaptiveJitterBuffer::new(JitterBufferConfig {
+                storage,
+                ..Default::default()
+            });
+            for seq in arrivals {
+                jitter.add_packet(create_test_packet(seq, seq as u32 * 160));
+            }
+            let order: Vec<u16> = std::iter::from_fn(|| jitter.get_next_packet())
+                .map(|p| p.header.sequence_number)
+                .collect();
+            let stats = jitter.get_stats();
+            played.push((order, stats.duplicates, stats.discontinuities));
+        }
+
+        assert_eq!(
+            played[0].0,
+            vec![65530, 65531, 65532, 65533, 65534, 0, 1, 2, 3, 4]
+        );
+        assert_eq!(played[0], played[1]);
+    }
 }
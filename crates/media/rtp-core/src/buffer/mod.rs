@@ -5,10 +5,12 @@
 
 pub mod jitter;
 mod pool;
+mod seq_ring;
 pub mod transmit;
 
 pub use jitter::*;
 pub use pool::*;
+pub use seq_ring::*;
 pub use transmit::*;
 
 use std::sync::Arc;
@@ -0,0 +1,300 @@
+//! Fixed-capacity ring of entries indexed by RTP sequence number
+//!
+//! [`SeqRing`] is the storage behind the jitter buffers when
+//! [`JitterBufferStorage::Ring`] is selected. Slots are allocated once up
+//! front and addressed by `seq & mask`, so insert, remove, duplicate and
+//! lateness checks are O(1) and never allocate. Sequence numbers are
+//! compared with serial-number arithmetic (RFC 1982), so the window slides
+//! across the 16-bit wraparound without special cases.
+
+/// Packet storage backing a jitter buffer
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+pub enum JitterBufferStorage {
+    /// Fixed-capacity ring indexed by sequence number ([`SeqRing`])
+    #[default]
+    Ring,
+    /// Ordered map keyed by sequence number
+    BTreeMap,
+}
+
+/// Result of [`SeqRing::insert`]
+#[derive(Debug, PartialEq, Eq)]
+pub enum SeqInsert<T> {
+    /// The entry was stored; `evicted` older entries were pushed out of
+    /// the window to make room for it
+    Inserted { evicted: usize },
+    /// An entry with the same sequence number is already stored
+    Duplicate(T),
+    /// The entry is older than the window can reach back to
+    TooOld(T),
+}
+
+/// Fixed-capacity ring of entries keyed by 16-bit sequence number.
+///
+/// The ring covers a window of at most [`Self::capacity`] consecutive
+/// sequence numbers starting at the oldest stored entry. Inserting past
+/// the end of the window slides it forward and evicts whatever falls off
+/// the front.
+pub struct SeqRing<T> {
+    slots: Box<[Option<T>]>,
+    mask: u16,
+    /// Sequence number of the oldest stored entry (meaningless when empty)
+    base: u16,
+    /// Distance from `base` to the newest stored entry, plus one
+    span: usize,
+    len: usize,
+}
+
+impl<T> SeqRing<T> {
+    /// Create a ring holding at least `capacity` consecutive sequence
+    /// numbers. The capacity is rounded up to a power of two (at most
+    /// 32768, half the sequence space).
+    pub fn with_capacity(capacity: usize) -> Self {
+        let capacity = capacity.clamp(1, 0x8000).next_power_of_two();
+        let slots = std::iter::repeat_with(|| None).take(capacity).collect();
+        Self {
+            slots,
+            mask: (capacity - 1) as u16,
+            base: 0,
+            span: 0,
+            len: 0,
+        }
+    }
+
+    /// Number of consecutive sequence numbers the window can hold
+    pub fn capacity(&self) -> usize {
+        self.slots.len()
+    }
+
+    /// Number of stored entries
+    pub fn len(&self) -> usize {
+        self.len
+    }
+
+    /// Whether the ring holds no entries
+    pub fn is_empty(&self) -> bool {
+        self.len == 0
+    }
+
+    /// Sequence number of the oldest stored entry
+    pub fn first_seq(&self) -> Option<u16> {
+        (self.len > 0).then_some(self.base)
+    }
+
+    /// Whether an entry with sequence number `seq` is stored
+    pub fn contains(&self, seq: u16) -> bool {
+        self.offset(seq).is_some() && self.slots[self.slot(seq)].is_some()
+    }
+
+    /// Store `value` under `seq`.
+    pub fn insert(&mut self, seq: u16, value: T) -> SeqInsert<T> {
+        if self.len == 0 {
+            self.base = seq;
+            self.span = 1;
+            self.len = 1;
+            let slot = self.slot(seq);
+            self.slots[slot] = Some(value);
+            return SeqInsert::Inserted { evicted: 0 };
+        }
+
+        let ahead = seq.wrapping_sub(self.base);
+        let mut evicted = 0;
+        if ahead < 0x8000 {
+            let new_span = ahead as usize + 1;
+            if new_span > self.capacity() {
+                // Slide the window forward, dropping what falls off.
+                let shift = new_span - self.capacity();
+                if shift >= self.span {
+                    evicted = self.len;
+                    self.clear();
+                    return match self.insert(seq, value) {
+                        SeqInsert::Inserted { .. } => SeqInsert::Inserted { evicted },
+                        other => other,
+                    };
+                }
+                for _ in 0..shift {
+                    let slot = self.slot(self.base);
+                    if self.slots[slot].take().is_some() {
+                        self.len -= 1;
+                        evicted += 1;
+                    }
+                    self.base = self.base.wrapping_add(1);
+                    self.span -= 1;
+                }
+            }
+            let slot = self.slot(seq);
+            if self.slots[slot].is_some() {
+                return SeqInsert::Duplicate(value);
+            }
+            self.slots[slot] = Some(value);
+            self.len += 1;
+            self.span = self.span.max(seq.wrapping_sub(self.base) as usize + 1);
+            self.skip_empty_front();
+        } else {
+            // Older than anything stored: extend the window backwards if
+            // the newest entry still fits.
+            let back = self.base.wrapping_sub(seq) as usize;
+            if self.span + back > self.capacity() {
+                return SeqInsert::TooOld(value);
+            }
+            self.base = seq;
+            self.span += back;
+            let slot = self.slot(seq);
+            self.slots[slot] = Some(value);
+            self.len += 1;
+        }
+        SeqInsert::Inserted { evicted }
+    }
+
+    /// Remove and return the entry stored under `seq`
+    pub fn remove(&mut self, seq: u16) -> Option<T> {
+        self.offset(seq)?;
+        let slot = self.slot(seq);
+        let value = self.slots[slot].take()?;
+        self.len -= 1;
+        self.skip_empty_front();
+        self.skip_empty_back();
+        Some(value)
+    }
+
+    /// Remove and return the oldest stored entry
+    pub fn pop_first(&mut self) -> Option<(u16, T)> {
+        let seq = self.first_seq()?;
+        self.remove(seq).map(|value| (seq, value))
+    }
+
+    /// Sequence number of the oldest stored entry at or after `seq`.
+    ///
+    /// Scans forward from `seq`, so the cost is the length of the run of
+    /// missing sequence numbers it skips.
+    pub fn next_at_or_after(&self, seq: u16) -> Option<u16> {
+        if self.len == 0 {
+            return None;
+        }
+        if seq.wrapping_sub(self.base) >= 0x8000 {
+            return Some(self.base);
+        }
+        let start = self.offset(seq)?;
+        (start..self.span)
+            .map(|offset| self.base.wrapping_add(offset as u16))
+            .find(|&s| self.slots[self.slot(s)].is_some())
+    }
+
+    /// Drop every stored entry
+    pub fn clear(&mut self) {
+        if self.len > 0 {
+            for offset in 0..self.span {
+                let slot = self.slot(self.base.wrapping_add(offset as u16));
+                self.slots[slot] = None;
+            }
+        }
+        self.span = 0;
+        self.len = 0;
+    }
+
+    fn slot(&self, seq: u16) -> usize {
+        (seq & self.mask) as usize
+    }
+
+    /// Offset of `seq` from the oldest entry, if it lies inside the window
+    fn offset(&self, seq: u16) -> Option<usize> {
+        let offset = seq.wrapping_sub(self.base) as usize;
+        (self.len > 0 && offset < self.span).then_some(offset)
+    }
+
+    /// Keep `base` on a stored entry after the front has been removed
+    fn skip_empty_front(&mut self) {
+        if self.len == 0 {
+            self.span = 0;
+            return;
+        }
+        while self.slots[self.slot(self.base)].is_none() {
+            self.base = self.base.wrapping_add(1);
+            self.span -= 1;
+        }
+    }
+
+    /// Keep the window ending on a stored entry after the back has been
+    /// removed
+    fn skip_empty_back(&mut self) {
+        while self.span > 0
+            && self.slots[self.slot(self.base.wrapping_add(self.span as u16 - 1))].is_none()
+        {
+            self.span -= 1;
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_in_order_and_reordered() {
+        let mut ring = SeqRing::with_capacity(8);
+        assert_eq!(ring.insert(11, 'b'), SeqInsert::Inserted { evicted: 0 });
+        assert_eq!(ring.insert(10, 'a'), SeqInsert::Inserted { evicted: 0 });
+        assert_eq!(ring.insert(13, 'd'), SeqInsert::Inserted { evicted: 0 });
+        assert_eq!(ring.first_seq(), Some(10));
+        assert_eq!(ring.len(), 3);
+
+        assert_eq!(ring.pop_first(), Some((10, 'a')));
+        assert_eq!(ring.pop_first(), Some((11, 'b')));
+        // 12 is missing; the next entry at or after it is 13.
+        assert_eq!(ring.next_at_or_after(12), Some(13));
+        assert_eq!(ring.remove(13), Some('d'));
+        assert!(ring.is_empty());
+        assert_eq!(ring.first_seq(), None);
+    }
+
+    #[test]
+    fn test_duplicates_and_too_old() {
+        let mut ring = SeqRing::with_capacity(4);
+        ring.insert(100, 1);
+        assert_eq!(ring.insert(100, 2), SeqInsert::Duplicate(2));
+        ring.insert(103, 3);
+        // Window is 100..=103; 99 would need five slots.
+        assert_eq!(ring.insert(99, 4), SeqInsert::TooOld(4));
+        assert!(ring.contains(103));
+        assert!(!ring.contains(101));
+        assert!(!ring.contains(99));
+    }
+
+    #[test]
+    fn test_window_slides_and_evicts() {
+        let mut ring = SeqRing::with_capacity(4);
+        ring.insert(1, ());
+        ring.insert(2, ());
+        ring.insert(4, ());
+        // 6 needs the window 3..=6, pushing out 1 and 2.
+        assert_eq!(ring.insert(6, ()), SeqInsert::Inserted { evicted: 2 });
+        assert_eq!(ring.first_seq(), Some(4));
+        // A jump far ahead empties the ring.
+        assert_eq!(ring.insert(1000, ()), SeqInsert::Inserted { evicted: 2 });
+        assert_eq!(ring.len(), 1);
+        assert_eq!(ring.first_seq(), Some(1000));
+    }
+
+    #[test]
+    fn test_sequence_wraparound() {
+        let mut ring = SeqRing::with_capacity(16);
+        for seq in [65534u16, 0, 65535, 1] {
+            assert_eq!(ring.insert(seq, seq), SeqInsert::Inserted { evicted: 0 });
+        }
+        assert_eq!(ring.next_at_or_after(65533), Some(65534));
+        let order: Vec<u16> = std::iter::from_fn(|| ring.pop_first().map(|(s, _)| s)).collect();
+        assert_eq!(order, vec![65534, 65535, 0, 1]);
+    }
+
+    #[test]
+    fn test_clear_resets_window() {
+        let mut ring = SeqRing::with_capacity(4);
+        ring.insert(7, ());
+        ring.insert(9, ());
+        ring.clear();
+        assert!(ring.is_empty());
+        assert!(!ring.contains(7));
+        assert_eq!(ring.insert(500, ()), SeqInsert::Inserted { evicted: 0 });
+        assert_eq!(ring.first_seq(), Some(500));
+    }
+}
@@ -129,11 +129,12 @@ impl DtlsConnection {
         }
 
         // Initialize the handshake state
-        let handshake = HandshakeState::new(
+        let mut handshake = HandshakeState::new(
             self.config.role,
             self.config.version,
             self.config.max_retransmissions,
         );
+        handshake.set_srtp_profiles(self.offered_srtp_profiles());
         self.handshake = Some(handshake);
 
         // Start handshake process in background
@@ -149,7 +150,7 @@ impl DtlsConnection {
         let transport = self.transport.as_ref().unwrap().clone();
         let remote_addr = self.remote_addr.unwrap();
         let handshake_complete_tx = self.handshake_complete_tx.take().unwrap();
-        let _srtp_profiles = self.config.srtp_profiles.clone();
+        let srtp_profiles = self.offered_srtp_profiles();
         let _local_cert = self.local_cert.clone();
         let version = self.config.version;
         let max_retransmissions = self.config.max_retransmissions;
@@ -157,8 +158,9 @@ impl DtlsConnection {
         // Create a separate async function to handle the handshake
         let handle_handshake = async move {
             // Create a new handshake state machine
-            let handshake =
+            let mut handshake =
                 super::handshake::HandshakeState::new(role, version, max_retransmissions);
+            handshake.set_srtp_profiles(srtp_profiles);
 
             // Initialize transport handler
             struct HandshakeHandler {
@@ -431,15 +433,9 @@ impl DtlsConnection {
                                                             );
 
                                                             // Determine SRTP profile
-                                                            let srtp_profile = match self.handshake.srtp_profile() {
-                                                                Some(profile) => {
-                                                                    match profile {
-                                                                        0x0001 => Some(super::message::extension::SrtpProtectionProfile::Aes128CmSha1_80),
-                                                                        0x0002 => Some(super::message::extension::SrtpProtectionProfile::Aes128CmSha1_32),
-                                                                        _ => None,
-                                                                    }
-                                                                },
-                                                                None => None,
+                                                            let srtp_profile = match self.handshake.srtp_profile().map(SrtpProtectionProfile::from) {
+                                                                Some(SrtpProtectionProfile::Unknown(_)) | None => None,
+                                                                profile => profile,
                                                             };
 
                                                             // Return the result
@@ -955,6 +951,16 @@ impl DtlsConnection {
         self.srtp_profile
     }
 
+    /// DTLS protection profiles for the configured SRTP suites, in
+    /// preference order; suites without a DTLS-SRTP profile are skipped
+    fn offered_srtp_profiles(&self) -> Vec<SrtpProtectionProfile> {
+        self.config
+            .srtp_profiles
+            .iter()
+            .filter_map(super::srtp::extractor::convert_suite_to_profile)
+            .collect()
+    }
+
     /// Get the local certificate
     pub fn local_certificate(&self) -> Option<&Certificate> {
         self.local_cert.as_ref()
@@ -187,7 +187,12 @@ impl HandshakeState {
             srtp_profile: None,
             cookie: None,
             session_id: None,
-            available_srtp_profiles: vec![SrtpProtectionProfile::Aes128CmSha1_80],
+            available_srtp_profiles: vec![
+                SrtpProtectionProfile::AeadAes128Gcm,
+                SrtpProtectionProfile::AeadAes256Gcm,
+                SrtpProtectionProfile::Aes128CmSha1_80,
+                SrtpProtectionProfile::Aes128CmSha1_32,
+            ],
             local_ecdhe_private_key: None,
             local_ecdhe_public_key: None,
             remote_ecdhe_public_key: None,
@@ -1138,8 +1143,7 @@ impl HandshakeState {
         let compression_methods = vec![0];
 
         // Add SRTP extension
-        let srtp_extension =
-            UseSrtpExtension::with_profiles(vec![SrtpProtectionProfile::Aes128CmSha1_80]);
+        let srtp_extension = UseSrtpExtension::with_profiles(self.available_srtp_profiles.clone());
 
         let extensions = vec![Extension::UseSrtp(srtp_extension)];
 
@@ -1246,6 +1250,12 @@ impl HandshakeState {
         self.srtp_profile
     }
 
+    /// Set the SRTP protection profiles offered (client) or accepted
+    /// (server), in order of preference
+    pub fn set_srtp_profiles(&mut self, profiles: Vec<SrtpProtectionProfile>) {
+        self.available_srtp_profiles = profiles;
+    }
+
     /// Get the cookie if any (debug helper)
     pub fn cookie(&self) -> Option<&Bytes> {
         self.cookie.as_ref()
@@ -385,6 +385,8 @@ impl ClientHello {
         // Add SRTP extension
         let srtp_extension =
             crate::dtls::message::extension::UseSrtpExtension::with_profiles(vec![
+                crate::dtls::message::extension::SrtpProtectionProfile::AeadAes128Gcm,
+                crate::dtls::message::extension::SrtpProtectionProfile::AeadAes256Gcm,
                 crate::dtls::message::extension::SrtpProtectionProfile::Aes128CmSha1_80,
                 crate::dtls::message::extension::SrtpProtectionProfile::Aes128CmSha1_32,
             ]);
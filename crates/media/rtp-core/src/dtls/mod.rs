@@ -64,6 +64,8 @@ impl Default for DtlsConfig {
             mtu: 1200,
             max_retransmissions: 5,
             srtp_profiles: vec![
+                crate::srtp::SRTP_AEAD_AES_128_GCM,
+                crate::srtp::SRTP_AEAD_AES_256_GCM,
                 crate::srtp::SRTP_AES128_CM_SHA1_80,
                 crate::srtp::SRTP_AES128_CM_SHA1_32,
             ],
@@ -7,6 +7,7 @@ use crate::dtls::message::extension::SrtpProtectionProfile;
 use crate::dtls::Result;
 use crate::srtp::{
     SrtpAuthenticationAlgorithm, SrtpCryptoKey, SrtpCryptoSuite, SrtpEncryptionAlgorithm,
+    SRTP_AEAD_AES_128_GCM, SRTP_AEAD_AES_256_GCM,
 };
 
 /// DTLS-SRTP context after key extraction
@@ -57,7 +58,8 @@ pub fn extract_srtp_keys_from_dtls(
 
     // Get key and salt lengths based on the crypto suite
     let key_length = crypto_suite.key_length;
-    let salt_length = 14; // SRTP standard salt length
+    // 14 bytes for AES-CM, 12 bytes for AEAD profiles (RFC 7714 §12)
+    let salt_length = crypto_suite.salt_length();
 
     // Extract client and server keys
     let (client_key, client_salt) = extract_srtp_keys(
@@ -105,20 +107,26 @@ fn convert_profile_to_suite(profile: SrtpProtectionProfile) -> Result<SrtpCrypto
                 tag_length: 4,  // 32 bits
             })
         }
-        SrtpProtectionProfile::AeadAes128Gcm => {
-            // This would require adding an AEAD encryption algorithm to the SRTP module
-            Err(crate::error::Error::UnsupportedFeature(
-                "AEAD GCM crypto suite not yet supported".to_string(),
-            ))
-        }
-        SrtpProtectionProfile::AeadAes256Gcm => {
-            // This would require adding an AEAD encryption algorithm to the SRTP module
-            Err(crate::error::Error::UnsupportedFeature(
-                "AEAD GCM crypto suite not yet supported".to_string(),
-            ))
-        }
+        SrtpProtectionProfile::AeadAes128Gcm => Ok(SRTP_AEAD_AES_128_GCM),
+        SrtpProtectionProfile::AeadAes256Gcm => Ok(SRTP_AEAD_AES_256_GCM),
         SrtpProtectionProfile::Unknown(_) => Err(crate::error::Error::UnsupportedFeature(
             "Unknown SRTP protection profile".to_string(),
         )),
     }
 }
+
+/// Convert an SRTP crypto suite to the DTLS protection profile that
+/// negotiates it, if there is one (RFC 5764 §4.1.2, RFC 7714 §14.2)
+pub fn convert_suite_to_profile(suite: &SrtpCryptoSuite) -> Option<SrtpProtectionProfile> {
+    match (suite.encryption, suite.authentication, suite.key_length) {
+        (SrtpEncryptionAlgorithm::AesCm, SrtpAuthenticationAlgorithm::HmacSha1_80, 16) => {
+            Some(SrtpProtectionProfile::Aes128CmSha1_80)
+        }
+        (SrtpEncryptionAlgorithm::AesCm, SrtpAuthenticationAlgorithm::HmacSha1_32, 16) => {
+            Some(SrtpProtectionProfile::Aes128CmSha1_32)
+        }
+        (SrtpEncryptionAlgorithm::AeadAesGcm, _, 16) => Some(SrtpProtectionProfile::AeadAes128Gcm),
+        (SrtpEncryptionAlgorithm::AeadAesGcm, _, 32) => Some(SrtpProtectionProfile::AeadAes256Gcm),
+        _ => None,
+    }
+}
@@ -84,6 +84,10 @@ pub mod sync;
 /// The default maximum size for RTP packets in bytes
 pub const DEFAULT_MAX_PACKET_SIZE: usize = 1500;
 
+/// RFC 4733 `telephone-event` payload type assumed until SDP negotiates
+/// another one (101 by convention; it is a dynamic payload type)
+pub const DEFAULT_TELEPHONE_EVENT_PAYLOAD_TYPE: u8 = 101;
+
 /// Typedef for RTP timestamp values
 pub type RtpTimestamp = u32;
 
@@ -123,7 +127,11 @@ pub use session::{
 };
 
 // Re-export transport types
-pub use transport::{RtpTransport, RtpTransportBufferConfig, RtpTransportConfig, UdpRtpTransport};
+pub use transport::{
+    DemuxSessionConfig, RtpForwardGuard, RtpForwardStats, RtpForwardTarget, RtpTransport,
+    RtpTransportBufferConfig, RtpTransportConfig, SharedRtpSocket, SharedRtpSocketConfig,
+    UdpRtpTransport,
+};
 
 // Re-export traits for media-core integration
 pub use traits::media_transport::RtpMediaTransport;
@@ -1,6 +1,8 @@
 //! RFC 8489 STUN message codec — Binding Request encode + Binding
 //! Response decode for the `MAPPED-ADDRESS` / `XOR-MAPPED-ADDRESS`
-//! attributes only.
+//! attributes, plus the ICE-lite responder side: Binding Request decode
+//! (`USERNAME`, `USE-CANDIDATE`), short-term `MESSAGE-INTEGRITY`
+//! verification and Binding Success Response encode.
 //!
 //! Wire format (§5):
 //!
@@ -22,10 +24,14 @@
 
 use std::net::{IpAddr, Ipv4Addr, Ipv6Addr, SocketAddr};
 
+use hmac::{Hmac, Mac};
 use rand::RngCore;
+use sha1::Sha1;
 
 use super::StunError;
 
+type HmacSha1 = Hmac<Sha1>;
+
 /// RFC 8489 §6 fixed magic cookie.
 pub const MAGIC_COOKIE: u32 = 0x2112_A442;
 
@@ -38,6 +44,19 @@ const BINDING_RESPONSE: u16 = 0x0101;
 const ATTR_MAPPED_ADDRESS: u16 = 0x0001;
 /// `XOR-MAPPED-ADDRESS` attribute type (RFC 8489 §14.2).
 const ATTR_XOR_MAPPED_ADDRESS: u16 = 0x0020;
+/// `USERNAME` attribute type (RFC 8489 §14.3).
+const ATTR_USERNAME: u16 = 0x0006;
+/// `MESSAGE-INTEGRITY` attribute type (RFC 8489 §14.5).
+const ATTR_MESSAGE_INTEGRITY: u16 = 0x0008;
+/// `USE-CANDIDATE` attribute type (RFC 8445 §16.1).
+const ATTR_USE_CANDIDATE: u16 = 0x0025;
+/// `FINGERPRINT` attribute type (RFC 8489 §14.7).
+const ATTR_FINGERPRINT: u16 = 0x8028;
+
+/// HMAC-SHA1 output carried in `MESSAGE-INTEGRITY`.
+const MESSAGE_INTEGRITY_LEN: usize = 20;
+/// XOR'd into the CRC-32 for `FINGERPRINT` (RFC 8489 §14.7).
+const FINGERPRINT_XOR: u32 = 0x5354_554E;
 
 const FAMILY_IPV4: u8 = 0x01;
 const FAMILY_IPV6: u8 = 0x02;
@@ -151,6 +170,218 @@ pub fn decode_binding_response(
     found_xor.or(found_plain).ok_or(StunError::NoMappedAddress)
 }
 
+/// Inbound Binding Request as seen by an ICE-lite responder.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct BindingRequest<'a> {
+    /// Transaction id to echo in the response.
+    pub transaction_id: [u8; TXN_ID_LEN],
+    /// `USERNAME` value (`"<local ufrag>:<remote ufrag>"` for ICE).
+    pub username: Option<&'a [u8]>,
+    /// The controlling agent nominated this pair (RFC 8445 §7.1.2).
+    pub use_candidate: bool,
+    /// Offset of the `MESSAGE-INTEGRITY` attribute header, if present.
+    integrity_offset: Option<usize>,
+}
+
+impl BindingRequest<'_> {
+    /// The local ufrag, i.e. `USERNAME` up to the first `:`.
+    pub fn local_ufrag(&self) -> Option<&[u8]> {
+        let username = self.username?;
+        Some(
+            username
+                .iter()
+                .position(|&b| b == b':')
+                .map_or(username, |colon| &username[..colon]),
+        )
+    }
+
+    /// Verify `MESSAGE-INTEGRITY` against the short-term credential `key`
+    /// (the local ICE password). `message` must be the buffer this request
+    /// was decoded from. Returns `false` when the attribute is absent.
+    pub fn verify_integrity(&self, message: &[u8], key: &[u8]) -> bool {
+        let Some(offset) = self.integrity_offset else {
+            return false;
+        };
+        // RFC 8489 §14.5: HMAC over everything before the attribute, with
+        // the header length rewritten to end just after it.
+        let covered_len = (offset + 4 + MESSAGE_INTEGRITY_LEN - HEADER_LEN) as u16;
+        let Ok(mut mac) = HmacSha1::new_from_slice(key) else {
+            return false;
+        };
+        mac.update(&message[..2]);
+        mac.update(&covered_len.to_be_bytes());
+        mac.update(&message[4..offset]);
+        mac.verify_slice(&message[offset + 4..offset + 4 + MESSAGE_INTEGRITY_LEN])
+            .is_ok()
+    }
+}
+
+/// Decode a Binding Request. Attributes other than `USERNAME`,
+/// `MESSAGE-INTEGRITY` and `USE-CANDIDATE` are skipped; anything after
+/// `MESSAGE-INTEGRITY` other than `FINGERPRINT` is ignored per RFC 8489
+/// §14.5.
+pub fn decode_binding_request(bytes: &[u8]) -> Result<BindingRequest<'_>, StunError> {
+    if bytes.len() < HEADER_LEN {
+        return Err(StunError::TooShort { got: bytes.len() });
+    }
+
+    let msg_type = u16::from_be_bytes([bytes[0], bytes[1]]);
+    let msg_len = u16::from_be_bytes([bytes[2], bytes[3]]) as usize;
+    let cookie = u32::from_be_bytes([bytes[4], bytes[5], bytes[6], bytes[7]]);
+
+    if cookie != MAGIC_COOKIE {
+        return Err(StunError::MagicCookieMismatch {
+            got: cookie,
+            expected: MAGIC_COOKIE,
+        });
+    }
+    if msg_type != BINDING_REQUEST {
+        return Err(StunError::NotBindingRequest(msg_type));
+    }
+    if HEADER_LEN + msg_len > bytes.len() {
+        return Err(StunError::AttributeTruncated {
+            got: bytes.len(),
+            need: HEADER_LEN + msg_len,
+        });
+    }
+
+    let mut request = BindingRequest {
+        transaction_id: [0; TXN_ID_LEN],
+        username: None,
+        use_candidate: false,
+        integrity_offset: None,
+    };
+    request.transaction_id.copy_from_slice(&bytes[8..20]);
+
+    let mut cursor = HEADER_LEN;
+    let body_end = HEADER_LEN + msg_len;
+    while cursor + 4 <= body_end {
+        let attr_type = u16::from_be_bytes([bytes[cursor], bytes[cursor + 1]]);
+        let attr_len = u16::from_be_bytes([bytes[cursor + 2], bytes[cursor + 3]]) as usize;
+        let body_start = cursor + 4;
+        let body_end_attr = body_start + attr_len;
+        if body_end_attr > body_end {
+            return Err(StunError::AttributeTruncated {
+                got: body_end - body_start,
+                need: attr_len,
+            });
+        }
+
+        if request.integrity_offset.is_some() {
+            // Only FINGERPRINT may follow MESSAGE-INTEGRITY.
+            break;
+        }
+        match attr_type {
+            ATTR_USERNAME => request.username = Some(&bytes[body_start..body_end_attr]),
+            ATTR_USE_CANDIDATE => request.use_candidate = true,
+            ATTR_MESSAGE_INTEGRITY => {
+                if attr_len != MESSAGE_INTEGRITY_LEN {
+                    return Err(StunError::AttributeTruncated {
+                        got: attr_len,
+                        need: MESSAGE_INTEGRITY_LEN,
+                    });
+                }
+                request.integrity_offset = Some(cursor);
+            }
+            _ => {
+                tracing::trace!("STUN: skipping request attribute type 0x{:04x}", attr_type);
+            }
+        }
+
+        cursor = body_start + ((attr_len + 3) & !3);
+    }
+
+    Ok(request)
+}
+
+/// Encode a Binding Success Response carrying `XOR-MAPPED-ADDRESS` for
+/// `mapped`, then `MESSAGE-INTEGRITY` (when `integrity_key` is set) and
+/// `FINGERPRINT`, into `out` (cleared first).
+pub fn encode_binding_success(
+    transaction_id: &[u8; TXN_ID_LEN],
+    mapped: SocketAddr,
+    integrity_key: Option<&[u8]>,
+    out: &mut Vec<u8>,
+) {
+    out.clear();
+    out.extend_from_slice(&BINDING_RESPONSE.to_be_bytes());
+    out.extend_from_slice(&0u16.to_be_bytes()); // patched per attribute
+    out.extend_from_slice(&MAGIC_COOKIE.to_be_bytes());
+    out.extend_from_slice(transaction_id);
+
+    let xport = mapped.port() ^ ((MAGIC_COOKIE >> 16) as u16);
+    match mapped.ip() {
+        IpAddr::V4(v4) => {
+            push_attr_header(out, ATTR_XOR_MAPPED_ADDRESS, 8);
+            out.extend_from_slice(&[0, FAMILY_IPV4]);
+            out.extend_from_slice(&xport.to_be_bytes());
+            out.extend_from_slice(&(u32::from_be_bytes(v4.octets()) ^ MAGIC_COOKIE).to_be_bytes());
+        }
+        IpAddr::V6(v6) => {
+            push_attr_header(out, ATTR_XOR_MAPPED_ADDRESS, 20);
+            out.extend_from_slice(&[0, FAMILY_IPV6]);
+            out.extend_from_slice(&xport.to_be_bytes());
+            let mut mask = [0u8; 16];
+            mask[0..4].copy_from_slice(&MAGIC_COOKIE.to_be_bytes());
+            mask[4..16].copy_from_slice(transaction_id);
+            out.extend(v6.octets().iter().zip(mask).map(|(b, m)| b ^ m));
+        }
+    }
+
+    if let Some(key) = integrity_key {
+        let covered_len = out.len() + 4 + MESSAGE_INTEGRITY_LEN;
+        set_message_len(out, covered_len);
+        let mut mac = HmacSha1::new_from_slice(key).expect("HMAC accepts any key length");
+        mac.update(out);
+        let tag = mac.finalize().into_bytes();
+        push_attr_header(out, ATTR_MESSAGE_INTEGRITY, MESSAGE_INTEGRITY_LEN as u16);
+        out.extend_from_slice(&tag);
+    }
+
+    let total_len = out.len() + 8;
+    set_message_len(out, total_len);
+    let fingerprint = crc32(out) ^ FINGERPRINT_XOR;
+    push_attr_header(out, ATTR_FINGERPRINT, 4);
+    out.extend_from_slice(&fingerprint.to_be_bytes());
+}
+
+fn push_attr_header(out: &mut Vec<u8>, attr_type: u16, len: u16) {
+    out.extend_from_slice(&attr_type.to_be_bytes());
+    out.extend_from_slice(&len.to_be_bytes());
+}
+
+/// Rewrite the header length so the message ends at `total_len` bytes.
+fn set_message_len(out: &mut [u8], total_len: usize) {
+    out[2..4].copy_from_slice(&((total_len - HEADER_LEN) as u16).to_be_bytes());
+}
+
+/// CRC-32 (ISO-HDLC, as used by `FINGERPRINT`).
+fn crc32(bytes: &[u8]) -> u32 {
+    const TABLE: [u32; 256] = {
+        let mut table = [0u32; 256];
+        let mut i = 0;
+        while i < 256 {
+            let mut crc = i as u32;
+            let mut bit = 0;
+            while bit < 8 {
+                crc = if crc & 1 != 0 {
+                    (crc >> 1) ^ 0xEDB8_8320
+                } else {
+                    crc >> 1
+                };
+                bit += 1;
+            }
+            table[i] = crc;
+            i += 1;
+        }
+        table
+    };
+
+    !bytes.iter().fold(!0u32, |crc, &b| {
+        TABLE[((crc ^ b as u32) & 0xff) as usize] ^ (crc >> 8)
+    })
+}
+
 fn decode_mapped_address(body: &[u8]) -> Result<SocketAddr, StunError> {
     if body.len() < 4 {
         return Err(StunError::AttributeTruncated {
@@ -402,6 +633,119 @@ mod tests {
         assert!(matches!(err, StunError::NoMappedAddress));
     }
 
+    #[test]
+    fn crc32_matches_reference_vector() {
+        assert_eq!(crc32(b"123456789"), 0xCBF4_3926);
+    }
+
+    /// Build an ICE connectivity check: USERNAME, USE-CANDIDATE,
+    /// MESSAGE-INTEGRITY keyed with `key`, FINGERPRINT.
+    fn craft_binding_request(txn: &[u8; TXN_ID_LEN], username: &[u8], key: &[u8]) -> Vec<u8> {
+        let mut msg = Vec::new();
+        msg.extend_from_slice(&BINDING_REQUEST.to_be_bytes());
+        msg.extend_from_slice(&0u16.to_be_bytes());
+        msg.extend_from_slice(&MAGIC_COOKIE.to_be_bytes());
+        msg.extend_from_slice(txn);
+        push_attr_header(&mut msg, ATTR_USERNAME, username.len() as u16);
+        msg.extend_from_slice(username);
+        while msg.len() % 4 != 0 {
+            msg.push(0);
+        }
+        push_attr_header(&mut msg, ATTR_USE_CANDIDATE, 0);
+        let covered_len = msg.len() + 4 + MESSAGE_INTEGRITY_LEN;
+        set_message_len(&mut msg, covered_len);
+        let mut mac = HmacSha1::new_from_slice(key).unwrap();
+        mac.update(&msg);
+        let tag = mac.finalize().into_bytes();
+        push_attr_header(
+            &mut msg,
+            ATTR_MESSAGE_INTEGRITY,
+            MESSAGE_INTEGRITY_LEN as u16,
+        );
+        msg.extend_from_slice(&tag);
+        let total_len = msg.len() + 8;
+        set_message_len(&mut msg, total_len);
+        let fingerprint = crc32(&msg) ^ FINGERPRINT_XOR;
+        push_attr_header(&mut msg, ATTR_FINGERPRINT, 4);
+        msg.extend_from_slice(&fingerprint.to_be_bytes());
+        msg
+    }
+
+    #[test]
+    fn binding_request_decodes_ice_attributes_and_verifies_integrity() {
+        let txn = [0x5Au8; TXN_ID_LEN];
+        let msg = craft_binding_request(&txn, b"lfrag:rfrag", b"local-password");
+        let request = decode_binding_request(&msg).unwrap();
+        assert_eq!(request.transaction_id, txn);
+        assert_eq!(request.local_ufrag(), Some(&b"lfrag"[..]));
+        assert!(request.use_candidate);
+        assert!(request.verify_integrity(&msg, b"local-password"));
+        assert!(!request.verify_integrity(&msg, b"wrong-password"));
+    }
+
+    /// RFC 5769 §2.1 sample request (short-term credentials).
+    #[test]
+    fn rfc5769_sample_request_verifies() {
+        const SAMPLE: [u8; 108] = [
+            0x00, 0x01, 0x00, 0x58, 0x21, 0x12, 0xa4, 0x42, 0xb7, 0xe7, 0xa7, 0x01, 0xbc, 0x34,
+            0xd6, 0x86, 0xfa, 0x87, 0xdf, 0xae, 0x80, 0x22, 0x00, 0x10, 0x53, 0x54, 0x55, 0x4e,
+            0x20, 0x74, 0x65, 0x73, 0x74, 0x20, 0x63, 0x6c, 0x69, 0x65, 0x6e, 0x74, 0x00, 0x24,
+            0x00, 0x04, 0x6e, 0x00, 0x01, 0xff, 0x80, 0x29, 0x00, 0x08, 0x93, 0x2f, 0xf9, 0xb1,
+            0x51, 0x26, 0x3b, 0x36, 0x00, 0x06, 0x00, 0x09, 0x65, 0x76, 0x74, 0x6a, 0x3a, 0x68,
+            0x36, 0x76, 0x59, 0x20, 0x20, 0x20, 0x00, 0x08, 0x00, 0x14, 0x9a, 0xea, 0xa7, 0x0c,
+            0xbf, 0xd8, 0xcb, 0x56, 0x78, 0x1e, 0xf2, 0xb5, 0xb2, 0xd3, 0xf2, 0x49, 0xc1, 0xb5,
+            0x71, 0xa2, 0x80, 0x28, 0x00, 0x04, 0xe5, 0x7a, 0x3b, 0xcf,
+        ];
+        let request = decode_binding_request(&SAMPLE).unwrap();
+        assert_eq!(request.username, Some(&b"evtj:h6vY"[..]));
+        assert_eq!(request.local_ufrag(), Some(&b"evtj"[..]));
+        assert!(!request.use_candidate);
+        assert!(request.verify_integrity(&SAMPLE, b"VOkJxbRl1RmTxUk/WvJxBt"));
+        assert_eq!(crc32(&SAMPLE[..100]) ^ FINGERPRINT_XOR, 0xe57a_3bcf);
+    }
+
+    #[test]
+    fn binding_request_rejects_responses() {
+        let txn = [0x10u8; TXN_ID_LEN];
+        let bytes = craft_binding_response("1.2.3.4:5".parse().unwrap(), &txn);
+        assert!(matches!(
+            decode_binding_request(&bytes),
+            Err(StunError::NotBindingRequest(BINDING_RESPONSE))
+        ));
+    }
+
+    #[test]
+    fn binding_success_round_trips_and_carries_valid_integrity_and_fingerprint() {
+        let txn = [0x21u8; TXN_ID_LEN];
+        for mapped in ["203.0.113.9:4000", "[2001:db8::7]:5000"] {
+            let mapped: SocketAddr = mapped.parse().unwrap();
+            let mut out = Vec::new();
+            encode_binding_success(&txn, mapped, Some(b"pwd"), &mut out);
+            assert_eq!(decode_binding_response(&out, &txn).unwrap(), mapped);
+            assert_eq!(
+                u16::from_be_bytes([out[2], out[3]]) as usize,
+                out.len() - HEADER_LEN
+            );
+
+            // FINGERPRINT covers everything before it.
+            let fp_offset = out.len() - 8;
+            assert_eq!(
+                u16::from_be_bytes([out[fp_offset], out[fp_offset + 1]]),
+                ATTR_FINGERPRINT
+            );
+            let fingerprint = u32::from_be_bytes(out[fp_offset + 4..].try_into().unwrap());
+            assert_eq!(fingerprint, crc32(&out[..fp_offset]) ^ FINGERPRINT_XOR);
+
+            // MESSAGE-INTEGRITY immediately precedes it.
+            let mi_offset = fp_offset - 4 - MESSAGE_INTEGRITY_LEN;
+            let mut check = out[..mi_offset].to_vec();
+            set_message_len(&mut check, mi_offset + 4 + MESSAGE_INTEGRITY_LEN);
+            let mut mac = HmacSha1::new_from_slice(b"pwd").unwrap();
+            mac.update(&check);
+            mac.verify_slice(&out[mi_offset + 4..fp_offset]).unwrap();
+        }
+    }
+
     #[test]
     fn legacy_mapped_address_fallback_decodes_when_no_xor() {
         let txn = [0x77u8; TXN_ID_LEN];
@@ -1,4 +1,4 @@
-//! RFC 8489 STUN client (Binding Request / Response only).
+//! RFC 8489 STUN client and ICE-lite responder codec (Binding only).
 //!
 //! Hand-rolled minimal codec — no `webrtc-stun` / `stun_codec` dep.
 //! The wire surface is small and the alternative (an external crate)
@@ -16,19 +16,28 @@
 //! - One-shot async [`StunClient::discover`] that sends a request and
 //!   waits for the matching response, with retry/timeout per RFC 8489
 //!   §6.2.1 (RTO-driven, capped probe budget).
+//! - ICE-lite responder (RFC 8445 §2.5): [`decode_binding_request`]
+//!   (`USERNAME`, `USE-CANDIDATE`, short-term `MESSAGE-INTEGRITY`
+//!   verification) and [`encode_binding_success`] (`XOR-MAPPED-ADDRESS`,
+//!   `MESSAGE-INTEGRITY`, `FINGERPRINT`). The shared-socket RTP
+//!   demultiplexer answers connectivity checks inline with these.
 //!
 //! ## Out of scope (deferred)
 //!
-//! - Long-term credential / MESSAGE-INTEGRITY / FINGERPRINT — Sprint
-//!   4 D3 (ICE) prerequisite.
+//! - Long-term credentials, and MESSAGE-INTEGRITY / FINGERPRINT on
+//!   the client's own requests — Sprint 4 D3 (ICE) prerequisite.
 //! - Comprehension-required attribute handling on responses (RFC
 //!   8489 §14, error 420). The response surface we accept is the
 //!   common-case `XOR-MAPPED-ADDRESS` only.
-//! - Server-side responder. We are a UAC.
+//! - Full ICE agent (candidate gathering, our own connectivity checks,
+//!   401/487 error responses).
 
 mod message;
 
-pub use message::{decode_binding_response, encode_binding_request, MAGIC_COOKIE};
+pub use message::{
+    decode_binding_request, decode_binding_response, encode_binding_request,
+    encode_binding_success, BindingRequest, MAGIC_COOKIE,
+};
 
 use std::io;
 use std::net::SocketAddr;
@@ -49,6 +58,8 @@ pub enum StunError {
     TransactionIdMismatch,
     #[error("STUN message type 0x{0:04x} is not a Binding Response")]
     NotBindingResponse(u16),
+    #[error("STUN message type 0x{0:04x} is not a Binding Request")]
+    NotBindingRequest(u16),
     #[error("STUN response carried no MAPPED-ADDRESS or XOR-MAPPED-ADDRESS")]
     NoMappedAddress,
     #[error("STUN attribute family 0x{0:02x} unrecognised (expected 0x01 IPv4 or 0x02 IPv6)")]
@@ -310,6 +310,44 @@ impl RtpHeader {
         })
     }
 
+    /// Length of the RTP header at the start of `data` (fixed header, CSRC
+    /// list and extension), validated against the buffer but without
+    /// parsing or allocating anything
+    pub fn wire_size(data: &[u8]) -> Result<usize> {
+        if data.len() < RTP_MIN_HEADER_SIZE {
+            return Err(Error::BufferTooSmall {
+                required: RTP_MIN_HEADER_SIZE,
+                available: data.len(),
+            });
+        }
+        let version = data[0] >> 6;
+        if version != RTP_VERSION {
+            return Err(Error::InvalidPacket(format!(
+                "Invalid RTP version: {}",
+                version
+            )));
+        }
+
+        let mut size = RTP_MIN_HEADER_SIZE + (data[0] & 0x0F) as usize * 4;
+        if data[0] & 0x10 != 0 {
+            if data.len() < size + 4 {
+                return Err(Error::BufferTooSmall {
+                    required: size + 4,
+                    available: data.len(),
+                });
+            }
+            let words = u16::from_be_bytes([data[size + 2], data[size + 3]]) as usize;
+            size += 4 + words * 4;
+        }
+        if data.len() < size {
+            return Err(Error::BufferTooSmall {
+                required: size,
+                available: data.len(),
+            });
+        }
+        Ok(size)
+    }
+
     /// Parse an RTP header from bytes without consuming the buffer
     /// Returns the header and the number of bytes consumed
     pub fn parse_without_consuming(data: &[u8]) -> Result<(Self, usize)> {
@@ -111,19 +111,26 @@ impl RtpPacket {
     /// performs an internal reallocation that only pays off when the
     /// buffer is reused across repeated calls.
     pub fn serialize_into(&self, buf: &mut BytesMut) -> Result<Bytes> {
-        let total_size = self.size();
-        buf.reserve(total_size);
+        self.write_to(buf)?;
+
+        // Split off exactly the bytes we wrote and freeze them into an
+        // immutable Bytes view. `buf` retains any leftover capacity for
+        // the next packet.
+        Ok(buf.split().freeze())
+    }
+
+    /// Append the wire form of this packet to `buf` without splitting it
+    /// off, so the caller can keep working on the bytes in place (e.g.
+    /// [`crate::srtp::SrtpContext::protect_in_place`]).
+    pub fn write_to(&self, buf: &mut BytesMut) -> Result<()> {
+        buf.reserve(self.size());
 
         // Serialize the header
         self.header.serialize(buf)?;
 
         // Add the payload
         buf.extend_from_slice(&self.payload);
-
-        // Split off exactly the bytes we wrote and freeze them into an
-        // immutable Bytes view. `buf` retains any leftover capacity for
-        // the next packet.
-        Ok(buf.split().freeze())
+        Ok(())
     }
 }
 
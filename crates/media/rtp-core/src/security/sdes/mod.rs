@@ -7,7 +7,10 @@
 
 use crate::security::SecurityKeyExchange;
 use crate::srtp::crypto::SrtpCryptoKey;
-use crate::srtp::{SrtpCryptoSuite, SRTP_AES128_CM_SHA1_32, SRTP_AES128_CM_SHA1_80};
+use crate::srtp::{
+    SrtpCryptoSuite, SRTP_AEAD_AES_128_GCM, SRTP_AEAD_AES_256_GCM, SRTP_AES128_CM_SHA1_32,
+    SRTP_AES128_CM_SHA1_80,
+};
 use crate::Error;
 use base64::{engine::general_purpose::STANDARD as BASE64, Engine as _};
 use rand::{rngs::OsRng, RngCore};
@@ -148,7 +151,14 @@ pub struct SdesConfig {
 impl Default for SdesConfig {
     fn default() -> Self {
         Self {
-            crypto_suites: vec![SRTP_AES128_CM_SHA1_80, SRTP_AES128_CM_SHA1_32],
+            // The AEAD suites (RFC 7714) are accepted in answers but not
+            // offered by default, so offers stay compatible with AES-CM-only peers
+            crypto_suites: vec![
+                SRTP_AES128_CM_SHA1_80,
+                SRTP_AES128_CM_SHA1_32,
+                SRTP_AEAD_AES_128_GCM,
+                SRTP_AEAD_AES_256_GCM,
+            ],
             offer_count: 2,
         }
     }
@@ -164,6 +174,8 @@ pub struct Sdes {
     state: SdesState,
     /// Local crypto attributes
     local_attrs: Vec<SdesCryptoAttribute>,
+    /// Suite and key offered with each local attribute, by index
+    local_keys: Vec<(SrtpCryptoSuite, SrtpCryptoKey)>,
     /// Remote crypto attributes
     remote_attrs: Vec<SdesCryptoAttribute>,
     /// Selected crypto attribute
@@ -182,6 +194,7 @@ impl Sdes {
             role,
             state: SdesState::Initial,
             local_attrs: Vec::new(),
+            local_keys: Vec::new(),
             remote_attrs: Vec::new(),
             selected_attr: None,
             srtp_key: None,
@@ -196,28 +209,16 @@ impl Sdes {
         suite: &SrtpCryptoSuite,
     ) -> Result<(SdesCryptoAttribute, SrtpCryptoKey), Error> {
         // Map SRTP crypto suite to SDES crypto suite string
-        let crypto_suite_str = match (suite.encryption, suite.authentication) {
-            (
-                crate::srtp::SrtpEncryptionAlgorithm::AesCm,
-                crate::srtp::SrtpAuthenticationAlgorithm::HmacSha1_80,
-            ) => "AES_CM_128_HMAC_SHA1_80",
-            (
-                crate::srtp::SrtpEncryptionAlgorithm::AesCm,
-                crate::srtp::SrtpAuthenticationAlgorithm::HmacSha1_32,
-            ) => "AES_CM_128_HMAC_SHA1_32",
-            _ => {
-                return Err(Error::UnsupportedFeature(
-                    "Unsupported SRTP crypto suite for SDES".into(),
-                ))
-            }
-        };
+        let crypto_suite_str = suite.sdes_name().ok_or_else(|| {
+            Error::UnsupportedFeature("Unsupported SRTP crypto suite for SDES".into())
+        })?;
 
         // Generate random key
-        let mut key = vec![0u8; 16]; // 128-bit AES key
+        let mut key = vec![0u8; suite.key_length];
         OsRng.fill_bytes(&mut key);
 
-        // Generate random salt
-        let mut salt = vec![0u8; 14]; // 112-bit salt
+        // Generate random salt (112 bits for AES-CM, 96 bits for AEAD)
+        let mut salt = vec![0u8; suite.salt_length()];
         OsRng.fill_bytes(&mut salt);
 
         // Combine key and salt
@@ -258,6 +259,7 @@ impl Sdes {
 
             // Store local attribute
             self.local_attrs.push(attr.clone());
+            self.local_keys.push((suite.clone(), srtp_key.clone()));
 
             // Add to offer
             offer.push(format!("a=crypto:{}", attr.to_string()));
@@ -300,20 +302,23 @@ impl Sdes {
             ));
         }
 
-        // Select the first supported crypto attribute
-        let selected = &self.remote_attrs[0];
-
-        // Map SDES crypto suite to SRTP crypto suite
-        let srtp_suite = match selected.crypto_suite.as_str() {
-            "AES_CM_128_HMAC_SHA1_80" => SRTP_AES128_CM_SHA1_80,
-            "AES_CM_128_HMAC_SHA1_32" => SRTP_AES128_CM_SHA1_32,
-            _ => {
-                return Err(Error::UnsupportedFeature(format!(
+        // Select the first offered crypto attribute whose suite we support
+        let (selected, srtp_suite) = self
+            .remote_attrs
+            .iter()
+            .find_map(|attr| {
+                SrtpCryptoSuite::from_sdes_name(&attr.crypto_suite)
+                    .filter(|suite| self.config.crypto_suites.contains(suite))
+                    .map(|suite| (attr, suite))
+            })
+            .ok_or_else(|| {
+                Error::UnsupportedFeature(format!(
                     "Unsupported crypto suite: {}",
-                    selected.crypto_suite
-                )))
-            }
-        };
+                    self.remote_attrs[0].crypto_suite
+                ))
+            })?;
+        let key_length = srtp_suite.key_length;
+        let salt_length = srtp_suite.salt_length();
 
         // Parse key info
         let key_info = selected.key_info.as_str();
@@ -323,13 +328,13 @@ impl Sdes {
             .decode(key_info)
             .map_err(|_| Error::ParseError("Invalid Base64 encoding in key info".into()))?;
 
-        if keysalt.len() < 30 {
+        if keysalt.len() < key_length + salt_length {
             return Err(Error::ParseError("Key info too short".into()));
         }
 
         // Split key and salt
-        let key = keysalt[0..16].to_vec();
-        let salt = keysalt[16..30].to_vec();
+        let key = keysalt[..key_length].to_vec();
+        let salt = keysalt[key_length..key_length + salt_length].to_vec();
 
         // Store key for later use
         self.srtp_key = Some(SrtpCryptoKey::new(key, salt));
@@ -380,14 +385,17 @@ impl Sdes {
         let selected = selected_attr.unwrap();
 
         // Find matching local attribute by tag
-        let local_attr = self.local_attrs.iter().find(|a| a.tag == selected.tag);
-
-        if local_attr.is_none() {
+        let Some(index) = self.local_attrs.iter().position(|a| a.tag == selected.tag) else {
             return Err(Error::InvalidMessage(format!(
                 "No matching local attribute for tag {}",
                 selected.tag
             )));
-        }
+        };
+
+        // Switch to the key and suite offered under the selected tag
+        let (suite, key) = self.local_keys[index].clone();
+        self.srtp_suite = Some(suite);
+        self.srtp_key = Some(key);
 
         // Store selected attribute
         self.selected_attr = Some(selected);
@@ -1,6 +1,6 @@
 use crate::security::sdes::{Sdes, SdesConfig, SdesCryptoAttribute, SdesRole};
 use crate::security::SecurityKeyExchange;
-use crate::srtp::{SRTP_AES128_CM_SHA1_32, SRTP_AES128_CM_SHA1_80};
+use crate::srtp::{SRTP_AEAD_AES_128_GCM, SRTP_AES128_CM_SHA1_32, SRTP_AES128_CM_SHA1_80};
 
 #[test]
 fn test_sdes_crypto_attribute_parsing() {
@@ -193,3 +193,56 @@ fn test_sdes_error_handling() {
     let result = answerer.process_message(invalid_offer);
     assert!(result.is_err());
 }
+
+#[test]
+fn test_sdes_aead_gcm_negotiation() {
+    let offerer_config = SdesConfig {
+        crypto_suites: vec![SRTP_AEAD_AES_128_GCM, SRTP_AES128_CM_SHA1_80],
+        offer_count: 2,
+    };
+
+    // An answerer supporting GCM picks the first (AEAD) offer
+    let mut offerer = Sdes::new(offerer_config.clone(), SdesRole::Offerer);
+    let mut answerer = Sdes::new(SdesConfig::default(), SdesRole::Answerer);
+    let offer = offerer.process_message(b"").unwrap().unwrap();
+    assert!(std::str::from_utf8(&offer)
+        .unwrap()
+        .contains("a=crypto:1 AEAD_AES_128_GCM inline:"));
+    let answer = answerer.process_message(&offer).unwrap().unwrap();
+    offerer.process_message(&answer).unwrap();
+
+    assert_eq!(answerer.get_srtp_suite(), Some(SRTP_AEAD_AES_128_GCM));
+    assert_eq!(offerer.get_srtp_suite(), Some(SRTP_AEAD_AES_128_GCM));
+    let key = answerer.get_srtp_key().unwrap();
+    assert_eq!(key.key().len(), 16);
+    assert_eq!(key.salt().len(), 12);
+    let offered = offerer.get_srtp_key().unwrap();
+    assert_eq!(offered.key(), key.key());
+    assert_eq!(offered.salt(), key.salt());
+
+    // An AES-CM-only answerer skips the AEAD offer and the offerer
+    // switches to the key sent with the selected tag
+    let mut offerer = Sdes::new(offerer_config, SdesRole::Offerer);
+    let mut answerer = Sdes::new(
+        SdesConfig {
+            crypto_suites: vec![SRTP_AES128_CM_SHA1_80],
+            offer_count: 1,
+        },
+        SdesRole::Answerer,
+    );
+    let offer = offerer.process_message(b"").unwrap().unwrap();
+    let answer = answerer.process_message(&offer).unwrap().unwrap();
+    assert!(std::str::from_utf8(&answer)
+        .unwrap()
+        .starts_with("a=crypto:2 "));
+    offerer.process_message(&answer).unwrap();
+
+    assert_eq!(offerer.get_srtp_suite(), Some(SRTP_AES128_CM_SHA1_80));
+    let (offered, answered) = (
+        offerer.get_srtp_key().unwrap(),
+        answerer.get_srtp_key().unwrap(),
+    );
+    assert_eq!(offered.key(), answered.key());
+    assert_eq!(offered.salt(), answered.salt());
+    assert_eq!(offered.salt().len(), 14);
+}
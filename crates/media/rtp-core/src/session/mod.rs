@@ -24,7 +24,8 @@ use tracing::{debug, error, info, trace, warn};
 use crate::error::Error;
 use crate::packet::{RtpHeader, RtpPacket};
 use crate::transport::{
-    RtpTransport, RtpTransportBufferConfig, RtpTransportConfig, UdpRtpTransport,
+    DemuxSessionConfig, DemuxedRtpTransport, RtpForwardGuard, RtpForwardTarget, RtpTransport,
+    RtpTransportBufferConfig, RtpTransportConfig, SharedRtpSocket, UdpRtpTransport,
 };
 use crate::{Result, RtpSsrc, RtpTimestamp};
 
@@ -53,6 +54,13 @@ where
 /// roughly 1.3 seconds of headroom for one stream.
 pub const RTP_SESSION_CHANNEL_CAPACITY: usize = 64;
 
+/// Most queued packets the send task flushes in one batched UDP send.
+///
+/// A session normally queues one packet per 20 ms frame, so batches only form
+/// when the send task falls behind (or a caller queues a burst); they are then
+/// drained with one `sendmmsg`/GSO call instead of a `send_to` per packet.
+const RTP_SEND_BATCH_MAX: usize = 32;
+
 /// Small best-effort queue for the legacy polling receive API.
 ///
 /// Media-core consumes RTP packets through the event broadcast path, so this
@@ -413,7 +421,7 @@ pub struct RtpSession {
 impl RtpSession {
     /// Create a new RTP session
     pub async fn new(config: RtpSessionConfig) -> Result<Self> {
-        Self::new_with_receive_queue(config, true).await
+        Self::new_with_receive_queue(config, true, None).await
     }
 
     /// Create a new RTP session for event-driven consumers.
@@ -422,12 +430,36 @@ impl RtpSession {
     /// but they are not duplicated into the polling queue used by
     /// [`RtpSession::receive_packet`].
     pub async fn new_event_driven(config: RtpSessionConfig) -> Result<Self> {
-        Self::new_with_receive_queue(config, false).await
+        Self::new_with_receive_queue(config, false, None).await
+    }
+
+    /// Create a new RTP session on a [`SharedRtpSocket`] instead of its own
+    /// UDP socket.
+    ///
+    /// `config.local_addr` and the transport buffer sizing are ignored; the
+    /// session uses the shared socket's address and configuration. Inbound
+    /// packets are routed to the session by `config.remote_addr` and the
+    /// SSRCs learned from it (see [`SharedRtpSocket`]).
+    pub async fn new_on_shared_socket(
+        config: RtpSessionConfig,
+        shared: &SharedRtpSocket,
+    ) -> Result<Self> {
+        Self::new_with_receive_queue(config, true, Some(shared)).await
+    }
+
+    /// Event-driven variant of [`RtpSession::new_on_shared_socket`]; see
+    /// [`RtpSession::new_event_driven`].
+    pub async fn new_event_driven_on_shared_socket(
+        config: RtpSessionConfig,
+        shared: &SharedRtpSocket,
+    ) -> Result<Self> {
+        Self::new_with_receive_queue(config, false, Some(shared)).await
     }
 
     async fn new_with_receive_queue(
         config: RtpSessionConfig,
         receive_queue_enabled: bool,
+        shared: Option<&SharedRtpSocket>,
     ) -> Result<Self> {
         let session_buffer_config = config.session_buffer_config;
         let transport_buffer_config = config.transport_buffer_config;
@@ -450,8 +482,14 @@ impl RtpSession {
             buffer_config: transport_buffer_config,
         };
 
-        // Create UDP transport
-        let transport = Arc::new(UdpRtpTransport::new(transport_config).await?);
+        // Create UDP transport, or register on the shared socket
+        let transport: Arc<dyn RtpTransport> = match shared {
+            Some(shared) => Arc::new(shared.register_session(DemuxSessionConfig {
+                remote_rtp_addr: config.remote_addr,
+                ..Default::default()
+            })?),
+            None => Arc::new(UdpRtpTransport::new(transport_config).await?),
+        };
 
         // Create channels for internal communication.
         let (sender_tx, sender_rx) =
@@ -554,9 +592,7 @@ impl RtpSession {
         // If we have a remote address, set it on the transport
         if let Some(addr) = remote_addr {
             // Set the remote RTP address on the UDP transport
-            if let Some(t) = transport.as_any().downcast_ref::<UdpRtpTransport>() {
-                t.set_remote_rtp_addr(addr).await;
-            }
+            set_transport_remote_addr(transport.as_ref(), addr).await;
         }
 
         // Prepare the scheduler's sequence state, but do not start its
@@ -578,70 +614,96 @@ impl RtpSession {
         let send_transport = transport.clone();
         let send_task = spawn_memory_tracked("rtp_core.rtp_session.send_task", async move {
             let mut last_remote_addr = remote_addr;
-            let mut rtp_send_buffer = BytesMut::with_capacity(crate::DEFAULT_MAX_PACKET_SIZE);
+            let mut burst: Vec<RtpPacket> = Vec::with_capacity(RTP_SEND_BATCH_MAX);
+            let mut send_buffers: Vec<BytesMut> = Vec::new();
 
             while let Some(packet) = sender_rx.recv().await {
+                // Take whatever else is already queued so a backlog goes out
+                // in one batched send rather than one syscall per packet.
+                burst.clear();
+                burst.push(packet);
+                while burst.len() < RTP_SEND_BATCH_MAX {
+                    match sender_rx.try_recv() {
+                        Ok(packet) => burst.push(packet),
+                        Err(_) => break,
+                    }
+                }
+
                 // Always try to get the current remote address from transport first
-                let dest =
-                    if let Some(t) = send_transport.as_any().downcast_ref::<UdpRtpTransport>() {
-                        // Check transport for current remote address
-                        match t.remote_rtp_addr().await {
-                            Some(addr) => {
-                                // Update our cached value
-                                last_remote_addr = Some(addr);
-                                addr
-                            }
-                            None => {
-                                // Fall back to cached value if transport doesn't have one
-                                if let Some(addr) = last_remote_addr {
-                                    addr
-                                } else {
-                                    // No destination address, can't send
-                                    warn!("No destination address for RTP packet, dropping");
-                                    continue;
-                                }
-                            }
-                        }
-                    } else {
-                        // Not a UDP transport, use cached value
+                let dest = match transport_remote_addr(send_transport.as_ref()).await {
+                    Some(addr) => {
+                        // Update our cached value
+                        last_remote_addr = Some(addr);
+                        addr
+                    }
+                    None => {
                         if let Some(addr) = last_remote_addr {
                             addr
                         } else {
                             // No destination address, can't send
-                            warn!("No destination address for RTP packet, dropping");
+                            warn!(
+                                "No destination address for {} RTP packet(s), dropping",
+                                burst.len()
+                            );
                             continue;
                         }
-                    };
+                    }
+                };
 
-                // Send the packet
+                // Send the packets
                 debug!(
-                    "Sending RTP packet to {} (seq={}, timestamp={})",
-                    dest, packet.header.sequence_number, packet.header.timestamp
+                    "Sending {} RTP packet(s) to {} (first seq={}, timestamp={})",
+                    burst.len(),
+                    dest,
+                    burst[0].header.sequence_number,
+                    burst[0].header.timestamp
                 );
 
-                let send_result =
-                    if let Some(t) = send_transport.as_any().downcast_ref::<UdpRtpTransport>() {
-                        t.send_rtp_with_buffer(&packet, dest, &mut rtp_send_buffer)
-                            .await
-                    } else {
-                        send_transport.send_rtp(&packet, dest).await
-                    };
+                if let Some(t) = send_transport.as_any().downcast_ref::<UdpRtpTransport>() {
+                    if let Err(e) = t
+                        .send_rtp_batch_with_buffers(&burst, dest, &mut send_buffers)
+                        .await
+                    {
+                        error!("Failed to send {} RTP packet(s): {}", burst.len(), e);
+
+                        // Broadcast error event
+                        let _ = event_tx_send.send(RtpSessionEvent::Error(e));
+                        continue;
+                    }
 
-                if let Err(e) = send_result {
-                    error!("Failed to send RTP packet: {}", e);
+                    debug!(
+                        "Successfully sent {} RTP packet(s) to {}",
+                        burst.len(),
+                        dest
+                    );
 
-                    // Broadcast error event
-                    let _ = event_tx_send.send(RtpSessionEvent::Error(e));
+                    // Update stats
+                    {
+                        let mut session_stats = stats_send.lock();
+                        session_stats.packets_sent += burst.len() as u64;
+                        session_stats.bytes_sent +=
+                            burst.iter().map(|packet| packet.size() as u64).sum::<u64>();
+                    }
                     continue;
                 }
 
-                debug!("Successfully sent RTP packet to {}", dest);
+                for packet in &burst {
+                    if let Err(e) = send_transport.send_rtp(packet, dest).await {
+                        error!("Failed to send RTP packet: {}", e);
+
+                        // Broadcast error event
+                        let _ = event_tx_send.send(RtpSessionEvent::Error(e));
+                        continue;
+                    }
+
+                    debug!("Successfully sent RTP packet to {}", dest);
 
-                // Update stats
-                {
-                    let mut session_stats = stats_send.lock();
-                    session_stats.packets_sent += 1;
-                    session_stats.bytes_sent += packet.size() as u64;
+                    // Update stats
+                    {
+                        let mut session_stats = stats_send.lock();
+                        session_stats.packets_sent += 1;
+                        session_stats.bytes_sent += packet.size() as u64;
+                    }
                 }
             }
         });
@@ -1071,6 +1133,34 @@ impl RtpSession {
         })
     }
 
+    /// Outbound side of a receive-loop bridge forwarder for this session.
+    ///
+    /// Forwarded packets carry this session's SSRC and draw their sequence
+    /// numbers from the same atomic as [`Self::send_handle`]. `None` when
+    /// the session has no scheduler or does not own a dedicated
+    /// [`UdpRtpTransport`] (shared-socket and TCP sessions).
+    pub fn forward_target(&self) -> Option<RtpForwardTarget> {
+        let scheduler = self.scheduler.as_ref()?;
+        let transport = self.transport.as_any().downcast_ref::<UdpRtpTransport>()?;
+        Some(transport.forward_target(
+            self.ssrc,
+            scheduler.sequence_handle(),
+            self.config.clock_rate,
+        ))
+    }
+
+    /// Relay RTP media this session receives straight to `target` from its
+    /// transport's receive loop, until the returned guard is dropped.
+    ///
+    /// While installed, media packets bypass this session: no
+    /// [`RtpSessionEvent::PacketReceived`], no receive statistics, no
+    /// jitter buffering. RTCP is still delivered. `None` when the session
+    /// does not own a dedicated [`UdpRtpTransport`].
+    pub fn forward_to(&self, target: RtpForwardTarget) -> Option<RtpForwardGuard> {
+        let transport = self.transport.as_any().downcast_ref::<UdpRtpTransport>()?;
+        Some(transport.install_forwarder(target))
+    }
+
     /// Receive an RTP packet
     pub async fn receive_packet(&mut self) -> Result<RtpPacket> {
         self.receiver
@@ -1115,9 +1205,7 @@ impl RtpSession {
         }
 
         // Update the transport's remote address
-        if let Some(t) = self.transport.as_any().downcast_ref::<UdpRtpTransport>() {
-            t.set_remote_rtp_addr(addr).await;
-        }
+        set_transport_remote_addr(self.transport.as_ref(), addr).await;
     }
 
     /// Get the local address
@@ -1265,6 +1353,20 @@ impl RtpSession {
         self.config.payload_type = payload_type;
     }
 
+    /// Set the RFC 4733 `telephone-event` payload type negotiated for
+    /// media received on this session. Packets carrying it are reported as
+    /// DTMF, including while a bridge forwarder (or its kernel relay
+    /// offload) relays this session's media. Ignored by transports other
+    /// than the UDP-family ones.
+    pub fn set_telephone_event_payload_type(&self, payload_type: u8) {
+        let transport = self.transport.as_any();
+        if let Some(t) = transport.downcast_ref::<UdpRtpTransport>() {
+            t.set_telephone_event_payload_type(payload_type);
+        } else if let Some(t) = transport.downcast_ref::<DemuxedRtpTransport>() {
+            t.set_telephone_event_payload_type(payload_type);
+        }
+    }
+
     /// Get a stream by SSRC, if it exists
     pub async fn get_stream(&self, ssrc: RtpSsrc) -> Option<RtpStreamStats> {
         self.streams.get(&ssrc).map(|stream| stream.get_stats())
@@ -1597,6 +1699,26 @@ impl RtpSession {
     }
 }
 
+/// Remote RTP address tracked by the UDP-family transports (own socket or
+/// shared socket); `None` for other transports.
+async fn transport_remote_addr(transport: &dyn RtpTransport) -> Option<SocketAddr> {
+    if let Some(t) = transport.as_any().downcast_ref::<UdpRtpTransport>() {
+        t.remote_rtp_addr().await
+    } else if let Some(t) = transport.as_any().downcast_ref::<DemuxedRtpTransport>() {
+        t.remote_rtp_addr().await
+    } else {
+        None
+    }
+}
+
+async fn set_transport_remote_addr(transport: &dyn RtpTransport, addr: SocketAddr) {
+    if let Some(t) = transport.as_any().downcast_ref::<UdpRtpTransport>() {
+        t.set_remote_rtp_addr(addr).await;
+    } else if let Some(t) = transport.as_any().downcast_ref::<DemuxedRtpTransport>() {
+        t.set_remote_rtp_addr(addr).await;
+    }
+}
+
 /// A lightweight sender handle for an RTP session
 ///
 /// This handle can be used to send RTP packets to the session
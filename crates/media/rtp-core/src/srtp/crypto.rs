@@ -1,16 +1,19 @@
 use super::{SrtpAuthenticationAlgorithm, SrtpCryptoSuite, SrtpEncryptionAlgorithm};
 use crate::error::Error;
+use crate::packet::RtpHeader;
 use crate::packet::RtpPacket;
 use crate::Result;
 use aes::{
-    cipher::{generic_array::GenericArray, KeyIvInit, StreamCipher},
+    cipher::{generic_array::GenericArray, InnerIvInit, KeyInit as _, StreamCipher},
     Aes128, Aes256,
 };
+use aes_gcm::{aead::AeadInPlace, Aes128Gcm, Aes256Gcm, KeyInit};
 use base64::{engine::general_purpose::STANDARD as BASE64, Engine as _};
 use bytes::{BufMut, Bytes, BytesMut};
 use ctr::Ctr64BE;
 use hmac::{Hmac, Mac};
 use sha1::Sha1;
+use std::sync::atomic::{AtomicU32, AtomicU64, Ordering};
 
 // Define types for AES-CM
 type Aes128Ctr64BE = Ctr64BE<Aes128>;
@@ -18,6 +21,12 @@ type Aes256Ctr64BE = Ctr64BE<Aes256>;
 // Define type for HMAC-SHA1
 type HmacSha1 = Hmac<Sha1>;
 
+/// AES-GCM authentication tag length used by every SRTP AEAD suite.
+const GCM_TAG_LEN: usize = 16;
+
+/// Length of the SRTCP `E || index` trailer word.
+const SRTCP_INDEX_LEN: usize = 4;
+
 /// Basic cryptographic key/salt for SRTP
 #[derive(Debug, Clone)]
 pub struct SrtpCryptoKey {
@@ -77,6 +86,242 @@ pub struct SrtpCrypto {
 
     /// Session keys derived from master key
     session_keys: Option<SrtpSessionKeys>,
+
+    /// Keyed AES-CM and HMAC-SHA1 state for the RFC 3711 suites
+    cm: Option<CmSessionCiphers>,
+
+    /// Keyed AES-GCM instances for AEAD suites (RFC 7714)
+    gcm: Option<GcmSessionCiphers>,
+
+    /// Highest RTP packet index protected
+    rtp_send_index: PacketIndexTracker,
+
+    /// Highest RTP packet index authenticated
+    rtp_recv_index: PacketIndexTracker,
+
+    /// Next SRTCP index to send (AEAD suites)
+    rtcp_send_index: AtomicU32,
+}
+
+/// Per-direction AES-CM and HMAC-SHA1 state for the RFC 3711 suites.
+struct CmSessionCiphers {
+    rtp: CmCipher,
+    rtcp: CmCipher,
+}
+
+/// AES-CM key schedule and HMAC-SHA1 state keyed once from the session
+/// keys. Per packet only the counter block is set up and the keyed HMAC
+/// (inner and outer pads already absorbed) is cloned, so neither path
+/// rekeys or touches the heap.
+struct CmCipher {
+    /// `None` for NULL encryption
+    cipher: Option<AesCtrKey>,
+    /// `None` for NULL authentication
+    mac: Option<HmacSha1>,
+    salt: Vec<u8>,
+}
+
+impl CmCipher {
+    fn new(suite: &SrtpCryptoSuite, enc_key: &[u8], auth_key: &[u8], salt: &[u8]) -> Result<Self> {
+        let cipher = match suite.encryption {
+            SrtpEncryptionAlgorithm::AesCm => Some(AesCtrKey::new(enc_key)?),
+            _ => None,
+        };
+        let mac = match suite.authentication {
+            SrtpAuthenticationAlgorithm::Null => None,
+            _ => Some(
+                HmacSha1::new_from_slice(auth_key)
+                    .map_err(|e| Error::SrtpError(format!("Failed to create HMAC: {}", e)))?,
+            ),
+        };
+        Ok(Self {
+            cipher,
+            mac,
+            salt: salt.to_vec(),
+        })
+    }
+
+    /// Apply the AES-CM keystream for `(ssrc, index)` (RFC 3711 §4.1.1).
+    fn apply_keystream(&self, ssrc: u32, index: u64, data: &mut [u8]) -> Result<()> {
+        if let Some(cipher) = &self.cipher {
+            let iv = super::create_srtp_iv_block(&self.salt, ssrc, index)?;
+            cipher.apply_keystream(&iv, data);
+        }
+        Ok(())
+    }
+
+    /// Full 20-byte HMAC-SHA1 over `data || trailer`, or `None` for NULL
+    /// authentication.
+    fn auth_tag(&self, data: &[u8], trailer: &[u8]) -> Option<[u8; 20]> {
+        let mut mac = self.mac.clone()?;
+        mac.update(data);
+        mac.update(trailer);
+        Some(mac.finalize().into_bytes().into())
+    }
+
+    /// Verify a truncated tag over `data || trailer` in constant time.
+    fn verify_tag(&self, data: &[u8], trailer: &[u8], tag: &[u8]) -> Result<()> {
+        let Some(expected) = self.auth_tag(data, trailer) else {
+            return Ok(());
+        };
+        if tag.len() > expected.len() {
+            return Err(Error::SrtpError(
+                "Authentication tag length mismatch".to_string(),
+            ));
+        }
+        let diff = expected
+            .iter()
+            .zip(tag)
+            .fold(0u8, |acc, (a, b)| acc | (a ^ b));
+        if diff != 0 {
+            return Err(Error::SrtpError("Authentication failed".to_string()));
+        }
+        Ok(())
+    }
+}
+
+/// AES block cipher with its key schedule expanded once, driven in
+/// counter mode per packet.
+enum AesCtrKey {
+    Aes128(Aes128),
+    Aes256(Aes256),
+}
+
+impl AesCtrKey {
+    fn new(key: &[u8]) -> Result<Self> {
+        match key.len() {
+            16 => Ok(Self::Aes128(Aes128::new_from_slice(key).map_err(|e| {
+                Error::SrtpError(format!("Failed to create AES cipher: {}", e))
+            })?)),
+            32 => Ok(Self::Aes256(Aes256::new_from_slice(key).map_err(|e| {
+                Error::SrtpError(format!("Failed to create AES cipher: {}", e))
+            })?)),
+            len => Err(Error::SrtpError(format!(
+                "unsupported AES-CM key length: {} bytes",
+                len
+            ))),
+        }
+    }
+
+    fn apply_keystream(&self, iv: &[u8; 16], data: &mut [u8]) {
+        let iv = GenericArray::from_slice(iv);
+        match self {
+            Self::Aes128(cipher) => {
+                Aes128Ctr64BE::inner_iv_init(cipher.clone(), iv).apply_keystream(data)
+            }
+            Self::Aes256(cipher) => {
+                Aes256Ctr64BE::inner_iv_init(cipher.clone(), iv).apply_keystream(data)
+            }
+        }
+    }
+}
+
+/// Per-direction AES-GCM instances, keyed once from the session keys so
+/// the AES key schedule and GHASH key are not recomputed per packet.
+struct GcmSessionCiphers {
+    rtp: AesGcmCipher,
+    rtcp: AesGcmCipher,
+}
+
+enum AesGcmCipher {
+    Aes128(Box<Aes128Gcm>),
+    Aes256(Box<Aes256Gcm>),
+}
+
+impl AesGcmCipher {
+    fn new(key: &[u8]) -> Result<Self> {
+        match key.len() {
+            16 => Ok(Self::Aes128(Box::new(
+                Aes128Gcm::new_from_slice(key)
+                    .map_err(|e| Error::SrtpError(format!("Failed to create AES-GCM: {}", e)))?,
+            ))),
+            32 => Ok(Self::Aes256(Box::new(
+                Aes256Gcm::new_from_slice(key)
+                    .map_err(|e| Error::SrtpError(format!("Failed to create AES-GCM: {}", e)))?,
+            ))),
+            len => Err(Error::SrtpError(format!(
+                "unsupported AES-GCM key length: {} bytes",
+                len
+            ))),
+        }
+    }
+
+    /// Encrypt `buffer` in place and return its authentication tag.
+    fn seal(&self, iv: &[u8; 12], aad: &[u8], buffer: &mut [u8]) -> Result<[u8; GCM_TAG_LEN]> {
+        let nonce = GenericArray::from_slice(iv);
+        let tag = match self {
+            Self::Aes128(cipher) => cipher.encrypt_in_place_detached(nonce, aad, buffer),
+            Self::Aes256(cipher) => cipher.encrypt_in_place_detached(nonce, aad, buffer),
+        }
+        .map_err(|_| Error::SrtpError("AES-GCM encryption failed".to_string()))?;
+        Ok(tag.into())
+    }
+
+    /// Verify `tag` and decrypt `buffer` in place.
+    fn open(&self, iv: &[u8; 12], aad: &[u8], buffer: &mut [u8], tag: &[u8]) -> Result<()> {
+        let nonce = GenericArray::from_slice(iv);
+        let tag = GenericArray::from_slice(tag);
+        match self {
+            Self::Aes128(cipher) => cipher.decrypt_in_place_detached(nonce, aad, buffer, tag),
+            Self::Aes256(cipher) => cipher.decrypt_in_place_detached(nonce, aad, buffer, tag),
+        }
+        .map_err(|_| Error::SrtpError("Authentication failed".to_string()))
+    }
+}
+
+/// Highest 48-bit packet index (`ROC << 16 | SEQ`) seen in one direction,
+/// from which the index of the next sequence number is estimated
+/// (RFC 3711 §3.3.1). Stored as `index + 1`; `0` means none yet.
+#[derive(Default)]
+struct PacketIndexTracker(AtomicU64);
+
+impl PacketIndexTracker {
+    /// Estimate the packet index of `seq` (RFC 3711 Appendix A).
+    fn estimate(&self, seq: u16) -> u64 {
+        let Some(highest) = self.0.load(Ordering::Acquire).checked_sub(1) else {
+            return seq as u64;
+        };
+        let roc = highest >> 16;
+        let s_l = (highest & 0xFFFF) as u16;
+        let v = if s_l < 0x8000 {
+            if seq > s_l && seq - s_l > 0x8000 {
+                roc.saturating_sub(1)
+            } else {
+                roc
+            }
+        } else if s_l - 0x8000 > seq {
+            roc + 1
+        } else {
+            roc
+        };
+        (v << 16) | seq as u64
+    }
+
+    fn update(&self, index: u64) {
+        self.0.fetch_max(index + 1, Ordering::AcqRel);
+    }
+}
+
+/// RFC 7714 §8.1 SRTP IV: `(00 00 || SSRC || ROC || SEQ) XOR salt`.
+fn gcm_rtp_iv(salt: &[u8], ssrc: u32, index: u64) -> [u8; 12] {
+    let mut iv = [0u8; 12];
+    iv[2..6].copy_from_slice(&ssrc.to_be_bytes());
+    iv[6..12].copy_from_slice(&index.to_be_bytes()[2..8]);
+    for (byte, salt) in iv.iter_mut().zip(salt) {
+        *byte ^= salt;
+    }
+    iv
+}
+
+/// RFC 7714 §9.1 SRTCP IV: `(00 00 || SSRC || 00 00 || 0 || index) XOR salt`.
+fn gcm_rtcp_iv(salt: &[u8], ssrc: u32, index: u32) -> [u8; 12] {
+    let mut iv = [0u8; 12];
+    iv[2..6].copy_from_slice(&ssrc.to_be_bytes());
+    iv[8..12].copy_from_slice(&(index & 0x7FFF_FFFF).to_be_bytes());
+    for (byte, salt) in iv.iter_mut().zip(salt) {
+        *byte ^= salt;
+    }
+    iv
 }
 
 /// Derived session keys for SRTP
@@ -117,6 +362,11 @@ impl SrtpCrypto {
             suite,
             master_key,
             session_keys: None,
+            cm: None,
+            gcm: None,
+            rtp_send_index: PacketIndexTracker::default(),
+            rtp_recv_index: PacketIndexTracker::default(),
+            rtcp_send_index: AtomicU32::new(0),
         };
 
         // Derive session keys
@@ -127,6 +377,10 @@ impl SrtpCrypto {
 
     /// Derive session keys from master key
     fn derive_keys(&mut self) -> Result<()> {
+        if self.suite.is_aead() {
+            return self.derive_aead_keys();
+        }
+
         // Use our KDF to derive session keys according to RFC 3711
 
         // Derive RTP encryption key
@@ -179,6 +433,11 @@ impl SrtpCrypto {
         };
         let rtcp_salt = super::srtp_kdf(&self.master_key, &rtcp_salt_params, 14)?;
 
+        self.cm = Some(CmSessionCiphers {
+            rtp: CmCipher::new(&self.suite, &rtp_enc_key, &rtp_auth_key, &rtp_salt)?,
+            rtcp: CmCipher::new(&self.suite, &rtcp_enc_key, &rtcp_auth_key, &rtcp_salt)?,
+        });
+
         // Store the derived keys
         let session_keys = SrtpSessionKeys {
             rtp_enc_key,
@@ -193,323 +452,296 @@ impl SrtpCrypto {
         Ok(())
     }
 
-    /// Encrypt an RTP packet
-    pub fn encrypt_rtp(&self, packet: &RtpPacket) -> Result<(RtpPacket, Option<Vec<u8>>)> {
-        if self.suite.encryption == SrtpEncryptionAlgorithm::Null {
-            // Null encryption, just return the original packet
-            return if self.suite.authentication == SrtpAuthenticationAlgorithm::Null {
-                // No authentication either
-                Ok((packet.clone(), None))
-            } else {
-                // Authentication is enabled, calculate tag
-                let serialized = packet.serialize()?;
-                let auth_tag = self.calculate_auth_tag(&serialized, 0)?;
-                Ok((packet.clone(), Some(auth_tag)))
-            };
+    /// Derive AEAD session keys (RFC 7714 §11): the RFC 3711 KDF with a
+    /// 96-bit master salt, 96-bit session salts and no authentication keys.
+    fn derive_aead_keys(&mut self) -> Result<()> {
+        let salt_length = self.suite.salt_length();
+        if self.master_key.salt().len() < salt_length {
+            return Err(Error::SrtpError(format!(
+                "Salt length mismatch: expected {} but got {}",
+                salt_length,
+                self.master_key.salt().len()
+            )));
         }
-
-        // Get session keys
-        let session_keys = self
-            .session_keys
-            .as_ref()
-            .ok_or_else(|| Error::SrtpError("Session keys not derived".to_string()))?;
-
-        // Extract header and payload
-        let header = packet.header.clone();
-        let payload = packet.payload.clone();
-
-        // Create an IV for encryption
-        let ssrc = packet.header.ssrc;
-        let sequence = packet.header.sequence_number as u64;
-        let roc: u32 = 0; // Roll-over counter, in a real implementation this would be tracked
-        let packet_index = (roc as u64) << 16 | sequence;
-
-        // Create an IV using salt and packet info
-        let iv = match self.suite.encryption {
-            SrtpEncryptionAlgorithm::AesCm => {
-                super::create_srtp_iv(&session_keys.rtp_salt, ssrc, packet_index)?
-            }
-            _ => {
-                return Err(Error::SrtpError(
-                    "Unsupported encryption algorithm".to_string(),
-                ))
-            }
+        let master_key = SrtpCryptoKey::new(
+            self.master_key.key().to_vec(),
+            self.master_key.salt()[..salt_length].to_vec(),
+        );
+        let derive = |label, len| {
+            let params = super::SrtpKeyDerivationParams {
+                label,
+                key_derivation_rate: 0,
+                index: 0,
+            };
+            super::srtp_kdf(&master_key, &params, len)
         };
 
-        // Create a mutable copy of the payload for encryption
-        let mut encrypted_payload = BytesMut::from(&payload[..]);
+        let rtp_enc_key = derive(
+            super::KeyDerivationLabel::RtpEncryption,
+            self.suite.key_length,
+        )?;
+        let rtp_salt = derive(super::KeyDerivationLabel::RtpSalt, salt_length)?;
+        let rtcp_enc_key = derive(
+            super::KeyDerivationLabel::RtcpEncryption,
+            self.suite.key_length,
+        )?;
+        let rtcp_salt = derive(super::KeyDerivationLabel::RtcpSalt, salt_length)?;
+
+        self.gcm = Some(GcmSessionCiphers {
+            rtp: AesGcmCipher::new(&rtp_enc_key)?,
+            rtcp: AesGcmCipher::new(&rtcp_enc_key)?,
+        });
+        self.session_keys = Some(SrtpSessionKeys {
+            rtp_enc_key,
+            rtp_auth_key: Vec::new(),
+            rtp_salt,
+            rtcp_enc_key,
+            rtcp_auth_key: Vec::new(),
+            rtcp_salt,
+        });
+        Ok(())
+    }
 
-        // Encrypt the payload
-        match self.suite.encryption {
-            SrtpEncryptionAlgorithm::AesCm => {
-                aes_cm_encrypt(&mut encrypted_payload, &session_keys.rtp_enc_key, &iv)?;
-            }
-            _ => {
-                return Err(Error::SrtpError(
-                    "Unsupported encryption algorithm".to_string(),
-                ))
-            }
+    /// Session keys and ciphers of an AEAD suite.
+    fn gcm_session(&self) -> Result<(&SrtpSessionKeys, &GcmSessionCiphers)> {
+        match (&self.session_keys, &self.gcm) {
+            (Some(keys), Some(gcm)) => Ok((keys, gcm)),
+            _ => Err(Error::SrtpError("Session keys not derived".to_string())),
         }
+    }
 
-        // Create a new packet with the encrypted payload
-        let encrypted_packet = RtpPacket::new(header, encrypted_payload.freeze());
-
-        // Calculate authentication tag if authentication is enabled
-        let auth_tag = if self.suite.authentication != SrtpAuthenticationAlgorithm::Null {
-            // Serialize the encrypted packet for authentication
-            let encrypted_serialized = encrypted_packet.serialize()?;
+    /// Keyed state of an RFC 3711 suite.
+    fn cm_session(&self) -> Result<&CmSessionCiphers> {
+        self.cm
+            .as_ref()
+            .ok_or_else(|| Error::SrtpError("Session keys not derived".to_string()))
+    }
 
-            // Calculate the authentication tag
-            let auth_tag = self.calculate_auth_tag(&encrypted_serialized, roc)?;
-            Some(auth_tag)
+    /// Bytes SRTP appends to an RTP packet: the authentication tag, if any.
+    pub fn rtp_trailer_len(&self) -> usize {
+        if self.suite.is_aead() || self.suite.authentication != SrtpAuthenticationAlgorithm::Null {
+            self.suite.tag_length
         } else {
-            None
-        };
+            0
+        }
+    }
 
-        Ok((encrypted_packet, auth_tag))
+    /// Protect a serialized RTP packet in place (RFC 3711 §3.3, RFC 7714
+    /// §8): the payload is encrypted and the authentication tag appended.
+    ///
+    /// Nothing is allocated when `buf` has [`Self::rtp_trailer_len`] bytes
+    /// of spare capacity.
+    pub fn protect_rtp_in_place(&self, buf: &mut BytesMut) -> Result<()> {
+        let header_len = RtpHeader::wire_size(buf)?;
+        let seq = u16::from_be_bytes([buf[2], buf[3]]);
+        let ssrc = u32::from_be_bytes([buf[8], buf[9], buf[10], buf[11]]);
+
+        if self.suite.is_aead() {
+            let (keys, gcm) = self.gcm_session()?;
+            let index = self.rtp_send_index.estimate(seq);
+            self.rtp_send_index.update(index);
+            let iv = gcm_rtp_iv(&keys.rtp_salt, ssrc, index);
+            let (header, payload) = buf.split_at_mut(header_len);
+            let tag = gcm.rtp.seal(&iv, header, payload)?;
+            buf.extend_from_slice(&tag);
+            return Ok(());
+        }
+
+        let cm = &self.cm_session()?.rtp;
+        let packet_index = self.rtp_send_index.estimate(seq);
+        self.rtp_send_index.update(packet_index);
+        let roc = (packet_index >> 16) as u32;
+        cm.apply_keystream(ssrc, packet_index, &mut buf[header_len..])?;
+        if let Some(tag) = cm.auth_tag(buf, &roc.to_be_bytes()) {
+            buf.extend_from_slice(&tag[..self.suite.tag_length]);
+        }
+        Ok(())
     }
 
-    /// Calculate authentication tag for a packet
-    fn calculate_auth_tag(&self, packet_data: &[u8], roc: u32) -> Result<Vec<u8>> {
-        if self.suite.authentication == SrtpAuthenticationAlgorithm::Null {
+    /// Unprotect an SRTP packet in place: the authentication tag is
+    /// verified and removed and the payload decrypted, leaving the plain
+    /// RTP packet in `buf`. On error `buf` is left unmodified for
+    /// authentication failures and otherwise unspecified.
+    pub fn unprotect_rtp_in_place(&self, buf: &mut BytesMut) -> Result<()> {
+        let tag_len = self.rtp_trailer_len();
+        if buf.len() < tag_len {
             return Err(Error::SrtpError(
-                "Authentication is not enabled".to_string(),
+                "Packet too short to contain authentication tag".to_string(),
             ));
         }
+        let sealed_len = buf.len() - tag_len;
+        let header_len = RtpHeader::wire_size(&buf[..sealed_len])?;
+        let seq = u16::from_be_bytes([buf[2], buf[3]]);
+        let ssrc = u32::from_be_bytes([buf[8], buf[9], buf[10], buf[11]]);
+
+        if self.suite.is_aead() {
+            let (keys, gcm) = self.gcm_session()?;
+            let index = self.rtp_recv_index.estimate(seq);
+            let iv = gcm_rtp_iv(&keys.rtp_salt, ssrc, index);
+            let (sealed, tag) = buf.split_at_mut(sealed_len);
+            let (header, payload) = sealed.split_at_mut(header_len);
+            gcm.rtp.open(&iv, header, payload, tag)?;
+            // Only authenticated packets may advance the rollover counter.
+            self.rtp_recv_index.update(index);
+            buf.truncate(sealed_len);
+            return Ok(());
+        }
 
-        // Get session keys
-        let session_keys = self
-            .session_keys
-            .as_ref()
-            .ok_or_else(|| Error::SrtpError("Session keys not derived".to_string()))?;
-
-        // Create an authenticator
-        let authenticator = super::auth::SrtpAuthenticator::new(
-            self.suite.authentication,
-            session_keys.rtp_auth_key.clone(),
-            self.suite.tag_length,
-        );
-
-        // Calculate the authentication tag
-        authenticator.calculate_auth_tag(packet_data, roc)
+        let cm = &self.cm_session()?.rtp;
+        let packet_index = self.rtp_recv_index.estimate(seq);
+        let roc = (packet_index >> 16) as u32;
+        let (sealed, tag) = buf.split_at(sealed_len);
+        cm.verify_tag(sealed, &roc.to_be_bytes(), tag)?;
+        self.rtp_recv_index.update(packet_index);
+        buf.truncate(sealed_len);
+        cm.apply_keystream(ssrc, packet_index, &mut buf[header_len..])
     }
 
-    /// Decrypt an SRTP packet
-    pub fn decrypt_rtp(&self, data: &[u8]) -> Result<RtpPacket> {
-        if self.suite.encryption == SrtpEncryptionAlgorithm::Null
-            && self.suite.authentication == SrtpAuthenticationAlgorithm::Null
-        {
-            // Null encryption and authentication, just parse the packet
-            return RtpPacket::parse(data);
+    /// Encrypt an RTCP compound packet with AES-GCM (RFC 7714 §9). Returns
+    /// the complete SRTCP packet: `header || ciphertext || tag || E+index`.
+    fn encrypt_rtcp_gcm(&self, data: &[u8]) -> Result<(Bytes, Option<Vec<u8>>)> {
+        let (keys, gcm) = self.gcm_session()?;
+        if data.len() < 8 {
+            return Err(Error::SrtpError("RTCP packet too short".to_string()));
         }
 
-        // Get session keys
-        let session_keys = self
-            .session_keys
-            .as_ref()
-            .ok_or_else(|| Error::SrtpError("Session keys not derived".to_string()))?;
+        let ssrc = u32::from_be_bytes([data[4], data[5], data[6], data[7]]);
+        let index = self.rtcp_send_index.fetch_add(1, Ordering::Relaxed) & 0x7FFF_FFFF;
+        let trailer = (0x8000_0000 | index).to_be_bytes();
+        let iv = gcm_rtcp_iv(&keys.rtcp_salt, ssrc, index);
 
-        // Determine authentication tag size
-        let auth_tag_size = if self.suite.authentication != SrtpAuthenticationAlgorithm::Null {
-            self.suite.tag_length
-        } else {
-            0
-        };
-
-        // Check if the packet has an authentication tag
-        if auth_tag_size > 0 && data.len() < auth_tag_size {
-            return Err(Error::SrtpError(
-                "Packet too short to contain authentication tag".to_string(),
-            ));
-        }
+        let mut aad = [0u8; 8 + SRTCP_INDEX_LEN];
+        aad[..8].copy_from_slice(&data[..8]);
+        aad[8..].copy_from_slice(&trailer);
 
-        // Split data into packet and authentication tag
-        let (packet_data, auth_tag) = if auth_tag_size > 0 {
-            let tag_start = data.len() - auth_tag_size;
-            (&data[0..tag_start], &data[tag_start..])
-        } else {
-            (data, &[][..])
-        };
+        let mut result = BytesMut::with_capacity(data.len() + GCM_TAG_LEN + SRTCP_INDEX_LEN);
+        result.extend_from_slice(data);
+        let tag = gcm.rtcp.seal(&iv, &aad, &mut result[8..])?;
+        result.extend_from_slice(&tag);
+        result.extend_from_slice(&trailer);
 
-        // Verify authentication if enabled
-        if self.suite.authentication != SrtpAuthenticationAlgorithm::Null {
-            // Create an authenticator
-            let authenticator = super::auth::SrtpAuthenticator::new(
-                self.suite.authentication,
-                session_keys.rtp_auth_key.clone(),
-                self.suite.tag_length,
-            );
+        Ok((result.freeze(), None))
+    }
 
-            // Roll-over counter, in a full implementation this would be tracked
-            let roc: u32 = 0;
+    /// Verify and decrypt an AES-GCM SRTCP packet (RFC 7714 §9). Packets
+    /// with the E flag clear are authenticated only (§9.2).
+    fn decrypt_rtcp_gcm(&self, data: &[u8]) -> Result<Bytes> {
+        let (keys, gcm) = self.gcm_session()?;
+        if data.len() < 8 + GCM_TAG_LEN + SRTCP_INDEX_LEN {
+            return Err(Error::SrtpError(format!(
+                "SRTCP packet too short: {} bytes",
+                data.len()
+            )));
+        }
 
-            // Verify the authentication tag
-            let is_valid = authenticator.verify_auth_tag(packet_data, auth_tag, roc)?;
-            if !is_valid {
-                return Err(Error::SrtpError("Authentication failed".to_string()));
-            }
+        let (body, trailer) = data.split_at(data.len() - SRTCP_INDEX_LEN);
+        let (sealed, tag) = body.split_at(body.len() - GCM_TAG_LEN);
+        let index_value = u32::from_be_bytes([trailer[0], trailer[1], trailer[2], trailer[3]]);
+        let ssrc = u32::from_be_bytes([sealed[4], sealed[5], sealed[6], sealed[7]]);
+        let iv = gcm_rtcp_iv(&keys.rtcp_salt, ssrc, index_value);
+
+        let mut result = BytesMut::from(sealed);
+        if index_value & 0x8000_0000 != 0 {
+            let mut aad = [0u8; 8 + SRTCP_INDEX_LEN];
+            aad[..8].copy_from_slice(&sealed[..8]);
+            aad[8..].copy_from_slice(trailer);
+            gcm.rtcp.open(&iv, &aad, &mut result[8..], tag)?;
+        } else {
+            let mut aad = Vec::with_capacity(sealed.len() + SRTCP_INDEX_LEN);
+            aad.extend_from_slice(sealed);
+            aad.extend_from_slice(trailer);
+            gcm.rtcp.open(&iv, &aad, &mut [], tag)?;
         }
 
-        // Parse the RTP header first (it's not encrypted)
-        let packet = RtpPacket::parse(packet_data)?;
+        Ok(result.freeze())
+    }
 
-        if self.suite.encryption == SrtpEncryptionAlgorithm::Null {
-            // If only authentication is enabled, return the parsed packet
-            return Ok(packet);
+    /// Encrypt an RTP packet
+    pub fn encrypt_rtp(&self, packet: &RtpPacket) -> Result<(RtpPacket, Option<Vec<u8>>)> {
+        if self.suite.encryption == SrtpEncryptionAlgorithm::Null
+            && self.suite.authentication == SrtpAuthenticationAlgorithm::Null
+        {
+            // No encryption or authentication, just return the original packet
+            return Ok((packet.clone(), None));
         }
 
-        // Create an IV for decryption
-        let ssrc = packet.header.ssrc;
-        let sequence = packet.header.sequence_number as u64;
-        let roc: u32 = 0; // In a real implementation, this would be tracked
-        let packet_index = (roc as u64) << 16 | sequence;
+        let mut buf = BytesMut::with_capacity(packet.size() + self.rtp_trailer_len());
+        packet.header.serialize(&mut buf)?;
+        let header_len = buf.len();
+        buf.extend_from_slice(&packet.payload);
+        self.protect_rtp_in_place(&mut buf)?;
 
-        // Create an IV using salt and packet info
-        let iv = match self.suite.encryption {
-            SrtpEncryptionAlgorithm::AesCm => {
-                super::create_srtp_iv(&session_keys.rtp_salt, ssrc, packet_index)?
-            }
-            _ => {
-                return Err(Error::SrtpError(
-                    "Unsupported encryption algorithm".to_string(),
-                ))
-            }
-        };
-
-        // Create a mutable copy of the payload for decryption
-        let mut decrypted_payload = BytesMut::from(&packet.payload[..]);
+        let auth_tag = buf.split_off(header_len + packet.payload.len());
+        let payload = buf.split_off(header_len).freeze();
+        let auth_tag = (!auth_tag.is_empty()).then(|| auth_tag.to_vec());
+        Ok((RtpPacket::new(packet.header.clone(), payload), auth_tag))
+    }
 
-        // Decrypt the payload
-        match self.suite.encryption {
-            SrtpEncryptionAlgorithm::AesCm => {
-                aes_cm_decrypt(&mut decrypted_payload, &session_keys.rtp_enc_key, &iv)?;
-            }
-            _ => {
-                return Err(Error::SrtpError(
-                    "Unsupported encryption algorithm".to_string(),
-                ))
-            }
+    /// Decrypt an SRTP packet
+    pub fn decrypt_rtp(&self, data: &[u8]) -> Result<RtpPacket> {
+        if self.suite.encryption == SrtpEncryptionAlgorithm::Null
+            && self.suite.authentication == SrtpAuthenticationAlgorithm::Null
+        {
+            // Null encryption and authentication, just parse the packet
+            return RtpPacket::parse(data);
         }
 
-        // Create a new packet with the decrypted payload
-        let decrypted_packet = RtpPacket::new(packet.header, decrypted_payload.freeze());
-
-        Ok(decrypted_packet)
+        let mut buf = BytesMut::from(data);
+        self.unprotect_rtp_in_place(&mut buf)?;
+        RtpPacket::parse_from_bytes(buf.freeze())
     }
 
     /// Encrypt an RTCP packet
     pub fn encrypt_rtcp(&self, data: &[u8]) -> Result<(Bytes, Option<Vec<u8>>)> {
-        if self.suite.encryption == SrtpEncryptionAlgorithm::Null {
-            // Null encryption, just return the original data
-            return if self.suite.authentication == SrtpAuthenticationAlgorithm::Null {
-                // No authentication either
-                Ok((Bytes::copy_from_slice(data), None))
-            } else {
-                // Only authentication
-                let auth_tag = self.calculate_rtcp_auth_tag(data, 0)?;
-                Ok((Bytes::copy_from_slice(data), Some(auth_tag)))
-            };
+        if self.suite.is_aead() {
+            return self.encrypt_rtcp_gcm(data);
         }
 
-        // Get session keys
-        let session_keys = self
-            .session_keys
-            .as_ref()
-            .ok_or_else(|| Error::SrtpError("Session keys not derived".to_string()))?;
+        if self.suite.encryption == SrtpEncryptionAlgorithm::Null
+            && self.suite.authentication == SrtpAuthenticationAlgorithm::Null
+        {
+            // No encryption or authentication, just return the original data
+            return Ok((Bytes::copy_from_slice(data), None));
+        }
 
-        // In a real implementation, we would:
-        // 1. Parse the RTCP packet
-        // 2. Extract the header portion (first 8 bytes)
-        // 3. Extract the payload portion
-        // 4. Create IV for encryption
-        // 5. Encrypt the payload
-        // 6. Create the E flag and SRTCP index at the end
-        // 7. Calculate authentication tag
+        let cm = &self.cm_session()?.rtcp;
+        if self.suite.encryption == SrtpEncryptionAlgorithm::Null {
+            // Only authentication
+            let auth_tag = cm
+                .auth_tag(data, &[])
+                .map(|tag| tag[..self.suite.tag_length].to_vec());
+            return Ok((Bytes::copy_from_slice(data), auth_tag));
+        }
 
         // For simplicity in this implementation, we'll assume everything after the first 8 bytes is to be encrypted
         if data.len() <= 8 {
             return Err(Error::SrtpError("RTCP packet too short".to_string()));
         }
 
-        // Extract header and payload
-        let header = &data[0..8];
-        let payload = &data[8..];
+        // Header, encrypted payload, then the E flag and SRTCP index
+        let mut result = BytesMut::with_capacity(data.len() + SRTCP_INDEX_LEN);
+        result.extend_from_slice(data);
 
-        // Create a mutable buffer for our result
-        let mut result = BytesMut::with_capacity(data.len() + 4); // Space for index (4)
-
-        // Copy the header
-        result.extend_from_slice(header);
-
-        // Create a mutable copy of the payload for encryption
-        let mut encrypted_payload = BytesMut::from(payload);
-
-        // Create an IV (simplified - in a real implementation we'd extract SSRC from the RTCP packet)
-        let ssrc = 0u32; // Simplified - would extract from packet
-        let index = 0u64; // Simplified - would track index
-
-        let iv = match self.suite.encryption {
-            SrtpEncryptionAlgorithm::AesCm => {
-                super::create_srtp_iv(&session_keys.rtcp_salt, ssrc, index)?
-            }
-            _ => {
-                return Err(Error::SrtpError(
-                    "Unsupported encryption algorithm".to_string(),
-                ))
-            }
-        };
-
-        // Encrypt the payload
-        match self.suite.encryption {
-            SrtpEncryptionAlgorithm::AesCm => {
-                aes_cm_encrypt(&mut encrypted_payload, &session_keys.rtcp_enc_key, &iv)?;
-            }
-            _ => {
-                return Err(Error::SrtpError(
-                    "Unsupported encryption algorithm".to_string(),
-                ))
-            }
-        }
-
-        // Add encrypted payload to result
-        result.extend_from_slice(&encrypted_payload);
-
-        // Add SRTCP index and E flag
+        // Simplified - would extract the SSRC from the packet and track the index
+        let ssrc = 0u32;
+        let index = 0u64;
+        cm.apply_keystream(ssrc, index, &mut result[8..])?;
         result.put_u32(0x80000000 | (index as u32)); // E flag set, index 0
 
         // Calculate authentication tag if needed
-        let auth_tag = if self.suite.authentication != SrtpAuthenticationAlgorithm::Null {
-            let auth_tag = self.calculate_rtcp_auth_tag(&result, 0)?;
-            Some(auth_tag)
-        } else {
-            None
-        };
+        let auth_tag = cm
+            .auth_tag(&result, &[])
+            .map(|tag| tag[..self.suite.tag_length].to_vec());
 
         Ok((result.freeze(), auth_tag))
     }
 
-    /// Calculate authentication tag for an RTCP packet
-    fn calculate_rtcp_auth_tag(&self, data: &[u8], _index: u32) -> Result<Vec<u8>> {
-        if self.suite.authentication == SrtpAuthenticationAlgorithm::Null {
-            return Err(Error::SrtpError(
-                "Authentication is not enabled".to_string(),
-            ));
-        }
-
-        // Get session keys
-        let session_keys = self
-            .session_keys
-            .as_ref()
-            .ok_or_else(|| Error::SrtpError("Session keys not derived".to_string()))?;
-
-        // Create HMAC-SHA1 instance
-        let tag = hmac_sha1(data, &session_keys.rtcp_auth_key, self.suite.tag_length)?;
-
-        Ok(tag)
-    }
-
     /// Decrypt an SRTCP packet
     pub fn decrypt_rtcp(&self, data: &[u8]) -> Result<Bytes> {
+        if self.suite.is_aead() {
+            return self.decrypt_rtcp_gcm(data);
+        }
+
         if self.suite.encryption == SrtpEncryptionAlgorithm::Null
             && self.suite.authentication == SrtpAuthenticationAlgorithm::Null
         {
@@ -517,189 +749,49 @@ impl SrtpCrypto {
             return Ok(Bytes::copy_from_slice(data));
         }
 
-        // Get session keys
-        let session_keys = self
-            .session_keys
-            .as_ref()
-            .ok_or_else(|| Error::SrtpError("Session keys not derived".to_string()))?;
+        let cm = &self.cm_session()?.rtcp;
 
         // Check packet minimum length (header + index + auth tag)
-        let min_len = 8
-            + 4
-            + (if self.suite.authentication != SrtpAuthenticationAlgorithm::Null {
-                self.suite.tag_length
-            } else {
-                0
-            });
-
-        if data.len() < min_len {
+        let tag_length = self.rtp_trailer_len();
+        if data.len() < 8 + SRTCP_INDEX_LEN + tag_length {
             return Err(Error::SrtpError(format!(
                 "SRTCP packet too short: {} bytes",
                 data.len()
             )));
         }
 
-        // Calculate authentication tag position
-        let auth_tag_pos = data.len() - self.suite.tag_length;
-
         // Verify authentication tag if authentication is enabled
-        if self.suite.authentication != SrtpAuthenticationAlgorithm::Null {
-            let packet_data = &data[0..auth_tag_pos];
-            let auth_tag = &data[auth_tag_pos..];
-
-            // Calculate authentication tag to compare
-            let calculated_tag = self.calculate_rtcp_auth_tag(packet_data, 0)?;
-
-            // Constant-time comparison to prevent timing attacks
-            let mut result = 0;
-            if calculated_tag.len() != auth_tag.len() {
-                return Err(Error::SrtpError(
-                    "Authentication tag length mismatch".to_string(),
-                ));
-            }
-
-            for (a, b) in calculated_tag.iter().zip(auth_tag.iter()) {
-                result |= a ^ b;
-            }
-
-            if result != 0 {
-                return Err(Error::SrtpError("SRTCP authentication failed".to_string()));
-            }
-        }
+        let auth_tag_pos = data.len() - tag_length;
+        cm.verify_tag(&data[..auth_tag_pos], &[], &data[auth_tag_pos..])
+            .map_err(|_| Error::SrtpError("SRTCP authentication failed".to_string()))?;
 
         // Get the index and E flag
-        let index_pos = auth_tag_pos - 4;
-        let index_bytes = [
+        let index_pos = auth_tag_pos - SRTCP_INDEX_LEN;
+        let index_value = u32::from_be_bytes([
             data[index_pos],
             data[index_pos + 1],
             data[index_pos + 2],
             data[index_pos + 3],
-        ];
-        let index_value = u32::from_be_bytes(index_bytes);
+        ]);
         let e_flag = (index_value & 0x80000000) != 0;
         let index = index_value & 0x7FFFFFFF;
 
-        // If E flag is not set, packet is not encrypted
-        if !e_flag {
-            // Remove the index and auth tag
-            let mut result = BytesMut::with_capacity(index_pos);
-            result.extend_from_slice(&data[0..index_pos]);
-            return Ok(result.freeze());
-        }
-
-        // Extract header and payload
-        let header = &data[0..8];
-        let payload = &data[8..index_pos];
-
-        // Create a mutable buffer for our result
-        let mut result = BytesMut::with_capacity(index_pos);
-
-        // Copy the header
-        result.extend_from_slice(header);
-
-        // Create a mutable copy of the payload for decryption
-        let mut decrypted_payload = BytesMut::from(payload);
-
-        // Create an IV (simplified - in a real implementation we'd extract SSRC from the RTCP packet)
-        let ssrc = 0u32; // Simplified - would extract from packet
+        let mut result = BytesMut::from(&data[..index_pos]);
 
-        let iv = match self.suite.encryption {
-            SrtpEncryptionAlgorithm::AesCm => {
-                super::create_srtp_iv(&session_keys.rtcp_salt, ssrc, index as u64)?
-            }
-            _ => {
-                return Err(Error::SrtpError(
-                    "Unsupported encryption algorithm".to_string(),
-                ))
-            }
-        };
-
-        // Decrypt the payload
-        match self.suite.encryption {
-            SrtpEncryptionAlgorithm::AesCm => {
-                aes_cm_decrypt(&mut decrypted_payload, &session_keys.rtcp_enc_key, &iv)?;
-            }
-            _ => {
-                return Err(Error::SrtpError(
-                    "Unsupported encryption algorithm".to_string(),
-                ))
-            }
+        // If E flag is not set, packet is not encrypted
+        if e_flag {
+            // Simplified - would extract the SSRC from the packet
+            let ssrc = 0u32;
+            cm.apply_keystream(ssrc, index as u64, &mut result[8..])?;
         }
 
-        // Add decrypted payload to result
-        result.extend_from_slice(&decrypted_payload);
-
         Ok(result.freeze())
     }
 }
 
-/// AES Counter Mode encryption for SRTP
-fn aes_cm_encrypt(data: &mut [u8], key: &[u8], iv: &[u8]) -> Result<()> {
-    if iv.len() < 16 {
-        return Err(Error::SrtpError(format!(
-            "AES-CM IV too short: expected 16 bytes, got {}",
-            iv.len()
-        )));
-    }
-    let iv = GenericArray::from_slice(&iv[0..16]);
-
-    match key.len() {
-        16 => {
-            let key = GenericArray::from_slice(key);
-            let mut cipher = Aes128Ctr64BE::new(key, iv);
-            cipher.apply_keystream(data);
-        }
-        32 => {
-            let key = GenericArray::from_slice(key);
-            let mut cipher = Aes256Ctr64BE::new(key, iv);
-            cipher.apply_keystream(data);
-        }
-        len => {
-            return Err(Error::SrtpError(format!(
-                "unsupported AES-CM key length: {} bytes",
-                len
-            )));
-        }
-    }
-
-    Ok(())
-}
-
-/// AES Counter Mode decryption for SRTP
-fn aes_cm_decrypt(data: &mut [u8], key: &[u8], iv: &[u8]) -> Result<()> {
-    // AES-CM is symmetric, so encryption and decryption are the same
-    aes_cm_encrypt(data, key, iv)
-}
-
-/// HMAC-SHA1 authentication for SRTP
-fn hmac_sha1(data: &[u8], key: &[u8], tag_length: usize) -> Result<Vec<u8>> {
-    // Create a new HMAC-SHA1 instance
-    let mut mac = HmacSha1::new_from_slice(key)
-        .map_err(|e| Error::SrtpError(format!("Failed to create HMAC: {}", e)))?;
-
-    // Update with data
-    mac.update(data);
-
-    // Finalize and get the result
-    let result = mac.finalize().into_bytes();
-
-    // Truncate to the requested tag length. Guard against a misconfigured
-    // suite whose tag_length exceeds the 20-byte HMAC-SHA1 output (otherwise
-    // the slice below panics).
-    if tag_length > result.len() {
-        return Err(Error::SrtpError(format!(
-            "auth tag_length {} exceeds HMAC-SHA1 output {}",
-            tag_length,
-            result.len()
-        )));
-    }
-    let tag = result.as_slice()[..tag_length].to_vec();
-
-    Ok(tag)
-}
-
 #[cfg(test)]
 mod tests {
+    use super::super::{SRTP_AEAD_AES_128_GCM, SRTP_AEAD_AES_256_GCM};
     use super::*;
 
     fn hex_bytes(hex: &str) -> Vec<u8> {
@@ -768,12 +860,11 @@ mod tests {
     fn test_aes_cm_encryption() {
         // Test data
         let mut data = vec![0, 1, 2, 3, 4, 5, 6, 7, 8, 9];
-        let key = vec![0; 16]; // 16-byte AES key (all zeros)
-        let iv = vec![0; 16]; // 16-byte IV (all zeros)
+        let cipher = AesCtrKey::new(&[0; 16]).unwrap(); // 16-byte AES key (all zeros)
+        let iv = [0; 16]; // 16-byte IV (all zeros)
 
         // Encrypt
-        let result = aes_cm_encrypt(&mut data, &key, &iv);
-        assert!(result.is_ok());
+        cipher.apply_keystream(&iv, &mut data);
 
         // Data should now be encrypted - it should differ from the original
         assert_ne!(data, vec![0, 1, 2, 3, 4, 5, 6, 7, 8, 9]);
@@ -782,8 +873,7 @@ mod tests {
         let _encrypted = data.clone();
 
         // Now decrypt
-        let result = aes_cm_decrypt(&mut data, &key, &iv);
-        assert!(result.is_ok());
+        cipher.apply_keystream(&iv, &mut data);
 
         // Data should now be decrypted back to the original
         assert_eq!(data, vec![0, 1, 2, 3, 4, 5, 6, 7, 8, 9]);
@@ -791,39 +881,43 @@ mod tests {
 
     #[test]
     fn test_rfc3711_appendix_b2_aes_cm_vector() {
-        let key = hex_bytes("2B7E151628AED2A6ABF7158809CF4F3C");
-        let iv = hex_bytes("F0F1F2F3F4F5F6F7F8F9FAFBFCFD0000");
+        let cipher = AesCtrKey::new(&hex_bytes("2B7E151628AED2A6ABF7158809CF4F3C")).unwrap();
+        let iv: [u8; 16] = hex_bytes("F0F1F2F3F4F5F6F7F8F9FAFBFCFD0000")
+            .try_into()
+            .unwrap();
         let mut data = vec![0u8; 16];
 
-        aes_cm_encrypt(&mut data, &key, &iv).unwrap();
+        cipher.apply_keystream(&iv, &mut data);
 
         assert_eq!(data, hex_bytes("E03EAD0935C95E80E166B16DD92B4EB4"));
     }
 
     #[test]
     fn test_hmac_sha1() {
-        // Test data
-        let data = vec![0, 1, 2, 3, 4, 5, 6, 7, 8, 9];
-        let key = vec![0; 20]; // 20-byte key (all zeros)
-
-        // Calculate tag with length 10 (80 bits)
-        let tag = hmac_sha1(&data, &key, 10);
-        assert!(tag.is_ok());
-        let tag = tag.unwrap();
-
-        // Tag should be 10 bytes long
-        assert_eq!(tag.len(), 10);
-
-        // Calculate tag with length 4 (32 bits)
-        let tag32 = hmac_sha1(&data, &key, 4);
-        assert!(tag32.is_ok());
-        let tag32 = tag32.unwrap();
+        // RFC 2202 test case 2
+        let mac = CmCipher::new(
+            &super::super::SRTP_AES128_CM_SHA1_80,
+            &[0; 16],
+            b"Jefe",
+            &[0; 14],
+        )
+        .unwrap();
+        let data = b"what do ya want for nothing?";
+        let tag = mac.auth_tag(data, &[]).unwrap();
+        assert_eq!(
+            tag.to_vec(),
+            hex_bytes("effcdf6ae5eb2fa2d27416d5f184df9c259a7c79")
+        );
 
-        // Tag should be 4 bytes long
-        assert_eq!(tag32.len(), 4);
+        // The keyed state is reused: a second tag over split input matches
+        assert_eq!(mac.auth_tag(&data[..10], &data[10..]), Some(tag));
 
-        // First 4 bytes should match between the two tags
-        assert_eq!(tag[0..4], tag32[0..4]);
+        // 80- and 32-bit truncations verify; a flipped bit does not
+        assert!(mac.verify_tag(data, &[], &tag[..10]).is_ok());
+        assert!(mac.verify_tag(data, &[], &tag[..4]).is_ok());
+        let mut bad = tag;
+        bad[0] ^= 1;
+        assert!(mac.verify_tag(data, &[], &bad[..10]).is_err());
     }
 
     #[test]
@@ -1013,4 +1107,246 @@ mod tests {
             assert!(decrypted.is_err());
         }
     }
+
+    /// Build an AEAD context directly from RFC 7714 session keys.
+    fn gcm_with_session_keys(suite: SrtpCryptoSuite, key: &[u8], salt: &[u8]) -> SrtpCrypto {
+        SrtpCrypto {
+            suite,
+            master_key: SrtpCryptoKey::new(key.to_vec(), salt.to_vec()),
+            session_keys: Some(SrtpSessionKeys {
+                rtp_enc_key: key.to_vec(),
+                rtp_auth_key: Vec::new(),
+                rtp_salt: salt.to_vec(),
+                rtcp_enc_key: key.to_vec(),
+                rtcp_auth_key: Vec::new(),
+                rtcp_salt: salt.to_vec(),
+            }),
+            cm: None,
+            gcm: Some(GcmSessionCiphers {
+                rtp: AesGcmCipher::new(key).unwrap(),
+                rtcp: AesGcmCipher::new(key).unwrap(),
+            }),
+            rtp_send_index: PacketIndexTracker::default(),
+            rtp_recv_index: PacketIndexTracker::default(),
+            rtcp_send_index: AtomicU32::new(0),
+        }
+    }
+
+    const RFC7714_KEY: &str = "000102030405060708090a0b0c0d0e0f";
+    const RFC7714_SALT: &str = "517569642070726f2071756f";
+
+    #[test]
+    fn test_rfc7714_aes_128_gcm_rtp_vector() {
+        // RFC 7714 §16.1.1
+        let crypto = gcm_with_session_keys(
+            SRTP_AEAD_AES_128_GCM,
+            &hex_bytes(RFC7714_KEY),
+            &hex_bytes(RFC7714_SALT),
+        );
+        let header = hex_bytes("8040f17b8041f8d35501a0b2");
+        let plaintext = hex_bytes(
+            "47616c6c696120657374206f6d6e69732064697669736120696e207061727465732074726573",
+        );
+        let mut packet_bytes = header.clone();
+        packet_bytes.extend_from_slice(&plaintext);
+        let packet = RtpPacket::parse(&packet_bytes).unwrap();
+
+        assert_eq!(
+            gcm_rtp_iv(&hex_bytes(RFC7714_SALT), 0x5501a0b2, 0xf17b).to_vec(),
+            hex_bytes("51753c6580c2726f20718414")
+        );
+
+        let (encrypted, tag) = crypto.encrypt_rtp(&packet).unwrap();
+        assert_eq!(
+            encrypted.payload.to_vec(),
+            hex_bytes(
+                "f24de3a3fb34de6cacba861c9d7e4bcabe633bd50d294e6f42a5f47a51c7d19b36de3adf8833"
+            )
+        );
+        let tag = tag.unwrap();
+        assert_eq!(tag, hex_bytes("899d7f27beb16a9152cf765ee4390cce"));
+
+        let mut wire = header;
+        wire.extend_from_slice(&encrypted.payload);
+        wire.extend_from_slice(&tag);
+        let decrypted = crypto.decrypt_rtp(&wire).unwrap();
+        assert_eq!(decrypted.payload.to_vec(), plaintext);
+    }
+
+    #[test]
+    fn test_rfc7714_aes_128_gcm_srtcp_vector() {
+        // RFC 7714 §17.1
+        let crypto = gcm_with_session_keys(
+            SRTP_AEAD_AES_128_GCM,
+            &hex_bytes(RFC7714_KEY),
+            &hex_bytes(RFC7714_SALT),
+        );
+        crypto.rtcp_send_index.store(0x5d4, Ordering::Relaxed);
+        let mut rtcp = hex_bytes("81c8000d4d617273");
+        let body = hex_bytes(
+            "4e5450314e545032525450200000042a0000e9304c756e61deadbeefdeadbeefdeadbeefdeadbeefdeadbeef",
+        );
+        rtcp.extend_from_slice(&body);
+
+        let srtcp = crypto.encrypt_rtcp(&rtcp).unwrap().0;
+        let mut expected = hex_bytes("81c8000d4d617273");
+        expected.extend_from_slice(&hex_bytes(
+            "63e94885dcdab67ca727d7662f6b7e997ff5c0f76c06f32dc676a5f1730d6fda4ce09b4686303ded0bb9275b",
+        ));
+        expected.extend_from_slice(&hex_bytes("c84aa45896cf4d2fc5abf87245d9eade"));
+        expected.extend_from_slice(&hex_bytes("800005d4"));
+        assert_eq!(srtcp.to_vec(), expected);
+
+        assert_eq!(crypto.decrypt_rtcp(&srtcp).unwrap().to_vec(), rtcp);
+    }
+
+    #[test]
+    fn test_aead_gcm_round_trip_and_tamper() {
+        for (suite, key_len) in [(SRTP_AEAD_AES_128_GCM, 16), (SRTP_AEAD_AES_256_GCM, 32)] {
+            let key = SrtpCryptoKey::new(vec![0x2a; key_len], vec![0x17; 12]);
+            let sender = SrtpCrypto::new(suite.clone(), key.clone()).unwrap();
+            let receiver = SrtpCrypto::new(suite, key).unwrap();
+
+            let header = crate::packet::RtpHeader::new(96, 1000, 160, 0x1234_5678);
+            let packet = RtpPacket::new(header, Bytes::from_static(b"aead protected payload"));
+            let (encrypted, tag) = sender.encrypt_rtp(&packet).unwrap();
+            assert_ne!(encrypted.payload, packet.payload);
+
+            let mut wire = encrypted.serialize().unwrap().to_vec();
+            wire.extend_from_slice(&tag.unwrap());
+            let decrypted = receiver.decrypt_rtp(&wire).unwrap();
+            assert_eq!(decrypted.payload, packet.payload);
+
+            // Header bytes are authenticated as AAD.
+            let mut tampered = wire.clone();
+            tampered[1] ^= 0x01;
+            assert!(receiver.decrypt_rtp(&tampered).is_err());
+            let last = wire.len() - 1;
+            wire[last] ^= 0x80;
+            assert!(receiver.decrypt_rtp(&wire).is_err());
+
+            let rtcp = [0x80, 0xc8, 0x00, 0x06, 0x12, 0x34, 0x56, 0x78, 1, 2, 3, 4];
+            let mut srtcp = sender.encrypt_rtcp(&rtcp).unwrap().0.to_vec();
+            assert_eq!(srtcp.len(), rtcp.len() + GCM_TAG_LEN + SRTCP_INDEX_LEN);
+            assert_eq!(receiver.decrypt_rtcp(&srtcp).unwrap().as_ref(), &rtcp[..]);
+            srtcp[9] ^= 0x01;
+            assert!(receiver.decrypt_rtcp(&srtcp).is_err());
+        }
+    }
+
+    #[test]
+    fn test_aead_gcm_rollover_counter() {
+        let key = SrtpCryptoKey::new(vec![0x01; 16], vec![0x02; 12]);
+        let sender = SrtpCrypto::new(SRTP_AEAD_AES_128_GCM, key.clone()).unwrap();
+        let receiver = SrtpCrypto::new(SRTP_AEAD_AES_128_GCM, key).unwrap();
+
+        let mut ciphertexts = Vec::new();
+        for seq in [65534u16, 65535, 0, 1] {
+            let header = crate::packet::RtpHeader::new(0, seq, 0, 42);
+            let packet = RtpPacket::new(header, Bytes::from_static(&[0u8; 16]));
+            let (encrypted, tag) = sender.encrypt_rtp(&packet).unwrap();
+            let mut wire = encrypted.serialize().unwrap().to_vec();
+            wire.extend_from_slice(&tag.unwrap());
+            assert_eq!(
+                receiver.decrypt_rtp(&wire).unwrap().payload.as_ref(),
+                &[0u8; 16]
+            );
+            ciphertexts.push(encrypted.payload);
+        }
+
+        // Sequence 0 after the wrap is index 65536, not a reuse of index 0.
+        assert_eq!(sender.rtp_send_index.estimate(2), 0x1_0002);
+        assert_eq!(receiver.rtp_recv_index.estimate(65535), 0xffff);
+        let fresh = SrtpCrypto::new(
+            SRTP_AEAD_AES_128_GCM,
+            SrtpCryptoKey::new(vec![0x01; 16], vec![0x02; 12]),
+        )
+        .unwrap();
+        let header = crate::packet::RtpHeader::new(0, 0, 0, 42);
+        let (roc0, _) = fresh
+            .encrypt_rtp(&RtpPacket::new(header, Bytes::from_static(&[0u8; 16])))
+            .unwrap();
+        assert_ne!(roc0.payload, ciphertexts[2]);
+    }
+
+    #[test]
+    fn test_aes_cm_rollover_counter() {
+        let key = SrtpCryptoKey::new(vec![0x01; 16], vec![0x02; 14]);
+        let sender = SrtpCrypto::new(super::super::SRTP_AES128_CM_SHA1_80, key.clone()).unwrap();
+        let receiver = SrtpCrypto::new(super::super::SRTP_AES128_CM_SHA1_80, key).unwrap();
+
+        let protect = |seq: u16| {
+            let header = crate::packet::RtpHeader::new(0, seq, 0, 42);
+            let packet = RtpPacket::new(header, Bytes::from_static(&[0u8; 16]));
+            let mut buf = BytesMut::new();
+            packet.write_to(&mut buf).unwrap();
+            sender.protect_rtp_in_place(&mut buf).unwrap();
+            buf
+        };
+        let mut wrapped = BytesMut::new();
+        for seq in [65534u16, 65535, 0, 1] {
+            let mut buf = protect(seq);
+            if seq == 0 {
+                wrapped = buf.clone();
+            }
+            receiver.unprotect_rtp_in_place(&mut buf).unwrap();
+            assert_eq!(&buf[12..], &[0u8; 16]);
+        }
+        assert_eq!(sender.rtp_send_index.estimate(2), 0x1_0002);
+        assert_eq!(receiver.rtp_recv_index.estimate(2), 0x1_0002);
+
+        // The tag of sequence 0 after the wrap covers ROC 1: a receiver
+        // still at ROC 0 rejects it, and a failed check does not advance
+        // the receiver's index.
+        let fresh = SrtpCrypto::new(
+            super::super::SRTP_AES128_CM_SHA1_80,
+            SrtpCryptoKey::new(vec![0x01; 16], vec![0x02; 14]),
+        )
+        .unwrap();
+        assert!(fresh.unprotect_rtp_in_place(&mut wrapped.clone()).is_err());
+        assert_eq!(fresh.rtp_recv_index.estimate(0), 0);
+    }
+
+    #[test]
+    fn test_in_place_matches_legacy_path() {
+        let suites = [
+            (super::super::SRTP_AES128_CM_SHA1_80, 16, 14),
+            (super::super::SRTP_AES128_CM_SHA1_32, 16, 14),
+            (super::super::SRTP_AES256_CM_SHA1_80, 32, 14),
+            (SRTP_AEAD_AES_128_GCM, 16, 12),
+            (SRTP_AEAD_AES_256_GCM, 32, 12),
+        ];
+        for (suite, key_len, salt_len) in suites {
+            let key = SrtpCryptoKey::new(vec![0x5a; key_len], vec![0x3c; salt_len]);
+            let legacy = SrtpCrypto::new(suite.clone(), key.clone()).unwrap();
+            let sender = SrtpCrypto::new(suite.clone(), key.clone()).unwrap();
+            let receiver = SrtpCrypto::new(suite, key).unwrap();
+
+            let header = crate::packet::RtpHeader::new(0, 4242, 160, 0x0bad_cafe);
+            let packet = RtpPacket::new(header, Bytes::from_static(&[0x11; 160]));
+
+            let (encrypted, tag) = legacy.encrypt_rtp(&packet).unwrap();
+            let mut expected = encrypted.serialize().unwrap().to_vec();
+            expected.extend_from_slice(&tag.unwrap());
+
+            let mut buf = BytesMut::with_capacity(packet.size() + sender.rtp_trailer_len());
+            packet.write_to(&mut buf).unwrap();
+            let base = buf.as_ptr();
+            sender.protect_rtp_in_place(&mut buf).unwrap();
+            assert_eq!(&buf[..], &expected[..]);
+            // Enough headroom was reserved, so the buffer never moved.
+            assert_eq!(buf.as_ptr(), base);
+
+            receiver.unprotect_rtp_in_place(&mut buf).unwrap();
+            assert_eq!(buf.as_ptr(), base);
+            assert_eq!(&buf[..], &packet.serialize().unwrap()[..]);
+
+            // A corrupted tag leaves the buffer untouched.
+            let mut tampered = BytesMut::from(&expected[..]);
+            let last = tampered.len() - 1;
+            tampered[last] ^= 0x01;
+            assert!(receiver.unprotect_rtp_in_place(&mut tampered).is_err());
+            assert_eq!(tampered.len(), expected.len());
+        }
+    }
 }
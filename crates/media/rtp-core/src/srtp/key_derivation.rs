@@ -53,9 +53,11 @@ pub fn srtp_kdf(
     params: &SrtpKeyDerivationParams,
     output_len: usize,
 ) -> Result<Vec<u8>> {
-    if master_key.salt().len() < 14 {
+    // AEAD suites carry a 96-bit master salt, zero-padded on the right to
+    // the KDF's 112-bit input (RFC 7714 §11, as libsrtp does).
+    if master_key.salt().len() < 12 {
         return Err(Error::SrtpError(format!(
-            "Salt too short: expected at least 14 bytes, got {}",
+            "Salt too short: expected at least 12 bytes, got {}",
             master_key.salt().len()
         )));
     }
@@ -75,7 +77,8 @@ pub fn srtp_kdf(
     // RFC 3711 Section 4.3.1: x = key_id XOR master_salt, where key_id is the
     // right-aligned 7-octet value label || (index DIV key_derivation_rate).
     let mut x = [0u8; 14];
-    x.copy_from_slice(&master_key.salt()[0..14]);
+    let salt_len = master_key.salt().len().min(14);
+    x[..salt_len].copy_from_slice(&master_key.salt()[..salt_len]);
     x[7] ^= params.label as u8;
     for i in 0..6 {
         x[8 + i] ^= ((r >> (8 * (5 - i))) & 0xFF) as u8;
@@ -137,6 +140,13 @@ pub fn srtp_kdf(
 /// * `ssrc` - Synchronization source identifier
 /// * `packet_index` - Index of the packet
 pub fn create_srtp_iv(salt: &[u8], ssrc: u32, packet_index: u64) -> Result<Vec<u8>> {
+    create_srtp_iv_block(salt, ssrc, packet_index).map(|iv| iv.to_vec())
+}
+
+/// Create the SRTP IV as a fixed-size counter block, without allocating
+///
+/// Same layout as [`create_srtp_iv`]; used on the per-packet path.
+pub fn create_srtp_iv_block(salt: &[u8], ssrc: u32, packet_index: u64) -> Result<[u8; 16]> {
     if salt.len() < 14 {
         return Err(Error::SrtpError(format!(
             "Salt too short: expected at least 14 bytes, got {}",
@@ -144,29 +154,22 @@ pub fn create_srtp_iv(salt: &[u8], ssrc: u32, packet_index: u64) -> Result<Vec<u
         )));
     }
 
-    // Create an IV according to RFC 3711 Section 4.1.2
-    let mut iv = Vec::with_capacity(16);
-    iv.extend_from_slice(&salt[0..14]);
-
-    // Set the last two bytes to zero
-    iv.push(0);
-    iv.push(0);
+    // Create an IV according to RFC 3711 Section 4.1.2: the salt with the
+    // last two bytes zero
+    let mut iv = [0u8; 16];
+    iv[..14].copy_from_slice(&salt[..14]);
 
     // XOR the salt with the SSRC and packet index
     // SSRC goes into bytes 4-7 (indexed 0)
-    iv[4] ^= ((ssrc >> 24) & 0xFF) as u8;
-    iv[5] ^= ((ssrc >> 16) & 0xFF) as u8;
-    iv[6] ^= ((ssrc >> 8) & 0xFF) as u8;
-    iv[7] ^= (ssrc & 0xFF) as u8;
+    for (byte, ssrc) in iv[4..8].iter_mut().zip(ssrc.to_be_bytes()) {
+        *byte ^= ssrc;
+    }
 
     // Packet index goes into bytes 8-13 (indexed 0)
     // For typical 48-bit RTP sequence number + roll-over-counter combination
-    iv[8] ^= ((packet_index >> 40) & 0xFF) as u8;
-    iv[9] ^= ((packet_index >> 32) & 0xFF) as u8;
-    iv[10] ^= ((packet_index >> 24) & 0xFF) as u8;
-    iv[11] ^= ((packet_index >> 16) & 0xFF) as u8;
-    iv[12] ^= ((packet_index >> 8) & 0xFF) as u8;
-    iv[13] ^= (packet_index & 0xFF) as u8;
+    for (byte, index) in iv[8..14].iter_mut().zip(&packet_index.to_be_bytes()[2..]) {
+        *byte ^= index;
+    }
 
     Ok(iv)
 }
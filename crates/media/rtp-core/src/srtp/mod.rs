@@ -9,7 +9,8 @@ pub mod key_derivation;
 pub use auth::{SrtpAuthenticator, SrtpReplayProtection};
 pub use crypto::SrtpCryptoKey;
 pub use key_derivation::{
-    create_srtp_iv, srtp_kdf, KeyDerivationLabel, KeyRotationFrequency, SrtpKeyDerivationParams,
+    create_srtp_iv, create_srtp_iv_block, srtp_kdf, KeyDerivationLabel, KeyRotationFrequency,
+    SrtpKeyDerivationParams,
 };
 
 /// SRTP encryption algorithms
@@ -21,6 +22,11 @@ pub enum SrtpEncryptionAlgorithm {
     /// AES in f8-mode (Customized for SRTP)
     AesF8,
 
+    /// AES Galois/Counter Mode AEAD (RFC 7714). Encrypts and authenticates
+    /// in one pass, so suites using it carry
+    /// [`SrtpAuthenticationAlgorithm::Null`] and a 16-byte `tag_length`.
+    AeadAesGcm,
+
     /// Null encryption (for debugging/testing only)
     Null,
 }
@@ -102,23 +108,64 @@ pub const SRTP_NULL_NULL: SrtpCryptoSuite = SrtpCryptoSuite {
     tag_length: 0,
 };
 
-/// AEAD AES-128 GCM
+/// AEAD AES-128 GCM (RFC 7714)
 pub const SRTP_AEAD_AES_128_GCM: SrtpCryptoSuite = SrtpCryptoSuite {
-    encryption: SrtpEncryptionAlgorithm::AesCm, // Using AesCm as placeholder
+    encryption: SrtpEncryptionAlgorithm::AeadAesGcm,
     authentication: SrtpAuthenticationAlgorithm::Null, // Authentication is part of AEAD
-    key_length: 16,                             // 128 bits
-    tag_length: 16,                             // 128 bits for GCM
+    key_length: 16,                                    // 128 bits
+    tag_length: 16,                                    // 128 bits for GCM
 };
 
-/// AEAD AES-256 GCM
+/// AEAD AES-256 GCM (RFC 7714)
 pub const SRTP_AEAD_AES_256_GCM: SrtpCryptoSuite = SrtpCryptoSuite {
-    encryption: SrtpEncryptionAlgorithm::AesCm, // Using AesCm as placeholder
+    encryption: SrtpEncryptionAlgorithm::AeadAesGcm,
     authentication: SrtpAuthenticationAlgorithm::Null, // Authentication is part of AEAD
-    key_length: 32,                             // 256 bits
-    tag_length: 16,                             // 128 bits for GCM
+    key_length: 32,                                    // 256 bits
+    tag_length: 16,                                    // 128 bits for GCM
 };
 
+/// SDES crypto-suite names (RFC 4568 §6.2, RFC 6188 §7.1, RFC 7714 §14.2).
+const SDES_SUITES: [(&str, SrtpCryptoSuite); 6] = [
+    ("AEAD_AES_128_GCM", SRTP_AEAD_AES_128_GCM),
+    ("AEAD_AES_256_GCM", SRTP_AEAD_AES_256_GCM),
+    ("AES_CM_128_HMAC_SHA1_80", SRTP_AES128_CM_SHA1_80),
+    ("AES_CM_128_HMAC_SHA1_32", SRTP_AES128_CM_SHA1_32),
+    ("AES_256_CM_HMAC_SHA1_80", SRTP_AES256_CM_SHA1_80),
+    ("AES_256_CM_HMAC_SHA1_32", SRTP_AES256_CM_SHA1_32),
+];
+
 impl SrtpCryptoSuite {
+    /// Whether the suite is an AEAD suite (RFC 7714).
+    pub fn is_aead(&self) -> bool {
+        self.encryption == SrtpEncryptionAlgorithm::AeadAesGcm
+    }
+
+    /// Master salt length in bytes: 112 bits for AES-CM (RFC 3711 §8.2),
+    /// 96 bits for AEAD AES-GCM (RFC 7714 §12).
+    pub fn salt_length(&self) -> usize {
+        if self.is_aead() {
+            12
+        } else {
+            14
+        }
+    }
+
+    /// SDES (`a=crypto`) name of the suite, if it has one.
+    pub fn sdes_name(&self) -> Option<&'static str> {
+        SDES_SUITES
+            .iter()
+            .find(|(_, suite)| suite == self)
+            .map(|(name, _)| *name)
+    }
+
+    /// Look up a suite by its SDES (`a=crypto`) name.
+    pub fn from_sdes_name(name: &str) -> Option<Self> {
+        SDES_SUITES
+            .iter()
+            .find(|(suite_name, _)| *suite_name == name)
+            .map(|(_, suite)| suite.clone())
+    }
+
     /// Validate that the suite's parameters are internally consistent.
     ///
     /// The HMAC-SHA1 authentication tag is truncated from a fixed 20-byte
@@ -127,8 +174,21 @@ impl SrtpCryptoSuite {
     /// hand-constructed `SrtpCryptoSuite` literal (the fields are public)
     /// whose oversized `tag_length` would otherwise panic when the tag is
     /// sliced out of the digest during protect/unprotect.
+    ///
+    /// AEAD suites must use 128- or 256-bit keys, no separate
+    /// authentication, and the full 16-byte GCM tag (RFC 7714 §14.2).
     pub fn validate(&self) -> Result<(), crate::Error> {
         const HMAC_SHA1_OUTPUT_LEN: usize = 20;
+        if self.is_aead()
+            && (self.authentication != SrtpAuthenticationAlgorithm::Null
+                || self.tag_length != 16
+                || !matches!(self.key_length, 16 | 32))
+        {
+            return Err(crate::Error::SrtpError(format!(
+                "invalid AEAD SRTP suite: key_length {}, tag_length {}, authentication {:?}",
+                self.key_length, self.tag_length, self.authentication
+            )));
+        }
         match self.authentication {
             SrtpAuthenticationAlgorithm::HmacSha1_80 | SrtpAuthenticationAlgorithm::HmacSha1_32 => {
                 if self.tag_length > HMAC_SHA1_OUTPUT_LEN {
@@ -274,6 +334,35 @@ impl SrtpContext {
         })
     }
 
+    /// Protect a serialized RTP packet in place, appending the
+    /// authentication tag. Allocation-free when `buf` has
+    /// [`Self::rtp_trailer_len`] bytes of spare capacity.
+    pub fn protect_in_place(&mut self, buf: &mut bytes::BytesMut) -> Result<(), crate::Error> {
+        if !self.enabled {
+            return Ok(());
+        }
+        self.packet_index += 1;
+        self.crypto.protect_rtp_in_place(buf)
+    }
+
+    /// Unprotect an SRTP packet in place, leaving the plain RTP packet
+    /// (without the authentication tag) in `buf`
+    pub fn unprotect_in_place(&mut self, buf: &mut bytes::BytesMut) -> Result<(), crate::Error> {
+        if !self.enabled {
+            return Ok(());
+        }
+        self.crypto.unprotect_rtp_in_place(buf)
+    }
+
+    /// Bytes [`Self::protect_in_place`] appends to an RTP packet
+    pub fn rtp_trailer_len(&self) -> usize {
+        if self.enabled {
+            self.crypto.rtp_trailer_len()
+        } else {
+            0
+        }
+    }
+
     /// Unprotect an RTP packet (SRTP decryption)
     /// The input data should include the authentication tag if used
     pub fn unprotect(&mut self, data: &[u8]) -> Result<crate::packet::RtpPacket, crate::Error> {
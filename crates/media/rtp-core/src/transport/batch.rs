@@ -0,0 +1,620 @@
+//! Batched UDP socket I/O for the RTP transport (Linux)
+//!
+//! `recvmmsg(2)` drains up to N datagrams per readiness wakeup into a slab of
+//! receive buffers; `sendmmsg(2)` flushes a burst of outbound packets in a
+//! single call. When UDP segmentation offload is enabled, equal-sized bursts
+//! to one destination go out as a single `UDP_SEGMENT` send (GSO, Linux 4.18+)
+//! and the receive side accepts kernel-coalesced `UDP_GRO` super-datagrams
+//! (Linux 5.0+), splitting them back into their original packets.
+//!
+//! Slabs are shared per thread rather than owned per socket: a receive loop
+//! borrows its thread's slab with [`with_thread_recv_batch`] for one
+//! synchronous receive-and-dispatch pass, so memory scales with worker
+//! threads instead of with open transports. Slots are sized to the
+//! configured receive buffer (one MTU by default) and only grow to a full
+//! 64 KiB super-datagram on threads serving a socket with GRO enabled.
+//!
+//! Everything here is synchronous and non-blocking (`MSG_DONTWAIT`); the
+//! caller drives readiness through `tokio::net::UdpSocket::readable` and
+//! `try_io` (receive) or `async_io` (send).
+
+use std::cell::RefCell;
+use std::io;
+use std::mem::{size_of, zeroed};
+use std::net::{Ipv4Addr, Ipv6Addr, SocketAddr, SocketAddrV4, SocketAddrV6};
+use std::os::fd::RawFd;
+use std::ptr;
+
+use libc::{c_int, c_uint, c_void};
+
+// From <linux/udp.h>; spelled out because not every libc target exports them.
+const SOL_UDP: c_int = 17;
+const UDP_SEGMENT: c_int = 103;
+const UDP_GRO: c_int = 104;
+
+/// Kernel cap on segments in one GSO send (`UDP_MAX_SEGMENTS`).
+const GSO_MAX_SEGMENTS: usize = 64;
+
+/// Largest payload a single UDP datagram (or GRO super-datagram) can carry.
+const MAX_UDP_PAYLOAD: usize = 65_507;
+
+/// `sendmmsg`/`recvmmsg` vector limit (`UIO_MAXIOV`).
+pub(crate) const MAX_BATCH: usize = 1024;
+
+/// Whether the kernel accepts `UDP_SEGMENT` on this socket.
+pub(crate) fn gso_supported(fd: RawFd) -> bool {
+    let mut value: c_int = 0;
+    let mut len = size_of::<c_int>() as libc::socklen_t;
+    // SAFETY: `value`/`len` are valid for the duration of the call.
+    unsafe {
+        libc::getsockopt(
+            fd,
+            SOL_UDP,
+            UDP_SEGMENT,
+            &mut value as *mut c_int as *mut c_void,
+            &mut len,
+        ) == 0
+    }
+}
+
+/// Ask the kernel to coalesce inbound datagrams (`UDP_GRO`).
+pub(crate) fn enable_gro(fd: RawFd) -> io::Result<()> {
+    let on: c_int = 1;
+    // SAFETY: `on` is valid for the duration of the call.
+    let rc = unsafe {
+        libc::setsockopt(
+            fd,
+            SOL_UDP,
+            UDP_GRO,
+            &on as *const c_int as *const c_void,
+            size_of::<c_int>() as libc::socklen_t,
+        )
+    };
+    if rc == 0 {
+        Ok(())
+    } else {
+        Err(io::Error::last_os_error())
+    }
+}
+
+/// Errors meaning GSO is unavailable on this path (e.g. no checksum offload
+/// on the egress device) rather than a transient send failure.
+pub(crate) fn is_gso_unsupported(err: &io::Error) -> bool {
+    matches!(
+        err.raw_os_error(),
+        Some(libc::EIO) | Some(libc::EINVAL) | Some(libc::ENOPROTOOPT) | Some(libc::EOPNOTSUPP)
+    )
+}
+
+fn cmsg_space(payload: usize) -> usize {
+    // SAFETY: pure arithmetic macro.
+    unsafe { libc::CMSG_SPACE(payload as c_uint) as usize }
+}
+
+thread_local! {
+    /// This thread's receive slab, see [`with_thread_recv_batch`].
+    static THREAD_RECV_BATCH: RefCell<Option<RecvBatch>> = const { RefCell::new(None) };
+}
+
+/// Run `f` with this thread's shared receive slab, first growing it to at
+/// least `slots` slots of `slot_size` bytes (and GRO-sized slots when
+/// `gro`). The slab only ever grows, so sockets with different sizing
+/// served by one thread settle on the largest shape instead of
+/// reallocating back and forth.
+///
+/// `f` must receive and consume its datagrams without awaiting, and must
+/// not itself call this function.
+pub(crate) fn with_thread_recv_batch<R>(
+    slots: usize,
+    slot_size: usize,
+    gro: bool,
+    f: impl FnOnce(&mut RecvBatch) -> R,
+) -> R {
+    THREAD_RECV_BATCH.with(|cell| {
+        let mut cell = cell.borrow_mut();
+        let batch = match cell.take() {
+            Some(batch) if batch.fits(slots, slot_size, gro) => batch,
+            Some(batch) => RecvBatch::new(
+                slots.max(batch.capacity()),
+                slot_size.max(batch.slot_size),
+                gro || batch.gro(),
+            ),
+            None => RecvBatch::new(slots, slot_size, gro),
+        };
+        f(cell.insert(batch))
+    })
+}
+
+/// Reusable `recvmmsg` state: one buffer, address and header per slot.
+pub(crate) struct RecvBatch {
+    slot_size: usize,
+    buffers: Vec<u8>,
+    /// Per-slot ancillary data (GRO segment size); `u64` for cmsg alignment.
+    control: Vec<u64>,
+    control_len: usize,
+    addrs: Vec<libc::sockaddr_storage>,
+    iovecs: Vec<libc::iovec>,
+    headers: Vec<libc::mmsghdr>,
+    filled: usize,
+}
+
+impl RecvBatch {
+    /// `slots` datagrams of up to `slot_size` bytes per `recvmmsg` call. With
+    /// `gro`, each slot is sized for a full coalesced super-datagram.
+    pub(crate) fn new(slots: usize, slot_size: usize, gro: bool) -> Self {
+        let slots = slots.clamp(1, MAX_BATCH);
+        let slot_size = if gro {
+            slot_size.max(MAX_UDP_PAYLOAD)
+        } else {
+            slot_size.max(1)
+        };
+        let control_len = if gro {
+            cmsg_space(size_of::<c_int>())
+        } else {
+            0
+        };
+        let control_words = control_len.div_ceil(size_of::<u64>());
+
+        let mut batch = Self {
+            slot_size,
+            buffers: vec![0u8; slots * slot_size],
+            control: vec![0u64; slots * control_words],
+            control_len,
+            // SAFETY: all-zero is a valid sockaddr_storage.
+            addrs: vec![unsafe { zeroed() }; slots],
+            iovecs: Vec::with_capacity(slots),
+            headers: Vec::with_capacity(slots),
+            filled: 0,
+        };
+
+        for i in 0..slots {
+            batch.iovecs.push(libc::iovec {
+                // SAFETY: in bounds of `buffers`.
+                iov_base: unsafe { batch.buffers.as_mut_ptr().add(i * slot_size) } as *mut c_void,
+                iov_len: slot_size,
+            });
+        }
+        for i in 0..slots {
+            // SAFETY: all-zero is a valid mmsghdr; fields are set below.
+            let mut header: libc::mmsghdr = unsafe { zeroed() };
+            header.msg_hdr.msg_name = &mut batch.addrs[i] as *mut _ as *mut c_void;
+            header.msg_hdr.msg_iov = &mut batch.iovecs[i];
+            header.msg_hdr.msg_iovlen = 1;
+            if control_len > 0 {
+                header.msg_hdr.msg_control =
+                    batch.control[i * control_words..].as_mut_ptr() as *mut c_void;
+            }
+            batch.headers.push(header);
+        }
+        batch
+    }
+
+    /// Number of slots (datagrams per call).
+    pub(crate) fn capacity(&self) -> usize {
+        self.headers.len()
+    }
+
+    fn gro(&self) -> bool {
+        self.control_len > 0
+    }
+
+    fn fits(&self, slots: usize, slot_size: usize, gro: bool) -> bool {
+        let slot_size = if gro {
+            slot_size.max(MAX_UDP_PAYLOAD)
+        } else {
+            slot_size
+        };
+        self.capacity() >= slots.clamp(1, MAX_BATCH)
+            && self.slot_size >= slot_size
+            && (self.gro() || !gro)
+    }
+
+    /// One non-blocking `recvmmsg` into at most `slots` slots; returns the
+    /// number filled.
+    pub(crate) fn recv(&mut self, fd: RawFd, slots: usize) -> io::Result<usize> {
+        let slots = slots.clamp(1, self.headers.len());
+        for header in &mut self.headers[..slots] {
+            header.msg_hdr.msg_namelen = size_of::<libc::sockaddr_storage>() as libc::socklen_t;
+            header.msg_hdr.msg_controllen = self.control_len as _;
+            header.msg_hdr.msg_flags = 0;
+            header.msg_len = 0;
+        }
+        self.filled = 0;
+        // SAFETY: every header points at live, correctly sized storage
+        // owned by `self`.
+        let rc = unsafe {
+            libc::recvmmsg(
+                fd,
+                self.headers.as_mut_ptr(),
+                slots as c_uint,
+                libc::MSG_DONTWAIT,
+                ptr::null_mut(),
+            )
+        };
+        if rc < 0 {
+            return Err(io::Error::last_os_error());
+        }
+        self.filled = rc as usize;
+        Ok(self.filled)
+    }
+
+    /// Datagrams from the last [`Self::recv`], with GRO super-datagrams
+    /// split back into their original packets.
+    pub(crate) fn datagrams(&self) -> impl Iterator<Item = (&[u8], SocketAddr)> + '_ {
+        (0..self.filled).flat_map(move |i| {
+            let len = (self.headers[i].msg_len as usize).min(self.slot_size);
+            let start = i * self.slot_size;
+            let data = &self.buffers[start..start + len];
+            let segment = self.gro_segment_size(i).unwrap_or(len).max(1);
+            let source = sockaddr_to_std(&self.addrs[i]);
+            data.chunks(segment)
+                .filter_map(move |chunk| source.map(|addr| (chunk, addr)))
+        })
+    }
+
+    fn gro_segment_size(&self, slot: usize) -> Option<usize> {
+        if self.control_len == 0 {
+            return None;
+        }
+        let hdr = &self.headers[slot].msg_hdr;
+        // SAFETY: the kernel filled `msg_control`/`msg_controllen`; the
+        // CMSG_* helpers stay within that range.
+        unsafe {
+            let mut cmsg = libc::CMSG_FIRSTHDR(hdr);
+            while !cmsg.is_null() {
+                if (*cmsg).cmsg_level == SOL_UDP && (*cmsg).cmsg_type == UDP_GRO {
+                    let size = ptr::read_unaligned(libc::CMSG_DATA(cmsg) as *const c_int);
+                    return usize::try_from(size).ok().filter(|&s| s > 0);
+                }
+                cmsg = libc::CMSG_NXTHDR(hdr, cmsg);
+            }
+        }
+        None
+    }
+}
+
+/// Reusable `sendmmsg`/GSO scratch state.
+#[derive(Default)]
+pub(crate) struct SendBatch {
+    iovecs: Vec<libc::iovec>,
+    headers: Vec<libc::mmsghdr>,
+    /// Concatenated payload for a GSO send
+    gso_payload: Vec<u8>,
+    /// Ancillary data for a GSO send; `u64` for cmsg alignment.
+    gso_control: Vec<u64>,
+}
+
+// SAFETY: the raw pointers are rebuilt on every call and only dereferenced
+// by the kernel during that call.
+unsafe impl Send for SendBatch {}
+
+impl SendBatch {
+    /// One non-blocking send of as many of `packets` as the kernel accepts;
+    /// returns how many were sent (always at least one on success).
+    pub(crate) fn send(
+        &mut self,
+        fd: RawFd,
+        packets: &[&[u8]],
+        dest: &SocketAddr,
+        gso: bool,
+    ) -> io::Result<usize> {
+        let (addr, addr_len) = std_to_sockaddr(dest);
+        if gso {
+            if let Some((segment, count)) = gso_run(packets) {
+                return self
+                    .send_gso(fd, &packets[..count], segment, &addr, addr_len)
+                    .map(|_| count);
+            }
+        }
+        self.send_mmsg(fd, packets, &addr, addr_len)
+    }
+
+    fn send_mmsg(
+        &mut self,
+        fd: RawFd,
+        packets: &[&[u8]],
+        addr: &libc::sockaddr_storage,
+        addr_len: libc::socklen_t,
+    ) -> io::Result<usize> {
+        let count = packets.len().min(MAX_BATCH);
+        self.iovecs.clear();
+        self.iovecs
+            .extend(packets[..count].iter().map(|packet| libc::iovec {
+                iov_base: packet.as_ptr() as *mut c_void,
+                iov_len: packet.len(),
+            }));
+        self.headers.clear();
+        for iov in &mut self.iovecs {
+            // SAFETY: all-zero is a valid mmsghdr; fields are set below.
+            let mut header: libc::mmsghdr = unsafe { zeroed() };
+            header.msg_hdr.msg_name = addr as *const _ as *mut c_void;
+            header.msg_hdr.msg_namelen = addr_len;
+            header.msg_hdr.msg_iov = iov;
+            header.msg_hdr.msg_iovlen = 1;
+            self.headers.push(header);
+        }
+        // SAFETY: headers point at `addr` and at the caller's packet slices,
+        // all alive for the duration of the call.
+        let rc = unsafe {
+            libc::sendmmsg(
+                fd,
+                self.headers.as_mut_ptr(),
+                count as c_uint,
+                libc::MSG_DONTWAIT,
+            )
+        };
+        if rc < 0 {
+            return Err(io::Error::last_os_error());
+        }
+        Ok(rc as usize)
+    }
+
+    fn send_gso(
+        &mut self,
+        fd: RawFd,
+        packets: &[&[u8]],
+        segment: u16,
+        addr: &libc::sockaddr_storage,
+        addr_len: libc::socklen_t,
+    ) -> io::Result<()> {
+        self.gso_payload.clear();
+        for packet in packets {
+            self.gso_payload.extend_from_slice(packet);
+        }
+
+        let control_len = cmsg_space(size_of::<u16>());
+        self.gso_control.clear();
+        self.gso_control
+            .resize(control_len.div_ceil(size_of::<u64>()), 0);
+
+        let mut iov = libc::iovec {
+            iov_base: self.gso_payload.as_mut_ptr() as *mut c_void,
+            iov_len: self.gso_payload.len(),
+        };
+        // SAFETY: all-zero is a valid msghdr; fields are set below.
+        let mut msg: libc::msghdr = unsafe { zeroed() };
+        msg.msg_name = addr as *const _ as *mut c_void;
+        msg.msg_namelen = addr_len;
+        msg.msg_iov = &mut iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = self.gso_control.as_mut_ptr() as *mut c_void;
+        msg.msg_controllen = control_len as _;
+
+        // SAFETY: `msg_control` has room for one u16 cmsg (sized above);
+        // every pointer in `msg` is alive for the duration of the call.
+        let rc = unsafe {
+            let cmsg = libc::CMSG_FIRSTHDR(&msg);
+            (*cmsg).cmsg_level = SOL_UDP;
+            (*cmsg).cmsg_type = UDP_SEGMENT;
+            (*cmsg).cmsg_len = libc::CMSG_LEN(size_of::<u16>() as c_uint) as _;
+            ptr::write_unaligned(libc::CMSG_DATA(cmsg) as *mut u16, segment);
+            libc::sendmsg(fd, &msg, libc::MSG_DONTWAIT)
+        };
+        if rc < 0 {
+            return Err(io::Error::last_os_error());
+        }
+        Ok(())
+    }
+}
+
+/// The leading run of `packets` that one GSO send can carry: every packet
+/// but the last the same size, the last no larger. Returns
+/// `(segment_size, packet_count)`, or `None` when a plain `sendmmsg` is no
+/// worse (fewer than two packets, or mismatched sizes up front).
+fn gso_run(packets: &[&[u8]]) -> Option<(u16, usize)> {
+    let segment = packets.first()?.len();
+    if segment == 0 || packets.len() < 2 {
+        return None;
+    }
+    let limit = packets
+        .len()
+        .min(GSO_MAX_SEGMENTS)
+        .min(MAX_UDP_PAYLOAD / segment);
+    let mut count = 1;
+    while count < limit {
+        let len = packets[count].len();
+        if len > segment || len == 0 {
+            break;
+        }
+        count += 1;
+        if len < segment {
+            break; // a short packet can only end the run
+        }
+    }
+    (count >= 2).then_some((u16::try_from(segment).ok()?, count))
+}
+
+fn sockaddr_to_std(storage: &libc::sockaddr_storage) -> Option<SocketAddr> {
+    match storage.ss_family as c_int {
+        libc::AF_INET => {
+            // SAFETY: ss_family says this storage holds a sockaddr_in.
+            let addr = unsafe { &*(storage as *const _ as *const libc::sockaddr_in) };
+            Some(SocketAddr::V4(SocketAddrV4::new(
+                Ipv4Addr::from(u32::from_be(addr.sin_addr.s_addr)),
+                u16::from_be(addr.sin_port),
+            )))
+        }
+        libc::AF_INET6 => {
+            // SAFETY: ss_family says this storage holds a sockaddr_in6.
+            let addr = unsafe { &*(storage as *const _ as *const libc::sockaddr_in6) };
+            Some(SocketAddr::V6(SocketAddrV6::new(
+                Ipv6Addr::from(addr.sin6_addr.s6_addr),
+                u16::from_be(addr.sin6_port),
+                addr.sin6_flowinfo,
+                addr.sin6_scope_id,
+            )))
+        }
+        _ => None,
+    }
+}
+
+fn std_to_sockaddr(addr: &SocketAddr) -> (libc::sockaddr_storage, libc::socklen_t) {
+    // SAFETY: all-zero is a valid sockaddr_storage.
+    let mut storage: libc::sockaddr_storage = unsafe { zeroed() };
+    let len = match addr {
+        SocketAddr::V4(v4) => {
+            // SAFETY: sockaddr_storage is large and aligned enough for any
+            // sockaddr type.
+            let raw = unsafe { &mut *(&mut storage as *mut _ as *mut libc::sockaddr_in) };
+            raw.sin_family = libc::AF_INET as libc::sa_family_t;
+            raw.sin_port = v4.port().to_be();
+            raw.sin_addr = libc::in_addr {
+                s_addr: u32::from(*v4.ip()).to_be(),
+            };
+            size_of::<libc::sockaddr_in>()
+        }
+        SocketAddr::V6(v6) => {
+            // SAFETY: as above.
+            let raw = unsafe { &mut *(&mut storage as *mut _ as *mut libc::sockaddr_in6) };
+            raw.sin6_family = libc::AF_INET6 as libc::sa_family_t;
+            raw.sin6_port = v6.port().to_be();
+            raw.sin6_addr = libc::in6_addr {
+                s6_addr: v6.ip().octets(),
+            };
+            raw.sin6_flowinfo = v6.flowinfo();
+            raw.sin6_scope_id = v6.scope_id();
+            size_of::<libc::sockaddr_in6>()
+        }
+    };
+    (storage, len as libc::socklen_t)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::net::UdpSocket;
+    use std::os::fd::AsRawFd;
+
+    fn pair() -> (UdpSocket, UdpSocket) {
+        let rx = UdpSocket::bind("127.0.0.1:0").unwrap();
+        let tx = UdpSocket::bind("127.0.0.1:0").unwrap();
+        (rx, tx)
+    }
+
+    fn recv_all(rx: &UdpSocket, batch: &mut RecvBatch, want: usize) -> Vec<(Vec<u8>, SocketAddr)> {
+        rx.set_nonblocking(true).unwrap();
+        let mut got = Vec::new();
+        let deadline = std::time::Instant::now() + std::time::Duration::from_secs(2);
+        while got.len() < want && std::time::Instant::now() < deadline {
+            match batch.recv(rx.as_raw_fd(), batch.capacity()) {
+                Ok(_) => got.extend(batch.datagrams().map(|(d, a)| (d.to_vec(), a))),
+                Err(e) if e.kind() == io::ErrorKind::WouldBlock => {
+                    std::thread::sleep(std::time::Duration::from_millis(1))
+                }
+                Err(e) => panic!("recvmmsg: {e}"),
+            }
+        }
+        got
+    }
+
+    #[test]
+    fn test_sockaddr_round_trip() {
+        for addr in ["127.0.0.1:5004", "[::1]:6000", "[fe80::1%2]:7000"] {
+            let addr: SocketAddr = addr.parse().unwrap();
+            let (storage, _) = std_to_sockaddr(&addr);
+            assert_eq!(sockaddr_to_std(&storage), Some(addr));
+        }
+    }
+
+    #[test]
+    fn test_gso_run_boundaries() {
+        let a = [0u8; 172];
+        let short = [0u8; 40];
+        let long = [0u8; 200];
+        assert_eq!(gso_run(&[&a]), None);
+        assert_eq!(gso_run(&[&a, &a, &a]), Some((172, 3)));
+        assert_eq!(gso_run(&[&a, &a, &short, &a]), Some((172, 3)));
+        assert_eq!(gso_run(&[&a, &long]), None);
+        assert_eq!(gso_run(&[&a, &a, &long]), Some((172, 2)));
+        let many = vec![&a[..]; 100];
+        assert_eq!(gso_run(&many), Some((172, GSO_MAX_SEGMENTS)));
+    }
+
+    #[test]
+    fn test_sendmmsg_recvmmsg_round_trip() {
+        let (rx, tx) = pair();
+        let dest = rx.local_addr().unwrap();
+        let packets: Vec<Vec<u8>> = (0..40u8).map(|i| vec![i; 20 + i as usize]).collect();
+        let slices: Vec<&[u8]> = packets.iter().map(|p| &p[..]).collect();
+
+        let mut send = SendBatch::default();
+        let mut sent = 0;
+        while sent < slices.len() {
+            sent += send
+                .send(tx.as_raw_fd(), &slices[sent..], &dest, false)
+                .unwrap();
+        }
+
+        let mut batch = RecvBatch::new(16, 1500, false);
+        let got = recv_all(&rx, &mut batch, packets.len());
+        assert_eq!(got.len(), packets.len());
+        for ((data, source), expected) in got.iter().zip(&packets) {
+            assert_eq!(data, expected);
+            assert_eq!(*source, tx.local_addr().unwrap());
+        }
+    }
+
+    #[test]
+    fn test_gso_send_splits_or_falls_back() {
+        let (rx, tx) = pair();
+        let dest = rx.local_addr().unwrap();
+        let packets: Vec<Vec<u8>> = (0..10u8).map(|i| vec![i; 172]).collect();
+        let slices: Vec<&[u8]> = packets.iter().map(|p| &p[..]).collect();
+
+        let mut send = SendBatch::default();
+        let gso = gso_supported(tx.as_raw_fd());
+        let mut sent = 0;
+        while sent < slices.len() {
+            sent += match send.send(tx.as_raw_fd(), &slices[sent..], &dest, gso) {
+                Ok(n) => n,
+                Err(e) if is_gso_unsupported(&e) => send
+                    .send(tx.as_raw_fd(), &slices[sent..], &dest, false)
+                    .unwrap(),
+                Err(e) => panic!("send: {e}"),
+            };
+        }
+
+        // Without UDP_GRO the receiver sees the original datagrams.
+        let mut batch = RecvBatch::new(32, 1500, false);
+        let got = recv_all(&rx, &mut batch, packets.len());
+        let data: Vec<Vec<u8>> = got.into_iter().map(|(d, _)| d).collect();
+        assert_eq!(data, packets);
+    }
+
+    #[test]
+    fn test_gro_receive_splits_coalesced_datagrams() {
+        let (rx, tx) = pair();
+        if enable_gro(rx.as_raw_fd()).is_err() || !gso_supported(tx.as_raw_fd()) {
+            return; // kernel without UDP GRO/GSO
+        }
+        let dest = rx.local_addr().unwrap();
+        let packets: Vec<Vec<u8>> = (0..8u8).map(|i| vec![i; 160]).collect();
+        let slices: Vec<&[u8]> = packets.iter().map(|p| &p[..]).collect();
+        let mut send = SendBatch::default();
+        if send.send(tx.as_raw_fd(), &slices, &dest, true).is_err() {
+            return; // GSO rejected on this device
+        }
+
+        let mut batch = RecvBatch::new(4, 1500, true);
+        let got = recv_all(&rx, &mut batch, packets.len());
+        let data: Vec<Vec<u8>> = got.into_iter().map(|(d, _)| d).collect();
+        assert_eq!(data, packets);
+    }
+
+    #[test]
+    fn test_thread_slab_is_mtu_sized_and_only_grows() {
+        std::thread::spawn(|| {
+            let shape = |slots, size, gro| {
+                with_thread_recv_batch(slots, size, gro, |batch| {
+                    (batch.capacity(), batch.slot_size, batch.gro())
+                })
+            };
+            assert_eq!(shape(32, 1500, false), (32, 1500, false));
+            assert_eq!(shape(8, 1200, false), (32, 1500, false));
+            assert_eq!(shape(4, 1500, true), (32, MAX_UDP_PAYLOAD, true));
+            assert_eq!(shape(64, 1500, false), (64, MAX_UDP_PAYLOAD, true));
+        })
+        .join()
+        .unwrap();
+    }
+}
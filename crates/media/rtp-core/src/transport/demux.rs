@@ -0,0 +1,1148 @@
+//! Shared-socket RTP demultiplexer.
+//!
+//! [`UdpRtpTransport`](super::UdpRtpTransport) binds one socket and spawns
+//! one receive task per media session. At 10k+ concurrent calls that is
+//! 10-20k sockets, as many tasks, and an exhausted port range.
+//! [`SharedRtpSocket`] is the opt-in alternative: a small group of
+//! `SO_REUSEPORT` sockets on one port, one receive task each, serving every
+//! session registered on it.
+//!
+//! Inbound datagrams are routed to sessions by `(remote addr, SSRC)`:
+//!
+//! 1. `(addr, ssrc)` — learned from the first packet of each stream,
+//! 2. `(addr, *)` — the session's remote address (SDP, `set_remote_rtp_addr`,
+//!    symmetric-RTP sends, or a validated ICE connectivity check),
+//! 3. `ssrc` — only for SSRCs the session declared up front, which lets a
+//!    peer behind a NAT reach the session from an address the SDP did not
+//!    announce. Such a match learns `(addr, ssrc)`, never `(addr, *)`.
+//!
+//! The indexes are sharded copy-on-write maps behind `ArcSwap`: lookups on
+//! the receive path are wait-free, and a registration clones one shard of
+//! roughly `sessions / 1024` entries.
+//!
+//! STUN Binding Requests are answered inline as an ICE-lite agent (RFC 8445
+//! §2.5): the request's `USERNAME` selects the session by local ufrag, its
+//! `MESSAGE-INTEGRITY` is checked against the session's password, and the
+//! source address is added to the session's routes.
+//!
+//! Each session is a [`DemuxedRtpTransport`], which implements
+//! [`RtpTransport`] and emits the same [`RtpEvent`] stream as
+//! `UdpRtpTransport` (same SRTP, RFC 4733 and RTCP-mux handling).
+
+use std::borrow::Borrow;
+use std::collections::hash_map::RandomState;
+use std::collections::HashMap;
+use std::hash::{BuildHasher, Hash};
+use std::io;
+use std::net::SocketAddr;
+use std::sync::atomic::{AtomicBool, AtomicU64, AtomicUsize, Ordering};
+use std::sync::Arc;
+use std::time::Instant;
+
+use arc_swap::{ArcSwap, ArcSwapOption};
+use async_trait::async_trait;
+use bytes::BytesMut;
+use dashmap::DashMap;
+use socket2::{Domain, Protocol, Socket, Type};
+#[cfg(target_os = "linux")]
+use tokio::io::Interest;
+use tokio::net::UdpSocket;
+use tokio::sync::broadcast;
+use tokio::task::JoinHandle;
+use tracing::{debug, trace, warn};
+
+#[cfg(target_os = "linux")]
+use super::batch;
+use super::udp::{
+    classify_rtp_mux_packet, spawn_memory_tracked, RtpMuxPacketClass, RtpReceiveContext,
+};
+use super::{RtpTransport, RtpTransportBufferConfig};
+use crate::error::Error;
+use crate::network::stun::{decode_binding_request, encode_binding_success};
+use crate::packet::rtcp::RtcpPacket;
+use crate::packet::RtpPacket;
+use crate::traits::RtpEvent;
+use crate::Result;
+
+/// Shards per demux index. Sized so a registration at 100k sessions
+/// clones about a hundred entries.
+const DEMUX_SHARDS: usize = 1024;
+
+/// `(addr, ssrc)` routes a session learns from inbound traffic before it
+/// stops indexing new ones; bounds table growth from a peer cycling SSRCs.
+/// Unindexed streams still route through the `(addr, *)` entry.
+const MAX_ROUTES_PER_SESSION: usize = 16;
+
+/// Demux key: remote address plus SSRC, or `None` for "any SSRC".
+type RouteKey = (SocketAddr, Option<u32>);
+
+/// Hash index with wait-free reads: `DEMUX_SHARDS` immutable maps, each
+/// replaced wholesale (RCU) on write.
+struct DemuxIndex<K, V> {
+    hasher: RandomState,
+    shards: Box<[ArcSwap<HashMap<K, V>>]>,
+}
+
+impl<K: Hash + Eq + Clone, V: Clone> DemuxIndex<K, V> {
+    fn new() -> Self {
+        Self {
+            hasher: RandomState::new(),
+            shards: (0..DEMUX_SHARDS)
+                .map(|_| ArcSwap::from_pointee(HashMap::new()))
+                .collect(),
+        }
+    }
+
+    fn shard<Q: Hash + ?Sized>(&self, key: &Q) -> &ArcSwap<HashMap<K, V>> {
+        &self.shards[self.hasher.hash_one(key) as usize % DEMUX_SHARDS]
+    }
+
+    fn get<Q>(&self, key: &Q) -> Option<V>
+    where
+        K: Borrow<Q>,
+        Q: Hash + Eq + ?Sized,
+    {
+        self.shard(key).load().get(key).cloned()
+    }
+
+    /// Insert `key` unless it is already present, as one RCU on its
+    /// shard. Returns whether it was inserted.
+    fn try_insert(&self, key: K, value: V) -> bool {
+        let mut inserted = false;
+        self.shard(&key).rcu(|current| {
+            inserted = !current.contains_key(&key);
+            if !inserted {
+                return Arc::clone(current);
+            }
+            let mut next = HashMap::clone(current);
+            next.insert(key.clone(), value.clone());
+            Arc::new(next)
+        });
+        inserted
+    }
+
+    /// Insert `key` unless it maps to a value `keep` refuses to give up, as
+    /// one RCU on its shard. On refusal returns the value that kept it.
+    fn insert_unless(&self, key: K, value: V, keep: impl Fn(&V) -> bool) -> Option<V> {
+        let mut holder = None;
+        self.shard(&key).rcu(|current| {
+            holder = current.get(&key).filter(|existing| keep(existing)).cloned();
+            if holder.is_some() {
+                return Arc::clone(current);
+            }
+            let mut next = HashMap::clone(current);
+            next.insert(key.clone(), value.clone());
+            Arc::new(next)
+        });
+        holder
+    }
+
+    /// Remove `key` if it still maps to a value matching `owned`.
+    fn remove_if(&self, key: &K, owned: impl Fn(&V) -> bool) {
+        let shard = self.shard(key);
+        if !shard.load().get(key).is_some_and(&owned) {
+            return;
+        }
+        shard.rcu(|current| {
+            let mut next = HashMap::clone(current);
+            if next.get(key).is_some_and(&owned) {
+                next.remove(key);
+            }
+            next
+        });
+    }
+
+    fn len(&self) -> usize {
+        self.shards.iter().map(|shard| shard.load().len()).sum()
+    }
+}
+
+/// Shared-socket group configuration.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct SharedRtpSocketConfig {
+    /// Address every socket in the group binds. Port `0` picks one port
+    /// for the whole group.
+    pub local_addr: SocketAddr,
+    /// Sockets (and receive tasks) in the `SO_REUSEPORT` group. `0` means
+    /// one per available core. Forced to `1` except on Linux and FreeBSD,
+    /// the platforms whose kernels balance datagrams across the group.
+    pub socket_count: usize,
+    /// Per-session event ring capacity and per-socket receive sizing.
+    /// `recv_batch_size > 1` uses `recvmmsg` on Linux; `udp_offload` is
+    /// ignored here.
+    pub buffer_config: RtpTransportBufferConfig,
+}
+
+impl Default for SharedRtpSocketConfig {
+    fn default() -> Self {
+        Self {
+            local_addr: "0.0.0.0:0".parse().unwrap(),
+            socket_count: 0,
+            buffer_config: RtpTransportBufferConfig::default(),
+        }
+    }
+}
+
+/// ICE-lite short-term credentials for one session (RFC 8445 §5.3).
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct IceLiteCredentials {
+    /// Local `ice-ufrag`.
+    pub ufrag: String,
+    /// Local `ice-pwd`; keys `MESSAGE-INTEGRITY` both ways.
+    pub pwd: String,
+}
+
+/// Per-session registration on a [`SharedRtpSocket`].
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct DemuxSessionConfig {
+    /// Remote RTP address from SDP, if known.
+    pub remote_rtp_addr: Option<SocketAddr>,
+    /// Remote SSRCs declared in SDP (`a=ssrc`). Packets carrying them are
+    /// routed to this session from any source address.
+    pub remote_ssrcs: Vec<u32>,
+    /// Answer ICE connectivity checks for this session.
+    pub ice_credentials: Option<IceLiteCredentials>,
+    /// Enable symmetric RTP: each send updates the remote address.
+    pub symmetric_rtp: bool,
+}
+
+impl Default for DemuxSessionConfig {
+    fn default() -> Self {
+        Self {
+            remote_rtp_addr: None,
+            remote_ssrcs: Vec::new(),
+            ice_credentials: None,
+            symmetric_rtp: true,
+        }
+    }
+}
+
+/// Snapshot of a [`SharedRtpSocket`]'s routing state and counters.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct SharedRtpSocketStats {
+    /// Registered sessions
+    pub sessions: usize,
+    /// `(addr, ssrc)` and `(addr, *)` routes
+    pub routes: usize,
+    /// Datagrams received across all sockets
+    pub datagrams_received: u64,
+    /// Datagrams that matched no session
+    pub unroutable: u64,
+    /// STUN Binding Success Responses sent
+    pub stun_responses: u64,
+    /// STUN requests dropped for unknown ufrag or failed integrity
+    pub stun_rejected: u64,
+}
+
+/// One registered session's receive-side state.
+struct DemuxSession {
+    id: u64,
+    event_tx: broadcast::Sender<RtpEvent>,
+    receive: parking_lot::Mutex<RtpReceiveContext>,
+    srtp_send: Arc<parking_lot::Mutex<Option<crate::srtp::SrtpContext>>>,
+    srtp_recv: Arc<parking_lot::Mutex<Option<crate::srtp::SrtpContext>>>,
+    remote_rtp_addr: ArcSwapOption<SocketAddr>,
+    declared_ssrcs: Vec<u32>,
+    ice: Option<IceLiteCredentials>,
+    /// Every route indexed for this session; the lock also orders route
+    /// learning against unregistration.
+    routes: parking_lot::Mutex<Vec<RouteKey>>,
+    closed: AtomicBool,
+}
+
+#[derive(Default)]
+struct DemuxCounters {
+    datagrams_received: AtomicU64,
+    unroutable: AtomicU64,
+    stun_responses: AtomicU64,
+    stun_rejected: AtomicU64,
+}
+
+/// Sockets, indexes and counters shared by the receive tasks and every
+/// session handle.
+struct DemuxRouter {
+    sockets: Vec<Arc<UdpSocket>>,
+    local_addr: SocketAddr,
+    buffer_config: RtpTransportBufferConfig,
+    routes: DemuxIndex<RouteKey, Arc<DemuxSession>>,
+    ssrc_routes: DemuxIndex<u32, Arc<DemuxSession>>,
+    ice_routes: DemuxIndex<Box<[u8]>, Arc<DemuxSession>>,
+    /// RFC 4733 retransmit dedup; keyed on peer address so one map serves
+    /// every session (see `udp::DTMF_DEDUP_TTL`).
+    dtmf_seen: Arc<DashMap<(SocketAddr, u32, u32), Instant>>,
+    sessions: AtomicUsize,
+    next_id: AtomicU64,
+    active: AtomicBool,
+    counters: DemuxCounters,
+}
+
+impl DemuxRouter {
+    /// Index `key` for `session` unless it is closed, over its route
+    /// budget, or the key already routes to another live session. Returns
+    /// whether the route is (now) present.
+    fn add_route(&self, session: &Arc<DemuxSession>, key: RouteKey, always: bool) -> bool {
+        let mut routes = session.routes.lock();
+        if session.closed.load(Ordering::Acquire) {
+            return false;
+        }
+        if routes.contains(&key) {
+            return true;
+        }
+        if !always && routes.len() >= MAX_ROUTES_PER_SESSION {
+            return false;
+        }
+        // A closing owner is about to drop the key; anyone else keeps it,
+        // or its stream would silently move to this session.
+        let live_owner = |existing: &Arc<DemuxSession>| {
+            !Arc::ptr_eq(existing, session) && !existing.closed.load(Ordering::Acquire)
+        };
+        if let Some(owner) = self.routes.insert_unless(key, session.clone(), live_owner) {
+            // Configured addresses are worth a warning; learned ones are
+            // retried by every packet or check and only traced.
+            if always {
+                warn!(
+                    "Shared RTP socket: route {:?} belongs to session {}; not routing it to session {}",
+                    key, owner.id, session.id
+                );
+            } else {
+                trace!(
+                    "Shared RTP socket: route {:?} belongs to session {}; not learned by session {}",
+                    key, owner.id, session.id
+                );
+            }
+            return false;
+        }
+        routes.push(key);
+        true
+    }
+
+    fn unregister(&self, session: &Arc<DemuxSession>) {
+        let routes = {
+            let mut routes = session.routes.lock();
+            if session.closed.swap(true, Ordering::AcqRel) {
+                return;
+            }
+            std::mem::take(&mut *routes)
+        };
+        let owned = |candidate: &Arc<DemuxSession>| Arc::ptr_eq(candidate, session);
+        for key in &routes {
+            self.routes.remove_if(key, owned);
+        }
+        for ssrc in &session.declared_ssrcs {
+            self.ssrc_routes.remove_if(ssrc, owned);
+        }
+        if let Some(ice) = &session.ice {
+            self.ice_routes
+                .remove_if(&Box::from(ice.ufrag.as_bytes()), owned);
+        }
+        self.sessions.fetch_sub(1, Ordering::Relaxed);
+    }
+
+    /// Find the session for an RTP/RTCP datagram, learning `(addr, ssrc)`
+    /// on the first packet of a stream.
+    fn route(
+        &self,
+        data: &[u8],
+        addr: SocketAddr,
+        class: RtpMuxPacketClass,
+    ) -> Option<Arc<DemuxSession>> {
+        let ssrc = packet_ssrc(data, class);
+        if let Some(ssrc) = ssrc {
+            if let Some(session) = self.routes.get(&(addr, Some(ssrc))) {
+                return Some(session);
+            }
+        }
+
+        // A declared SSRC only vouches for its own stream: learning
+        // `(addr, *)` from it would hand the session every SSRC the source
+        // sends.
+        let session = match self.routes.get(&(addr, None)) {
+            Some(session) => session,
+            None => self.ssrc_routes.get(&ssrc?)?,
+        };
+        if let Some(ssrc) = ssrc {
+            self.add_route(&session, (addr, Some(ssrc)), false);
+        }
+        Some(session)
+    }
+
+    /// Deliver one inbound datagram: STUN is answered inline, everything
+    /// else goes to its session's receive context.
+    fn dispatch(&self, socket: &UdpSocket, data: &[u8], addr: SocketAddr, scratch: &mut Vec<u8>) {
+        self.counters
+            .datagrams_received
+            .fetch_add(1, Ordering::Relaxed);
+        let class = classify_rtp_mux_packet(data);
+        if class == RtpMuxPacketClass::Stun {
+            self.handle_stun(socket, data, addr, scratch);
+            return;
+        }
+        match self.route(data, addr, class) {
+            Some(session) => session.receive.lock().handle_datagram(data, addr, class),
+            None => {
+                self.counters.unroutable.fetch_add(1, Ordering::Relaxed);
+                trace!("Shared RTP socket: no session for {} ({:?})", addr, class);
+            }
+        }
+    }
+
+    /// ICE-lite Binding responder. Requests with `USERNAME` must match a
+    /// session's ufrag and pass `MESSAGE-INTEGRITY`; credential-less
+    /// requests (plain keepalives) are answered only for addresses already
+    /// routed to a session without ICE. Everything else is dropped.
+    fn handle_stun(
+        &self,
+        socket: &UdpSocket,
+        data: &[u8],
+        addr: SocketAddr,
+        scratch: &mut Vec<u8>,
+    ) {
+        let Ok(request) = decode_binding_request(data) else {
+            return;
+        };
+        let session = match request.local_ufrag() {
+            Some(ufrag) => self.ice_routes.get(ufrag).filter(|session| {
+                session
+                    .ice
+                    .as_ref()
+                    .is_some_and(|ice| request.verify_integrity(data, ice.pwd.as_bytes()))
+            }),
+            None => self
+                .routes
+                .get(&(addr, None))
+                .filter(|session| session.ice.is_none()),
+        };
+        let Some(session) = session else {
+            self.counters.stun_rejected.fetch_add(1, Ordering::Relaxed);
+            trace!("Shared RTP socket: rejected STUN request from {}", addr);
+            return;
+        };
+
+        self.add_route(&session, (addr, None), false);
+        // ICE-lite follows the controlling agent's nomination; until one
+        // arrives, the first valid check gives media somewhere to go.
+        if request.use_candidate || session.remote_rtp_addr.load().is_none() {
+            session.remote_rtp_addr.store(Some(Arc::new(addr)));
+        }
+
+        encode_binding_success(
+            &request.transaction_id,
+            addr,
+            session.ice.as_ref().map(|ice| ice.pwd.as_bytes()),
+            scratch,
+        );
+        // Never block the receive task on a response; the peer retransmits.
+        match socket.try_send_to(scratch, addr) {
+            Ok(_) => {
+                self.counters.stun_responses.fetch_add(1, Ordering::Relaxed);
+            }
+            Err(e) => trace!(
+                "Shared RTP socket: STUN response to {} dropped: {}",
+                addr,
+                e
+            ),
+        }
+    }
+}
+
+/// Sender SSRC of an RTP (bytes 8..12) or RTCP (bytes 4..8) datagram.
+fn packet_ssrc(data: &[u8], class: RtpMuxPacketClass) -> Option<u32> {
+    let offset = match class {
+        RtpMuxPacketClass::Rtp => 8,
+        RtpMuxPacketClass::Rtcp => 4,
+        _ => return None,
+    };
+    let bytes = data.get(offset..offset + 4)?;
+    Some(u32::from_be_bytes([bytes[0], bytes[1], bytes[2], bytes[3]]))
+}
+
+/// Whether the kernel spreads unicast datagrams across sockets sharing a
+/// port: `SO_REUSEPORT` on Linux, `SO_REUSEPORT_LB` on FreeBSD. macOS and
+/// the other BSDs accept `SO_REUSEPORT` but deliver to a single socket, so
+/// the group is one socket there.
+const REUSE_PORT_BALANCED: bool = cfg!(any(target_os = "linux", target_os = "freebsd"));
+
+fn bind_reuse_port(addr: SocketAddr, reuse_port: bool) -> io::Result<std::net::UdpSocket> {
+    let socket = Socket::new(Domain::for_address(addr), Type::DGRAM, Some(Protocol::UDP))?;
+    #[cfg(target_os = "linux")]
+    if reuse_port {
+        socket.set_reuse_port(true)?;
+    }
+    #[cfg(target_os = "freebsd")]
+    if reuse_port {
+        socket.set_reuse_port_lb(true)?;
+    }
+    #[cfg(not(any(target_os = "linux", target_os = "freebsd")))]
+    let _ = reuse_port;
+    socket.bind(&addr.into())?;
+    socket.set_nonblocking(true)?;
+    Ok(socket.into())
+}
+
+async fn run_receiver(router: Arc<DemuxRouter>, index: usize) {
+    let socket = router.sockets[index].clone();
+    let recv_buffer_size = router.buffer_config.recv_buffer_size;
+    let mut stun_scratch = Vec::with_capacity(128);
+    debug!(
+        "Shared RTP receive loop {} started on {}",
+        index, router.local_addr
+    );
+
+    #[cfg(target_os = "linux")]
+    if router.buffer_config.recv_batch_size > 1 {
+        use std::os::fd::AsRawFd;
+
+        let fd = socket.as_raw_fd();
+        let recv_batch_size = router.buffer_config.recv_batch_size;
+        while router.active.load(Ordering::Acquire) {
+            let received = match socket.readable().await {
+                Ok(()) => batch::with_thread_recv_batch(
+                    recv_batch_size,
+                    recv_buffer_size,
+                    false,
+                    |batch| -> std::io::Result<()> {
+                        socket.try_io(Interest::READABLE, || batch.recv(fd, recv_batch_size))?;
+                        for (data, addr) in batch.datagrams() {
+                            router.dispatch(&socket, data, addr, &mut stun_scratch);
+                        }
+                        Ok(())
+                    },
+                ),
+                Err(e) => Err(e),
+            };
+            match received {
+                Ok(()) => {}
+                Err(e) if e.kind() == std::io::ErrorKind::WouldBlock => {}
+                Err(e) => {
+                    warn!("Shared RTP socket receive error: {}", e);
+                    tokio::time::sleep(tokio::time::Duration::from_millis(10)).await;
+                }
+            }
+        }
+        return;
+    }
+
+    let mut buffer = vec![0u8; recv_buffer_size];
+    while router.active.load(Ordering::Acquire) {
+        match socket.recv_from(&mut buffer).await {
+            Ok((size, addr)) => router.dispatch(&socket, &buffer[..size], addr, &mut stun_scratch),
+            Err(e) => {
+                warn!("Shared RTP socket receive error: {}", e);
+                tokio::time::sleep(tokio::time::Duration::from_millis(10)).await;
+            }
+        }
+    }
+}
+
+/// Aborts the receive tasks once the last [`SharedRtpSocket`] handle (and
+/// with it the last session) is gone.
+struct ReceiverTasks(parking_lot::Mutex<Vec<JoinHandle<()>>>);
+
+impl Drop for ReceiverTasks {
+    fn drop(&mut self) {
+        for task in self.0.get_mut().drain(..) {
+            task.abort();
+        }
+    }
+}
+
+/// A group of `SO_REUSEPORT` UDP sockets on one port serving many RTP
+/// sessions. Cheap to clone; see the [module docs](self).
+#[derive(Clone)]
+pub struct SharedRtpSocket {
+    router: Arc<DemuxRouter>,
+    tasks: Arc<ReceiverTasks>,
+}
+
+impl std::fmt::Debug for SharedRtpSocket {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("SharedRtpSocket")
+            .field("local_addr", &self.router.local_addr)
+            .field("sockets", &self.router.sockets.len())
+            .field("sessions", &self.router.sessions.load(Ordering::Relaxed))
+            .finish()
+    }
+}
+
+impl SharedRtpSocket {
+    /// Bind the socket group and start one receive task per socket.
+    pub async fn new(config: SharedRtpSocketConfig) -> Result<Self> {
+        let socket_count = if !REUSE_PORT_BALANCED {
+            1
+        } else if config.socket_count == 0 {
+            std::thread::available_parallelism().map_or(1, |n| n.get())
+        } else {
+            config.socket_count
+        };
+        let reuse_port = socket_count > 1;
+
+        let bind_error =
+            |e: io::Error| Error::Transport(format!("Failed to bind shared RTP socket: {}", e));
+        let first = bind_reuse_port(config.local_addr, reuse_port).map_err(bind_error)?;
+        let local_addr = first.local_addr().map_err(bind_error)?;
+        let mut sockets = Vec::with_capacity(socket_count);
+        sockets.push(Arc::new(UdpSocket::from_std(first).map_err(bind_error)?));
+        for _ in 1..socket_count {
+            let socket = bind_reuse_port(local_addr, reuse_port).map_err(bind_error)?;
+            sockets.push(Arc::new(UdpSocket::from_std(socket).map_err(bind_error)?));
+        }
+
+        let router = Arc::new(DemuxRouter {
+            sockets,
+            local_addr,
+            buffer_config: config.buffer_config,
+            routes: DemuxIndex::new(),
+            ssrc_routes: DemuxIndex::new(),
+            ice_routes: DemuxIndex::new(),
+            dtmf_seen: Arc::new(DashMap::new()),
+            sessions: AtomicUsize::new(0),
+            next_id: AtomicU64::new(0),
+            active: AtomicBool::new(true),
+            counters: DemuxCounters::default(),
+        });
+        let tasks = (0..socket_count)
+            .map(|index| {
+                spawn_memory_tracked(
+                    "rtp_core.shared_rtp_socket.receiver_task",
+                    run_receiver(router.clone(), index),
+                )
+            })
+            .collect();
+
+        debug!(
+            "Bound shared RTP socket group on {} ({} sockets)",
+            local_addr, socket_count
+        );
+        Ok(Self {
+            router,
+            tasks: Arc::new(ReceiverTasks(parking_lot::Mutex::new(tasks))),
+        })
+    }
+
+    /// Local address shared by every session.
+    pub fn local_addr(&self) -> SocketAddr {
+        self.router.local_addr
+    }
+
+    /// Sockets (and receive tasks) in the group.
+    pub fn socket_count(&self) -> usize {
+        self.router.sockets.len()
+    }
+
+    /// Register a session. Its transport stays routed until it is closed
+    /// or dropped.
+    pub fn register_session(&self, config: DemuxSessionConfig) -> Result<DemuxedRtpTransport> {
+        let router = &self.router;
+        if !router.active.load(Ordering::Acquire) {
+            return Err(Error::Transport("Shared RTP socket is closed".to_string()));
+        }
+
+        let id = router.next_id.fetch_add(1, Ordering::Relaxed);
+        let (event_tx, _) = broadcast::channel(router.buffer_config.event_channel_capacity.max(1));
+        let srtp_recv = Arc::new(parking_lot::Mutex::new(None));
+        let session = Arc::new(DemuxSession {
+            id,
+            receive: parking_lot::Mutex::new(RtpReceiveContext::new(
+                event_tx.clone(),
+                srtp_recv.clone(),
+                router.dtmf_seen.clone(),
+                Some(router.local_addr),
+            )),
+            event_tx,
+            srtp_send: Arc::new(parking_lot::Mutex::new(None)),
+            srtp_recv,
+            remote_rtp_addr: ArcSwapOption::from(config.remote_rtp_addr.map(Arc::new)),
+            declared_ssrcs: config.remote_ssrcs,
+            ice: config.ice_credentials,
+            routes: parking_lot::Mutex::new(Vec::new()),
+            closed: AtomicBool::new(false),
+        });
+
+        // Claim the ufrag and declared SSRCs key by key, each as one RCU,
+        // so concurrent registrations cannot both pass a check and then
+        // overwrite each other; on conflict release what was claimed.
+        let owned = |candidate: &Arc<DemuxSession>| Arc::ptr_eq(candidate, &session);
+        if let Some(ice) = &session.ice {
+            if !router
+                .ice_routes
+                .try_insert(Box::from(ice.ufrag.as_bytes()), session.clone())
+            {
+                return Err(Error::Transport(format!(
+                    "ICE ufrag {:?} already registered on shared RTP socket",
+                    ice.ufrag
+                )));
+            }
+        }
+        for (claimed, &ssrc) in session.declared_ssrcs.iter().enumerate() {
+            if router.ssrc_routes.try_insert(ssrc, session.clone()) {
+                continue;
+            }
+            for released in &session.declared_ssrcs[..claimed] {
+                router.ssrc_routes.remove_if(released, owned);
+            }
+            if let Some(ice) = &session.ice {
+                router
+                    .ice_routes
+                    .remove_if(&Box::from(ice.ufrag.as_bytes()), owned);
+            }
+            return Err(Error::Transport(format!(
+                "Remote SSRC {:08x} already registered on shared RTP socket",
+                ssrc
+            )));
+        }
+
+        router.sessions.fetch_add(1, Ordering::Relaxed);
+        if let Some(addr) = config.remote_rtp_addr {
+            router.add_route(&session, (addr, None), true);
+            for &ssrc in &session.declared_ssrcs {
+                router.add_route(&session, (addr, Some(ssrc)), true);
+            }
+        }
+
+        Ok(DemuxedRtpTransport {
+            socket: router.sockets[id as usize % router.sockets.len()].clone(),
+            session,
+            shared: self.clone(),
+            symmetric_rtp: config.symmetric_rtp,
+        })
+    }
+
+    /// Resolve which session an inbound datagram from `source` would be
+    /// delivered to, without delivering it. Learns routes exactly like the
+    /// receive path. Returns the session id (see [`DemuxedRtpTransport::id`]).
+    pub fn route_datagram(&self, data: &[u8], source: SocketAddr) -> Option<u64> {
+        let class = classify_rtp_mux_packet(data);
+        if !class.is_media() {
+            return None;
+        }
+        self.router
+            .route(data, source, class)
+            .map(|session| session.id)
+    }
+
+    /// Routing-table sizes and counters.
+    pub fn stats(&self) -> SharedRtpSocketStats {
+        let router = &self.router;
+        SharedRtpSocketStats {
+            sessions: router.sessions.load(Ordering::Relaxed),
+            routes: router.routes.len(),
+            datagrams_received: router.counters.datagrams_received.load(Ordering::Relaxed),
+            unroutable: router.counters.unroutable.load(Ordering::Relaxed),
+            stun_responses: router.counters.stun_responses.load(Ordering::Relaxed),
+            stun_rejected: router.counters.stun_rejected.load(Ordering::Relaxed),
+        }
+    }
+
+    /// Stop every receive task. Registered sessions stop receiving; new
+    /// registrations fail.
+    pub async fn close(&self) {
+        self.router.active.store(false, Ordering::Release);
+        let tasks = std::mem::take(&mut *self.tasks.0.lock());
+        for task in tasks {
+            task.abort();
+            let _ = task.await;
+        }
+    }
+}
+
+/// One media session on a [`SharedRtpSocket`]. Implements [`RtpTransport`];
+/// closing or dropping it removes the session's routes.
+pub struct DemuxedRtpTransport {
+    session: Arc<DemuxSession>,
+    /// Socket this session sends from; any socket in the group carries the
+    /// shared local address.
+    socket: Arc<UdpSocket>,
+    shared: SharedRtpSocket,
+    symmetric_rtp: bool,
+}
+
+impl DemuxedRtpTransport {
+    /// Session id, unique within its [`SharedRtpSocket`].
+    pub fn id(&self) -> u64 {
+        self.session.id
+    }
+
+    /// Set the remote RTP address and route its traffic to this session.
+    pub async fn set_remote_rtp_addr(&self, addr: SocketAddr) {
+        self.update_remote(addr);
+    }
+
+    /// Get the remote RTP address
+    pub async fn remote_rtp_addr(&self) -> Option<SocketAddr> {
+        self.session.remote_rtp_addr.load().as_deref().copied()
+    }
+
+    /// Install per-direction SRTP contexts; same contract as
+    /// [`UdpRtpTransport::set_srtp_contexts`](super::UdpRtpTransport::set_srtp_contexts).
+    pub async fn set_srtp_contexts(
+        &self,
+        send: crate::srtp::SrtpContext,
+        recv: crate::srtp::SrtpContext,
+    ) {
+        *self.session.srtp_send.lock() = Some(send);
+        *self.session.srtp_recv.lock() = Some(recv);
+    }
+
+    /// Whether SRTP is currently configured on this session.
+    pub async fn srtp_enabled(&self) -> bool {
+        self.session.srtp_send.lock().is_some() || self.session.srtp_recv.lock().is_some()
+    }
+
+    /// Payload type of RFC 4733 `telephone-event`s received on this
+    /// session; same contract as
+    /// [`UdpRtpTransport::set_telephone_event_payload_type`](super::UdpRtpTransport::set_telephone_event_payload_type).
+    pub fn set_telephone_event_payload_type(&self, payload_type: u8) {
+        self.session
+            .receive
+            .lock()
+            .set_telephone_event_payload_type(payload_type);
+    }
+
+    fn update_remote(&self, addr: SocketAddr) {
+        if self.session.remote_rtp_addr.load().as_deref() != Some(&addr) {
+            self.session.remote_rtp_addr.store(Some(Arc::new(addr)));
+            self.shared
+                .router
+                .add_route(&self.session, (addr, None), true);
+        }
+    }
+}
+
+impl Drop for DemuxedRtpTransport {
+    fn drop(&mut self) {
+        self.shared.router.unregister(&self.session);
+    }
+}
+
+#[async_trait]
+impl RtpTransport for DemuxedRtpTransport {
+    fn local_rtp_addr(&self) -> Result<SocketAddr> {
+        Ok(self.shared.router.local_addr)
+    }
+
+    /// RTCP is always multiplexed on a shared socket.
+    fn local_rtcp_addr(&self) -> Result<Option<SocketAddr>> {
+        Ok(None)
+    }
+
+    async fn send_rtp(&self, packet: &RtpPacket, dest: SocketAddr) -> Result<()> {
+        let mut buffer;
+        {
+            let mut srtp_guard = self.session.srtp_send.lock();
+            let trailer_len = srtp_guard.as_ref().map_or(0, |ctx| ctx.rtp_trailer_len());
+            buffer = BytesMut::with_capacity(packet.size() + trailer_len);
+            packet.write_to(&mut buffer)?;
+            if let Some(ctx) = srtp_guard.as_mut() {
+                ctx.protect_in_place(&mut buffer)?;
+            }
+        }
+        self.send_rtp_bytes(&buffer, dest).await
+    }
+
+    async fn send_rtp_bytes(&self, bytes: &[u8], dest: SocketAddr) -> Result<()> {
+        if self.symmetric_rtp {
+            self.update_remote(dest);
+        }
+        self.socket
+            .send_to(bytes, dest)
+            .await
+            .map_err(|e| Error::Transport(format!("Failed to send RTP packet: {}", e)))?;
+        Ok(())
+    }
+
+    async fn send_rtcp(&self, packet: &RtcpPacket, dest: SocketAddr) -> Result<()> {
+        let data = packet.serialize()?;
+        self.send_rtcp_bytes(&data, dest).await
+    }
+
+    async fn send_rtcp_bytes(&self, bytes: &[u8], dest: SocketAddr) -> Result<()> {
+        self.socket
+            .send_to(bytes, dest)
+            .await
+            .map_err(|e| Error::Transport(format!("Failed to send RTCP packet: {}", e)))?;
+        Ok(())
+    }
+
+    async fn receive_packet(&self, _buffer: &mut [u8]) -> Result<(usize, SocketAddr)> {
+        Err(Error::NotImplemented(
+            "Shared-socket sessions deliver packets through subscribe()".to_string(),
+        ))
+    }
+
+    fn subscribe(&self) -> broadcast::Receiver<RtpEvent> {
+        self.session.event_tx.subscribe()
+    }
+
+    async fn install_srtp_contexts(
+        &self,
+        send: crate::srtp::SrtpContext,
+        recv: crate::srtp::SrtpContext,
+    ) -> Result<()> {
+        DemuxedRtpTransport::set_srtp_contexts(self, send, recv).await;
+        Ok(())
+    }
+
+    fn as_any(&self) -> &dyn std::any::Any {
+        self
+    }
+
+    async fn close(&self) -> Result<()> {
+        self.shared.router.unregister(&self.session);
+        Ok(())
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::packet::RtpHeader;
+    use bytes::Bytes;
+    use std::time::Duration;
+
+    fn rtp(ssrc: u32, seq: u16) -> Bytes {
+        RtpPacket::new(
+            RtpHeader::new(0, seq, 160, ssrc),
+            Bytes::from_static(b"payload"),
+        )
+        .serialize()
+        .unwrap()
+    }
+
+    async fn shared(socket_count: usize) -> SharedRtpSocket {
+        SharedRtpSocket::new(SharedRtpSocketConfig {
+            local_addr: "127.0.0.1:0".parse().unwrap(),
+            socket_count,
+            ..Default::default()
+        })
+        .await
+        .unwrap()
+    }
+
+    async fn expect_media(rx: &mut broadcast::Receiver<RtpEvent>, seq: u16) {
+        match tokio::time::timeout(Duration::from_millis(500), rx.recv()).await {
+            Ok(Ok(RtpEvent::MediaReceived {
+                sequence_number, ..
+            })) => assert_eq!(sequence_number, seq),
+            other => panic!("expected MediaReceived seq {}, got {:?}", seq, other),
+        }
+    }
+
+    #[tokio::test]
+    async fn demuxes_sessions_by_remote_address() {
+        let shared = shared(2).await;
+        let peer_a = UdpSocket::bind("127.0.0.1:0").await.unwrap();
+        let peer_b = UdpSocket::bind("127.0.0.1:0").await.unwrap();
+        let session_a = shared
+            .register_session(DemuxSessionConfig {
+                remote_rtp_addr: Some(peer_a.local_addr().unwrap()),
+                ..Default::default()
+            })
+            .unwrap();
+        let session_b = shared
+            .register_session(DemuxSessionConfig {
+                remote_rtp_addr: Some(peer_b.local_addr().unwrap()),
+                ..Default::default()
+            })
+            .unwrap();
+        let mut rx_a = session_a.subscribe();
+        let mut rx_b = session_b.subscribe();
+        assert_eq!(session_a.local_rtp_addr().unwrap(), shared.local_addr());
+
+        peer_a
+            .send_to(&rtp(0xaaaa, 1), shared.local_addr())
+            .await
+            .unwrap();
+        peer_b
+            .send_to(&rtp(0xbbbb, 2), shared.local_addr())
+            .await
+            .unwrap();
+        expect_media(&mut rx_a, 1).await;
+        expect_media(&mut rx_b, 2).await;
+        assert!(rx_a.try_recv().is_err());
+
+        // (addr, ssrc) learned on first packet, plus the (addr, *) routes.
+        assert_eq!(shared.stats().routes, 4);
+        drop(session_a);
+        assert_eq!(shared.stats().sessions, 1);
+        assert_eq!(shared.stats().routes, 2);
+
+        // Sending goes out from the shared port.
+        session_b
+            .send_rtp_bytes(&rtp(0x1234, 9), peer_b.local_addr().unwrap())
+            .await
+            .unwrap();
+        let mut buf = [0u8; 64];
+        let (_, from) = peer_b.recv_from(&mut buf).await.unwrap();
+        assert_eq!(from, shared.local_addr());
+    }
+
+    #[tokio::test]
+    async fn declared_ssrc_routes_from_unannounced_address_and_unknown_is_dropped() {
+        let shared = shared(1).await;
+        let session = shared
+            .register_session(DemuxSessionConfig {
+                remote_rtp_addr: Some("192.0.2.1:4000".parse().unwrap()),
+                remote_ssrcs: vec![0x5555],
+                ..Default::default()
+            })
+            .unwrap();
+        let natted = "198.51.100.7:61000".parse().unwrap();
+
+        assert_eq!(
+            shared.route_datagram(&rtp(0x5555, 1), natted),
+            Some(session.id())
+        );
+        assert_eq!(
+            shared.route_datagram(&rtp(0x6666, 1), "203.0.113.1:1".parse().unwrap()),
+            None
+        );
+        // Only the declared stream was learned for the unannounced source.
+        assert_eq!(shared.route_datagram(&rtp(0x6666, 2), natted), None);
+
+        // Declared SSRCs and ufrags are exclusive; a rejected registration
+        // releases whatever it had claimed.
+        assert!(shared
+            .register_session(DemuxSessionConfig {
+                remote_ssrcs: vec![0x7777, 0x5555],
+                ..Default::default()
+            })
+            .is_err());
+        assert_eq!(
+            shared.route_datagram(&rtp(0x7777, 1), "203.0.113.2:1".parse().unwrap()),
+            None
+        );
+        let ice = || IceLiteCredentials {
+            ufrag: "frag".to_string(),
+            pwd: "password".to_string(),
+        };
+        let owner = shared
+            .register_session(DemuxSessionConfig {
+                ice_credentials: Some(ice()),
+                ..Default::default()
+            })
+            .unwrap();
+        assert!(shared
+            .register_session(DemuxSessionConfig {
+                ice_credentials: Some(ice()),
+                ..Default::default()
+            })
+            .is_err());
+        drop(owner);
+        assert_eq!(shared.stats().sessions, 1);
+    }
+
+    #[tokio::test]
+    async fn live_sessions_keep_their_routes() {
+        let shared = shared(1).await;
+        let peer = "192.0.2.9:5000".parse().unwrap();
+        let first = shared
+            .register_session(DemuxSessionConfig {
+                remote_rtp_addr: Some(peer),
+                ..Default::default()
+            })
+            .unwrap();
+        let second = shared.register_session(DemuxSessionConfig::default()).unwrap();
+
+        // The second session cannot take the first one's address over.
+        second.set_remote_rtp_addr(peer).await;
+        assert_eq!(
+            shared.route_datagram(&rtp(0x1111, 1), peer),
+            Some(first.id())
+        );
+
+        // Once the owner is gone the address is free to claim.
+        drop(first);
+        second.update_remote("192.0.2.10:5000".parse().unwrap());
+        second.set_remote_rtp_addr(peer).await;
+        assert_eq!(
+            shared.route_datagram(&rtp(0x1111, 2), peer),
+            Some(second.id())
+        );
+    }
+
+    #[tokio::test]
+    async fn concurrent_registrations_claim_an_ssrc_once() {
+        let shared = shared(1).await;
+        let registered: Vec<_> = std::thread::scope(|scope| {
+            let workers: Vec<_> = (0..8)
+                .map(|_| {
+                    scope.spawn(|| {
+                        shared.register_session(DemuxSessionConfig {
+                            remote_ssrcs: vec![0x4242],
+                            ..Default::default()
+                        })
+                    })
+                })
+                .collect();
+            workers
+                .into_iter()
+                .filter_map(|worker| worker.join().unwrap().ok())
+                .collect()
+        });
+        assert_eq!(registered.len(), 1);
+        assert_eq!(
+            shared.route_datagram(&rtp(0x4242, 1), "203.0.113.3:1".parse().unwrap()),
+            Some(registered[0].id())
+        );
+    }
+
+    #[tokio::test]
+    async fn ice_lite_answers_checks_and_latches_remote() {
+        use hmac::{Hmac, Mac};
+        use sha1::Sha1;
+
+        let shared = shared(1).await;
+        let session = shared
+            .register_session(DemuxSessionConfig {
+                ice_credentials: Some(IceLiteCredentials {
+                    ufrag: "lfrag".to_string(),
+                    pwd: "local-password".to_string(),
+                }),
+                ..Default::default()
+            })
+            .unwrap();
+        let mut rx = session.subscribe();
+        let peer = UdpSocket::bind("127.0.0.1:0").await.unwrap();
+        let peer_addr = peer.local_addr().unwrap();
+
+        // USERNAME "lfrag:rfrag", USE-CANDIDATE, MESSAGE-INTEGRITY.
+        let txn = [7u8; 12];
+        let mut check = vec![0x00, 0x01, 0x00, 0x00, 0x21, 0x12, 0xa4, 0x42];
+        check.extend_from_slice(&txn);
+        check.extend_from_slice(&[0x00, 0x06, 0x00, 0x0b]);
+        check.extend_from_slice(b"lfrag:rfrag\0");
+        check.extend_from_slice(&[0x00, 0x25, 0x00, 0x00]);
+        let covered = (check.len() + 24 - 20) as u16;
+        check[2..4].copy_from_slice(&covered.to_be_bytes());
+        let mut mac = Hmac::<Sha1>::new_from_slice(b"local-password").unwrap();
+        mac.update(&check);
+        check.extend_from_slice(&[0x00, 0x08, 0x00, 0x14]);
+        check.extend_from_slice(&mac.finalize().into_bytes());
+
+        peer.send_to(&check, shared.local_addr()).await.unwrap();
+        let mut buf = [0u8; 256];
+        let (n, _) = tokio::time::timeout(Duration::from_millis(500), peer.recv_from(&mut buf))
+            .await
+            .unwrap()
+            .unwrap();
+        assert_eq!(
+            crate::network::stun::decode_binding_response(&buf[..n], &txn).unwrap(),
+            peer_addr
+        );
+        assert_eq!(session.remote_rtp_addr().await, Some(peer_addr));
+
+        // Media from the checked address now reaches the session.
+        peer.send_to(&rtp(0x7777, 3), shared.local_addr())
+            .await
+            .unwrap();
+        expect_media(&mut rx, 3).await;
+
+        // Wrong password: no response, counted as rejected.
+        let last = check.len() - 1;
+        check[last] ^= 0xff;
+        peer.send_to(&check, shared.local_addr()).await.unwrap();
+        tokio::time::sleep(Duration::from_millis(50)).await;
+        let stats = shared.stats();
+        assert_eq!((stats.stun_responses, stats.stun_rejected), (1, 1));
+    }
+}
@@ -0,0 +1,689 @@
+//! Receive-loop RTP forwarding for packet-level bridges
+//!
+//! A media bridge relays every RTP packet of one leg onto the other. Done
+//! through the session layer, each packet is broadcast to the session's
+//! receive task, broadcast again to a bridge forwarder task, rebuilt from
+//! its parsed header and queued to the outbound session's send task: three
+//! task hops, two broadcast rings that drop packets when a subscriber lags,
+//! and a header rebuild.
+//!
+//! An [`RtpForwarder`] installed on a [`UdpRtpTransport`](super::UdpRtpTransport)
+//! handles the packet in the receive loop that read it instead. The datagram
+//! is copied into the loop's reusable scratch buffer and unprotected with
+//! the inbound leg's SRTP context, if any. Its SSRC, sequence number and
+//! timestamp are then rewritten in place for the outbound leg
+//! ([`RtpTranslator`]), it is protected with the outbound leg's SRTP context
+//! and sent from the outbound leg's socket with a non-blocking `send_to`.
+//! Nothing is allocated and no other task is woken.
+//!
+//! On Linux a forwarder can additionally hand a flow to the kernel
+//! ([`RtpForwardGuard::offload`]): once both legs are plain RTP and a
+//! source's offsets are known, an XDP rule relays its packets before they
+//! reach the socket, and the receive loop only sees what the rule cannot
+//! handle.
+//!
+//! Forwarded packets bypass the inbound session entirely: no
+//! `PacketReceived` events, stream statistics or jitter buffering on that
+//! leg while the forwarder is installed. RTCP is never forwarded; each leg
+//! keeps its own control plane.
+
+use std::net::SocketAddr;
+#[cfg(target_os = "linux")]
+use std::sync::atomic::AtomicU8;
+use std::sync::atomic::{AtomicBool, AtomicU16, AtomicU64, Ordering};
+use std::sync::Arc;
+#[cfg(target_os = "linux")]
+use std::time::Duration;
+use std::time::Instant;
+
+use arc_swap::ArcSwapOption;
+use bytes::BytesMut;
+use tokio::net::UdpSocket;
+use tracing::{debug, trace};
+
+use super::udp::IoCounters;
+#[cfg(target_os = "linux")]
+use super::xdp::{XdpRelay, XdpRelayRule};
+use crate::srtp::SrtpContext;
+#[cfg(target_os = "linux")]
+use crate::{Error, Result};
+use crate::{RtpSequenceNumber, RtpSsrc, RtpTimestamp};
+
+/// Fixed RTP header length (RFC 3550 §5.1), up to and including the SSRC
+const RTP_FIXED_HEADER_LEN: usize = 12;
+
+/// Rewrites the identity of forwarded RTP packets for the outbound leg
+///
+/// The SSRC becomes the outbound session's. Sequence numbers are shifted
+/// by a fixed offset, chosen when a source starts so that it continues
+/// the outbound session's sequence counter; gaps and reordering on the
+/// inbound leg therefore stay visible to the far end, and forwarded
+/// packets and packets the outbound session sends itself share one
+/// sequence space. Timestamps are carried over unchanged until the
+/// inbound SSRC changes (a re-INVITE, a transfer); from then on they are
+/// offset so the outbound stream keeps advancing by the wall-clock time
+/// between the two sources. Fixed offsets per source are also what lets
+/// the kernel relay take over a flow (see `xdp`).
+#[derive(Debug, Clone)]
+pub struct RtpTranslator {
+    ssrc: RtpSsrc,
+    clock_rate: u32,
+    source_ssrc: Option<RtpSsrc>,
+    sequence_offset: RtpSequenceNumber,
+    timestamp_offset: RtpTimestamp,
+    last_timestamp: RtpTimestamp,
+    last_forwarded_at: Option<Instant>,
+}
+
+impl RtpTranslator {
+    /// Translator writing `ssrc` into every packet; `clock_rate` is the
+    /// RTP clock of the bridged payload type
+    pub fn new(ssrc: RtpSsrc, clock_rate: u32) -> Self {
+        Self {
+            ssrc,
+            clock_rate,
+            source_ssrc: None,
+            sequence_offset: 0,
+            timestamp_offset: 0,
+            last_timestamp: 0,
+            last_forwarded_at: None,
+        }
+    }
+
+    /// Whether `packet` starts with a version 2 RTP header
+    pub fn is_rewritable(packet: &[u8]) -> bool {
+        packet.len() >= RTP_FIXED_HEADER_LEN && packet[0] >> 6 == 2
+    }
+
+    /// Rewrite the sequence number, timestamp and SSRC of `packet` in
+    /// place and return the sequence number written. A new source's first
+    /// packet is numbered `next_sequence`. CSRCs, extensions and payload
+    /// are left untouched. Returns `None`, without modifying it, if
+    /// `packet` is not RTP.
+    pub fn rewrite(
+        &mut self,
+        packet: &mut [u8],
+        next_sequence: RtpSequenceNumber,
+        now: Instant,
+    ) -> Option<RtpSequenceNumber> {
+        if !Self::is_rewritable(packet) {
+            return None;
+        }
+
+        let source_ssrc = u32::from_be_bytes([packet[8], packet[9], packet[10], packet[11]]);
+        let sequence = u16::from_be_bytes([packet[2], packet[3]]);
+        let timestamp = u32::from_be_bytes([packet[4], packet[5], packet[6], packet[7]]);
+        if self.source_ssrc != Some(source_ssrc) {
+            if let (Some(_), Some(last)) = (self.source_ssrc, self.last_forwarded_at) {
+                let elapsed_ticks = (now.duration_since(last).as_micros()
+                    * u128::from(self.clock_rate)
+                    / 1_000_000) as u32;
+                self.timestamp_offset = self
+                    .last_timestamp
+                    .wrapping_add(elapsed_ticks.max(1))
+                    .wrapping_sub(timestamp);
+            }
+            self.sequence_offset = next_sequence.wrapping_sub(sequence);
+            self.source_ssrc = Some(source_ssrc);
+        }
+
+        let sequence = sequence.wrapping_add(self.sequence_offset);
+        let timestamp = timestamp.wrapping_add(self.timestamp_offset);
+        packet[2..4].copy_from_slice(&sequence.to_be_bytes());
+        packet[4..8].copy_from_slice(&timestamp.to_be_bytes());
+        packet[8..12].copy_from_slice(&self.ssrc.to_be_bytes());
+        self.last_timestamp = timestamp;
+        self.last_forwarded_at = Some(now);
+        Some(sequence)
+    }
+
+    /// Current source and the sequence and timestamp offsets applied to it
+    pub fn offsets(&self) -> Option<(RtpSsrc, RtpSequenceNumber, RtpTimestamp)> {
+        self.source_ssrc
+            .map(|source| (source, self.sequence_offset, self.timestamp_offset))
+    }
+
+    /// Packets of the current source were forwarded elsewhere (the kernel
+    /// relay), the last one stamped `last_timestamp` at about `at`; a
+    /// later source change continues from there.
+    pub fn resume(&mut self, last_timestamp: RtpTimestamp, at: Instant) {
+        self.last_timestamp = last_timestamp;
+        self.last_forwarded_at = Some(at);
+    }
+}
+
+/// Move `counter` past `sent` unless it already is, in RFC 3550
+/// sequence-number order
+fn advance_sequence(counter: &AtomicU16, sent: RtpSequenceNumber) {
+    let next = sent.wrapping_add(1);
+    let _ = counter.fetch_update(Ordering::Relaxed, Ordering::Relaxed, |current| {
+        ((next.wrapping_sub(current) as i16) > 0).then_some(next)
+    });
+}
+
+/// Outbound leg of a forwarder: the socket, destination, SRTP context and
+/// RTP identity packets are re-sent with
+///
+/// Issued by [`RtpSession::forward_target`](crate::RtpSession::forward_target).
+#[derive(Clone)]
+pub struct RtpForwardTarget {
+    pub(super) socket: Arc<UdpSocket>,
+    pub(super) remote_addr: Arc<ArcSwapOption<SocketAddr>>,
+    pub(super) srtp_send: Arc<parking_lot::Mutex<Option<SrtpContext>>>,
+    pub(super) active: Arc<AtomicBool>,
+    pub(super) io_counters: Arc<IoCounters>,
+    pub(crate) ssrc: RtpSsrc,
+    pub(crate) sequence: Arc<AtomicU16>,
+    pub(crate) clock_rate: u32,
+}
+
+/// Packets a forwarder has relayed and dropped
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct RtpForwardStats {
+    /// Packets sent on the outbound leg
+    pub forwarded: u64,
+    /// Packets dropped: not RTP, SRTP failure, no destination yet, the
+    /// outbound leg closed, or its socket buffer full
+    pub dropped: u64,
+    /// Packets the kernel relay forwarded without waking the receive loop
+    pub offloaded: u64,
+    /// Bytes of those packets, Ethernet header included
+    pub offloaded_bytes: u64,
+}
+
+/// How often an offloaded forwarder checks that its kernel rule still
+/// describes the flow (outbound address, SRTP, leg state, telephone-event
+/// payload type)
+#[cfg(target_os = "linux")]
+const OFFLOAD_REVALIDATE_INTERVAL: Duration = Duration::from_millis(250);
+
+/// Delay before retrying a rule the kernel relay refused
+#[cfg(target_os = "linux")]
+const OFFLOAD_RETRY_INTERVAL: Duration = Duration::from_secs(1);
+
+/// Kernel relay state of an offloaded forwarder
+#[cfg(target_os = "linux")]
+struct Offload {
+    relay: Arc<XdpRelay>,
+    /// Local RTP address of the inbound leg: the rule's key
+    ingress: SocketAddr,
+    /// Local RTP address of the outbound leg
+    egress: SocketAddr,
+    /// Inbound leg's SRTP context; protected media is never offloaded
+    srtp_recv: Arc<parking_lot::Mutex<Option<SrtpContext>>>,
+    /// Inbound leg's negotiated `telephone-event` payload type, which the
+    /// rule leaves to the receive loop so DTMF is still reported
+    telephone_event_pt: Arc<AtomicU8>,
+    /// Rule currently in the kernel
+    installed: Option<XdpRelayRule>,
+    retry_at: Option<Instant>,
+    /// Counters of rules already withdrawn
+    packets: u64,
+    bytes: u64,
+}
+
+/// Forwards RTP received on one transport out of another, from inside the
+/// receive loop
+pub struct RtpForwarder {
+    target: RtpForwardTarget,
+    translator: parking_lot::Mutex<RtpTranslator>,
+    forwarded: AtomicU64,
+    dropped: AtomicU64,
+    /// Set once [`RtpForwardGuard::offload`] ran; keeps the `offload` lock
+    /// off the path of forwarders that never offload
+    #[cfg(target_os = "linux")]
+    offloading: AtomicBool,
+    #[cfg(target_os = "linux")]
+    offload: parking_lot::Mutex<Option<Offload>>,
+}
+
+impl RtpForwarder {
+    /// Forwarder sending to `target`
+    pub fn new(target: RtpForwardTarget) -> Self {
+        let translator = RtpTranslator::new(target.ssrc, target.clock_rate);
+        Self {
+            target,
+            translator: parking_lot::Mutex::new(translator),
+            forwarded: AtomicU64::new(0),
+            dropped: AtomicU64::new(0),
+            #[cfg(target_os = "linux")]
+            offloading: AtomicBool::new(false),
+            #[cfg(target_os = "linux")]
+            offload: parking_lot::Mutex::new(None),
+        }
+    }
+
+    /// Packets relayed and dropped so far. For an offloaded forwarder this
+    /// reads the kernel rule's counters.
+    pub fn stats(&self) -> RtpForwardStats {
+        #[allow(unused_mut)]
+        let mut stats = RtpForwardStats {
+            forwarded: self.forwarded.load(Ordering::Relaxed),
+            dropped: self.dropped.load(Ordering::Relaxed),
+            ..Default::default()
+        };
+        #[cfg(target_os = "linux")]
+        if self.offloading.load(Ordering::Acquire) {
+            if let Some(state) = self.offload.lock().as_ref() {
+                stats.offloaded = state.packets;
+                stats.offloaded_bytes = state.bytes;
+                if state.installed.is_some() {
+                    if let Ok(Some(counters)) = state.relay.counters(state.ingress) {
+                        stats.offloaded += counters.packets;
+                        stats.offloaded_bytes += counters.bytes;
+                    }
+                }
+            }
+        }
+        stats
+    }
+
+    pub(super) fn count_drop(&self) {
+        self.dropped.fetch_add(1, Ordering::Relaxed);
+    }
+
+    /// Rewrite, protect and send one plain RTP packet held in `packet`.
+    /// `packet` is scratch storage owned by the receive loop; it is left
+    /// holding the datagram as sent. `inbound_protected` says whether it
+    /// arrived as SRTP.
+    pub(super) fn forward(&self, packet: &mut BytesMut, inbound_protected: bool) {
+        let target = &self.target;
+        if !target.active.load(Ordering::Acquire) || !RtpTranslator::is_rewritable(packet) {
+            self.dropped.fetch_add(1, Ordering::Relaxed);
+            return;
+        }
+        let Some(dest) = target.remote_addr.load().as_deref().copied() else {
+            self.dropped.fetch_add(1, Ordering::Relaxed);
+            return;
+        };
+
+        let now = Instant::now();
+        #[cfg(target_os = "linux")]
+        let offloading = self.offloading.load(Ordering::Acquire);
+        #[cfg(target_os = "linux")]
+        if offloading {
+            // A packet of another source than the kernel rule's: take the
+            // flow back so the new source continues where the kernel left.
+            let source_ssrc = u32::from_be_bytes([packet[8], packet[9], packet[10], packet[11]]);
+            if let Some(state) = self.offload.lock().as_mut() {
+                if state
+                    .installed
+                    .is_some_and(|rule| rule.source_ssrc != source_ssrc)
+                {
+                    self.withdraw(state, now);
+                }
+            }
+        }
+
+        let next_sequence = target.sequence.load(Ordering::Relaxed);
+        let mut translator = self.translator.lock();
+        let Some(sequence) = translator.rewrite(packet, next_sequence, now) else {
+            self.dropped.fetch_add(1, Ordering::Relaxed);
+            return;
+        };
+        #[cfg(target_os = "linux")]
+        let offsets = translator.offsets();
+        drop(translator);
+        advance_sequence(&target.sequence, sequence);
+
+        let mut outbound_protected = false;
+        if let Some(ctx) = target.srtp_send.lock().as_mut() {
+            outbound_protected = true;
+            packet.reserve(ctx.rtp_trailer_len());
+            if let Err(e) = ctx.protect_in_place(packet) {
+                debug!("Forwarded RTP SRTP protect failed: {}", e);
+                self.dropped.fetch_add(1, Ordering::Relaxed);
+                return;
+            }
+        }
+
+        // A plain non-blocking `sendto` on the fd rather than
+        // `try_send_to`: tokio's readiness gate would report `WouldBlock`
+        // until the reactor has seen the socket writable once, and a miss
+        // here would clear the readiness the leg's own send task relies on.
+        let sock = socket2::SockRef::from(target.socket.as_ref());
+        match sock.send_to(packet, &dest.into()) {
+            Ok(_) => {
+                self.forwarded.fetch_add(1, Ordering::Relaxed);
+                target
+                    .io_counters
+                    .send_syscalls
+                    .fetch_add(1, Ordering::Relaxed);
+                target
+                    .io_counters
+                    .datagrams_sent
+                    .fetch_add(1, Ordering::Relaxed);
+            }
+            Err(e) => {
+                // Real-time media: a full socket buffer drops the packet
+                // rather than stalling the inbound leg's receive loop.
+                trace!("Forwarded RTP send to {} failed: {}", dest, e);
+                self.dropped.fetch_add(1, Ordering::Relaxed);
+                return;
+            }
+        }
+
+        #[cfg(target_os = "linux")]
+        if offloading && !inbound_protected && !outbound_protected {
+            if let Some(offsets) = offsets {
+                self.promote(dest, offsets, now);
+            }
+        }
+        #[cfg(not(target_os = "linux"))]
+        let _ = (inbound_protected, outbound_protected);
+    }
+
+    /// Hand the flow to the kernel relay, unless the installed rule already
+    /// describes it
+    #[cfg(target_os = "linux")]
+    fn promote(
+        &self,
+        destination: SocketAddr,
+        (source_ssrc, sequence_offset, timestamp_offset): (
+            RtpSsrc,
+            RtpSequenceNumber,
+            RtpTimestamp,
+        ),
+        now: Instant,
+    ) {
+        let mut offload = self.offload.lock();
+        let Some(state) = offload.as_mut() else {
+            return;
+        };
+        if !destination.is_ipv4() || state.retry_at.is_some_and(|at| now < at) {
+            return;
+        }
+        let rule = XdpRelayRule {
+            ingress: state.ingress,
+            source_ssrc,
+            egress: state.egress,
+            destination,
+            ssrc: self.target.ssrc,
+            sequence_offset,
+            timestamp_offset,
+            // The receive loop reports telephone-events while relaying them.
+            passed_payload_type: Some(state.telephone_event_pt.load(Ordering::Relaxed)),
+        };
+        if state.installed == Some(rule) {
+            // Rule in place; the kernel passed this packet up because the
+            // next hop is not resolved yet.
+            return;
+        }
+        if state.srtp_recv.lock().is_some() {
+            return;
+        }
+        if state.installed.is_some() {
+            self.withdraw(state, now);
+        }
+        match state.relay.insert(&rule) {
+            Ok(()) => {
+                debug!(
+                    "RTP forwarding {} -> {} offloaded to the kernel relay",
+                    state.ingress, destination
+                );
+                state.installed = Some(rule);
+                state.retry_at = None;
+            }
+            Err(e) => {
+                debug!(
+                    "Kernel relay refused {} -> {}: {}",
+                    state.ingress, destination, e
+                );
+                state.retry_at = Some(now + OFFLOAD_RETRY_INTERVAL);
+            }
+        }
+    }
+
+    /// Take the flow back from the kernel relay, carrying its sequence
+    /// and timestamp position over to the translator
+    #[cfg(target_os = "linux")]
+    fn withdraw(&self, state: &mut Offload, now: Instant) {
+        if state.installed.take().is_none() {
+            return;
+        }
+        match state.relay.remove(state.ingress) {
+            Ok(Some(counters)) if counters.packets > 0 => {
+                state.packets += counters.packets;
+                state.bytes += counters.bytes;
+                advance_sequence(&self.target.sequence, counters.last_sequence);
+                self.translator.lock().resume(counters.last_timestamp, now);
+            }
+            Ok(_) => {}
+            Err(e) => debug!("Kernel relay rule for {} not removed: {}", state.ingress, e),
+        }
+    }
+
+    /// Withdraw the kernel rule if the flow it describes changed under it:
+    /// the kernel never sees the outbound leg's address or SRTP state.
+    #[cfg(target_os = "linux")]
+    fn revalidate_offload(&self) {
+        let mut offload = self.offload.lock();
+        let Some(state) = offload.as_mut() else {
+            return;
+        };
+        let Some(rule) = state.installed else {
+            return;
+        };
+        let target = &self.target;
+        let stale = target.remote_addr.load().as_deref() != Some(&rule.destination)
+            || !target.active.load(Ordering::Acquire)
+            || target.srtp_send.lock().is_some()
+            || state.srtp_recv.lock().is_some()
+            || rule.passed_payload_type != Some(state.telephone_event_pt.load(Ordering::Relaxed));
+        if stale {
+            self.withdraw(state, Instant::now());
+        }
+    }
+
+    #[cfg(target_os = "linux")]
+    fn stop_offload(&self) {
+        if let Some(mut state) = self.offload.lock().take() {
+            self.withdraw(&mut state, Instant::now());
+        }
+        self.offloading.store(false, Ordering::Release);
+    }
+}
+
+/// Keeps a forwarder installed on a transport; uninstalls it on drop
+pub struct RtpForwardGuard {
+    pub(super) slot: Arc<ArcSwapOption<RtpForwarder>>,
+    pub(super) forwarder: Arc<RtpForwarder>,
+    /// Local RTP address, inbound SRTP context and `telephone-event`
+    /// payload type of the transport the forwarder is installed on
+    #[cfg(target_os = "linux")]
+    pub(super) ingress: (
+        Option<SocketAddr>,
+        Arc<parking_lot::Mutex<Option<SrtpContext>>>,
+        Arc<AtomicU8>,
+    ),
+    #[cfg(target_os = "linux")]
+    pub(super) revalidate: Option<tokio::task::JoinHandle<()>>,
+}
+
+impl RtpForwardGuard {
+    /// Packets relayed and dropped so far
+    pub fn stats(&self) -> RtpForwardStats {
+        self.forwarder.stats()
+    }
+
+    /// The installed forwarder, for reading its statistics after the
+    /// guard has been handed off
+    pub fn forwarder(&self) -> Arc<RtpForwarder> {
+        self.forwarder.clone()
+    }
+
+    /// Let `relay` forward this flow in the kernel whenever it can: both
+    /// legs plain RTP over IPv4, one source at a time. The forwarder
+    /// installs a rule once it has seen a source's first packet and takes
+    /// the flow back when the source, the outbound address or either
+    /// leg's SRTP state changes, or when the guard drops. `relay` must be
+    /// attached to the interface the inbound leg receives on.
+    ///
+    /// Must be called within a Tokio runtime: a task re-checks the rule
+    /// against the outbound leg every 250 ms.
+    #[cfg(target_os = "linux")]
+    pub fn offload(&mut self, relay: Arc<XdpRelay>) -> Result<()> {
+        let (ingress, srtp_recv, telephone_event_pt) = self.ingress.clone();
+        let ingress = ingress
+            .ok_or_else(|| Error::Transport("Inbound leg has no local address".to_string()))?;
+        let egress = self
+            .forwarder
+            .target
+            .socket
+            .local_addr()
+            .map_err(|e| Error::Transport(format!("Outbound leg address: {}", e)))?;
+        if !ingress.is_ipv4() || !egress.is_ipv4() {
+            return Err(Error::UnsupportedFeature(
+                "Kernel relay offload needs IPv4 legs".to_string(),
+            ));
+        }
+
+        self.forwarder.stop_offload();
+        *self.forwarder.offload.lock() = Some(Offload {
+            relay,
+            ingress,
+            egress,
+            srtp_recv,
+            telephone_event_pt,
+            installed: None,
+            retry_at: None,
+            packets: 0,
+            bytes: 0,
+        });
+        self.forwarder.offloading.store(true, Ordering::Release);
+
+        if self.revalidate.is_none() {
+            let forwarder = Arc::downgrade(&self.forwarder);
+            self.revalidate = Some(tokio::spawn(async move {
+                let mut tick = tokio::time::interval(OFFLOAD_REVALIDATE_INTERVAL);
+                tick.set_missed_tick_behavior(tokio::time::MissedTickBehavior::Delay);
+                loop {
+                    tick.tick().await;
+                    let Some(forwarder) = forwarder.upgrade() else {
+                        break;
+                    };
+                    forwarder.revalidate_offload();
+                }
+            }));
+        }
+        Ok(())
+    }
+}
+
+impl Drop for RtpForwardGuard {
+    fn drop(&mut self) {
+        // Only clear the slot if a later install hasn't replaced us.
+        let current = self.slot.load();
+        if current
+            .as_ref()
+            .is_some_and(|installed| Arc::ptr_eq(installed, &self.forwarder))
+        {
+            self.slot.compare_and_swap(&*current, None);
+        }
+
+        #[cfg(target_os = "linux")]
+        {
+            if let Some(task) = self.revalidate.take() {
+                task.abort();
+            }
+            self.forwarder.stop_offload();
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::packet::{RtpHeader, RtpPacket};
+    use bytes::Bytes;
+    use std::time::Duration;
+
+    fn wire(ssrc: RtpSsrc, sequence: u16, timestamp: u32) -> BytesMut {
+        let mut header = RtpHeader::new(0, sequence, timestamp, ssrc);
+        header.marker = true;
+        let packet = RtpPacket::new(header, Bytes::from_static(&[0xd5; 160]));
+        BytesMut::from(&packet.serialize().unwrap()[..])
+    }
+
+    #[test]
+    fn rewrite_replaces_identity_and_keeps_the_rest() {
+        let mut translator = RtpTranslator::new(0x1111_2222, 8000);
+        let mut packet = wire(0xaaaa_bbbb, 7, 16_000);
+        assert_eq!(
+            translator.rewrite(&mut packet, 500, Instant::now()),
+            Some(500)
+        );
+
+        let parsed = RtpPacket::parse(&packet).unwrap();
+        assert_eq!(parsed.header.ssrc, 0x1111_2222);
+        assert_eq!(parsed.header.sequence_number, 500);
+        assert_eq!(parsed.header.timestamp, 16_000);
+        assert!(parsed.header.marker);
+        assert_eq!(&parsed.payload[..], &[0xd5; 160][..]);
+    }
+
+    #[test]
+    fn source_change_keeps_timestamps_advancing() {
+        let mut translator = RtpTranslator::new(1, 8000);
+        let start = Instant::now();
+        let mut first = wire(0xaaaa, 1, 1_000_000);
+        translator.rewrite(&mut first, 1, start);
+
+        // New source with an unrelated timestamp base, 20 ms later.
+        let mut second = wire(0xbbbb, 9, 42);
+        translator.rewrite(&mut second, 2, start + Duration::from_millis(20));
+        let timestamp = RtpPacket::parse(&second).unwrap().header.timestamp;
+        assert_eq!(timestamp, 1_000_000 + 160);
+
+        // Later packets of the new source keep the same offsets.
+        let mut third = wire(0xbbbb, 10, 42 + 160);
+        let sequence = translator.rewrite(&mut third, 3, start + Duration::from_millis(40));
+        assert_eq!(sequence, Some(3));
+        let timestamp = RtpPacket::parse(&third).unwrap().header.timestamp;
+        assert_eq!(timestamp, 1_000_000 + 320);
+        assert_eq!(
+            translator.offsets(),
+            Some((0xbbbb, 3u16.wrapping_sub(10), 1_000_000 + 160 - 42))
+        );
+    }
+
+    #[test]
+    fn inbound_gaps_and_reordering_survive_the_rewrite() {
+        let mut translator = RtpTranslator::new(1, 8000);
+        let now = Instant::now();
+        let sequences: Vec<_> = [100u16, 101, 104, 103, 105]
+            .into_iter()
+            .map(|seq| {
+                translator
+                    .rewrite(&mut wire(0xaaaa, seq, 0), 7, now)
+                    .unwrap()
+            })
+            .collect();
+        assert_eq!(sequences, [7, 8, 11, 10, 12]);
+    }
+
+    #[test]
+    fn sequence_counter_only_moves_forward() {
+        let counter = AtomicU16::new(10);
+        advance_sequence(&counter, 12);
+        assert_eq!(counter.load(Ordering::Relaxed), 13);
+        advance_sequence(&counter, 11);
+        assert_eq!(counter.load(Ordering::Relaxed), 13);
+        counter.store(65_535, Ordering::Relaxed);
+        advance_sequence(&counter, 65_535);
+        assert_eq!(counter.load(Ordering::Relaxed), 0);
+    }
+
+    #[test]
+    fn non_rtp_is_left_alone() {
+        let mut translator = RtpTranslator::new(1, 8000);
+        let mut stun = [0x00u8, 0x01, 0x00, 0x00, 0x21, 0x12, 0xa4, 0x42, 0, 0, 0, 0];
+        let original = stun;
+        assert_eq!(translator.rewrite(&mut stun, 1, Instant::now()), None);
+        assert_eq!(stun, original);
+        assert_eq!(
+            translator.rewrite(&mut [0x80, 0x00], 1, Instant::now()),
+            None
+        );
+    }
+}
@@ -23,6 +23,14 @@ pub struct RtpTransportBufferConfig {
     pub recv_buffer_size: usize,
     /// UDP RTCP receive buffer size in bytes when RTCP uses a separate socket.
     pub rtcp_recv_buffer_size: usize,
+    /// Datagrams drained per receive syscall on the RTP socket. `1` keeps
+    /// the per-datagram `recv_from` loop; larger values use `recvmmsg(2)`
+    /// on Linux (capped at 1024) and are ignored on other platforms.
+    pub recv_batch_size: usize,
+    /// Enable Linux UDP segmentation offloads on the RTP socket: GSO for
+    /// `UdpRtpTransport::send_rtp_bytes_batch`, and GRO when
+    /// `recv_batch_size > 1`. Ignored when the kernel lacks support.
+    pub udp_offload: bool,
 }
 
 impl Default for RtpTransportBufferConfig {
@@ -31,6 +39,8 @@ impl Default for RtpTransportBufferConfig {
             event_channel_capacity: RTP_TRANSPORT_EVENT_CHANNEL_CAPACITY,
             recv_buffer_size: crate::DEFAULT_MAX_PACKET_SIZE,
             rtcp_recv_buffer_size: crate::DEFAULT_MAX_PACKET_SIZE,
+            recv_batch_size: 1,
+            udp_offload: false,
         }
     }
 }
@@ -66,6 +76,20 @@ pub trait RtpTransport: Send + Sync {
     /// This allows receiving both RTP and RTCP packets as events
     fn subscribe(&self) -> broadcast::Receiver<RtpEvent>;
 
+    /// Install per-direction SRTP contexts, replacing any installed pair.
+    ///
+    /// Transports that carry SRTP override this; the default reports that
+    /// the transport cannot.
+    async fn install_srtp_contexts(
+        &self,
+        _send: crate::srtp::SrtpContext,
+        _recv: crate::srtp::SrtpContext,
+    ) -> Result<()> {
+        Err(crate::Error::NotImplemented(
+            "SRTP is not supported by this transport".to_string(),
+        ))
+    }
+
     /// Get a reference to this object as Any
     fn as_any(&self) -> &dyn std::any::Any;
 
@@ -127,20 +151,35 @@ pub enum PortPairingStrategy {
 
 // Re-export submodules
 mod allocator;
+#[cfg(target_os = "linux")]
+mod batch;
+mod demux;
+mod forward;
 pub mod security_transport;
 mod tcp;
 mod udp;
 mod validation;
+#[cfg(target_os = "linux")]
+pub mod xdp;
 
 // Re-export transport implementations
 pub use allocator::{
     AllocationStrategy, GlobalPortAllocator, PairingStrategy, PortAllocator, PortAllocatorConfig,
     DEFAULT_RTP_PORT_RANGE_END, DEFAULT_RTP_PORT_RANGE_START, MIN_PORT,
 };
+pub use demux::{
+    DemuxSessionConfig, DemuxedRtpTransport, IceLiteCredentials, SharedRtpSocket,
+    SharedRtpSocketConfig, SharedRtpSocketStats,
+};
+pub use forward::{
+    RtpForwardGuard, RtpForwardStats, RtpForwardTarget, RtpForwarder, RtpTranslator,
+};
 pub use security_transport::SecurityRtpTransport;
 pub use tcp::TcpRtpTransport;
-pub use udp::{set_diagnostics as set_udp_diagnostics, UdpRtpTransport};
+pub use udp::{set_diagnostics as set_udp_diagnostics, UdpRtpTransport, UdpTransportIoStats};
 pub use validation::{PlatformSocketStrategy, PlatformType, RtpSocketValidator};
+#[cfg(target_os = "linux")]
+pub use xdp::{XdpAttachMode, XdpRelay, XdpRelayRule, XdpRuleCounters};
 
 #[cfg(test)]
 mod tests {
@@ -162,5 +201,7 @@ mod tests {
             config.buffer_config.rtcp_recv_buffer_size,
             crate::DEFAULT_MAX_PACKET_SIZE
         );
+        assert_eq!(config.buffer_config.recv_batch_size, 1);
+        assert!(!config.buffer_config.udp_offload);
     }
 }
@@ -4,7 +4,7 @@
 
 use std::fmt::Write as _;
 use std::net::SocketAddr;
-use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::atomic::{AtomicBool, AtomicU16, AtomicU64, AtomicU8, Ordering};
 use std::sync::Arc;
 use std::time::{Duration, Instant};
 
@@ -12,6 +12,8 @@ use arc_swap::ArcSwapOption;
 use async_trait::async_trait;
 use bytes::{Bytes, BytesMut};
 use dashmap::DashMap;
+#[cfg(target_os = "linux")]
+use tokio::io::Interest;
 use tokio::net::UdpSocket;
 use tokio::sync::{broadcast, Mutex};
 use tokio::task::JoinHandle;
@@ -35,7 +37,7 @@ static SRTP_DIAGNOSTICS_ENABLED: AtomicBool = AtomicBool::new(false);
 static RTP_DIAGNOSTICS_ENABLED: AtomicBool = AtomicBool::new(false);
 
 #[cfg(feature = "memory-diagnostics")]
-fn spawn_memory_tracked<F>(kind: &'static str, future: F) -> JoinHandle<F::Output>
+pub(super) fn spawn_memory_tracked<F>(kind: &'static str, future: F) -> JoinHandle<F::Output>
 where
     F: std::future::Future + Send + 'static,
     F::Output: Send + 'static,
@@ -44,7 +46,7 @@ where
 }
 
 #[cfg(not(feature = "memory-diagnostics"))]
-fn spawn_memory_tracked<F>(_: &'static str, future: F) -> JoinHandle<F::Output>
+pub(super) fn spawn_memory_tracked<F>(_: &'static str, future: F) -> JoinHandle<F::Output>
 where
     F: std::future::Future + Send + 'static,
     F::Output: Send + 'static,
@@ -53,7 +55,7 @@ where
 }
 
 #[derive(Clone, Copy, Debug, Eq, PartialEq)]
-enum RtpMuxPacketClass {
+pub(super) enum RtpMuxPacketClass {
     Rtp,
     Rtcp,
     Stun,
@@ -78,7 +80,7 @@ impl RtpMuxPacketClass {
         }
     }
 
-    fn is_media(self) -> bool {
+    pub(super) fn is_media(self) -> bool {
         matches!(self, Self::Rtp | Self::Rtcp)
     }
 }
@@ -96,7 +98,7 @@ fn rtp_diagnostics_enabled() -> bool {
     RTP_DIAGNOSTICS_ENABLED.load(Ordering::Relaxed)
 }
 
-fn classify_rtp_mux_packet(buffer: &[u8]) -> RtpMuxPacketClass {
+pub(super) fn classify_rtp_mux_packet(buffer: &[u8]) -> RtpMuxPacketClass {
     if buffer.len() < 2 {
         return RtpMuxPacketClass::TooSmall;
     }
@@ -223,13 +225,371 @@ fn log_malformed_rtp_packet(
 }
 
 use super::allocator::{GlobalPortAllocator, PairingStrategy};
+#[cfg(target_os = "linux")]
+use super::batch;
+use super::forward::{RtpForwardGuard, RtpForwardTarget, RtpForwarder};
 use super::validation::PlatformSocketStrategy;
 use super::{RtpTransport, RtpTransportConfig};
 use crate::error::Error;
 use crate::packet::rtcp::RtcpPacket;
-use crate::packet::RtpPacket;
+use crate::packet::{RtpHeader, RtpPacket};
 use crate::traits::RtpEvent;
-use crate::Result;
+use crate::{Result, RtpSsrc};
+
+/// State owned by the RTP receive task and shared by the per-datagram and
+/// batched receive loops: where events go, SRTP/DTMF state, and the drop
+/// counters that rate-limit diagnostics.
+pub(super) struct RtpReceiveContext {
+    event_tx: broadcast::Sender<RtpEvent>,
+    srtp_recv: Arc<parking_lot::Mutex<Option<crate::srtp::SrtpContext>>>,
+    dtmf_seen: Arc<DashMap<(SocketAddr, u32, u32), Instant>>,
+    srtp_diagnostics: bool,
+    rtp_diagnostics: bool,
+    local_rtp_addr: Option<SocketAddr>,
+    first_inbound_rtp_logged: bool,
+    srtp_unprotect_failures: u64,
+    non_rtp_drop_count: u64,
+    malformed_rtp_drop_count: u64,
+    /// Scratch buffer SRTP packets are unprotected in. It keeps its
+    /// storage across packets; only the plain payload handed to
+    /// subscribers is copied out of it.
+    srtp_buf: BytesMut,
+    /// Bridge forwarder slot; when one is installed, RTP media is relayed
+    /// from here instead of being published as events.
+    forward: Option<Arc<ArcSwapOption<RtpForwarder>>>,
+    /// Negotiated `telephone-event` payload type, decoded into
+    /// [`RtpEvent::DtmfEvent`]s rather than published as media
+    telephone_event_pt: Arc<AtomicU8>,
+}
+
+impl RtpReceiveContext {
+    pub(super) fn new(
+        event_tx: broadcast::Sender<RtpEvent>,
+        srtp_recv: Arc<parking_lot::Mutex<Option<crate::srtp::SrtpContext>>>,
+        dtmf_seen: Arc<DashMap<(SocketAddr, u32, u32), Instant>>,
+        local_rtp_addr: Option<SocketAddr>,
+    ) -> Self {
+        Self {
+            event_tx,
+            srtp_recv,
+            dtmf_seen,
+            srtp_diagnostics: srtp_diagnostics_enabled(),
+            rtp_diagnostics: rtp_diagnostics_enabled(),
+            local_rtp_addr,
+            first_inbound_rtp_logged: false,
+            srtp_unprotect_failures: 0,
+            non_rtp_drop_count: 0,
+            malformed_rtp_drop_count: 0,
+            srtp_buf: BytesMut::new(),
+            forward: None,
+            telephone_event_pt: Arc::new(AtomicU8::new(
+                crate::DEFAULT_TELEPHONE_EVENT_PAYLOAD_TYPE,
+            )),
+        }
+    }
+
+    /// Check `slot` for an installed [`RtpForwarder`] on every RTP packet.
+    pub(super) fn with_forward_slot(mut self, slot: Arc<ArcSwapOption<RtpForwarder>>) -> Self {
+        self.forward = Some(slot);
+        self
+    }
+
+    /// Read the `telephone-event` payload type from `slot`, which the
+    /// owning transport updates when SDP negotiates one.
+    pub(super) fn with_telephone_event_slot(mut self, slot: Arc<AtomicU8>) -> Self {
+        self.telephone_event_pt = slot;
+        self
+    }
+
+    /// Set the `telephone-event` payload type for subsequent packets.
+    pub(super) fn set_telephone_event_payload_type(&self, payload_type: u8) {
+        self.telephone_event_pt
+            .store(payload_type, Ordering::Relaxed);
+    }
+
+    /// Emit a `DtmfEvent` for the first 4 bytes of an RFC 4733
+    /// `telephone-event` payload, suppressing end-of-event retransmits.
+    fn publish_dtmf(&mut self, addr: SocketAddr, ssrc: u32, timestamp: u32, p: &[u8]) {
+        let event = p[0];
+        let byte1 = p[1];
+        let end_of_event = (byte1 & 0b1000_0000) != 0;
+        let volume = byte1 & 0b0011_1111;
+        let duration = u16::from_be_bytes([p[2], p[3]]);
+
+        // RFC 4733 §2.5.1.3 retransmit dedup. The sender emits up to
+        // three identical E=1 frames sharing `(ssrc, rtp_timestamp)`.
+        // Keyed by `(peer_addr, ssrc, ts)` so two simultaneous DTMF
+        // streams from different peers fire independently. Inline
+        // retain prunes stale entries on every fire — at one PT 101
+        // frame per ~20 ms per active tone, this stays bounded.
+        if end_of_event {
+            let key = (addr, ssrc, timestamp);
+            let now = Instant::now();
+            self.dtmf_seen
+                .retain(|_, seen_at| now.duration_since(*seen_at) < DTMF_DEDUP_TTL);
+            if self.dtmf_seen.insert(key, now).is_some() {
+                return; // retransmit — suppress
+            }
+        }
+
+        let dtmf = RtpEvent::DtmfEvent {
+            event,
+            end_of_event,
+            volume,
+            duration,
+            timestamp,
+            source: addr,
+            ssrc,
+        };
+        if self.event_tx.receiver_count() > 0 {
+            if let Err(e) = self.event_tx.send(dtmf) {
+                warn!("Failed to send DTMF event: {}", e);
+            }
+        } else {
+            let _ = self.event_tx.send(dtmf);
+        }
+    }
+
+    /// Relay one RTP datagram through `forwarder`: unprotect into the
+    /// scratch buffer, then rewrite, protect and send it in place. The
+    /// buffer keeps its storage, so the relay allocates nothing.
+    fn forward_datagram(&mut self, forwarder: &RtpForwarder, data: &[u8], addr: SocketAddr) {
+        self.srtp_buf.clear();
+        self.srtp_buf.extend_from_slice(data);
+        let mut protected = false;
+        if let Some(ctx) = self.srtp_recv.lock().as_mut() {
+            protected = true;
+            if ctx.unprotect_in_place(&mut self.srtp_buf).is_err() {
+                self.srtp_unprotect_failures += 1;
+                forwarder.count_drop();
+                trace!("SRTP unprotect failed; dropping forwarded packet");
+                return;
+            }
+        }
+
+        // Telephone-events are relayed like any other packet, and still
+        // reported on this leg so DTMF detection keeps working while
+        // bridged.
+        let buf = &self.srtp_buf;
+        let telephone_event_pt = self.telephone_event_pt.load(Ordering::Relaxed);
+        if buf.len() > 1 && buf[1] & 0x7f == telephone_event_pt {
+            if let Ok(offset) = RtpHeader::wire_size(buf) {
+                if buf.len() >= offset + 4 {
+                    let timestamp = u32::from_be_bytes([buf[4], buf[5], buf[6], buf[7]]);
+                    let ssrc = u32::from_be_bytes([buf[8], buf[9], buf[10], buf[11]]);
+                    let payload = [
+                        buf[offset],
+                        buf[offset + 1],
+                        buf[offset + 2],
+                        buf[offset + 3],
+                    ];
+                    self.publish_dtmf(addr, ssrc, timestamp, &payload);
+                }
+            }
+        }
+
+        forwarder.forward(&mut self.srtp_buf, protected);
+    }
+
+    /// Dispatch one inbound datagram already classified by
+    /// [`classify_rtp_mux_packet`].
+    pub(super) fn handle_datagram(
+        &mut self,
+        data: &[u8],
+        addr: SocketAddr,
+        packet_class: RtpMuxPacketClass,
+    ) {
+        let size = data.len();
+        if !packet_class.is_media() {
+            self.non_rtp_drop_count = self.non_rtp_drop_count.saturating_add(1);
+            log_dropped_non_rtp_packet(
+                self.rtp_diagnostics,
+                self.non_rtp_drop_count,
+                self.local_rtp_addr,
+                addr,
+                size,
+                packet_class,
+                data,
+            );
+            return;
+        }
+
+        // Check if it's RTCP according to RFC 5761
+        if packet_class == RtpMuxPacketClass::Rtcp {
+            debug!("Received RTCP packet, type: {}", data[1] & 0x7F);
+            let rtcp_data = Bytes::copy_from_slice(data);
+            let event = RtpEvent::RtcpReceived {
+                data: rtcp_data,
+                source: addr,
+            };
+
+            // Only log errors if there are receivers
+            if self.event_tx.receiver_count() > 0 {
+                if let Err(e) = self.event_tx.send(event) {
+                    warn!("Failed to send RTCP event: {}", e);
+                }
+            } else {
+                // Still send the event but ignore errors if no one is listening
+                let _ = self.event_tx.send(event);
+            }
+        } else {
+            if let Some(forwarder) = self.forward.as_ref().and_then(|slot| slot.load_full()) {
+                self.forward_datagram(&forwarder, data, addr);
+                return;
+            }
+
+            // SRTP unprotect (RFC 3711 §3.4) when an
+            // inbound SrtpContext is configured. Auth
+            // failures MUST be silently dropped — no
+            // event, no warn-level log — to avoid
+            // leaking timing or distinguishing failure
+            // modes to a network attacker.
+            let mut srtp_guard = self.srtp_recv.lock();
+            if self.srtp_diagnostics && !self.first_inbound_rtp_logged {
+                info!(
+                    "SRTP_DIAG inbound_rtp_first local={:?} source={} size={} srtp_context={}",
+                    self.local_rtp_addr,
+                    addr,
+                    size,
+                    srtp_guard.is_some()
+                );
+                self.first_inbound_rtp_logged = true;
+            }
+            let parse_result: Result<RtpPacket> = if let Some(ctx) = srtp_guard.as_mut() {
+                self.srtp_buf.clear();
+                self.srtp_buf.extend_from_slice(data);
+                match ctx.unprotect_in_place(&mut self.srtp_buf) {
+                    Ok(()) => RtpPacket::parse(&self.srtp_buf),
+                    Err(_) => {
+                        self.srtp_unprotect_failures += 1;
+                        if self.srtp_diagnostics
+                            && (self.srtp_unprotect_failures <= 5
+                                || self.srtp_unprotect_failures % 50 == 0)
+                        {
+                            info!(
+                                "SRTP_DIAG unprotect_failed local={:?} source={} size={} failures={}",
+                                self.local_rtp_addr,
+                                addr,
+                                size,
+                                self.srtp_unprotect_failures
+                            );
+                        }
+                        trace!("SRTP unprotect failed; dropping packet");
+                        drop(srtp_guard);
+                        return;
+                    }
+                }
+            } else {
+                RtpPacket::parse(data)
+            };
+            drop(srtp_guard);
+            match parse_result {
+                Ok(packet) => {
+                    // Log packet reception at transport level (debug only)
+                    debug!(
+                        "Transport received packet with SSRC={:08x}, seq={}, ts={}",
+                        packet.header.ssrc, packet.header.sequence_number, packet.header.timestamp
+                    );
+
+                    // Debug: Log SSRC demultiplexing info
+                    debug!("SSRC demultiplexing: Forwarding packet with SSRC={:08x}, seq={}, payload size={} bytes",
+                       packet.header.ssrc, packet.header.sequence_number, packet.payload.len());
+
+                    // RFC 4733: the negotiated `telephone-event` PT (101
+                    // by default) carries DTMF tones as RTP events rather
+                    // than audio samples. Decode the 4-byte body inline and emit a
+                    // typed `DtmfEvent` instead of a generic
+                    // `MediaReceived`, so the media layer doesn't have
+                    // to re-parse and doesn't try to feed the bytes to
+                    // a PCMU/PCMA/Opus decoder. Oversized payloads are
+                    // tolerated per RFC 4733's forward-compat clause
+                    // (read only first 4 bytes).
+                    if packet.header.payload_type == self.telephone_event_pt.load(Ordering::Relaxed)
+                        && packet.payload.len() >= 4
+                    {
+                        self.publish_dtmf(
+                            addr,
+                            packet.header.ssrc,
+                            packet.header.timestamp,
+                            &packet.payload[..4],
+                        );
+                        return;
+                    }
+
+                    // Create RTP event
+                    let event = RtpEvent::MediaReceived {
+                        payload_type: packet.header.payload_type,
+                        sequence_number: packet.header.sequence_number,
+                        timestamp: packet.header.timestamp,
+                        marker: packet.header.marker,
+                        payload: packet.payload.clone(), // Use the parsed payload
+                        source: addr,
+                        ssrc: packet.header.ssrc, // Include the SSRC from the parsed packet
+                    };
+
+                    // Only log errors if there are receivers
+                    if self.event_tx.receiver_count() > 0 {
+                        if let Err(e) = self.event_tx.send(event) {
+                            warn!("Failed to send RTP event: {}", e);
+                        }
+                    } else {
+                        // Still send the event but ignore errors if no one is listening
+                        let _ = self.event_tx.send(event);
+                    }
+                }
+                Err(e) => {
+                    self.malformed_rtp_drop_count = self.malformed_rtp_drop_count.saturating_add(1);
+                    log_malformed_rtp_packet(
+                        self.rtp_diagnostics,
+                        self.malformed_rtp_drop_count,
+                        self.local_rtp_addr,
+                        addr,
+                        size,
+                        &e,
+                        Some(data),
+                    );
+                }
+            }
+        }
+    }
+
+    /// Surface a socket receive error to subscribers.
+    pub(super) fn report_socket_error(&self, e: &std::io::Error) {
+        error!("Error receiving packet: {}", e);
+
+        // Send error event
+        let err_event = RtpEvent::Error(Error::Transport(format!("Socket error: {}", e)));
+        if self.event_tx.receiver_count() > 0 {
+            let _ = self.event_tx.send(err_event);
+        }
+    }
+}
+
+/// Socket-level I/O counters behind [`UdpRtpTransport::io_stats`].
+#[derive(Debug, Default)]
+pub(super) struct IoCounters {
+    recv_syscalls: AtomicU64,
+    datagrams_received: AtomicU64,
+    pub(super) send_syscalls: AtomicU64,
+    pub(super) datagrams_sent: AtomicU64,
+}
+
+/// Snapshot of RTP-socket receive/send calls and the datagrams they moved.
+///
+/// Only calls that transferred data are counted, so
+/// `recv_syscalls / datagrams_received` is the syscalls-per-packet figure
+/// the per-datagram (`1.0`) and batched (`< 1.0`) paths can be compared on.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct UdpTransportIoStats {
+    /// `recv_from`/`recvmmsg` calls that returned data
+    pub recv_syscalls: u64,
+    /// Datagrams received (GRO super-datagrams count once per segment)
+    pub datagrams_received: u64,
+    /// `send_to`/`sendmmsg`/GSO `sendmsg` calls that sent data
+    pub send_syscalls: u64,
+    /// Datagrams sent
+    pub datagrams_sent: u64,
+}
 
 /// UDP transport for RTP/RTCP
 ///
@@ -301,6 +661,31 @@ pub struct UdpRtpTransport {
     /// peers must each fire independently.
     dtmf_seen: Arc<DashMap<(SocketAddr, u32, u32), Instant>>,
 
+    /// Receive/send syscall and datagram counters, see [`Self::io_stats`].
+    io_counters: Arc<IoCounters>,
+
+    /// Bridge forwarder the receive loop relays RTP media through, see
+    /// [`Self::install_forwarder`]. Loaded once per RTP datagram.
+    forward: Arc<ArcSwapOption<RtpForwarder>>,
+
+    /// Negotiated RFC 4733 `telephone-event` payload type, read by the
+    /// receive loop and by kernel relay rules installed for this leg.
+    telephone_event_pt: Arc<AtomicU8>,
+
+    /// Reusable `sendmmsg` header/iovec arrays for
+    /// [`Self::send_rtp_bytes_batch`]. CPU-only, never held across `.await`.
+    #[cfg(target_os = "linux")]
+    send_batch: parking_lot::Mutex<batch::SendBatch>,
+
+    /// UDP GSO is requested and the kernel accepted `UDP_SEGMENT`. Cleared
+    /// at runtime if the egress device later rejects a segmented send.
+    #[cfg(target_os = "linux")]
+    udp_gso: AtomicBool,
+
+    /// `UDP_GRO` was enabled on the RTP socket for the batched receiver.
+    #[cfg(target_os = "linux")]
+    udp_gro: bool,
+
     #[cfg(feature = "memory-diagnostics")]
     _memory_guard: rvoip_infra_common::memory_diagnostics::ObjectGuard,
     #[cfg(feature = "memory-diagnostics")]
@@ -422,6 +807,26 @@ impl UdpRtpTransport {
         // Create broadcaster
         let (event_tx, _) = broadcast::channel(buffer_config.event_channel_capacity.max(1));
 
+        // Opt-in Linux UDP offloads: GSO for batched sends, GRO only when the
+        // batched receiver is there to split coalesced datagrams again.
+        #[cfg(target_os = "linux")]
+        let (udp_gso, udp_gro) = {
+            use std::os::fd::AsRawFd;
+
+            let fd = socket_rtp.as_raw_fd();
+            let gso = buffer_config.udp_offload && batch::gso_supported(fd);
+            let gro = buffer_config.udp_offload
+                && buffer_config.recv_batch_size > 1
+                && match batch::enable_gro(fd) {
+                    Ok(()) => true,
+                    Err(e) => {
+                        debug!("UDP_GRO unavailable on RTP socket: {}", e);
+                        false
+                    }
+                };
+            (gso, gro)
+        };
+
         let transport = Self {
             rtp_socket: Arc::new(socket_rtp),
             rtcp_socket: socket_rtcp.map(Arc::new),
@@ -434,6 +839,15 @@ impl UdpRtpTransport {
             srtp_send: Arc::new(parking_lot::Mutex::new(None)),
             srtp_recv: Arc::new(parking_lot::Mutex::new(None)),
             dtmf_seen: Arc::new(DashMap::new()),
+            io_counters: Arc::new(IoCounters::default()),
+            forward: Arc::new(ArcSwapOption::from(None)),
+            telephone_event_pt: Arc::new(AtomicU8::new(crate::DEFAULT_TELEPHONE_EVENT_PAYLOAD_TYPE)),
+            #[cfg(target_os = "linux")]
+            send_batch: parking_lot::Mutex::new(batch::SendBatch::default()),
+            #[cfg(target_os = "linux")]
+            udp_gso: AtomicBool::new(udp_gso),
+            #[cfg(target_os = "linux")]
+            udp_gro,
             #[cfg(feature = "memory-diagnostics")]
             _memory_guard: rvoip_infra_common::memory_diagnostics::ObjectGuard::new(
                 "rtp_core.udp_transport",
@@ -467,247 +881,111 @@ impl UdpRtpTransport {
 
         // Start RTP receiver
         let rtp_socket = self.rtp_socket.clone();
-        let event_tx = self.event_tx.clone();
         let active_state = self.active.clone();
-        let srtp_recv = self.srtp_recv.clone();
-        let dtmf_seen = self.dtmf_seen.clone();
-        let srtp_diagnostics = srtp_diagnostics_enabled();
-        let rtp_diagnostics = rtp_diagnostics_enabled();
-        let local_rtp_addr = rtp_socket.local_addr().ok();
+        let io_counters = self.io_counters.clone();
         let recv_buffer_size = self.config.buffer_config.recv_buffer_size;
+        #[cfg(target_os = "linux")]
+        let (recv_batch_size, udp_gro) = (self.config.buffer_config.recv_batch_size, self.udp_gro);
+        let mut receive = RtpReceiveContext::new(
+            self.event_tx.clone(),
+            self.srtp_recv.clone(),
+            self.dtmf_seen.clone(),
+            rtp_socket.local_addr().ok(),
+        )
+        .with_forward_slot(self.forward.clone())
+        .with_telephone_event_slot(self.telephone_event_pt.clone());
 
-        let rtp_receiver = spawn_memory_tracked(
-            "rtp_core.udp_transport.rtp_receiver_task",
-            async move {
-                let mut first_inbound_rtp_logged = false;
-                let mut srtp_unprotect_failures = 0_u64;
-                let mut non_rtp_drop_count = 0_u64;
-                let mut malformed_rtp_drop_count = 0_u64;
+        let rtp_receiver =
+            spawn_memory_tracked("rtp_core.udp_transport.rtp_receiver_task", async move {
                 debug!("UDP receive loop started on {:?}", rtp_socket.local_addr());
 
+                // Linux batched path: one recvmmsg drains up to
+                // `recv_batch_size` datagrams per wakeup into this thread's
+                // shared receive slab; the whole batch is classified before
+                // any of it is dispatched, all without awaiting in between.
+                #[cfg(target_os = "linux")]
+                if recv_batch_size > 1 {
+                    use std::os::fd::AsRawFd;
+
+                    let fd = rtp_socket.as_raw_fd();
+                    let mut classes = Vec::with_capacity(recv_batch_size.min(batch::MAX_BATCH));
+
+                    while active_state.load(Ordering::Acquire) {
+                        let received = match rtp_socket.readable().await {
+                            Ok(()) => batch::with_thread_recv_batch(
+                                recv_batch_size,
+                                recv_buffer_size,
+                                udp_gro,
+                                |batch| -> std::io::Result<()> {
+                                    rtp_socket.try_io(Interest::READABLE, || {
+                                        batch.recv(fd, recv_batch_size)
+                                    })?;
+                                    classes.clear();
+                                    classes.extend(
+                                        batch
+                                            .datagrams()
+                                            .map(|(data, _)| classify_rtp_mux_packet(data)),
+                                    );
+                                    io_counters.recv_syscalls.fetch_add(1, Ordering::Relaxed);
+                                    io_counters
+                                        .datagrams_received
+                                        .fetch_add(classes.len() as u64, Ordering::Relaxed);
+                                    trace!("UDP recvmmsg returned {} datagrams", classes.len());
+
+                                    for ((data, addr), &class) in batch.datagrams().zip(&classes)
+                                    {
+                                        receive.handle_datagram(data, addr, class);
+                                    }
+                                    Ok(())
+                                },
+                            ),
+                            Err(e) => Err(e),
+                        };
+                        match received {
+                            Ok(()) => {}
+                            Err(e) if e.kind() == std::io::ErrorKind::WouldBlock => {}
+                            Err(e) => {
+                                receive.report_socket_error(&e);
+
+                                // Short delay before retrying
+                                tokio::time::sleep(tokio::time::Duration::from_millis(10)).await;
+                            }
+                        }
+                    }
+                    return;
+                }
+
+                // Every consumer copies out of the datagram (parse, unprotect,
+                // RTCP `copy_from_slice`), so one buffer serves the whole loop.
+                let mut buffer = vec![0u8; recv_buffer_size];
+
                 loop {
                     // Check if we should continue running
                     if !active_state.load(Ordering::Acquire) {
                         break;
                     }
 
-                    let mut buffer = vec![0u8; recv_buffer_size];
-
                     // Receive packet
                     match rtp_socket.recv_from(&mut buffer).await {
                         Ok((size, addr)) => {
                             info!("🔵 UDP recv_from returned {} bytes from {}", size, addr);
+                            io_counters.recv_syscalls.fetch_add(1, Ordering::Relaxed);
+                            io_counters
+                                .datagrams_received
+                                .fetch_add(1, Ordering::Relaxed);
 
-                            let packet_class = classify_rtp_mux_packet(&buffer[..size]);
-                            if !packet_class.is_media() {
-                                non_rtp_drop_count = non_rtp_drop_count.saturating_add(1);
-                                log_dropped_non_rtp_packet(
-                                    rtp_diagnostics,
-                                    non_rtp_drop_count,
-                                    local_rtp_addr,
-                                    addr,
-                                    size,
-                                    packet_class,
-                                    &buffer[..size],
-                                );
-                                continue;
-                            }
-
-                            // Check if it's RTCP according to RFC 5761
-                            if packet_class == RtpMuxPacketClass::Rtcp {
-                                debug!("Received RTCP packet, type: {}", buffer[1] & 0x7F);
-                                let rtcp_data = Bytes::copy_from_slice(&buffer[..size]);
-                                let event = RtpEvent::RtcpReceived {
-                                    data: rtcp_data,
-                                    source: addr,
-                                };
-
-                                // Only log errors if there are receivers
-                                if event_tx.receiver_count() > 0 {
-                                    if let Err(e) = event_tx.send(event) {
-                                        warn!("Failed to send RTCP event: {}", e);
-                                    }
-                                } else {
-                                    // Still send the event but ignore errors if no one is listening
-                                    let _ = event_tx.send(event);
-                                }
-                            } else {
-                                // SRTP unprotect (RFC 3711 §3.4) when an
-                                // inbound SrtpContext is configured. Auth
-                                // failures MUST be silently dropped — no
-                                // event, no warn-level log — to avoid
-                                // leaking timing or distinguishing failure
-                                // modes to a network attacker.
-                                let mut srtp_guard = srtp_recv.lock();
-                                if srtp_diagnostics && !first_inbound_rtp_logged {
-                                    info!(
-                                    "SRTP_DIAG inbound_rtp_first local={:?} source={} size={} srtp_context={}",
-                                    local_rtp_addr,
-                                    addr,
-                                    size,
-                                    srtp_guard.is_some()
-                                );
-                                    first_inbound_rtp_logged = true;
-                                }
-                                let parse_result: Result<RtpPacket> = if let Some(ctx) =
-                                    srtp_guard.as_mut()
-                                {
-                                    match ctx.unprotect(&buffer[0..size]) {
-                                        Ok(packet) => Ok(packet),
-                                        Err(_) => {
-                                            srtp_unprotect_failures += 1;
-                                            if srtp_diagnostics
-                                                && (srtp_unprotect_failures <= 5
-                                                    || srtp_unprotect_failures % 50 == 0)
-                                            {
-                                                info!(
-                                                    "SRTP_DIAG unprotect_failed local={:?} source={} size={} failures={}",
-                                                    local_rtp_addr,
-                                                    addr,
-                                                    size,
-                                                    srtp_unprotect_failures
-                                                );
-                                            }
-                                            trace!("SRTP unprotect failed; dropping packet");
-                                            drop(srtp_guard);
-                                            continue;
-                                        }
-                                    }
-                                } else {
-                                    RtpPacket::parse(&buffer[..size])
-                                };
-                                drop(srtp_guard);
-                                match parse_result {
-                                    Ok(packet) => {
-                                        // Log packet reception at transport level (debug only)
-                                        debug!(
-                                        "Transport received packet with SSRC={:08x}, seq={}, ts={}",
-                                        packet.header.ssrc,
-                                        packet.header.sequence_number,
-                                        packet.header.timestamp
-                                    );
-
-                                        // Debug: Log SSRC demultiplexing info
-                                        debug!("SSRC demultiplexing: Forwarding packet with SSRC={:08x}, seq={}, payload size={} bytes",
-                                           packet.header.ssrc, packet.header.sequence_number, packet.payload.len());
-
-                                        // RFC 4733: PT 101 (by default) is `telephone-event` —
-                                        // DTMF tones carried as RTP events rather than audio
-                                        // samples. Decode the 4-byte body inline and emit a
-                                        // typed `DtmfEvent` instead of a generic
-                                        // `MediaReceived`, so the media layer doesn't have
-                                        // to re-parse and doesn't try to feed the bytes to
-                                        // a PCMU/PCMA/Opus decoder. Oversized payloads are
-                                        // tolerated per RFC 4733's forward-compat clause
-                                        // (read only first 4 bytes).
-                                        if packet.header.payload_type == 101
-                                            && packet.payload.len() >= 4
-                                        {
-                                            let p = &packet.payload[..4];
-                                            let event = p[0];
-                                            let byte1 = p[1];
-                                            let end_of_event = (byte1 & 0b1000_0000) != 0;
-                                            let volume = byte1 & 0b0011_1111;
-                                            let duration = u16::from_be_bytes([p[2], p[3]]);
-
-                                            // RFC 4733 §2.5.1.3 retransmit dedup. The
-                                            // sender emits up to three identical E=1
-                                            // frames sharing `(ssrc, rtp_timestamp)`.
-                                            // Keyed by `(peer_addr, ssrc, ts)` so two
-                                            // simultaneous DTMF streams from
-                                            // different peers fire independently.
-                                            // Inline retain prunes stale entries on
-                                            // every fire — at one PT 101 frame per
-                                            // ~20 ms per active tone, this stays
-                                            // bounded.
-                                            if end_of_event {
-                                                let key = (
-                                                    addr,
-                                                    packet.header.ssrc,
-                                                    packet.header.timestamp,
-                                                );
-                                                let now = Instant::now();
-                                                dtmf_seen.retain(|_, seen_at| {
-                                                    now.duration_since(*seen_at) < DTMF_DEDUP_TTL
-                                                });
-                                                if dtmf_seen.insert(key, now).is_some() {
-                                                    continue; // retransmit — suppress
-                                                }
-                                            }
-
-                                            let dtmf = RtpEvent::DtmfEvent {
-                                                event,
-                                                end_of_event,
-                                                volume,
-                                                duration,
-                                                timestamp: packet.header.timestamp,
-                                                source: addr,
-                                                ssrc: packet.header.ssrc,
-                                            };
-                                            if event_tx.receiver_count() > 0 {
-                                                if let Err(e) = event_tx.send(dtmf) {
-                                                    warn!("Failed to send DTMF event: {}", e);
-                                                }
-                                            } else {
-                                                let _ = event_tx.send(dtmf);
-                                            }
-                                            continue;
-                                        }
-
-                                        // Create RTP event
-                                        let event = RtpEvent::MediaReceived {
-                                            payload_type: packet.header.payload_type,
-                                            sequence_number: packet.header.sequence_number,
-                                            timestamp: packet.header.timestamp,
-                                            marker: packet.header.marker,
-                                            payload: packet.payload.clone(), // Use the parsed payload
-                                            source: addr,
-                                            ssrc: packet.header.ssrc, // Include the SSRC from the parsed packet
-                                        };
-
-                                        // Only log errors if there are receivers
-                                        if event_tx.receiver_count() > 0 {
-                                            if let Err(e) = event_tx.send(event) {
-                                                warn!("Failed to send RTP event: {}", e);
-                                            }
-                                        } else {
-                                            // Still send the event but ignore errors if no one is listening
-                                            let _ = event_tx.send(event);
-                                        }
-                                    }
-                                    Err(e) => {
-                                        malformed_rtp_drop_count =
-                                            malformed_rtp_drop_count.saturating_add(1);
-                                        log_malformed_rtp_packet(
-                                            rtp_diagnostics,
-                                            malformed_rtp_drop_count,
-                                            local_rtp_addr,
-                                            addr,
-                                            size,
-                                            &e,
-                                            Some(&buffer[..size]),
-                                        );
-                                    }
-                                }
-                            }
+                            let data = &buffer[..size];
+                            receive.handle_datagram(data, addr, classify_rtp_mux_packet(data));
                         }
                         Err(e) => {
-                            error!("Error receiving packet: {}", e);
-
-                            // Send error event
-                            let err_event =
-                                RtpEvent::Error(Error::Transport(format!("Socket error: {}", e)));
-                            if event_tx.receiver_count() > 0 {
-                                let _ = event_tx.send(err_event);
-                            }
+                            receive.report_socket_error(&e);
 
                             // Short delay before retrying
                             tokio::time::sleep(tokio::time::Duration::from_millis(10)).await;
                         }
                     }
                 }
-            },
-        );
+            });
 
         // Store task handle
         let mut receiver_task = self.receiver_task.lock().await;
@@ -858,32 +1136,177 @@ impl UdpRtpTransport {
     }
 
     /// Send an RTP packet using caller-provided scratch storage for
-    /// serialization. Plain RTP writes directly into the scratch buffer;
-    /// SRTP keeps crypto-owned output semantics but combines protected
-    /// packet bytes and auth tag in one reusable buffer.
+    /// serialization. The packet is written into the scratch buffer and,
+    /// with SRTP, protected in place with the auth tag appended, so a
+    /// reused buffer makes the send path allocation-free.
     pub async fn send_rtp_with_buffer(
         &self,
         packet: &RtpPacket,
         dest: SocketAddr,
         buffer: &mut BytesMut,
     ) -> Result<()> {
-        let protected = {
+        buffer.clear();
+        {
             let mut srtp_guard = self.srtp_send.lock();
+            let trailer_len = srtp_guard.as_ref().map_or(0, |ctx| ctx.rtp_trailer_len());
+            buffer.reserve(packet.size() + trailer_len);
+            packet.write_to(buffer)?;
             if let Some(ctx) = srtp_guard.as_mut() {
-                Some(ctx.protect(packet)?)
-            } else {
-                None
+                ctx.protect_in_place(buffer)?;
             }
-        };
+        }
+        self.send_rtp_bytes(buffer, dest).await
+    }
 
-        if let Some(protected) = protected {
-            let data = protected.serialize_into(buffer)?;
-            self.send_rtp_bytes(&data, dest).await
-        } else {
-            buffer.clear();
-            packet.header.serialize(buffer)?;
-            buffer.extend_from_slice(&packet.payload);
-            self.send_rtp_bytes(buffer, dest).await
+    /// Send a burst of RTP packets to one destination through
+    /// [`Self::send_rtp_bytes_batch`]. Each packet is serialized (and, with
+    /// SRTP, protected) into its own slot of `buffers`, which grows to the
+    /// largest burst seen and is reused across calls.
+    pub async fn send_rtp_batch_with_buffers(
+        &self,
+        packets: &[RtpPacket],
+        dest: SocketAddr,
+        buffers: &mut Vec<BytesMut>,
+    ) -> Result<()> {
+        if buffers.len() < packets.len() {
+            buffers.resize_with(packets.len(), BytesMut::new);
+        }
+        {
+            let mut srtp_guard = self.srtp_send.lock();
+            let trailer_len = srtp_guard.as_ref().map_or(0, |ctx| ctx.rtp_trailer_len());
+            for (packet, buffer) in packets.iter().zip(buffers.iter_mut()) {
+                buffer.clear();
+                buffer.reserve(packet.size() + trailer_len);
+                packet.write_to(buffer)?;
+                if let Some(ctx) = srtp_guard.as_mut() {
+                    ctx.protect_in_place(buffer)?;
+                }
+            }
+        }
+        let wires: Vec<&[u8]> = buffers[..packets.len()].iter().map(|b| &b[..]).collect();
+        self.send_rtp_bytes_batch(&wires, dest).await
+    }
+
+    /// Send already-serialized RTP datagrams to one destination with as few
+    /// syscalls as the platform allows.
+    ///
+    /// On Linux this is `sendmmsg(2)`; with
+    /// [`RtpTransportBufferConfig::udp_offload`](super::RtpTransportBufferConfig::udp_offload)
+    /// set, runs of equal-sized packets go out as one UDP GSO send instead.
+    /// Elsewhere, and for a single packet, it is one `send_to` per packet.
+    /// Packets are sent in order; on error, the packets before the failing
+    /// one have already been sent.
+    pub async fn send_rtp_bytes_batch(&self, packets: &[&[u8]], dest: SocketAddr) -> Result<()> {
+        #[cfg(target_os = "linux")]
+        if packets.len() > 1 {
+            use std::os::fd::AsRawFd;
+
+            if self.config.symmetric_rtp {
+                self.remote_rtp_addr.store(Some(Arc::new(dest)));
+            }
+
+            let fd = self.rtp_socket.as_raw_fd();
+            let mut remaining = packets;
+            while !remaining.is_empty() {
+                let gso = self.udp_gso.load(Ordering::Relaxed);
+                let sent = self
+                    .rtp_socket
+                    .async_io(Interest::WRITABLE, || {
+                        self.send_batch.lock().send(fd, remaining, &dest, gso)
+                    })
+                    .await;
+                match sent {
+                    Ok(count) => {
+                        self.io_counters
+                            .send_syscalls
+                            .fetch_add(1, Ordering::Relaxed);
+                        self.io_counters
+                            .datagrams_sent
+                            .fetch_add(count as u64, Ordering::Relaxed);
+                        remaining = &remaining[count..];
+                    }
+                    Err(e) if gso && batch::is_gso_unsupported(&e) => {
+                        warn!("UDP GSO rejected by egress device, disabling: {}", e);
+                        self.udp_gso.store(false, Ordering::Relaxed);
+                    }
+                    Err(e) => {
+                        return Err(Error::Transport(format!("Failed to send RTP batch: {}", e)));
+                    }
+                }
+            }
+            return Ok(());
+        }
+
+        for packet in packets {
+            self.send_rtp_bytes(packet, dest).await?;
+        }
+        Ok(())
+    }
+
+    /// Snapshot of RTP-socket syscall and datagram counters.
+    pub fn io_stats(&self) -> UdpTransportIoStats {
+        UdpTransportIoStats {
+            recv_syscalls: self.io_counters.recv_syscalls.load(Ordering::Relaxed),
+            datagrams_received: self.io_counters.datagrams_received.load(Ordering::Relaxed),
+            send_syscalls: self.io_counters.send_syscalls.load(Ordering::Relaxed),
+            datagrams_sent: self.io_counters.datagrams_sent.load(Ordering::Relaxed),
+        }
+    }
+
+    /// Payload type of RFC 4733 `telephone-event`s received on this
+    /// transport, as negotiated in SDP. Packets carrying it are reported as
+    /// [`RtpEvent::DtmfEvent`]s, and a kernel relay forwarding this leg
+    /// leaves them to the receive loop.
+    pub fn set_telephone_event_payload_type(&self, payload_type: u8) {
+        self.telephone_event_pt
+            .store(payload_type, Ordering::Relaxed);
+    }
+
+    /// The `telephone-event` payload type currently in effect
+    pub fn telephone_event_payload_type(&self) -> u8 {
+        self.telephone_event_pt.load(Ordering::Relaxed)
+    }
+
+    /// Outbound side of a bridge forwarder: packets relayed to it leave
+    /// from this transport's RTP socket towards its current remote
+    /// address, protected with its outbound SRTP context and stamped with
+    /// `ssrc` and the next value of `sequence`.
+    pub fn forward_target(
+        &self,
+        ssrc: RtpSsrc,
+        sequence: Arc<AtomicU16>,
+        clock_rate: u32,
+    ) -> RtpForwardTarget {
+        RtpForwardTarget {
+            socket: self.rtp_socket.clone(),
+            remote_addr: self.remote_rtp_addr.clone(),
+            srtp_send: self.srtp_send.clone(),
+            active: self.active.clone(),
+            io_counters: self.io_counters.clone(),
+            ssrc,
+            sequence,
+            clock_rate,
+        }
+    }
+
+    /// Relay RTP media received on this transport to `target` from the
+    /// receive loop, replacing any forwarder already installed. While the
+    /// returned guard lives, RTP media is no longer published as
+    /// [`RtpEvent`]s; RTCP still is.
+    pub fn install_forwarder(&self, target: RtpForwardTarget) -> RtpForwardGuard {
+        let forwarder = Arc::new(RtpForwarder::new(target));
+        self.forward.store(Some(forwarder.clone()));
+        RtpForwardGuard {
+            slot: self.forward.clone(),
+            forwarder,
+            #[cfg(target_os = "linux")]
+            ingress: (
+                self.rtp_socket.local_addr().ok(),
+                self.srtp_recv.clone(),
+                self.telephone_event_pt.clone(),
+            ),
+            #[cfg(target_os = "linux")]
+            revalidate: None,
         }
     }
 }
@@ -920,6 +1343,13 @@ impl RtpTransport for UdpRtpTransport {
             .await
             .map_err(|e| Error::Transport(format!("Failed to send RTP packet: {}", e)))?;
 
+        self.io_counters
+            .send_syscalls
+            .fetch_add(1, Ordering::Relaxed);
+        self.io_counters
+            .datagrams_sent
+            .fetch_add(1, Ordering::Relaxed);
+
         debug!("UDP send_to sent {} bytes to {}", sent_bytes, dest);
         Ok(())
     }
@@ -976,6 +1406,15 @@ impl RtpTransport for UdpRtpTransport {
         self.event_tx.subscribe()
     }
 
+    async fn install_srtp_contexts(
+        &self,
+        send: crate::srtp::SrtpContext,
+        recv: crate::srtp::SrtpContext,
+    ) -> Result<()> {
+        UdpRtpTransport::set_srtp_contexts(self, send, recv).await;
+        Ok(())
+    }
+
     async fn close(&self) -> Result<()> {
         // Stop the receiver task
         self.stop_receiver().await?;
@@ -1060,6 +1499,7 @@ fn is_rtcp_packet(buffer: &[u8]) -> bool {
 mod tests {
     use super::*;
     use crate::packet::RtpHeader;
+    use crate::transport::{RtpForwardStats, RtpTransportBufferConfig};
     use bytes::Bytes;
 
     #[test]
@@ -1965,6 +2405,44 @@ mod tests {
         );
     }
 
+    /// A `telephone-event` payload type negotiated away from 101 is the
+    /// one decoded as DTMF; PT 101 then is ordinary media.
+    #[tokio::test]
+    async fn test_negotiated_telephone_event_pt_dispatch_as_dtmf_event() {
+        let cfg = |name: &str| RtpTransportConfig {
+            local_rtp_addr: "127.0.0.1:0".parse().unwrap(),
+            local_rtcp_addr: None,
+            symmetric_rtp: true,
+            rtcp_mux: true,
+            session_id: Some(name.to_string()),
+            use_port_allocator: false,
+            buffer_config: Default::default(),
+        };
+        let sender = UdpRtpTransport::new(cfg("dtmf-pt-sender")).await.unwrap();
+        let receiver = UdpRtpTransport::new(cfg("dtmf-pt-receiver")).await.unwrap();
+        receiver.set_telephone_event_payload_type(96);
+        assert_eq!(receiver.telephone_event_payload_type(), 96);
+
+        let mut events = receiver.subscribe();
+        let receiver_addr = receiver.local_rtp_addr().unwrap();
+        let payload = rfc4733_payload(5, true, 10, 800);
+        for (seq, pt) in [(1, 101), (2, 96)] {
+            let header = RtpHeader::new(pt, seq, 4000, 0x0bad_cafe);
+            let packet = RtpPacket::new(header, payload.clone());
+            sender.send_rtp(&packet, receiver_addr).await.unwrap();
+        }
+
+        let timeout = tokio::time::Duration::from_millis(500);
+        match tokio::time::timeout(timeout, events.recv()).await {
+            Ok(Ok(RtpEvent::MediaReceived { payload_type, .. })) => assert_eq!(payload_type, 101),
+            other => panic!("expected PT 101 as media, got {:?}", other),
+        }
+        match tokio::time::timeout(timeout, events.recv()).await {
+            Ok(Ok(RtpEvent::DtmfEvent { event, .. })) => assert_eq!(event, 5),
+            other => panic!("expected DtmfEvent on PT 96, got {:?}", other),
+        }
+    }
+
     /// Dedup keys on `(peer_addr, ssrc, ts)` because rtp-core has no
     /// dialog scope. Two simultaneous DTMF streams from different peers
     /// that happen to collide on `(ssrc, ts)` must each fire — they're
@@ -2064,4 +2542,225 @@ mod tests {
             other => panic!("expected plaintext MediaReceived, got {:?}", other),
         }
     }
+
+    /// Batched send + `recvmmsg` receive (with and without UDP GSO/GRO)
+    /// must surface the same in-order `MediaReceived` stream as the
+    /// per-datagram path.
+    #[tokio::test]
+    async fn batched_io_delivers_same_events_as_per_datagram_path() {
+        for (recv_batch_size, udp_offload) in [(1, false), (32, false), (32, true)] {
+            let buffer_config = RtpTransportBufferConfig {
+                recv_batch_size,
+                udp_offload,
+                ..Default::default()
+            };
+            let cfg = |name: &str| RtpTransportConfig {
+                local_rtp_addr: "127.0.0.1:0".parse().unwrap(),
+                local_rtcp_addr: None,
+                symmetric_rtp: true,
+                rtcp_mux: true,
+                session_id: Some(name.to_string()),
+                use_port_allocator: false,
+                buffer_config,
+            };
+            let t1 = UdpRtpTransport::new(cfg("batch1")).await.unwrap();
+            let t2 = UdpRtpTransport::new(cfg("batch2")).await.unwrap();
+            let mut events = t2.subscribe();
+
+            let packets: Vec<RtpPacket> = (0..16u16)
+                .map(|seq| {
+                    let header = RtpHeader::new(0, seq, seq as u32 * 160, 0x1234_5678);
+                    RtpPacket::new(header, Bytes::from(vec![seq as u8; 160]))
+                })
+                .collect();
+            let mut buffers = Vec::new();
+            t1.send_rtp_batch_with_buffers(&packets, t2.local_rtp_addr().unwrap(), &mut buffers)
+                .await
+                .unwrap();
+            assert_eq!(t1.io_stats().datagrams_sent, 16);
+
+            for seq in 0..16u16 {
+                match tokio::time::timeout(Duration::from_millis(500), events.recv()).await {
+                    Ok(Ok(RtpEvent::MediaReceived {
+                        sequence_number,
+                        payload,
+                        source,
+                        ..
+                    })) => {
+                        assert_eq!(sequence_number, seq);
+                        assert_eq!(&payload[..], &[seq as u8; 160][..]);
+                        assert_eq!(source, t1.local_rtp_addr().unwrap());
+                    }
+                    other => panic!(
+                        "batch={} offload={}: expected MediaReceived seq {}, got {:?}",
+                        recv_batch_size, udp_offload, seq, other
+                    ),
+                }
+            }
+
+            let sent = t1.io_stats();
+            assert_eq!(sent.datagrams_sent, 16);
+            let received = t2.io_stats();
+            assert_eq!(received.datagrams_received, 16);
+            if recv_batch_size == 1 || !cfg!(target_os = "linux") {
+                assert_eq!(received.recv_syscalls, 16);
+            } else {
+                assert!(received.recv_syscalls <= 16);
+            }
+        }
+    }
+
+    fn forward_test_config(name: &str) -> RtpTransportConfig {
+        RtpTransportConfig {
+            local_rtp_addr: "127.0.0.1:0".parse().unwrap(),
+            local_rtcp_addr: None,
+            symmetric_rtp: true,
+            rtcp_mux: true,
+            session_id: Some(name.to_string()),
+            use_port_allocator: false,
+            buffer_config: Default::default(),
+        }
+    }
+
+    #[tokio::test]
+    async fn forwarder_rewrites_and_rekeys_in_the_receive_loop() {
+        // peer --SRTP(k1)--> A ==forwarder==> B --SRTP(k2)--> sink
+        let transport_a = UdpRtpTransport::new(forward_test_config("fwd-a"))
+            .await
+            .unwrap();
+        let transport_b = UdpRtpTransport::new(forward_test_config("fwd-b"))
+            .await
+            .unwrap();
+        let peer = UdpSocket::bind("127.0.0.1:0").await.unwrap();
+        let sink = UdpSocket::bind("127.0.0.1:0").await.unwrap();
+
+        let (mut peer_send, a_recv) = make_srtp_ctx_pair();
+        let (a_send, _) = make_srtp_ctx_pair();
+        transport_a.set_srtp_contexts(a_send, a_recv).await;
+        let (b_send, mut sink_recv) = make_aes256_srtp_ctx_pair();
+        let (_, b_recv) = make_aes256_srtp_ctx_pair();
+        transport_b.set_srtp_contexts(b_send, b_recv).await;
+        transport_b
+            .set_remote_rtp_addr(sink.local_addr().unwrap())
+            .await;
+
+        let sequence = Arc::new(AtomicU16::new(4000));
+        let guard =
+            transport_a.install_forwarder(transport_b.forward_target(0x0b0b_0b0b, sequence, 8000));
+        let mut a_events = transport_a.subscribe();
+
+        let payload = Bytes::from_static(&[0x55; 160]);
+        for i in 0..3u16 {
+            let packet = RtpPacket::new(
+                RtpHeader::new(0, 100 + i, 160 * u32::from(i), 0xa),
+                payload.clone(),
+            );
+            let mut wire = BytesMut::from(&packet.serialize().unwrap()[..]);
+            wire.reserve(peer_send.rtp_trailer_len());
+            peer_send.protect_in_place(&mut wire).unwrap();
+            peer.send_to(&wire, transport_a.local_rtp_addr().unwrap())
+                .await
+                .unwrap();
+        }
+
+        let mut buf = [0u8; 2048];
+        for i in 0..3u16 {
+            let (n, from) =
+                tokio::time::timeout(Duration::from_millis(500), sink.recv_from(&mut buf))
+                    .await
+                    .expect("forwarded packet")
+                    .unwrap();
+            assert_eq!(from, transport_b.local_rtp_addr().unwrap());
+            let packet = sink_recv.unprotect(&buf[..n]).expect("re-keyed for leg B");
+            assert_eq!(packet.header.ssrc, 0x0b0b_0b0b);
+            assert_eq!(packet.header.sequence_number, 4000 + i);
+            assert_eq!(packet.header.timestamp, 160 * u32::from(i));
+            assert_eq!(packet.payload, payload);
+        }
+
+        assert!(
+            matches!(
+                a_events.try_recv(),
+                Err(broadcast::error::TryRecvError::Empty)
+            ),
+            "forwarded media must not be published on the inbound leg"
+        );
+        assert_eq!(
+            guard.stats(),
+            RtpForwardStats {
+                forwarded: 3,
+                ..Default::default()
+            }
+        );
+        assert_eq!(transport_b.io_stats().datagrams_sent, 3);
+
+        // Uninstalling restores normal delivery.
+        drop(guard);
+        let packet = RtpPacket::new(RtpHeader::new(0, 200, 0, 0xa), payload.clone());
+        let mut wire = BytesMut::from(&packet.serialize().unwrap()[..]);
+        peer_send.protect_in_place(&mut wire).unwrap();
+        peer.send_to(&wire, transport_a.local_rtp_addr().unwrap())
+            .await
+            .unwrap();
+        match tokio::time::timeout(Duration::from_millis(500), a_events.recv()).await {
+            Ok(Ok(RtpEvent::MediaReceived {
+                sequence_number, ..
+            })) => assert_eq!(sequence_number, 200),
+            other => panic!("expected MediaReceived, got {:?}", other),
+        }
+    }
+
+    #[tokio::test]
+    async fn forwarded_telephone_events_are_still_reported() {
+        let transport_a = UdpRtpTransport::new(forward_test_config("fwd-dtmf-a"))
+            .await
+            .unwrap();
+        let transport_b = UdpRtpTransport::new(forward_test_config("fwd-dtmf-b"))
+            .await
+            .unwrap();
+        let peer = UdpSocket::bind("127.0.0.1:0").await.unwrap();
+        let sink = UdpSocket::bind("127.0.0.1:0").await.unwrap();
+        transport_b
+            .set_remote_rtp_addr(sink.local_addr().unwrap())
+            .await;
+        let _guard = transport_a.install_forwarder(transport_b.forward_target(
+            0x0b0b_0b0b,
+            Arc::new(AtomicU16::new(1)),
+            8000,
+        ));
+        let mut a_events = transport_a.subscribe();
+
+        // Digit 5, end of event, volume 10, duration 800.
+        let body = Bytes::from_static(&[5, 0x8a, 0x03, 0x20]);
+        let packet = RtpPacket::new(RtpHeader::new(101, 7, 4000, 0xa), body.clone());
+        peer.send_to(
+            &packet.serialize().unwrap(),
+            transport_a.local_rtp_addr().unwrap(),
+        )
+        .await
+        .unwrap();
+
+        match tokio::time::timeout(Duration::from_millis(500), a_events.recv()).await {
+            Ok(Ok(RtpEvent::DtmfEvent {
+                event,
+                end_of_event,
+                timestamp,
+                ssrc,
+                ..
+            })) => {
+                assert_eq!((event, end_of_event), (5, true));
+                assert_eq!((timestamp, ssrc), (4000, 0xa));
+            }
+            other => panic!("expected DtmfEvent, got {:?}", other),
+        }
+        let mut buf = [0u8; 2048];
+        let (n, _) = tokio::time::timeout(Duration::from_millis(500), sink.recv_from(&mut buf))
+            .await
+            .expect("forwarded telephone-event")
+            .unwrap();
+        let forwarded = RtpPacket::parse(&buf[..n]).unwrap();
+        assert_eq!(forwarded.header.payload_type, 101);
+        assert_eq!(forwarded.header.ssrc, 0x0b0b_0b0b);
+        assert_eq!(forwarded.payload, body);
+    }
 }
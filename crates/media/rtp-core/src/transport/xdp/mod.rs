@@ -0,0 +1,352 @@
+//! In-kernel RTP relay for transparent bridges (Linux XDP)
+//!
+//! A bridge whose legs both carry plain RTP only needs each packet's
+//! addresses and RTP identity rewritten, which the kernel can do before
+//! the packet ever reaches a socket. [`XdpRelay`] loads a small XDP
+//! program (see `program.rs`) on the interfaces media arrives on and keeps
+//! one [`XdpRelayRule`] per relayed flow in a BPF hash map, keyed on the
+//! inbound leg's local RTP port. Matching packets are rewritten and
+//! redirected out of the outbound leg's interface; everything else — RTCP,
+//! STUN, SRTP, packets from a new SSRC, flows without a rule, packets whose
+//! next hop is not resolved yet — continues to the socket and the
+//! userspace [`UdpRtpTransport`](super::UdpRtpTransport) path unchanged.
+//! The program counts the packets and bytes it relays per rule, and
+//! records the last sequence number and timestamp it wrote, so userspace
+//! can take a flow back without a discontinuity.
+//!
+//! Bridges normally drive this through
+//! [`RtpForwardGuard::offload`](super::RtpForwardGuard::offload), which
+//! installs and withdraws rules as the forwarder's view of the flow
+//! changes. Loading and attaching XDP programs needs `CAP_BPF` and
+//! `CAP_NET_ADMIN` (or root), and Linux 5.9+ for XDP links. The kernel's
+//! route lookup only resolves next hops from interfaces with IPv4
+//! forwarding enabled, so outbound interfaces need
+//! `net.ipv4.conf.<interface>.forwarding=1`; rules towards any other
+//! interface are refused and those flows stay in userspace.
+
+mod program;
+mod sys;
+
+use std::net::{IpAddr, Ipv4Addr, SocketAddr, SocketAddrV4, UdpSocket};
+use std::os::fd::{AsRawFd, OwnedFd};
+
+use tracing::debug;
+
+use self::program::{RuleKey, RuleValue};
+use crate::{Error, Result, RtpSsrc};
+
+/// Default capacity of the rule map: two rules per bridged call
+pub const DEFAULT_XDP_RELAY_RULES: u32 = 16_384;
+
+/// Where the relay program runs
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub enum XdpAttachMode {
+    /// Generic XDP, run by the network stack after the socket buffer is
+    /// built. Works on every interface (veth, bonds, virtual NICs).
+    #[default]
+    Generic,
+    /// Native XDP, run by the driver before any allocation. Needs driver
+    /// support on the inbound interface, and redirect support on the
+    /// outbound one.
+    Driver,
+}
+
+/// One relayed flow: RTP arriving at `ingress` from `source_ssrc` leaves
+/// from `egress` to `destination` as `ssrc`
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct XdpRelayRule {
+    /// Local RTP address of the inbound leg. A rule matches its port; an
+    /// unspecified IP matches every local address.
+    pub ingress: SocketAddr,
+    /// SSRC the rule relays; other sources are left to userspace
+    pub source_ssrc: RtpSsrc,
+    /// Local RTP address of the outbound leg. When its IP is unspecified
+    /// the address the kernel would pick for `destination` is used.
+    pub egress: SocketAddr,
+    /// Remote RTP address of the outbound leg
+    pub destination: SocketAddr,
+    /// SSRC written into relayed packets
+    pub ssrc: RtpSsrc,
+    /// Added to each sequence number (wrapping)
+    pub sequence_offset: u16,
+    /// Added to each timestamp (wrapping)
+    pub timestamp_offset: u32,
+    /// Payload type the kernel leaves to userspace, e.g. telephone-events
+    /// the inbound leg still reports
+    pub passed_payload_type: Option<u8>,
+}
+
+/// What the kernel relayed for one rule
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct XdpRuleCounters {
+    /// Packets relayed
+    pub packets: u64,
+    /// Bytes relayed, Ethernet header included
+    pub bytes: u64,
+    /// Last sequence number written; meaningless while `packets` is 0
+    pub last_sequence: u16,
+    /// Last timestamp written; meaningless while `packets` is 0
+    pub last_timestamp: u32,
+}
+
+struct XdpLink {
+    interface: String,
+    _link: OwnedFd,
+}
+
+/// XDP relay program attached to a set of interfaces, with its rule map
+///
+/// Dropping the relay detaches the program and frees the rules; packets
+/// then take the userspace path again.
+pub struct XdpRelay {
+    rules: OwnedFd,
+    _program: OwnedFd,
+    links: Vec<XdpLink>,
+}
+
+fn bpf_error(what: &str, e: std::io::Error) -> Error {
+    let hint = match e.raw_os_error() {
+        Some(libc::EPERM) => " (needs CAP_BPF and CAP_NET_ADMIN)",
+        _ => "",
+    };
+    Error::Transport(format!("XDP relay: {}: {}{}", what, e, hint))
+}
+
+fn ipv4(addr: SocketAddr, what: &str) -> Result<SocketAddrV4> {
+    match addr {
+        SocketAddr::V4(v4) => Ok(v4),
+        SocketAddr::V6(_) => Err(Error::UnsupportedFeature(format!(
+            "XDP relay: {} {} is IPv6; only IPv4 is relayed in the kernel",
+            what, addr
+        ))),
+    }
+}
+
+/// Source address and interface of packets sent from `egress` to
+/// `destination`, resolved the way the kernel would for an unbound socket
+fn resolve_egress(egress: SocketAddrV4, destination: SocketAddrV4) -> Result<(Ipv4Addr, u32)> {
+    let source = if egress.ip().is_unspecified() {
+        // A connected UDP socket reports the source address routing picked.
+        let probe = UdpSocket::bind((Ipv4Addr::UNSPECIFIED, 0))
+            .and_then(|probe| probe.connect(destination).map(|_| probe))
+            .and_then(|probe| probe.local_addr())
+            .map_err(|e| {
+                Error::Transport(format!("XDP relay: no route to {}: {}", destination, e))
+            })?;
+        match probe.ip() {
+            IpAddr::V4(ip) => ip,
+            IpAddr::V6(ip) => {
+                return Err(Error::Transport(format!(
+                    "XDP relay: route to {} picked IPv6 source {}",
+                    destination, ip
+                )))
+            }
+        }
+    } else {
+        *egress.ip()
+    };
+    let (interface, ifindex) = sys::interface_with_address(source)
+        .map_err(|e| bpf_error("listing interfaces", e))?
+        .ok_or_else(|| {
+            Error::Transport(format!("XDP relay: no interface has address {}", source))
+        })?;
+    // bpf_fib_lookup() refuses to route from an interface that does not
+    // forward, whichever direction the lookup is for.
+    if !sys::ipv4_forwarding(&interface).unwrap_or(false) {
+        return Err(Error::Transport(format!(
+            "XDP relay: IPv4 forwarding is disabled on {} (net.ipv4.conf.{}.forwarding)",
+            interface, interface
+        )));
+    }
+    Ok((source, ifindex))
+}
+
+impl XdpRelay {
+    /// Load the relay program and attach it to `interfaces`, with room
+    /// for `max_rules` flows. Interface names are resolved in the calling
+    /// thread's network namespace.
+    pub fn attach(interfaces: &[&str], mode: XdpAttachMode, max_rules: u32) -> Result<Self> {
+        let rules = sys::hash_map_create::<RuleKey, RuleValue>("rvoip_relay", max_rules)
+            .map_err(|e| bpf_error("creating rule map", e))?;
+        let insns = program::relay_program(rules.as_raw_fd());
+        let program = sys::xdp_prog_load("rvoip_relay", &insns, program::LICENSE)
+            .map_err(|e| bpf_error("loading program", e))?;
+
+        let flags = match mode {
+            XdpAttachMode::Generic => sys::XDP_FLAGS_SKB_MODE,
+            XdpAttachMode::Driver => sys::XDP_FLAGS_DRV_MODE,
+        };
+        let mut links = Vec::with_capacity(interfaces.len());
+        for &interface in interfaces {
+            let ifindex = sys::interface_index(interface)
+                .map_err(|e| bpf_error(&format!("interface {}", interface), e))?;
+            let link = sys::xdp_link_create(&program, ifindex, flags)
+                .map_err(|e| bpf_error(&format!("attaching to {}", interface), e))?;
+            debug!("XDP relay attached to {} ({:?} mode)", interface, mode);
+            links.push(XdpLink {
+                interface: interface.to_string(),
+                _link: link,
+            });
+        }
+
+        Ok(Self {
+            rules,
+            _program: program,
+            links,
+        })
+    }
+
+    /// Interfaces the program is attached to
+    pub fn interfaces(&self) -> impl Iterator<Item = &str> {
+        self.links.iter().map(|link| link.interface.as_str())
+    }
+
+    /// Install `rule`, replacing any rule for the same ingress port. The
+    /// replaced rule's counters are discarded; read them with
+    /// [`Self::remove`] first if they matter.
+    pub fn insert(&self, rule: &XdpRelayRule) -> Result<()> {
+        let ingress = ipv4(rule.ingress, "ingress")?;
+        let egress = ipv4(rule.egress, "egress")?;
+        let destination = ipv4(rule.destination, "destination")?;
+        let (source, egress_ifindex) = resolve_egress(egress, destination)?;
+
+        let value = RuleValue {
+            local_ip: ingress.ip().octets(),
+            src_ip: source.octets(),
+            dst_ip: destination.ip().octets(),
+            src_port: egress.port().to_be_bytes(),
+            dst_port: destination.port().to_be_bytes(),
+            ssrc: rule.ssrc.to_be_bytes(),
+            source_ssrc: rule.source_ssrc.to_be_bytes(),
+            sequence_offset: rule.sequence_offset,
+            timestamp_offset: rule.timestamp_offset,
+            egress_ifindex,
+            passed_payload_type: rule
+                .passed_payload_type
+                .map_or(program::NO_PAYLOAD_TYPE, |pt| pt & 0x7f),
+            ..Default::default()
+        };
+        let key = RuleKey::from(ingress.port());
+        sys::map_update(&self.rules, &key, &value).map_err(|e| bpf_error("installing rule", e))
+    }
+
+    /// Remove the rule for `ingress`'s port, returning its final counters
+    pub fn remove(&self, ingress: SocketAddr) -> Result<Option<XdpRuleCounters>> {
+        let counters = self.counters(ingress)?;
+        let key = RuleKey::from(ingress.port());
+        sys::map_delete(&self.rules, &key).map_err(|e| bpf_error("removing rule", e))?;
+        Ok(counters)
+    }
+
+    /// Current counters of the rule for `ingress`'s port
+    pub fn counters(&self, ingress: SocketAddr) -> Result<Option<XdpRuleCounters>> {
+        let key = RuleKey::from(ingress.port());
+        let value: Option<RuleValue> =
+            sys::map_lookup(&self.rules, &key).map_err(|e| bpf_error("reading rule", e))?;
+        Ok(value.map(|value| XdpRuleCounters {
+            packets: value.packets,
+            bytes: value.bytes,
+            last_sequence: value.last_sequence,
+            last_timestamp: value.last_timestamp,
+        }))
+    }
+}
+
+impl std::fmt::Debug for XdpRelay {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("XdpRelay")
+            .field("interfaces", &self.interfaces().collect::<Vec<_>>())
+            .finish()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::program::XDP_PASS;
+    use super::*;
+
+    fn is_root() -> bool {
+        // SAFETY: geteuid has no preconditions.
+        unsafe { libc::geteuid() == 0 }
+    }
+
+    /// Ethernet + IPv4 + UDP + RTP frame to `dport`
+    fn frame(dport: u16, payload_type: u8, ssrc: u32) -> Vec<u8> {
+        let mut frame = vec![0u8; 54 + 160];
+        frame[12..14].copy_from_slice(&0x0800u16.to_be_bytes());
+        frame[14] = 0x45;
+        let total = (frame.len() - 14) as u16;
+        frame[16..18].copy_from_slice(&total.to_be_bytes());
+        frame[22] = 64;
+        frame[23] = 17;
+        frame[26..30].copy_from_slice(&[10, 0, 0, 2]);
+        frame[30..34].copy_from_slice(&[10, 0, 0, 1]);
+        frame[34..36].copy_from_slice(&40_000u16.to_be_bytes());
+        frame[36..38].copy_from_slice(&dport.to_be_bytes());
+        frame[38..40].copy_from_slice(&(total - 20).to_be_bytes());
+        frame[42] = 0x80;
+        frame[43] = payload_type;
+        frame[50..54].copy_from_slice(&ssrc.to_be_bytes());
+        frame
+    }
+
+    #[test]
+    fn ipv6_rules_are_rejected_before_touching_the_kernel() {
+        let v4: SocketAddr = "10.0.0.1:5000".parse().unwrap();
+        let v6: SocketAddr = "[::1]:5000".parse().unwrap();
+        assert!(matches!(
+            ipv4(v6, "destination"),
+            Err(Error::UnsupportedFeature(_))
+        ));
+        assert!(ipv4(v4, "ingress").is_ok());
+    }
+
+    #[test]
+    #[ignore = "needs CAP_BPF: loads the relay program through the verifier"]
+    fn program_passes_what_it_cannot_relay() {
+        if !is_root() {
+            return;
+        }
+        let rules = sys::hash_map_create::<RuleKey, RuleValue>("rvoip_test", 16).unwrap();
+        let insns = program::relay_program(rules.as_raw_fd());
+        let prog = sys::xdp_prog_load("rvoip_test", &insns, program::LICENSE)
+            .expect("verifier accepts the relay program");
+
+        let rule = RuleValue {
+            source_ssrc: 0x1234_5678u32.to_be_bytes(),
+            dst_ip: [127, 0, 0, 1],
+            egress_ifindex: 1,
+            passed_payload_type: 101,
+            ..Default::default()
+        };
+        sys::map_update(&rules, &RuleKey::from(5004u16), &rule).unwrap();
+
+        let pass = XDP_PASS as u32;
+        // No rule for the port.
+        let mut packet = frame(6000, 0, 0x1234_5678);
+        assert_eq!(sys::xdp_test_run(&prog, &mut packet).unwrap(), pass);
+        // RTCP sender report on the RTP port.
+        let mut packet = frame(5004, 200, 0x1234_5678);
+        assert_eq!(sys::xdp_test_run(&prog, &mut packet).unwrap(), pass);
+        // Telephone-event left to userspace.
+        let mut packet = frame(5004, 101, 0x1234_5678);
+        assert_eq!(sys::xdp_test_run(&prog, &mut packet).unwrap(), pass);
+        // Another source.
+        let mut packet = frame(5004, 0, 0x0bad_0bad);
+        assert_eq!(sys::xdp_test_run(&prog, &mut packet).unwrap(), pass);
+        // Truncated frame.
+        let mut packet = frame(5004, 0, 0x1234_5678);
+        packet.truncate(50);
+        assert_eq!(sys::xdp_test_run(&prog, &mut packet).unwrap(), pass);
+        // Matching rule, but the destination is local: not forwardable.
+        let mut packet = frame(5004, 0, 0x1234_5678);
+        let original = packet.clone();
+        assert_eq!(sys::xdp_test_run(&prog, &mut packet).unwrap(), pass);
+        assert_eq!(packet, original, "passed frames are not modified");
+
+        let value: RuleValue = sys::map_lookup(&rules, &RuleKey::from(5004u16))
+            .unwrap()
+            .unwrap();
+        assert_eq!(value.packets, 0);
+    }
+}
@@ -0,0 +1,568 @@
+//! The relay's XDP program, assembled in place
+//!
+//! The program is small enough to hand-assemble, which keeps the relay free
+//! of a BPF toolchain at build time and of an object loader at run time.
+//! [`Asm`] is a minimal eBPF assembler (forward labels, no relocations
+//! other than the one map descriptor); [`relay_program`] emits the relay.
+//!
+//! Per frame, the program:
+//!
+//! 1. passes anything that is not Ethernet + IPv4 without options + an
+//!    unfragmented UDP datagram carrying an RTP version 2 header, and
+//!    RTCP (RFC 5761 §4 payload types 64–95 with the marker bit set);
+//! 2. looks the UDP destination port up in the rule map, and passes the
+//!    frame on a miss, when the rule is bound to another local address,
+//!    when the RTP SSRC is not the rule's source, or when the payload
+//!    type is the one the rule leaves to userspace (telephone-events);
+//! 3. resolves the outbound route and next hop with `bpf_fib_lookup`
+//!    (output lookup from the rule's egress interface), and passes the
+//!    frame if there is none yet, e.g. an unresolved neighbour;
+//! 4. rewrites MACs, IP addresses (TTL reset, header checksum
+//!    recomputed), UDP ports (checksum cleared, RFC 768) and the RTP
+//!    sequence number, timestamp and SSRC, then counts the frame and
+//!    redirects it out of the egress interface.
+//!
+//! Passed frames continue up the stack to the owning socket, so userspace
+//! sees exactly what the kernel could not relay.
+
+use std::mem::offset_of;
+
+/// `XDP_PASS`
+pub(super) const XDP_PASS: i32 = 2;
+
+/// Verifier-visible license of the program; the helpers used are not
+/// GPL-only, but the fib lookup helper's kernel side is GPL code
+pub(super) const LICENSE: &str = "Dual MIT/GPL";
+
+/// `BPF_FIB_LOOKUP_OUTPUT`: route as a locally generated packet
+const BPF_FIB_LOOKUP_OUTPUT: i32 = 1 << 1;
+
+// Helper function ids from <linux/bpf.h>.
+const HELPER_MAP_LOOKUP_ELEM: i32 = 1;
+const HELPER_REDIRECT: i32 = 23;
+const HELPER_FIB_LOOKUP: i32 = 69;
+
+/// Rule map value: one relayed flow. Addresses, ports and SSRCs are kept
+/// in network byte order exactly as they appear on the wire; offsets and
+/// the kernel-written last values are host order.
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub(super) struct RuleValue {
+    /// Inbound destination address to match, 0 for any
+    pub local_ip: [u8; 4],
+    /// Rewritten source address (the egress leg's)
+    pub src_ip: [u8; 4],
+    /// Rewritten destination address
+    pub dst_ip: [u8; 4],
+    pub src_port: [u8; 2],
+    pub dst_port: [u8; 2],
+    /// Rewritten SSRC
+    pub ssrc: [u8; 4],
+    /// SSRC the rule matches
+    pub source_ssrc: [u8; 4],
+    pub sequence_offset: u16,
+    /// Last sequence number sent, written by the program
+    pub last_sequence: u16,
+    pub timestamp_offset: u32,
+    /// Last timestamp sent, written by the program
+    pub last_timestamp: u32,
+    /// Interface the egress address lives on; the route lookup starts there
+    pub egress_ifindex: u32,
+    /// Payload type left to userspace (telephone-events), `NO_PAYLOAD_TYPE`
+    /// for none
+    pub passed_payload_type: u8,
+    pub _pad: [u8; 7],
+    pub packets: u64,
+    /// Frame bytes relayed, Ethernet header included
+    pub bytes: u64,
+}
+
+/// `RuleValue::passed_payload_type` matching nothing (payload types are
+/// 7 bits)
+pub(super) const NO_PAYLOAD_TYPE: u8 = 0xff;
+
+/// Rule map key: UDP destination port, host order
+pub(super) type RuleKey = u32;
+
+/// One eBPF instruction (`struct bpf_insn`)
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub(crate) struct Insn {
+    pub code: u8,
+    /// `dst_reg` in the low nibble, `src_reg` in the high nibble
+    pub regs: u8,
+    pub off: i16,
+    pub imm: i32,
+}
+
+// Instruction classes, sizes, modes and operations from <linux/bpf.h>.
+const BPF_LD: u8 = 0x00;
+const BPF_LDX: u8 = 0x01;
+const BPF_ST: u8 = 0x02;
+const BPF_STX: u8 = 0x03;
+const BPF_ALU: u8 = 0x04;
+const BPF_JMP: u8 = 0x05;
+const BPF_ALU64: u8 = 0x07;
+
+pub(super) const BPF_W: u8 = 0x00;
+pub(super) const BPF_H: u8 = 0x08;
+pub(super) const BPF_B: u8 = 0x10;
+pub(super) const BPF_DW: u8 = 0x18;
+
+const BPF_IMM: u8 = 0x00;
+const BPF_MEM: u8 = 0x60;
+const BPF_ATOMIC: u8 = 0xc0;
+
+const BPF_K: u8 = 0x00;
+const BPF_X: u8 = 0x08;
+const BPF_TO_BE: u8 = 0x08;
+
+const BPF_ADD: u8 = 0x00;
+const BPF_AND: u8 = 0x50;
+const BPF_RSH: u8 = 0x70;
+const BPF_XOR: u8 = 0xa0;
+const BPF_MOV: u8 = 0xb0;
+const BPF_END: u8 = 0xd0;
+
+const BPF_JA: u8 = 0x00;
+pub(super) const BPF_JEQ: u8 = 0x10;
+pub(super) const BPF_JGT: u8 = 0x20;
+pub(super) const BPF_JNE: u8 = 0x50;
+pub(super) const BPF_JLT: u8 = 0xa0;
+pub(super) const BPF_JLE: u8 = 0xb0;
+const BPF_CALL: u8 = 0x80;
+const BPF_EXIT: u8 = 0x90;
+
+/// `BPF_PSEUDO_MAP_FD`: `ld_imm64` source marker for a map descriptor
+const BPF_PSEUDO_MAP_FD: u8 = 1;
+
+pub(super) const R0: u8 = 0;
+pub(super) const R1: u8 = 1;
+pub(super) const R2: u8 = 2;
+pub(super) const R3: u8 = 3;
+pub(super) const R4: u8 = 4;
+pub(super) const R6: u8 = 6;
+pub(super) const R7: u8 = 7;
+pub(super) const R8: u8 = 8;
+pub(super) const R9: u8 = 9;
+pub(super) const R10: u8 = 10;
+
+/// Jump target handed out by [`Asm::label`]
+#[derive(Debug, Clone, Copy)]
+pub(super) struct Label(usize);
+
+/// Minimal eBPF assembler
+#[derive(Debug, Default)]
+pub(super) struct Asm {
+    insns: Vec<Insn>,
+    labels: Vec<Option<usize>>,
+    fixups: Vec<(usize, Label)>,
+}
+
+impl Asm {
+    fn emit(&mut self, code: u8, dst: u8, src: u8, off: i16, imm: i32) {
+        self.insns.push(Insn {
+            code,
+            regs: (src << 4) | dst,
+            off,
+            imm,
+        });
+    }
+
+    /// New label, bound later with [`Self::bind`]
+    pub fn label(&mut self) -> Label {
+        self.labels.push(None);
+        Label(self.labels.len() - 1)
+    }
+
+    /// Point `label` at the next instruction
+    pub fn bind(&mut self, label: Label) {
+        self.labels[label.0] = Some(self.insns.len());
+    }
+
+    pub fn mov_imm(&mut self, dst: u8, imm: i32) {
+        self.emit(BPF_ALU64 | BPF_MOV | BPF_K, dst, 0, 0, imm);
+    }
+
+    pub fn mov(&mut self, dst: u8, src: u8) {
+        self.emit(BPF_ALU64 | BPF_MOV | BPF_X, dst, src, 0, 0);
+    }
+
+    pub fn add_imm(&mut self, dst: u8, imm: i32) {
+        self.emit(BPF_ALU64 | BPF_ADD | BPF_K, dst, 0, 0, imm);
+    }
+
+    pub fn add(&mut self, dst: u8, src: u8) {
+        self.emit(BPF_ALU64 | BPF_ADD | BPF_X, dst, src, 0, 0);
+    }
+
+    pub fn and_imm(&mut self, dst: u8, imm: i32) {
+        self.emit(BPF_ALU64 | BPF_AND | BPF_K, dst, 0, 0, imm);
+    }
+
+    pub fn rsh_imm(&mut self, dst: u8, imm: i32) {
+        self.emit(BPF_ALU64 | BPF_RSH | BPF_K, dst, 0, 0, imm);
+    }
+
+    pub fn xor_imm(&mut self, dst: u8, imm: i32) {
+        self.emit(BPF_ALU64 | BPF_XOR | BPF_K, dst, 0, 0, imm);
+    }
+
+    /// Convert the low `bits` of `dst` from host to network order,
+    /// zero-extending the rest
+    pub fn to_be(&mut self, dst: u8, bits: i32) {
+        self.emit(BPF_ALU | BPF_END | BPF_TO_BE, dst, 0, 0, bits);
+    }
+
+    /// `dst = *(size *)(src + off)`
+    pub fn load(&mut self, size: u8, dst: u8, src: u8, off: i16) {
+        self.emit(BPF_LDX | size | BPF_MEM, dst, src, off, 0);
+    }
+
+    /// `*(size *)(dst + off) = src`
+    pub fn store(&mut self, size: u8, dst: u8, off: i16, src: u8) {
+        self.emit(BPF_STX | size | BPF_MEM, dst, src, off, 0);
+    }
+
+    /// `*(size *)(dst + off) = imm`
+    pub fn store_imm(&mut self, size: u8, dst: u8, off: i16, imm: i32) {
+        self.emit(BPF_ST | size | BPF_MEM, dst, 0, off, imm);
+    }
+
+    /// `lock *(u64 *)(dst + off) += src`
+    pub fn atomic_add64(&mut self, dst: u8, off: i16, src: u8) {
+        self.emit(
+            BPF_STX | BPF_DW | BPF_ATOMIC,
+            dst,
+            src,
+            off,
+            i32::from(BPF_ADD),
+        );
+    }
+
+    /// Load map descriptor `fd` into `dst` (two instruction slots)
+    pub fn load_map_fd(&mut self, dst: u8, fd: i32) {
+        self.emit(BPF_LD | BPF_DW | BPF_IMM, dst, BPF_PSEUDO_MAP_FD, 0, fd);
+        self.emit(0, 0, 0, 0, 0);
+    }
+
+    /// `if dst <op> imm goto target`
+    pub fn jump_imm(&mut self, op: u8, dst: u8, imm: i32, target: Label) {
+        self.fixups.push((self.insns.len(), target));
+        self.emit(BPF_JMP | op | BPF_K, dst, 0, 0, imm);
+    }
+
+    /// `if dst <op> src goto target`
+    pub fn jump(&mut self, op: u8, dst: u8, src: u8, target: Label) {
+        self.fixups.push((self.insns.len(), target));
+        self.emit(BPF_JMP | op | BPF_X, dst, src, 0, 0);
+    }
+
+    pub fn goto(&mut self, target: Label) {
+        self.fixups.push((self.insns.len(), target));
+        self.emit(BPF_JMP | BPF_JA, 0, 0, 0, 0);
+    }
+
+    pub fn call(&mut self, helper: i32) {
+        self.emit(BPF_JMP | BPF_CALL, 0, 0, 0, helper);
+    }
+
+    pub fn exit(&mut self) {
+        self.emit(BPF_JMP | BPF_EXIT, 0, 0, 0, 0);
+    }
+
+    /// Resolve jumps. Panics on an unbound label: that is an assembler bug,
+    /// not a runtime condition.
+    pub fn finish(mut self) -> Vec<Insn> {
+        for (at, label) in std::mem::take(&mut self.fixups) {
+            let target = self.labels[label.0].expect("jump to unbound label");
+            self.insns[at].off = (target as isize - at as isize - 1) as i16;
+        }
+        self.insns
+    }
+}
+
+// Frame layout: Ethernet, IPv4 without options, UDP, RTP.
+const ETH_TYPE: i16 = 12;
+const IP: i16 = 14;
+const IP_VERSION_IHL: i16 = IP;
+const IP_TOTAL_LEN: i16 = IP + 2;
+const IP_FRAGMENT: i16 = IP + 6;
+const IP_TTL: i16 = IP + 8;
+const IP_PROTOCOL: i16 = IP + 9;
+const IP_CHECKSUM: i16 = IP + 10;
+const IP_SADDR: i16 = IP + 12;
+const IP_DADDR: i16 = IP + 16;
+const UDP: i16 = IP + 20;
+const UDP_SPORT: i16 = UDP;
+const UDP_DPORT: i16 = UDP + 2;
+const UDP_CHECKSUM: i16 = UDP + 6;
+const RTP: i16 = UDP + 8;
+const RTP_PAYLOAD_TYPE: i16 = RTP + 1;
+const RTP_SEQUENCE: i16 = RTP + 2;
+const RTP_TIMESTAMP: i16 = RTP + 4;
+const RTP_SSRC: i16 = RTP + 8;
+/// Shortest frame the program rewrites
+const MIN_FRAME: i32 = RTP as i32 + 12;
+
+// `struct bpf_fib_lookup` (64 bytes) on the stack.
+const FIB: i16 = -72;
+const FIB_FAMILY: i16 = FIB;
+const FIB_L4_PROTOCOL: i16 = FIB + 1;
+const FIB_SPORT: i16 = FIB + 2;
+const FIB_DPORT: i16 = FIB + 4;
+const FIB_TOT_LEN: i16 = FIB + 6;
+const FIB_IFINDEX: i16 = FIB + 8;
+const FIB_IPV4_SRC: i16 = FIB + 16;
+const FIB_IPV4_DST: i16 = FIB + 32;
+const FIB_SMAC: i16 = FIB + 52;
+const FIB_DMAC: i16 = FIB + 58;
+const FIB_SIZE: i32 = 64;
+/// Rule map key on the stack
+const KEY: i16 = -4;
+
+const ETH_P_IP: i32 = 0x0800;
+const IPPROTO_UDP: i32 = 17;
+const AF_INET: i32 = 2;
+const ETH_HLEN: i32 = 14;
+/// TTL of relayed packets, as if the relay had originated them
+const RELAY_TTL: i32 = 64;
+
+fn field(offset: usize) -> i16 {
+    offset as i16
+}
+
+/// Assemble the relay program against rule map descriptor `rules`
+pub(super) fn relay_program(rules: i32) -> Vec<Insn> {
+    let mut a = Asm::default();
+    let pass = a.label();
+
+    // r6 = ctx, r7 = data, r8 = data_end
+    a.mov(R6, R1);
+    a.load(BPF_W, R7, R6, 0);
+    a.load(BPF_W, R8, R6, 4);
+    a.mov(R2, R7);
+    a.add_imm(R2, MIN_FRAME);
+    a.jump(BPF_JGT, R2, R8, pass);
+
+    // Ethernet + IPv4 without options + unfragmented UDP + RTP v2.
+    a.load(BPF_H, R2, R7, ETH_TYPE);
+    a.to_be(R2, 16);
+    a.jump_imm(BPF_JNE, R2, ETH_P_IP, pass);
+    a.load(BPF_B, R2, R7, IP_VERSION_IHL);
+    a.jump_imm(BPF_JNE, R2, 0x45, pass);
+    a.load(BPF_B, R2, R7, IP_PROTOCOL);
+    a.jump_imm(BPF_JNE, R2, IPPROTO_UDP, pass);
+    a.load(BPF_H, R2, R7, IP_FRAGMENT);
+    a.to_be(R2, 16);
+    a.and_imm(R2, 0x3fff);
+    a.jump_imm(BPF_JNE, R2, 0, pass);
+    a.load(BPF_B, R2, R7, RTP);
+    a.rsh_imm(R2, 6);
+    a.jump_imm(BPF_JNE, R2, 2, pass);
+
+    // RTCP multiplexed on the RTP port (RFC 5761 §4) stays in userspace.
+    let rtp = a.label();
+    a.load(BPF_B, R2, R7, RTP_PAYLOAD_TYPE);
+    a.jump_imm(BPF_JLT, R2, 192, rtp);
+    a.jump_imm(BPF_JLE, R2, 223, pass);
+    a.bind(rtp);
+
+    // r9 = rule for the destination port
+    a.load(BPF_H, R2, R7, UDP_DPORT);
+    a.to_be(R2, 16);
+    a.store(BPF_W, R10, KEY, R2);
+    a.load_map_fd(R1, rules);
+    a.mov(R2, R10);
+    a.add_imm(R2, i32::from(KEY));
+    a.call(HELPER_MAP_LOOKUP_ELEM);
+    a.jump_imm(BPF_JEQ, R0, 0, pass);
+    a.mov(R9, R0);
+
+    let any_local = a.label();
+    a.load(BPF_W, R2, R9, field(offset_of!(RuleValue, local_ip)));
+    a.jump_imm(BPF_JEQ, R2, 0, any_local);
+    a.load(BPF_W, R3, R7, IP_DADDR);
+    a.jump(BPF_JNE, R2, R3, pass);
+    a.bind(any_local);
+    a.load(BPF_W, R2, R7, RTP_SSRC);
+    a.load(BPF_W, R3, R9, field(offset_of!(RuleValue, source_ssrc)));
+    a.jump(BPF_JNE, R2, R3, pass);
+    a.load(BPF_B, R2, R7, RTP_PAYLOAD_TYPE);
+    a.and_imm(R2, 0x7f);
+    a.load(
+        BPF_B,
+        R3,
+        R9,
+        field(offset_of!(RuleValue, passed_payload_type)),
+    );
+    a.jump(BPF_JEQ, R2, R3, pass);
+
+    // Route and next hop for the rewritten packet.
+    a.mov_imm(R2, 0);
+    for off in (0..FIB_SIZE as i16).step_by(8) {
+        a.store(BPF_DW, R10, FIB + off, R2);
+    }
+    a.store_imm(BPF_B, R10, FIB_FAMILY, AF_INET);
+    a.store_imm(BPF_B, R10, FIB_L4_PROTOCOL, IPPROTO_UDP);
+    a.load(BPF_H, R2, R9, field(offset_of!(RuleValue, src_port)));
+    a.store(BPF_H, R10, FIB_SPORT, R2);
+    a.load(BPF_H, R2, R9, field(offset_of!(RuleValue, dst_port)));
+    a.store(BPF_H, R10, FIB_DPORT, R2);
+    a.load(BPF_H, R2, R7, IP_TOTAL_LEN);
+    a.to_be(R2, 16);
+    a.store(BPF_H, R10, FIB_TOT_LEN, R2);
+    a.load(BPF_W, R2, R9, field(offset_of!(RuleValue, egress_ifindex)));
+    a.store(BPF_W, R10, FIB_IFINDEX, R2);
+    a.load(BPF_W, R2, R9, field(offset_of!(RuleValue, src_ip)));
+    a.store(BPF_W, R10, FIB_IPV4_SRC, R2);
+    a.load(BPF_W, R2, R9, field(offset_of!(RuleValue, dst_ip)));
+    a.store(BPF_W, R10, FIB_IPV4_DST, R2);
+    a.mov(R1, R6);
+    a.mov(R2, R10);
+    a.add_imm(R2, i32::from(FIB));
+    a.mov_imm(R3, FIB_SIZE);
+    a.mov_imm(R4, BPF_FIB_LOOKUP_OUTPUT);
+    a.call(HELPER_FIB_LOOKUP);
+    a.jump_imm(BPF_JNE, R0, 0, pass);
+
+    // Ethernet: stack reads are aligned, so the MACs move 16 bits at a time.
+    for i in 0..3 {
+        a.load(BPF_H, R2, R10, FIB_DMAC + 2 * i);
+        a.store(BPF_H, R7, 2 * i, R2);
+        a.load(BPF_H, R2, R10, FIB_SMAC + 2 * i);
+        a.store(BPF_H, R7, 6 + 2 * i, R2);
+    }
+
+    // IPv4: addresses, TTL, header checksum (RFC 1071; the one's
+    // complement sum is byte-order independent, so raw loads do).
+    a.load(BPF_W, R2, R9, field(offset_of!(RuleValue, src_ip)));
+    a.store(BPF_W, R7, IP_SADDR, R2);
+    a.load(BPF_W, R2, R9, field(offset_of!(RuleValue, dst_ip)));
+    a.store(BPF_W, R7, IP_DADDR, R2);
+    a.mov_imm(R2, RELAY_TTL);
+    a.store(BPF_B, R7, IP_TTL, R2);
+    a.mov_imm(R2, 0);
+    a.store(BPF_H, R7, IP_CHECKSUM, R2);
+    a.mov_imm(R3, 0);
+    for word in 0..10 {
+        a.load(BPF_H, R2, R7, IP + 2 * word);
+        a.add(R3, R2);
+    }
+    for _ in 0..2 {
+        a.mov(R2, R3);
+        a.rsh_imm(R2, 16);
+        a.and_imm(R3, 0xffff);
+        a.add(R3, R2);
+    }
+    a.xor_imm(R3, 0xffff);
+    a.store(BPF_H, R7, IP_CHECKSUM, R3);
+
+    // UDP: ports; a zero checksum means none (RFC 768).
+    a.load(BPF_H, R2, R9, field(offset_of!(RuleValue, src_port)));
+    a.store(BPF_H, R7, UDP_SPORT, R2);
+    a.load(BPF_H, R2, R9, field(offset_of!(RuleValue, dst_port)));
+    a.store(BPF_H, R7, UDP_DPORT, R2);
+    a.mov_imm(R2, 0);
+    a.store(BPF_H, R7, UDP_CHECKSUM, R2);
+
+    // RTP: sequence and timestamp shifted into the outbound leg's space.
+    a.load(BPF_H, R2, R7, RTP_SEQUENCE);
+    a.to_be(R2, 16);
+    a.load(BPF_H, R3, R9, field(offset_of!(RuleValue, sequence_offset)));
+    a.add(R2, R3);
+    a.store(BPF_H, R9, field(offset_of!(RuleValue, last_sequence)), R2);
+    a.to_be(R2, 16);
+    a.store(BPF_H, R7, RTP_SEQUENCE, R2);
+    a.load(BPF_W, R2, R7, RTP_TIMESTAMP);
+    a.to_be(R2, 32);
+    a.load(
+        BPF_W,
+        R3,
+        R9,
+        field(offset_of!(RuleValue, timestamp_offset)),
+    );
+    a.add(R2, R3);
+    a.store(BPF_W, R9, field(offset_of!(RuleValue, last_timestamp)), R2);
+    a.to_be(R2, 32);
+    a.store(BPF_W, R7, RTP_TIMESTAMP, R2);
+    a.load(BPF_W, R2, R9, field(offset_of!(RuleValue, ssrc)));
+    a.store(BPF_W, R7, RTP_SSRC, R2);
+
+    a.mov_imm(R2, 1);
+    a.atomic_add64(R9, field(offset_of!(RuleValue, packets)), R2);
+    a.load(BPF_H, R2, R7, IP_TOTAL_LEN);
+    a.to_be(R2, 16);
+    a.add_imm(R2, ETH_HLEN);
+    a.atomic_add64(R9, field(offset_of!(RuleValue, bytes)), R2);
+
+    a.load(BPF_W, R1, R10, FIB_IFINDEX);
+    a.mov_imm(R2, 0);
+    a.call(HELPER_REDIRECT);
+    a.exit();
+
+    a.bind(pass);
+    a.mov_imm(R0, XDP_PASS);
+    a.exit();
+    a.finish()
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn rule_value_matches_the_program_layout() {
+        assert_eq!(std::mem::size_of::<RuleValue>(), 64);
+        assert_eq!(offset_of!(RuleValue, source_ssrc), 20);
+        assert_eq!(offset_of!(RuleValue, egress_ifindex), 36);
+        assert_eq!(offset_of!(RuleValue, packets) % 8, 0);
+        assert_eq!(offset_of!(RuleValue, bytes) % 8, 0);
+    }
+
+    #[test]
+    fn jumps_resolve_relative_to_the_next_instruction() {
+        let mut a = Asm::default();
+        let end = a.label();
+        let back = a.label();
+        a.bind(back);
+        a.jump_imm(BPF_JEQ, R1, 0, end);
+        a.mov_imm(R0, 1);
+        a.goto(back);
+        a.bind(end);
+        a.exit();
+        let insns = a.finish();
+        assert_eq!(insns[0].off, 2);
+        assert_eq!(insns[2].off, -3);
+        assert_eq!(insns[0].regs, R1);
+    }
+
+    #[test]
+    fn relay_program_is_well_formed() {
+        let insns = relay_program(42);
+        let exits = insns
+            .iter()
+            .filter(|i| i.code == BPF_JMP | BPF_EXIT)
+            .count();
+        assert_eq!(exits, 2);
+        assert_eq!(insns.last().unwrap().code, BPF_JMP | BPF_EXIT);
+
+        // The map descriptor is the only pseudo load, and every jump lands
+        // inside the program.
+        let map_loads: Vec<_> = insns
+            .iter()
+            .filter(|i| i.code == BPF_LD | BPF_DW | BPF_IMM)
+            .collect();
+        assert_eq!(map_loads.len(), 1);
+        assert_eq!(map_loads[0].imm, 42);
+        assert_eq!(map_loads[0].regs >> 4, BPF_PSEUDO_MAP_FD);
+        for (at, insn) in insns.iter().enumerate() {
+            let class = insn.code & 0x07;
+            let op = insn.code & 0xf0;
+            if class == BPF_JMP && op != BPF_CALL && op != BPF_EXIT {
+                let target = at as isize + 1 + insn.off as isize;
+                assert!(target > at as isize && (target as usize) < insns.len());
+            }
+        }
+    }
+}
@@ -0,0 +1,326 @@
+//! The handful of `bpf(2)` commands the XDP relay needs
+//!
+//! Attribute layouts are the leading fields of `union bpf_attr` for each
+//! command; the kernel zero-extends a short attribute, so only the fields
+//! used here are declared. Every file descriptor the kernel hands back is
+//! wrapped in an `OwnedFd`, which is all the lifetime management BPF
+//! objects need: a map or program lives while a descriptor (or a program
+//! referencing the map) does, and an XDP link detaches when its last
+//! descriptor closes.
+
+use std::ffi::CString;
+use std::io;
+use std::mem::size_of;
+use std::os::fd::{AsRawFd, FromRawFd, OwnedFd};
+
+use libc::{c_int, c_long, c_void};
+
+use super::program::Insn;
+
+// From <linux/bpf.h>; spelled out because libc does not export them.
+const BPF_MAP_CREATE: c_int = 0;
+const BPF_MAP_LOOKUP_ELEM: c_int = 1;
+const BPF_MAP_UPDATE_ELEM: c_int = 2;
+const BPF_MAP_DELETE_ELEM: c_int = 3;
+const BPF_PROG_LOAD: c_int = 5;
+#[cfg(test)]
+const BPF_PROG_TEST_RUN: c_int = 10;
+const BPF_LINK_CREATE: c_int = 28;
+
+const BPF_MAP_TYPE_HASH: u32 = 1;
+const BPF_PROG_TYPE_XDP: u32 = 6;
+const BPF_XDP: u32 = 37;
+const BPF_ANY: u64 = 0;
+
+/// `XDP_FLAGS_SKB_MODE`: generic XDP, run from the network stack
+pub(super) const XDP_FLAGS_SKB_MODE: u32 = 1 << 1;
+/// `XDP_FLAGS_DRV_MODE`: native XDP, run by the driver
+pub(super) const XDP_FLAGS_DRV_MODE: u32 = 1 << 2;
+
+/// Verifier log kept when a program is rejected
+const VERIFIER_LOG_SIZE: usize = 64 * 1024;
+
+#[repr(C)]
+#[derive(Default)]
+struct MapCreateAttr {
+    map_type: u32,
+    key_size: u32,
+    value_size: u32,
+    max_entries: u32,
+    map_flags: u32,
+    inner_map_fd: u32,
+    numa_node: u32,
+    map_name: [u8; 16],
+}
+
+#[repr(C)]
+#[derive(Default)]
+struct MapElemAttr {
+    map_fd: u32,
+    _pad: u32,
+    key: u64,
+    value: u64,
+    flags: u64,
+}
+
+#[repr(C)]
+#[derive(Default)]
+struct ProgLoadAttr {
+    prog_type: u32,
+    insn_cnt: u32,
+    insns: u64,
+    license: u64,
+    log_level: u32,
+    log_size: u32,
+    log_buf: u64,
+    kern_version: u32,
+    prog_flags: u32,
+    prog_name: [u8; 16],
+    prog_ifindex: u32,
+    expected_attach_type: u32,
+}
+
+#[repr(C)]
+#[derive(Default)]
+struct LinkCreateAttr {
+    prog_fd: u32,
+    target_ifindex: u32,
+    attach_type: u32,
+    flags: u32,
+}
+
+#[cfg(test)]
+#[repr(C)]
+#[derive(Default)]
+struct TestRunAttr {
+    prog_fd: u32,
+    retval: u32,
+    data_size_in: u32,
+    data_size_out: u32,
+    data_in: u64,
+    data_out: u64,
+    repeat: u32,
+    duration: u32,
+}
+
+fn bpf<T>(cmd: c_int, attr: &mut T) -> io::Result<c_long> {
+    // SAFETY: `attr` is a live, fully initialised `#[repr(C)]` prefix of
+    // `union bpf_attr` for `cmd`, and `size_of::<T>()` is its length. Any
+    // pointers inside it reference buffers the caller keeps alive.
+    let rc = unsafe {
+        libc::syscall(
+            libc::SYS_bpf,
+            cmd,
+            attr as *mut T as *mut c_void,
+            size_of::<T>(),
+        )
+    };
+    if rc < 0 {
+        Err(io::Error::last_os_error())
+    } else {
+        Ok(rc)
+    }
+}
+
+fn owned_fd(rc: c_long) -> OwnedFd {
+    // SAFETY: the kernel returned a new descriptor that nothing else owns.
+    unsafe { OwnedFd::from_raw_fd(rc as c_int) }
+}
+
+fn object_name(name: &str) -> [u8; 16] {
+    // BPF object names are at most 15 bytes plus NUL.
+    let mut out = [0u8; 16];
+    for (dst, src) in out.iter_mut().zip(name.bytes().take(15)) {
+        *dst = src;
+    }
+    out
+}
+
+/// Create a hash map of `max_entries` `K` -> `V` entries
+pub(super) fn hash_map_create<K, V>(name: &str, max_entries: u32) -> io::Result<OwnedFd> {
+    let mut attr = MapCreateAttr {
+        map_type: BPF_MAP_TYPE_HASH,
+        key_size: size_of::<K>() as u32,
+        value_size: size_of::<V>() as u32,
+        max_entries,
+        map_name: object_name(name),
+        ..Default::default()
+    };
+    bpf(BPF_MAP_CREATE, &mut attr).map(owned_fd)
+}
+
+/// Insert or replace `key`
+pub(super) fn map_update<K, V>(map: &OwnedFd, key: &K, value: &V) -> io::Result<()> {
+    let mut attr = MapElemAttr {
+        map_fd: map.as_raw_fd() as u32,
+        key: key as *const K as u64,
+        value: value as *const V as u64,
+        flags: BPF_ANY,
+        ..Default::default()
+    };
+    bpf(BPF_MAP_UPDATE_ELEM, &mut attr).map(drop)
+}
+
+/// Copy out the value stored under `key`, if any
+pub(super) fn map_lookup<K, V: Default>(map: &OwnedFd, key: &K) -> io::Result<Option<V>> {
+    let mut value = V::default();
+    let mut attr = MapElemAttr {
+        map_fd: map.as_raw_fd() as u32,
+        key: key as *const K as u64,
+        value: &mut value as *mut V as u64,
+        ..Default::default()
+    };
+    match bpf(BPF_MAP_LOOKUP_ELEM, &mut attr) {
+        Ok(_) => Ok(Some(value)),
+        Err(e) if e.raw_os_error() == Some(libc::ENOENT) => Ok(None),
+        Err(e) => Err(e),
+    }
+}
+
+/// Delete `key`; `false` if it was not present
+pub(super) fn map_delete<K>(map: &OwnedFd, key: &K) -> io::Result<bool> {
+    let mut attr = MapElemAttr {
+        map_fd: map.as_raw_fd() as u32,
+        key: key as *const K as u64,
+        ..Default::default()
+    };
+    match bpf(BPF_MAP_DELETE_ELEM, &mut attr) {
+        Ok(_) => Ok(true),
+        Err(e) if e.raw_os_error() == Some(libc::ENOENT) => Ok(false),
+        Err(e) => Err(e),
+    }
+}
+
+/// Load an XDP program. A verifier rejection is retried once with logging
+/// enabled so the error carries the tail of the verifier log.
+pub(super) fn xdp_prog_load(name: &str, insns: &[Insn], license: &str) -> io::Result<OwnedFd> {
+    let license = CString::new(license).expect("license has no NUL");
+    let mut attr = ProgLoadAttr {
+        prog_type: BPF_PROG_TYPE_XDP,
+        insn_cnt: insns.len() as u32,
+        insns: insns.as_ptr() as u64,
+        license: license.as_ptr() as u64,
+        prog_name: object_name(name),
+        expected_attach_type: BPF_XDP,
+        ..Default::default()
+    };
+    match bpf(BPF_PROG_LOAD, &mut attr) {
+        Ok(fd) => Ok(owned_fd(fd)),
+        Err(e)
+            if e.raw_os_error() == Some(libc::EACCES) || e.raw_os_error() == Some(libc::EINVAL) =>
+        {
+            let mut log = vec![0u8; VERIFIER_LOG_SIZE];
+            attr.log_level = 1;
+            attr.log_size = log.len() as u32;
+            attr.log_buf = log.as_mut_ptr() as u64;
+            match bpf(BPF_PROG_LOAD, &mut attr) {
+                Ok(fd) => Ok(owned_fd(fd)),
+                Err(_) => {
+                    let end = log.iter().position(|&b| b == 0).unwrap_or(log.len());
+                    let text = String::from_utf8_lossy(&log[..end]);
+                    let tail: Vec<&str> = text.lines().rev().take(8).collect();
+                    let tail: Vec<&str> = tail.into_iter().rev().collect();
+                    Err(io::Error::new(
+                        e.kind(),
+                        format!("{} (verifier: {})", e, tail.join(" | ")),
+                    ))
+                }
+            }
+        }
+        Err(e) => Err(e),
+    }
+}
+
+/// Attach `prog` to interface `ifindex` through a BPF link (Linux 5.9+)
+pub(super) fn xdp_link_create(prog: &OwnedFd, ifindex: u32, flags: u32) -> io::Result<OwnedFd> {
+    let mut attr = LinkCreateAttr {
+        prog_fd: prog.as_raw_fd() as u32,
+        target_ifindex: ifindex,
+        attach_type: BPF_XDP,
+        flags,
+    };
+    bpf(BPF_LINK_CREATE, &mut attr).map(owned_fd)
+}
+
+/// Run `prog` once over `frame` (`BPF_PROG_TEST_RUN`); returns the XDP
+/// action and leaves `frame` holding the packet as the program left it
+#[cfg(test)]
+pub(super) fn xdp_test_run(prog: &OwnedFd, frame: &mut Vec<u8>) -> io::Result<u32> {
+    let input = frame.clone();
+    frame.resize(input.len() + 256, 0);
+    let mut attr = TestRunAttr {
+        prog_fd: prog.as_raw_fd() as u32,
+        data_size_in: input.len() as u32,
+        data_size_out: frame.len() as u32,
+        data_in: input.as_ptr() as u64,
+        data_out: frame.as_mut_ptr() as u64,
+        repeat: 1,
+        ..Default::default()
+    };
+    bpf(BPF_PROG_TEST_RUN, &mut attr)?;
+    frame.truncate(attr.data_size_out as usize);
+    Ok(attr.retval)
+}
+
+/// Index of network interface `name` in the calling thread's namespace
+pub(super) fn interface_index(name: &str) -> io::Result<u32> {
+    let c_name = CString::new(name)
+        .map_err(|_| io::Error::new(io::ErrorKind::InvalidInput, "interface name has a NUL"))?;
+    // SAFETY: `c_name` is a valid NUL-terminated string.
+    let index = unsafe { libc::if_nametoindex(c_name.as_ptr()) };
+    if index == 0 {
+        Err(io::Error::last_os_error())
+    } else {
+        Ok(index)
+    }
+}
+
+/// Name and index of the interface that owns IPv4 address `addr`
+pub(super) fn interface_with_address(
+    addr: std::net::Ipv4Addr,
+) -> io::Result<Option<(String, u32)>> {
+    let mut list: *mut libc::ifaddrs = std::ptr::null_mut();
+    // SAFETY: on success `list` points at a list we free below.
+    if unsafe { libc::getifaddrs(&mut list) } != 0 {
+        return Err(io::Error::last_os_error());
+    }
+    let mut found = None;
+    let mut entry = list;
+    while !entry.is_null() {
+        // SAFETY: `entry` is a node of the list returned by getifaddrs.
+        let ifa = unsafe { &*entry };
+        entry = ifa.ifa_next;
+        if ifa.ifa_addr.is_null() {
+            continue;
+        }
+        // SAFETY: `ifa_addr` is non-null and at least a `sockaddr`.
+        if c_int::from(unsafe { (*ifa.ifa_addr).sa_family }) != libc::AF_INET {
+            continue;
+        }
+        // SAFETY: AF_INET entries carry a `sockaddr_in`.
+        let sin = unsafe { &*(ifa.ifa_addr as *const libc::sockaddr_in) };
+        if u32::from_be(sin.sin_addr.s_addr) == u32::from(addr) {
+            // SAFETY: `ifa_name` is a NUL-terminated interface name.
+            let (name, index) = unsafe {
+                (
+                    std::ffi::CStr::from_ptr(ifa.ifa_name),
+                    libc::if_nametoindex(ifa.ifa_name),
+                )
+            };
+            if index != 0 {
+                found = Some((name.to_string_lossy().into_owned(), index));
+                break;
+            }
+        }
+    }
+    // SAFETY: `list` came from getifaddrs and is freed exactly once.
+    unsafe { libc::freeifaddrs(list) };
+    Ok(found)
+}
+
+/// Whether IPv4 forwarding is enabled on interface `name`
+/// (`net.ipv4.conf.<name>.forwarding`)
+pub(super) fn ipv4_forwarding(name: &str) -> io::Result<bool> {
+    let path = format!("/proc/sys/net/ipv4/conf/{}/forwarding", name);
+    Ok(std::fs::read_to_string(path)?.trim() != "0")
+}
@@ -0,0 +1,246 @@
+//! Kernel relay end to end over veth pairs.
+//!
+//! Three network namespaces: two peers and a relay between them.
+//!
+//! ```text
+//! peer A (10.201.1.2) ──veth── relay [leg A 10.201.1.1 ══XDP══ leg B 10.201.2.1] ──veth── peer B (10.201.2.2)
+//! ```
+//!
+//! A bridge forwarder on leg A relays to leg B and is offloaded to an
+//! `XdpRelay` attached (generic mode) to both relay-side veths. Peer B
+//! must see one continuous RTP stream whichever path each packet took,
+//! RTCP must stay on leg A, and a new source must continue the stream.
+//!
+//! The relay's veths forward IPv4, as the kernel route lookup requires.
+//! Needs root for namespaces and XDP:
+//! `cargo test -p rvoip-rtp-core --test xdp_relay_veth -- --ignored`
+
+#![cfg(target_os = "linux")]
+
+use std::fs::File;
+use std::net::{SocketAddr, UdpSocket};
+use std::os::fd::AsRawFd;
+use std::process::Command;
+use std::sync::atomic::AtomicU16;
+use std::sync::Arc;
+use std::time::Duration;
+
+use rvoip_rtp_core::transport::{UdpRtpTransport, XdpAttachMode, XdpRelay};
+use rvoip_rtp_core::{RtpTransport, RtpTransportConfig};
+
+const PACKETS: u16 = 50;
+
+struct Topology {
+    prefix: String,
+}
+
+impl Topology {
+    fn ns(&self, role: &str) -> String {
+        format!("{}{}", self.prefix, role)
+    }
+
+    fn create() -> Self {
+        let topology = Self {
+            prefix: format!("rvx{}", std::process::id()),
+        };
+        let (relay, a, b) = (topology.ns("r"), topology.ns("a"), topology.ns("b"));
+        for ns in [&relay, &a, &b] {
+            ip(&format!("netns add {}", ns));
+            ip(&format!("-n {} link set lo up", ns));
+        }
+        for (side, net) in [("a", 1), ("b", 2)] {
+            let peer = topology.ns(side);
+            ip(&format!(
+                "link add rv{side} netns {relay} type veth peer name pv{side} netns {peer}"
+            ));
+            ip(&format!(
+                "-n {relay} addr add 10.201.{net}.1/24 dev rv{side}"
+            ));
+            ip(&format!(
+                "-n {peer} addr add 10.201.{net}.2/24 dev pv{side}"
+            ));
+            ip(&format!("-n {relay} link set rv{side} up"));
+            sysctl(&relay, &format!("net.ipv4.conf.rv{side}.forwarding=1"));
+            ip(&format!("-n {peer} link set pv{side} up"));
+        }
+        topology
+    }
+}
+
+impl Drop for Topology {
+    fn drop(&mut self) {
+        // Deleting a namespace removes the veth ends inside it.
+        for role in ["r", "a", "b"] {
+            let _ = Command::new("ip")
+                .args(["netns", "del", &self.ns(role)])
+                .status();
+        }
+    }
+}
+
+fn ip(args: &str) {
+    let status = Command::new("ip")
+        .args(args.split_whitespace())
+        .status()
+        .expect("run ip");
+    assert!(status.success(), "ip {} failed", args);
+}
+
+fn sysctl(ns: &str, setting: &str) {
+    let status = Command::new("ip")
+        .args(["netns", "exec", ns, "sysctl", "-qw", setting])
+        .status()
+        .expect("run sysctl");
+    assert!(status.success(), "sysctl {} failed", setting);
+}
+
+/// Run `f` on a thread inside network namespace `ns`. Sockets it creates
+/// stay in `ns` after it returns.
+fn in_netns<T: Send>(ns: &str, f: impl FnOnce() -> T + Send) -> T {
+    std::thread::scope(|scope| {
+        scope
+            .spawn(|| {
+                let handle = File::open(format!("/var/run/netns/{}", ns)).expect("open netns");
+                // SAFETY: plain syscall on a valid namespace descriptor; it
+                // only affects this (scoped) thread.
+                let rc = unsafe { libc::setns(handle.as_raw_fd(), libc::CLONE_NEWNET) };
+                assert_eq!(rc, 0, "setns: {}", std::io::Error::last_os_error());
+                f()
+            })
+            .join()
+            .expect("namespace thread")
+    })
+}
+
+fn rtp(payload_type: u8, sequence: u16, timestamp: u32, ssrc: u32) -> Vec<u8> {
+    let mut packet = vec![0u8; 12 + 160];
+    packet[0] = 0x80;
+    packet[1] = payload_type;
+    packet[2..4].copy_from_slice(&sequence.to_be_bytes());
+    packet[4..8].copy_from_slice(&timestamp.to_be_bytes());
+    packet[8..12].copy_from_slice(&ssrc.to_be_bytes());
+    packet
+}
+
+/// (sequence, timestamp, ssrc) of every RTP packet until `count` arrived
+fn receive(socket: &UdpSocket, count: usize, from: SocketAddr) -> Vec<(u16, u32, u32)> {
+    let mut buf = [0u8; 2048];
+    let mut seen = Vec::new();
+    while seen.len() < count {
+        let (n, source) = socket.recv_from(&mut buf).expect("relayed packet");
+        assert_eq!(source, from);
+        assert_eq!(n, 12 + 160);
+        seen.push((
+            u16::from_be_bytes([buf[2], buf[3]]),
+            u32::from_be_bytes([buf[4], buf[5], buf[6], buf[7]]),
+            u32::from_be_bytes([buf[8], buf[9], buf[10], buf[11]]),
+        ));
+    }
+    seen.sort();
+    seen
+}
+
+fn config(local: &str) -> RtpTransportConfig {
+    RtpTransportConfig {
+        local_rtp_addr: local.parse().unwrap(),
+        local_rtcp_addr: None,
+        symmetric_rtp: false,
+        rtcp_mux: true,
+        session_id: None,
+        use_port_allocator: false,
+        buffer_config: Default::default(),
+    }
+}
+
+#[test]
+#[ignore = "needs root: creates network namespaces and attaches XDP programs"]
+fn bridged_rtp_is_relayed_in_the_kernel() {
+    // SAFETY: geteuid has no preconditions.
+    if unsafe { libc::geteuid() } != 0 {
+        eprintln!("skipping: not root");
+        return;
+    }
+    let topology = Topology::create();
+    let peer_a = in_netns(&topology.ns("a"), || {
+        UdpSocket::bind("10.201.1.2:0").unwrap()
+    });
+    let peer_b = in_netns(&topology.ns("b"), || {
+        UdpSocket::bind("10.201.2.2:0").unwrap()
+    });
+    peer_b
+        .set_read_timeout(Some(Duration::from_secs(2)))
+        .unwrap();
+    let peer_b_addr = peer_b.local_addr().unwrap();
+
+    in_netns(&topology.ns("r"), || {
+        // Worker threads inherit the relay namespace from this thread.
+        let runtime = tokio::runtime::Builder::new_multi_thread()
+            .worker_threads(2)
+            .enable_all()
+            .build()
+            .unwrap();
+        runtime.block_on(async {
+            let leg_a = UdpRtpTransport::new(config("10.201.1.1:0")).await.unwrap();
+            let leg_b = UdpRtpTransport::new(config("10.201.2.1:0")).await.unwrap();
+            leg_b.set_remote_rtp_addr(peer_b_addr).await;
+            let leg_a_addr = leg_a.local_rtp_addr().unwrap();
+            let leg_b_addr = leg_b.local_rtp_addr().unwrap();
+
+            let relay = Arc::new(
+                XdpRelay::attach(&["rva", "rvb"], XdpAttachMode::Generic, 64)
+                    .expect("attach relay"),
+            );
+            let sequence = Arc::new(AtomicU16::new(4000));
+            let mut guard =
+                leg_a.install_forwarder(leg_b.forward_target(0x0b0b_0b0b, sequence, 8000));
+            guard.offload(relay.clone()).unwrap();
+
+            // One source: the first packets go through userspace (and
+            // resolve peer B's MAC), the rest through the kernel.
+            for i in 0..PACKETS {
+                let packet = rtp(0, 100 + i, 160 * u32::from(i), 0xa);
+                peer_a.send_to(&packet, leg_a_addr).unwrap();
+                tokio::time::sleep(Duration::from_millis(2)).await;
+            }
+            let seen =
+                tokio::task::block_in_place(|| receive(&peer_b, usize::from(PACKETS), leg_b_addr));
+            let expected: Vec<_> = (0..PACKETS)
+                .map(|i| (4000 + i, 160 * u32::from(i), 0x0b0b_0b0b))
+                .collect();
+            assert_eq!(seen, expected);
+
+            let stats = guard.stats();
+            assert_eq!(stats.forwarded + stats.offloaded, u64::from(PACKETS));
+            assert!(
+                stats.offloaded > 0,
+                "nothing relayed in the kernel: {stats:?}"
+            );
+            assert_eq!(
+                stats.offloaded_bytes,
+                stats.offloaded * (14 + 20 + 8 + 12 + 160)
+            );
+
+            // RTCP on the RTP port is never relayed.
+            let mut report = rtp(200, 0, 0, 0xa);
+            report.truncate(28);
+            peer_a.send_to(&report, leg_a_addr).unwrap();
+
+            // A new source continues the sequence space.
+            for i in 0..10u16 {
+                let packet = rtp(0, 7000 + i, 90_000 + 160 * u32::from(i), 0xb);
+                peer_a.send_to(&packet, leg_a_addr).unwrap();
+                tokio::time::sleep(Duration::from_millis(2)).await;
+            }
+            let seen = tokio::task::block_in_place(|| receive(&peer_b, 10, leg_b_addr));
+            let sequences: Vec<u16> = seen.iter().map(|&(seq, _, _)| seq).collect();
+            assert_eq!(
+                sequences,
+                (4000 + PACKETS..4000 + PACKETS + 10).collect::<Vec<_>>()
+            );
+            assert!(seen.iter().all(|&(_, _, ssrc)| ssrc == 0x0b0b_0b0b));
+
+            drop(guard);
+            assert_eq!(relay.counters(leg_a_addr).unwrap(), None);
+        });
+    });
+}
@@ -5,9 +5,26 @@
 //! against it. Measures the per-REGISTER cost the registrar pays at
 //! varying client fan-out — the classic "all phones come back after a
 //! WAN outage" scenario.
+//!
+//! `digest_challenge_verify` isolates the registrar's Digest work: one
+//! challenge plus one verified `Authorization` per REGISTER, driven from
+//! concurrent tasks against a shared `SipAuthService`. Modes:
+//!
+//! - `local`: signed nonces and the in-process nonce-count window.
+//! - `redis`: Redis replay store recording every issued nonce.
+//! - `redis_signed`: Redis replay store behind a shared nonce key, so
+//!   Redis only sees nonce-count checks.
+//!
+//! The Redis modes run when `RVOIP_REDIS_URL` is set.
 
+use async_trait::async_trait;
 use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
-use rvoip_sip::{Config, StreamPeer, UnifiedCoordinator};
+use rvoip_redis::{RedisAuthConfig, RedisAuthProvider};
+use rvoip_sip::{
+    Config, CredentialAuthError, DigestAlgorithm, DigestAuth, DigestAuthenticator, DigestSecret,
+    DigestSecretProvider, SipAuthDecision, SipAuthScheme, SipAuthService, SipAuthSource,
+    StreamPeer, UnifiedCoordinator,
+};
 use std::collections::HashMap;
 use std::sync::Arc;
 use std::time::{Duration, Instant};
@@ -22,6 +39,10 @@ const REGISTRAR_PASS: &str = "password123";
 const FANOUT: [usize; 3] = [1, 8, 32];
 const REGISTRATIONS_PER_CLIENT: u64 = 4;
 
+const DIGEST_FANOUT: [usize; 3] = [1, 16, 128];
+const DIGEST_ROUNDS_PER_TASK: u64 = 32;
+const DIGEST_URI: &str = "sip:bench.local";
+
 async fn build_registrar(port: u16) -> Arc<UnifiedCoordinator> {
     let coordinator = UnifiedCoordinator::new(Config::local("bench-registrar", port))
         .await
@@ -126,5 +147,125 @@ fn bench_register_storm(c: &mut Criterion) {
     group.finish();
 }
 
-criterion_group!(benches, bench_register_storm);
+struct BenchDigestProvider;
+
+#[async_trait]
+impl DigestSecretProvider for BenchDigestProvider {
+    async fn lookup_digest_secret(
+        &self,
+        _username: &str,
+        _realm: &str,
+        _algorithm: DigestAlgorithm,
+    ) -> std::result::Result<Option<DigestSecret>, CredentialAuthError> {
+        Ok(Some(DigestSecret::PlaintextPassword(
+            REGISTRAR_PASS.to_string(),
+        )))
+    }
+}
+
+fn digest_service() -> SipAuthService {
+    SipAuthService::new().with_digest_provider(REGISTRAR_REALM, Arc::new(BenchDigestProvider))
+}
+
+/// One REGISTER's worth of Digest work: issue a challenge, answer it, and
+/// verify the answer.
+async fn challenge_and_verify(service: &SipAuthService, username: &str) {
+    let challenge = service
+        .challenges_async(SipAuthSource::Origin)
+        .await
+        .expect("challenge")
+        .into_iter()
+        .find(|challenge| challenge.scheme == SipAuthScheme::Digest)
+        .expect("Digest challenge");
+    let parsed = DigestAuthenticator::parse_challenge(&challenge.value).expect("parse challenge");
+    let computed = DigestAuth::compute_response_with_state(
+        username,
+        REGISTRAR_PASS,
+        &parsed,
+        "REGISTER",
+        DIGEST_URI,
+        1,
+        None,
+    )
+    .expect("compute response");
+    let authorization =
+        DigestAuth::format_authorization_with_state(username, &parsed, DIGEST_URI, &computed);
+    let decision = service
+        .authenticate_authorization(
+            Some(&authorization),
+            "REGISTER",
+            DIGEST_URI,
+            None,
+            SipAuthSource::Origin,
+            false,
+        )
+        .await
+        .expect("verify");
+    assert!(matches!(decision, SipAuthDecision::Authorized(_)));
+}
+
+fn bench_digest_challenge_verify(c: &mut Criterion) {
+    let rt = common::build_runtime();
+
+    let mut modes = vec![("local", Arc::new(digest_service()))];
+    match std::env::var("RVOIP_REDIS_URL") {
+        Ok(url) => {
+            let redis = Arc::new(
+                RedisAuthProvider::from_config(
+                    RedisAuthConfig::new(url).with_namespace("rvoip:bench:registration_storm"),
+                )
+                .expect("redis provider"),
+            );
+            rt.block_on(redis.clear_namespace_for_tests())
+                .expect("clear redis namespace");
+            modes.push((
+                "redis",
+                Arc::new(digest_service().with_digest_replay_store(redis.clone())),
+            ));
+            modes.push((
+                "redis_signed",
+                Arc::new(
+                    digest_service()
+                        .with_digest_replay_store(redis)
+                        .with_digest_nonce_key(rand::random::<[u8; 32]>()),
+                ),
+            ));
+        }
+        Err(_) => println!("digest_challenge_verify: set RVOIP_REDIS_URL for the Redis modes"),
+    }
+
+    let mut group = c.benchmark_group("digest_challenge_verify");
+    for (mode, service) in &modes {
+        for &fanout in &DIGEST_FANOUT {
+            group.throughput(Throughput::Elements(fanout as u64 * DIGEST_ROUNDS_PER_TASK));
+            group.bench_with_input(BenchmarkId::new(*mode, fanout), &fanout, |b, &fanout| {
+                b.iter_custom(|iters| {
+                    rt.block_on(async {
+                        let start = Instant::now();
+                        for _ in 0..iters {
+                            let tasks: Vec<_> = (0..fanout)
+                                .map(|task| {
+                                    let service = Arc::clone(service);
+                                    tokio::spawn(async move {
+                                        let username = format!("ext-{task}");
+                                        for _ in 0..DIGEST_ROUNDS_PER_TASK {
+                                            challenge_and_verify(&service, &username).await;
+                                        }
+                                    })
+                                })
+                                .collect();
+                            for task in tasks {
+                                task.await.expect("digest task");
+                            }
+                        }
+                        start.elapsed()
+                    })
+                });
+            });
+        }
+    }
+    group.finish();
+}
+
+criterion_group!(benches, bench_register_storm, bench_digest_challenge_verify);
 criterion_main!(benches);
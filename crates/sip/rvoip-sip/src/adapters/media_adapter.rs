@@ -289,6 +289,19 @@ fn select_primary_audio_payload(formats: &[String]) -> Option<u8> {
     })
 }
 
+/// Payload type the audio m-line maps to RFC 4733 `telephone-event`
+fn telephone_event_payload_from_session(session: &SdpSession) -> Option<u8> {
+    session
+        .media_descriptions
+        .iter()
+        .find(|m| m.media == "audio")
+        .and_then(|m| {
+            m.rtpmaps()
+                .find(|rtpmap| rtpmap.encoding_name.eq_ignore_ascii_case("telephone-event"))
+                .map(|rtpmap| rtpmap.payload_type)
+        })
+}
+
 fn select_primary_audio_payload_from_session(session: &SdpSession) -> Option<u8> {
     session
         .media_descriptions
@@ -714,6 +727,7 @@ impl MediaAdapter {
         dialog_id: &DialogId,
         remote_addr: SocketAddr,
         codec: &str,
+        telephone_event_pt: Option<u8>,
     ) -> Result<()> {
         let mut config = self
             .controller
@@ -725,6 +739,18 @@ impl MediaAdapter {
             .config;
         config.remote_addr = Some(remote_addr);
         config.preferred_codec = Some(codec.to_string());
+        match telephone_event_pt {
+            Some(pt) => {
+                config
+                    .parameters
+                    .insert(MediaConfig::TELEPHONE_EVENT_PAYLOAD_TYPE.to_string(), pt.to_string());
+            }
+            None => {
+                config
+                    .parameters
+                    .remove(MediaConfig::TELEPHONE_EVENT_PAYLOAD_TYPE);
+            }
+        }
 
         self.controller
             .update_media(dialog_id.clone(), config)
@@ -921,6 +947,9 @@ impl MediaAdapter {
             .map(|answer| negotiated_g729_annex_b(answer, self.g729_annex_b))
             .unwrap_or(false);
         let negotiated_codec = codec_name_for_payload(payload_type, negotiated_annex_b);
+        let telephone_event_pt = parsed_answer
+            .as_ref()
+            .and_then(telephone_event_payload_from_session);
 
         // Update media session with remote address. SRTP contexts (if
         // negotiated in 2B.1) must be installed *between* updating the
@@ -939,8 +968,13 @@ impl MediaAdapter {
         if let Some(dialog_id) = dialog_id {
             let remote_addr = SocketAddr::new(remote_ip, remote_port);
 
-            self.apply_negotiated_media_config(&dialog_id, remote_addr, &negotiated_codec)
-                .await?;
+            self.apply_negotiated_media_config(
+                &dialog_id,
+                remote_addr,
+                &negotiated_codec,
+                telephone_event_pt,
+            )
+            .await?;
 
             // RFC 4568 SDES: install per-direction contexts before the
             // first wire packet flows.
@@ -1132,6 +1166,9 @@ impl MediaAdapter {
             false
         };
         let negotiated_codec = codec_name_for_payload(negotiated_payload_type, negotiated_annex_b);
+        // Only a telephone-event format the answer keeps is negotiated.
+        let telephone_event_pt = telephone_event_payload_from_session(&parsed_offer)
+            .filter(|pt| formats.iter().any(|fmt| fmt.parse::<u8>().ok() == Some(*pt)));
         let offered_direction = audio_direction(&parsed_offer);
         let answer_direction = answer_direction_for_offer(&offered_direction);
 
@@ -1149,8 +1186,13 @@ impl MediaAdapter {
         if let Some(dialog_id) = dialog_id {
             let remote_addr = SocketAddr::new(remote_ip, remote_port);
 
-            self.apply_negotiated_media_config(&dialog_id, remote_addr, &negotiated_codec)
-                .await?;
+            self.apply_negotiated_media_config(
+                &dialog_id,
+                remote_addr,
+                &negotiated_codec,
+                telephone_event_pt,
+            )
+            .await?;
 
             if let Some((_, pair)) = self.negotiated_srtp.remove(session_id) {
                 let suite = pair.suite;
@@ -329,6 +329,15 @@ impl SessionBuilder {
         self
     }
 
+    /// Set the transaction-manager execution mode (shared or per-core shards).
+    pub fn with_sip_transaction_execution_mode(
+        mut self,
+        mode: rvoip_sip_dialog::transaction::TransactionExecutionMode,
+    ) -> Self {
+        self.config.sip_transaction_execution_mode = mode;
+        self
+    }
+
     /// Set the per-transaction command channel capacity.
     pub fn with_sip_transaction_command_channel_capacity(mut self, capacity: usize) -> Self {
         self.config = self
@@ -512,6 +521,7 @@ mod tests {
             event_channel_capacity: 10,
             recv_buffer_size: 2048,
             rtcp_recv_buffer_size: 1024,
+            ..Default::default()
         };
         let mut media_config = MediaSessionControllerConfig::default();
         media_config.rtp_buffer_size = 960;
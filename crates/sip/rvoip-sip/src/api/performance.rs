@@ -512,6 +512,8 @@ pub enum RecipeUdpParseDispatch {
     SourceHash,
     /// Spread received datagrams across workers.
     RoundRobin,
+    /// Route by top Via branch to match transaction shards.
+    TransactionShard,
 }
 
 impl From<RecipeUdpParseDispatch> for rvoip_sip_transport::UdpParseDispatch {
@@ -519,6 +521,7 @@ impl From<RecipeUdpParseDispatch> for rvoip_sip_transport::UdpParseDispatch {
         match value {
             RecipeUdpParseDispatch::SourceHash => Self::SourceHash,
             RecipeUdpParseDispatch::RoundRobin => Self::RoundRobin,
+            RecipeUdpParseDispatch::TransactionShard => Self::TransactionShard,
         }
     }
 }
@@ -583,6 +586,10 @@ pub struct RecipeRtpTransportBufferConfig {
     pub recv_buffer_size: Option<RecipeUsize>,
     /// UDP RTCP receive buffer size in bytes for separate RTCP sockets.
     pub rtcp_recv_buffer_size: Option<RecipeUsize>,
+    /// Datagrams drained per RTP receive syscall (Linux `recvmmsg`).
+    pub recv_batch_size: Option<RecipeUsize>,
+    /// Enable Linux UDP GSO/GRO on the RTP socket.
+    pub udp_offload: Option<bool>,
 }
 
 impl RecipeRtpTransportBufferConfig {
@@ -599,6 +606,13 @@ impl RecipeRtpTransportBufferConfig {
             config.rtcp_recv_buffer_size =
                 value.resolve(params, "rtpTransportBufferConfig.rtcpRecvBufferSize")?;
         }
+        if let Some(value) = &self.recv_batch_size {
+            config.recv_batch_size =
+                value.resolve(params, "rtpTransportBufferConfig.recvBatchSize")?;
+        }
+        if let Some(value) = self.udp_offload {
+            config.udp_offload = value;
+        }
         Ok(())
     }
 }
@@ -1588,6 +1588,7 @@ mod tests {
             event_channel_capacity: 13,
             recv_buffer_size: 2048,
             rtcp_recv_buffer_size: 1024,
+            ..Default::default()
         };
         let mut media_config = MediaSessionControllerConfig::default();
         media_config.rtp_buffer_size = 960;
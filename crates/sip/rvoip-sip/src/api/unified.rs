@@ -770,6 +770,18 @@ pub struct Config {
     /// dispatch workers are enabled, this capacity is divided across workers.
     pub sip_transaction_dispatch_queue_capacity: Option<usize>,
 
+    /// How the transaction manager executes receive-side work.
+    ///
+    /// `Shared` (the default) handles events on the endpoint's Tokio runtime.
+    /// `Sharded` runs one pinned, single-threaded shard per
+    /// [`Config::sip_transaction_dispatch_workers`] (default: one per core)
+    /// and keeps each transaction, and its slice of the transaction tables,
+    /// on the shard owning its top Via branch. UDP parse workers hand
+    /// received messages straight to their shard. Pair it with
+    /// `UdpParseDispatch::TransactionShard` and as many UDP parse workers as
+    /// shards so each parse worker feeds a single shard.
+    pub sip_transaction_execution_mode: rvoip_sip_dialog::transaction::TransactionExecutionMode,
+
     /// Optional per-transaction command channel capacity.
     ///
     /// Each SIP transaction owns a private command queue for timer and
@@ -1076,6 +1088,7 @@ impl Config {
             transaction_event_channel_capacity: 10_000,
             sip_transaction_dispatch_workers: None,
             sip_transaction_dispatch_queue_capacity: None,
+            sip_transaction_execution_mode: Default::default(),
             sip_transaction_command_channel_capacity: None,
             sip_transaction_dispatch_priority_burst_max: None,
             sip_invite_2xx_retransmit_max_due_per_tick: None,
@@ -1184,6 +1197,7 @@ impl Config {
             transaction_event_channel_capacity: 10_000,
             sip_transaction_dispatch_workers: None,
             sip_transaction_dispatch_queue_capacity: None,
+            sip_transaction_execution_mode: Default::default(),
             sip_transaction_command_channel_capacity: None,
             sip_transaction_dispatch_priority_burst_max: None,
             sip_invite_2xx_retransmit_max_due_per_tick: None,
@@ -1889,6 +1903,17 @@ impl Config {
         self
     }
 
+    /// Set the transaction-manager execution mode.
+    ///
+    /// See [`Config::sip_transaction_execution_mode`].
+    pub fn with_sip_transaction_execution_mode(
+        mut self,
+        mode: rvoip_sip_dialog::transaction::TransactionExecutionMode,
+    ) -> Self {
+        self.sip_transaction_execution_mode = mode;
+        self
+    }
+
     /// Set the per-transaction command channel capacity.
     ///
     /// Values below `1` are rejected by [`Config::validate`]. This should be
@@ -5802,13 +5827,14 @@ impl UnifiedCoordinator {
 
         // Create transaction manager using transport manager
         let (transaction_manager, event_rx) =
-            TransactionManager::with_transport_manager_and_index_capacity_and_dispatch(
+            TransactionManager::with_transport_manager_and_execution_mode(
                 transport_manager,
                 transport_event_rx,
                 Some(config.transaction_event_channel_capacity),
                 Some(config.transaction_index_capacity_hint()),
                 config.sip_transaction_dispatch_workers,
                 config.sip_transaction_dispatch_queue_capacity,
+                config.sip_transaction_execution_mode,
             )
             .await
             .map_err(|e| {
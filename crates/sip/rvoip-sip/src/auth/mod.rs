@@ -58,6 +58,12 @@
 //! can use
 //! [`SipDigestAuthService::authenticate_authorization_with_replay_store`].
 //!
+//! Digest nonces are HMAC-signed timestamps ([`DigestNonceSigner`]), so local
+//! challenges keep no per-nonce state and nonce-count replay is tracked in a
+//! sharded window. Clusters that configure
+//! [`SipAuthService::with_digest_nonce_key`] skip the per-challenge replay
+//! store write as well; the store then only sees nonce-count checks.
+//!
 //! # Examples
 //!
 //! PBX Digest account with Endpoint:
@@ -216,7 +222,7 @@
 use std::collections::{BTreeMap, HashMap};
 use std::str::FromStr;
 use std::sync::{Arc, RwLock};
-use std::time::{Duration, Instant, SystemTime};
+use std::time::{Duration, SystemTime};
 
 use async_trait::async_trait;
 use base64::engine::general_purpose::STANDARD as BASE64_STANDARD;
@@ -226,15 +232,20 @@ use rvoip_core_traits::identity::IdentityAssurance;
 use crate::errors::{Result, SessionError};
 use crate::types::Credentials;
 
+mod nonce_count;
+
+use nonce_count::NonceCountWindow;
+
 // Re-export digest authentication from auth-core.
 pub use rvoip_auth_core::{
     AAuthValidator, ApiKeyVerifier, AuthAuditEvent, AuthAuditOutcome, AuthAuditScheme,
     AuthAuditSink, AuthFailureReason, AuthRateLimitKey, AuthRateLimitKind, AuthRateLimitVerdict,
     AuthRateLimiter, BearerAuthError, BearerValidator, CredentialAuthError, DigestAlgorithm,
     DigestAuthenticator, DigestChallenge, DigestChallengeDetails, DigestClient as DigestAuth,
-    DigestComputed, DigestNonceStatus, DigestReplayStore, DigestResponse, DigestSecret,
-    DigestSecretProvider, JwksJwtValidator, JwtValidator, OAuth2IntrospectionValidator,
-    PasswordVerifier, TokenRevocationChecker, TokenRevocationContext, TokenRevocationStatus,
+    DigestComputed, DigestNonceSigner, DigestNonceStatus, DigestReplayStore, DigestResponse,
+    DigestSecret, DigestSecretProvider, JwksJwtValidator, JwtValidator,
+    OAuth2IntrospectionValidator, PasswordVerifier, TokenRevocationChecker, TokenRevocationContext,
+    TokenRevocationStatus,
 };
 
 /// SIP authentication scheme shared by UAC negotiation, UAS challenges, and
@@ -994,6 +1005,7 @@ pub struct SipAuthService {
     audit_failure_policy: AuditFailurePolicy,
     rate_limiter: Option<Arc<dyn AuthRateLimiter>>,
     digest_replay_store: Option<Arc<dyn DigestReplayStore>>,
+    digest_nonce_key: Option<Arc<[u8]>>,
 }
 
 impl SipAuthService {
@@ -1015,6 +1027,7 @@ impl SipAuthService {
             audit_failure_policy: AuditFailurePolicy::FailOpen,
             rate_limiter: None,
             digest_replay_store: None,
+            digest_nonce_key: None,
         }
     }
 
@@ -1052,6 +1065,9 @@ impl SipAuthService {
         if let Some(replay_store) = self.digest_replay_store.clone() {
             digest = digest.with_replay_store(replay_store);
         }
+        if let Some(key) = &self.digest_nonce_key {
+            digest = digest.with_nonce_key(key);
+        }
         self.digest_provider = Some(digest);
         self
     }
@@ -1074,6 +1090,9 @@ impl SipAuthService {
     /// Use [`Self::challenges_async`] or
     /// [`Self::authenticate_authorization_with_context`] when shared replay
     /// state must record newly issued nonces.
+    ///
+    /// Combine with [`Self::with_digest_nonce_key`] so the store only sees
+    /// nonce-count checks, not a write per challenge.
     pub fn with_digest_replay_store(mut self, replay_store: Arc<dyn DigestReplayStore>) -> Self {
         if let Some(digest) = self.digest_provider.take() {
             self.digest_provider = Some(digest.with_replay_store(replay_store.clone()));
@@ -1082,6 +1101,23 @@ impl SipAuthService {
         self
     }
 
+    /// Sign provider-backed Digest nonces with a key shared across nodes.
+    ///
+    /// Nonces are always HMAC-signed timestamps ([`DigestNonceSigner`]) that
+    /// validate without a lookup; by default the key is random per process.
+    /// With a shared key every node accepts every other node's nonces, so a
+    /// configured [`DigestReplayStore`] is no longer asked to record each
+    /// issued nonce and is only consulted for nonce-count replay. Use at
+    /// least 32 random bytes.
+    pub fn with_digest_nonce_key(mut self, key: impl AsRef<[u8]>) -> Self {
+        let key: Arc<[u8]> = Arc::from(key.as_ref());
+        if let Some(digest) = self.digest_provider.take() {
+            self.digest_provider = Some(digest.with_nonce_key(&key));
+        }
+        self.digest_nonce_key = Some(key);
+        self
+    }
+
     /// Add a redacted audit sink for authentication events.
     pub fn with_audit_sink(mut self, sink: Arc<dyn AuthAuditSink>) -> Self {
         self.audit_sink = Some(sink);
@@ -2136,6 +2172,7 @@ impl std::fmt::Debug for SipAuthService {
             .field("audit_failure_policy", &self.audit_failure_policy)
             .field("rate_limiter", &self.rate_limiter.is_some())
             .field("digest_replay_store", &self.digest_replay_store.is_some())
+            .field("digest_nonce_key", &self.digest_nonce_key.is_some())
             .finish()
     }
 }
@@ -2145,22 +2182,25 @@ struct DigestProviderAuthStore {
     authenticator: DigestAuthenticator,
     realm: String,
     provider: Arc<dyn DigestSecretProvider>,
-    nonces: Arc<RwLock<HashMap<String, Instant>>>,
-    nonce_counts: Arc<RwLock<HashMap<(String, String), u32>>>,
-    nonce_ttl: Duration,
+    nonces: DigestNonceSigner,
+    nonce_counts: Arc<NonceCountWindow>,
+    /// Nonces are signed with a key shared across nodes, so the replay
+    /// store does not need to track them.
+    shared_nonce_key: bool,
     replay_store: Option<Arc<dyn DigestReplayStore>>,
 }
 
 impl DigestProviderAuthStore {
     fn new(realm: impl Into<String>, provider: Arc<dyn DigestSecretProvider>) -> Self {
         let realm = realm.into();
+        let nonces = DigestNonceSigner::new(realm.clone(), DEFAULT_DIGEST_NONCE_TTL);
         Self {
             authenticator: DigestAuthenticator::new(realm.clone()),
             realm,
             provider,
-            nonces: Arc::new(RwLock::new(HashMap::new())),
-            nonce_counts: Arc::new(RwLock::new(HashMap::new())),
-            nonce_ttl: Duration::from_secs(300),
+            nonce_counts: Arc::new(NonceCountWindow::new(nonces.max_lifetime())),
+            nonces,
+            shared_nonce_key: false,
             replay_store: None,
         }
     }
@@ -2175,36 +2215,36 @@ impl DigestProviderAuthStore {
         self
     }
 
+    fn with_nonce_key(mut self, key: &[u8]) -> Self {
+        self.nonces = DigestNonceSigner::with_key(self.realm.clone(), key, self.nonces.ttl());
+        self.shared_nonce_key = true;
+        self
+    }
+
+    /// The replay store, when issued nonces are recorded there rather than
+    /// validated by signature alone.
+    fn nonces_in_replay_store(&self) -> Option<&Arc<dyn DigestReplayStore>> {
+        self.replay_store
+            .as_ref()
+            .filter(|_| !self.shared_nonce_key)
+    }
+
     fn challenge(&self) -> DigestChallenge {
-        let challenge = self.authenticator.generate_challenge();
-        self.record_nonce_local(&challenge.nonce);
-        challenge
+        self.authenticator
+            .generate_challenge_with_nonce(self.nonces.issue())
     }
 
     async fn challenge_async(&self) -> Result<DigestChallenge> {
-        let challenge = self.authenticator.generate_challenge();
-        if let Some(replay_store) = &self.replay_store {
+        let challenge = self.challenge();
+        if let Some(replay_store) = self.nonces_in_replay_store() {
             replay_store
-                .record_nonce(&challenge.nonce, system_time_after(self.nonce_ttl))
+                .record_nonce(&challenge.nonce, system_time_after(self.nonces.ttl()))
                 .await
                 .map_err(|err| SessionError::AuthError(err.to_string()))?;
-        } else {
-            self.record_nonce_local(&challenge.nonce);
         }
         Ok(challenge)
     }
 
-    fn record_nonce_local(&self, nonce: &str) {
-        let expires_at = Instant::now()
-            .checked_add(self.nonce_ttl)
-            .unwrap_or_else(Instant::now);
-        let mut nonces = self
-            .nonces
-            .write()
-            .unwrap_or_else(|poisoned| poisoned.into_inner());
-        nonces.insert(nonce.to_string(), expires_at);
-    }
-
     fn www_authenticate(&self, challenge: &DigestChallenge) -> String {
         self.authenticator.format_www_authenticate(challenge)
     }
@@ -2299,67 +2339,15 @@ impl DigestProviderAuthStore {
         ))
     }
 
-    fn nonce_status(&self, nonce: &str) -> NonceStatus {
-        let now = Instant::now();
-        let mut nonces = self
-            .nonces
-            .write()
-            .unwrap_or_else(|poisoned| poisoned.into_inner());
-        match nonces.get(nonce).copied() {
-            Some(expires_at) if expires_at > now => NonceStatus::Active,
-            Some(_) => {
-                nonces.remove(nonce);
-                NonceStatus::Expired
-            }
-            None => NonceStatus::Unknown,
-        }
-    }
-
-    fn accept_nonce_count(&self, response: &DigestResponse) -> bool {
-        let Some(qop) = response.qop.as_deref() else {
-            return true;
-        };
-        if qop != "auth" && qop != "auth-int" {
-            return false;
-        }
-        let Some(nc) = response
-            .nc
-            .as_deref()
-            .and_then(|value| u32::from_str_radix(value, 16).ok())
-        else {
-            return false;
-        };
-        let Some(cnonce) = response.cnonce.clone() else {
-            return false;
-        };
-        if cnonce.is_empty() {
-            return false;
-        }
-        let key = (response.username.clone(), response.nonce.clone());
-        let mut nonce_counts = self
-            .nonce_counts
-            .write()
-            .unwrap_or_else(|poisoned| poisoned.into_inner());
-        if nonce_counts.get(&key).is_some_and(|last| nc <= *last) {
-            return false;
-        }
-        nonce_counts.insert(key, nc);
-        true
-    }
-
     async fn nonce_status_async(&self, nonce: &str) -> Result<NonceStatus> {
-        let Some(replay_store) = &self.replay_store else {
-            return Ok(self.nonce_status(nonce));
+        let Some(replay_store) = self.nonces_in_replay_store() else {
+            return Ok(self.nonces.verify(nonce, SystemTime::now()).into());
         };
-        match replay_store
+        replay_store
             .nonce_status(nonce, SystemTime::now())
             .await
-            .map_err(|err| SessionError::AuthError(err.to_string()))?
-        {
-            DigestNonceStatus::Active => Ok(NonceStatus::Active),
-            DigestNonceStatus::Expired => Ok(NonceStatus::Expired),
-            DigestNonceStatus::Unknown => Ok(NonceStatus::Unknown),
-        }
+            .map(NonceStatus::from)
+            .map_err(|err| SessionError::AuthError(err.to_string()))
     }
 
     async fn accept_nonce_count_async(
@@ -2391,7 +2379,8 @@ impl DigestProviderAuthStore {
                 .await
                 .map_err(|err| SessionError::AuthError(err.to_string()))?
         } else {
-            self.accept_nonce_count(response)
+            self.nonce_counts
+                .accept(&response.username, &response.nonce, nc)
         };
         if accepted {
             Ok(None)
@@ -2550,6 +2539,9 @@ fn subject_realm_from_authorization(
     (None, None)
 }
 
+/// Lifetime of issued Digest nonces unless overridden.
+const DEFAULT_DIGEST_NONCE_TTL: Duration = Duration::from_secs(300);
+
 fn system_time_after(duration: Duration) -> SystemTime {
     SystemTime::now()
         .checked_add(duration)
@@ -2797,22 +2789,21 @@ pub struct SipDigestAuthService {
     authenticator: DigestAuthenticator,
     realm: String,
     users: Arc<RwLock<HashMap<String, String>>>,
-    nonces: Arc<RwLock<HashMap<String, Instant>>>,
-    nonce_counts: Arc<RwLock<HashMap<(String, String), u32>>>,
-    nonce_ttl: Duration,
+    nonces: DigestNonceSigner,
+    nonce_counts: Arc<NonceCountWindow>,
 }
 
 impl SipDigestAuthService {
     /// Create a digest service for the given realm.
     pub fn new(realm: impl Into<String>) -> Self {
         let realm = realm.into();
+        let nonces = DigestNonceSigner::new(realm.clone(), DEFAULT_DIGEST_NONCE_TTL);
         Self {
             authenticator: DigestAuthenticator::new(realm.clone()),
             realm,
             users: Arc::new(RwLock::new(HashMap::new())),
-            nonces: Arc::new(RwLock::new(HashMap::new())),
-            nonce_counts: Arc::new(RwLock::new(HashMap::new())),
-            nonce_ttl: Duration::from_secs(300),
+            nonce_counts: Arc::new(NonceCountWindow::new(nonces.max_lifetime())),
+            nonces,
         }
     }
 
@@ -2824,7 +2815,8 @@ impl SipDigestAuthService {
 
     /// Set how long generated nonces remain valid.
     pub fn with_nonce_ttl(mut self, ttl: Duration) -> Self {
-        self.nonce_ttl = ttl;
+        self.nonces = self.nonces.with_ttl(ttl);
+        self.nonce_counts = Arc::new(NonceCountWindow::new(self.nonces.max_lifetime()));
         self
     }
 
@@ -2838,15 +2830,12 @@ impl SipDigestAuthService {
     }
 
     /// Generate a fresh digest challenge.
+    ///
+    /// The nonce is signed rather than stored, so issuing challenges takes
+    /// no lock and keeps no per-challenge state.
     pub fn challenge(&self) -> DigestChallenge {
-        let challenge = self.authenticator.generate_challenge();
-        let expires_at = Instant::now() + self.nonce_ttl;
-        let mut nonces = self
-            .nonces
-            .write()
-            .unwrap_or_else(|poisoned| poisoned.into_inner());
-        nonces.insert(challenge.nonce.clone(), expires_at);
-        challenge
+        self.authenticator
+            .generate_challenge_with_nonce(self.nonces.issue())
     }
 
     /// Generate a challenge and record its nonce in a shared replay store.
@@ -2858,9 +2847,9 @@ impl SipDigestAuthService {
         &self,
         replay_store: Arc<dyn DigestReplayStore>,
     ) -> Result<DigestChallenge> {
-        let challenge = self.authenticator.generate_challenge();
+        let challenge = self.challenge();
         replay_store
-            .record_nonce(&challenge.nonce, system_time_after(self.nonce_ttl))
+            .record_nonce(&challenge.nonce, system_time_after(self.nonces.ttl()))
             .await
             .map_err(|err| SessionError::AuthError(err.to_string()))?;
         Ok(challenge)
@@ -3052,19 +3041,7 @@ impl SipDigestAuthService {
     }
 
     fn nonce_status(&self, nonce: &str) -> NonceStatus {
-        let now = Instant::now();
-        let mut nonces = self
-            .nonces
-            .write()
-            .unwrap_or_else(|poisoned| poisoned.into_inner());
-        match nonces.get(nonce).copied() {
-            Some(expires_at) if expires_at > now => NonceStatus::Active,
-            Some(_) => {
-                nonces.remove(nonce);
-                NonceStatus::Expired
-            }
-            None => NonceStatus::Unknown,
-        }
+        self.nonces.verify(nonce, SystemTime::now()).into()
     }
 
     fn accept_nonce_count(&self, response: &DigestResponse) -> bool {
@@ -3087,16 +3064,8 @@ impl SipDigestAuthService {
         if cnonce.is_empty() {
             return false;
         }
-        let key = (response.username.clone(), response.nonce.clone());
-        let mut nonce_counts = self
-            .nonce_counts
-            .write()
-            .unwrap_or_else(|poisoned| poisoned.into_inner());
-        if nonce_counts.get(&key).is_some_and(|last| nc <= *last) {
-            return false;
-        }
-        nonce_counts.insert(key, nc);
-        true
+        self.nonce_counts
+            .accept(&response.username, &response.nonce, nc)
     }
 
     fn rejected(&self) -> AuthDecision {
@@ -3149,6 +3118,16 @@ enum NonceStatus {
     Unknown,
 }
 
+impl From<DigestNonceStatus> for NonceStatus {
+    fn from(status: DigestNonceStatus) -> Self {
+        match status {
+            DigestNonceStatus::Active => Self::Active,
+            DigestNonceStatus::Expired => Self::Expired,
+            DigestNonceStatus::Unknown => Self::Unknown,
+        }
+    }
+}
+
 impl std::fmt::Debug for SipDigestAuthService {
     fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
         let user_count = self
@@ -3156,16 +3135,11 @@ impl std::fmt::Debug for SipDigestAuthService {
             .read()
             .map(|users| users.len())
             .unwrap_or_default();
-        let nonce_count = self
-            .nonces
-            .read()
-            .map(|nonces| nonces.len())
-            .unwrap_or_default();
         f.debug_struct("SipDigestAuthService")
             .field("authenticator", &self.authenticator)
             .field("user_count", &user_count)
-            .field("nonce_count", &nonce_count)
-            .field("nonce_ttl", &self.nonce_ttl)
+            .field("tracked_nonce_counts", &self.nonce_counts.len())
+            .field("nonce_ttl", &self.nonces.ttl())
             .finish()
     }
 }
@@ -4322,6 +4296,117 @@ mod tests {
         );
     }
 
+    #[tokio::test]
+    async fn shared_digest_nonce_key_keeps_challenges_out_of_replay_store() {
+        let replay_store = Arc::new(MemoryDigestReplayStore::default());
+        let key = [42u8; 32];
+        let node = |replay_store: Arc<MemoryDigestReplayStore>| {
+            SipAuthService::new()
+                .with_digest_nonce_key(key)
+                .with_digest_provider("example.test", Arc::new(StaticDigestProvider))
+                .with_digest_replay_store(replay_store)
+        };
+        let (issuer, verifier) = (node(replay_store.clone()), node(replay_store.clone()));
+        let challenge = issuer
+            .challenges_async(SipAuthSource::Origin)
+            .await
+            .expect("async challenges")
+            .into_iter()
+            .find(|challenge| challenge.scheme == SipAuthScheme::Digest)
+            .expect("Digest challenge");
+        let digest_challenge =
+            DigestAuthenticator::parse_challenge(&challenge.value).expect("parse challenge");
+        assert!(
+            replay_store.nonces.lock().unwrap().is_empty(),
+            "signed nonces must not be written to the replay store"
+        );
+        let authorization = authorization_for(
+            "alice",
+            "secret",
+            &digest_challenge,
+            "OPTIONS",
+            "sip:bob@example.test",
+            None,
+        );
+
+        // Another node with the same key accepts the nonce.
+        let authenticate = |service: &SipAuthService| {
+            let service = service.clone();
+            let authorization = authorization.clone();
+            async move {
+                service
+                    .authenticate_authorization(
+                        Some(&authorization),
+                        "OPTIONS",
+                        "sip:bob@example.test",
+                        None,
+                        SipAuthSource::Origin,
+                        false,
+                    )
+                    .await
+                    .expect("Digest auth")
+            }
+        };
+        assert!(matches!(
+            authenticate(&verifier).await,
+            SipAuthDecision::Authorized(_)
+        ));
+        // The nonce-count is still shared through the store.
+        assert!(matches!(
+            authenticate(&issuer).await,
+            SipAuthDecision::Rejected { .. }
+        ));
+        assert_eq!(replay_store.nonce_counts.lock().unwrap().len(), 1);
+
+        // A node with a different key does not.
+        let stranger = SipAuthService::new()
+            .with_digest_provider("example.test", Arc::new(StaticDigestProvider))
+            .with_digest_nonce_key([7u8; 32]);
+        assert!(matches!(
+            authenticate(&stranger).await,
+            SipAuthDecision::Rejected { .. }
+        ));
+    }
+
+    #[tokio::test]
+    async fn local_digest_provider_rejects_replayed_nonce_count() {
+        let service = SipAuthService::new()
+            .with_digest_provider("example.test", Arc::new(StaticDigestProvider));
+        let challenge = service
+            .challenges(SipAuthSource::Origin)
+            .into_iter()
+            .find(|challenge| challenge.scheme == SipAuthScheme::Digest)
+            .expect("Digest challenge");
+        let digest_challenge =
+            DigestAuthenticator::parse_challenge(&challenge.value).expect("parse challenge");
+        let authorization = authorization_for(
+            "alice",
+            "secret",
+            &digest_challenge,
+            "OPTIONS",
+            "sip:bob@example.test",
+            None,
+        );
+        let mut decisions = Vec::new();
+        for _ in 0..2 {
+            decisions.push(
+                service
+                    .authenticate_authorization(
+                        Some(&authorization),
+                        "OPTIONS",
+                        "sip:bob@example.test",
+                        None,
+                        SipAuthSource::Origin,
+                        false,
+                    )
+                    .await
+                    .expect("Digest auth"),
+            );
+        }
+        assert!(matches!(decisions[0], SipAuthDecision::Authorized(_)));
+        assert!(matches!(decisions[1], SipAuthDecision::Rejected { .. }));
+    }
+
     #[tokio::test]
     async fn sip_digest_auth_service_supports_replay_store_helper() {
         let replay_store = Arc::new(MemoryDigestReplayStore::default());
@@ -0,0 +1,161 @@
+//! Local Digest nonce-count replay window.
+//!
+//! RFC 7616 §3.4.5 needs the last accepted `nc` per `(username, nonce)` for
+//! as long as the nonce is usable. Entries are keyed by a keyed 64-bit hash
+//! of that pair and spread over independently locked shards, so concurrent
+//! REGISTERs rarely meet on a lock. Each shard keeps two time buckets of one
+//! nonce lifetime each: an entry is only dropped once two bucket boundaries
+//! have passed since it was last written, by which point its nonce has
+//! expired and is rejected before the window is consulted.
+
+use std::collections::hash_map::RandomState;
+use std::collections::HashMap;
+use std::hash::{BuildHasher, Hash, Hasher};
+use std::sync::Mutex;
+use std::time::{Duration, Instant};
+
+pub(super) struct NonceCountWindow {
+    shards: Box<[Mutex<Shard>]>,
+    hasher: RandomState,
+    origin: Instant,
+    bucket: Duration,
+}
+
+#[derive(Default)]
+struct Shard {
+    epoch: u64,
+    current: HashMap<u64, u32>,
+    previous: HashMap<u64, u32>,
+}
+
+impl NonceCountWindow {
+    /// Window for nonces that stay valid for `nonce_ttl`.
+    pub(super) fn new(nonce_ttl: Duration) -> Self {
+        let shards = std::thread::available_parallelism()
+            .map(|n| n.get() * 4)
+            .unwrap_or(16)
+            .next_power_of_two();
+        Self {
+            shards: (0..shards).map(|_| Mutex::default()).collect(),
+            hasher: RandomState::new(),
+            origin: Instant::now(),
+            bucket: nonce_ttl.max(Duration::from_millis(1)),
+        }
+    }
+
+    /// Record `nc` for `(username, nonce)` if it is above the last accepted
+    /// value; `false` means a replay.
+    pub(super) fn accept(&self, username: &str, nonce: &str, nc: u32) -> bool {
+        self.accept_at(username, nonce, nc, Instant::now())
+    }
+
+    fn accept_at(&self, username: &str, nonce: &str, nc: u32, now: Instant) -> bool {
+        let key = self.key(username, nonce);
+        // The low bits index the shard's maps; shard on the high bits.
+        let shard = (key >> 32) as usize & (self.shards.len() - 1);
+        let epoch =
+            (now.saturating_duration_since(self.origin).as_nanos() / self.bucket.as_nanos()) as u64;
+        let mut shard = self.shards[shard]
+            .lock()
+            .unwrap_or_else(|poisoned| poisoned.into_inner());
+        shard.rotate(epoch);
+        let last = match shard.current.get(&key) {
+            Some(last) => Some(*last),
+            None => shard.previous.remove(&key),
+        };
+        if let Some(last) = last.filter(|last| nc <= *last) {
+            // Keep the entry alive in the current bucket.
+            shard.current.insert(key, last);
+            return false;
+        }
+        shard.current.insert(key, nc);
+        true
+    }
+
+    /// Tracked `(username, nonce)` pairs, for diagnostics.
+    pub(super) fn len(&self) -> usize {
+        self.shards
+            .iter()
+            .map(|shard| {
+                let shard = shard
+                    .lock()
+                    .unwrap_or_else(|poisoned| poisoned.into_inner());
+                shard.current.len() + shard.previous.len()
+            })
+            .sum()
+    }
+
+    fn key(&self, username: &str, nonce: &str) -> u64 {
+        let mut hasher = self.hasher.build_hasher();
+        username.hash(&mut hasher);
+        nonce.hash(&mut hasher);
+        hasher.finish()
+    }
+}
+
+impl Shard {
+    fn rotate(&mut self, epoch: u64) {
+        if epoch <= self.epoch {
+            return;
+        }
+        if epoch == self.epoch + 1 {
+            self.previous = std::mem::take(&mut self.current);
+        } else {
+            self.previous.clear();
+            self.current.clear();
+        }
+        self.epoch = epoch;
+    }
+}
+
+impl std::fmt::Debug for NonceCountWindow {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("NonceCountWindow")
+            .field("shards", &self.shards.len())
+            .field("bucket", &self.bucket)
+            .finish()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn accepts_increasing_counts_and_rejects_replays() {
+        let window = NonceCountWindow::new(Duration::from_secs(60));
+        assert!(window.accept("alice", "n1", 1));
+        assert!(!window.accept("alice", "n1", 1));
+        assert!(window.accept("alice", "n1", 3));
+        assert!(!window.accept("alice", "n1", 2));
+        // Counts are per (username, nonce).
+        assert!(window.accept("bob", "n1", 1));
+        assert!(window.accept("alice", "n2", 1));
+        assert_eq!(window.len(), 3);
+    }
+
+    #[test]
+    fn entries_outlive_one_bucket_boundary() {
+        let window = NonceCountWindow::new(Duration::from_secs(10));
+        let start = window.origin;
+        assert!(window.accept_at("alice", "n1", 1, start + Duration::from_secs(9)));
+        // Next bucket: the entry moved to `previous` and still blocks replays.
+        assert!(!window.accept_at("alice", "n1", 1, start + Duration::from_secs(11)));
+        // A rejected replay refreshes the entry into the current bucket.
+        assert!(!window.accept_at("alice", "n1", 1, start + Duration::from_secs(21)));
+        assert!(window.accept_at("alice", "n1", 2, start + Duration::from_secs(25)));
+    }
+
+    #[test]
+    fn idle_entries_are_dropped_after_two_buckets() {
+        let window = NonceCountWindow::new(Duration::from_secs(10));
+        let start = window.origin;
+        assert!(window.accept_at("alice", "n1", 5, start + Duration::from_secs(1)));
+        assert!(window.accept_at("bob", "n1", 5, start + Duration::from_secs(12)));
+        assert_eq!(window.len(), 2);
+        // Bucket 2 retires bucket 0; alice's nonce is long expired by now.
+        assert!(window.accept_at("carol", "n1", 1, start + Duration::from_secs(21)));
+        assert!(window.accept_at("alice", "n1", 1, start + Duration::from_secs(21)));
+        assert!(!window.accept_at("bob", "n1", 5, start + Duration::from_secs(21)));
+    }
+}
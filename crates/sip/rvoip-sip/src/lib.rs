@@ -548,9 +548,9 @@ pub use auth::{
     AuthDecision, AuthFailureReason, AuthIdentity, AuthRateLimitKey, AuthRateLimitKind,
     AuthRateLimitVerdict, AuthRateLimiter, BearerAuthError, BearerValidator, ClientAuthHeader,
     CredentialAuthError, DigestAlgorithm, DigestAuth, DigestAuthenticator, DigestChallenge,
-    DigestChallengeDetails, DigestComputed, DigestNonceStatus, DigestReplayStore, DigestResponse,
-    DigestSecret, DigestSecretProvider, JwksJwtValidator, JwtValidator,
-    OAuth2IntrospectionValidator, PasswordVerifier, SipAuthChallenge, SipAuthContext,
+    DigestChallengeDetails, DigestComputed, DigestNonceSigner, DigestNonceStatus,
+    DigestReplayStore, DigestResponse, DigestSecret, DigestSecretProvider, JwksJwtValidator,
+    JwtValidator, OAuth2IntrospectionValidator, PasswordVerifier, SipAuthChallenge, SipAuthContext,
     SipAuthDecision, SipAuthPolicy, SipAuthScheme, SipAuthService, SipAuthSource, SipClientAuth,
     SipDigestAuthService, SipIncomingAuthenticator, SipTransportSecurityContext,
     TokenRevocationChecker, TokenRevocationContext, TokenRevocationStatus,
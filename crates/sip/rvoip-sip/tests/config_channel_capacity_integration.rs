@@ -258,6 +258,7 @@ fn rtp_media_buffer_tuning_is_configurable() {
         event_channel_capacity: 12,
         recv_buffer_size: 2048,
         rtcp_recv_buffer_size: 1024,
+        ..Default::default()
     };
     let mut media_config = MediaSessionControllerConfig::default();
     media_config.audio_frame_pool.initial_size = 8;
@@ -128,6 +128,7 @@ fn test_config_graduated_perf_knobs_are_configurable() {
         event_channel_capacity: 12,
         recv_buffer_size: 2048,
         rtcp_recv_buffer_size: 1024,
+        ..Default::default()
     };
     let mut media_controller_config = MediaSessionControllerConfig::default();
     media_controller_config.rtp_buffer_size = 960;
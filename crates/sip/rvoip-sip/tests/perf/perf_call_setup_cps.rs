@@ -17,9 +17,17 @@
 //!   per-point JSONs plus aggregated `_sweep.json` and a
 //!   publication-ready `_sweep.md` table under
 //!   `target/perf-results/perf_call_setup_cps/`.
+//! - **Shard scaling**: set `RVOIP_PERF_SWEEP_SHARDS=1,2,4,8` to boot a
+//!   fresh Bob per point with sharded transaction execution (that many
+//!   per-core shards, fed by as many branch-hashed UDP parse workers) and
+//!   drive each at the first CPS point. Writes the CPS-vs-shards table to
+//!   `target/perf-results/perf_call_setup_cps_shard_scaling/`. Offer more
+//!   load than one shard sustains, and relax the ASR gate
+//!   (`RVOIP_PERF_MIN_ASR`) to chart past the knee.
 //!
 //! Env knobs:
 //! - `RVOIP_PERF_SWEEP_CPS`     (comma-separated points; enables sweep mode)
+//! - `RVOIP_PERF_SWEEP_SHARDS`  (comma-separated shard counts; enables shard scaling)
 //! - `RVOIP_PERF_TARGET_CPS`    (single-point default; 100)
 //! - `RVOIP_PERF_RAMP_SECS`     (default 5)
 //! - `RVOIP_PERF_STEADY_SECS`   (default 30)
@@ -47,6 +55,8 @@ use rvoip_sip::api::callback_peer::{
 use rvoip_sip::api::incoming::IncomingCall;
 use rvoip_sip::api::unified::{Config, UnifiedCoordinator};
 use rvoip_sip::PerformanceConfig;
+use rvoip_sip_dialog::transaction::TransactionExecutionMode;
+use rvoip_sip_transport::UdpParseDispatch;
 use serde_json::{json, Value};
 use tokio::task::{JoinHandle, JoinSet};
 
@@ -391,14 +401,43 @@ fn perf_call_setup_cps() {
 }
 
 async fn perf_call_setup_cps_inner() {
+    let Some(shard_counts) = parse_sweep_env("RVOIP_PERF_SWEEP_SHARDS") else {
+        run_call_setup_cps(None).await;
+        return;
+    };
+
+    let scenario = std::env::var("RVOIP_PERF_REPORT_SCENARIO")
+        .unwrap_or_else(|_| "perf_call_setup_cps".to_string());
+    let mut scaling = SweepRunner::new(
+        format!("{scenario}_shard_scaling"),
+        shard_counts.clone(),
+        "Transaction shards",
+        "achieved_cps",
+        "ASR",
+    );
+    for shards in shard_counts {
+        run_call_setup_cps(Some((shards as usize, &mut scaling))).await;
+    }
+    let _written = scaling.finalize();
+}
+
+/// Boot Bob and the Alice shards, then drive every CPS point. With
+/// `shard_run = Some((shards, scaling))`, Bob runs sharded transaction
+/// execution with `shards` shards, only the first CPS point is driven, and
+/// its report goes to the `scaling` sweep keyed by shard count.
+async fn run_call_setup_cps(mut shard_run: Option<(usize, &mut SweepRunner)>) {
     // Sweep points: env-driven list, or fall back to a single-point
     // run pinned at RVOIP_PERF_TARGET_CPS (default 100).
-    let points = parse_sweep_env("RVOIP_PERF_SWEEP_CPS").unwrap_or_else(|| {
+    let mut points = parse_sweep_env("RVOIP_PERF_SWEEP_CPS").unwrap_or_else(|| {
         vec![std::env::var("RVOIP_PERF_TARGET_CPS")
             .ok()
             .and_then(|s| s.parse().ok())
             .unwrap_or(100.0)]
     });
+    let transaction_shards = shard_run.as_ref().map(|(shards, _)| *shards);
+    if transaction_shards.is_some() {
+        points.truncate(1);
+    }
 
     let per_call_timeout = Duration::from_secs(
         std::env::var("RVOIP_PERF_CALL_TIMEOUT_SECS")
@@ -431,7 +470,7 @@ async fn perf_call_setup_cps_inner() {
     );
 
     let bob_port = support::ports::next_sip_port();
-    let bob_cfg = apply_same_host_media_carveout(
+    let mut bob_cfg = apply_same_host_media_carveout(
         perf_config(
             Config::local("perf-bob", bob_port),
             channel_capacity,
@@ -442,6 +481,9 @@ async fn perf_call_setup_cps_inner() {
         SAME_HOST_BOB_MEDIA_END,
         channel_capacity,
     );
+    if let Some(shards) = transaction_shards {
+        bob_cfg = with_transaction_shards(bob_cfg, shards);
+    }
     let alice_recipe = if profile == "legacy" {
         "legacy"
     } else {
@@ -472,6 +514,7 @@ async fn perf_call_setup_cps_inner() {
         "report_scenario": report_scenario.clone(),
         "client_profile": alice_recipe,
         "alice_shards": alice_shards,
+        "transaction_shards": transaction_shards,
         "recipe_file": recipe_path,
         "channel_capacity": channel_capacity,
         "alice_channel_capacity_per_shard": alice_capacity,
@@ -536,7 +579,7 @@ async fn perf_call_setup_cps_inner() {
         if let Some(obj) = point_effective_config.as_object_mut() {
             obj.insert("max_in_flight_limit".to_string(), json!(max_in_flight));
         }
-        let report = run_one_point(
+        let mut report = run_one_point(
             report_scenario.clone(),
             Arc::clone(&clients),
             target.clone(),
@@ -546,6 +589,16 @@ async fn perf_call_setup_cps_inner() {
             point_effective_config,
         )
         .await;
+        if let Some(shards) = transaction_shards {
+            let achieved = report
+                .to_json()
+                .pointer("/results/achieved_cps")
+                .and_then(|v| v.as_f64())
+                .unwrap_or(0.0);
+            report
+                .result("transaction_shards", shards as u64)
+                .result("cps_per_shard", round2(achieved / shards as f64));
+        }
         let report_json = report.to_json();
         let asr = report_json
             .pointer("/results/asr")
@@ -564,10 +617,15 @@ async fn perf_call_setup_cps_inner() {
                 point, asr, min_asr, harness_backpressure
             ));
         }
-        sweep.add_point(point, report);
+        match shard_run.as_mut() {
+            Some((shards, scaling)) => scaling.add_point(*shards as f64, report),
+            None => sweep.add_point(point, report),
+        }
     }
 
-    let _written = sweep.finalize();
+    if shard_run.is_none() {
+        let _written = sweep.finalize();
+    }
 
     bob.shutdown.shutdown();
     let _ = tokio::time::timeout(Duration::from_secs(3), bob.task).await;
@@ -637,6 +695,18 @@ fn perf_config(
     }
 }
 
+/// Run Bob's transactions on `shards` per-core shards, with one branch
+/// hashed UDP parse worker per shard so each worker feeds a single shard
+fn with_transaction_shards(config: Config, shards: usize) -> Config {
+    let parse_queue_capacity = config.sip_udp_parse_queue_capacity;
+    let dispatch_queue_capacity = config.sip_transaction_dispatch_queue_capacity;
+    config
+        .with_sip_transaction_execution_mode(TransactionExecutionMode::Sharded)
+        .with_sip_transaction_dispatch_config(Some(shards), dispatch_queue_capacity)
+        .with_sip_udp_parse_config(Some(shards), parse_queue_capacity)
+        .with_sip_udp_parse_dispatch(UdpParseDispatch::TransactionShard)
+}
+
 fn apply_same_host_media_carveout(
     config: Config,
     start: u16,
@@ -690,6 +760,7 @@ fn config_snapshot(config: &Config) -> Value {
         "transaction_event_channel_capacity": config.transaction_event_channel_capacity,
         "sip_transaction_dispatch_workers": config.sip_transaction_dispatch_workers,
         "sip_transaction_dispatch_queue_capacity": config.sip_transaction_dispatch_queue_capacity,
+        "sip_transaction_execution_mode": format!("{:?}", config.sip_transaction_execution_mode),
         "sip_transaction_command_channel_capacity": config.sip_transaction_command_channel_capacity,
         "effective_sip_transaction_command_channel_capacity": config
             .sip_transaction_command_channel_capacity
@@ -21,6 +21,17 @@
 //! - `RVOIP_PERF_CALL_RATIO_PCT`   (default 80 — share of ops that are calls)
 //! - `RVOIP_PERF_STEADY_SECS`      (default 20)
 //! - `RVOIP_PERF_CALL_TIMEOUT_SECS` (default 15)
+//! - `RVOIP_PERF_MIXED_TRANSCODE_STREAMS` (default 0 — no media load)
+//! - `RVOIP_PERF_MIXED_TRANSCODE_PTS` (default `0:8`, PCMU→PCMA; `0:111`
+//!   needs `rvoip-media-core/opus`)
+//! - `RVOIP_PERF_MIXED_MEDIA_WORKERS` (default: `MediaWorkerConfig` default)
+//!
+//! Transcoding density: with `RVOIP_PERF_MIXED_TRANSCODE_STREAMS=N` every
+//! point runs twice under N bridge frame pumps, each transcoding one 20 ms
+//! frame per tick in the same process — once transcoding inline on the
+//! tokio runtime (`perf_mixed_workload`), once on a dedicated
+//! `MediaWorkerPool` (`perf_mixed_workload_media_pool`). Compare the
+//! `sip_latency` p99 (calls and REGISTERs together) between the two.
 
 #![allow(clippy::needless_return)]
 
@@ -28,6 +39,13 @@ use std::sync::atomic::{AtomicU64, Ordering};
 use std::sync::Arc;
 use std::time::Duration;
 
+use bytes::Bytes;
+use rvoip_core::bridge::frame_pump::{spawn_pump_with_pool, TranscoderSwap};
+use rvoip_core::ids::StreamId;
+use rvoip_core::stream::{MediaFrame, StreamKind};
+use rvoip_media_core::codec::transcoding::Transcoder;
+use rvoip_media_core::codec::worker_pool::{MediaWorkerConfig, MediaWorkerPool};
+use rvoip_media_core::processing::format::FormatConverter;
 use rvoip_sip::api::callback_peer::{
     CallHandler, CallHandlerDecision, CallbackPeer, ShutdownHandle,
 };
@@ -37,6 +55,7 @@ use rvoip_sip::api::stream_peer::EventReceiver;
 use rvoip_sip::api::unified::{Config, UnifiedCoordinator};
 use serde_json::json;
 use tokio::net::UdpSocket;
+use tokio::sync::{mpsc, RwLock};
 use tokio::task::JoinHandle;
 
 #[path = "support/mod.rs"]
@@ -130,11 +149,142 @@ async fn boot_mock_registrar(port: u16) -> JoinHandle<()> {
     })
 }
 
+/// Bridge frame pumps transcoding synthetic 20 ms frames in-process,
+/// inline on the runtime (`pool: None`) or on a media worker pool.
+struct TranscodeLoad {
+    feeders: Vec<JoinHandle<()>>,
+    drains: Vec<JoinHandle<()>>,
+    frames_out: Arc<AtomicU64>,
+    pool: Option<Arc<MediaWorkerPool>>,
+}
+
+#[derive(Clone, Copy)]
+struct TranscodeSettings {
+    streams: usize,
+    from_pt: u8,
+    to_pt: u8,
+}
+
+fn start_transcode_load(
+    settings: TranscodeSettings,
+    pool: Option<Arc<MediaWorkerPool>>,
+) -> TranscodeLoad {
+    // One 20 ms PCMU frame of a square-ish tone, re-encoded for other
+    // source codecs.
+    let mut source = Transcoder::new(Arc::new(RwLock::new(FormatConverter::new())));
+    let pcmu: Vec<u8> = (0..160u32)
+        .map(|i| if i % 8 < 4 { 0x20 } else { 0xA0 })
+        .collect();
+    let payload = if settings.from_pt == 0 {
+        Bytes::from(pcmu)
+    } else {
+        Bytes::from(
+            source
+                .transcode_blocking(&pcmu, 0, settings.from_pt)
+                .expect("encode source frame"),
+        )
+    };
+
+    let frames_out = Arc::new(AtomicU64::new(0));
+    let mut feeders = Vec::with_capacity(settings.streams);
+    let mut drains = Vec::with_capacity(settings.streams);
+    for i in 0..settings.streams {
+        let (from_tx, from_rx) = mpsc::channel::<MediaFrame>(8);
+        let (to_tx, mut to_rx) = mpsc::channel::<MediaFrame>(8);
+        let (_swap_tx, swap_rx) = mpsc::channel::<TranscoderSwap>(1);
+        let transcoder = Transcoder::new(Arc::new(RwLock::new(FormatConverter::new())));
+        // The pump exits when its feeder is aborted and `from_tx` drops.
+        let _pump = spawn_pump_with_pool(
+            "perf",
+            from_rx,
+            to_tx,
+            Some(transcoder),
+            settings.from_pt,
+            settings.to_pt,
+            swap_rx,
+            pool.clone(),
+        );
+        // Spread stream phases across the 20 ms frame interval.
+        let phase = Duration::from_micros((20_000 * i / settings.streams.max(1)) as u64);
+        let payload = payload.clone();
+        feeders.push(tokio::spawn(async move {
+            tokio::time::sleep(phase).await;
+            let stream_id = StreamId::new();
+            let mut interval = tokio::time::interval(Duration::from_millis(20));
+            interval.set_missed_tick_behavior(tokio::time::MissedTickBehavior::Skip);
+            let mut timestamp_rtp = 0u32;
+            loop {
+                interval.tick().await;
+                let frame = MediaFrame {
+                    stream_id: stream_id.clone(),
+                    kind: StreamKind::Audio,
+                    payload: payload.clone(),
+                    timestamp_rtp,
+                    captured_at: chrono::Utc::now(),
+                    payload_type: None,
+                };
+                timestamp_rtp = timestamp_rtp.wrapping_add(160);
+                if from_tx.try_send(frame).is_err() && from_tx.is_closed() {
+                    return;
+                }
+            }
+        }));
+        let frames_out = Arc::clone(&frames_out);
+        drains.push(tokio::spawn(async move {
+            while to_rx.recv().await.is_some() {
+                frames_out.fetch_add(1, Ordering::Relaxed);
+            }
+        }));
+    }
+    TranscodeLoad {
+        feeders,
+        drains,
+        frames_out,
+        pool,
+    }
+}
+
+impl TranscodeLoad {
+    /// Stop feeding, let the pumps drain and return the load's summary.
+    async fn stop(self, settings: TranscodeSettings) -> serde_json::Value {
+        for feeder in &self.feeders {
+            feeder.abort();
+        }
+        let _ = tokio::time::timeout(Duration::from_secs(5), async {
+            for drain in self.drains {
+                let _ = drain.await;
+            }
+        })
+        .await;
+        let mut block = json!({
+            "streams": settings.streams,
+            "from_pt": settings.from_pt,
+            "to_pt": settings.to_pt,
+            "mode": if self.pool.is_some() { "media_worker_pool" } else { "inline" },
+            "frames_out": self.frames_out.load(Ordering::Relaxed),
+        });
+        if let Some(pool) = &self.pool {
+            let stats = pool.stats();
+            block["pool"] = json!({
+                "workers": stats.workers,
+                "frames": stats.frames,
+                "failures": stats.failures,
+                "dropped": stats.dropped,
+                "ticks": stats.ticks,
+                "overruns": stats.overruns,
+                "longest_batch_us": stats.longest_batch.as_micros() as u64,
+            });
+        }
+        block
+    }
+}
+
 async fn run_one_call(
     alice: Arc<UnifiedCoordinator>,
     from: String,
     target: String,
     setup_hist: Arc<LatencyHistogram>,
+    sip_hist: Arc<LatencyHistogram>,
     counters: Arc<FlowCounters>,
     call_timeout: Duration,
 ) {
@@ -152,7 +302,9 @@ async fn run_one_call(
         counters.timeout.fetch_add(1, Ordering::Relaxed);
         return;
     }
-    setup_hist.record_nanos(t_send.elapsed().as_nanos() as u64);
+    let setup_nanos = t_send.elapsed().as_nanos() as u64;
+    setup_hist.record_nanos(setup_nanos);
+    sip_hist.record_nanos(setup_nanos);
     if handle.hangup_and_wait(Some(call_timeout)).await.is_ok() {
         counters.succeeded.fetch_add(1, Ordering::Relaxed);
     } else {
@@ -166,6 +318,7 @@ async fn run_one_register(
     from_uri: String,
     contact_uri: String,
     latency: Arc<LatencyHistogram>,
+    sip_hist: Arc<LatencyHistogram>,
     counters: Arc<FlowCounters>,
     reg_timeout: Duration,
 ) {
@@ -202,7 +355,9 @@ async fn run_one_register(
     .await;
     match waited {
         Ok(true) => {
-            latency.record_nanos(t_send.elapsed().as_nanos() as u64);
+            let nanos = t_send.elapsed().as_nanos() as u64;
+            latency.record_nanos(nanos);
+            sip_hist.record_nanos(nanos);
             counters.succeeded.fetch_add(1, Ordering::Relaxed);
         }
         Ok(false) => {
@@ -214,7 +369,9 @@ async fn run_one_register(
     }
 }
 
+#[allow(clippy::too_many_arguments)]
 async fn run_one_point(
+    scenario: &str,
     alice: Arc<UnifiedCoordinator>,
     call_from: String,
     call_target: String,
@@ -224,6 +381,8 @@ async fn run_one_point(
     call_ratio_pct: u8,
     steady_secs: u64,
     call_timeout: Duration,
+    transcode: Option<TranscodeSettings>,
+    pool: Option<Arc<MediaWorkerPool>>,
 ) -> ScenarioReport {
     let load = LoadProfile {
         target_cps: total_ops_per_sec,
@@ -234,15 +393,18 @@ async fn run_one_point(
 
     let call_hist = Arc::new(LatencyHistogram::new("setup_latency"));
     let reg_hist = Arc::new(LatencyHistogram::new("register_latency"));
+    let sip_hist = Arc::new(LatencyHistogram::new("sip_latency"));
     let call_counters = Arc::new(FlowCounters::default());
     let reg_counters = Arc::new(FlowCounters::default());
     let handles = Arc::new(tokio::sync::Mutex::new(Vec::<JoinHandle<()>>::new()));
     let sampler = ResourceSampler::start(Duration::from_millis(500));
+    let media_load = transcode.map(|settings| (settings, start_transcode_load(settings, pool)));
 
     let active_wall = {
         let alice = Arc::clone(&alice);
         let call_hist = Arc::clone(&call_hist);
         let reg_hist = Arc::clone(&reg_hist);
+        let sip_hist = Arc::clone(&sip_hist);
         let call_counters = Arc::clone(&call_counters);
         let reg_counters = Arc::clone(&reg_counters);
         let handles = Arc::clone(&handles);
@@ -255,6 +417,7 @@ async fn run_one_point(
             let alice = Arc::clone(&alice);
             let call_hist = Arc::clone(&call_hist);
             let reg_hist = Arc::clone(&reg_hist);
+            let sip_hist = Arc::clone(&sip_hist);
             let call_counters = Arc::clone(&call_counters);
             let reg_counters = Arc::clone(&reg_counters);
             let from = call_from.clone();
@@ -265,7 +428,16 @@ async fn run_one_point(
             let handles_for_record = Arc::clone(&handles);
             let h = if is_call {
                 tokio::spawn(async move {
-                    run_one_call(alice, from, target, call_hist, call_counters, call_timeout).await;
+                    run_one_call(
+                        alice,
+                        from,
+                        target,
+                        call_hist,
+                        sip_hist,
+                        call_counters,
+                        call_timeout,
+                    )
+                    .await;
                 })
             } else {
                 tokio::spawn(async move {
@@ -275,6 +447,7 @@ async fn run_one_point(
                         aor,
                         aor_contact,
                         reg_hist,
+                        sip_hist,
                         reg_counters,
                         call_timeout,
                     )
@@ -298,6 +471,10 @@ async fn run_one_point(
         }
     })
     .await;
+    let media_block = match media_load {
+        Some((settings, load)) => Some(load.stop(settings).await),
+        None => None,
+    };
     let resources = sampler.stop().await;
 
     let call_offered = call_counters.offered.load(Ordering::Relaxed);
@@ -320,7 +497,7 @@ async fn run_one_point(
         0.0
     };
 
-    let mut report = ScenarioReport::new("perf_mixed_workload", load);
+    let mut report = ScenarioReport::new(scenario, load);
     let cores = report.environment().cpu_count_physical() as f64;
     let cps_per_core = if cores > 0.0 {
         achieved_cps / cores
@@ -348,7 +525,11 @@ async fn run_one_point(
         )
         .latency(&call_hist)
         .latency(&reg_hist)
+        .latency(&sip_hist)
         .with_resources(resources);
+    if let Some(block) = media_block {
+        report.result_block("transcoding", block);
+    }
     report
 }
 
@@ -375,6 +556,38 @@ async fn perf_mixed_workload() {
             .unwrap_or(15),
     );
 
+    let transcode_streams: usize = std::env::var("RVOIP_PERF_MIXED_TRANSCODE_STREAMS")
+        .ok()
+        .and_then(|s| s.parse().ok())
+        .unwrap_or(0);
+    let (from_pt, to_pt) = std::env::var("RVOIP_PERF_MIXED_TRANSCODE_PTS")
+        .ok()
+        .and_then(|s| {
+            let (from, to) = s.split_once(':')?;
+            Some((from.trim().parse().ok()?, to.trim().parse().ok()?))
+        })
+        .unwrap_or((0u8, 8u8));
+    let settings = TranscodeSettings {
+        streams: transcode_streams,
+        from_pt,
+        to_pt,
+    };
+    // (scenario, media worker pool) per pass: one pass without a pool,
+    // plus one with a pool when there is transcoding to put on it.
+    let transcode = (transcode_streams > 0).then_some(settings);
+    let mut passes: Vec<(&str, Option<Arc<MediaWorkerPool>>)> = vec![("perf_mixed_workload", None)];
+    if transcode_streams > 0 {
+        let mut config = MediaWorkerConfig::default();
+        if let Some(workers) = std::env::var("RVOIP_PERF_MIXED_MEDIA_WORKERS")
+            .ok()
+            .and_then(|s| s.parse().ok())
+        {
+            config.workers = workers;
+        }
+        let pool = Arc::new(MediaWorkerPool::new(config).expect("media worker pool"));
+        passes.push(("perf_mixed_workload_media_pool", Some(pool)));
+    }
+
     let bob_port = support::ports::next_sip_port();
     let registrar_port = support::ports::next_sip_port();
     let alice_port = support::ports::next_sip_port();
@@ -387,31 +600,36 @@ async fn perf_mixed_workload() {
     let call_target = format!("sip:bob@127.0.0.1:{}", bob_port);
     let registrar_uri = format!("sip:127.0.0.1:{registrar_port}");
 
-    let mut sweep = SweepRunner::new(
-        "perf_mixed_workload",
-        points.clone(),
-        "Total ops/sec",
-        "achieved_cps",
-        "ASR",
-    );
+    for (scenario, pool) in passes {
+        let mut sweep = SweepRunner::new(
+            scenario,
+            points.clone(),
+            "Total ops/sec",
+            "achieved_cps",
+            "ASR",
+        );
 
-    for &point in &points {
-        let report = run_one_point(
-            Arc::clone(&alice),
-            call_from.clone(),
-            call_target.clone(),
-            registrar_uri.clone(),
-            alice_port,
-            point,
-            call_ratio_pct,
-            steady_secs,
-            call_timeout,
-        )
-        .await;
-        sweep.add_point(point, report);
-    }
+        for &point in &points {
+            let report = run_one_point(
+                scenario,
+                Arc::clone(&alice),
+                call_from.clone(),
+                call_target.clone(),
+                registrar_uri.clone(),
+                alice_port,
+                point,
+                call_ratio_pct,
+                steady_secs,
+                call_timeout,
+                transcode,
+                pool.clone(),
+            )
+            .await;
+            sweep.add_point(point, report);
+        }
 
-    let _written = sweep.finalize();
+        let _written = sweep.finalize();
+    }
 
     registrar_task.abort();
     let _ = registrar_task.await;
@@ -8,28 +8,38 @@
 //!
 //! This scenario:
 //!
-//! 1. Pre-populates the mock registrar with `RVOIP_PERF_BINDINGS`
-//!    distinct AORs (one REGISTER per AOR).
-//! 2. Drives **refresh** REGISTERs (same AORs again) at the configured
-//!    rate.
-//! 3. Reports refresh-RPS, refresh latency p99, and the binding table
-//!    size at steady-state.
+//! 1. Measures the registrar store's memory per binding by filling a
+//!    bare `UserRegistry` with `RVOIP_PERF_BINDINGS` AORs.
+//! 2. Pre-populates the mock registrar, which keeps its bindings in a
+//!    `UserRegistry`, with the same AORs (one REGISTER per AOR).
+//! 3. Drives **refresh** REGISTERs (same AORs again) at the configured
+//!    rate while an expiry sweep runs on the registry every
+//!    `RVOIP_PERF_EXPIRY_SWEEP_MS`. Bindings are granted
+//!    `RVOIP_PERF_BINDING_EXPIRES_SECS`, so the AORs the refresh loop
+//!    does not reach in time expire during the steady window.
+//! 4. Reports refresh-RPS, refresh latency p99, the binding table size
+//!    at steady-state, memory per binding, and the registry write
+//!    latency of REGISTERs that overlapped an expiry sweep.
 //!
 //! Env knobs:
-//! - `RVOIP_PERF_SWEEP_BINDINGS`   (sweeps binding count; e.g. 1000,10000)
-//! - `RVOIP_PERF_BINDINGS`         (single-point default; 200)
-//! - `RVOIP_PERF_REFRESH_RPS`      (default 100 — sustained refresh rate)
-//! - `RVOIP_PERF_STEADY_SECS`      (default 20)
+//! - `RVOIP_PERF_SWEEP_BINDINGS`        (sweeps binding count; e.g. 1000,10000)
+//! - `RVOIP_PERF_BINDINGS`              (single-point default; 200)
+//! - `RVOIP_PERF_REFRESH_RPS`           (default 100 — sustained refresh rate)
+//! - `RVOIP_PERF_STEADY_SECS`           (default 20)
+//! - `RVOIP_PERF_BINDING_EXPIRES_SECS`  (default 30 — expiry granted per binding)
+//! - `RVOIP_PERF_EXPIRY_SWEEP_MS`       (default 1000 — expiry sweep cadence)
 
 #![allow(clippy::needless_return)]
 
-use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
 use std::sync::Arc;
 use std::time::Duration;
 
 use rvoip_sip::api::events::Event;
 use rvoip_sip::api::stream_peer::EventReceiver;
 use rvoip_sip::api::unified::{Config, UnifiedCoordinator};
+use rvoip_sip_registrar::registrar::{RegistryConfig, UserRegistry};
+use rvoip_sip_registrar::types::{AddressOfRecord, ContactInfo, ContactReachability, Transport};
 use serde_json::json;
 use tokio::net::UdpSocket;
 use tokio::task::JoinHandle;
@@ -48,10 +58,115 @@ struct Counters {
     timeout: AtomicU64,
 }
 
-/// Mock registrar that holds an in-memory binding table — needed so
-/// the "table size" metric has meaning.
+/// Mock registrar's binding table: the registrar crate's own store, so
+/// the "table size", memory and expiry metrics reflect production code.
 struct BindingTable {
-    bindings: tokio::sync::Mutex<std::collections::HashMap<String, String>>,
+    registry: UserRegistry,
+    binding_expires: u32,
+    /// Odd while an expiry sweep is running.
+    sweep_generation: AtomicU64,
+    sweeps: AtomicU64,
+    expired: AtomicU64,
+    write_latency: LatencyHistogram,
+    write_during_sweep_latency: LatencyHistogram,
+    sweep_duration: LatencyHistogram,
+}
+
+impl BindingTable {
+    fn new(binding_expires: u32) -> Self {
+        Self {
+            registry: short_expiry_registry(),
+            binding_expires,
+            sweep_generation: AtomicU64::new(0),
+            sweeps: AtomicU64::new(0),
+            expired: AtomicU64::new(0),
+            write_latency: LatencyHistogram::new("registry_write_latency"),
+            write_during_sweep_latency: LatencyHistogram::new("registry_write_during_sweep"),
+            sweep_duration: LatencyHistogram::new("expiry_sweep_duration"),
+        }
+    }
+
+    /// Store the binding for `aor`, timing the registry write and noting
+    /// whether it overlapped an expiry sweep.
+    async fn bind(&self, aor: &AddressOfRecord) {
+        let before = self.sweep_generation.load(Ordering::Acquire);
+        let t_write = std::time::Instant::now();
+        let _ = self
+            .registry
+            .register_aor(aor, binding_contact(aor.as_str()), self.binding_expires)
+            .await;
+        let nanos = t_write.elapsed().as_nanos() as u64;
+        let after = self.sweep_generation.load(Ordering::Acquire);
+        self.write_latency.record_nanos(nanos);
+        if before % 2 == 1 || before != after {
+            self.write_during_sweep_latency.record_nanos(nanos);
+        }
+    }
+
+    /// Expire due bindings every `interval`, as `RegistrationManager`
+    /// does, until `stop` is set.
+    async fn run_expiry_sweeps(&self, interval: Duration, stop: &AtomicBool) {
+        let mut ticker = tokio::time::interval(interval);
+        ticker.tick().await;
+        while !stop.load(Ordering::Relaxed) {
+            ticker.tick().await;
+            self.sweep_generation.fetch_add(1, Ordering::AcqRel);
+            let t_sweep = std::time::Instant::now();
+            let expired = self.registry.expire_registrations().await;
+            self.sweep_duration
+                .record_nanos(t_sweep.elapsed().as_nanos() as u64);
+            self.sweep_generation.fetch_add(1, Ordering::AcqRel);
+            self.sweeps.fetch_add(1, Ordering::Relaxed);
+            self.expired
+                .fetch_add(expired.len() as u64, Ordering::Relaxed);
+        }
+    }
+}
+
+fn short_expiry_registry() -> UserRegistry {
+    UserRegistry::with_config(RegistryConfig {
+        min_expires: 1,
+        ..RegistryConfig::default()
+    })
+}
+
+fn binding_contact(uri: &str) -> ContactInfo {
+    ContactInfo {
+        uri: uri.to_string(),
+        instance_id: String::new(),
+        transport: Transport::UDP,
+        user_agent: "perf-alice".to_string(),
+        expires: chrono::Utc::now(),
+        q_value: 1.0,
+        received: None,
+        path: Vec::new(),
+        methods: vec!["INVITE".to_string(), "MESSAGE".to_string()],
+        reg_id: None,
+        flow_id: None,
+        reachability: ContactReachability::Unknown,
+    }
+}
+
+/// Resident bytes per binding of a bare `UserRegistry` holding
+/// `binding_count` AORs shaped like the ones the scenario registers.
+async fn registry_bytes_per_binding(alice_port: u16, binding_count: u64) -> Option<f64> {
+    if binding_count == 0 {
+        return None;
+    }
+    let aors: Vec<AddressOfRecord> = (0..binding_count)
+        .filter_map(|i| {
+            AddressOfRecord::parse(&format!("sip:user-{i:08}@127.0.0.1:{alice_port}")).ok()
+        })
+        .collect();
+    let registry = short_expiry_registry();
+    let before = support::sampler::current_rss_bytes()?;
+    for aor in &aors {
+        let _ = registry
+            .register_aor(aor, binding_contact(aor.as_str()), 3600)
+            .await;
+    }
+    let after = support::sampler::current_rss_bytes()?;
+    Some(after.saturating_sub(before) as f64 / registry.len().max(1) as f64)
 }
 
 async fn boot_mock_registrar(
@@ -87,15 +202,13 @@ async fn boot_mock_registrar(
             };
             count_in.fetch_add(1, Ordering::Relaxed);
 
-            // Track the binding (AOR → placeholder). The From URI
-            // stands in for the AOR; the Contact value isn't surfaced
-            // through a stable API here so we store a constant marker.
-            if let Some(from_uri) = req.from().map(|f| f.uri.to_string()) {
-                table
-                    .bindings
-                    .lock()
-                    .await
-                    .insert(from_uri, "<bound>".to_string());
+            // Track the binding. The From URI stands in for the AOR and,
+            // as the scenario registers it, for the Contact too.
+            if let Some(aor) = req
+                .from()
+                .and_then(|f| AddressOfRecord::parse(&f.uri.to_string()).ok())
+            {
+                table.bind(&aor).await;
             }
 
             let mut resp = create_response(&req, StatusCode::Ok);
@@ -104,7 +217,7 @@ async fn boot_mock_registrar(
             }
             resp.headers.push(TypedHeader::Other(
                 HeaderName::Expires,
-                HeaderValue::Raw(b"3600".to_vec()),
+                HeaderValue::Raw(table.binding_expires.to_string().into_bytes()),
             ));
             let _ = sock
                 .send_to(&Message::Response(resp).to_bytes(), from)
@@ -175,6 +288,7 @@ async fn run_one_point(
     refresh_rps: f64,
     steady_secs: u64,
     reg_timeout: Duration,
+    sweep_interval: Duration,
     table: Arc<BindingTable>,
 ) -> ScenarioReport {
     let prepop_latency = Arc::new(LatencyHistogram::new("prepop_register_latency"));
@@ -182,6 +296,7 @@ async fn run_one_point(
     let prepop_counters = Arc::new(Counters::default());
     let refresh_counters = Arc::new(Counters::default());
 
+    let memory_per_binding = registry_bytes_per_binding(alice_port, binding_count).await;
     let sampler = ResourceSampler::start(Duration::from_millis(500));
 
     // ----- Phase A: pre-populate the binding table. Sequential to
@@ -200,7 +315,15 @@ async fn run_one_point(
         )
         .await;
     }
-    let bindings_at_steady = table.bindings.lock().await.len() as u64;
+    let bindings_at_steady = table.registry.len() as u64;
+
+    // Expiry sweeps run from here on, under the refresh load.
+    let stop_sweeps = Arc::new(AtomicBool::new(false));
+    let sweeper = {
+        let table = Arc::clone(&table);
+        let stop_sweeps = Arc::clone(&stop_sweeps);
+        tokio::spawn(async move { table.run_expiry_sweeps(sweep_interval, &stop_sweeps).await })
+    };
 
     // ----- Phase B: sustained refresh load against the populated table.
     let load = LoadProfile {
@@ -256,6 +379,9 @@ async fn run_one_point(
     })
     .await;
 
+    stop_sweeps.store(true, Ordering::Relaxed);
+    let _ = sweeper.await;
+
     let resources = sampler.stop().await;
     let refresh_offered = refresh_counters.offered.load(Ordering::Relaxed);
     let refresh_succeeded = refresh_counters.succeeded.load(Ordering::Relaxed);
@@ -280,6 +406,11 @@ async fn run_one_point(
     report
         .result("binding_count_target", binding_count)
         .result("bindings_at_steady", bindings_at_steady)
+        .result("bindings_at_end", table.registry.len() as u64)
+        .result("binding_expires_secs", table.binding_expires)
+        .result("bindings_expired", table.expired.load(Ordering::Relaxed))
+        .result("expiry_sweeps", table.sweeps.load(Ordering::Relaxed))
+        .result("memory_per_binding_bytes", memory_per_binding.map(round2))
         .result("achieved_rps", round2(achieved_rps))
         .result("regs_per_core_per_sec", round2(regs_per_core_per_sec))
         .result("rsr", round4(rsr))
@@ -295,6 +426,9 @@ async fn run_one_point(
         )
         .latency(&prepop_latency)
         .latency(&refresh_latency)
+        .latency(&table.write_latency)
+        .latency(&table.write_during_sweep_latency)
+        .latency(&table.sweep_duration)
         .with_resources(resources);
     report
 }
@@ -322,21 +456,22 @@ async fn perf_registrar_binding_scale() {
             .unwrap_or(10),
     );
 
-    let registrar_port = support::ports::next_sip_port();
-    let alice_port = support::ports::next_sip_port();
-    let table = Arc::new(BindingTable {
-        bindings: tokio::sync::Mutex::new(std::collections::HashMap::new()),
-    });
-    let count_in = Arc::new(AtomicU64::new(0));
-    let registrar_task =
-        boot_mock_registrar(registrar_port, Arc::clone(&count_in), Arc::clone(&table)).await;
-    tokio::time::sleep(Duration::from_millis(100)).await;
+    let binding_expires: u32 = std::env::var("RVOIP_PERF_BINDING_EXPIRES_SECS")
+        .ok()
+        .and_then(|s| s.parse().ok())
+        .unwrap_or(30);
+    let sweep_interval = Duration::from_millis(
+        std::env::var("RVOIP_PERF_EXPIRY_SWEEP_MS")
+            .ok()
+            .and_then(|s| s.parse().ok())
+            .unwrap_or(1000),
+    );
 
+    let alice_port = support::ports::next_sip_port();
     let alice = UnifiedCoordinator::new(Config::local("perf-alice", alice_port))
         .await
         .expect("perf alice");
     tokio::time::sleep(Duration::from_millis(200)).await;
-    let registrar_uri = format!("sip:127.0.0.1:{registrar_port}");
 
     let mut sweep = SweepRunner::new(
         "perf_registrar_binding_scale",
@@ -347,27 +482,35 @@ async fn perf_registrar_binding_scale() {
     );
 
     for &point in &points {
-        // Clear table between sweep points to keep per-point bindings
-        // count accurate.
-        table.bindings.lock().await.clear();
+        // A fresh registrar per sweep point keeps the per-point binding
+        // count and histograms accurate.
+        let registrar_port = support::ports::next_sip_port();
+        let table = Arc::new(BindingTable::new(binding_expires));
+        let count_in = Arc::new(AtomicU64::new(0));
+        let registrar_task =
+            boot_mock_registrar(registrar_port, Arc::clone(&count_in), Arc::clone(&table)).await;
+        tokio::time::sleep(Duration::from_millis(100)).await;
+
         let report = run_one_point(
             Arc::clone(&alice),
-            registrar_uri.clone(),
+            format!("sip:127.0.0.1:{registrar_port}"),
             alice_port,
             point.round() as u64,
             refresh_rps,
             steady_secs,
             reg_timeout,
-            Arc::clone(&table),
+            sweep_interval,
+            table,
         )
         .await;
         sweep.add_point(point, report);
+
+        registrar_task.abort();
+        let _ = registrar_task.await;
     }
 
     let _written = sweep.finalize();
 
-    registrar_task.abort();
-    let _ = registrar_task.await;
     drop(alice);
 }
 
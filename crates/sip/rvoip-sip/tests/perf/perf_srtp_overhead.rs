@@ -5,6 +5,11 @@
 //! same metrics plus a `delta_vs_plain_rtp_baseline` block read from a
 //! previous scenario 5 run.
 //!
+//! Built with `--features dhat`, the report also carries an
+//! `srtp_allocations_per_packet` block comparing heap allocations of the
+//! `SrtpContext::protect`/`unprotect` path with the in-place
+//! `protect_in_place`/`unprotect_in_place` path the RTP transport uses.
+//!
 //! Env knobs:
 //! - `RVOIP_PERF_SWEEP_SRTP_CALLS`     (enables sweep mode)
 //! - `RVOIP_PERF_RTP_CALLS`            (reused single-point default; 50)
@@ -18,7 +23,12 @@ use std::sync::atomic::{AtomicU64, Ordering};
 use std::sync::Arc;
 use std::time::Duration;
 
+use bytes::{Bytes, BytesMut};
 use rvoip_media_core::types::AudioFrame;
+use rvoip_rtp_core::srtp::{
+    SrtpContext, SrtpCryptoKey, SrtpCryptoSuite, SRTP_AEAD_AES_128_GCM, SRTP_AES128_CM_SHA1_80,
+};
+use rvoip_rtp_core::{RtpHeader, RtpPacket};
 use rvoip_sip::api::callback_peer::{
     CallHandler, CallHandlerDecision, CallbackPeer, ShutdownHandle,
 };
@@ -27,6 +37,10 @@ use rvoip_sip::api::unified::{Config, UnifiedCoordinator};
 use serde_json::{json, Value};
 use tokio::task::JoinHandle;
 
+#[cfg(feature = "dhat")]
+#[global_allocator]
+static ALLOC: dhat::Alloc = dhat::Alloc;
+
 #[path = "support/mod.rs"]
 mod support;
 use support::{
@@ -36,6 +50,7 @@ use support::{
 const FRAME_SAMPLES: usize = 160;
 const FRAME_INTERVAL_MS: u64 = 20;
 const PPS_PER_STREAM: u64 = 50;
+const ALLOC_SAMPLE_PACKETS: u64 = 1_000;
 
 #[derive(Clone)]
 struct CountingAccept {
@@ -106,6 +121,7 @@ async fn run_one_point(
     call_timeout: Duration,
     sent_frames: Arc<AtomicU64>,
     received_frames: Arc<AtomicU64>,
+    srtp_allocations: Value,
 ) -> ScenarioReport {
     let load = LoadProfile {
         target_cps: target as f64,
@@ -238,6 +254,7 @@ async fn run_one_point(
         .result("frames_received", received)
         .result("frame_loss_pct", round4(frame_loss_pct))
         .result("delta_vs_plain_rtp_baseline", delta)
+        .result("srtp_allocations_per_packet", srtp_allocations)
         .result(
             "errors",
             json!({
@@ -251,6 +268,98 @@ async fn run_one_point(
     report
 }
 
+/// Heap allocations per packet for one protect + unprotect round trip,
+/// legacy vs in-place, for the default SDES suite and AES-GCM. Counted
+/// with the dhat allocator, so only available under `--features dhat`.
+fn measure_srtp_allocations() -> Value {
+    #[cfg(feature = "dhat")]
+    {
+        let _profiler = dhat::Profiler::builder().testing().build();
+        let mut suites = serde_json::Map::new();
+        for (name, suite) in [
+            ("AES_CM_128_HMAC_SHA1_80", SRTP_AES128_CM_SHA1_80),
+            ("AEAD_AES_128_GCM", SRTP_AEAD_AES_128_GCM),
+        ] {
+            let (legacy, in_place) =
+                srtp_allocation_counts(suite, || dhat::HeapStats::get().total_blocks);
+            suites.insert(
+                name.to_string(),
+                json!({
+                    "protect_unprotect_legacy": round2(legacy),
+                    "protect_unprotect_in_place": round2(in_place),
+                }),
+            );
+        }
+        json!({
+            "counter": "dhat",
+            "packets": ALLOC_SAMPLE_PACKETS,
+            "suites": suites,
+        })
+    }
+
+    #[cfg(not(feature = "dhat"))]
+    {
+        json!({
+            "counter": null,
+            "note": "build with --features dhat to count SRTP allocations per packet",
+        })
+    }
+}
+
+/// Returns `(legacy, in_place)` allocations per packet as reported by the
+/// `total_blocks` counter. Contexts and scratch buffers are set up and
+/// warmed before counting so only steady-state work is measured.
+#[cfg_attr(not(feature = "dhat"), allow(dead_code))]
+fn srtp_allocation_counts(suite: SrtpCryptoSuite, total_blocks: impl Fn() -> u64) -> (f64, f64) {
+    let (key_len, salt_len) = (suite.key_length, suite.salt_length());
+    let key = || SrtpCryptoKey::new(vec![0x42; key_len], vec![0x24; salt_len]);
+    let header = RtpHeader::new(0, 1, 160, 0x5eed_5eed);
+    let packet = RtpPacket::new(header, Bytes::from(vec![0u8; FRAME_SAMPLES]));
+
+    let mut tx = SrtpContext::new(suite.clone(), key()).expect("srtp tx context");
+    let mut rx = SrtpContext::new(suite.clone(), key()).expect("srtp rx context");
+    let mut legacy_round_trip = |packet: &mut RtpPacket| {
+        packet.header.sequence_number = packet.header.sequence_number.wrapping_add(1);
+        let wire = tx
+            .protect(packet)
+            .and_then(|p| p.serialize())
+            .expect("legacy protect");
+        rx.unprotect(&wire).expect("legacy unprotect");
+    };
+    let mut warm = packet.clone();
+    legacy_round_trip(&mut warm);
+    let before = total_blocks();
+    for _ in 0..ALLOC_SAMPLE_PACKETS {
+        legacy_round_trip(&mut warm);
+    }
+    let legacy = (total_blocks() - before) as f64 / ALLOC_SAMPLE_PACKETS as f64;
+
+    let mut tx = SrtpContext::new(suite.clone(), key()).expect("srtp tx context");
+    let mut rx = SrtpContext::new(suite, key()).expect("srtp rx context");
+    let mut send_buf = BytesMut::with_capacity(packet.size() + tx.rtp_trailer_len());
+    let mut recv_buf = BytesMut::with_capacity(send_buf.capacity());
+    let mut in_place_round_trip = |packet: &mut RtpPacket| {
+        packet.header.sequence_number = packet.header.sequence_number.wrapping_add(1);
+        send_buf.clear();
+        packet.write_to(&mut send_buf).expect("serialize");
+        tx.protect_in_place(&mut send_buf)
+            .expect("in-place protect");
+        recv_buf.clear();
+        recv_buf.extend_from_slice(&send_buf);
+        rx.unprotect_in_place(&mut recv_buf)
+            .expect("in-place unprotect");
+    };
+    let mut warm = packet;
+    in_place_round_trip(&mut warm);
+    let before = total_blocks();
+    for _ in 0..ALLOC_SAMPLE_PACKETS {
+        in_place_round_trip(&mut warm);
+    }
+    let in_place = (total_blocks() - before) as f64 / ALLOC_SAMPLE_PACKETS as f64;
+
+    (legacy, in_place)
+}
+
 fn read_plain_rtp_baseline_delta(
     target: f64,
     active: u64,
@@ -329,6 +438,10 @@ async fn perf_srtp_overhead() {
             .unwrap_or(30),
     );
 
+    // Measured before any call is up so background tasks don't pollute
+    // the heap counters.
+    let srtp_allocations = measure_srtp_allocations();
+
     let bob_port = support::ports::next_sip_port();
     let alice_port = support::ports::next_sip_port();
     let sent_frames = Arc::new(AtomicU64::new(0));
@@ -357,6 +470,7 @@ async fn perf_srtp_overhead() {
             call_timeout,
             Arc::clone(&sent_frames),
             Arc::clone(&received_frames),
+            srtp_allocations.clone(),
         )
         .await;
         sweep.add_point(point, report);
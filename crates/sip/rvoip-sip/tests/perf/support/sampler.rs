@@ -196,6 +196,18 @@ impl ResourceSampler {
     }
 }
 
+/// Current resident set size of this process in bytes, for before/after
+/// deltas that are too fine for the sampled series.
+pub fn current_rss_bytes() -> Option<u64> {
+    let pid = Pid::from_u32(std::process::id());
+    let mut sys = System::new();
+    sys.refresh_processes_specifics(
+        ProcessesToUpdate::Some(&[pid]),
+        ProcessRefreshKind::new().with_memory(),
+    );
+    sys.process(pid).map(|proc_| proc_.memory())
+}
+
 fn tail_samples(samples: &[ResourceSample], tail_window_secs: f64) -> &[ResourceSample] {
     let Some(last) = samples.last() else {
         return samples;
@@ -3,10 +3,25 @@
 //! Measures `parse_message` (lenient + strict) across the canonical
 //! corpus. Throughput is reported in bytes so degradation from added
 //! per-byte work (e.g. UTF-8 validation) shows up cleanly.
+//!
+//! `lazy` runs `parse_message_lazy`, which only indexes the headers;
+//! `lazy_proxy` additionally reads the headers a stateless proxy needs
+//! (Via, Max-Forwards, From, To, Call-ID, CSeq), so it is the fair
+//! comparison against `lenient` for that kind of consumer.
+//!
+//! `core_scan_head` times the vectorized head pre-pass on its own
+//! (`simd`, the kernel picked for this CPU) next to the portable
+//! reference (`scalar`), in bytes/s. `core_parse_rate` reports whole
+//! messages per second for the full and lazy parsers, which is the
+//! number to compare across revisions for the end-to-end effect.
 
+use bytes::Bytes;
 use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
 use rvoip_sip_core::parser::message::ParseMode;
-use rvoip_sip_core::{parse_message, parse_message_with_mode};
+use rvoip_sip_core::parser::scan::{scan_message_head, scan_message_head_scalar};
+use rvoip_sip_core::types::headers::HeaderAccess;
+use rvoip_sip_core::types::HeaderName;
+use rvoip_sip_core::{parse_message, parse_message_lazy, parse_message_with_mode};
 
 #[path = "common/fixtures.rs"]
 mod fixtures;
@@ -44,5 +59,73 @@ fn bench_parse_strict(c: &mut Criterion) {
     group.finish();
 }
 
-criterion_group!(benches, bench_parse_lenient, bench_parse_strict);
+fn bench_parse_lazy(c: &mut Criterion) {
+    let mut group = c.benchmark_group("core_parse_message");
+    for fx in fixtures::corpus() {
+        let bytes = Bytes::from_static(fx.bytes);
+        group.throughput(Throughput::Bytes(fx.bytes.len() as u64));
+        group.bench_with_input(BenchmarkId::new("lazy", fx.name), &bytes, |b, bytes| {
+            b.iter(|| {
+                let msg = parse_message_lazy(black_box(bytes.clone())).expect("parse");
+                black_box(msg);
+            });
+        });
+        group.bench_with_input(
+            BenchmarkId::new("lazy_proxy", fx.name),
+            &bytes,
+            |b, bytes| {
+                b.iter(|| {
+                    let msg = parse_message_lazy(black_box(bytes.clone())).expect("parse");
+                    black_box(msg.first_via());
+                    black_box(msg.header(&HeaderName::MaxForwards));
+                    black_box(msg.from());
+                    black_box(msg.to());
+                    black_box(msg.call_id());
+                    black_box(msg.cseq());
+                    black_box(msg.has_header(&HeaderName::Route));
+                });
+            },
+        );
+    }
+    group.finish();
+}
+
+fn bench_scan_head(c: &mut Criterion) {
+    let mut group = c.benchmark_group("core_scan_head");
+    for fx in fixtures::corpus() {
+        let head_len = scan_message_head(fx.bytes).end().unwrap_or(fx.bytes.len());
+        group.throughput(Throughput::Bytes(head_len as u64));
+        group.bench_with_input(BenchmarkId::new("simd", fx.name), fx.bytes, |b, bytes| {
+            b.iter(|| black_box(scan_message_head(black_box(bytes))));
+        });
+        group.bench_with_input(BenchmarkId::new("scalar", fx.name), fx.bytes, |b, bytes| {
+            b.iter(|| black_box(scan_message_head_scalar(black_box(bytes))));
+        });
+    }
+    group.finish();
+}
+
+fn bench_parse_rate(c: &mut Criterion) {
+    let mut group = c.benchmark_group("core_parse_rate");
+    group.throughput(Throughput::Elements(1));
+    for fx in fixtures::corpus() {
+        group.bench_with_input(BenchmarkId::new("full", fx.name), fx.bytes, |b, bytes| {
+            b.iter(|| black_box(parse_message(black_box(bytes)).expect("parse")));
+        });
+        let bytes = Bytes::from_static(fx.bytes);
+        group.bench_with_input(BenchmarkId::new("lazy", fx.name), &bytes, |b, bytes| {
+            b.iter(|| black_box(parse_message_lazy(black_box(bytes.clone())).expect("parse")));
+        });
+    }
+    group.finish();
+}
+
+criterion_group!(
+    benches,
+    bench_parse_lenient,
+    bench_parse_strict,
+    bench_parse_lazy,
+    bench_scan_head,
+    bench_parse_rate
+);
 criterion_main!(benches);
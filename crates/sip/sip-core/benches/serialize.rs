@@ -2,14 +2,80 @@
 //!
 //! Measures `Message::to_bytes()` over the canonical corpus. The parser
 //! is invoked once during setup so each iteration only times the
-//! serialization path (Vec allocation + per-header `format!`).
+//! serialization path.
+//!
+//! The `*_lazy_*` groups do the same for `LazyMessage`, whose unmodified
+//! serialization is a copy of the received bytes.
+//!
+//! The `*_wire_*` groups measure `WireFormat`: `write_to` into a reused
+//! buffer (the pooled transport send path), a `PreparedMessage`
+//! retransmission, and a proxy fork derived from a `PreparedMessage`.
+//! Before the groups run, a table of heap allocations per message for
+//! each path is printed; a counting global allocator provides the
+//! numbers.
+
+use std::alloc::{GlobalAlloc, Layout, System};
+use std::sync::atomic::{AtomicUsize, Ordering};
 
+use bytes::{Bytes, BytesMut};
 use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
-use rvoip_sip_core::parse_message;
+use rvoip_sip_core::prelude::*;
+use rvoip_sip_core::types::wire::{PreparedMessage, WireFormat};
+use rvoip_sip_core::{parse_message, parse_message_lazy};
 
 #[path = "common/fixtures.rs"]
 mod fixtures;
 
+/// System allocator that counts allocations
+struct CountingAlloc;
+
+static ALLOCATIONS: AtomicUsize = AtomicUsize::new(0);
+
+unsafe impl GlobalAlloc for CountingAlloc {
+    unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+        ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        System.alloc(layout)
+    }
+
+    unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
+        System.dealloc(ptr, layout)
+    }
+
+    unsafe fn realloc(&self, ptr: *mut u8, layout: Layout, new_size: usize) -> *mut u8 {
+        ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        System.realloc(ptr, layout, new_size)
+    }
+}
+
+#[global_allocator]
+static GLOBAL: CountingAlloc = CountingAlloc;
+
+/// Average allocations per call of `f` over `rounds` calls
+fn allocations_per_call(rounds: usize, mut f: impl FnMut()) -> f64 {
+    f();
+    let before = ALLOCATIONS.load(Ordering::Relaxed);
+    for _ in 0..rounds {
+        f();
+    }
+    (ALLOCATIONS.load(Ordering::Relaxed) - before) as f64 / rounds as f64
+}
+
+/// The edits a proxy makes when forking a request to one target
+fn fork(prepared: &PreparedMessage, target: &Uri) -> PreparedMessage {
+    let via = Via::new(
+        "SIP",
+        "2.0",
+        "UDP",
+        "proxy.example.com",
+        Some(5060),
+        vec![Param::branch("z9hG4bKbenchfork")],
+    )
+    .expect("valid Via");
+    prepared
+        .with_request_uri(target.clone())
+        .with_header_first(TypedHeader::Via(via))
+}
+
 fn bench_to_bytes(c: &mut Criterion) {
     let mut group = c.benchmark_group("core_serialize_message");
     for fx in fixtures::corpus() {
@@ -44,5 +110,158 @@ fn bench_roundtrip(c: &mut Criterion) {
     group.finish();
 }
 
-criterion_group!(benches, bench_to_bytes, bench_roundtrip);
+fn bench_lazy_to_bytes(c: &mut Criterion) {
+    let mut group = c.benchmark_group("core_serialize_lazy_message");
+    for fx in fixtures::corpus() {
+        let msg = parse_message_lazy(Bytes::from_static(fx.bytes)).expect("fixture parses");
+        group.throughput(Throughput::Bytes(fx.bytes.len() as u64));
+        group.bench_with_input(BenchmarkId::from_parameter(fx.name), &msg, |b, msg| {
+            b.iter(|| {
+                let out = black_box(msg).to_bytes();
+                black_box(out);
+            });
+        });
+    }
+    group.finish();
+}
+
+fn bench_lazy_roundtrip(c: &mut Criterion) {
+    let mut group = c.benchmark_group("core_roundtrip_lazy_message");
+    for fx in fixtures::corpus() {
+        let bytes = Bytes::from_static(fx.bytes);
+        group.throughput(Throughput::Bytes(fx.bytes.len() as u64));
+        group.bench_with_input(BenchmarkId::from_parameter(fx.name), &bytes, |b, bytes| {
+            b.iter(|| {
+                let msg = parse_message_lazy(black_box(bytes.clone())).expect("parse");
+                let out = msg.to_bytes();
+                black_box(out);
+            });
+        });
+    }
+    group.finish();
+}
+
+fn report_allocations() {
+    const ROUNDS: usize = 1000;
+    let target: Uri = "sip:bob@192.0.2.4:5060".parse().expect("valid URI");
+
+    println!();
+    println!(
+        "{:<20} {:>10} {:>10} {:>10} {:>12} {:>10}",
+        "fixture", "to_bytes", "write_to", "to_wire", "prepared_tx", "fork"
+    );
+    for fx in fixtures::corpus() {
+        let msg = parse_message(fx.bytes).expect("fixture parses");
+        let prepared = PreparedMessage::new(msg.clone());
+        let mut buf = BytesMut::with_capacity(8192);
+
+        let to_bytes = allocations_per_call(ROUNDS, || {
+            black_box(msg.to_bytes());
+        });
+        let write_to = allocations_per_call(ROUNDS, || {
+            buf.clear();
+            msg.write_to(&mut buf);
+        });
+        let to_wire = allocations_per_call(ROUNDS, || {
+            black_box(msg.to_wire());
+        });
+        let prepared_tx = allocations_per_call(ROUNDS, || {
+            buf.clear();
+            prepared.write_to(&mut buf);
+        });
+        let forked = matches!(msg, Message::Request(_)).then(|| {
+            allocations_per_call(ROUNDS, || {
+                buf.clear();
+                fork(&prepared, &target).write_to(&mut buf);
+            })
+        });
+        println!(
+            "{:<20} {:>10.1} {:>10.1} {:>10.1} {:>12.1} {:>10}",
+            fx.name,
+            to_bytes,
+            write_to,
+            to_wire,
+            prepared_tx,
+            forked.map_or_else(|| "-".to_string(), |n| format!("{n:.1}"))
+        );
+    }
+    println!();
+}
+
+fn bench_write_to(c: &mut Criterion) {
+    report_allocations();
+
+    let mut group = c.benchmark_group("core_serialize_wire_write_to");
+    for fx in fixtures::corpus() {
+        let msg = parse_message(fx.bytes).expect("fixture parses");
+        let mut buf = BytesMut::with_capacity(8192);
+        group.throughput(Throughput::Bytes(fx.bytes.len() as u64));
+        group.bench_with_input(BenchmarkId::from_parameter(fx.name), &msg, |b, msg| {
+            b.iter(|| {
+                buf.clear();
+                black_box(msg).write_to(&mut buf);
+                black_box(&buf);
+            });
+        });
+    }
+    group.finish();
+}
+
+fn bench_prepared_retransmit(c: &mut Criterion) {
+    let mut group = c.benchmark_group("core_serialize_wire_retransmit");
+    for fx in fixtures::corpus() {
+        let prepared = PreparedMessage::new(parse_message(fx.bytes).expect("fixture parses"));
+        let mut buf = BytesMut::with_capacity(8192);
+        group.throughput(Throughput::Bytes(fx.bytes.len() as u64));
+        group.bench_with_input(
+            BenchmarkId::from_parameter(fx.name),
+            &prepared,
+            |b, prepared| {
+                b.iter(|| {
+                    buf.clear();
+                    black_box(prepared).write_to(&mut buf);
+                    black_box(&buf);
+                });
+            },
+        );
+    }
+    group.finish();
+}
+
+fn bench_prepared_fork(c: &mut Criterion) {
+    let target: Uri = "sip:bob@192.0.2.4:5060".parse().expect("valid URI");
+    let mut group = c.benchmark_group("core_serialize_wire_fork");
+    for fx in fixtures::corpus() {
+        let msg = parse_message(fx.bytes).expect("fixture parses");
+        if !matches!(msg, Message::Request(_)) {
+            continue;
+        }
+        let prepared = PreparedMessage::new(msg);
+        let mut buf = BytesMut::with_capacity(8192);
+        group.throughput(Throughput::Bytes(fx.bytes.len() as u64));
+        group.bench_with_input(
+            BenchmarkId::from_parameter(fx.name),
+            &prepared,
+            |b, prepared| {
+                b.iter(|| {
+                    buf.clear();
+                    fork(black_box(prepared), &target).write_to(&mut buf);
+                    black_box(&buf);
+                });
+            },
+        );
+    }
+    group.finish();
+}
+
+criterion_group!(
+    benches,
+    bench_to_bytes,
+    bench_roundtrip,
+    bench_lazy_to_bytes,
+    bench_lazy_roundtrip,
+    bench_write_to,
+    bench_prepared_retransmit,
+    bench_prepared_fork
+);
 criterion_main!(benches);
@@ -220,6 +220,7 @@ pub use builder::{
 pub use error::{Error, Result};
 pub use parser::message::parse_message_with_mode;
 pub use parser::message::ParseMode;
+pub use parser::message::{parse_message_lazy, parse_message_lazy_with_mode};
 pub use parser::parse_message;
 #[cfg(feature = "sdp")]
 pub use sdp::attributes::MediaDirection;
@@ -9,10 +9,12 @@ use crate::parser::request::parse_request_line;
 use crate::error::{Error, Result};
 use crate::parser::common::ParseResult;
 use crate::parser::response::parse_status_line;
+use crate::parser::scan::{scan_header_block, Field, HeadIndex};
 use crate::parser::separators::hcolon;
 use crate::parser::token::token;
 use crate::parser::utils::unfold_lws;
 use crate::parser::whitespace::crlf;
+use crate::types::lazy_message::{HeaderSlot, LazyMessage, LazyStartLine};
 use crate::types::{Header, HeaderName, HeaderValue, TypedHeader};
 use bytes::Bytes;
 use nom::branch::alt;
@@ -56,9 +58,65 @@ pub fn trim_bytes(bytes: &[u8]) -> &[u8] {
 }
 
 /// Parses a block of header lines terminated by an empty line (CRLF).
-/// Uses the `message_header` parser for each line.
 /// Returns a Vec of raw Headers.
+///
+/// Line ends, folds and the terminating empty line come from the
+/// vectorized pre-pass in [`crate::parser::scan`]; nom then only checks
+/// each header's name and colon (see [`split_field`]).
 fn parse_header_block(input: &[u8]) -> ParseResult<'_, Vec<Header>> {
+    let (index, end) = index_header_lines(input)?;
+    let mut headers = Vec::with_capacity(index.lines().len());
+    for field in index.fields(input) {
+        let (name, value) = split_field(input, &field)?;
+        headers.push(Header::new(name, HeaderValue::Raw(unfold_lws(value))));
+    }
+    Ok((&input[end..], headers))
+}
+
+/// Run the pre-pass over a header block; returns the index and the
+/// offset just past the empty line.
+///
+/// The pre-pass only knows CRLF line ends. If it finds no empty line the
+/// block is either malformed, in which case [`parse_header_lines`]
+/// reports the error where the per-line grammar fails, or it ends in a
+/// bare-LF empty line (which `crlf` accepts) and is indexed up to there.
+/// The same fallback handles an LF-led line before the CRLF empty line.
+fn index_header_lines(
+    input: &[u8],
+) -> std::result::Result<(HeadIndex, usize), nom::Err<NomError<&[u8]>>> {
+    let index = scan_header_block(input);
+    if let Some(end) = index.end() {
+        // A line starting with LF would have been taken for the empty
+        // line by the per-line grammar.
+        if !index.lines().iter().any(|line| input[line.start] == b'\n') {
+            return Ok((index, end));
+        }
+    }
+    let (rest, _) = parse_header_lines(input)?;
+    let end = input.len() - rest.len();
+    Ok((scan_header_block(&input[..end]), end))
+}
+
+/// Check a header field found by the pre-pass against `header-name
+/// HCOLON` and return its name and still-folded value. Equivalent to
+/// [`message_header`] on the same line, minus the value scan.
+fn split_field<'a>(
+    input: &'a [u8],
+    field: &Field,
+) -> std::result::Result<(HeaderName, &'a [u8]), nom::Err<NomError<&'a [u8]>>> {
+    let line = &input[field.start..];
+    let (value, (name_bytes, _)) = tuple((header_name, hcolon))(line)?;
+    let name = str::from_utf8(name_bytes)
+        .ok()
+        .and_then(|name| HeaderName::from_str(name).ok())
+        .ok_or_else(|| nom::Err::Error(NomError::new(line, ErrorKind::MapRes)))?;
+    let value_start = (input.len() - value.len()).min(field.end);
+    Ok((name, &input[value_start..field.end]))
+}
+
+/// Per-line header block parser, used when the pre-pass found no CRLF
+/// empty line.
+fn parse_header_lines(input: &[u8]) -> ParseResult<'_, Vec<Header>> {
     // Hand-rolled equivalent of `many_till(message_header, crlf)` that
     // pre-sizes the Vec. The previous `many_till` started from
     // `Vec::with_capacity(0)` and grew via doubling — a typical 8–12
@@ -342,6 +400,115 @@ pub fn parse_message_with_mode(input: &[u8], mode: ParseMode) -> Result<Message>
     }
 }
 
+/// Parse a SIP message lazily, keeping `input` as its backing storage.
+///
+/// Only the start line is parsed; headers are indexed by name and parsed
+/// into [`TypedHeader`]s on first access. See [`LazyMessage`].
+pub fn parse_message_lazy(input: Bytes) -> Result<LazyMessage> {
+    parse_message_lazy_with_mode(input, ParseMode::Lenient)
+}
+
+/// Parse a SIP message lazily with a specific parsing mode.
+///
+/// Start line, header framing and Content-Length are checked as in
+/// [`parse_message_with_mode`]; errors inside individual header values
+/// only surface (as [`TypedHeader::Other`]) when the header is accessed.
+pub fn parse_message_lazy_with_mode(input: Bytes, mode: ParseMode) -> Result<LazyMessage> {
+    let base = &input[..];
+    let failed = |e: nom::Err<NomError<&[u8]>>| match e {
+        nom::Err::Error(e) | nom::Err::Failure(e) => {
+            let offset = base.len() - e.input.len();
+            tracing::debug!(offset, code = ?e.code, "SIP lazy parse failed");
+            Error::ParseError(format!(
+                "Failed to parse message near offset {}: {:?}",
+                offset, e.code
+            ))
+        }
+        nom::Err::Incomplete(_) => Error::ParseError("Incomplete message".to_string()),
+    };
+
+    // 1. Start line
+    let (rest, start_line) = alt((
+        map(parse_request_line, |(method, uri, version)| {
+            LazyStartLine::Request {
+                method,
+                uri,
+                version,
+            }
+        }),
+        map(parse_status_line, |(version, status, reason)| {
+            LazyStartLine::Response {
+                version,
+                status,
+                reason: offset_in(base, reason),
+            }
+        }),
+    ))(base)
+    .map_err(failed)?;
+
+    // 2. Header index, tracking Content-Length (last one wins, as in
+    // full_message_parser)
+    let (rest, headers, content_length) = index_header_block(base, rest).map_err(failed)?;
+    let content_length = content_length.unwrap_or(0);
+
+    // 3. Body
+    let body_start = base.len() - rest.len();
+    let body_len = if rest.len() < content_length {
+        if mode == ParseMode::Strict {
+            return Err(Error::ParseError("Incomplete message".to_string()));
+        }
+        rest.len()
+    } else {
+        if mode == ParseMode::Strict && rest.len() > content_length {
+            return Err(Error::ParseError(format!(
+                "Failed to parse message near offset {}: {:?}",
+                body_start + content_length,
+                ErrorKind::Eof
+            )));
+        }
+        content_length
+    };
+    let end = body_start + body_len;
+
+    Ok(LazyMessage::new(
+        input.slice(..end),
+        start_line,
+        headers,
+        body_start..end,
+    ))
+}
+
+/// Index a header block like [`parse_header_block`]: record each header's
+/// name and value span within `base` instead of building raw `Header`s.
+/// Also returns the last valid Content-Length.
+fn index_header_block<'a>(
+    base: &[u8],
+    input: &'a [u8],
+) -> ParseResult<'a, (Vec<HeaderSlot>, Option<usize>)> {
+    let (index, end) = index_header_lines(input)?;
+    let mut headers = Vec::with_capacity(index.lines().len());
+    let mut content_length = None;
+    for field in index.fields(input) {
+        let (name, value) = split_field(input, &field)?;
+        if name == HeaderName::ContentLength {
+            if let Some(cl) = str::from_utf8(value)
+                .ok()
+                .and_then(|s| s.trim().parse::<usize>().ok())
+            {
+                content_length = Some(cl);
+            }
+        }
+        headers.push(HeaderSlot::new(name, offset_in(base, value)));
+    }
+    Ok((&input[end..], (headers, content_length)))
+}
+
+/// Range of `part` within `base`; `part` must be a subslice of `base`
+fn offset_in(base: &[u8], part: &[u8]) -> std::ops::Range<usize> {
+    let start = part.as_ptr() as usize - base.as_ptr() as usize;
+    start..start + part.len()
+}
+
 /// Parse a SIP message from bytes (legacy API, kept for compatibility)
 pub fn parse_message_bytes(input: &[u8]) -> Result<Message> {
     parse_message(input)
@@ -12,6 +12,7 @@ pub mod message;
 pub mod multipart;
 mod request;
 mod response;
+pub mod scan;
 pub mod uri;
 pub mod utils;
 pub mod via_locator;
@@ -26,6 +27,7 @@ pub use message::{parse_message /*, IncrementalParser, ParseState*/}; // Removed
                                                                       // pub use response::response_parser; // Removed
                                                                       // Commenting out potentially unresolved imports
 pub use crate::types::multipart::{MimePart, MultipartBody};
+pub use message::parse_message_lazy;
 pub use multipart::parse_multipart;
 pub use uri::{parse_uri /*, parse_uri_params, parse_host_port*/};
 
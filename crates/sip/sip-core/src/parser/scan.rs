@@ -0,0 +1,602 @@
+//! Vectorized pre-pass over the head of a SIP message
+//!
+//! Before any grammar runs, the parser, the lazy parser, the Via locator
+//! and the stream transports' framers all need the same structure: where
+//! each line ends, where the name/value colon of each header sits, and
+//! where the blank line separating the head from the body is. This
+//! module finds all three in one pass and records them in a
+//! [`HeadIndex`], so none of those consumers walks the head byte by byte.
+//!
+//! The pass compares 16 or 32 bytes at a time against `\r` and `:` (SSE2
+//! or AVX2 on x86_64, NEON on aarch64, a portable loop elsewhere) and
+//! only visits the matching positions. Scanning stops at the blank line,
+//! so the body is never touched.
+//!
+//! Lines end at CRLF only; a bare CR or LF is ordinary content, as in the
+//! header grammar. Folded continuation lines (starting with SP or HTAB)
+//! are kept as separate [`Line`]s and joined back into one [`Field`] by
+//! [`HeadIndex::fields`].
+//!
+//! Callers that want a single header can use [`find_message_field`]
+//! instead, which runs the same kernels but records nothing and stops as
+//! soon as that header is complete.
+//!
+//! ## Examples
+//!
+//! ```rust
+//! use rvoip_sip_core::parser::scan::scan_message_head;
+//!
+//! let msg = b"SIP/2.0 200 OK\r\nCall-ID: a@b\r\nl: 3\r\n\r\nabc";
+//! let head = scan_message_head(msg);
+//! assert_eq!(head.end(), Some(msg.len() - 3));
+//! assert_eq!(head.content_length(msg), Some(3));
+//!
+//! let call_id = head.find_field(msg, b"Call-ID", Some(b'i')).unwrap();
+//! assert_eq!(call_id.value(msg), b"a@b");
+//! ```
+
+/// One physical line of a message head, without its CRLF
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct Line {
+    /// Offset of the first byte of the line
+    pub start: usize,
+    /// Offset of the terminating `\r`
+    pub end: usize,
+    /// Offset of the first `:` on the line, if any
+    pub colon: Option<usize>,
+}
+
+/// A logical header field: one header line plus any folded continuation
+/// lines
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct Field {
+    /// Offset of the first byte of the header name
+    pub start: usize,
+    /// Offset of the name/value colon, if the first line has one
+    pub colon: Option<usize>,
+    /// Offset of the `\r` ending the first physical line
+    pub first_line_end: usize,
+    /// Offset of the `\r` ending the last continuation line
+    pub end: usize,
+}
+
+impl Field {
+    /// Header name: the bytes before the colon, without trailing SP/HTAB.
+    /// Empty when the line has no colon.
+    pub fn name<'a>(&self, input: &'a [u8]) -> &'a [u8] {
+        match self.colon {
+            Some(colon) => trim_wsp_end(&input[self.start..colon]),
+            None => &[],
+        }
+    }
+
+    /// Header value: the bytes after the colon up to the final CRLF, with
+    /// leading SP/HTAB removed and folds left in place. Empty when the
+    /// line has no colon.
+    pub fn value<'a>(&self, input: &'a [u8]) -> &'a [u8] {
+        match self.colon {
+            Some(colon) => trim_wsp_start(&input[colon + 1..self.end]),
+            None => &[],
+        }
+    }
+
+    /// True if the header name is `long` or the compact form `compact`,
+    /// compared case-insensitively (RFC 3261 §7.3.3)
+    pub fn has_name(&self, input: &[u8], long: &[u8], compact: Option<u8>) -> bool {
+        let name = self.name(input);
+        name.eq_ignore_ascii_case(long)
+            || compact.is_some_and(|c| name.len() == 1 && name[0].eq_ignore_ascii_case(&c))
+    }
+}
+
+/// Line structure of a message head, produced by [`scan_message_head`] or
+/// [`scan_header_block`]
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct HeadIndex {
+    lines: Vec<Line>,
+    /// 1 when `lines[0]` is a start line, 0 for a bare header block
+    first_header: usize,
+    end: Option<usize>,
+}
+
+impl HeadIndex {
+    /// Every complete line before the blank line, start line included
+    pub fn lines(&self) -> &[Line] {
+        &self.lines
+    }
+
+    /// The request- or status-line, for an index built by
+    /// [`scan_message_head`]
+    pub fn start_line(&self) -> Option<&Line> {
+        if self.first_header == 1 {
+            self.lines.first()
+        } else {
+            None
+        }
+    }
+
+    /// Offset just past the blank line ending the head (the start of the
+    /// body), or `None` if the input stops before it
+    pub fn end(&self) -> Option<usize> {
+        self.end
+    }
+
+    /// True if the blank line ending the head was found
+    pub fn is_complete(&self) -> bool {
+        self.end.is_some()
+    }
+
+    /// Header fields in order, with continuation lines joined
+    pub fn fields<'a>(&'a self, input: &'a [u8]) -> Fields<'a> {
+        Fields {
+            lines: self.lines.get(self.first_header..).unwrap_or_default(),
+            input,
+        }
+    }
+
+    /// First header field named `long` or `compact`
+    pub fn find_field(&self, input: &[u8], long: &[u8], compact: Option<u8>) -> Option<Field> {
+        self.fields(input)
+            .find(|field| field.has_name(input, long, compact))
+    }
+
+    /// Content-Length (or compact `l`) value; the last well-formed one
+    /// wins, as in the message parser (RFC 3261 §20.14)
+    pub fn content_length(&self, input: &[u8]) -> Option<usize> {
+        self.fields(input)
+            .filter(|field| field.has_name(input, b"Content-Length", Some(b'l')))
+            .filter_map(|field| {
+                std::str::from_utf8(field.value(input))
+                    .ok()?
+                    .trim()
+                    .parse()
+                    .ok()
+            })
+            .last()
+    }
+}
+
+/// Iterator over the header fields of a [`HeadIndex`]
+#[derive(Debug, Clone)]
+pub struct Fields<'a> {
+    lines: &'a [Line],
+    input: &'a [u8],
+}
+
+impl Iterator for Fields<'_> {
+    type Item = Field;
+
+    fn next(&mut self) -> Option<Field> {
+        let (first, rest) = self.lines.split_first()?;
+        let folded = rest
+            .iter()
+            .take_while(|line| matches!(self.input[line.start], b' ' | b'\t'))
+            .count();
+        self.lines = &rest[folded..];
+        Some(Field {
+            start: first.start,
+            colon: first.colon,
+            first_line_end: first.end,
+            end: rest[..folded].last().map_or(first.end, |line| line.end),
+        })
+    }
+}
+
+/// Index a whole message: start line, header lines and the head/body
+/// boundary
+pub fn scan_message_head(input: &[u8]) -> HeadIndex {
+    scan(input, 1, false)
+}
+
+/// Index a header block that starts right after the start line
+pub fn scan_header_block(input: &[u8]) -> HeadIndex {
+    scan(input, 0, false)
+}
+
+/// Portable implementation of [`scan_message_head`], which the vector
+/// kernels must match; exposed for tests and benchmarks.
+pub fn scan_message_head_scalar(input: &[u8]) -> HeadIndex {
+    scan(input, 1, true)
+}
+
+/// First header field of a whole message named `long` or `compact`, as
+/// [`HeadIndex::find_field`] would return it. Builds no index: scanning
+/// stops once the field and its continuation lines are complete.
+pub fn find_message_field(input: &[u8], long: &[u8], compact: Option<u8>) -> Option<Field> {
+    let finder = FieldFinder {
+        long,
+        compact,
+        start_line: true,
+        found: None,
+    };
+    run(input, finder, false).sink.found
+}
+
+fn scan(input: &[u8], first_header: usize, scalar_only: bool) -> HeadIndex {
+    let scanner = run(input, Vec::with_capacity(16 + first_header), scalar_only);
+    HeadIndex {
+        lines: scanner.sink,
+        first_header,
+        end: scanner.end,
+    }
+}
+
+fn run<S: LineSink>(input: &[u8], sink: S, scalar_only: bool) -> Scanner<S> {
+    let mut scanner = Scanner {
+        sink,
+        line_start: 0,
+        colon: None,
+        end: None,
+    };
+    let resume = if scalar_only {
+        Some(0)
+    } else {
+        scan_vectorized(input, &mut scanner)
+    };
+    if let Some(offset) = resume {
+        scan_portable(input, offset, &mut scanner);
+    }
+    scanner
+}
+
+/// Receiver of the lines a scan finds, in order
+trait LineSink {
+    /// Take one complete line; returning true stops the scan.
+    fn line(&mut self, input: &[u8], line: Line) -> bool;
+}
+
+impl LineSink for Vec<Line> {
+    #[inline(always)]
+    fn line(&mut self, _input: &[u8], line: Line) -> bool {
+        self.push(line);
+        false
+    }
+}
+
+/// Sink for [`find_message_field`]: matches header names as lines arrive
+/// and stops at the first line after the matching field
+struct FieldFinder<'a> {
+    long: &'a [u8],
+    compact: Option<u8>,
+    /// The next line is the start line, not a header
+    start_line: bool,
+    found: Option<Field>,
+}
+
+impl LineSink for FieldFinder<'_> {
+    fn line(&mut self, input: &[u8], line: Line) -> bool {
+        if std::mem::take(&mut self.start_line) {
+            return false;
+        }
+        let continuation = matches!(input[line.start], b' ' | b'\t');
+        if let Some(field) = self.found.as_mut() {
+            if !continuation {
+                return true;
+            }
+            field.end = line.end;
+            return false;
+        }
+        let field = Field {
+            start: line.start,
+            colon: line.colon,
+            first_line_end: line.end,
+            end: line.end,
+        };
+        // A continuation line's name starts with SP/HTAB, so it never
+        // matches and is skipped along with the field it belongs to.
+        if field.has_name(input, self.long, self.compact) {
+            self.found = Some(field);
+        }
+        false
+    }
+}
+
+/// Line-building state shared by all kernels. Kernels only produce
+/// bitmasks of `\r` / `:` positions; this turns them into lines.
+struct Scanner<S> {
+    sink: S,
+    line_start: usize,
+    colon: Option<usize>,
+    end: Option<usize>,
+}
+
+impl<S: LineSink> Scanner<S> {
+    /// Consume the hits in `mask`, where set bit `i << shift` means
+    /// `input[base + i]` is `\r` or `:`. Returns true once the blank line
+    /// has been seen or the sink has stopped the scan.
+    #[inline(always)]
+    fn visit(&mut self, input: &[u8], base: usize, mut mask: u64, shift: u32) -> bool {
+        while mask != 0 {
+            let pos = base + (mask.trailing_zeros() >> shift) as usize;
+            mask &= mask - 1;
+            if input[pos] == b':' {
+                if self.colon.is_none() {
+                    self.colon = Some(pos);
+                }
+            } else if input.get(pos + 1) == Some(&b'\n') {
+                if pos == self.line_start {
+                    self.end = Some(pos + 2);
+                    return true;
+                }
+                let line = Line {
+                    start: self.line_start,
+                    end: pos,
+                    colon: self.colon.take(),
+                };
+                self.line_start = pos + 2;
+                if self.sink.line(input, line) {
+                    return true;
+                }
+            }
+        }
+        false
+    }
+}
+
+/// Run the widest kernel available from the start of `input`; returns
+/// the offset where the portable loop has to take over, or `None` if the
+/// head ended within the vectorized part.
+#[cfg(target_arch = "x86_64")]
+fn scan_vectorized(input: &[u8], scanner: &mut Scanner<impl LineSink>) -> Option<usize> {
+    // The feature check is a cached atomic load after the first call.
+    if std::is_x86_feature_detected!("avx2") {
+        // SAFETY: AVX2 support was checked above.
+        unsafe { x86::scan_avx2(input, scanner) }
+    } else {
+        // SAFETY: SSE2 is part of the x86_64 baseline.
+        unsafe { x86::scan_sse2(input, scanner) }
+    }
+}
+
+#[cfg(target_arch = "aarch64")]
+fn scan_vectorized(input: &[u8], scanner: &mut Scanner<impl LineSink>) -> Option<usize> {
+    // SAFETY: NEON is part of the aarch64 baseline.
+    unsafe { neon::scan(input, scanner) }
+}
+
+#[cfg(not(any(target_arch = "x86_64", target_arch = "aarch64")))]
+fn scan_vectorized(_input: &[u8], _scanner: &mut Scanner<impl LineSink>) -> Option<usize> {
+    Some(0)
+}
+
+/// Portable kernel: builds the same masks 64 bytes at a time
+fn scan_portable(input: &[u8], from: usize, scanner: &mut Scanner<impl LineSink>) {
+    let mut base = from;
+    for chunk in input[from..].chunks(64) {
+        let mut mask = 0u64;
+        for (i, &byte) in chunk.iter().enumerate() {
+            if byte == b'\r' || byte == b':' {
+                mask |= 1 << i;
+            }
+        }
+        if scanner.visit(input, base, mask, 0) {
+            return;
+        }
+        base += chunk.len();
+    }
+}
+
+#[cfg(target_arch = "x86_64")]
+mod x86 {
+    use super::{LineSink, Scanner};
+    use std::arch::x86_64::*;
+
+    #[target_feature(enable = "sse2")]
+    pub(super) unsafe fn scan_sse2(
+        input: &[u8],
+        scanner: &mut Scanner<impl LineSink>,
+    ) -> Option<usize> {
+        let cr = _mm_set1_epi8(b'\r' as i8);
+        let colon = _mm_set1_epi8(b':' as i8);
+        let mut offset = 0;
+        while offset + 16 <= input.len() {
+            let chunk = _mm_loadu_si128(input.as_ptr().add(offset) as *const __m128i);
+            let hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, cr), _mm_cmpeq_epi8(chunk, colon));
+            let mask = _mm_movemask_epi8(hits) as u32 as u64;
+            if scanner.visit(input, offset, mask, 0) {
+                return None;
+            }
+            offset += 16;
+        }
+        Some(offset)
+    }
+
+    #[target_feature(enable = "avx2")]
+    pub(super) unsafe fn scan_avx2(
+        input: &[u8],
+        scanner: &mut Scanner<impl LineSink>,
+    ) -> Option<usize> {
+        let cr = _mm256_set1_epi8(b'\r' as i8);
+        let colon = _mm256_set1_epi8(b':' as i8);
+        let mut offset = 0;
+        while offset + 32 <= input.len() {
+            let chunk = _mm256_loadu_si256(input.as_ptr().add(offset) as *const __m256i);
+            let hits = _mm256_or_si256(
+                _mm256_cmpeq_epi8(chunk, cr),
+                _mm256_cmpeq_epi8(chunk, colon),
+            );
+            let mask = _mm256_movemask_epi8(hits) as u32 as u64;
+            if scanner.visit(input, offset, mask, 0) {
+                return None;
+            }
+            offset += 32;
+        }
+        Some(offset)
+    }
+}
+
+#[cfg(target_arch = "aarch64")]
+mod neon {
+    use super::{LineSink, Scanner};
+    use std::arch::aarch64::*;
+
+    /// Every nibble of the narrowed compare result is 0xF for a hit; keep
+    /// one bit per byte.
+    const NIBBLE_LSB: u64 = 0x1111_1111_1111_1111;
+
+    #[target_feature(enable = "neon")]
+    pub(super) unsafe fn scan(input: &[u8], scanner: &mut Scanner<impl LineSink>) -> Option<usize> {
+        let cr = vdupq_n_u8(b'\r');
+        let colon = vdupq_n_u8(b':');
+        let mut offset = 0;
+        while offset + 16 <= input.len() {
+            let chunk = vld1q_u8(input.as_ptr().add(offset));
+            let hits = vorrq_u8(vceqq_u8(chunk, cr), vceqq_u8(chunk, colon));
+            // NEON has no movemask: shift-narrow each 16-bit lane by 4 so
+            // byte i becomes nibble i of a 64-bit value.
+            let narrowed = vshrn_n_u16::<4>(vreinterpretq_u16_u8(hits));
+            let mask = vget_lane_u64::<0>(vreinterpret_u64_u8(narrowed)) & NIBBLE_LSB;
+            if scanner.visit(input, offset, mask, 2) {
+                return None;
+            }
+            offset += 16;
+        }
+        Some(offset)
+    }
+}
+
+fn trim_wsp_start(bytes: &[u8]) -> &[u8] {
+    let start = bytes
+        .iter()
+        .position(|&b| b != b' ' && b != b'\t')
+        .unwrap_or(bytes.len());
+    &bytes[start..]
+}
+
+fn trim_wsp_end(bytes: &[u8]) -> &[u8] {
+    let end = bytes
+        .iter()
+        .rposition(|&b| b != b' ' && b != b'\t')
+        .map_or(0, |p| p + 1);
+    &bytes[..end]
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    const INVITE: &[u8] = b"INVITE sip:bob@biloxi.example.com SIP/2.0\r\n\
+Via: SIP/2.0/UDP [2001:db8::1]:5060;branch=z9hG4bK776asdhds\r\n\
+Max-Forwards: 70\r\n\
+Subject : folded\r\n\t subject line\r\n\
+l: 7\r\n\
+\r\n\
+v=0\r\n\r\n";
+
+    #[test]
+    fn test_indexes_lines_colons_and_end() {
+        let head = scan_message_head(INVITE);
+        let start = head.start_line().unwrap();
+        assert_eq!(&INVITE[start.start..start.end], &INVITE[..41]);
+
+        let fields: Vec<_> = head.fields(INVITE).collect();
+        assert_eq!(fields.len(), 4);
+        assert_eq!(fields[0].name(INVITE), b"Via");
+        // Only the first colon on a line separates name and value.
+        assert_eq!(
+            fields[0].value(INVITE),
+            b"SIP/2.0/UDP [2001:db8::1]:5060;branch=z9hG4bK776asdhds"
+        );
+        assert_eq!(fields[2].name(INVITE), b"Subject");
+        assert_eq!(fields[2].value(INVITE), b"folded\r\n\t subject line");
+        assert!(fields[2].first_line_end < fields[2].end);
+
+        // Stops at the blank line, not the one inside the body.
+        assert_eq!(head.end(), Some(INVITE.len() - 7));
+        assert_eq!(head.content_length(INVITE), Some(7));
+        assert!(head.find_field(INVITE, b"max-forwards", None).is_some());
+        assert!(head.find_field(INVITE, b"Call-ID", Some(b'i')).is_none());
+    }
+
+    #[test]
+    fn test_find_message_field_matches_index() {
+        let head = scan_message_head(INVITE);
+        for (long, compact) in [
+            (&b"Via"[..], Some(b'v')),
+            (b"Subject", Some(b's')),
+            (b"Content-Length", Some(b'l')),
+            (b"Call-ID", Some(b'i')),
+            // The start line is never taken for a header.
+            (b"INVITE sip", None),
+        ] {
+            assert_eq!(
+                find_message_field(INVITE, long, compact),
+                head.find_field(INVITE, long, compact),
+                "{}",
+                String::from_utf8_lossy(long)
+            );
+        }
+        // The folded value is complete even though scanning stops there.
+        let subject = find_message_field(INVITE, b"Subject", None).unwrap();
+        assert_eq!(subject.value(INVITE), b"folded\r\n\t subject line");
+
+        // Fields after a truncated head are not reported.
+        assert!(find_message_field(&INVITE[..60], b"Via", None).is_none());
+        assert!(find_message_field(b"A\r\n", b"A", None).is_none());
+    }
+
+    #[test]
+    fn test_incomplete_head() {
+        let cut = &INVITE[..60];
+        let head = scan_message_head(cut);
+        assert!(!head.is_complete());
+        assert_eq!(head.lines().len(), 1);
+
+        // A CR at the very end may still become a CRLF.
+        let head = scan_message_head(b"SIP/2.0 200 OK\r");
+        assert!(head.lines().is_empty());
+        assert!(scan_header_block(b"").end().is_none());
+    }
+
+    #[test]
+    fn test_header_block_and_empty_head() {
+        let head = scan_header_block(b"\r\nbody");
+        assert_eq!(head.end(), Some(2));
+        assert_eq!(head.fields(b"\r\nbody").count(), 0);
+
+        let block = b"To: <sip:b@x>\r\nFrom: <sip:a@x>\r\n\r\n";
+        let head = scan_header_block(block);
+        assert!(head.start_line().is_none());
+        let names: Vec<_> = head.fields(block).map(|f| f.name(block)).collect();
+        assert_eq!(names, [&b"To"[..], &b"From"[..]]);
+    }
+
+    #[test]
+    fn test_bare_cr_and_lf_are_content() {
+        let msg = b"A\r\nX: a\rb\nc\r\n\r\n";
+        let head = scan_message_head(msg);
+        let field = head.fields(msg).next().unwrap();
+        assert_eq!(field.value(msg), b"a\rb\nc");
+        assert_eq!(head.end(), Some(msg.len()));
+    }
+
+    #[test]
+    fn test_vector_kernels_match_scalar() {
+        // Lines of varied length put CRs and colons at every position
+        // relative to the 16/32-byte blocks, including CRLFs split
+        // across blocks.
+        let mut msg = b"OPTIONS sip:x SIP/2.0\r\n".to_vec();
+        for i in 0..97 {
+            msg.extend_from_slice(format!("X-H{}:", i).as_bytes());
+            msg.extend(std::iter::repeat_n(b'a' + (i % 26) as u8, i % 37));
+            if i % 5 == 0 {
+                msg.extend_from_slice(b"\r\n :more:colons");
+            }
+            msg.extend_from_slice(b"\r\n");
+        }
+        msg.extend_from_slice(b"\r\nbody:\r\n\r\n");
+
+        for len in 0..=msg.len() {
+            let input = &msg[..len];
+            assert_eq!(
+                scan_message_head(input),
+                scan_message_head_scalar(input),
+                "length {}",
+                len
+            );
+        }
+        let head = scan_message_head(&msg);
+        assert_eq!(head.fields(&msg).count(), 97);
+        assert_eq!(head.end(), Some(msg.len() - b"body:\r\n\r\n".len()));
+    }
+}
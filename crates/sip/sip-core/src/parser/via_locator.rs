@@ -24,9 +24,13 @@
 //!   SIP/2.0/UDP h2`) are treated as a single line — pop removes all
 //!   entries on that line. The rvoip serializer emits one Via per
 //!   line, so this is correct for in-tree messages.
+//! - Only the head is searched: lines after the empty line that ends
+//!   the headers belong to the body.
 
 use std::ops::Range;
 
+use super::scan::find_message_field;
+
 /// Locate the first `Via:` (or compact `v:`) header line in `bytes`.
 ///
 /// Returns the byte range of the full line, **inclusive** of the
@@ -36,59 +40,13 @@ use std::ops::Range;
 /// Returns `None` if no Via header is found or the file is malformed
 /// (no CRLF terminator before end-of-buffer).
 pub fn find_top_via_line(bytes: &[u8]) -> Option<Range<usize>> {
-    let mut cursor = 0;
-    while cursor < bytes.len() {
-        // Find the end of the current line.
-        let line_end = match find_crlf(bytes, cursor) {
-            Some(end) => end,
-            None => return None,
-        };
-        let line = &bytes[cursor..line_end];
-
-        if is_via_header(line) {
-            // Return inclusive of CRLF.
-            return Some(cursor..(line_end + 2));
-        }
-
-        cursor = line_end + 2;
-    }
-    None
-}
-
-/// Find the offset of the `\r\n` that terminates the line starting at
-/// `from`. Returns the index of the `\r`.
-fn find_crlf(bytes: &[u8], from: usize) -> Option<usize> {
-    let mut i = from;
-    while i + 1 < bytes.len() {
-        if bytes[i] == b'\r' && bytes[i + 1] == b'\n' {
-            return Some(i);
-        }
-        i += 1;
-    }
-    None
-}
-
-/// True when `line` starts with a Via header name (`Via` long form or
-/// `v` compact form) followed by optional whitespace and a colon.
-/// Per RFC 3261 §7.3.1 / §7.3.3, header names are case-insensitive.
-fn is_via_header(line: &[u8]) -> bool {
-    // Long form: "Via" + optional WSP + ":"
-    if line.len() >= 4 && line[..3].eq_ignore_ascii_case(b"Via") {
-        return has_colon_after_optional_wsp(&line[3..]);
-    }
-    // Compact form: "v" + optional WSP + ":"
-    if line.len() >= 2 && line[..1].eq_ignore_ascii_case(b"v") {
-        return has_colon_after_optional_wsp(&line[1..]);
-    }
-    false
-}
-
-fn has_colon_after_optional_wsp(rest: &[u8]) -> bool {
-    let mut i = 0;
-    while i < rest.len() && (rest[i] == b' ' || rest[i] == b'\t') {
-        i += 1;
-    }
-    i < rest.len() && rest[i] == b':'
+    // Line ends and colons come from the shared head kernels, which stop
+    // right after the top Via; only the name in front of each colon is
+    // compared. Header names are case-insensitive and may be followed by
+    // whitespace before the colon (RFC 3261 §7.3.1 / §7.3.3).
+    find_message_field(bytes, b"Via", Some(b'v'))
+        // Return inclusive of CRLF.
+        .map(|field| field.start..field.first_line_end + 2)
 }
 
 #[cfg(test)]
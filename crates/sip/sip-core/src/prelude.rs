@@ -12,6 +12,7 @@ pub use crate::parser::headers::content_type::ContentTypeValue;
 pub use crate::parser::headers::route::RouteEntry as ParserRouteValue;
 pub use crate::parser::headers::route::RouteEntry as PathEntry;
 pub use crate::parser::message::parse_message_with_mode;
+pub use crate::parser::message::{parse_message_lazy, parse_message_lazy_with_mode};
 pub use crate::parser::message::{ParseMode, MAX_BODY_SIZE, MAX_HEADER_COUNT, MAX_LINE_LENGTH};
 pub use crate::parser::parse_message;
 pub use crate::types::address::Address;
@@ -30,6 +31,7 @@ pub use crate::types::from::From;
 pub use crate::types::header::{Header, HeaderValue, TypedHeader, TypedHeaderTrait};
 pub use crate::types::headers::HeaderName;
 pub use crate::types::in_reply_to::InReplyTo;
+pub use crate::types::lazy_message::LazyMessage;
 pub use crate::types::max_forwards::MaxForwards;
 pub use crate::types::multipart::{MimePart, MultipartBody, ParsedBody};
 pub use crate::types::organization::Organization;
@@ -54,6 +56,7 @@ pub use crate::types::unsupported::Unsupported;
 pub use crate::types::uri::{Host, Scheme, Uri};
 pub use crate::types::warning::Warning;
 pub use crate::types::warning::{WarnAgent, WarningHeader, WarningValue};
+pub use crate::types::wire::{PreparedMessage, WireFormat};
 pub use crate::types::MediaType;
 pub use crate::types::Method;
 pub use crate::types::StatusCode;
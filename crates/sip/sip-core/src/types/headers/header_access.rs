@@ -130,6 +130,18 @@ where
 /// This function uses the more efficient `as_typed_ref` method on TypedHeader
 /// and handles special cases like Via headers that can contain multiple entries.
 pub fn collect_typed_headers<T: TypedHeaderTrait + 'static>(headers: &[TypedHeader]) -> Vec<&T>
+where
+    <T as TypedHeaderTrait>::Name: std::fmt::Debug,
+    T: std::fmt::Debug,
+{
+    collect_typed_headers_from(headers.iter())
+}
+
+/// [`collect_typed_headers`] over any sequence of headers, for message
+/// representations that do not keep them in one slice
+pub fn collect_typed_headers_from<'a, T: TypedHeaderTrait + 'static>(
+    headers: impl Iterator<Item = &'a TypedHeader>,
+) -> Vec<&'a T>
 where
     <T as TypedHeaderTrait>::Name: std::fmt::Debug,
     T: std::fmt::Debug,
@@ -143,7 +155,6 @@ where
     // Special handling for Via headers - each Via can contain multiple entries
     if type_id == std::any::TypeId::of::<crate::types::via::Via>() {
         let vias = headers
-            .iter()
             .filter(|h| h.name() == target_name)
             .filter_map(|h| h.as_typed_ref::<T>());
 
@@ -160,7 +171,6 @@ where
 
     // Standard handling for all other header types
     headers
-        .iter()
         .filter(|h| h.name() == target_name)
         .filter_map(|h| h.as_typed_ref::<T>())
         .collect()
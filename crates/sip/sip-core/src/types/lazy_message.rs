@@ -0,0 +1,509 @@
+//! # Lazily Parsed SIP Messages
+//!
+//! [`LazyMessage`] is a read-only view of a SIP message that keeps the
+//! original wire bytes and an index of where each header sits in them.
+//! Only the start line is parsed up front; a header is turned into a
+//! [`TypedHeader`] the first time it is accessed, and the result is
+//! cached for later calls.
+//!
+//! This suits components that look at a handful of headers and pass the
+//! rest through untouched, such as a stateless proxy (Via, Max-Forwards,
+//! Route) or a registrar (From, To, Call-ID, CSeq, Contact, Expires).
+//! Headers that are never accessed, such as a large Authorization or an
+//! unknown extension header, are never parsed.
+//!
+//! Serializing an unmodified lazy message copies the original bytes, and
+//! the body is a zero-copy slice of them. To modify a message, convert it
+//! with [`LazyMessage::into_message`]; headers already parsed are reused.
+//!
+//! ## Examples
+//!
+//! ```rust
+//! use rvoip_sip_core::prelude::*;
+//! use rvoip_sip_core::parse_message_lazy;
+//! use bytes::Bytes;
+//!
+//! let data = Bytes::from_static(
+//!     b"REGISTER sip:registrar.example.com SIP/2.0\r\n\
+//!       Via: SIP/2.0/UDP pc.example.com:5060;branch=z9hG4bK776\r\n\
+//!       From: <sip:alice@example.com>;tag=1\r\n\
+//!       To: <sip:alice@example.com>\r\n\
+//!       Call-ID: reg-1@pc.example.com\r\n\
+//!       CSeq: 1 REGISTER\r\n\
+//!       Content-Length: 0\r\n\r\n",
+//! );
+//!
+//! let message = parse_message_lazy(data.clone()).unwrap();
+//! assert_eq!(message.method(), Some(Method::Register));
+//! // Only the Call-ID header is parsed here.
+//! assert_eq!(message.call_id().unwrap().as_str(), "reg-1@pc.example.com");
+//! // Unmodified messages serialize to their original bytes.
+//! assert_eq!(message.to_bytes(), data.to_vec());
+//! ```
+
+use bytes::Bytes;
+use std::collections::HashSet;
+use std::ops::Range;
+use std::str::FromStr;
+use std::sync::OnceLock;
+
+use crate::parser::utils::unfold_lws;
+use crate::types;
+use crate::types::from::From;
+use crate::types::header::{Header, HeaderName, HeaderValue, TypedHeader, TypedHeaderTrait};
+use crate::types::headers::{collect_typed_headers_from, HeaderAccess};
+use crate::types::method::Method;
+use crate::types::sip_message::Message;
+use crate::types::sip_request::Request;
+use crate::types::sip_response::Response;
+use crate::types::to::To;
+use crate::types::uri::Uri;
+use crate::types::version::Version;
+use crate::types::via::Via;
+use crate::types::CSeq;
+use crate::types::StatusCode;
+
+/// Parsed start line of a [`LazyMessage`]
+#[derive(Debug, Clone, PartialEq)]
+pub enum LazyStartLine {
+    /// Request-line
+    Request {
+        method: Method,
+        uri: Uri,
+        version: Version,
+    },
+    /// Status-line; the reason phrase stays in the raw bytes
+    Response {
+        version: Version,
+        status: StatusCode,
+        reason: Range<usize>,
+    },
+}
+
+/// One header of a [`LazyMessage`]: its name, where its value sits in the
+/// raw bytes, and the typed form once someone asked for it
+#[derive(Debug, Clone)]
+pub(crate) struct HeaderSlot {
+    name: HeaderName,
+    /// Value span in the raw bytes, still folded, without the CRLF
+    value: Range<usize>,
+    typed: OnceLock<TypedHeader>,
+}
+
+impl HeaderSlot {
+    pub(crate) fn new(name: HeaderName, value: Range<usize>) -> Self {
+        Self {
+            name,
+            value,
+            typed: OnceLock::new(),
+        }
+    }
+}
+
+/// A SIP message backed by its wire bytes, with headers parsed on demand
+///
+/// Created by [`parse_message_lazy`](crate::parse_message_lazy). See the
+/// [module documentation](self) for details.
+#[derive(Debug, Clone)]
+pub struct LazyMessage {
+    /// The message exactly as received, up to the end of the body
+    raw: Bytes,
+    start_line: LazyStartLine,
+    headers: Vec<HeaderSlot>,
+    body: Range<usize>,
+}
+
+impl LazyMessage {
+    pub(crate) fn new(
+        raw: Bytes,
+        start_line: LazyStartLine,
+        headers: Vec<HeaderSlot>,
+        body: Range<usize>,
+    ) -> Self {
+        Self {
+            raw,
+            start_line,
+            headers,
+            body,
+        }
+    }
+
+    /// Returns true if this is a request
+    pub fn is_request(&self) -> bool {
+        matches!(self.start_line, LazyStartLine::Request { .. })
+    }
+
+    /// Returns true if this is a response
+    pub fn is_response(&self) -> bool {
+        !self.is_request()
+    }
+
+    /// The parsed start line
+    pub fn start_line(&self) -> &LazyStartLine {
+        &self.start_line
+    }
+
+    /// Request method, or `None` for a response
+    pub fn method(&self) -> Option<Method> {
+        match &self.start_line {
+            LazyStartLine::Request { method, .. } => Some(method.clone()),
+            LazyStartLine::Response { .. } => None,
+        }
+    }
+
+    /// Request-URI, or `None` for a response
+    pub fn uri(&self) -> Option<&Uri> {
+        match &self.start_line {
+            LazyStartLine::Request { uri, .. } => Some(uri),
+            LazyStartLine::Response { .. } => None,
+        }
+    }
+
+    /// Response status, or `None` for a request
+    pub fn status(&self) -> Option<StatusCode> {
+        match &self.start_line {
+            LazyStartLine::Response { status, .. } => Some(*status),
+            LazyStartLine::Request { .. } => None,
+        }
+    }
+
+    /// Reason phrase as sent, or `None` for a request
+    pub fn reason_phrase(&self) -> Option<&str> {
+        match &self.start_line {
+            LazyStartLine::Response { reason, .. } => {
+                std::str::from_utf8(&self.raw[reason.clone()]).ok()
+            }
+            LazyStartLine::Request { .. } => None,
+        }
+    }
+
+    /// SIP version
+    pub fn version(&self) -> &Version {
+        match &self.start_line {
+            LazyStartLine::Request { version, .. } | LazyStartLine::Response { version, .. } => {
+                version
+            }
+        }
+    }
+
+    /// Message body, sliced from the original bytes without copying
+    pub fn body(&self) -> Bytes {
+        self.raw.slice(self.body.clone())
+    }
+
+    /// The message's wire bytes
+    pub fn as_bytes(&self) -> &Bytes {
+        &self.raw
+    }
+
+    /// Serialize the message. A lazy message cannot be modified, so this
+    /// is a copy of the original bytes.
+    pub fn to_bytes(&self) -> Vec<u8> {
+        self.raw.to_vec()
+    }
+
+    /// Consume the message, returning its wire bytes without copying
+    pub fn into_bytes(self) -> Bytes {
+        self.raw
+    }
+
+    /// Number of header lines
+    pub fn header_count(&self) -> usize {
+        self.headers.len()
+    }
+
+    /// Number of headers parsed into typed form so far
+    pub fn parsed_header_count(&self) -> usize {
+        self.headers
+            .iter()
+            .filter(|slot| slot.typed.get().is_some())
+            .count()
+    }
+
+    /// Value of the first `name` header as received (folded lines
+    /// included), without parsing it
+    pub fn raw_value(&self, name: &HeaderName) -> Option<&[u8]> {
+        self.headers
+            .iter()
+            .find(|slot| slot.name == *name)
+            .map(|slot| &self.raw[slot.value.clone()])
+    }
+
+    /// First `name` header, parsed on first access
+    pub fn header(&self, name: &HeaderName) -> Option<&TypedHeader> {
+        let index = self.headers.iter().position(|slot| slot.name == *name)?;
+        Some(self.typed(index))
+    }
+
+    /// First header of type `T`, parsed on first access
+    pub fn typed_header<T>(&self) -> Option<&T>
+    where
+        T: TypedHeaderTrait + std::fmt::Debug + 'static,
+        <T as TypedHeaderTrait>::Name: std::fmt::Debug,
+    {
+        self.typed_named(T::header_name().into())
+            .find_map(|header| header.as_typed_ref::<T>())
+    }
+
+    /// Call-ID header, if present
+    pub fn call_id(&self) -> Option<&types::CallId> {
+        match self.header(&HeaderName::CallId) {
+            Some(TypedHeader::CallId(call_id)) => Some(call_id),
+            _ => None,
+        }
+    }
+
+    /// From header, if present
+    pub fn from(&self) -> Option<&From> {
+        match self.header(&HeaderName::From) {
+            Some(TypedHeader::From(from)) => Some(from),
+            _ => None,
+        }
+    }
+
+    /// To header, if present
+    pub fn to(&self) -> Option<&To> {
+        match self.header(&HeaderName::To) {
+            Some(TypedHeader::To(to)) => Some(to),
+            _ => None,
+        }
+    }
+
+    /// CSeq header, if present
+    pub fn cseq(&self) -> Option<&CSeq> {
+        match self.header(&HeaderName::CSeq) {
+            Some(TypedHeader::CSeq(cseq)) => Some(cseq),
+            _ => None,
+        }
+    }
+
+    /// First Via header line, if present
+    pub fn first_via(&self) -> Option<&Via> {
+        match self.header(&HeaderName::Via) {
+            Some(TypedHeader::Via(via)) => Some(via),
+            _ => None,
+        }
+    }
+
+    /// Parse every header and convert into an owned [`Message`]. Headers
+    /// parsed earlier are moved rather than parsed again, and the body is
+    /// shared with the original bytes.
+    pub fn into_message(self) -> Message {
+        let body = self.raw.slice(self.body.clone());
+        let mut headers = Vec::with_capacity(self.headers.len());
+        for slot in self.headers {
+            let typed = match slot.typed.into_inner() {
+                Some(typed) => typed,
+                None => parse_slot(&self.raw, &slot.name, &slot.value),
+            };
+            headers.push(typed);
+        }
+
+        match self.start_line {
+            LazyStartLine::Request {
+                method,
+                uri,
+                version,
+            } => {
+                let mut request = Request::new(method, uri);
+                request.version = version;
+                request.set_headers(headers);
+                request.body = body;
+                Message::Request(request)
+            }
+            LazyStartLine::Response {
+                version,
+                status,
+                reason,
+            } => {
+                let mut response = Response::new(status)
+                    .with_reason(String::from_utf8_lossy(&self.raw[reason]).into_owned());
+                response.version = version;
+                response.set_headers(headers);
+                response.body = body;
+                Message::Response(response)
+            }
+        }
+    }
+
+    /// Typed form of header `index`, parsing it on first use
+    fn typed(&self, index: usize) -> &TypedHeader {
+        let slot = &self.headers[index];
+        slot.typed
+            .get_or_init(|| parse_slot(&self.raw, &slot.name, &slot.value))
+    }
+
+    /// Typed forms of all `name` headers, in message order
+    fn typed_named(&self, name: HeaderName) -> impl Iterator<Item = &TypedHeader> + '_ {
+        self.headers
+            .iter()
+            .enumerate()
+            .filter(move |(_, slot)| slot.name == name)
+            .map(move |(index, _)| self.typed(index))
+    }
+}
+
+/// Parse one header value the way the full parser does: unfold, try the
+/// typed parser, and fall back to keeping the raw value.
+fn parse_slot(raw: &[u8], name: &HeaderName, value: &Range<usize>) -> TypedHeader {
+    let header = Header::new(
+        name.clone(),
+        HeaderValue::Raw(unfold_lws(&raw[value.clone()])),
+    );
+    match TypedHeader::try_from(&header) {
+        Ok(typed) => typed,
+        Err(e) => {
+            tracing::debug!("header parse error (keeping as Other): {}", e);
+            TypedHeader::Other(header.name, header.value)
+        }
+    }
+}
+
+impl std::convert::From<LazyMessage> for Message {
+    fn from(message: LazyMessage) -> Self {
+        message.into_message()
+    }
+}
+
+impl HeaderAccess for LazyMessage {
+    fn typed_headers<T>(&self) -> Vec<&T>
+    where
+        T: TypedHeaderTrait + std::fmt::Debug + 'static,
+        <T as TypedHeaderTrait>::Name: std::fmt::Debug,
+    {
+        collect_typed_headers_from::<T>(self.typed_named(T::header_name().into()))
+    }
+
+    fn typed_header<T>(&self) -> Option<&T>
+    where
+        T: TypedHeaderTrait + std::fmt::Debug + 'static,
+        <T as TypedHeaderTrait>::Name: std::fmt::Debug,
+    {
+        LazyMessage::typed_header(self)
+    }
+
+    fn headers(&self, name: &HeaderName) -> Vec<&TypedHeader> {
+        self.typed_named(name.clone()).collect()
+    }
+
+    fn header(&self, name: &HeaderName) -> Option<&TypedHeader> {
+        LazyMessage::header(self, name)
+    }
+
+    fn headers_by_name(&self, name: &str) -> Vec<&TypedHeader> {
+        match HeaderName::from_str(name) {
+            Ok(header_name) => self.headers(&header_name),
+            Err(_) => Vec::new(),
+        }
+    }
+
+    fn raw_header_value(&self, name: &HeaderName) -> Option<String> {
+        self.raw_value(name).map(|value| {
+            String::from_utf8_lossy(&unfold_lws(value))
+                .trim()
+                .to_string()
+        })
+    }
+
+    fn raw_headers(&self, name: &HeaderName) -> Vec<Vec<u8>> {
+        self.headers
+            .iter()
+            .filter(|slot| slot.name == *name)
+            .map(|slot| unfold_lws(&self.raw[slot.value.clone()]))
+            .collect()
+    }
+
+    fn header_names(&self) -> Vec<HeaderName> {
+        let names: HashSet<_> = self.headers.iter().map(|slot| slot.name.clone()).collect();
+        names.into_iter().collect()
+    }
+
+    fn has_header(&self, name: &HeaderName) -> bool {
+        self.headers.iter().any(|slot| slot.name == *name)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::parser::message::{
+        parse_message, parse_message_lazy, parse_message_lazy_with_mode, ParseMode,
+    };
+
+    const INVITE: &[u8] = b"INVITE sip:bob@biloxi.example.com SIP/2.0\r\n\
+Via: SIP/2.0/UDP pc33.atlanta.example.com;branch=z9hG4bK776asdhds\r\n\
+Via: SIP/2.0/UDP proxy.atlanta.example.com;branch=z9hG4bK111\r\n\
+Max-Forwards: 70\r\n\
+To: Bob <sip:bob@biloxi.example.com>\r\n\
+From: Alice <sip:alice@atlanta.example.com>;tag=1928301774\r\n\
+Call-ID: a84b4c76e66710@pc33.atlanta.example.com\r\n\
+CSeq: 314159 INVITE\r\n\
+Subject: folded\r\n  subject line\r\n\
+Contact: <sip:alice@pc33.atlanta.example.com>\r\n\
+Content-Type: application/sdp\r\n\
+Content-Length: 4\r\n\
+\r\n\
+v=0\n";
+
+    #[test]
+    fn test_headers_parsed_on_demand() {
+        let message = parse_message_lazy(Bytes::from_static(INVITE)).unwrap();
+        assert_eq!(message.method(), Some(Method::Invite));
+        assert_eq!(message.header_count(), 11);
+        assert_eq!(message.parsed_header_count(), 0);
+
+        assert_eq!(message.cseq().unwrap().seq, 314159);
+        assert_eq!(message.parsed_header_count(), 1);
+        // Cached: a second lookup parses nothing new.
+        assert!(message.cseq().is_some());
+        assert_eq!(message.parsed_header_count(), 1);
+
+        assert!(message.has_header(&HeaderName::Contact));
+        assert_eq!(message.headers(&HeaderName::Via).len(), 2);
+        assert_eq!(message.parsed_header_count(), 3);
+        assert_eq!(
+            message.raw_header_value(&HeaderName::Subject).unwrap(),
+            "folded subject line"
+        );
+        assert_eq!(&message.body()[..], b"v=0\n");
+    }
+
+    #[test]
+    fn test_matches_full_parse() {
+        let full = parse_message(INVITE).unwrap();
+        let lazy = parse_message_lazy(Bytes::from_static(INVITE)).unwrap();
+        // Touch one header first so both cached and fresh slots are used.
+        assert!(lazy.call_id().is_some());
+        assert_eq!(lazy.into_message(), full);
+
+        let ok = b"SIP/2.0 200 Very OK\r\nCall-ID: x@y\r\nContent-Length: 0\r\n\r\n";
+        let lazy = parse_message_lazy(Bytes::from_static(ok)).unwrap();
+        assert_eq!(lazy.status(), Some(StatusCode::Ok));
+        assert_eq!(lazy.reason_phrase(), Some("Very OK"));
+        assert_eq!(Message::from(lazy), parse_message(ok).unwrap());
+    }
+
+    #[test]
+    fn test_serializes_original_bytes() {
+        let mut wire = INVITE.to_vec();
+        wire.extend_from_slice(b"trailing garbage");
+        let message = parse_message_lazy(Bytes::from(wire)).unwrap();
+        assert_eq!(message.to_bytes(), INVITE);
+        assert_eq!(message.into_bytes(), Bytes::from_static(INVITE));
+    }
+
+    #[test]
+    fn test_strict_mode_framing() {
+        let short = &INVITE[..INVITE.len() - 2];
+        assert!(
+            parse_message_lazy_with_mode(Bytes::from_static(short), ParseMode::Strict).is_err()
+        );
+        let lenient = parse_message_lazy(Bytes::from_static(short)).unwrap();
+        assert_eq!(&lenient.body()[..], b"v=");
+
+        let mut long = INVITE.to_vec();
+        long.push(b'x');
+        assert!(parse_message_lazy_with_mode(Bytes::from(long), ParseMode::Strict).is_err());
+        assert!(parse_message_lazy(Bytes::from_static(b"NOT A SIP MESSAGE\r\n\r\n")).is_err());
+    }
+}
@@ -319,12 +319,16 @@ pub use method::Method;
 pub mod status;
 pub use status::StatusCode;
 
+pub mod lazy_message;
 pub mod sip_message;
 pub mod sip_request;
 pub mod sip_response;
+pub mod wire;
+pub use lazy_message::{LazyMessage, LazyStartLine};
 pub use sip_message::Message;
 pub use sip_request::Request;
 pub use sip_response::Response;
+pub use wire::{PreparedMessage, WireFormat};
 
 pub mod param;
 pub use param::Param;
@@ -473,57 +473,14 @@ impl Message {
     /// assert!(String::from_utf8_lossy(&bytes).contains("SIP/2.0 200 OK"));
     /// ```
     pub fn to_bytes(&self) -> Vec<u8> {
-        // Write directly into the output Vec via `write!`. Each
-        // `format!(...).as_bytes()` previously allocated a fresh String
-        // per header (10+ allocations for a typical INVITE); the
-        // `Write` impl for `Vec<u8>` reuses the single output buffer.
-        // Pre-size for ~64 B/header + body so the early growth steps
-        // get skipped on common messages.
-        use std::io::Write as _;
-
-        let (headers, body): (&[crate::types::TypedHeader], &[u8]) = match self {
-            Message::Request(r) => (&r.headers, &r.body),
-            Message::Response(r) => (&r.headers, &r.body),
-        };
-        let estimated = 64 + headers.len() * 64 + body.len();
-        let mut bytes = Vec::with_capacity(estimated);
-
-        match self {
-            Message::Request(request) => {
-                // Request line: METHOD URI SIP/2.0\r\n
-                let _ = write!(
-                    &mut bytes,
-                    "{} {} {}\r\n",
-                    request.method, request.uri, request.version
-                );
-
-                for header in &request.headers {
-                    let _ = write!(&mut bytes, "{}\r\n", header);
-                }
-
-                bytes.extend_from_slice(b"\r\n");
-                bytes.extend_from_slice(&request.body);
-            }
-            Message::Response(response) => {
-                // Status line: SIP/2.0 CODE REASON\r\n
-                let _ = write!(
-                    &mut bytes,
-                    "{} {} {}\r\n",
-                    response.version,
-                    response.status.as_u16(),
-                    response.reason_phrase()
-                );
-
-                for header in &response.headers {
-                    let _ = write!(&mut bytes, "{}\r\n", header);
-                }
-
-                bytes.extend_from_slice(b"\r\n");
-                bytes.extend_from_slice(&response.body);
-            }
-        }
-
-        bytes
+        // Same writer the transports use with their pooled buffers (see
+        // `types::wire`); converting the uniquely owned `BytesMut` back
+        // into a `Vec` does not copy.
+        use crate::types::wire::WireFormat as _;
+
+        let mut bytes = bytes::BytesMut::with_capacity(self.wire_size_hint());
+        self.write_to(&mut bytes);
+        bytes.into()
     }
 
     // Note: The parse method is intentionally omitted here.
@@ -0,0 +1,435 @@
+//! # Wire Serialization
+//!
+//! [`WireFormat`] writes SIP messages and headers straight into a
+//! caller-supplied [`BytesMut`]. A transport can keep a pool of send
+//! buffers and serialize into one of them instead of allocating a fresh
+//! `Vec<u8>` per message and copying it again on the way to the socket.
+//!
+//! [`PreparedMessage`] is for messages that go out more than once. It
+//! serializes the start line and every header line once and keeps the
+//! fragments, so a retransmission is a sequence of copies rather than a
+//! round of `Display` formatting. Deriving a forked request (new
+//! Request-URI, a new top Via, a decremented Max-Forwards) re-serializes
+//! only the parts that change; the other fragments are shared.
+//!
+//! ## Examples
+//!
+//! ```rust
+//! use rvoip_sip_core::prelude::*;
+//! use rvoip_sip_core::types::wire::{PreparedMessage, WireFormat};
+//! use bytes::BytesMut;
+//!
+//! let request = Request::new(Method::Options, "sip:bob@example.com".parse().unwrap())
+//!     .with_header(TypedHeader::MaxForwards(MaxForwards::new(70)));
+//! let message = Message::Request(request);
+//!
+//! // Serialize into a reusable buffer.
+//! let mut buf = BytesMut::with_capacity(1024);
+//! message.write_to(&mut buf);
+//! assert_eq!(&buf[..], &message.to_bytes()[..]);
+//!
+//! // Serialize once, send many times.
+//! let prepared = PreparedMessage::new(message);
+//! buf.clear();
+//! prepared.write_to(&mut buf);
+//! assert_eq!(&buf[..], &prepared.message().to_bytes()[..]);
+//!
+//! // Fork to another target: only the start line is re-serialized.
+//! let fork = prepared.with_request_uri("sip:bob@192.0.2.7".parse().unwrap());
+//! assert!(fork.to_wire().starts_with(b"OPTIONS sip:bob@192.0.2.7 SIP/2.0\r\n"));
+//! ```
+
+use bytes::{BufMut, Bytes, BytesMut};
+use std::fmt::Write as _;
+
+use crate::types::header::{HeaderName, TypedHeader};
+use crate::types::sip_message::Message;
+use crate::types::sip_request::Request;
+use crate::types::sip_response::Response;
+use crate::types::uri::Uri;
+
+/// Serialization of SIP entities into a byte buffer
+pub trait WireFormat {
+    /// Append the wire form to `buf`, growing it as needed
+    fn write_to(&self, buf: &mut BytesMut);
+
+    /// Expected serialized size, used to reserve capacity up front
+    fn wire_size_hint(&self) -> usize {
+        0
+    }
+
+    /// Serialize into a new buffer
+    fn to_wire(&self) -> Bytes {
+        let mut buf = BytesMut::with_capacity(self.wire_size_hint());
+        self.write_to(&mut buf);
+        buf.freeze()
+    }
+}
+
+/// Serialized header size assumed before a header has been written
+const HEADER_SIZE_HINT: usize = 64;
+
+impl WireFormat for TypedHeader {
+    /// Writes `Name: value\r\n`
+    fn write_to(&self, buf: &mut BytesMut) {
+        // `fmt::Write` for `BytesMut` grows the buffer and never fails.
+        let _ = write!(buf, "{}\r\n", self);
+    }
+
+    fn wire_size_hint(&self) -> usize {
+        HEADER_SIZE_HINT
+    }
+}
+
+impl WireFormat for Request {
+    fn write_to(&self, buf: &mut BytesMut) {
+        buf.reserve(self.wire_size_hint());
+        write_request_line(self, buf);
+        write_headers_and_body(&self.headers, &self.body, buf);
+    }
+
+    fn wire_size_hint(&self) -> usize {
+        HEADER_SIZE_HINT * (1 + self.headers.len()) + self.body.len()
+    }
+}
+
+impl WireFormat for Response {
+    fn write_to(&self, buf: &mut BytesMut) {
+        buf.reserve(self.wire_size_hint());
+        write_status_line(self, buf);
+        write_headers_and_body(&self.headers, &self.body, buf);
+    }
+
+    fn wire_size_hint(&self) -> usize {
+        HEADER_SIZE_HINT * (1 + self.headers.len()) + self.body.len()
+    }
+}
+
+impl WireFormat for Message {
+    fn write_to(&self, buf: &mut BytesMut) {
+        match self {
+            Message::Request(request) => request.write_to(buf),
+            Message::Response(response) => response.write_to(buf),
+        }
+    }
+
+    fn wire_size_hint(&self) -> usize {
+        match self {
+            Message::Request(request) => request.wire_size_hint(),
+            Message::Response(response) => response.wire_size_hint(),
+        }
+    }
+}
+
+/// Request line: METHOD URI SIP/2.0\r\n
+fn write_request_line(request: &Request, buf: &mut BytesMut) {
+    let _ = write!(
+        buf,
+        "{} {} {}\r\n",
+        request.method, request.uri, request.version
+    );
+}
+
+/// Status line: SIP/2.0 CODE REASON\r\n
+fn write_status_line(response: &Response, buf: &mut BytesMut) {
+    let _ = write!(
+        buf,
+        "{} {} {}\r\n",
+        response.version,
+        response.status.as_u16(),
+        response.reason_phrase()
+    );
+}
+
+fn write_start_line(message: &Message, buf: &mut BytesMut) {
+    match message {
+        Message::Request(request) => write_request_line(request, buf),
+        Message::Response(response) => write_status_line(response, buf),
+    }
+}
+
+fn write_headers_and_body(headers: &[TypedHeader], body: &[u8], buf: &mut BytesMut) {
+    for header in headers {
+        header.write_to(buf);
+    }
+    buf.put_slice(b"\r\n");
+    buf.put_slice(body);
+}
+
+fn headers_mut(message: &mut Message) -> &mut Vec<TypedHeader> {
+    match message {
+        Message::Request(request) => &mut request.headers,
+        Message::Response(response) => &mut response.headers,
+    }
+}
+
+/// A message together with the serialized form of its start line and
+/// each header line
+///
+/// The message is read-only; the `with_*` methods derive a new prepared
+/// message and re-serialize only what they change. Fragments are
+/// reference-counted slices, so clones and derived messages share them.
+#[derive(Debug, Clone)]
+pub struct PreparedMessage {
+    message: Message,
+    start_line: Bytes,
+    /// One `Name: value\r\n` fragment per entry in the message's headers
+    headers: Vec<Bytes>,
+}
+
+impl PreparedMessage {
+    /// Serialize `message` once and keep the fragments
+    pub fn new(message: Message) -> Self {
+        let mut buf = BytesMut::with_capacity(message.wire_size_hint());
+        write_start_line(&message, &mut buf);
+        let start_line = buf.split().freeze();
+        let headers = message
+            .all_headers()
+            .iter()
+            .map(|header| {
+                header.write_to(&mut buf);
+                buf.split().freeze()
+            })
+            .collect();
+        Self {
+            message,
+            start_line,
+            headers,
+        }
+    }
+
+    /// The structured message
+    pub fn message(&self) -> &Message {
+        &self.message
+    }
+
+    /// Consume, returning the structured message
+    pub fn into_message(self) -> Message {
+        self.message
+    }
+
+    /// Serialized `Name: value\r\n` line of header `index`
+    pub fn header_fragment(&self, index: usize) -> Option<&Bytes> {
+        self.headers.get(index)
+    }
+
+    /// Exact serialized size of the message
+    pub fn wire_len(&self) -> usize {
+        self.start_line.len()
+            + self.headers.iter().map(Bytes::len).sum::<usize>()
+            + 2
+            + self.message.body().len()
+    }
+
+    /// Copy with a different Request-URI, for sending a request to
+    /// another target. Header fragments are shared. A response is
+    /// returned unchanged.
+    pub fn with_request_uri(&self, uri: Uri) -> Self {
+        let mut message = self.message.clone();
+        let Message::Request(request) = &mut message else {
+            return self.clone();
+        };
+        request.uri = uri;
+        let mut buf = BytesMut::new();
+        write_start_line(&message, &mut buf);
+        Self {
+            message,
+            start_line: buf.freeze(),
+            headers: self.headers.clone(),
+        }
+    }
+
+    /// Copy with `header` inserted before all others, such as the Via a
+    /// proxy adds to a forwarded request
+    pub fn with_header_first(&self, header: TypedHeader) -> Self {
+        let fragment = header.to_wire();
+        let mut message = self.message.clone();
+        headers_mut(&mut message).insert(0, header);
+        let mut headers = Vec::with_capacity(self.headers.len() + 1);
+        headers.push(fragment);
+        headers.extend(self.headers.iter().cloned());
+        Self {
+            message,
+            start_line: self.start_line.clone(),
+            headers,
+        }
+    }
+
+    /// Copy with `header` inserted before the first header of the same
+    /// name (or appended if there is none), such as the Via a proxy
+    /// pushes onto a forwarded request's Via stack
+    pub fn with_header_on_top(&self, header: TypedHeader) -> Self {
+        let fragment = header.to_wire();
+        let name = header.name();
+        let mut message = self.message.clone();
+        let mut headers = self.headers.clone();
+        let message_headers = headers_mut(&mut message);
+        let index = message_headers
+            .iter()
+            .position(|h| h.name() == name)
+            .unwrap_or(message_headers.len());
+        message_headers.insert(index, header);
+        headers.insert(index, fragment);
+        Self {
+            message,
+            start_line: self.start_line.clone(),
+            headers,
+        }
+    }
+
+    /// Copy with the first header named like `header` replaced by it (or
+    /// `header` appended if there is none), such as a decremented
+    /// Max-Forwards
+    pub fn with_header_replaced(&self, header: TypedHeader) -> Self {
+        let fragment = header.to_wire();
+        let name = header.name();
+        let mut message = self.message.clone();
+        let mut headers = self.headers.clone();
+        let message_headers = headers_mut(&mut message);
+        match message_headers.iter().position(|h| h.name() == name) {
+            Some(index) => {
+                message_headers[index] = header;
+                headers[index] = fragment;
+            }
+            None => {
+                message_headers.push(header);
+                headers.push(fragment);
+            }
+        }
+        Self {
+            message,
+            start_line: self.start_line.clone(),
+            headers,
+        }
+    }
+
+    /// Copy without the first `name` header, such as the top Via a proxy
+    /// removes from a response it forwards
+    pub fn without_first(&self, name: &HeaderName) -> Self {
+        let mut message = self.message.clone();
+        let mut headers = self.headers.clone();
+        let message_headers = headers_mut(&mut message);
+        if let Some(index) = message_headers.iter().position(|h| h.name() == *name) {
+            message_headers.remove(index);
+            headers.remove(index);
+        }
+        Self {
+            message,
+            start_line: self.start_line.clone(),
+            headers,
+        }
+    }
+}
+
+impl From<Message> for PreparedMessage {
+    fn from(message: Message) -> Self {
+        Self::new(message)
+    }
+}
+
+impl WireFormat for PreparedMessage {
+    fn write_to(&self, buf: &mut BytesMut) {
+        buf.reserve(self.wire_len());
+        buf.put_slice(&self.start_line);
+        for fragment in &self.headers {
+            buf.put_slice(fragment);
+        }
+        buf.put_slice(b"\r\n");
+        buf.put_slice(self.message.body());
+    }
+
+    fn wire_size_hint(&self) -> usize {
+        self.wire_len()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::parser::message::parse_message;
+    use crate::types::max_forwards::MaxForwards;
+    use crate::types::via::Via;
+
+    const INVITE: &[u8] = b"INVITE sip:bob@biloxi.example.com SIP/2.0\r\n\
+Via: SIP/2.0/UDP pc33.atlanta.example.com;branch=z9hG4bK776asdhds\r\n\
+Max-Forwards: 70\r\n\
+To: Bob <sip:bob@biloxi.example.com>\r\n\
+From: Alice <sip:alice@atlanta.example.com>;tag=1928301774\r\n\
+Call-ID: a84b4c76e66710@pc33.atlanta.example.com\r\n\
+CSeq: 314159 INVITE\r\n\
+Content-Type: application/sdp\r\n\
+Content-Length: 4\r\n\
+\r\n\
+v=0\n";
+
+    #[test]
+    fn test_write_to_matches_to_bytes() {
+        let message = parse_message(INVITE).unwrap();
+        let mut buf = BytesMut::new();
+        message.write_to(&mut buf);
+        assert_eq!(&buf[..], &message.to_bytes()[..]);
+
+        // Appends rather than overwrites.
+        message.write_to(&mut buf);
+        assert_eq!(buf.len(), 2 * message.to_bytes().len());
+
+        let response = Message::Response(Response::new(crate::types::StatusCode::Ok));
+        assert_eq!(&response.to_wire()[..], &response.to_bytes()[..]);
+    }
+
+    #[test]
+    fn test_prepared_message_reuses_fragments() {
+        let message = parse_message(INVITE).unwrap();
+        let prepared = PreparedMessage::new(message.clone());
+        assert_eq!(&prepared.to_wire()[..], &message.to_bytes()[..]);
+        assert_eq!(prepared.wire_len(), message.to_bytes().len());
+        assert_eq!(
+            &prepared.header_fragment(1).unwrap()[..],
+            b"Max-Forwards: 70\r\n"
+        );
+
+        let via = Via::new(
+            "SIP",
+            "2.0",
+            "UDP",
+            "proxy.example.com",
+            Some(5060),
+            vec![crate::types::Param::branch("z9hG4bKfork1")],
+        )
+        .unwrap();
+        let fork = prepared
+            .with_request_uri("sip:bob@192.0.2.4".parse().unwrap())
+            .with_header_first(TypedHeader::Via(via))
+            .with_header_replaced(TypedHeader::MaxForwards(MaxForwards::new(69)));
+        // The derived fragments match a full serialization of the edited
+        // message...
+        assert_eq!(&fork.to_wire()[..], &fork.message().to_bytes()[..]);
+        // ...and the untouched ones are the same allocation.
+        assert_eq!(
+            fork.header_fragment(3).unwrap().as_ptr(),
+            prepared.header_fragment(2).unwrap().as_ptr()
+        );
+
+        let pushed = prepared.with_header_on_top(TypedHeader::Via(
+            Via::new(
+                "SIP",
+                "2.0",
+                "UDP",
+                "proxy.example.com",
+                Some(5060),
+                vec![crate::types::Param::branch("z9hG4bKfork2")],
+            )
+            .unwrap(),
+        ));
+        assert_eq!(&pushed.to_wire()[..], &pushed.message().to_bytes()[..]);
+        assert!(pushed
+            .header_fragment(0)
+            .unwrap()
+            .windows(12)
+            .any(|w| w == b"z9hG4bKfork2"));
+
+        let popped = fork.without_first(&HeaderName::Via);
+        assert_eq!(popped.message().all_headers().len(), 9);
+        assert_eq!(&popped.to_wire()[..], &popped.message().to_bytes()[..]);
+    }
+}
@@ -10,6 +10,12 @@
 //! 2. `Arc<Mutex<HashMap<TransactionKey, _>>>` contention under N concurrent
 //!    tokio tasks — the structure used verbatim by `TransactionManager`.
 //!
+//! 3. Transaction timers: arm+cancel and arm+fire rates through
+//!    `TimerManager` (the shared timing wheel) against a spawned
+//!    sleeper task per timer, plus the heap held by 100k armed timers
+//!    for each, printed before the timer groups run. A counting global
+//!    allocator supplies the memory numbers.
+//!
 //! Use these to ground end-to-end results from
 //! `crates/sip/rvoip-sip/benches/call_setup.rs` and the `dialog_steady_state`
 //! profiling example. See `crates/sip/rvoip-sip/docs/PROFILING.md`.
@@ -17,17 +23,51 @@
 use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
 use dashmap::DashMap;
 use rvoip_sip_core::types::Method;
+use rvoip_sip_dialog::transaction::timer::{TimerManager, TimerType};
 use rvoip_sip_dialog::transaction::TransactionKey;
+use std::alloc::{GlobalAlloc, Layout, System};
 use std::collections::HashMap;
+use std::sync::atomic::{AtomicUsize, Ordering};
 use std::sync::Arc;
 use std::time::{Duration, Instant};
 use tokio::runtime::Builder;
-use tokio::sync::Mutex;
+use tokio::sync::{mpsc, Mutex};
 
 const TABLE_SIZES: [usize; 4] = [10, 1_000, 10_000, 100_000];
 const CONTENDED_TABLE_SIZE: usize = 10_000;
 const CONTENDED_OPS_PER_TASK: u64 = 200;
 const THREAD_COUNTS: [usize; 4] = [1, 4, 8, 16];
+const TIMER_COUNTS: [usize; 3] = [1_000, 10_000, 100_000];
+/// Armed-timer population for the memory report
+const TIMER_MEMORY_POPULATION: usize = 100_000;
+/// Long enough that no timer fires while it is being measured (Timer B)
+const LONG_TIMER: Duration = Duration::from_secs(32);
+
+/// System allocator that tracks live heap bytes
+struct CountingAlloc;
+
+static LIVE_BYTES: AtomicUsize = AtomicUsize::new(0);
+
+unsafe impl GlobalAlloc for CountingAlloc {
+    unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+        LIVE_BYTES.fetch_add(layout.size(), Ordering::Relaxed);
+        System.alloc(layout)
+    }
+
+    unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
+        LIVE_BYTES.fetch_sub(layout.size(), Ordering::Relaxed);
+        System.dealloc(ptr, layout)
+    }
+
+    unsafe fn realloc(&self, ptr: *mut u8, layout: Layout, new_size: usize) -> *mut u8 {
+        LIVE_BYTES.fetch_add(new_size, Ordering::Relaxed);
+        LIVE_BYTES.fetch_sub(layout.size(), Ordering::Relaxed);
+        System.realloc(ptr, layout, new_size)
+    }
+}
+
+#[global_allocator]
+static GLOBAL: CountingAlloc = CountingAlloc;
 
 fn make_key(i: usize, is_server: bool) -> TransactionKey {
     TransactionKey::new(format!("z9hG4bK{:08x}", i), Method::Invite, is_server)
@@ -362,11 +402,194 @@ fn bench_cross_await_tail(c: &mut Criterion) {
     group.finish();
 }
 
+/// Heap bytes held while `armed` timers are pending, per timer
+fn report_timer_memory(rt: &tokio::runtime::Runtime) {
+    let keys: Vec<TransactionKey> = (0..TIMER_MEMORY_POPULATION)
+        .map(|i| make_key(i, false))
+        .collect();
+
+    let wheel = rt.block_on(async {
+        let manager = TimerManager::new(None);
+        let before = LIVE_BYTES.load(Ordering::Relaxed);
+        let mut handles = Vec::with_capacity(keys.len());
+        let handles_bytes = LIVE_BYTES.load(Ordering::Relaxed).saturating_sub(before);
+        for key in &keys {
+            handles.push(
+                manager
+                    .start_timer(key.clone(), TimerType::B, LONG_TIMER)
+                    .await
+                    .expect("timer"),
+            );
+        }
+        let held = LIVE_BYTES
+            .load(Ordering::Relaxed)
+            .saturating_sub(before + handles_bytes);
+        for handle in &handles {
+            handle.abort();
+        }
+        held
+    });
+
+    let sleepers = rt.block_on(async {
+        let before = LIVE_BYTES.load(Ordering::Relaxed);
+        let mut handles = Vec::with_capacity(keys.len());
+        let handles_bytes = LIVE_BYTES.load(Ordering::Relaxed).saturating_sub(before);
+        for key in &keys {
+            let key = key.clone();
+            handles.push(tokio::spawn(async move {
+                tokio::time::sleep(LONG_TIMER).await;
+                black_box(key);
+            }));
+        }
+        // Let every task register its sleep with the runtime's timer.
+        tokio::task::yield_now().await;
+        let held = LIVE_BYTES
+            .load(Ordering::Relaxed)
+            .saturating_sub(before + handles_bytes);
+        for handle in &handles {
+            handle.abort();
+        }
+        held
+    });
+
+    println!();
+    println!(
+        "{:<14} {:>10} {:>14} {:>14}",
+        "timers", "armed", "heap_bytes", "bytes/timer"
+    );
+    for (name, bytes) in [("wheel", wheel), ("spawned_sleep", sleepers)] {
+        println!(
+            "{:<14} {:>10} {:>14} {:>14.1}",
+            name,
+            TIMER_MEMORY_POPULATION,
+            bytes,
+            bytes as f64 / TIMER_MEMORY_POPULATION as f64
+        );
+    }
+    println!();
+}
+
+/// Arm then cancel `n` timers: the common case, since retransmission
+/// and timeout timers are cancelled by the response that ends them.
+fn bench_timer_arm_cancel(c: &mut Criterion) {
+    let rt = Builder::new_multi_thread()
+        .worker_threads(4)
+        .enable_all()
+        .build()
+        .expect("runtime");
+    report_timer_memory(&rt);
+
+    let mut group = c.benchmark_group("dialog_timer_arm_cancel");
+    for &n in &TIMER_COUNTS {
+        let keys: Vec<TransactionKey> = (0..n).map(|i| make_key(i, false)).collect();
+        group.throughput(Throughput::Elements(n as u64));
+
+        group.bench_with_input(BenchmarkId::new("wheel", n), &keys, |b, keys| {
+            let manager = TimerManager::new(None);
+            b.iter(|| {
+                rt.block_on(async {
+                    let mut handles = Vec::with_capacity(keys.len());
+                    for key in keys {
+                        handles.push(
+                            manager
+                                .start_timer(key.clone(), TimerType::B, LONG_TIMER)
+                                .await
+                                .expect("timer"),
+                        );
+                    }
+                    for handle in &handles {
+                        handle.abort();
+                    }
+                })
+            });
+        });
+
+        group.bench_with_input(BenchmarkId::new("spawned_sleep", n), &keys, |b, keys| {
+            b.iter(|| {
+                rt.block_on(async {
+                    let mut handles = Vec::with_capacity(keys.len());
+                    for key in keys {
+                        let key = key.clone();
+                        handles.push(tokio::spawn(async move {
+                            tokio::time::sleep(LONG_TIMER).await;
+                            black_box(key);
+                        }));
+                    }
+                    for handle in &handles {
+                        handle.abort();
+                    }
+                })
+            });
+        });
+    }
+    group.finish();
+}
+
+/// Arm `n` short timers and wait for every expiry to be delivered to
+/// the transaction's command channel.
+fn bench_timer_arm_fire(c: &mut Criterion) {
+    const FIRE_AFTER: Duration = Duration::from_millis(1);
+
+    let rt = Builder::new_multi_thread()
+        .worker_threads(4)
+        .enable_all()
+        .build()
+        .expect("runtime");
+
+    let mut group = c.benchmark_group("dialog_timer_arm_fire");
+    group.sample_size(20);
+    for &n in &TIMER_COUNTS[..2] {
+        let keys: Vec<TransactionKey> = (0..n).map(|i| make_key(i, false)).collect();
+        group.throughput(Throughput::Elements(n as u64));
+
+        group.bench_with_input(BenchmarkId::new("wheel", n), &keys, |b, keys| {
+            b.iter(|| {
+                rt.block_on(async {
+                    let manager = TimerManager::new(None);
+                    let (tx, mut rx) = mpsc::channel(keys.len());
+                    for key in keys {
+                        manager.register_transaction(key.clone(), tx.clone()).await;
+                        manager
+                            .start_timer(key.clone(), TimerType::A, FIRE_AFTER)
+                            .await
+                            .expect("timer");
+                    }
+                    for _ in 0..keys.len() {
+                        black_box(rx.recv().await);
+                    }
+                })
+            });
+        });
+
+        group.bench_with_input(BenchmarkId::new("spawned_sleep", n), &keys, |b, keys| {
+            b.iter(|| {
+                rt.block_on(async {
+                    let (tx, mut rx) = mpsc::channel(keys.len());
+                    for key in keys {
+                        let key = key.clone();
+                        let tx = tx.clone();
+                        tokio::spawn(async move {
+                            tokio::time::sleep(FIRE_AFTER).await;
+                            let _ = tx.send(key).await;
+                        });
+                    }
+                    for _ in 0..keys.len() {
+                        black_box(rx.recv().await);
+                    }
+                })
+            });
+        });
+    }
+    group.finish();
+}
+
 criterion_group!(
     benches,
     bench_key_lookup,
     bench_contended_lookup,
     bench_insert_remove,
-    bench_cross_await_tail
+    bench_cross_await_tail,
+    bench_timer_arm_cancel,
+    bench_timer_arm_fire
 );
 criterion_main!(benches);
@@ -253,7 +253,10 @@ pub mod uri_resolver {
 /// [`new_system_resilient`](rvoip_sip_transport::resolver::HickoryResolver::new_system_resilient):
 /// the config read is capped at 2s and falls back to a default config if the
 /// host's DNS setup is slow/hung, so the first non-IP, non-localhost resolution
-/// can never stall the caller for seconds.
+/// can never stall the caller for seconds. Results are cached by a
+/// [`CachingResolver`](rvoip_sip_transport::resolver::CachingResolver) for
+/// their DNS TTL, so repeated requests to the same domain skip the
+/// NAPTR/SRV/A ladder.
 async fn process_default_resolver(
 ) -> Option<std::sync::Arc<dyn rvoip_sip_transport::resolver::Resolver>> {
     use std::sync::Arc;
@@ -267,7 +270,9 @@ async fn process_default_resolver(
                 std::time::Duration::from_secs(2),
             )
             .await;
-            Arc::new(r) as Arc<dyn rvoip_sip_transport::resolver::Resolver>
+            Arc::new(rvoip_sip_transport::resolver::CachingResolver::new(
+                Arc::new(r),
+            )) as Arc<dyn rvoip_sip_transport::resolver::Resolver>
         })
         .await
         .clone();
@@ -23,7 +23,7 @@ use tokio::task::JoinHandle;
 use tracing::{debug, trace};
 
 use rvoip_sip_core::prelude::*;
-use rvoip_sip_transport::Transport;
+use rvoip_sip_transport::{Error as TransportError, Transport, WireCache};
 
 use crate::transaction::error::{Error, Result};
 use crate::transaction::runner::{
@@ -80,6 +80,10 @@ pub struct ClientTransactionData {
     /// fire, per retransmit, per state action.
     pub request: Arc<Request>,
 
+    /// Wire form of `request`, serialized on the first retransmission and
+    /// reused for every later one.
+    pub request_wire: Arc<WireCache>,
+
     /// Last response received for this transaction
     pub last_response: Arc<Mutex<Option<Response>>>,
 
@@ -116,6 +120,33 @@ impl Drop for ClientTransactionData {
     }
 }
 
+impl ClientTransactionData {
+    /// Send the request for the first time.
+    ///
+    /// A request whose serialized form was seeded in `request_wire` goes
+    /// out through the cache, so neither this send nor a retransmission
+    /// serializes it again.
+    pub async fn send_initial_request(&self) -> std::result::Result<(), TransportError> {
+        if self.request_wire.serialized().is_some() {
+            return self.retransmit_request().await;
+        }
+        self.transport
+            .send_message(Message::Request(self.request.clone()), self.remote_addr)
+            .await
+    }
+
+    /// Retransmit the original request (Timer A / Timer E).
+    ///
+    /// The request is immutable, so the transport serializes it once and
+    /// reuses the bytes on every retransmission, while still choosing the
+    /// transport, Via and trace exactly as it did for the first send.
+    pub async fn retransmit_request(&self) -> std::result::Result<(), TransportError> {
+        self.transport
+            .send_request_cached(&self.request, &self.request_wire, self.remote_addr)
+            .await
+    }
+}
+
 /// Common behavior trait for all client transactions.
 ///
 /// This trait provides shared functionality that all client transactions need,
@@ -67,11 +67,10 @@ use std::pin::Pin;
 use std::sync::Arc;
 use std::time::Duration;
 use tokio::sync::{mpsc, Mutex};
-use tokio::task::JoinHandle;
 use tracing::{debug, error, trace, warn};
 
 use rvoip_sip_core::prelude::*;
-use rvoip_sip_transport::Transport;
+use rvoip_sip_transport::{Transport, WireCache};
 
 use crate::transaction::client::{
     ClientTransaction, ClientTransactionData, CommonClientTransaction,
@@ -79,7 +78,9 @@ use crate::transaction::client::{
 use crate::transaction::error::{Error, Result};
 use crate::transaction::logic::TransactionLogic;
 use crate::transaction::runner::run_transaction_loop;
-use crate::transaction::timer::{TimerFactory, TimerManager, TimerSettings, TimerType};
+use crate::transaction::timer::{
+    TimerFactory, TimerHandle, TimerManager, TimerSettings, TimerType,
+};
 use crate::transaction::utils;
 use crate::transaction::{
     AtomicTransactionState, InternalTransactionCommand, Transaction, TransactionAsync,
@@ -115,23 +116,23 @@ pub struct ClientInviteTransaction {
     logic: Arc<ClientInviteLogic>,
 }
 
-/// Holds JoinHandles and dynamic state for timers specific to Client INVITE transactions.
+/// Holds timer handles and dynamic state for timers specific to Client INVITE transactions.
 ///
 /// Used by the transaction runner to manage the various timers required by the
 /// INVITE client transaction state machine as defined in RFC 3261.
 #[derive(Default, Debug)]
 struct ClientInviteTimerHandles {
     /// Handle for Timer A, which controls INVITE retransmissions
-    timer_a: Option<JoinHandle<()>>,
+    timer_a: Option<TimerHandle>,
 
     /// Current interval for Timer A, which doubles after each firing
     current_timer_a_interval: Option<Duration>, // For backoff
 
     /// Handle for Timer B, which controls transaction timeout
-    timer_b: Option<JoinHandle<()>>,
+    timer_b: Option<TimerHandle>,
 
     /// Handle for Timer D, which controls how long to wait in Completed state
-    timer_d: Option<JoinHandle<()>>,
+    timer_d: Option<TimerHandle>,
 }
 
 /// Implements the TransactionLogic for Client INVITE transactions.
@@ -268,12 +269,7 @@ impl ClientInviteLogic {
 
         // Send the initial request
         debug!(id=%tx_id, "ClientInviteLogic: Sending initial request in Calling state");
-        let request_guard: &Request = &data.request;
-        if let Err(e) = data
-            .transport
-            .send_message(Message::Request(request_guard.clone()), data.remote_addr)
-            .await
-        {
+        if let Err(e) = data.send_initial_request().await {
             error!(id=%tx_id, error=%e, "Failed to send initial request from Calling state");
             common_logic::send_transport_error_event(tx_id, &data.events_tx).await;
             // If send fails, command a transition to Terminated
@@ -284,7 +280,6 @@ impl ClientInviteLogic {
                 .await;
             return Err(Error::transport_error(e, "Failed to send initial request"));
         }
-        // `request_guard` is a plain `&Request`, no lock to release.
 
         // Start timers for Calling state
         timer_handles.current_timer_a_interval = Some(data.timer_config.t1);
@@ -315,12 +310,7 @@ impl ClientInviteLogic {
                 debug!(id=%tx_id, "Timer A triggered, retransmitting INVITE request");
 
                 // Retransmit the request
-                let request_guard: &Request = &data.request;
-                if let Err(e) = data
-                    .transport
-                    .send_message(Message::Request(request_guard.clone()), data.remote_addr)
-                    .await
-                {
+                if let Err(e) = data.retransmit_request().await {
                     error!(id=%tx_id, error=%e, "Failed to retransmit request");
                     common_logic::send_transport_error_event(tx_id, &data.events_tx).await;
                     return Ok(Some(TransactionState::Terminated));
@@ -457,7 +447,6 @@ impl ClientInviteLogic {
         // Get the original method from the request to validate the response
         let request_guard: &Request = &data.request;
         let original_method = validators::get_method_from_request(&request_guard);
-        // `request_guard` is a plain `&Request`, no lock to release.
 
         // Validate that the response matches our transaction
         if let Err(e) =
@@ -766,6 +755,7 @@ impl ClientInviteTransaction {
             state: Arc::new(AtomicTransactionState::new(TransactionState::Initial)),
             lifecycle: Arc::new(std::sync::atomic::AtomicU8::new(0)), // TransactionLifecycle::Active
             request: Arc::new(request.clone()),
+            request_wire: Arc::new(WireCache::new()),
             last_response: Arc::new(Mutex::new(None)),
             remote_addr,
             transport,
@@ -67,11 +67,10 @@ use std::pin::Pin;
 use std::sync::Arc;
 use std::time::Duration;
 use tokio::sync::{mpsc, Mutex};
-use tokio::task::JoinHandle;
 use tracing::{debug, error, trace, warn};
 
 use rvoip_sip_core::prelude::*;
-use rvoip_sip_transport::Transport;
+use rvoip_sip_transport::{Transport, WireCache};
 
 use crate::transaction::client::data::CommonClientTransaction;
 use crate::transaction::client::{ClientTransaction, ClientTransactionData};
@@ -79,7 +78,9 @@ use crate::transaction::common_logic;
 use crate::transaction::error::{Error, Result};
 use crate::transaction::logic::TransactionLogic;
 use crate::transaction::runner::run_transaction_loop;
-use crate::transaction::timer::{TimerFactory, TimerManager, TimerSettings, TimerType};
+use crate::transaction::timer::{
+    TimerFactory, TimerHandle, TimerManager, TimerSettings, TimerType,
+};
 use crate::transaction::timer_utils;
 use crate::transaction::validators;
 use crate::transaction::{
@@ -113,23 +114,23 @@ pub struct ClientNonInviteTransaction {
     logic: Arc<ClientNonInviteLogic>,
 }
 
-/// Holds JoinHandles and dynamic state for timers specific to Client Non-INVITE transactions.
+/// Holds timer handles and dynamic state for timers specific to Client Non-INVITE transactions.
 ///
 /// Used by the transaction runner to manage the various timers required by the
 /// non-INVITE client transaction state machine as defined in RFC 3261.
 #[derive(Default, Debug)]
 struct ClientNonInviteTimerHandles {
     /// Handle for Timer E, which controls request retransmissions
-    timer_e: Option<JoinHandle<()>>,
+    timer_e: Option<TimerHandle>,
 
     /// Current interval for Timer E, which doubles after each firing (up to T2)
     current_timer_e_interval: Option<Duration>, // For backoff
 
     /// Handle for Timer F, which controls transaction timeout
-    timer_f: Option<JoinHandle<()>>,
+    timer_f: Option<TimerHandle>,
 
     /// Handle for Timer K, which controls how long to wait in Completed state
-    timer_k: Option<JoinHandle<()>>,
+    timer_k: Option<TimerHandle>,
 }
 
 /// Implements the TransactionLogic for Client Non-INVITE transactions.
@@ -276,12 +277,7 @@ impl ClientNonInviteLogic {
 
         // Send the initial request
         debug!(id=%tx_id, "ClientNonInviteLogic: Sending initial request in Trying state");
-        let request_guard: &Request = &data.request;
-        if let Err(e) = data
-            .transport
-            .send_message(Message::Request(request_guard.clone()), data.remote_addr)
-            .await
-        {
+        if let Err(e) = data.send_initial_request().await {
             error!(id=%tx_id, error=%e, "Failed to send initial request from Trying state");
             common_logic::send_transport_error_event(tx_id, &data.events_tx).await;
             // If send fails, command a transition to Terminated
@@ -292,7 +288,6 @@ impl ClientNonInviteLogic {
                 .await;
             return Err(Error::transport_error(e, "Failed to send initial request"));
         }
-        // `request_guard` is a plain `&Request`, no lock to release.
 
         // Start timers for Trying state
         self.start_timer_e(data, timer_handles, command_tx.clone())
@@ -322,12 +317,7 @@ impl ClientNonInviteLogic {
                 debug!(id=%tx_id, "Timer E triggered, retransmitting request");
 
                 // Retransmit the request
-                let request_guard: &Request = &data.request;
-                if let Err(e) = data
-                    .transport
-                    .send_message(Message::Request(request_guard.clone()), data.remote_addr)
-                    .await
-                {
+                if let Err(e) = data.retransmit_request().await {
                     error!(id=%tx_id, error=%e, "Failed to retransmit request");
                     common_logic::send_transport_error_event(tx_id, &data.events_tx).await;
                     return Ok(Some(TransactionState::Terminated));
@@ -446,7 +436,6 @@ impl ClientNonInviteLogic {
         // Get the original method from the request to validate the response
         let request_guard: &Request = &data.request;
         let original_method = validators::get_method_from_request(&request_guard);
-        // `request_guard` is a plain `&Request`, no lock to release.
 
         // Validate that the response matches our transaction
         if let Err(e) =
@@ -722,6 +711,7 @@ impl ClientNonInviteTransaction {
             state: Arc::new(AtomicTransactionState::new(TransactionState::Initial)),
             lifecycle: Arc::new(std::sync::atomic::AtomicU8::new(0)), // TransactionLifecycle::Active
             request: Arc::new(request.clone()),
+            request_wire: Arc::new(WireCache::new()),
             last_response: Arc::new(Mutex::new(None)),
             remote_addr,
             transport,
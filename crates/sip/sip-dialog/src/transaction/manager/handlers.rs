@@ -40,6 +40,7 @@ use crate::transaction::state::TransactionLifecycle;
 use crate::transaction::utils::{create_ack_from_invite, transaction_key_from_message};
 use crate::transaction::{TransactionEvent, TransactionKey, TransactionKind, TransactionState};
 
+use super::table::TransactionTable;
 use super::types::*;
 use super::TransactionManager;
 
@@ -73,10 +74,8 @@ use super::TransactionManager;
 pub(crate) async fn handle_transport_message(
     event: TransportEvent,
     transport: &Arc<dyn Transport>,
-    client_transactions: &Arc<
-        dashmap::DashMap<TransactionKey, crate::transaction::manager::ArcClientTransaction>,
-    >,
-    server_transactions: &Arc<dashmap::DashMap<TransactionKey, Arc<dyn ServerTransaction>>>,
+    client_transactions: &Arc<TransactionTable<crate::transaction::manager::ArcClientTransaction>>,
+    server_transactions: &Arc<TransactionTable<Arc<dyn ServerTransaction>>>,
     events_tx: &mpsc::Sender<TransactionEvent>,
     event_subscribers: &Arc<arc_swap::ArcSwap<Vec<super::EventSubscriber>>>,
     manager: &TransactionManager,
@@ -158,12 +158,15 @@ mod functions;
 ///   Transport Layer
 /// ```
 mod handlers;
+mod shards;
+mod table;
 #[cfg(test)]
 mod tests;
 mod types;
 pub mod utils;
 
 pub use handlers::*;
+pub use shards::TransactionExecutionMode;
 pub use types::*;
 pub use utils::*;
 
@@ -172,7 +175,7 @@ use std::fmt;
 use std::hash::{DefaultHasher, Hash, Hasher};
 use std::net::SocketAddr;
 use std::sync::atomic::{AtomicBool, AtomicU64, AtomicUsize, Ordering};
-use std::sync::Arc;
+use std::sync::{Arc, OnceLock};
 use std::time::{Duration, Instant};
 
 use arc_swap::ArcSwap;
@@ -183,8 +186,10 @@ use tracing::{debug, error, info, trace, warn};
 
 use rvoip_infra_common::events::cross_crate::SipTransportContext;
 use rvoip_sip_core::prelude::*;
+use rvoip_sip_core::types::wire::{PreparedMessage, WireFormat};
 use rvoip_sip_core::{Host, TypedHeader};
 use rvoip_sip_transport::diagnostics as udp_diagnostics;
+use rvoip_sip_transport::transport::shard::{message_shard_hash, shard_index, ShardSink};
 use rvoip_sip_transport::transport::TransportType;
 use rvoip_sip_transport::{
     Error as TransportError, Transport, TransportEvent, TransportReceiveTiming,
@@ -192,7 +197,7 @@ use rvoip_sip_transport::{
 
 use crate::diagnostics;
 use crate::transaction::client::{
-    ClientInviteTransaction, ClientNonInviteTransaction, ClientTransaction,
+    ClientInviteTransaction, ClientNonInviteTransaction, ClientTransaction, CommonClientTransaction,
 };
 use crate::transaction::error::{Error, Result};
 use crate::transaction::method::{cancel, update};
@@ -214,6 +219,8 @@ use crate::transaction::{
     InternalTransactionCommand, Transaction, TransactionEvent, TransactionKey, TransactionKind,
     TransactionState, DEFAULT_TRANSACTION_COMMAND_CHANNEL_CAPACITY,
 };
+use shards::TransactionShards;
+use table::TransactionTable;
 
 // Type aliases without Sync requirement. `BoxedTransaction` and
 // `BoxedServerTransaction` below are retained for downstream APIs
@@ -293,6 +300,12 @@ fn transaction_dispatch_worker_count(workers: Option<usize>) -> usize {
         .clamp(1, MAX_TRANSACTION_DISPATCH_WORKERS)
 }
 
+fn transaction_shard_count(shards: Option<usize>) -> usize {
+    shards
+        .unwrap_or_else(|| std::thread::available_parallelism().map_or(1, |n| n.get()))
+        .clamp(1, MAX_TRANSACTION_DISPATCH_WORKERS)
+}
+
 fn transaction_dispatch_queue_capacity(capacity: Option<usize>, default_capacity: usize) -> usize {
     capacity.unwrap_or(default_capacity).max(1)
 }
@@ -338,6 +351,14 @@ fn normalize_top_client_via(request: &mut Request, branch: &str) -> bool {
     false
 }
 
+/// Hand a client transaction the serialized form of its request so its
+/// sends reuse it instead of serializing the request again
+fn seed_request_wire(tx: &impl CommonClientTransaction, wire: Option<&bytes::Bytes>) {
+    if let Some(wire) = wire {
+        tx.data().request_wire.set_serialized(wire.clone());
+    }
+}
+
 fn sip_diagnostics_enabled() -> bool {
     diagnostics::enabled()
 }
@@ -359,15 +380,15 @@ fn sip_diagnostics_enabled() -> bool {
 pub struct TransactionManager {
     /// Transport to use for messages
     transport: Arc<dyn Transport>,
-    /// Active client transactions. DashMap for sharded lock-free reads
-    /// across cores; per-transaction state is owned by the
-    /// `Arc<dyn ClientTransaction>` itself (its impls hold their own
+    /// Active client transactions, one partition per transaction shard
+    /// (a single partition in shared mode); per-transaction state is owned
+    /// by the `Arc<dyn ClientTransaction>` itself (its impls hold their own
     /// internal `Arc<Mutex<...>>` over data + timers + state machine).
     /// Hot-path call sites clone the Arc out, drop the shard guard,
     /// then await — no map-wide serialization on transport I/O.
-    client_transactions: Arc<DashMap<TransactionKey, ArcClientTransaction>>,
+    client_transactions: Arc<TransactionTable<ArcClientTransaction>>,
     /// Active server transactions. Same pattern as `client_transactions`.
-    server_transactions: Arc<DashMap<TransactionKey, Arc<dyn ServerTransaction>>>,
+    server_transactions: Arc<TransactionTable<Arc<dyn ServerTransaction>>>,
     /// Indexed queue of transactions that reached `Terminated`.
     /// The periodic cleanup task drains this instead of scanning every active
     /// transaction map on each tick; occasional full sweeps remain as a
@@ -390,9 +411,9 @@ pub struct TransactionManager {
     invite_2xx_response_due_queue: Arc<std::sync::Mutex<BinaryHeap<Invite2xxDueEntry>>>,
     invite_2xx_response_due_sequence: Arc<AtomicU64>,
     terminated_cleanup_tx: Option<mpsc::Sender<TerminatedCleanupItem>>,
-    /// Transaction destinations — `transaction_id → SocketAddr`.
-    /// DashMap for sharded lock-free reads.
-    transaction_destinations: Arc<DashMap<TransactionKey, SocketAddr>>,
+    /// Transaction destinations — `transaction_id → SocketAddr`,
+    /// partitioned like `client_transactions`.
+    transaction_destinations: Arc<TransactionTable<SocketAddr>>,
     /// Event sender
     events_tx: mpsc::Sender<TransactionEvent>,
     /// Additional event subscribers. ArcSwap so the broadcast hot path
@@ -403,9 +424,9 @@ pub struct TransactionManager {
     /// Maps subscribers to transactions they're interested in.
     /// DashMap — guards never held across `.await`.
     subscriber_to_transactions: Arc<DashMap<usize, Vec<TransactionKey>>>,
-    /// Maps transactions to subscribers interested in them.
-    /// DashMap — guards never held across `.await`.
-    transaction_to_subscribers: Arc<DashMap<TransactionKey, Vec<usize>>>,
+    /// Maps transactions to subscribers interested in them, partitioned
+    /// like `client_transactions`. Guards never held across `.await`.
+    transaction_to_subscribers: Arc<TransactionTable<Vec<usize>>>,
     /// Subscriber counter for assigning unique IDs. `AtomicUsize` —
     /// the previous `Mutex<usize>` only ever did fetch-and-increment.
     next_subscriber_id: Arc<AtomicUsize>,
@@ -453,6 +474,10 @@ pub struct TransactionManager {
     pub(crate) pending_inbound_timing: Arc<DashMap<TransactionKey, TransportReceiveTiming>>,
     transaction_dispatch_workers: usize,
     transaction_dispatch_queue_capacity: usize,
+    transaction_execution_mode: TransactionExecutionMode,
+    /// Shard runtimes in [`TransactionExecutionMode::Sharded`]; set once
+    /// when the message loop starts
+    transaction_shards: Arc<OnceLock<TransactionShards>>,
     transaction_command_channel_capacity: usize,
     transaction_dispatch_priority_burst_max: Arc<AtomicUsize>,
     invite_2xx_retransmit_max_due_per_tick: Arc<AtomicUsize>,
@@ -486,12 +511,20 @@ struct QueuedTransactionDispatch {
     worker_id: usize,
 }
 
-#[derive(Clone)]
+#[derive(Debug, Clone)]
 struct TransactionDispatchWorkerSender {
     high: mpsc::Sender<QueuedTransactionDispatch>,
     normal: mpsc::Sender<QueuedTransactionDispatch>,
 }
 
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+enum TransactionDispatchRoute {
+    /// Requests by Call-ID + From tag, everything else by transaction key
+    DialogKey,
+    /// Every message by top-Via branch to the shard owning its transaction
+    TransactionShard,
+}
+
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
 enum TransactionDispatchLane {
     High,
@@ -530,6 +563,21 @@ impl PartialOrd for Invite2xxDueEntry {
 // Define RFC3261 Branch magic cookie
 pub const RFC3261_BRANCH_MAGIC_COOKIE: &str = "z9hG4bK";
 
+/// Branch of the client transaction `request` starts: its top Via's branch,
+/// or a fresh RFC 3261 branch when it has none
+fn client_transaction_branch(request: &Request) -> String {
+    request
+        .first_via()
+        .and_then(|via| via.branch().map(str::to_string))
+        .unwrap_or_else(|| {
+            format!(
+                "{}{}",
+                RFC3261_BRANCH_MAGIC_COOKIE,
+                uuid::Uuid::new_v4().as_simple()
+            )
+        })
+}
+
 /// Build default `TimerSettings`, with an opt-in test hook that lets
 /// integration tests shorten Timer F (non-INVITE transaction timeout) so
 /// they don't have to wait the full 32 s for a dead peer to surface as a
@@ -613,6 +661,24 @@ fn transaction_dispatch_worker_index(
     fallback_worker.fetch_add(1, Ordering::Relaxed) % worker_count
 }
 
+fn transaction_shard_index(
+    event: &TransportEvent,
+    shard_count: usize,
+    fallback_shard: &AtomicUsize,
+) -> usize {
+    if shard_count <= 1 {
+        return 0;
+    }
+
+    if let TransportEvent::MessageReceived { message, .. } = event {
+        if let Some(hash) = message_shard_hash(message) {
+            return shard_index(hash, shard_count);
+        }
+    }
+
+    fallback_shard.fetch_add(1, Ordering::Relaxed) % shard_count
+}
+
 fn start_transaction_dispatch_workers(
     manager: TransactionManager,
     worker_count: usize,
@@ -624,34 +690,16 @@ fn start_transaction_dispatch_workers(
     let mut senders = Vec::with_capacity(worker_count);
 
     for worker_id in 0..worker_count {
-        let (high_tx, mut high_rx) =
+        let (high_tx, high_rx) = mpsc::channel::<QueuedTransactionDispatch>(per_worker_capacity);
+        let (normal_tx, normal_rx) =
             mpsc::channel::<QueuedTransactionDispatch>(per_worker_capacity);
-        let (normal_tx, mut normal_rx) =
-            mpsc::channel::<QueuedTransactionDispatch>(per_worker_capacity);
-        let manager_for_worker = manager.clone();
-        let priority_burst_max_for_worker = priority_burst_max.clone();
-        tokio::spawn(async move {
-            let mut high_burst_count = 0usize;
-            while let Some(queued) = recv_transaction_dispatch_event(
-                &mut high_rx,
-                &mut normal_rx,
-                &mut high_burst_count,
-                priority_burst_max_for_worker.load(Ordering::Relaxed).max(1),
-            )
-            .await
-            {
-                if let Some(queued_at) = queued.queued_at {
-                    diagnostics::record_transaction_dispatch_queue_by_worker_and_kind(
-                        queued.worker_id,
-                        queued.kind.as_str(),
-                        queued_at.elapsed(),
-                        high_rx.len() + normal_rx.len(),
-                    );
-                }
-                process_transaction_dispatch_event(&manager_for_worker, queued).await;
-            }
-            debug!(worker_id, "Transaction dispatch worker terminated");
-        });
+        tokio::spawn(run_transaction_dispatch_worker(
+            manager.clone(),
+            worker_id,
+            high_rx,
+            normal_rx,
+            priority_burst_max.clone(),
+        ));
         senders.push(TransactionDispatchWorkerSender {
             high: high_tx,
             normal: normal_tx,
@@ -666,6 +714,97 @@ fn start_transaction_dispatch_workers(
     Arc::new(senders)
 }
 
+/// Start one run-to-completion shard per worker (see [`shards`]) and record
+/// them on `manager`. Returns `None`, leaving the manager on shared
+/// dispatch, if the shard threads cannot be started.
+fn start_transaction_shards(
+    manager: &TransactionManager,
+    shard_count: usize,
+    queue_capacity: usize,
+    priority_burst_max: Arc<AtomicUsize>,
+) -> Option<Arc<Vec<TransactionDispatchWorkerSender>>> {
+    let shard_count = shard_count.clamp(1, MAX_TRANSACTION_DISPATCH_WORKERS);
+    let per_shard_capacity = (queue_capacity / shard_count).max(1);
+    let mut senders = Vec::with_capacity(shard_count);
+    let mut workers = Vec::with_capacity(shard_count);
+
+    for shard_id in 0..shard_count {
+        let (high_tx, high_rx) = mpsc::channel::<QueuedTransactionDispatch>(per_shard_capacity);
+        let (normal_tx, normal_rx) = mpsc::channel::<QueuedTransactionDispatch>(per_shard_capacity);
+        let manager = manager.clone();
+        let priority_burst_max = priority_burst_max.clone();
+        workers.push(move || {
+            run_transaction_dispatch_worker(
+                manager,
+                shard_id,
+                high_rx,
+                normal_rx,
+                priority_burst_max,
+            )
+        });
+        senders.push(TransactionDispatchWorkerSender {
+            high: high_tx,
+            normal: normal_tx,
+        });
+    }
+
+    match TransactionShards::start(workers) {
+        Ok(shards) => {
+            let _ = manager.transaction_shards.set(shards);
+            let senders = Arc::new(senders);
+            // UDP parse workers queue on the shards directly; other
+            // transports still go through the message loop.
+            let direct_ingress = manager
+                .transport
+                .attach_shard_sink(Arc::new(TransactionShardSink {
+                    senders: senders.clone(),
+                    running: manager.running.clone(),
+                }));
+            info!(
+                shards = shard_count,
+                per_shard_capacity, direct_ingress, "Transaction manager shards enabled"
+            );
+            Some(senders)
+        }
+        Err(e) => {
+            error!(
+                "Failed to start transaction shards, using shared dispatch: {}",
+                e
+            );
+            None
+        }
+    }
+}
+
+async fn run_transaction_dispatch_worker(
+    manager: TransactionManager,
+    worker_id: usize,
+    mut high_rx: mpsc::Receiver<QueuedTransactionDispatch>,
+    mut normal_rx: mpsc::Receiver<QueuedTransactionDispatch>,
+    priority_burst_max: Arc<AtomicUsize>,
+) {
+    let mut high_burst_count = 0usize;
+    while let Some(queued) = recv_transaction_dispatch_event(
+        &mut high_rx,
+        &mut normal_rx,
+        &mut high_burst_count,
+        priority_burst_max.load(Ordering::Relaxed).max(1),
+    )
+    .await
+    {
+        if let Some(queued_at) = queued.queued_at {
+            diagnostics::record_transaction_dispatch_queue_by_worker_and_kind(
+                queued.worker_id,
+                queued.kind.as_str(),
+                queued_at.elapsed(),
+                high_rx.len() + normal_rx.len(),
+            );
+        }
+        process_transaction_dispatch_event(&manager, queued).await;
+    }
+    debug!(worker_id, "Transaction dispatch worker terminated");
+}
+
 async fn recv_transaction_dispatch_event(
     high_rx: &mut mpsc::Receiver<QueuedTransactionDispatch>,
     normal_rx: &mut mpsc::Receiver<QueuedTransactionDispatch>,
@@ -747,10 +886,27 @@ async fn recv_normal_transaction_dispatch_event(
 async fn dispatch_transaction_event(
     event: TransportEvent,
     dispatch_senders: &Arc<Vec<TransactionDispatchWorkerSender>>,
+    route: TransactionDispatchRoute,
     fallback_worker: &AtomicUsize,
 ) {
-    let worker_index =
-        transaction_dispatch_worker_index(&event, dispatch_senders.len(), fallback_worker);
+    let worker_index = match route {
+        TransactionDispatchRoute::DialogKey => {
+            transaction_dispatch_worker_index(&event, dispatch_senders.len(), fallback_worker)
+        }
+        TransactionDispatchRoute::TransactionShard => {
+            transaction_shard_index(&event, dispatch_senders.len(), fallback_worker)
+        }
+    };
+    let _ = enqueue_transaction_dispatch(event, dispatch_senders, worker_index).await;
+}
+
+/// Queue `event` on the lane of `worker_index` its kind belongs to, waiting
+/// while that lane is full. Hands the event back if the worker has stopped.
+async fn enqueue_transaction_dispatch(
+    event: TransportEvent,
+    dispatch_senders: &[TransactionDispatchWorkerSender],
+    worker_index: usize,
+) -> std::result::Result<(), TransportEvent> {
     let timing_enabled = diagnostics::transaction_timing_enabled();
     let kind = transaction_ingress_kind(&event);
     let queued = QueuedTransactionDispatch {
@@ -766,7 +922,7 @@ async fn dispatch_transaction_event(
     };
 
     match sender.try_send(queued) {
-        Ok(()) => {}
+        Ok(()) => Ok(()),
         Err(mpsc::error::TrySendError::Full(queued)) => {
             let backpressure_started = timing_enabled.then(Instant::now);
             warn!(
@@ -775,18 +931,56 @@ async fn dispatch_transaction_event(
                 lane = ?lane,
                 "Transaction dispatch worker queue full; applying backpressure"
             );
-            if sender.send(queued).await.is_err() {
-                warn!(worker_index, "Transaction dispatch worker channel closed");
-            } else if let Some(started) = backpressure_started {
-                diagnostics::record_transaction_dispatch_backpressure(started.elapsed());
+            match sender.send(queued).await {
+                Ok(()) => {
+                    if let Some(started) = backpressure_started {
+                        diagnostics::record_transaction_dispatch_backpressure(started.elapsed());
+                    }
+                    Ok(())
+                }
+                Err(mpsc::error::SendError(queued)) => {
+                    warn!(worker_index, "Transaction dispatch worker channel closed");
+                    Err(queued.event)
+                }
             }
         }
-        Err(mpsc::error::TrySendError::Closed(_)) => {
+        Err(mpsc::error::TrySendError::Closed(queued)) => {
             warn!(worker_index, "Transaction dispatch worker channel closed");
+            Err(queued.event)
         }
     }
 }
 
+/// The transaction shards' dispatch lanes, attached to the transport so
+/// UDP parse workers queue received messages on the owning shard directly
+/// instead of through the transport event channel and the message loop
+#[derive(Debug)]
+struct TransactionShardSink {
+    senders: Arc<Vec<TransactionDispatchWorkerSender>>,
+    running: Arc<AtomicBool>,
+}
+
+#[async_trait::async_trait]
+impl ShardSink for TransactionShardSink {
+    fn shard_count(&self) -> usize {
+        self.senders.len()
+    }
+
+    async fn deliver(
+        &self,
+        shard: usize,
+        mut event: TransportEvent,
+    ) -> std::result::Result<(), TransportEvent> {
+        // A stopped manager leaves the event to the message loop, which
+        // drops it the same way.
+        if !self.running.load(Ordering::Relaxed) {
+            return Err(event);
+        }
+        mark_transaction_manager_received(&mut event, Instant::now());
+        enqueue_transaction_dispatch(event, &self.senders, shard).await
+    }
+}
+
 async fn process_transaction_dispatch_event(
     manager: &TransactionManager,
     queued: QueuedTransactionDispatch,
@@ -1196,12 +1390,25 @@ impl TransactionManager {
         let (terminated_cleanup_tx, terminated_cleanup_rx) =
             mpsc::channel(index_capacity.max(TERMINATED_CLEANUP_BATCH_MAX));
 
-        let client_transactions = Arc::new(DashMap::with_capacity(index_capacity));
-        let server_transactions = Arc::new(DashMap::with_capacity(index_capacity));
-        let transaction_destinations = Arc::new(DashMap::with_capacity(index_capacity));
+        let transaction_partitions = 1;
+        let client_transactions = Arc::new(TransactionTable::with_capacity(
+            transaction_partitions,
+            index_capacity,
+        ));
+        let server_transactions = Arc::new(TransactionTable::with_capacity(
+            transaction_partitions,
+            index_capacity,
+        ));
+        let transaction_destinations = Arc::new(TransactionTable::with_capacity(
+            transaction_partitions,
+            index_capacity,
+        ));
         let event_subscribers = Arc::new(ArcSwap::from_pointee(Vec::new()));
         let subscriber_to_transactions = Arc::new(DashMap::with_capacity(index_capacity));
-        let transaction_to_subscribers = Arc::new(DashMap::with_capacity(index_capacity));
+        let transaction_to_subscribers = Arc::new(TransactionTable::with_capacity(
+            transaction_partitions,
+            index_capacity,
+        ));
         let next_subscriber_id = Arc::new(AtomicUsize::new(0));
         let transport_rx = Arc::new(Mutex::new(transport_rx));
         let running = Arc::new(AtomicBool::new(false));
@@ -1250,6 +1457,8 @@ impl TransactionManager {
             pending_inbound_timing: Arc::new(dashmap::DashMap::with_capacity(index_capacity)),
             transaction_dispatch_workers: DEFAULT_TRANSACTION_DISPATCH_WORKERS,
             transaction_dispatch_queue_capacity: events_capacity,
+            transaction_execution_mode: TransactionExecutionMode::Shared,
+            transaction_shards: Arc::new(OnceLock::new()),
             transaction_command_channel_capacity: DEFAULT_TRANSACTION_COMMAND_CHANNEL_CAPACITY,
             transaction_dispatch_priority_burst_max: Arc::new(AtomicUsize::new(
                 TRANSACTION_DISPATCH_PRIORITY_BURST_MAX,
@@ -1335,12 +1544,25 @@ impl TransactionManager {
         let (terminated_cleanup_tx, terminated_cleanup_rx) =
             mpsc::channel(index_capacity.max(TERMINATED_CLEANUP_BATCH_MAX));
 
-        let client_transactions = Arc::new(DashMap::with_capacity(index_capacity));
-        let server_transactions = Arc::new(DashMap::with_capacity(index_capacity));
-        let transaction_destinations = Arc::new(DashMap::with_capacity(index_capacity));
+        let transaction_partitions = 1;
+        let client_transactions = Arc::new(TransactionTable::with_capacity(
+            transaction_partitions,
+            index_capacity,
+        ));
+        let server_transactions = Arc::new(TransactionTable::with_capacity(
+            transaction_partitions,
+            index_capacity,
+        ));
+        let transaction_destinations = Arc::new(TransactionTable::with_capacity(
+            transaction_partitions,
+            index_capacity,
+        ));
         let event_subscribers = Arc::new(ArcSwap::from_pointee(Vec::new()));
         let subscriber_to_transactions = Arc::new(DashMap::with_capacity(index_capacity));
-        let transaction_to_subscribers = Arc::new(DashMap::with_capacity(index_capacity));
+        let transaction_to_subscribers = Arc::new(TransactionTable::with_capacity(
+            transaction_partitions,
+            index_capacity,
+        ));
         let next_subscriber_id = Arc::new(AtomicUsize::new(0));
         let transport_rx = Arc::new(Mutex::new(transport_rx));
         let running = Arc::new(AtomicBool::new(false));
@@ -1388,6 +1610,8 @@ impl TransactionManager {
             pending_inbound_timing: Arc::new(dashmap::DashMap::with_capacity(index_capacity)),
             transaction_dispatch_workers: DEFAULT_TRANSACTION_DISPATCH_WORKERS,
             transaction_dispatch_queue_capacity: events_capacity,
+            transaction_execution_mode: TransactionExecutionMode::Shared,
+            transaction_shards: Arc::new(OnceLock::new()),
             transaction_command_channel_capacity: DEFAULT_TRANSACTION_COMMAND_CHANNEL_CAPACITY,
             transaction_dispatch_priority_burst_max: Arc::new(AtomicUsize::new(
                 TRANSACTION_DISPATCH_PRIORITY_BURST_MAX,
@@ -1525,6 +1749,36 @@ impl TransactionManager {
         index_capacity: Option<usize>,
         dispatch_workers: Option<usize>,
         dispatch_queue_capacity: Option<usize>,
+    ) -> Result<(Self, mpsc::Receiver<TransactionEvent>)> {
+        Self::with_transport_manager_and_execution_mode(
+            transport_manager,
+            transport_rx,
+            capacity,
+            index_capacity,
+            dispatch_workers,
+            dispatch_queue_capacity,
+            TransactionExecutionMode::Shared,
+        )
+        .await
+    }
+
+    /// Creates a transaction manager like
+    /// [`Self::with_transport_manager_and_index_capacity_and_dispatch`],
+    /// choosing how receive-side work executes.
+    ///
+    /// With [`TransactionExecutionMode::Sharded`], `dispatch_workers` is the
+    /// number of per-core shards (default: available parallelism). UDP
+    /// parse workers then queue received messages on their shard directly.
+    /// Pair it with `UdpParseDispatch::TransactionShard` and the same number
+    /// of UDP parse workers so each parse worker feeds exactly one shard.
+    pub async fn with_transport_manager_and_execution_mode(
+        transport_manager: crate::transaction::transport::TransportManager,
+        transport_rx: mpsc::Receiver<TransportEvent>,
+        capacity: Option<usize>,
+        index_capacity: Option<usize>,
+        dispatch_workers: Option<usize>,
+        dispatch_queue_capacity: Option<usize>,
+        execution_mode: TransactionExecutionMode,
     ) -> Result<(Self, mpsc::Receiver<TransactionEvent>)> {
         // Wrap the manager's per-flavour registry behind a
         // `MultiplexedTransport` so outbound requests get URI-aware
@@ -1547,18 +1801,38 @@ impl TransactionManager {
         let (events_tx, events_rx) = mpsc::channel(events_capacity);
         let index_capacity = transaction_index_capacity(index_capacity.or(Some(events_capacity)));
         let invite_2xx_cache_capacity = invite_2xx_response_cache_capacity(index_capacity);
-        let transaction_dispatch_workers = transaction_dispatch_worker_count(dispatch_workers);
+        let transaction_dispatch_workers = match execution_mode {
+            TransactionExecutionMode::Shared => transaction_dispatch_worker_count(dispatch_workers),
+            TransactionExecutionMode::Sharded => transaction_shard_count(dispatch_workers),
+        };
         let transaction_dispatch_queue_capacity =
             transaction_dispatch_queue_capacity(dispatch_queue_capacity, events_capacity);
         let (terminated_cleanup_tx, terminated_cleanup_rx) =
             mpsc::channel(index_capacity.max(TERMINATED_CLEANUP_BATCH_MAX));
 
-        let client_transactions = Arc::new(DashMap::with_capacity(index_capacity));
-        let server_transactions = Arc::new(DashMap::with_capacity(index_capacity));
-        let transaction_destinations = Arc::new(DashMap::with_capacity(index_capacity));
+        // One table partition per shard, so shards keep to their own.
+        let transaction_partitions = match execution_mode {
+            TransactionExecutionMode::Shared => 1,
+            TransactionExecutionMode::Sharded => transaction_dispatch_workers,
+        };
+        let client_transactions = Arc::new(TransactionTable::with_capacity(
+            transaction_partitions,
+            index_capacity,
+        ));
+        let server_transactions = Arc::new(TransactionTable::with_capacity(
+            transaction_partitions,
+            index_capacity,
+        ));
+        let transaction_destinations = Arc::new(TransactionTable::with_capacity(
+            transaction_partitions,
+            index_capacity,
+        ));
         let event_subscribers = Arc::new(ArcSwap::from_pointee(Vec::new()));
         let subscriber_to_transactions = Arc::new(DashMap::with_capacity(index_capacity));
-        let transaction_to_subscribers = Arc::new(DashMap::with_capacity(index_capacity));
+        let transaction_to_subscribers = Arc::new(TransactionTable::with_capacity(
+            transaction_partitions,
+            index_capacity,
+        ));
         let next_subscriber_id = Arc::new(AtomicUsize::new(0));
         let transport_rx = Arc::new(Mutex::new(transport_rx));
         let running = Arc::new(AtomicBool::new(false));
@@ -1607,6 +1881,8 @@ impl TransactionManager {
             pending_inbound_timing: Arc::new(dashmap::DashMap::with_capacity(index_capacity)),
             transaction_dispatch_workers,
             transaction_dispatch_queue_capacity,
+            transaction_execution_mode: execution_mode,
+            transaction_shards: Arc::new(OnceLock::new()),
             transaction_command_channel_capacity: DEFAULT_TRANSACTION_COMMAND_CHANNEL_CAPACITY,
             transaction_dispatch_priority_burst_max: Arc::new(AtomicUsize::new(
                 TRANSACTION_DISPATCH_PRIORITY_BURST_MAX,
@@ -1668,12 +1944,25 @@ impl TransactionManager {
         let (events_tx, _) = mpsc::channel(100); // Dummy receiver, will be ignored
         let index_capacity = transaction_index_capacity(None);
         let invite_2xx_cache_capacity = invite_2xx_response_cache_capacity(index_capacity);
-        let client_transactions = Arc::new(DashMap::with_capacity(index_capacity));
-        let server_transactions = Arc::new(DashMap::with_capacity(index_capacity));
-        let transaction_destinations = Arc::new(DashMap::with_capacity(index_capacity));
+        let transaction_partitions = 1;
+        let client_transactions = Arc::new(TransactionTable::with_capacity(
+            transaction_partitions,
+            index_capacity,
+        ));
+        let server_transactions = Arc::new(TransactionTable::with_capacity(
+            transaction_partitions,
+            index_capacity,
+        ));
+        let transaction_destinations = Arc::new(TransactionTable::with_capacity(
+            transaction_partitions,
+            index_capacity,
+        ));
         let event_subscribers = Arc::new(ArcSwap::from_pointee(Vec::new()));
         let subscriber_to_transactions = Arc::new(DashMap::with_capacity(index_capacity));
-        let transaction_to_subscribers = Arc::new(DashMap::with_capacity(index_capacity));
+        let transaction_to_subscribers = Arc::new(TransactionTable::with_capacity(
+            transaction_partitions,
+            index_capacity,
+        ));
         let next_subscriber_id = Arc::new(AtomicUsize::new(0));
         let (_, transport_rx) = mpsc::channel(100); // Dummy channel
         let transport_rx = Arc::new(Mutex::new(transport_rx));
@@ -1722,6 +2011,8 @@ impl TransactionManager {
             pending_inbound_timing: Arc::new(dashmap::DashMap::with_capacity(index_capacity)),
             transaction_dispatch_workers: DEFAULT_TRANSACTION_DISPATCH_WORKERS,
             transaction_dispatch_queue_capacity: 100,
+            transaction_execution_mode: TransactionExecutionMode::Shared,
+            transaction_shards: Arc::new(OnceLock::new()),
             transaction_command_channel_capacity: DEFAULT_TRANSACTION_COMMAND_CHANNEL_CAPACITY,
             transaction_dispatch_priority_burst_max: Arc::new(AtomicUsize::new(
                 TRANSACTION_DISPATCH_PRIORITY_BURST_MAX,
@@ -1755,8 +2046,15 @@ impl TransactionManager {
         // Transaction registries
         let index_capacity = transaction_index_capacity(Some(10));
         let invite_2xx_cache_capacity = invite_2xx_response_cache_capacity(index_capacity);
-        let client_transactions = Arc::new(DashMap::with_capacity(index_capacity));
-        let server_transactions = Arc::new(DashMap::with_capacity(index_capacity));
+        let transaction_partitions = 1;
+        let client_transactions = Arc::new(TransactionTable::with_capacity(
+            transaction_partitions,
+            index_capacity,
+        ));
+        let server_transactions = Arc::new(TransactionTable::with_capacity(
+            transaction_partitions,
+            index_capacity,
+        ));
 
         // Setup timer manager
         let timer_settings = build_timer_settings();
@@ -1767,11 +2065,17 @@ impl TransactionManager {
         let running = Arc::new(AtomicBool::new(false));
 
         // Track destinations
-        let transaction_destinations = Arc::new(DashMap::with_capacity(index_capacity));
+        let transaction_destinations = Arc::new(TransactionTable::with_capacity(
+            transaction_partitions,
+            index_capacity,
+        ));
 
         // Initialize subscriber-related fields
         let subscriber_to_transactions = Arc::new(DashMap::with_capacity(index_capacity));
-        let transaction_to_subscribers = Arc::new(DashMap::with_capacity(index_capacity));
+        let transaction_to_subscribers = Arc::new(TransactionTable::with_capacity(
+            transaction_partitions,
+            index_capacity,
+        ));
         let next_subscriber_id = Arc::new(AtomicUsize::new(0));
 
         Self {
@@ -1810,6 +2114,8 @@ impl TransactionManager {
             pending_inbound_timing: Arc::new(dashmap::DashMap::with_capacity(index_capacity)),
             transaction_dispatch_workers: DEFAULT_TRANSACTION_DISPATCH_WORKERS,
             transaction_dispatch_queue_capacity: 10,
+            transaction_execution_mode: TransactionExecutionMode::Shared,
+            transaction_shards: Arc::new(OnceLock::new()),
             transaction_command_channel_capacity: DEFAULT_TRANSACTION_COMMAND_CHANNEL_CAPACITY,
             transaction_dispatch_priority_burst_max: Arc::new(AtomicUsize::new(
                 TRANSACTION_DISPATCH_PRIORITY_BURST_MAX,
@@ -2743,7 +3049,7 @@ impl TransactionManager {
         primary_tx: &mpsc::Sender<TransactionEvent>,
         subscribers: &Arc<ArcSwap<Vec<EventSubscriber>>>,
         subscriber_to_transactions: Option<&Arc<DashMap<usize, Vec<TransactionKey>>>>,
-        transaction_to_subscribers: Option<&Arc<DashMap<TransactionKey, Vec<usize>>>>,
+        transaction_to_subscribers: Option<&Arc<TransactionTable<Vec<usize>>>>,
         manager: Option<TransactionManager>,
     ) {
         let broadcast_started = diagnostics::transaction_timing_enabled().then(Instant::now);
@@ -2900,7 +3206,7 @@ impl TransactionManager {
     fn prune_event_subscribers(
         subscribers: &Arc<ArcSwap<Vec<EventSubscriber>>>,
         subscriber_to_transactions: Option<&Arc<DashMap<usize, Vec<TransactionKey>>>>,
-        transaction_to_subscribers: Option<&Arc<DashMap<TransactionKey, Vec<usize>>>>,
+        transaction_to_subscribers: Option<&Arc<TransactionTable<Vec<usize>>>>,
         closed_subscriber_ids: &[usize],
     ) {
         let explicit_closed: HashSet<usize> = closed_subscriber_ids.iter().copied().collect();
@@ -2941,7 +3247,7 @@ impl TransactionManager {
     fn remove_subscriber_indexes(
         subscriber_id: usize,
         subscriber_to_transactions: Option<&Arc<DashMap<usize, Vec<TransactionKey>>>>,
-        transaction_to_subscribers: Option<&Arc<DashMap<TransactionKey, Vec<usize>>>>,
+        transaction_to_subscribers: Option<&Arc<TransactionTable<Vec<usize>>>>,
     ) {
         let Some(subscriber_to_transactions) = subscriber_to_transactions else {
             return;
@@ -3044,6 +3350,18 @@ impl TransactionManager {
         let dispatch_workers = self.transaction_dispatch_workers;
         let dispatch_queue_capacity = self.transaction_dispatch_queue_capacity;
         let dispatch_priority_burst_max = self.transaction_dispatch_priority_burst_max.clone();
+        // Shard threads start here rather than in the loop task so
+        // transactions created right after construction already land on
+        // their shard.
+        let shard_senders = match self.transaction_execution_mode {
+            TransactionExecutionMode::Sharded => start_transaction_shards(
+                self,
+                dispatch_workers,
+                dispatch_queue_capacity,
+                dispatch_priority_burst_max.clone(),
+            ),
+            TransactionExecutionMode::Shared => None,
+        };
 
         tokio::spawn(async move {
             debug!("Starting transaction message loop");
@@ -3052,15 +3370,20 @@ impl TransactionManager {
             let (internal_tx, mut internal_rx) = mpsc::channel(100);
             let _internal_tx = internal_tx;
 
-            let dispatch_senders = if dispatch_workers > DEFAULT_TRANSACTION_DISPATCH_WORKERS {
-                Some(start_transaction_dispatch_workers(
-                    manager_arc.clone(),
-                    dispatch_workers,
-                    dispatch_queue_capacity,
-                    dispatch_priority_burst_max,
-                ))
+            let (dispatch_senders, dispatch_route) = if let Some(senders) = shard_senders {
+                (Some(senders), TransactionDispatchRoute::TransactionShard)
+            } else if dispatch_workers > DEFAULT_TRANSACTION_DISPATCH_WORKERS {
+                (
+                    Some(start_transaction_dispatch_workers(
+                        manager_arc.clone(),
+                        dispatch_workers,
+                        dispatch_queue_capacity,
+                        dispatch_priority_burst_max,
+                    )),
+                    TransactionDispatchRoute::DialogKey,
+                )
             } else {
-                None
+                (None, TransactionDispatchRoute::DialogKey)
             };
             let fallback_dispatch_worker = Arc::new(AtomicUsize::new(0));
 
@@ -3099,6 +3422,7 @@ impl TransactionManager {
                                 dispatch_transaction_event(
                                     message_event,
                                     dispatch_senders,
+                                    dispatch_route,
                                     &fallback_dispatch_worker,
                                 ).await;
                             } else if diagnostics::transaction_timing_enabled() {
@@ -3206,6 +3530,64 @@ impl TransactionManager {
         &self,
         request: Request,
         destination: SocketAddr,
+    ) -> Result<TransactionKey> {
+        self.create_client_transaction_inner(request, None, destination)
+            .await
+    }
+
+    /// Create a client transaction for a request that was derived from a
+    /// [`PreparedMessage`], such as one leg of a proxy fork.
+    ///
+    /// Behaves like [`Self::create_client_transaction`], but the request
+    /// is sent from the prepared fragments: only the top Via, which the
+    /// transaction layer normalizes, is serialized again.
+    pub async fn create_client_transaction_prepared(
+        &self,
+        prepared: PreparedMessage,
+        destination: SocketAddr,
+    ) -> Result<TransactionKey> {
+        let Message::Request(request) = prepared.message().clone() else {
+            return Err(Error::Other(
+                "create_client_transaction_prepared needs a request".to_string(),
+            ));
+        };
+        self.create_client_transaction_inner(request, Some(prepared), destination)
+            .await
+    }
+
+    async fn create_client_transaction_inner(
+        &self,
+        request: Request,
+        prepared: Option<PreparedMessage>,
+        destination: SocketAddr,
+    ) -> Result<TransactionKey> {
+        // The branch is the transaction key and picks the owning shard, so
+        // it is settled before the transaction is built there.
+        let branch = client_transaction_branch(&request);
+        let Some(shards) = self.transaction_shards.get() else {
+            return self
+                .create_client_transaction_local(request, prepared, destination, branch)
+                .await;
+        };
+        let shard = shards.shard_for_branch(&branch);
+        let manager = self.clone();
+        shards
+            .run_on(shard, async move {
+                manager
+                    .create_client_transaction_local(request, prepared, destination, branch)
+                    .await
+            })
+            .await
+    }
+
+    /// Build and register a client transaction keyed by `branch` on the
+    /// current runtime, which is where its runner task is spawned
+    async fn create_client_transaction_local(
+        &self,
+        request: Request,
+        prepared: Option<PreparedMessage>,
+        destination: SocketAddr,
+        branch: String,
     ) -> Result<TransactionKey> {
         debug!(method=%request.method(), destination=%destination, "Creating client transaction");
 
@@ -3215,32 +3597,6 @@ impl TransactionManager {
             tracing::trace!("  Via[{}]: {}", i, via);
         }
 
-        // Extract branch parameter from the top Via header or generate a new one
-        let branch = match request.first_via() {
-            Some(via) => {
-                match via.branch() {
-                    Some(b) => b.to_string(),
-                    None => {
-                        // Generate a branch parameter if none exists
-                        format!(
-                            "{}{}",
-                            RFC3261_BRANCH_MAGIC_COOKIE,
-                            uuid::Uuid::new_v4().as_simple()
-                        )
-                    }
-                }
-            }
-            None => {
-                // No Via header - should not happen, but we'll handle it by generating a branch
-                // and a Via header will be added by the transaction
-                format!(
-                    "{}{}",
-                    RFC3261_BRANCH_MAGIC_COOKIE,
-                    uuid::Uuid::new_v4().as_simple()
-                )
-            }
-        };
-
         // We'll create the transaction key directly
         let key = TransactionKey::new(branch.clone(), request.method().clone(), false);
 
@@ -3294,6 +3650,25 @@ impl TransactionManager {
 
         rvoip_sip_core::validation::validate_wire_request(&modified_request)?;
 
+        // Reuse the caller's fragments when the normalized request differs
+        // from the prepared one only in its top Via.
+        let prepared_wire = prepared.and_then(|prepared| {
+            let prepared = match modified_request
+                .headers
+                .iter()
+                .find(|h| matches!(h, TypedHeader::Via(_)))
+            {
+                Some(via) => prepared.with_header_replaced(via.clone()),
+                None => prepared,
+            };
+            match prepared.message() {
+                Message::Request(prepared_request) if *prepared_request == modified_request => {
+                    Some(prepared.to_wire())
+                }
+                _ => None,
+            }
+        });
+
         // Create the appropriate transaction. Returns Arc<dyn ClientTransaction>
         // so the map can shard (DashMap) and call sites can clone the
         // Arc out before any `.await`.
@@ -3310,6 +3685,7 @@ impl TransactionManager {
                     self.transaction_command_channel_capacity,
                 )?;
                 tracing::trace!("Created ClientInviteTransaction: {}", key);
+                seed_request_wire(&tx, prepared_wire.as_ref());
                 Arc::new(tx)
             }
             Method::Cancel => {
@@ -3325,6 +3701,7 @@ impl TransactionManager {
                     self.timer_settings_for_request(&modified_request),
                     self.transaction_command_channel_capacity,
                 )?;
+                seed_request_wire(&tx, prepared_wire.as_ref());
                 Arc::new(tx)
             }
             Method::Update => {
@@ -3340,6 +3717,7 @@ impl TransactionManager {
                     self.timer_settings_for_request(&modified_request),
                     self.transaction_command_channel_capacity,
                 )?;
+                seed_request_wire(&tx, prepared_wire.as_ref());
                 Arc::new(tx)
             }
             _ => {
@@ -3352,6 +3730,7 @@ impl TransactionManager {
                     self.timer_settings_for_request(&modified_request),
                     self.transaction_command_channel_capacity,
                 )?;
+                seed_request_wire(&tx, prepared_wire.as_ref());
                 Arc::new(tx)
             }
         };
@@ -3583,6 +3962,33 @@ impl TransactionManager {
         &self,
         request: Request,
         remote_addr: SocketAddr,
+    ) -> Result<Arc<dyn ServerTransaction>> {
+        // A request without a branch has no owning shard; building it here
+        // reports the error.
+        let Some((shards, shard)) = self.transaction_shards.get().and_then(|shards| {
+            let shard = shards.shard_for_request(&request)?;
+            Some((shards, shard))
+        }) else {
+            return self
+                .create_server_transaction_local(request, remote_addr)
+                .await;
+        };
+        let manager = self.clone();
+        shards
+            .run_on(shard, async move {
+                manager
+                    .create_server_transaction_local(request, remote_addr)
+                    .await
+            })
+            .await
+    }
+
+    /// Build and register a server transaction on the current runtime, which
+    /// is where its runner task is spawned
+    async fn create_server_transaction_local(
+        &self,
+        request: Request,
+        remote_addr: SocketAddr,
     ) -> Result<Arc<dyn ServerTransaction>> {
         // Extract branch parameter from the top Via header
         let branch = match request.first_via() {
@@ -0,0 +1,227 @@
+//! Sharded, run-to-completion transaction execution
+//!
+//! In [`TransactionExecutionMode::Sharded`] the manager runs one shard per
+//! dispatch worker. A shard is an OS thread driving a single-threaded Tokio
+//! runtime, pinned to one of the cores the process may run on where the
+//! platform allows it. Each transaction is owned by the shard its top-Via
+//! branch hashes to — the branch is the transaction key, so the owner is
+//! known for received messages, for requests the TU sends and for bare
+//! [`TransactionKey`]s alike. Transport events are routed to the owning
+//! shard, and everything a shard spawns while handling them — transaction
+//! runners, their termination grace tasks, wheel timer overflow sends —
+//! stays on that thread. Transactions the TU creates are built on their
+//! shard as well, and the manager's transaction tables keep one partition
+//! per shard ([`TransactionTable`](super::table::TransactionTable)), so a
+//! shard working on its own transactions neither migrates them between
+//! cores nor touches another shard's state.
+//!
+//! The branch hash is the one in [`rvoip_sip_transport::transport::shard`].
+//! The UDP transport uses it for `UdpParseDispatch::TransactionShard` and
+//! hands parsed messages straight to the owning shard's queue through a
+//! [`ShardSink`](rvoip_sip_transport::transport::shard::ShardSink): with as
+//! many parse workers as shards, parse worker `k` only feeds shard `k`.
+
+use std::cell::Cell;
+use std::future::Future;
+use std::io;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::time::Duration;
+
+use tokio::runtime::Handle;
+use tracing::{debug, warn};
+
+use rvoip_infra_common::affinity::{allowed_cores, pin_current_thread};
+use rvoip_sip_core::Request;
+use rvoip_sip_transport::transport::shard::{branch_shard_hash, shard_index};
+
+use crate::transaction::error::{Error, Result};
+use crate::transaction::TransactionKey;
+
+/// How long a shard keeps running its remaining tasks after its ingress
+/// queue closes, so transactions told to terminate during shutdown can
+/// reach `Destroyed` (runner grace period is 600 ms)
+const SHARD_DRAIN_GRACE: Duration = Duration::from_secs(2);
+
+/// How the transaction manager executes receive-side work
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+pub enum TransactionExecutionMode {
+    /// Events are handled on the caller's Tokio runtime, by the message
+    /// loop or by keyed dispatch workers when more than one is configured
+    #[default]
+    Shared,
+    /// Events and transactions are owned by per-core shards keyed by the
+    /// top-Via branch. The dispatch worker count is the shard count; it
+    /// defaults to the available parallelism.
+    Sharded,
+}
+
+static NEXT_SHARD_SET_ID: AtomicUsize = AtomicUsize::new(0);
+
+thread_local! {
+    /// `(shard set, shard)` owning the current thread, if any
+    static CURRENT_SHARD: Cell<Option<(usize, usize)>> = const { Cell::new(None) };
+}
+
+/// Runtime handles of one manager's shards
+#[derive(Debug)]
+pub(super) struct TransactionShards {
+    set_id: usize,
+    handles: Vec<Handle>,
+}
+
+impl TransactionShards {
+    /// Start one shard thread per entry of `workers`. Each closure is
+    /// called on its shard thread to build the future that drains that
+    /// shard's ingress queue; the shard stops once the future completes and
+    /// the drain grace expires.
+    pub(super) fn start<F, Fut>(workers: Vec<F>) -> io::Result<Self>
+    where
+        F: FnOnce() -> Fut + Send + 'static,
+        Fut: Future<Output = ()> + 'static,
+    {
+        let set_id = NEXT_SHARD_SET_ID.fetch_add(1, Ordering::Relaxed);
+        // Shards take cores from the bottom of the affinity mask; the
+        // media worker pool takes them from the top.
+        let cores = allowed_cores();
+        let mut handles = Vec::with_capacity(workers.len());
+
+        for (shard, make_worker) in workers.into_iter().enumerate() {
+            let (handle_tx, handle_rx) = std::sync::mpsc::sync_channel(1);
+            let core = (!cores.is_empty()).then(|| cores[shard % cores.len()]);
+            std::thread::Builder::new()
+                .name(format!("sip-tx-shard-{shard}"))
+                .spawn(move || {
+                    if let Some(core) = core {
+                        if let Err(e) = pin_current_thread(core) {
+                            warn!(
+                                shard,
+                                core,
+                                error = %e,
+                                "Could not pin transaction shard to core"
+                            );
+                        }
+                    }
+                    let runtime = match tokio::runtime::Builder::new_current_thread()
+                        .enable_all()
+                        .build()
+                    {
+                        Ok(runtime) => runtime,
+                        Err(e) => {
+                            let _ = handle_tx.send(Err(e));
+                            return;
+                        }
+                    };
+                    CURRENT_SHARD.with(|current| current.set(Some((set_id, shard))));
+                    let _ = handle_tx.send(Ok(runtime.handle().clone()));
+
+                    runtime.block_on(async move {
+                        make_worker().await;
+                        tokio::time::sleep(SHARD_DRAIN_GRACE).await;
+                    });
+                    debug!(shard, "Transaction shard stopped");
+                })?;
+            let handle = handle_rx
+                .recv()
+                .map_err(|_| io::Error::other("transaction shard thread exited"))??;
+            handles.push(handle);
+        }
+
+        Ok(Self { set_id, handles })
+    }
+
+    pub(super) fn len(&self) -> usize {
+        self.handles.len()
+    }
+
+    /// Shard owning the transactions of top-Via `branch`
+    pub(super) fn shard_for_branch(&self, branch: &str) -> usize {
+        shard_index(branch_shard_hash(branch.as_bytes()), self.len())
+    }
+
+    /// Shard owning the transaction `request` belongs to, or `None` if its
+    /// top Via has no branch
+    pub(super) fn shard_for_request(&self, request: &Request) -> Option<usize> {
+        let via = request.first_via()?;
+        via.branch().map(|branch| self.shard_for_branch(branch))
+    }
+
+    /// Run `work` on `shard`: inline when already on that shard's thread,
+    /// otherwise as a task on its runtime
+    pub(super) async fn run_on<T, Fut>(&self, shard: usize, work: Fut) -> Result<T>
+    where
+        Fut: Future<Output = Result<T>> + Send + 'static,
+        T: Send + 'static,
+    {
+        if CURRENT_SHARD.with(Cell::get) == Some((self.set_id, shard)) {
+            return work.await;
+        }
+        self.handles[shard]
+            .spawn(work)
+            .await
+            .map_err(|e| Error::Other(format!("Transaction shard {shard} stopped: {e}")))?
+    }
+}
+
+/// Shard of `shards` owning the transaction `key`
+pub(super) fn key_shard(key: &TransactionKey, shards: usize) -> usize {
+    shard_index(branch_shard_hash(key.branch.as_bytes()), shards)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn stop_on(
+        stop_rx: &tokio::sync::watch::Receiver<bool>,
+    ) -> impl FnOnce() -> std::pin::Pin<Box<dyn Future<Output = ()>>> + Send + 'static {
+        let mut stop_rx = stop_rx.clone();
+        move || {
+            Box::pin(async move {
+                let _ = stop_rx.wait_for(|stop| *stop).await;
+            })
+        }
+    }
+
+    #[tokio::test]
+    async fn test_run_on_executes_on_shard_thread() {
+        let (stop_tx, stop_rx) = tokio::sync::watch::channel(false);
+        let shards = TransactionShards::start(vec![stop_on(&stop_rx), stop_on(&stop_rx)])
+            .expect("start shards");
+
+        for shard in 0..2 {
+            let name = shards
+                .run_on(shard, async {
+                    Ok(std::thread::current().name().map(str::to_string))
+                })
+                .await
+                .expect("run on shard");
+            assert_eq!(
+                name.as_deref(),
+                Some(format!("sip-tx-shard-{shard}").as_str())
+            );
+        }
+        stop_tx.send(true).expect("stop shards");
+    }
+
+    #[tokio::test]
+    async fn test_nested_run_on_same_shard_is_inline() {
+        let (stop_tx, stop_rx) = tokio::sync::watch::channel(false);
+        let shards = std::sync::Arc::new(
+            TransactionShards::start(vec![stop_on(&stop_rx)]).expect("start shards"),
+        );
+
+        let inner = shards.clone();
+        let thread = shards
+            .run_on(0, async move {
+                let outer = std::thread::current().id();
+                let nested = inner
+                    .run_on(0, async { Ok(std::thread::current().id()) })
+                    .await?;
+                Ok(outer == nested)
+            })
+            .await
+            .expect("nested run");
+        assert!(thread);
+        stop_tx.send(true).expect("stop shards");
+    }
+}
@@ -0,0 +1,118 @@
+//! Transaction-keyed maps partitioned by shard
+//!
+//! In [`TransactionExecutionMode::Sharded`](super::TransactionExecutionMode)
+//! every transaction belongs to the shard its top-Via branch hashes to (see
+//! [`shards`](super::shards)). A [`TransactionTable`] keeps one map per
+//! shard, partitioned with the same function, so a shard handling its own
+//! transactions only ever touches its own partition: shards never contend
+//! on a lock, and one shard's inserts never resize another's table. Lookups
+//! from outside a shard (TU calls, cleanup sweeps) still work from any
+//! thread, since each partition remains a concurrent map.
+//!
+//! In shared mode the table has a single partition and behaves like a plain
+//! `DashMap`.
+
+use dashmap::mapref::entry::Entry;
+use dashmap::mapref::multiple::RefMulti;
+use dashmap::mapref::one::{Ref, RefMut};
+use dashmap::DashMap;
+
+use super::shards::key_shard;
+use crate::transaction::TransactionKey;
+
+/// Map from [`TransactionKey`] to `V`, split into one partition per shard
+#[derive(Debug)]
+pub(crate) struct TransactionTable<V> {
+    partitions: Box<[DashMap<TransactionKey, V>]>,
+}
+
+impl<V> TransactionTable<V> {
+    /// Create a table with `partitions` partitions (at least one) sharing
+    /// `capacity` between them
+    pub(crate) fn with_capacity(partitions: usize, capacity: usize) -> Self {
+        let partitions = partitions.max(1);
+        let per_partition = capacity.div_ceil(partitions);
+        Self {
+            partitions: (0..partitions)
+                .map(|_| DashMap::with_capacity(per_partition))
+                .collect(),
+        }
+    }
+
+    /// Partition owning `key`
+    fn partition(&self, key: &TransactionKey) -> &DashMap<TransactionKey, V> {
+        &self.partitions[key_shard(key, self.partitions.len())]
+    }
+
+    pub(crate) fn get(&self, key: &TransactionKey) -> Option<Ref<'_, TransactionKey, V>> {
+        self.partition(key).get(key)
+    }
+
+    pub(crate) fn get_mut(&self, key: &TransactionKey) -> Option<RefMut<'_, TransactionKey, V>> {
+        self.partition(key).get_mut(key)
+    }
+
+    pub(crate) fn contains_key(&self, key: &TransactionKey) -> bool {
+        self.partition(key).contains_key(key)
+    }
+
+    pub(crate) fn insert(&self, key: TransactionKey, value: V) -> Option<V> {
+        self.partition(&key).insert(key, value)
+    }
+
+    pub(crate) fn entry(&self, key: TransactionKey) -> Entry<'_, TransactionKey, V> {
+        self.partition(&key).entry(key)
+    }
+
+    pub(crate) fn remove(&self, key: &TransactionKey) -> Option<(TransactionKey, V)> {
+        self.partition(key).remove(key)
+    }
+
+    /// Entries of every partition, one partition after another
+    pub(crate) fn iter(&self) -> impl Iterator<Item = RefMulti<'_, TransactionKey, V>> {
+        self.partitions.iter().flat_map(|partition| partition.iter())
+    }
+
+    pub(crate) fn len(&self) -> usize {
+        self.partitions.iter().map(|partition| partition.len()).sum()
+    }
+
+    pub(crate) fn clear(&self) {
+        for partition in self.partitions.iter() {
+            partition.clear();
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use rvoip_sip_core::Method;
+
+    fn key(branch: &str) -> TransactionKey {
+        TransactionKey::new(branch.to_string(), Method::Invite, true)
+    }
+
+    #[test]
+    fn test_keys_land_in_their_shard_partition() {
+        let table = TransactionTable::with_capacity(4, 16);
+        for i in 0..32 {
+            table.insert(key(&format!("z9hG4bK{i}")), i);
+        }
+
+        assert_eq!(table.len(), 32);
+        for (shard, partition) in table.partitions.iter().enumerate() {
+            for entry in partition.iter() {
+                assert_eq!(key_shard(entry.key(), 4), shard);
+            }
+        }
+        assert_eq!(table.get(&key("z9hG4bK7")).map(|v| *v), Some(7));
+
+        assert!(table.remove(&key("z9hG4bK7")).is_some());
+        assert!(!table.contains_key(&key("z9hG4bK7")));
+        assert_eq!(table.iter().count(), 31);
+
+        table.clear();
+        assert_eq!(table.len(), 0);
+    }
+}
@@ -1143,10 +1143,10 @@ mod tests {
             None,
         )?;
 
-        // DashMap matches the new ArcClientTransaction-keyed
-        // TransactionManager storage.
-        let transactions: dashmap::DashMap<TransactionKey, std::sync::Arc<dyn ClientTransaction>> =
-            dashmap::DashMap::new();
+        // Same table type as the manager's client transaction storage.
+        let transactions: super::super::table::TransactionTable<
+            std::sync::Arc<dyn ClientTransaction>,
+        > = super::super::table::TransactionTable::with_capacity(1, 1);
         let tx_id = transaction.id().clone();
         transactions.insert(tx_id.clone(), std::sync::Arc::new(transaction));
 
@@ -267,14 +267,13 @@ pub async fn determine_ack_destination(response: &Response) -> Option<SocketAddr
 /// - Validating incoming requests against stored requests
 ///
 /// # Arguments
-/// * `transactions` - Mutex-wrapped map of transactions
+/// * `transactions` - Table of client transactions
 /// * `tx_id` - Transaction ID to look up
 ///
 /// # Returns
 /// * `Result<Request>` - The original request or an error
-pub async fn get_transaction_request(
-    transactions: &dashmap::DashMap<
-        TransactionKey,
+pub(crate) async fn get_transaction_request(
+    transactions: &super::table::TransactionTable<
         crate::transaction::manager::ArcClientTransaction,
     >,
     tx_id: &TransactionKey,
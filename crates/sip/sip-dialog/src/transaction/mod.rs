@@ -124,7 +124,7 @@ pub use state::*;
 pub const DEFAULT_TRANSACTION_COMMAND_CHANNEL_CAPACITY: usize = 32;
 
 // Re-export manager
-pub use manager::{TransactionManager, MAX_TRANSACTION_DISPATCH_WORKERS};
+pub use manager::{TransactionExecutionMode, TransactionManager, MAX_TRANSACTION_DISPATCH_WORKERS};
 
 /// Defines the core traits, types, and machinery for SIP transactions.
 ///
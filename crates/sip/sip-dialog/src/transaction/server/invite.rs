@@ -82,7 +82,9 @@ use crate::transaction::runner::run_transaction_loop;
 use crate::transaction::server::{
     CommonServerTransaction, ServerTransaction, ServerTransactionData,
 };
-use crate::transaction::timer::{TimerFactory, TimerManager, TimerSettings, TimerType};
+use crate::transaction::timer::{
+    TimerFactory, TimerHandle, TimerManager, TimerSettings, TimerType,
+};
 use crate::transaction::timer_utils;
 use crate::transaction::utils;
 use crate::transaction::{
@@ -115,7 +117,7 @@ pub struct ServerInviteTransaction {
     logic: Arc<ServerInviteLogic>,
 }
 
-/// Holds JoinHandles and dynamic state for timers specific to Server INVITE transactions.
+/// Holds timer handles and dynamic state for timers specific to Server INVITE transactions.
 ///
 /// Used by the transaction runner to manage the various timers required by the
 /// INVITE server transaction state machine as defined in RFC 3261.
@@ -125,16 +127,16 @@ struct ServerInviteTimerHandles {
     timer_100: Option<JoinHandle<()>>,
 
     /// Handle for Timer G, which controls response retransmissions
-    timer_g: Option<JoinHandle<()>>,
+    timer_g: Option<TimerHandle>,
 
     /// Current interval for Timer G, which doubles after each firing (up to T2)
     current_timer_g_interval: Option<Duration>, // For backoff
 
     /// Handle for Timer H, which controls transaction timeout waiting for ACK
-    timer_h: Option<JoinHandle<()>>,
+    timer_h: Option<TimerHandle>,
 
     /// Handle for Timer I, which controls how long to wait in Confirmed state
-    timer_i: Option<JoinHandle<()>>,
+    timer_i: Option<TimerHandle>,
 }
 
 /// Implements the TransactionLogic for Server INVITE transactions.
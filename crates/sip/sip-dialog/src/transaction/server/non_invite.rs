@@ -3,7 +3,6 @@ use std::net::SocketAddr;
 use std::pin::Pin;
 use std::sync::Arc;
 use tokio::sync::{mpsc, Mutex};
-use tokio::task::JoinHandle;
 use tracing::{debug, error, trace, warn};
 
 use rvoip_sip_core::prelude::*;
@@ -16,7 +15,9 @@ use crate::transaction::runner::run_transaction_loop;
 use crate::transaction::server::{
     CommonServerTransaction, ServerTransaction, ServerTransactionData,
 };
-use crate::transaction::timer::{TimerFactory, TimerManager, TimerSettings, TimerType};
+use crate::transaction::timer::{
+    TimerFactory, TimerHandle, TimerManager, TimerSettings, TimerType,
+};
 use crate::transaction::timer_utils;
 use crate::transaction::utils;
 use crate::transaction::{
@@ -35,10 +36,10 @@ pub struct ServerNonInviteTransaction {
     logic: Arc<ServerNonInviteLogic>,
 }
 
-/// Holds JoinHandles and dynamic state for timers specific to Server Non-INVITE transactions.
+/// Holds timer handles and dynamic state for timers specific to Server Non-INVITE transactions.
 #[derive(Default, Debug)]
 struct ServerNonInviteTimerHandles {
-    timer_j: Option<JoinHandle<()>>,
+    timer_j: Option<TimerHandle>,
 }
 
 /// Implements the TransactionLogic for Server Non-INVITE transactions.
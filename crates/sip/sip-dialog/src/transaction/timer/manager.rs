@@ -2,7 +2,7 @@
 //!
 //! The [`TimerManager`] is responsible for:
 //! - Registering and unregistering transactions that require timer services.
-//! - Starting one-shot timer tasks that, upon expiration, send an [`InternalTransactionCommand::Timer`]
+//! - Arming one-shot timers that, upon expiration, send an [`InternalTransactionCommand::Timer`]
 //!   event to the associated transaction.
 //! - Holding timer settings applicable to its operations.
 //!
@@ -18,7 +18,9 @@
 //! # Implementation Details
 //!
 //! This `TimerManager` provides a mechanism for scheduling a single notification after a
-//! specified duration. For timers that require periodic firing or complex backoff strategies
+//! specified duration. Timers are not tasks: they are entries in a process-wide hierarchical
+//! timing wheel (see [`wheel`](super::wheel)) with O(1) arm and cancel, driven by a single
+//! thread that delivers expired timers in batches. For timers that require periodic firing or complex backoff strategies
 //! (like RFC 3261 Timer A or E), the transaction itself, upon receiving a timer event,
 //! is responsible for performing its action (e.g., retransmission) and then requesting the
 //! `TimerManager` to start a new timer with the next appropriate duration.
@@ -71,19 +73,26 @@
 //! ```
 
 use std::collections::HashMap;
-use std::sync::Arc;
+use std::sync::{Arc, RwLock};
 use std::time::Duration;
 
-use crate::transaction::{InternalTransactionCommand, TransactionKey};
+use crate::transaction::{InternalTransactionCommand, TransactionKey, TransactionState};
+use tokio::runtime::Handle;
 use tokio::sync::mpsc;
-use tokio::sync::Mutex;
-use tokio::task::JoinHandle;
-use tokio::time::sleep;
 use tracing::{debug, trace};
 // Ensure TimerSettings is correctly imported if it was moved to super::types
 use super::types::{TimerSettings, TimerType};
+use super::wheel::{TimerEntry, TimerHandle, TimerScheduler, TimerTarget};
 // Timer struct from types.rs is not directly used by TimerManager methods but is related contextually.
 
+/// Command channels of the transactions registered with a [`TimerManager`].
+///
+/// A plain `RwLock`: it is never held across an `.await`, is only written on
+/// register/unregister, and is read once per fired timer. Arming and
+/// cancelling timers does not touch it.
+pub(crate) type TransactionChannels =
+    Arc<RwLock<HashMap<TransactionKey, mpsc::Sender<InternalTransactionCommand>>>>;
+
 /// Manages active timers for SIP transactions.
 ///
 /// The `TimerManager` is a central component of the SIP transaction layer that handles:
@@ -94,7 +103,8 @@ use super::types::{TimerSettings, TimerType};
 ///
 /// When a timer fires, the `TimerManager` sends an `InternalTransactionCommand::Timer` message
 /// to the `mpsc::Sender<InternalTransactionCommand>` that was registered for that transaction.
-/// It does not directly manage `Timer` struct instances but rather the spawned tasks for each active timer.
+/// It does not directly manage `Timer` struct instances; each active timer is an entry in the
+/// shared timing wheel, referenced by the [`TimerHandle`] returned from `start_timer`.
 ///
 /// # RFC 3261 Compliance
 ///
@@ -109,8 +119,7 @@ use super::types::{TimerSettings, TimerType};
 pub struct TimerManager {
     /// Stores sender channels for `InternalTransactionCommand`s, keyed by `TransactionKey`.
     /// Used to notify a specific transaction when one of its timers fires.
-    transaction_channels:
-        Arc<Mutex<HashMap<TransactionKey, mpsc::Sender<InternalTransactionCommand>>>>,
+    transaction_channels: TransactionChannels,
     /// Configuration settings for timers, such as default durations (T1, T2 etc.).
     /// While `TimerManager` itself mostly deals with given durations, these settings might inform
     /// those durations if not provided directly to `start_timer` or by a `TimerFactory`.
@@ -125,7 +134,7 @@ impl TimerManager {
     ///   The default settings follow RFC 3261 recommendations (T1=500ms, etc.).
     pub fn new(settings: Option<TimerSettings>) -> Self {
         Self {
-            transaction_channels: Arc::new(Mutex::new(HashMap::new())),
+            transaction_channels: Arc::new(RwLock::new(HashMap::new())),
             settings: settings.unwrap_or_default(),
         }
     }
@@ -153,7 +162,10 @@ impl TimerManager {
         transaction_id: TransactionKey,
         command_tx: mpsc::Sender<InternalTransactionCommand>,
     ) {
-        let mut channels = self.transaction_channels.lock().await;
+        let mut channels = self
+            .transaction_channels
+            .write()
+            .unwrap_or_else(|e| e.into_inner());
         if channels
             .insert(transaction_id.clone(), command_tx)
             .is_some()
@@ -165,8 +177,8 @@ impl TimerManager {
 
     /// Unregisters a transaction from the `TimerManager`.
     ///
-    /// After unregistering, the transaction will no longer receive timer events. Active timer tasks
-    /// for this transaction might still complete their sleep, but they will not be able to send an event.
+    /// After unregistering, the transaction will no longer receive timer events. Timers still armed
+    /// for this transaction will expire as scheduled, but they will not be able to send an event.
     /// Typically called when a transaction terminates.
     ///
     /// # Arguments
@@ -182,7 +194,10 @@ impl TimerManager {
     /// This method should be called when a transaction reaches its terminated state
     /// to prevent memory leaks and ensure proper cleanup.
     pub async fn unregister_transaction(&self, transaction_id: &TransactionKey) {
-        let mut channels = self.transaction_channels.lock().await;
+        let mut channels = self
+            .transaction_channels
+            .write()
+            .unwrap_or_else(|e| e.into_inner());
         if channels.remove(transaction_id).is_some() {
             trace!(id=%transaction_id, "Transaction unregistered from TimerManager.");
         } else {
@@ -192,26 +207,22 @@ impl TimerManager {
 
     /// Starts a one-shot timer for a specific transaction.
     ///
-    /// A new asynchronous task is spawned that will sleep for the given `duration`.
-    /// Upon waking, it sends an [`InternalTransactionCommand::Timer`] containing the `timer_type`
-    /// (as a string) to the registered channel for the `transaction_id`.
+    /// The timer is armed in the shared timing wheel; no task is spawned. Once `duration`
+    /// has elapsed, an [`InternalTransactionCommand::Timer`] containing the `timer_type`
+    /// (as a string) is sent to the channel registered for `transaction_id`.
     ///
     /// If the transaction is unregistered before the timer fires, or if its command channel
-    /// is closed, the event delivery will fail silently or log an error, respectively.
+    /// is closed, the event is dropped and logged at trace/debug level.
     ///
     /// # Arguments
     /// * `transaction_id` - The [`TransactionKey`] of the transaction this timer belongs to.
     /// * `timer_type` - The [`TimerType`] of this timer, used for generating the event payload.
-    /// * `duration` - The [`Duration`] for which the timer should sleep before firing.
+    /// * `duration` - The [`Duration`] after which the timer fires.
     ///
     /// # Returns
-    /// `Ok(JoinHandle<()>)` for the spawned timer task. The caller can use this handle
-    /// to await the timer task's completion or to abort it (though aborting is not
-    /// explicitly managed by `TimerManager` beyond providing the handle).
-    /// Returns `crate::error::Error` if the underlying transaction channel is not found *immediately*
-    /// (though the current implementation spawns and checks later).
-    /// The primary error source would be if `transaction_channels.lock()` fails, which is unlikely.
-    /// The current implementation always returns Ok, as the check happens in spawned task.
+    /// `Ok(TimerHandle)` for the armed timer; [`TimerHandle::abort`] cancels it in O(1).
+    /// The current implementation always returns `Ok`, as the registration is checked
+    /// when the timer fires.
     ///
     /// # RFC 3261 Timer Types
     ///
@@ -226,50 +237,42 @@ impl TimerManager {
         transaction_id: TransactionKey,
         timer_type: TimerType,
         duration: Duration,
-    ) -> Result<JoinHandle<()>, crate::transaction::error::Error> {
-        // Consider if crate::error::Error is appropriate here.
-        let transaction_channels_clone = self.transaction_channels.clone();
-
-        // Check if transaction channel exists *before* spawning to provide immediate feedback if possible.
-        // However, this adds a lock acquisition before spawning. For high-frequency timers, this might be a concern.
-        // The current design does the check *after* sleep, which is fine for eventual consistency.
-        // If we want to return an error if the channel is not *currently* registered, we'd do:
-        // { // Scope for the lock
-        //     let channels_guard = transaction_channels_clone.lock().await;
-        //     if !channels_guard.contains_key(&transaction_id) {
-        //         warn!(id = %transaction_id, timer = %timer_type, "Cannot start timer, transaction not registered.");
-        //         // How to return an error that fits crate::error::Error type?
-        //         // For now, let's stick to the original behavior of spawning and checking later.
-        //     }
-        // }
-
-        let handle = tokio::spawn(async move {
-            trace!(id=%transaction_id, timer=%timer_type, duration=?duration, "Timer task started.");
-
-            sleep(duration).await;
-
-            let channels_guard = transaction_channels_clone.lock().await;
-            if let Some(cmd_tx) = channels_guard.get(&transaction_id) {
-                let timer_event_payload = timer_type.to_string();
-                trace!(id=%transaction_id, timer=%timer_type, "Timer fired. Attempting to send event.");
-                if let Err(e) = cmd_tx
-                    .send(InternalTransactionCommand::Timer(
-                        timer_event_payload.clone(),
-                    ))
-                    .await
-                {
-                    // This error typically means the receiver (transaction) has been dropped/terminated.
-                    debug!(id=%transaction_id, timer=%timer_event_payload, error=%e, "Failed to send timer event (receiver dropped).");
-                } else {
-                    debug!(id=%transaction_id, timer=%timer_event_payload, "Timer event sent successfully.");
-                }
-            } else {
-                // Transaction was unregistered before timer fired.
-                trace!(id=%transaction_id, timer=%timer_type, "Timer fired, but transaction no longer registered.");
-            }
-        });
+    ) -> Result<TimerHandle, crate::transaction::error::Error> {
+        trace!(id=%transaction_id, timer=%timer_type, duration=?duration, "Timer armed.");
+        let entry = TimerEntry {
+            transaction_id,
+            timer_type,
+            target: TimerTarget::Registered(self.transaction_channels.clone()),
+            runtime: Handle::try_current().ok(),
+        };
+        Ok(TimerScheduler::global().schedule(duration, entry))
+    }
 
-        Ok(handle) // tokio::spawn itself doesn't typically return a Result in this form.
+    /// Starts a one-shot timer that also moves the transaction to `target_state`.
+    ///
+    /// When the timer fires, an [`InternalTransactionCommand::Timer`] followed by an
+    /// [`InternalTransactionCommand::TransitionTo`] is sent straight to `command_tx`,
+    /// whether or not the transaction is still registered. Used for the wait timers
+    /// (D, I, J, K) that end a transaction.
+    pub async fn start_timer_with_transition(
+        &self,
+        transaction_id: TransactionKey,
+        timer_type: TimerType,
+        duration: Duration,
+        command_tx: mpsc::Sender<InternalTransactionCommand>,
+        target_state: TransactionState,
+    ) -> Result<TimerHandle, crate::transaction::error::Error> {
+        trace!(id=%transaction_id, timer=%timer_type, duration=?duration, target_state=?target_state, "Timer with transition armed.");
+        let entry = TimerEntry {
+            transaction_id,
+            timer_type,
+            target: TimerTarget::Transition {
+                cmd_tx: command_tx,
+                state: target_state,
+            },
+            runtime: Handle::try_current().ok(),
+        };
+        Ok(TimerScheduler::global().schedule(duration, entry))
     }
 
     /// Returns a reference to the [`TimerSettings`] used by this manager.
@@ -299,6 +302,18 @@ mod tests {
         TransactionKey::new(format!("branch-manager-{}", name), Method::Options, false)
     }
 
+    // Helper to wait until a timer has fired
+    async fn wait_finished(handle: &TimerHandle, within: Duration) {
+        let wait = async {
+            while !handle.is_finished() {
+                tokio::time::sleep(Duration::from_millis(5)).await;
+            }
+        };
+        if timeout(within, wait).await.is_err() {
+            panic!("Timeout waiting for timer to complete");
+        }
+    }
+
     #[test]
     fn timer_manager_new_and_default() {
         let settings = TimerSettings {
@@ -307,7 +322,7 @@ mod tests {
         };
         let manager = TimerManager::new(Some(settings.clone()));
         assert_eq!(manager.settings(), &settings);
-        assert!(manager.transaction_channels.try_lock().unwrap().is_empty());
+        assert!(manager.transaction_channels.read().unwrap().is_empty());
 
         let default_manager = TimerManager::default();
         assert_eq!(*default_manager.settings(), TimerSettings::default());
@@ -322,15 +337,15 @@ mod tests {
         manager.register_transaction(tx_key.clone(), cmd_tx).await;
         assert!(manager
             .transaction_channels
-            .lock()
-            .await
+            .read()
+            .unwrap()
             .contains_key(&tx_key));
 
         manager.unregister_transaction(&tx_key).await;
         assert!(!manager
             .transaction_channels
-            .lock()
-            .await
+            .read()
+            .unwrap()
             .contains_key(&tx_key));
 
         // Test unregistering a non-existent key (should not panic)
@@ -365,7 +380,7 @@ mod tests {
             Err(_) => panic!("Timeout waiting for timer event"),
         }
 
-        handle.await.expect("Timer task panicked");
+        assert!(handle.is_finished());
     }
 
     #[tokio::test]
@@ -385,7 +400,7 @@ mod tests {
         // Unregister immediately after starting
         manager.unregister_transaction(&tx_key).await;
 
-        // The timer task will run, but it shouldn't find the channel to send the event.
+        // The timer will fire, but it shouldn't find the channel to send the event.
         // We check that no event is received.
         match timeout(timer_duration + Duration::from_millis(50), cmd_rx.recv()).await {
             Ok(Some(_)) => {
@@ -397,9 +412,7 @@ mod tests {
                 trace!("Timeout as expected for unregistered timer test.")
             }
         }
-        handle
-            .await
-            .expect("Timer task for unregistered tx panicked");
+        wait_finished(&handle, Duration::from_millis(100)).await;
     }
 
     #[tokio::test]
@@ -418,14 +431,50 @@ mod tests {
             .await
             .unwrap();
 
-        // The spawned task will attempt to send, but it will fail because the receiver is dropped.
-        // This should be handled gracefully within the task (e.g., logged error).
-        // We just await the handle to ensure the task completes without panicking.
-        match timeout(timer_duration + Duration::from_millis(50), handle).await {
-            Ok(Ok(())) => { /* Task completed */ }
-            Ok(Err(e)) => panic!("Timer task join error: {}", e),
-            Err(_) => panic!("Timeout waiting for timer task to complete after receiver dropped"),
+        // The wheel will attempt to send, but it will fail because the receiver is dropped.
+        // This should be handled gracefully (e.g., logged error) and the timer still completes.
+        wait_finished(&handle, timer_duration + Duration::from_millis(100)).await;
+    }
+
+    #[tokio::test]
+    async fn timer_manager_aborted_timer_does_not_fire() {
+        let manager = TimerManager::new(None);
+        let tx_key = dummy_tm_tx_key("aborted");
+        let (cmd_tx, mut cmd_rx) = mpsc::channel(4);
+        manager
+            .register_transaction(tx_key.clone(), cmd_tx.clone())
+            .await;
+
+        let aborted = manager
+            .start_timer(tx_key.clone(), TimerType::E, Duration::from_millis(20))
+            .await
+            .unwrap();
+        aborted.abort();
+        assert!(aborted.is_finished());
+
+        let transition = manager
+            .start_timer_with_transition(
+                tx_key.clone(),
+                TimerType::K,
+                Duration::from_millis(30),
+                cmd_tx,
+                crate::transaction::TransactionState::Terminated,
+            )
+            .await
+            .unwrap();
+
+        // Only the transition timer fires: Timer event first, then the transition.
+        match timeout(Duration::from_millis(200), cmd_rx.recv()).await {
+            Ok(Some(InternalTransactionCommand::Timer(payload))) => assert_eq!(payload, "K"),
+            other => panic!("Expected Timer K event, got {:?}", other),
+        }
+        match timeout(Duration::from_millis(50), cmd_rx.recv()).await {
+            Ok(Some(InternalTransactionCommand::TransitionTo(state))) => {
+                assert_eq!(state, crate::transaction::TransactionState::Terminated)
+            }
+            other => panic!("Expected transition, got {:?}", other),
         }
+        assert!(transition.is_finished());
     }
 
     #[test]
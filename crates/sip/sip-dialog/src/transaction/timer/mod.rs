@@ -29,6 +29,7 @@
 //! - [`TimerSettings`]: Configuration for standard timer durations (T1, T2, etc.).
 //! - [`TimerManager`]: Manages the execution of timers and dispatches events.
 //! - [`TimerFactory`]: Simplifies the creation of standard RFC 3261 timers.
+//! - [`TimerHandle`]: Cancels a timer armed through the `TimerManager`.
 //!
 //! # SIP Timer Overview
 //!
@@ -74,11 +75,13 @@
 pub mod factory;
 pub mod manager;
 pub mod types;
+pub mod wheel;
 
 // Re-export main items from submodules to make them accessible via `crate::timer::ItemName`
 pub use factory::TimerFactory;
 pub use manager::TimerManager;
 pub use types::{Timer, TimerSettings, TimerType};
+pub use wheel::TimerHandle;
 
 #[cfg(test)]
 mod tests {
@@ -0,0 +1,645 @@
+//! Hierarchical timing wheel that drives all transaction timers.
+//!
+//! Every transaction arms several one-shot timers (A/B/D, E/F/K, G/H/I, J)
+//! and cancels most of them before they fire. Rather than spawning a
+//! sleeping task per timer, [`TimerManager`](super::TimerManager) places
+//! each timer in a process-wide wheel:
+//!
+//! - **Levels**: six levels of 64 slots at 1 ms resolution. Level 0
+//!   covers the next 64 ms, each higher level covers 64× the one below,
+//!   so any SIP timer (at most 64·T1 plus some slack) lands in the first
+//!   three levels. When a higher-level slot comes due its timers cascade
+//!   down to the level that matches their remaining time.
+//! - **O(1) insert and cancel**: entries live in a slab and record their
+//!   slot position, so arming is a push and cancelling is a
+//!   `swap_remove`. A cancelled timer leaves nothing behind.
+//! - **Shards**: the wheel is split into one shard per CPU. A thread
+//!   always inserts into the same shard, so workers do not contend on a
+//!   single lock when arming timers.
+//! - **Batched delivery**: a single driver thread sleeps until the
+//!   earliest deadline across all shards, collects everything that
+//!   expired and only then delivers the timer commands, outside the
+//!   shard locks. Commands are sent with `try_send`; a full transaction
+//!   channel falls back to an awaited send on the runtime that armed the
+//!   timer, or, for timers armed outside any runtime, to an overflow queue
+//!   the driver retries every tick. The driver never blocks on a channel,
+//!   so one slow transaction cannot stall the wheel.
+//!
+//! The driver runs on its own thread rather than as a tokio task so it
+//! keeps running regardless of which runtime armed a timer.
+
+use std::collections::VecDeque;
+use std::sync::atomic::{AtomicU64, AtomicUsize, Ordering};
+use std::sync::{Condvar, Mutex, MutexGuard, Once, OnceLock};
+use std::time::{Duration, Instant};
+
+use tokio::runtime::Handle;
+use tokio::sync::mpsc::{self, error::TrySendError};
+use tracing::{debug, error, trace};
+
+use super::manager::TransactionChannels;
+use super::types::TimerType;
+use crate::transaction::{InternalTransactionCommand, TransactionKey, TransactionState};
+
+/// Bits of the deadline covered by one level
+const LEVEL_BITS: u32 = 6;
+/// Slots per level
+const SLOTS: usize = 1 << LEVEL_BITS;
+/// Number of levels
+const LEVELS: usize = 6;
+/// Furthest deadline the wheel can hold, in ticks (about 2.2 years)
+const MAX_TICKS: u64 = (1 << (LEVEL_BITS as usize * LEVELS)) - 1;
+/// Wheel resolution in milliseconds
+const TICK_MS: u64 = 1;
+
+/// Identifies an armed timer; stale once it fires or is cancelled
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub(crate) struct EntryKey {
+    index: u32,
+    generation: u32,
+}
+
+struct Armed<T> {
+    when: u64,
+    value: T,
+    level: u8,
+    slot: u8,
+    /// Position in the slot's index list
+    pos: u32,
+}
+
+struct Entry<T> {
+    generation: u32,
+    armed: Option<Armed<T>>,
+}
+
+struct Level {
+    /// Bit `n` is set when slot `n` is non-empty
+    occupied: u64,
+    slots: [Vec<u32>; SLOTS],
+}
+
+/// A single-threaded hierarchical timing wheel.
+///
+/// Time is measured in ticks; `poll` moves the wheel forward and hands
+/// back every value whose deadline has been reached.
+pub(crate) struct Wheel<T> {
+    /// Ticks processed so far
+    elapsed: u64,
+    levels: Vec<Level>,
+    entries: Vec<Entry<T>>,
+    free: Vec<u32>,
+}
+
+impl<T> Wheel<T> {
+    pub(crate) fn new() -> Self {
+        Self {
+            elapsed: 0,
+            levels: (0..LEVELS)
+                .map(|_| Level {
+                    occupied: 0,
+                    slots: std::array::from_fn(|_| Vec::new()),
+                })
+                .collect(),
+            entries: Vec::new(),
+            free: Vec::new(),
+        }
+    }
+
+    /// Arm a timer that fires once the wheel reaches tick `when`. A
+    /// deadline that has already passed fires on the next tick.
+    pub(crate) fn insert(&mut self, when: u64, value: T) -> EntryKey {
+        let when = when.clamp(self.elapsed + 1, self.elapsed + MAX_TICKS);
+        let armed = Armed {
+            when,
+            value,
+            level: 0,
+            slot: 0,
+            pos: 0,
+        };
+        let index = match self.free.pop() {
+            Some(index) => {
+                self.entries[index as usize].armed = Some(armed);
+                index
+            }
+            None => {
+                self.entries.push(Entry {
+                    generation: 0,
+                    armed: Some(armed),
+                });
+                (self.entries.len() - 1) as u32
+            }
+        };
+        self.place(index, when);
+        EntryKey {
+            index,
+            generation: self.entries[index as usize].generation,
+        }
+    }
+
+    /// Disarm a timer, returning its value if it had not fired yet
+    pub(crate) fn cancel(&mut self, key: EntryKey) -> Option<T> {
+        if !self.is_armed(key) {
+            return None;
+        }
+        let (level, slot, pos) = {
+            let armed = self.entries[key.index as usize].armed.as_ref()?;
+            (
+                armed.level as usize,
+                armed.slot as usize,
+                armed.pos as usize,
+            )
+        };
+        let indices = &mut self.levels[level].slots[slot];
+        indices.swap_remove(pos);
+        if let Some(&moved) = indices.get(pos) {
+            if let Some(armed) = self.entries[moved as usize].armed.as_mut() {
+                armed.pos = pos as u32;
+            }
+        }
+        if indices.is_empty() {
+            self.levels[level].occupied &= !(1 << slot);
+        }
+        Some(self.take(key.index).value)
+    }
+
+    /// Whether `key` still refers to an armed timer
+    pub(crate) fn is_armed(&self, key: EntryKey) -> bool {
+        self.entries
+            .get(key.index as usize)
+            .is_some_and(|entry| entry.generation == key.generation && entry.armed.is_some())
+    }
+
+    /// Earliest tick at which `poll` has work to do
+    pub(crate) fn next_deadline(&self) -> Option<u64> {
+        self.next_expiration().map(|(_, _, deadline)| deadline)
+    }
+
+    /// Advance the wheel to tick `now`, appending every expired value to
+    /// `expired` in deadline order.
+    pub(crate) fn poll(&mut self, now: u64, expired: &mut Vec<T>) {
+        while let Some((level, slot, deadline)) = self.next_expiration() {
+            if deadline > now {
+                break;
+            }
+            self.elapsed = deadline;
+            let mut indices = std::mem::take(&mut self.levels[level].slots[slot]);
+            self.levels[level].occupied &= !(1 << slot);
+            for &index in &indices {
+                let when = match &self.entries[index as usize].armed {
+                    Some(armed) => armed.when,
+                    None => continue,
+                };
+                if when <= deadline {
+                    expired.push(self.take(index).value);
+                } else {
+                    // Cascades to a lower level; never back into this slot.
+                    self.place(index, when);
+                }
+            }
+            indices.clear();
+            self.levels[level].slots[slot] = indices;
+        }
+        self.elapsed = self.elapsed.max(now);
+    }
+
+    fn take(&mut self, index: u32) -> Armed<T> {
+        let entry = &mut self.entries[index as usize];
+        let armed = entry.armed.take().expect("entry is armed");
+        entry.generation = entry.generation.wrapping_add(1);
+        self.free.push(index);
+        armed
+    }
+
+    fn place(&mut self, index: u32, when: u64) {
+        let level = level_for(self.elapsed, when);
+        let slot = ((when >> (level as u32 * LEVEL_BITS)) as usize) & (SLOTS - 1);
+        let indices = &mut self.levels[level].slots[slot];
+        let armed = self.entries[index as usize]
+            .armed
+            .as_mut()
+            .expect("entry is armed");
+        armed.level = level as u8;
+        armed.slot = slot as u8;
+        armed.pos = indices.len() as u32;
+        indices.push(index);
+        self.levels[level].occupied |= 1 << slot;
+    }
+
+    /// The first non-empty slot and the tick at which it comes due
+    fn next_expiration(&self) -> Option<(usize, usize, u64)> {
+        for (level, l) in self.levels.iter().enumerate() {
+            if l.occupied == 0 {
+                continue;
+            }
+            let shift = level as u32 * LEVEL_BITS;
+            let slot_range = 1u64 << shift;
+            let level_range = slot_range << LEVEL_BITS;
+            let now_slot = ((self.elapsed >> shift) as u32) & (SLOTS as u32 - 1);
+            let slot =
+                (l.occupied.rotate_right(now_slot).trailing_zeros() + now_slot) as usize % SLOTS;
+            let mut deadline = (self.elapsed & !(level_range - 1)) + slot as u64 * slot_range;
+            if deadline <= self.elapsed {
+                // Only the top level wraps around: its slots form a ring.
+                debug_assert_eq!(level, LEVELS - 1);
+                deadline += level_range;
+            }
+            return Some((level, slot, deadline));
+        }
+        None
+    }
+}
+
+/// Level whose slot granularity matches the distance from `elapsed` to
+/// `when`
+fn level_for(elapsed: u64, when: u64) -> usize {
+    let masked = ((elapsed ^ when) | (SLOTS as u64 - 1)).min(MAX_TICKS - 1);
+    let significant = 63 - masked.leading_zeros();
+    (significant / LEVEL_BITS) as usize
+}
+
+/// Where an expired transaction timer is delivered
+pub(crate) enum TimerTarget {
+    /// Look the transaction up in its manager's registry when the timer
+    /// fires; nothing is sent if it has been unregistered
+    Registered(TransactionChannels),
+    /// Send to `cmd_tx` directly, followed by a transition to `state`
+    Transition {
+        cmd_tx: mpsc::Sender<InternalTransactionCommand>,
+        state: TransactionState,
+    },
+}
+
+/// A transaction timer armed in the wheel
+pub(crate) struct TimerEntry {
+    pub(crate) transaction_id: TransactionKey,
+    pub(crate) timer_type: TimerType,
+    pub(crate) target: TimerTarget,
+    /// Runtime that armed the timer, used if the channel is full
+    pub(crate) runtime: Option<Handle>,
+}
+
+impl TimerEntry {
+    /// The channel and commands this timer delivers, or `None` if its
+    /// transaction is no longer registered
+    fn into_delivery(self) -> Option<Delivery> {
+        let (cmd_tx, transition) = match self.target {
+            TimerTarget::Registered(channels) => {
+                let cmd_tx = channels
+                    .read()
+                    .unwrap_or_else(|e| e.into_inner())
+                    .get(&self.transaction_id)
+                    .cloned();
+                match cmd_tx {
+                    Some(cmd_tx) => (cmd_tx, None),
+                    None => {
+                        trace!(id=%self.transaction_id, timer=%self.timer_type, "Timer fired, but transaction no longer registered.");
+                        return None;
+                    }
+                }
+            }
+            TimerTarget::Transition { cmd_tx, state } => (cmd_tx, Some(state)),
+        };
+
+        let commands = std::iter::once(InternalTransactionCommand::Timer(
+            self.timer_type.to_string(),
+        ))
+        .chain(transition.map(InternalTransactionCommand::TransitionTo))
+        .collect();
+        Some(Delivery {
+            transaction_id: self.transaction_id,
+            timer_type: self.timer_type,
+            cmd_tx,
+            commands,
+            runtime: self.runtime,
+        })
+    }
+}
+
+/// Timer commands on their way to a transaction
+struct Delivery {
+    transaction_id: TransactionKey,
+    timer_type: TimerType,
+    cmd_tx: mpsc::Sender<InternalTransactionCommand>,
+    commands: VecDeque<InternalTransactionCommand>,
+    runtime: Option<Handle>,
+}
+
+impl Delivery {
+    /// Send as many commands as the channel accepts without waiting;
+    /// `true` once nothing is left to deliver
+    fn flush(&mut self) -> bool {
+        while let Some(command) = self.commands.pop_front() {
+            match self.cmd_tx.try_send(command) {
+                Ok(()) => {}
+                Err(TrySendError::Closed(_)) => {
+                    debug!(id=%self.transaction_id, timer=%self.timer_type, "Failed to send timer event (receiver dropped).");
+                    self.commands.clear();
+                    return true;
+                }
+                Err(TrySendError::Full(command)) => {
+                    self.commands.push_front(command);
+                    return false;
+                }
+            }
+        }
+        trace!(id=%self.transaction_id, timer=%self.timer_type, "Timer event sent.");
+        true
+    }
+
+    async fn send_all(self) {
+        for command in self.commands {
+            if self.cmd_tx.send(command).await.is_err() {
+                break;
+            }
+        }
+    }
+}
+
+/// Handle to a timer armed through [`TimerManager`](super::TimerManager).
+///
+/// Dropping the handle leaves the timer armed; call [`abort`](Self::abort)
+/// to cancel it.
+#[derive(Debug)]
+pub struct TimerHandle {
+    shard: usize,
+    key: EntryKey,
+}
+
+impl TimerHandle {
+    /// Cancel the timer. Does nothing if it has already fired.
+    pub fn abort(&self) {
+        TimerScheduler::global().cancel(self.shard, self.key);
+    }
+
+    /// Whether the timer has fired or been cancelled
+    pub fn is_finished(&self) -> bool {
+        !TimerScheduler::global().is_armed(self.shard, self.key)
+    }
+}
+
+/// The process-wide sharded wheel and its driver thread
+pub(crate) struct TimerScheduler {
+    epoch: Instant,
+    shards: Box<[Mutex<Wheel<TimerEntry>>]>,
+    /// Tick the driver is sleeping until; `u64::MAX` while it is busy
+    next_wake: AtomicU64,
+    /// Set when an insert needs the driver to wake up early
+    wake: Mutex<bool>,
+    wake_cv: Condvar,
+}
+
+static SCHEDULER: OnceLock<TimerScheduler> = OnceLock::new();
+static DRIVER: Once = Once::new();
+static NEXT_SHARD: AtomicUsize = AtomicUsize::new(0);
+
+thread_local! {
+    static SHARD_SEED: usize = NEXT_SHARD.fetch_add(1, Ordering::Relaxed);
+}
+
+fn lock<T>(mutex: &Mutex<T>) -> MutexGuard<'_, T> {
+    mutex.lock().unwrap_or_else(|e| e.into_inner())
+}
+
+impl TimerScheduler {
+    /// The shared scheduler, starting its driver thread on first use
+    pub(crate) fn global() -> &'static TimerScheduler {
+        let scheduler = SCHEDULER.get_or_init(|| {
+            let shards = std::thread::available_parallelism().map_or(1, |n| n.get());
+            TimerScheduler {
+                epoch: Instant::now(),
+                shards: (0..shards).map(|_| Mutex::new(Wheel::new())).collect(),
+                next_wake: AtomicU64::new(u64::MAX),
+                wake: Mutex::new(false),
+                wake_cv: Condvar::new(),
+            }
+        });
+        DRIVER.call_once(|| {
+            if let Err(e) = std::thread::Builder::new()
+                .name("sip-timer-wheel".to_string())
+                .spawn(move || scheduler.run())
+            {
+                error!(error=%e, "Failed to start transaction timer thread");
+            }
+        });
+        scheduler
+    }
+
+    /// Arm `entry` to fire after `duration`
+    pub(crate) fn schedule(&self, duration: Duration, entry: TimerEntry) -> TimerHandle {
+        let deadline = Instant::now() + duration;
+        let elapsed = deadline.saturating_duration_since(self.epoch);
+        // Round up so a timer never fires early.
+        let when = elapsed.as_millis().div_ceil(TICK_MS as u128) as u64;
+
+        let shard = self.local_shard();
+        let key = lock(&self.shards[shard]).insert(when, entry);
+        if when < self.next_wake.load(Ordering::SeqCst) {
+            *lock(&self.wake) = true;
+            self.wake_cv.notify_one();
+        }
+        TimerHandle { shard, key }
+    }
+
+    fn cancel(&self, shard: usize, key: EntryKey) {
+        // Dropped outside the shard lock.
+        let entry = lock(&self.shards[shard]).cancel(key);
+        drop(entry);
+    }
+
+    fn is_armed(&self, shard: usize, key: EntryKey) -> bool {
+        lock(&self.shards[shard]).is_armed(key)
+    }
+
+    fn local_shard(&self) -> usize {
+        SHARD_SEED.with(|seed| *seed) % self.shards.len()
+    }
+
+    fn now_ticks(&self) -> u64 {
+        self.epoch.elapsed().as_millis() as u64 / TICK_MS
+    }
+
+    fn run(&self) {
+        let mut expired = Vec::new();
+        // Deliveries to full channels with no runtime to wait on; retried
+        // by this thread every tick instead of blocking it.
+        let mut overflow: Vec<Delivery> = Vec::new();
+        loop {
+            self.next_wake.store(u64::MAX, Ordering::SeqCst);
+            let now = self.now_ticks();
+            let mut next = u64::MAX;
+            for shard in self.shards.iter() {
+                let mut wheel = lock(shard);
+                wheel.poll(now, &mut expired);
+                if let Some(deadline) = wheel.next_deadline() {
+                    next = next.min(deadline);
+                }
+            }
+            // Earlier overflow goes first so each transaction still sees
+            // its timer commands in order.
+            overflow.retain_mut(|pending| !pending.flush());
+            if !expired.is_empty() {
+                trace!(
+                    count = expired.len(),
+                    "Delivering expired transaction timers"
+                );
+                for entry in expired.drain(..) {
+                    let Some(mut delivery) = entry.into_delivery() else {
+                        continue;
+                    };
+                    if let Some(pending) = overflow
+                        .iter_mut()
+                        .find(|pending| pending.cmd_tx.same_channel(&delivery.cmd_tx))
+                    {
+                        pending.commands.append(&mut delivery.commands);
+                    } else if !delivery.flush() {
+                        match delivery.runtime.take() {
+                            Some(runtime) => {
+                                runtime.spawn(delivery.send_all());
+                            }
+                            None => overflow.push(delivery),
+                        }
+                    }
+                }
+            }
+            if !overflow.is_empty() {
+                next = next.min(now + 1);
+            }
+            self.next_wake.store(next, Ordering::SeqCst);
+
+            let mut woken = lock(&self.wake);
+            if !*woken {
+                if next == u64::MAX {
+                    woken = self.wake_cv.wait(woken).unwrap_or_else(|e| e.into_inner());
+                } else {
+                    let until = self.epoch + Duration::from_millis(next.saturating_mul(TICK_MS));
+                    let timeout = until.saturating_duration_since(Instant::now());
+                    if !timeout.is_zero() {
+                        woken = self
+                            .wake_cv
+                            .wait_timeout(woken, timeout)
+                            .unwrap_or_else(|e| e.into_inner())
+                            .0;
+                    }
+                }
+            }
+            *woken = false;
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn drain(wheel: &mut Wheel<u64>, now: u64) -> Vec<u64> {
+        let mut out = Vec::new();
+        wheel.poll(now, &mut out);
+        out
+    }
+
+    #[test]
+    fn test_fires_at_deadline_across_levels() {
+        let mut wheel = Wheel::new();
+        let deadlines = [1, 63, 64, 65, 500, 4_095, 4_096, 32_000, 300_000];
+        for &when in &deadlines {
+            wheel.insert(when, when);
+        }
+
+        let mut fired = Vec::new();
+        for now in 0..=300_000 {
+            for when in drain(&mut wheel, now) {
+                assert_eq!(when, now, "timer fired at the wrong tick");
+                fired.push(when);
+            }
+        }
+        assert_eq!(fired, deadlines);
+        assert_eq!(wheel.next_deadline(), None);
+    }
+
+    #[test]
+    fn test_large_jumps_fire_everything_due() {
+        let mut wheel = Wheel::new();
+        for when in (0..10_000).map(|i| i * 17 + 1) {
+            wheel.insert(when, when);
+        }
+        let fired = drain(&mut wheel, 200_000);
+        assert_eq!(fired.len(), 10_000);
+        assert!(fired.windows(2).all(|w| w[0] <= w[1]));
+
+        // Past deadlines fire on the next tick.
+        wheel.insert(5, 5);
+        assert_eq!(wheel.next_deadline(), Some(200_001));
+        assert_eq!(drain(&mut wheel, 200_001), vec![5]);
+    }
+
+    #[test]
+    fn test_cancel_is_exact() {
+        let mut wheel = Wheel::new();
+        let keys: Vec<_> = (0..100).map(|i| wheel.insert(1_000 + i, i)).collect();
+        for key in keys.iter().step_by(2) {
+            assert!(wheel.cancel(*key).is_some());
+            assert!(!wheel.is_armed(*key));
+            // A second cancel is a no-op.
+            assert!(wheel.cancel(*key).is_none());
+        }
+
+        // Reused slab entries must not be reachable through stale keys.
+        let reused = wheel.insert(2_000, 1_000);
+        assert!(wheel.cancel(keys[0]).is_none());
+        assert!(wheel.is_armed(reused));
+
+        let fired = drain(&mut wheel, 5_000);
+        let expected: Vec<u64> = (1..100).step_by(2).chain([1_000]).collect();
+        assert_eq!(fired, expected);
+        assert!(!wheel.is_armed(keys[1]));
+    }
+
+    #[test]
+    fn test_full_channel_without_runtime_does_not_stall_driver() {
+        use rvoip_sip_core::Method;
+
+        let transition = |branch: &str, cmd_tx| TimerEntry {
+            transaction_id: TransactionKey::new(branch.to_string(), Method::Invite, true),
+            timer_type: TimerType::B,
+            target: TimerTarget::Transition {
+                cmd_tx,
+                state: TransactionState::Terminated,
+            },
+            runtime: None,
+        };
+        let scheduler = TimerScheduler::global();
+
+        // A timer for a transaction whose channel is already full.
+        let (full_tx, mut full_rx) = mpsc::channel(1);
+        full_tx
+            .try_send(InternalTransactionCommand::Timer("earlier".into()))
+            .unwrap();
+        scheduler.schedule(Duration::from_millis(1), transition("z9hG4bKfull", full_tx));
+
+        // Later timers for other transactions still fire.
+        let (free_tx, mut free_rx) = mpsc::channel(4);
+        scheduler.schedule(Duration::from_millis(20), transition("z9hG4bKfree", free_tx));
+        let deadline = Instant::now() + Duration::from_secs(2);
+        while free_rx.try_recv().is_err() {
+            assert!(Instant::now() < deadline, "driver stalled on a full channel");
+            std::thread::sleep(Duration::from_millis(5));
+        }
+
+        // Once the full channel drains, the queued commands arrive in order.
+        let mut received = Vec::new();
+        while received.len() < 3 {
+            assert!(Instant::now() < deadline, "queued timer commands never arrived");
+            match full_rx.try_recv() {
+                Ok(command) => received.push(command),
+                Err(_) => std::thread::sleep(Duration::from_millis(5)),
+            }
+        }
+        assert!(matches!(&received[0], InternalTransactionCommand::Timer(t) if t == "earlier"));
+        assert!(matches!(&received[1], InternalTransactionCommand::Timer(t) if t == "B"));
+        assert!(matches!(
+            received[2],
+            InternalTransactionCommand::TransitionTo(TransactionState::Terminated)
+        ));
+    }
+}
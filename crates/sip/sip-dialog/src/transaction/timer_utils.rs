@@ -1,9 +1,8 @@
 use std::time::Duration;
 use tokio::sync::mpsc;
-use tokio::task::JoinHandle;
-use tracing::{debug, trace};
+use tracing::trace;
 
-use crate::transaction::timer::{TimerManager, TimerSettings, TimerType};
+use crate::transaction::timer::{TimerHandle, TimerManager, TimerSettings, TimerType};
 use crate::transaction::{InternalTransactionCommand, TransactionKey, TransactionState};
 
 /// Helper module for transaction-specific timer operations using the core timer infrastructure.
@@ -20,7 +19,7 @@ use crate::transaction::{InternalTransactionCommand, TransactionKey, Transaction
 /// * `cmd_tx` - Channel to send commands when the timer fires
 ///
 /// # Returns
-/// A JoinHandle for the timer task
+/// A TimerHandle for the armed timer
 pub async fn start_transaction_timer(
     timer_manager: &TimerManager,
     tx_id: &TransactionKey,
@@ -28,7 +27,7 @@ pub async fn start_transaction_timer(
     timer_type: TimerType,
     interval: Duration,
     cmd_tx: mpsc::Sender<InternalTransactionCommand>,
-) -> Result<JoinHandle<()>, crate::transaction::error::Error> {
+) -> Result<TimerHandle, crate::transaction::error::Error> {
     // Register the transaction if not already done
     timer_manager
         .register_transaction(tx_id.clone(), cmd_tx)
@@ -55,45 +54,25 @@ pub async fn start_transaction_timer(
 /// * `target_state` - State to transition to when the timer fires
 ///
 /// # Returns
-/// A JoinHandle for the timer task
+/// A TimerHandle for the armed timer
 pub async fn start_timer_with_transition(
     timer_manager: &TimerManager,
     tx_id: &TransactionKey,
     timer_name: &str,
-    _timer_type: TimerType,
+    timer_type: TimerType,
     interval: Duration,
     cmd_tx: mpsc::Sender<InternalTransactionCommand>,
     target_state: TransactionState,
-) -> Result<JoinHandle<()>, crate::transaction::error::Error> {
-    // Clone values for transition - this fixes the 'borrowed data escapes function' error
-    let tx_id_clone = tx_id.clone();
-    let cmd_tx_clone = cmd_tx.clone();
-    let state = target_state;
-    let timer_name_clone = timer_name.to_string(); // Clone the timer name to avoid borrowing issues
-
+) -> Result<TimerHandle, crate::transaction::error::Error> {
     // Register the transaction if not already done
     timer_manager
-        .register_transaction(tx_id_clone.clone(), cmd_tx_clone.clone())
+        .register_transaction(tx_id.clone(), cmd_tx.clone())
         .await;
 
-    // We need to create a custom timer handler that will send both Timer and TransitionTo commands
-    let handle = tokio::spawn(async move {
-        // Sleep for the interval
-        tokio::time::sleep(interval).await;
-
-        // Then send both commands
-        debug!(id=%tx_id_clone, timer=%timer_name_clone, "Timer fired with transition to {:?}", state);
-
-        // First send the timer event
-        let _ = cmd_tx_clone
-            .send(InternalTransactionCommand::Timer(timer_name_clone.clone()))
-            .await;
-
-        // Then send the transition command
-        let _ = cmd_tx_clone
-            .send(InternalTransactionCommand::TransitionTo(state))
-            .await;
-    });
+    // The wheel sends both the Timer and the TransitionTo command when it fires
+    let handle = timer_manager
+        .start_timer_with_transition(tx_id.clone(), timer_type, interval, cmd_tx, target_state)
+        .await?;
 
     trace!(id=%tx_id, timer=%timer_name, interval=?interval, target_state=?target_state, "Started timer with transition");
     Ok(handle)
@@ -21,11 +21,13 @@ use std::sync::Arc;
 
 use async_trait::async_trait;
 use bytes::Bytes;
+use rvoip_sip_core::types::wire::WireFormat;
 use rvoip_sip_core::{HeaderName, Message, Request, TypedHeader, Uri};
+use rvoip_sip_transport::transport::shard::ShardSink;
 use rvoip_sip_transport::transport::TransportType;
 use rvoip_sip_transport::{
     error::{Error as TransportError, Result as TransportResult},
-    Transport,
+    Transport, WireCache,
 };
 use tracing::{debug, trace, warn};
 
@@ -156,30 +158,7 @@ impl MultiplexedTransport {
         destination: SocketAddr,
     ) -> TransportResult<(TransportType, Arc<dyn Transport>)> {
         match message {
-            Message::Request(request) => {
-                let want = select_transport_for_request(request);
-                if let Some(transport) = self.transports.get(&want) {
-                    trace!(
-                        "MultiplexedTransport: routing {} to {} via URI selection",
-                        request.method(),
-                        want
-                    );
-                    Ok((want, transport.clone()))
-                } else if want == TransportType::Tls {
-                    Err(TransportError::UnsupportedTransport(format!(
-                        "{} requires TLS by next-hop URI {}, but no TLS transport is registered",
-                        request.method(),
-                        next_hop_uri_for_request(request)
-                    )))
-                } else {
-                    debug!(
-                        "MultiplexedTransport: no {} transport registered for {}; falling back to default",
-                        want,
-                        request.method()
-                    );
-                    Ok((self.default.default_transport_type(), self.default.clone()))
-                }
-            }
+            Message::Request(request) => self.pick_request_transport(request),
             Message::Response(response) => {
                 // Probe connection-oriented transports first. We do
                 // *not* probe UDP because it always reports false (the
@@ -212,6 +191,88 @@ impl MultiplexedTransport {
         }
     }
 
+    /// Pick the underlying transport for an outbound request by its next
+    /// hop (see [`Self::pick_transport`]).
+    fn pick_request_transport(
+        &self,
+        request: &Request,
+    ) -> TransportResult<(TransportType, Arc<dyn Transport>)> {
+        let want = select_transport_for_request(request);
+        if let Some(transport) = self.transports.get(&want) {
+            trace!(
+                "MultiplexedTransport: routing {} to {} via URI selection",
+                request.method(),
+                want
+            );
+            Ok((want, transport.clone()))
+        } else if want == TransportType::Tls {
+            Err(TransportError::UnsupportedTransport(format!(
+                "{} requires TLS by next-hop URI {}, but no TLS transport is registered",
+                request.method(),
+                next_hop_uri_for_request(request)
+            )))
+        } else {
+            debug!(
+                "MultiplexedTransport: no {} transport registered for {}; falling back to default",
+                want,
+                request.method()
+            );
+            Ok((self.default.default_transport_type(), self.default.clone()))
+        }
+    }
+
+    /// RFC 3261 §18.1.1 — if the URI selected UDP but a request of `size`
+    /// bytes would exceed UDP's safe size, fail over to TCP when a TCP
+    /// transport is registered. If none is, fail closed: this is a
+    /// protocol MUST. Returns the TCP transport to switch to, or `None`
+    /// to stay on `transport`.
+    fn udp_size_failover(
+        &self,
+        request: &Request,
+        transport: &Arc<dyn Transport>,
+        size: usize,
+    ) -> TransportResult<Option<Arc<dyn Transport>>> {
+        let limit = transport.max_safe_message_size();
+        if size <= limit {
+            return Ok(None);
+        }
+        match self.transports.get(&TransportType::Tcp) {
+            Some(tcp) => {
+                debug!(
+                    "MultiplexedTransport: {} is {} bytes (UDP limit {}), failing over to TCP per RFC 3261 §18.1.1",
+                    request.method(), size, limit
+                );
+                Ok(Some(tcp.clone()))
+            }
+            None => {
+                warn!(
+                    "MultiplexedTransport: {} is {} bytes (UDP limit {}) and no TCP transport is registered; refusing to send",
+                    request.method(), size, limit
+                );
+                Err(TransportError::MessageTooLarge(size))
+            }
+        }
+    }
+
+    fn trace_outbound(
+        &self,
+        transport_type: TransportType,
+        transport: &Arc<dyn Transport>,
+        destination: SocketAddr,
+        message: &Message,
+    ) {
+        if let Some(trace) = &self.sip_trace {
+            let local_addr = transport.local_addr().unwrap_or(self.local_addr);
+            trace.publish(
+                SipTraceDirection::Outbound,
+                transport_type,
+                local_addr,
+                destination,
+                message,
+            );
+        }
+    }
+
     /// RFC 3263 §4.3 multi-candidate failover send.
     ///
     /// Walks `candidates` in order. For each, dispatches the message via
@@ -295,52 +356,80 @@ impl Transport for MultiplexedTransport {
     ) -> TransportResult<()> {
         let (mut transport_type, mut transport) = self.pick_transport(&message, destination)?;
 
-        // RFC 3261 §18.1.1 — if the URI selected UDP but the request
-        // would exceed UDP's safe size, fail over to TCP when a TCP
-        // transport is registered. If none is, fail closed: this is a
-        // protocol MUST.
         if transport_type == TransportType::Udp {
-            if let Message::Request(ref req) = message {
-                let size = message.to_bytes().len();
-                let limit = transport.max_safe_message_size();
-                if size > limit {
-                    match self.transports.get(&TransportType::Tcp) {
-                        Some(tcp) => {
-                            debug!(
-                                "MultiplexedTransport: {} is {} bytes (UDP limit {}), failing over to TCP per RFC 3261 §18.1.1",
-                                req.method(), size, limit
-                            );
-                            if let Message::Request(ref mut req_mut) = message {
-                                crate::transaction::utils::set_top_via_protocol(req_mut, "TCP");
-                            }
-                            transport_type = TransportType::Tcp;
-                            transport = tcp.clone();
-                        }
-                        None => {
-                            warn!(
-                                "MultiplexedTransport: {} is {} bytes (UDP limit {}) and no TCP transport is registered; refusing to send",
-                                req.method(), size, limit
-                            );
-                            return Err(TransportError::MessageTooLarge(size));
-                        }
-                    }
+            if let Message::Request(ref mut req) = message {
+                let size = req.to_wire().len();
+                if let Some(tcp) = self.udp_size_failover(req, &transport, size)? {
+                    crate::transaction::utils::set_top_via_protocol(req, "TCP");
+                    transport_type = TransportType::Tcp;
+                    transport = tcp;
                 }
             }
         }
 
-        if let Some(trace) = &self.sip_trace {
-            let local_addr = transport.local_addr().unwrap_or(self.local_addr);
-            trace.publish(
-                SipTraceDirection::Outbound,
-                transport_type,
-                local_addr,
-                destination,
-                &message,
-            );
-        }
+        self.trace_outbound(transport_type, &transport, destination, &message);
         transport.send_message(message, destination).await
     }
 
+    /// Retransmissions make the same transport choice, size failover and
+    /// trace as [`Self::send_message`]; only the serialization is cached,
+    /// per selected transport.
+    async fn send_request_cached(
+        &self,
+        request: &Request,
+        wire: &WireCache,
+        destination: SocketAddr,
+    ) -> TransportResult<()> {
+        let (selected, selected_transport) = self.pick_request_transport(request)?;
+        let rewrite = |request: &Request| {
+            let mut request = request.clone();
+            crate::transaction::utils::set_top_via_protocol(&mut request, "TCP");
+            request
+        };
+        let (transport_type, bytes) =
+            wire.get_or_try_insert_with(selected, || -> TransportResult<_> {
+                let bytes = wire.serialized().unwrap_or_else(|| request.to_wire());
+                if selected == TransportType::Udp
+                    && self
+                        .udp_size_failover(request, &selected_transport, bytes.len())?
+                        .is_some()
+                {
+                    return Ok((TransportType::Tcp, rewrite(request).to_wire()));
+                }
+                Ok((selected, bytes))
+            })?;
+        let transport = if transport_type == selected {
+            selected_transport
+        } else {
+            self.transports
+                .get(&transport_type)
+                .cloned()
+                .ok_or_else(|| {
+                    TransportError::UnsupportedTransport(format!(
+                        "{} transport is no longer registered",
+                        transport_type
+                    ))
+                })?
+        };
+
+        let structured = || {
+            Message::Request(if transport_type == selected {
+                request.clone()
+            } else {
+                rewrite(request)
+            })
+        };
+        if self.sip_trace.is_some() {
+            self.trace_outbound(transport_type, &transport, destination, &structured());
+        }
+        match transport.send_message_raw(bytes, destination).await {
+            Err(TransportError::NotImplemented(_)) => {
+                transport.send_message(structured(), destination).await
+            }
+            result => result,
+        }
+    }
+
     async fn send_message_raw(&self, bytes: Bytes, destination: SocketAddr) -> TransportResult<()> {
         for kind in [
             TransportType::Tls,
@@ -465,6 +554,16 @@ impl Transport for MultiplexedTransport {
             destination
         )))
     }
+
+    fn attach_shard_sink(&self, sink: Arc<dyn ShardSink>) -> bool {
+        // Offered to every child; only those that can deliver to shards
+        // (UDP) take it, and a child registered twice takes it once.
+        let mut attached = self.default.attach_shard_sink(sink.clone());
+        for transport in self.transports.values() {
+            attached |= transport.attach_shard_sink(sink.clone());
+        }
+        attached
+    }
 }
 
 #[cfg(test)]
@@ -531,16 +630,26 @@ mod tests {
         /// Whether this transport reports as having a connection to any
         /// destination. Used to drive `send_raw` / response-path probes.
         has_conn: std::sync::atomic::AtomicBool,
+        /// Reported `max_safe_message_size`.
+        max_size: usize,
+        /// Last message passed to `send_message`.
+        last: std::sync::Mutex<Option<Message>>,
     }
 
     impl CountingTransport {
         fn new(label: &'static str) -> Arc<Self> {
+            Self::with_max_size(label, usize::MAX)
+        }
+
+        fn with_max_size(label: &'static str, max_size: usize) -> Arc<Self> {
             Arc::new(Self {
                 label,
                 addr: "127.0.0.1:0".parse().unwrap(),
                 sends: AtomicUsize::new(0),
                 raw_sends: AtomicUsize::new(0),
                 has_conn: std::sync::atomic::AtomicBool::new(false),
+                max_size,
+                last: std::sync::Mutex::new(None),
             })
         }
 
@@ -565,13 +674,18 @@ mod tests {
 
         async fn send_message(
             &self,
-            _message: Message,
+            message: Message,
             _destination: SocketAddr,
         ) -> TransportResult<()> {
             self.sends.fetch_add(1, Ordering::SeqCst);
+            *self.last.lock().unwrap() = Some(message);
             Ok(())
         }
 
+        fn max_safe_message_size(&self) -> usize {
+            self.max_size
+        }
+
         async fn send_raw(&self, _destination: SocketAddr, _data: Bytes) -> TransportResult<()> {
             self.raw_sends.fetch_add(1, Ordering::SeqCst);
             Ok(())
@@ -886,4 +1000,81 @@ mod tests {
         ));
         assert_eq!(udp.count(), 0, "sips: must not fall back to UDP");
     }
+
+    #[tokio::test]
+    async fn cached_retransmits_follow_uri_selection() {
+        let udp = CountingTransport::new("udp");
+        let tls = CountingTransport::new("tls");
+
+        let mut by_flavour: HashMap<TransportType, Arc<dyn Transport>> = HashMap::new();
+        by_flavour.insert(TransportType::Udp, udp.clone() as Arc<dyn Transport>);
+        by_flavour.insert(TransportType::Tls, tls.clone() as Arc<dyn Transport>);
+        let mux =
+            MultiplexedTransport::new(udp.clone() as Arc<dyn Transport>, by_flavour, None).unwrap();
+
+        let Message::Request(request) = make_invite("sips:bob@example.com") else {
+            unreachable!()
+        };
+        let wire = WireCache::new();
+        let dest: SocketAddr = "127.0.0.1:5061".parse().unwrap();
+        for _ in 0..3 {
+            mux.send_request_cached(&request, &wire, dest)
+                .await
+                .unwrap();
+        }
+        assert_eq!(tls.count(), 3, "retransmits must stay on TLS");
+        assert_eq!(udp.count(), 0);
+    }
+
+    #[tokio::test]
+    async fn cached_retransmits_of_oversized_udp_request_fail_over_to_tcp() {
+        let udp = CountingTransport::with_max_size("udp", 100);
+        let tcp = CountingTransport::new("tcp");
+
+        let mut by_flavour: HashMap<TransportType, Arc<dyn Transport>> = HashMap::new();
+        by_flavour.insert(TransportType::Udp, udp.clone() as Arc<dyn Transport>);
+        by_flavour.insert(TransportType::Tcp, tcp.clone() as Arc<dyn Transport>);
+        let mux =
+            MultiplexedTransport::new(udp.clone() as Arc<dyn Transport>, by_flavour, None).unwrap();
+
+        let Message::Request(mut request) = make_invite("sip:bob@example.com") else {
+            unreachable!()
+        };
+        request.headers.insert(
+            0,
+            TypedHeader::Via(
+                rvoip_sip_core::types::via::Via::new(
+                    "SIP",
+                    "2.0",
+                    "UDP",
+                    "192.0.2.1",
+                    Some(5060),
+                    vec![rvoip_sip_core::types::Param::branch("z9hG4bKretx")],
+                )
+                .unwrap(),
+            ),
+        );
+        let wire = WireCache::new();
+        let dest: SocketAddr = "127.0.0.1:5060".parse().unwrap();
+        for _ in 0..2 {
+            mux.send_request_cached(&request, &wire, dest)
+                .await
+                .unwrap();
+        }
+        assert_eq!(udp.count(), 0, "oversized request must not go out over UDP");
+        assert_eq!(tcp.count(), 2);
+        let sent = tcp.last.lock().unwrap().take().unwrap();
+        assert!(String::from_utf8_lossy(&sent.to_bytes()).contains("SIP/2.0/TCP 192.0.2.1"));
+
+        // Without TCP the send is refused, as for the first transmission.
+        let mut udp_only: HashMap<TransportType, Arc<dyn Transport>> = HashMap::new();
+        udp_only.insert(TransportType::Udp, udp.clone() as Arc<dyn Transport>);
+        let mux =
+            MultiplexedTransport::new(udp.clone() as Arc<dyn Transport>, udp_only, None).unwrap();
+        let result = mux
+            .send_request_cached(&request, &WireCache::new(), dest)
+            .await;
+        assert!(matches!(result, Err(TransportError::MessageTooLarge(_))));
+        assert_eq!(udp.count(), 0);
+    }
 }
@@ -23,8 +23,9 @@ use rvoip_sip_core::types::max_forwards::MaxForwards;
 use rvoip_sip_core::types::status::StatusCode;
 use rvoip_sip_core::types::uri::Uri;
 use rvoip_sip_core::types::via::Via;
+use rvoip_sip_core::types::wire::PreparedMessage;
 use rvoip_sip_core::types::TypedHeader;
-use rvoip_sip_core::{Method, Request, Response};
+use rvoip_sip_core::{Message, Method, Request, Response};
 use rvoip_sip_dialog::transaction::{TransactionEvent, TransactionKey, TransactionManager};
 use tokio::sync::{broadcast, mpsc};
 use tokio::task::JoinHandle;
@@ -588,6 +589,9 @@ impl StatefulProxy {
             self.start_timer_c(upstream_tx_id.clone());
         }
 
+        // Serialize the forwarded request once; every leg shares these
+        // fragments and re-serializes only the Via it pushes.
+        let prepared = PreparedMessage::new(Message::Request(request));
         let leg_count = decision.leg_count();
         match decision.mode {
             ForkMode::Parallel => {
@@ -598,7 +602,7 @@ impl StatefulProxy {
                     let candidates = decision.candidates_for_leg(idx);
                     fork.legs_started
                         .store(idx + 1, std::sync::atomic::Ordering::Release);
-                    if let Err(e) = self.start_leg(&fork, &request, &candidates).await {
+                    if let Err(e) = self.start_leg(&fork, &prepared, &candidates).await {
                         warn!(
                             "proxy: failed to start parallel leg {} (candidates {:?}): {}",
                             idx, candidates, e
@@ -613,7 +617,7 @@ impl StatefulProxy {
                     let candidates = decision.candidates_for_leg(0);
                     fork.legs_started
                         .store(1, std::sync::atomic::Ordering::Release);
-                    self.start_leg(&fork, &request, &candidates).await?;
+                    self.start_leg(&fork, &prepared, &candidates).await?;
                 }
             }
         }
@@ -621,7 +625,7 @@ impl StatefulProxy {
         Ok(())
     }
 
-    /// Push a fresh proxy Via onto `request`, build a downstream client
+    /// Push a fresh proxy Via onto `base`, build a downstream client
     /// transaction targeting one of `candidates`, register the leg
     /// with the fork context, and send the request.
     ///
@@ -633,7 +637,7 @@ impl StatefulProxy {
     async fn start_leg(
         &self,
         fork: &Arc<ForkContext>,
-        base_request: &Request,
+        base: &PreparedMessage,
         candidates: &[SocketAddr],
     ) -> Result<(), ProxyError> {
         if candidates.is_empty() {
@@ -653,20 +657,22 @@ impl StatefulProxy {
 
         for (idx, destination) in candidates.iter().enumerate() {
             let attempt = idx + 1;
-            // Each attempt gets a fresh request clone + fresh proxy
-            // Via with a unique branch so RFC 3261 §16.6 branch
-            // uniqueness holds across the candidate walk.
-            let mut leg_request = base_request.clone();
+            // Each attempt gets a fresh proxy Via with a unique branch
+            // so RFC 3261 §16.6 branch uniqueness holds across the
+            // candidate walk.
             let proxy_branch = format!("z9hG4bK-proxy-{}", uuid::Uuid::new_v4().simple());
-            if let Err(e) = push_proxy_via(&mut leg_request, local_addr, &proxy_branch) {
-                last_err = Some(e);
-                continue;
-            }
+            let leg = match proxy_via(base, local_addr, &proxy_branch) {
+                Ok(via) => base.with_header_on_top(TypedHeader::Via(via)),
+                Err(e) => {
+                    last_err = Some(e);
+                    continue;
+                }
+            };
             self.known_branches.insert(proxy_branch.clone(), ());
 
             let downstream_tx_id = match self
                 .tm
-                .create_client_transaction(leg_request, *destination)
+                .create_client_transaction_prepared(leg, *destination)
                 .await
             {
                 Ok(id) => id,
@@ -884,11 +890,10 @@ impl StatefulProxy {
                         // Spawn the requested legs. Treat each
                         // target as a single-candidate leg under
                         // the requested mode.
+                        let base =
+                            PreparedMessage::new(Message::Request(fork.original_request.clone()));
                         for target in targets {
-                            if let Err(e) = self
-                                .start_leg(fork, &fork.original_request, &[target])
-                                .await
-                            {
+                            if let Err(e) = self.start_leg(fork, &base, &[target]).await {
                                 warn!("proxy: 3xx re-fork start_leg to {} failed: {}", target, e);
                             }
                         }
@@ -958,8 +963,9 @@ impl StatefulProxy {
                     // legs_started was already bumped by fetch_add;
                     // start_leg uses it implicitly via the success
                     // path's existing accounting.
-                    self.start_leg(fork, &fork.original_request, &candidates)
-                        .await?;
+                    let base =
+                        PreparedMessage::new(Message::Request(fork.original_request.clone()));
+                    self.start_leg(fork, &base, &candidates).await?;
                     return Ok(());
                 }
                 // Counter overshot — restore so the value stays
@@ -1224,32 +1230,28 @@ impl StatefulProxy {
     }
 }
 
-fn push_proxy_via(
-    request: &mut Request,
+fn proxy_via(
+    base: &PreparedMessage,
     local_addr: SocketAddr,
     branch: &str,
-) -> Result<(), ProxyError> {
+) -> Result<Via, ProxyError> {
+    let Message::Request(request) = base.message() else {
+        return Err(ProxyError::Transport("proxy Via for a response".into()));
+    };
     let transport = transport_token_for_request(request);
     let host = local_addr.ip().to_string();
     let port = Some(local_addr.port());
 
-    // Build a fresh single-entry Via for the proxy.
+    // Build a fresh single-entry Via for the proxy. The caller inserts it
+    // as a NEW typed-header at the position of the first existing Via,
+    // pushing the UAC's Via down by one. This keeps the proxy and UAC
+    // entries in separate typed-headers so on the response-forwarding
+    // path we can remove the proxy's typed-header wholesale without
+    // leaving an empty Via behind.
     let mut via = Via(Vec::new());
     via.push_proxy_branch(transport, host, port, branch)
         .map_err(|e| ProxyError::Transport(format!("push Via: {}", e)))?;
-
-    // Insert as a NEW typed-header at the position of the first
-    // existing Via, pushing the UAC's Via down by one. This keeps the
-    // proxy and UAC entries in separate typed-headers so on the
-    // response-forwarding path we can remove the proxy's typed-header
-    // wholesale without leaving an empty Via behind.
-    let pos = request
-        .headers
-        .iter()
-        .position(|h| matches!(h, TypedHeader::Via(_)))
-        .unwrap_or(request.headers.len());
-    request.headers.insert(pos, TypedHeader::Via(via));
-    Ok(())
+    Ok(via)
 }
 
 /// Extract every Contact URI from a (typically 3xx) response, in
@@ -0,0 +1,127 @@
+//! Location store recovery time.
+//!
+//! Builds a store of `RVOIP_BENCH_BINDINGS` registrations (default
+//! 1,000,000), snapshots it, and leaves a WAL tail of re-registrations for
+//! a tenth of them, then times opening the store into an empty registry:
+//! mapping and loading the snapshot plus replaying the tail.
+//!
+//! Before the timed group, a one-shot line is printed with the snapshot
+//! size, bytes per binding and the recovery breakdown of a single open.
+
+use chrono::{Duration, Utc};
+use criterion::{criterion_group, Criterion};
+use rvoip_sip_registrar::registrar::{LocationStore, RegistryConfig, UserRegistry};
+use rvoip_sip_registrar::{
+    AddressOfRecord, ContactInfo, ContactReachability, LocationStoreConfig, Transport,
+};
+use std::path::Path;
+use std::sync::Arc;
+
+fn bindings() -> usize {
+    std::env::var("RVOIP_BENCH_BINDINGS")
+        .ok()
+        .and_then(|n| n.parse().ok())
+        .unwrap_or(1_000_000)
+}
+
+fn contact(i: usize) -> ContactInfo {
+    ContactInfo {
+        uri: format!(
+            "sip:user{i}@10.{}.{}.{}:5060",
+            i >> 16 & 255,
+            i >> 8 & 255,
+            i & 255
+        ),
+        instance_id: format!("<urn:uuid:00000000-0000-0000-0000-{i:012}>"),
+        transport: Transport::UDP,
+        user_agent: "bench-ua/1.0".to_string(),
+        expires: Utc::now() + Duration::hours(1),
+        q_value: 1.0,
+        received: None,
+        path: Vec::new(),
+        methods: vec!["INVITE".to_string(), "MESSAGE".to_string()],
+        reg_id: Some(1),
+        flow_id: None,
+        reachability: ContactReachability::Unknown,
+    }
+}
+
+fn empty_registry() -> Arc<UserRegistry> {
+    Arc::new(UserRegistry::with_config(RegistryConfig::default()))
+}
+
+fn config(dir: &Path) -> LocationStoreConfig {
+    let mut config = LocationStoreConfig::new(dir);
+    // No snapshot may start while a recovery is being timed.
+    config.snapshot_interval = 3600;
+    config.sync_interval_ms = 100;
+    config
+}
+
+/// Populate a store in a fresh directory and return its config.
+fn build_store(n: usize) -> LocationStoreConfig {
+    let dir = std::env::temp_dir().join(format!("rvoip-location-bench-{}", std::process::id()));
+    let _ = std::fs::remove_dir_all(&dir);
+    let config = config(&dir);
+    let runtime = tokio::runtime::Builder::new_current_thread()
+        .build()
+        .unwrap();
+    runtime.block_on(async {
+        let registry = empty_registry();
+        let store = LocationStore::open(Arc::clone(&registry), &config).unwrap();
+        for i in 0..n {
+            let aor = AddressOfRecord::parse(&format!("sip:user{i}@example.com")).unwrap();
+            registry.register_aor(&aor, contact(i), 3600).await.unwrap();
+        }
+        store.snapshot().unwrap();
+        for i in (0..n).step_by(10) {
+            let aor = AddressOfRecord::parse(&format!("sip:user{i}@example.com")).unwrap();
+            registry.register_aor(&aor, contact(i), 3600).await.unwrap();
+        }
+        store.sync().unwrap();
+    });
+    config
+}
+
+fn bench_recovery(c: &mut Criterion) {
+    let n = bindings();
+    let config = build_store(n);
+
+    let registry = empty_registry();
+    let store = LocationStore::open(Arc::clone(&registry), &config).unwrap();
+    let stats = store.recovery().clone();
+    drop(store);
+    let snapshot_bytes = std::fs::metadata(config.dir.join("snapshot.bin"))
+        .map(|m| m.len())
+        .unwrap_or(0);
+    println!(
+        "location store: {} bindings, snapshot {:.1} MiB ({} B/binding), \
+         recovered {} snapshot + {} WAL changes in {:?}",
+        stats.keys,
+        snapshot_bytes as f64 / (1024.0 * 1024.0),
+        snapshot_bytes / n.max(1) as u64,
+        stats.snapshot_keys,
+        stats.wal_changes,
+        stats.elapsed
+    );
+    drop(registry);
+
+    let mut group = c.benchmark_group("location_recovery");
+    group.sample_size(10);
+    group.bench_function(format!("{n}_bindings"), |b| {
+        b.iter_with_large_drop(|| {
+            let registry = empty_registry();
+            let store = LocationStore::open(Arc::clone(&registry), &config).unwrap();
+            (store, registry)
+        })
+    });
+    group.finish();
+    let _ = std::fs::remove_dir_all(&config.dir);
+}
+
+criterion_group!(benches, bench_recovery);
+
+fn main() {
+    benches();
+    Criterion::default().configure_from_args().final_summary();
+}
@@ -76,7 +76,7 @@ impl RegistrarService {
 
     /// Create with specific mode and configuration
     pub async fn new_with_mode(mode: ServiceMode, config: RegistrarConfig) -> Result<Self> {
-        let registrar = Arc::new(Registrar::with_config(config.clone()));
+        let registrar = Arc::new(Registrar::open(config.clone())?);
         let presence = Arc::new(Presence::new());
 
         // Start background tasks
@@ -60,7 +60,7 @@ pub enum RegistrarError {
     #[error("Configuration error: {0}")]
     ConfigError(String),
 
-    /// Storage error (for future persistent storage)
+    /// Location store I/O or corrupt on-disk/replicated data
     #[error("Storage error: {0}")]
     StorageError(String),
 
@@ -25,10 +25,11 @@ pub use identity::{
     CredentialProvider, ExternalIdentity, IdentityProvider, IdentitySyncService,
     InMemoryIdentityProvider,
 };
-pub use registrar::{Registrar, UserCredentials, UserStore};
+pub use registrar::{HotStandby, LocationStore, Registrar, UserCredentials, UserStore};
 pub use types::{
-    AddressOfRecord, BasicStatus, ContactInfo, ContactReachability, ExtendedStatus, PresenceState,
-    PresenceStatus, RegistrarConfig, Subscription, SubscriptionState, Transport, UserRegistration,
+    AddressOfRecord, BasicStatus, ContactInfo, ContactReachability, ExtendedStatus,
+    LocationStoreConfig, PresenceState, PresenceStatus, RegistrarConfig, Subscription,
+    SubscriptionState, Transport, UserRegistration,
 };
 
 // Version information
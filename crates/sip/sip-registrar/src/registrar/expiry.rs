@@ -0,0 +1,135 @@
+//! Expiry index for registration bindings.
+//!
+//! Every AoR is filed under the first whole second at or after the expiry
+//! of its earliest contact, in per-second buckets spread over independently
+//! locked shards. A sweep detaches the buckets that are due and hands back the keys
+//! they held, so expiring bindings touches only the AoRs that are due rather
+//! than the whole registry. Entries are never removed in place: the registry
+//! remembers which second it last filed each AoR under and skips entries
+//! that no longer match, and an AoR whose contacts were refreshed since it
+//! was filed is simply checked once and filed again.
+
+use chrono::{DateTime, Utc};
+use std::collections::hash_map::RandomState;
+use std::collections::BTreeMap;
+use std::hash::BuildHasher;
+use std::sync::{Arc, Mutex};
+
+/// Bucket second of an AoR that is not filed anywhere.
+pub(super) const UNFILED: i64 = i64::MAX;
+
+pub(super) struct ExpiryIndex {
+    shards: Box<[Mutex<BTreeMap<i64, Vec<Arc<str>>>>]>,
+    hasher: RandomState,
+}
+
+impl ExpiryIndex {
+    pub(super) fn new() -> Self {
+        let shards = std::thread::available_parallelism()
+            .map(|n| n.get() * 4)
+            .unwrap_or(16)
+            .next_power_of_two();
+        Self {
+            shards: (0..shards).map(|_| Mutex::default()).collect(),
+            hasher: RandomState::new(),
+        }
+    }
+
+    /// File `key` under bucket `second`.
+    pub(super) fn file(&self, key: &Arc<str>, second: i64) {
+        let shard = self.hasher.hash_one(&**key) as usize & (self.shards.len() - 1);
+        self.shards[shard]
+            .lock()
+            .unwrap_or_else(|poisoned| poisoned.into_inner())
+            .entry(second)
+            .or_default()
+            .push(Arc::clone(key));
+    }
+
+    /// Detach every bucket at or before `now` (a Unix second) and return
+    /// its entries as `(second, key)`.
+    pub(super) fn take_due(&self, now: i64) -> Vec<(i64, Arc<str>)> {
+        let mut due = Vec::new();
+        for shard in self.shards.iter() {
+            let mut buckets = shard
+                .lock()
+                .unwrap_or_else(|poisoned| poisoned.into_inner());
+            while let Some(bucket) = buckets.first_entry() {
+                if *bucket.key() > now {
+                    break;
+                }
+                let (second, keys) = bucket.remove_entry();
+                due.extend(keys.into_iter().map(|key| (second, key)));
+            }
+        }
+        due
+    }
+
+    /// Filed entries, stale ones included.
+    #[cfg(test)]
+    pub(super) fn len(&self) -> usize {
+        self.shards
+            .iter()
+            .map(|shard| {
+                shard
+                    .lock()
+                    .unwrap_or_else(|poisoned| poisoned.into_inner())
+                    .values()
+                    .map(Vec::len)
+                    .sum::<usize>()
+            })
+            .sum()
+    }
+}
+
+impl std::fmt::Debug for ExpiryIndex {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("ExpiryIndex")
+            .field("shards", &self.shards.len())
+            .finish()
+    }
+}
+
+/// Bucket for a contact expiring at `expires`: its Unix second rounded up,
+/// so a bucket is only due once everything filed under it has expired.
+pub(super) fn bucket_of(expires: DateTime<Utc>) -> i64 {
+    let second = expires.timestamp();
+    if expires.timestamp_subsec_nanos() > 0 {
+        second + 1
+    } else {
+        second
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use chrono::Duration;
+
+    #[test]
+    fn takes_only_due_buckets() {
+        let index = ExpiryIndex::new();
+        let alice: Arc<str> = Arc::from("sip:alice@example.com");
+        let bob: Arc<str> = Arc::from("sip:bob@example.com");
+        index.file(&alice, 100);
+        index.file(&bob, 105);
+        index.file(&alice, 110);
+        assert_eq!(index.len(), 3);
+
+        assert!(index.take_due(99).is_empty());
+        let due = index.take_due(105);
+        assert_eq!(due.len(), 2);
+        assert!(due.contains(&(100, alice.clone())));
+        assert!(due.contains(&(105, bob)));
+        assert_eq!(index.take_due(109).len(), 0);
+        assert_eq!(index.take_due(110), vec![(110, alice)]);
+        assert_eq!(index.len(), 0);
+    }
+
+    #[test]
+    fn buckets_round_up_to_the_next_second() {
+        let whole = DateTime::from_timestamp(1_000, 0).unwrap();
+        assert_eq!(bucket_of(whole), 1_000);
+        assert_eq!(bucket_of(whole + Duration::milliseconds(1)), 1_001);
+    }
+}
@@ -9,14 +9,24 @@ use tracing::{debug, info};
 /// Manages registration lifecycle and expiry
 pub struct RegistrationManager {
     registry: Arc<UserRegistry>,
+    interval: Duration,
     running: Arc<RwLock<bool>>,
     handle: Arc<RwLock<Option<tokio::task::JoinHandle<()>>>>,
 }
 
+/// Default expiry sweep cadence, matching `RegistrarConfig::default()`.
+pub const DEFAULT_EXPIRY_CHECK_INTERVAL: Duration = Duration::from_secs(1);
+
 impl RegistrationManager {
     pub fn new(registry: Arc<UserRegistry>) -> Self {
+        Self::with_interval(registry, DEFAULT_EXPIRY_CHECK_INTERVAL)
+    }
+
+    /// Manager that sweeps for expired bindings every `interval`.
+    pub fn with_interval(registry: Arc<UserRegistry>, interval: Duration) -> Self {
         Self {
             registry,
+            interval,
             running: Arc::new(RwLock::new(false)),
             handle: Arc::new(RwLock::new(None)),
         }
@@ -33,9 +43,10 @@ impl RegistrationManager {
         *running = true;
         let registry = self.registry.clone();
         let running_flag = self.running.clone();
+        let period = self.interval;
 
         let handle = tokio::spawn(async move {
-            let mut ticker = interval(Duration::from_secs(30));
+            let mut ticker = interval(period);
 
             while *running_flag.read().await {
                 ticker.tick().await;
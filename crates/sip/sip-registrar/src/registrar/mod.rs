@@ -5,15 +5,20 @@ use crate::types::{
     AddressOfRecord, ContactInfo, ContactReachability, RegistrarConfig, UserRegistration,
 };
 use dashmap::DashMap;
-use std::sync::Arc;
+use std::sync::{Arc, Mutex};
+use std::time::Duration;
+use tracing::info;
 
+mod expiry;
 pub mod location;
 pub mod manager;
+pub mod persistence;
 pub mod registry;
 pub mod user_store;
 
 pub use location::LocationService;
 pub use manager::RegistrationManager;
+pub use persistence::{HotStandby, LocationStore, RecoveryStats, WalStats};
 pub use registry::{RegistryConfig, UserRegistry};
 pub use user_store::{UserCredentials, UserStore};
 
@@ -23,6 +28,8 @@ pub struct Registrar {
     location: Arc<LocationService>,
     manager: Arc<RegistrationManager>,
     domain_aliases: Arc<DashMap<String, String>>,
+    standby: Mutex<Option<HotStandby>>,
+    location_store: Option<LocationStore>,
 }
 
 impl Registrar {
@@ -33,13 +40,63 @@ impl Registrar {
     pub fn with_config(config: RegistrarConfig) -> Self {
         let registry = Arc::new(UserRegistry::with_config(RegistryConfig::from(&config)));
         let location = Arc::new(LocationService::new(registry.clone()));
-        let manager = Arc::new(RegistrationManager::new(registry.clone()));
+        let manager = Arc::new(RegistrationManager::with_interval(
+            registry.clone(),
+            Duration::from_secs(config.expiry_check_interval.max(1)),
+        ));
 
         Self {
             registry,
             location,
             manager,
             domain_aliases: Arc::new(DashMap::new()),
+            standby: Mutex::new(None),
+            location_store: None,
+        }
+    }
+
+    /// Create a registrar and, if `config.location_store` is set, recover
+    /// its bindings from disk, journal every later change and start
+    /// following the configured primary.
+    pub fn open(config: RegistrarConfig) -> Result<Self> {
+        let store_config = config.location_store.clone();
+        let mut registrar = Self::with_config(config);
+        if let Some(store_config) = store_config {
+            registrar.location_store = Some(LocationStore::open(
+                registrar.registry.clone(),
+                &store_config,
+            )?);
+            if let Some(primary) = store_config.replicate_from {
+                *registrar.standby.get_mut().unwrap() =
+                    Some(HotStandby::follow(registrar.registry.clone(), primary)?);
+            }
+        }
+        Ok(registrar)
+    }
+
+    pub fn location_store(&self) -> Option<&LocationStore> {
+        self.location_store.as_ref()
+    }
+
+    /// Whether this registrar follows a primary and has caught up with it.
+    pub fn is_standby_synced(&self) -> bool {
+        self.standby
+            .lock()
+            .unwrap()
+            .as_ref()
+            .is_some_and(HotStandby::is_synced)
+    }
+
+    /// Stop following the primary so this registrar serves on its own.
+    /// Returns false if it was not a standby.
+    pub fn promote(&self) -> bool {
+        match self.standby.lock().unwrap().take() {
+            Some(standby) => {
+                standby.promote();
+                info!("Registrar promoted from standby");
+                true
+            }
+            None => false,
         }
     }
 
@@ -241,4 +298,24 @@ mod tests {
 
         assert!(registrar.lookup_user("alice").await.is_err());
     }
+
+    #[tokio::test]
+    async fn default_expiry_manager_reaps_bindings_promptly() {
+        let registrar = Registrar::with_config(RegistrarConfig {
+            min_expires: 1,
+            ..RegistrarConfig::default()
+        });
+        registrar.start_expiry_manager().await;
+        registrar
+            .register_user("alice", contact("sip:alice@127.0.0.1:5071"), 1)
+            .await
+            .unwrap();
+        assert!(registrar.is_registered("alice").await);
+
+        // Expiry at most a second out, rounded up to the next bucket, plus
+        // one sweep interval.
+        tokio::time::sleep(std::time::Duration::from_millis(3500)).await;
+        assert!(!registrar.is_registered("alice").await);
+        registrar.stop_expiry_manager().await;
+    }
 }
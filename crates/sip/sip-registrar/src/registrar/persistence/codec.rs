@@ -0,0 +1,364 @@
+//! Binary encoding of binding records, shared by the WAL, snapshots and the
+//! replication stream.
+//!
+//! A record is the whole state of one key, so applying records in order is
+//! idempotent and a fuzzy snapshot plus the log after it replays to the
+//! right state. Lengths and counts are LEB128 varints, instants are Unix
+//! milliseconds, and strings are UTF-8.
+//!
+//! ```text
+//! change   = op:u8 (1 put, 2 remove, 3 synced) key [bindings]
+//! bindings = flags:u8 registered_at:i64 count:varint contact*
+//! contact  = uri instance_id transport:u8 user_agent expires:i64 q:f32
+//!            received:opt path:strs methods:strs reg_id:opt-u32
+//!            flow_id:opt reachability:u8
+//! ```
+
+use super::super::expiry::UNFILED;
+use super::super::registry::Bindings;
+use crate::error::{RegistrarError, Result};
+use crate::types::{ContactInfo, ContactReachability, Transport};
+use chrono::{DateTime, Utc};
+
+const OP_PUT: u8 = 1;
+const OP_REMOVE: u8 = 2;
+const OP_SYNCED: u8 = 3;
+
+const FLAG_KEYED_BY_AOR: u8 = 1;
+
+/// A decoded change record.
+pub(super) enum Change<'a> {
+    /// `key` now holds exactly these bindings.
+    Put { key: &'a str, bindings: Bindings },
+    /// `key` has no bindings.
+    Remove { key: &'a str },
+    /// Replication only: the initial state transfer is complete.
+    Synced,
+}
+
+pub(super) fn encode_put(buf: &mut Vec<u8>, key: &str, bindings: &Bindings) {
+    buf.push(OP_PUT);
+    encode_bindings(buf, key, bindings);
+}
+
+pub(super) fn encode_remove(buf: &mut Vec<u8>, key: &str) {
+    buf.push(OP_REMOVE);
+    put_str(buf, key);
+}
+
+pub(super) fn encode_synced(buf: &mut Vec<u8>) {
+    buf.push(OP_SYNCED);
+}
+
+/// Encode `key` and its bindings, as stored in a snapshot.
+pub(super) fn encode_bindings(buf: &mut Vec<u8>, key: &str, bindings: &Bindings) {
+    put_str(buf, key);
+    buf.push(if bindings.keyed_by_aor {
+        FLAG_KEYED_BY_AOR
+    } else {
+        0
+    });
+    buf.extend_from_slice(&bindings.registered_at.timestamp_millis().to_le_bytes());
+    put_varint(buf, bindings.contacts.len() as u64);
+    for contact in &bindings.contacts {
+        encode_contact(buf, contact);
+    }
+}
+
+pub(super) fn decode_change(payload: &[u8]) -> Result<Change<'_>> {
+    let mut reader = Reader::new(payload);
+    let change = match reader.u8()? {
+        OP_PUT => {
+            let (key, bindings) = decode_bindings_from(&mut reader)?;
+            Change::Put { key, bindings }
+        }
+        OP_REMOVE => Change::Remove { key: reader.str()? },
+        OP_SYNCED => Change::Synced,
+        op => return Err(corrupt(&format!("unknown change op {op}"))),
+    };
+    reader.finish()?;
+    Ok(change)
+}
+
+/// Decode a snapshot record written by [`encode_bindings`].
+pub(super) fn decode_bindings(record: &[u8]) -> Result<(&str, Bindings)> {
+    let mut reader = Reader::new(record);
+    let decoded = decode_bindings_from(&mut reader)?;
+    reader.finish()?;
+    Ok(decoded)
+}
+
+fn decode_bindings_from<'a>(reader: &mut Reader<'a>) -> Result<(&'a str, Bindings)> {
+    let key = reader.str()?;
+    let flags = reader.u8()?;
+    let registered_at = reader.instant()?;
+    let count = reader.count()?;
+    let mut contacts = Vec::with_capacity(count);
+    for _ in 0..count {
+        contacts.push(decode_contact(reader)?);
+    }
+    Ok((
+        key,
+        Bindings {
+            keyed_by_aor: flags & FLAG_KEYED_BY_AOR != 0,
+            contacts,
+            registered_at,
+            filed_under: UNFILED,
+        },
+    ))
+}
+
+fn encode_contact(buf: &mut Vec<u8>, contact: &ContactInfo) {
+    put_str(buf, &contact.uri);
+    put_str(buf, &contact.instance_id);
+    buf.push(transport_code(contact.transport));
+    put_str(buf, &contact.user_agent);
+    buf.extend_from_slice(&contact.expires.timestamp_millis().to_le_bytes());
+    buf.extend_from_slice(&contact.q_value.to_le_bytes());
+    put_opt_str(buf, contact.received.as_deref());
+    put_strs(buf, &contact.path);
+    put_strs(buf, &contact.methods);
+    match contact.reg_id {
+        Some(reg_id) => {
+            buf.push(1);
+            buf.extend_from_slice(&reg_id.to_le_bytes());
+        }
+        None => buf.push(0),
+    }
+    put_opt_str(buf, contact.flow_id.as_deref());
+    buf.push(match contact.reachability {
+        ContactReachability::Unknown => 0,
+        ContactReachability::Reachable => 1,
+        ContactReachability::Unreachable => 2,
+    });
+}
+
+fn decode_contact(reader: &mut Reader<'_>) -> Result<ContactInfo> {
+    Ok(ContactInfo {
+        uri: reader.str()?.to_string(),
+        instance_id: reader.str()?.to_string(),
+        transport: transport_from_code(reader.u8()?)?,
+        user_agent: reader.str()?.to_string(),
+        expires: reader.instant()?,
+        q_value: f32::from_le_bytes(reader.array()?),
+        received: reader.opt_str()?,
+        path: reader.strs()?,
+        methods: reader.strs()?,
+        reg_id: match reader.u8()? {
+            0 => None,
+            _ => Some(u32::from_le_bytes(reader.array()?)),
+        },
+        flow_id: reader.opt_str()?,
+        reachability: match reader.u8()? {
+            1 => ContactReachability::Reachable,
+            2 => ContactReachability::Unreachable,
+            _ => ContactReachability::Unknown,
+        },
+    })
+}
+
+fn transport_code(transport: Transport) -> u8 {
+    match transport {
+        Transport::UDP => 0,
+        Transport::TCP => 1,
+        Transport::TLS => 2,
+        Transport::WS => 3,
+        Transport::WSS => 4,
+        Transport::SCTP => 5,
+    }
+}
+
+fn transport_from_code(code: u8) -> Result<Transport> {
+    Ok(match code {
+        0 => Transport::UDP,
+        1 => Transport::TCP,
+        2 => Transport::TLS,
+        3 => Transport::WS,
+        4 => Transport::WSS,
+        5 => Transport::SCTP,
+        _ => return Err(corrupt(&format!("unknown transport {code}"))),
+    })
+}
+
+pub(super) fn put_varint(buf: &mut Vec<u8>, mut value: u64) {
+    while value >= 0x80 {
+        buf.push(value as u8 | 0x80);
+        value >>= 7;
+    }
+    buf.push(value as u8);
+}
+
+fn put_str(buf: &mut Vec<u8>, value: &str) {
+    put_varint(buf, value.len() as u64);
+    buf.extend_from_slice(value.as_bytes());
+}
+
+fn put_opt_str(buf: &mut Vec<u8>, value: Option<&str>) {
+    match value {
+        Some(value) => {
+            buf.push(1);
+            put_str(buf, value);
+        }
+        None => buf.push(0),
+    }
+}
+
+fn put_strs(buf: &mut Vec<u8>, values: &[String]) {
+    put_varint(buf, values.len() as u64);
+    for value in values {
+        put_str(buf, value);
+    }
+}
+
+pub(super) fn corrupt(what: &str) -> RegistrarError {
+    RegistrarError::StorageError(format!("corrupt location record: {what}"))
+}
+
+/// Cursor over an encoded record.
+pub(super) struct Reader<'a> {
+    buf: &'a [u8],
+    pos: usize,
+}
+
+impl<'a> Reader<'a> {
+    pub(super) fn new(buf: &'a [u8]) -> Self {
+        Self { buf, pos: 0 }
+    }
+
+    pub(super) fn remaining(&self) -> usize {
+        self.buf.len() - self.pos
+    }
+
+    pub(super) fn bytes(&mut self, len: usize) -> Result<&'a [u8]> {
+        if self.remaining() < len {
+            return Err(corrupt("truncated"));
+        }
+        let bytes = &self.buf[self.pos..self.pos + len];
+        self.pos += len;
+        Ok(bytes)
+    }
+
+    fn array<const N: usize>(&mut self) -> Result<[u8; N]> {
+        let mut out = [0u8; N];
+        out.copy_from_slice(self.bytes(N)?);
+        Ok(out)
+    }
+
+    fn u8(&mut self) -> Result<u8> {
+        Ok(self.bytes(1)?[0])
+    }
+
+    pub(super) fn varint(&mut self) -> Result<u64> {
+        let mut value = 0u64;
+        for shift in (0..64).step_by(7) {
+            let byte = self.u8()?;
+            value |= u64::from(byte & 0x7f) << shift;
+            if byte & 0x80 == 0 {
+                return Ok(value);
+            }
+        }
+        Err(corrupt("varint overflow"))
+    }
+
+    /// A count of items that each take at least one byte.
+    fn count(&mut self) -> Result<usize> {
+        let count = self.varint()?;
+        if count > self.remaining() as u64 {
+            return Err(corrupt("count exceeds record"));
+        }
+        Ok(count as usize)
+    }
+
+    fn str(&mut self) -> Result<&'a str> {
+        let len = self.count()?;
+        std::str::from_utf8(self.bytes(len)?).map_err(|_| corrupt("invalid UTF-8"))
+    }
+
+    fn opt_str(&mut self) -> Result<Option<String>> {
+        Ok(match self.u8()? {
+            0 => None,
+            _ => Some(self.str()?.to_string()),
+        })
+    }
+
+    fn strs(&mut self) -> Result<Vec<String>> {
+        let count = self.count()?;
+        let mut values = Vec::with_capacity(count);
+        for _ in 0..count {
+            values.push(self.str()?.to_string());
+        }
+        Ok(values)
+    }
+
+    fn instant(&mut self) -> Result<DateTime<Utc>> {
+        let millis = i64::from_le_bytes(self.array()?);
+        DateTime::from_timestamp_millis(millis).ok_or_else(|| corrupt("instant out of range"))
+    }
+
+    fn finish(&self) -> Result<()> {
+        if self.remaining() == 0 {
+            Ok(())
+        } else {
+            Err(corrupt("trailing bytes"))
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use chrono::Duration;
+
+    fn bindings() -> Bindings {
+        let now = DateTime::from_timestamp_millis(Utc::now().timestamp_millis()).unwrap();
+        Bindings {
+            keyed_by_aor: true,
+            contacts: vec![ContactInfo {
+                uri: "sip:alice@192.0.2.10:5060".to_string(),
+                instance_id: "<urn:uuid:00000000-0000-0000-0000-000000000001>".to_string(),
+                transport: Transport::TLS,
+                user_agent: "Test UA".to_string(),
+                expires: now + Duration::seconds(300),
+                q_value: 0.7,
+                received: Some("198.51.100.4:41000".to_string()),
+                path: vec!["<sip:edge.example.com;lr>".to_string()],
+                methods: vec!["INVITE".to_string(), "MESSAGE".to_string()],
+                reg_id: Some(2),
+                flow_id: None,
+                reachability: ContactReachability::Reachable,
+            }],
+            registered_at: now,
+            filed_under: UNFILED,
+        }
+    }
+
+    #[test]
+    fn put_round_trips() {
+        let original = bindings();
+        let mut buf = Vec::new();
+        encode_put(&mut buf, "sip:alice@example.com", &original);
+        let Change::Put { key, bindings } = decode_change(&buf).unwrap() else {
+            panic!("expected a put");
+        };
+        assert_eq!(key, "sip:alice@example.com");
+        assert!(bindings.keyed_by_aor);
+        assert_eq!(bindings.registered_at, original.registered_at);
+        assert_eq!(bindings.contacts, original.contacts);
+    }
+
+    #[test]
+    fn remove_round_trips_and_truncation_is_rejected() {
+        let mut buf = Vec::new();
+        encode_remove(&mut buf, "bob");
+        assert!(matches!(
+            decode_change(&buf).unwrap(),
+            Change::Remove { key: "bob" }
+        ));
+
+        let mut buf = Vec::new();
+        encode_put(&mut buf, "alice", &bindings());
+        for len in 0..buf.len() {
+            assert!(decode_change(&buf[..len]).is_err(), "prefix {len} decoded");
+        }
+    }
+}
@@ -0,0 +1,103 @@
+//! Read-only file mapping for snapshot recovery.
+//!
+//! Recovery walks a snapshot once from front to back, so the file is
+//! mapped rather than read into a buffer and the kernel is told to read
+//! ahead. Platforms without `mmap` fall back to reading the file.
+
+use std::fs::File;
+use std::io;
+use std::ops::Deref;
+
+pub(super) struct Mapped {
+    #[cfg(unix)]
+    ptr: *const u8,
+    #[cfg(unix)]
+    len: usize,
+    #[cfg(not(unix))]
+    data: Vec<u8>,
+}
+
+// SAFETY: the mapping is read-only and private; it is only ever read.
+#[cfg(unix)]
+unsafe impl Send for Mapped {}
+#[cfg(unix)]
+unsafe impl Sync for Mapped {}
+
+impl Mapped {
+    /// Map all of `file`. The file must not be truncated while mapped;
+    /// snapshots are only ever replaced by rename, never rewritten.
+    #[cfg(unix)]
+    pub(super) fn open(file: &File) -> io::Result<Self> {
+        use std::os::fd::AsRawFd;
+
+        let len = usize::try_from(file.metadata()?.len())
+            .map_err(|_| io::Error::new(io::ErrorKind::InvalidData, "snapshot too large"))?;
+        if len == 0 {
+            return Ok(Self {
+                ptr: std::ptr::NonNull::<u8>::dangling().as_ptr(),
+                len: 0,
+            });
+        }
+        // SAFETY: mapping a valid descriptor read-only; the result is
+        // checked before use and unmapped exactly once in `drop`.
+        let ptr = unsafe {
+            libc::mmap(
+                std::ptr::null_mut(),
+                len,
+                libc::PROT_READ,
+                libc::MAP_PRIVATE,
+                file.as_raw_fd(),
+                0,
+            )
+        };
+        if ptr == libc::MAP_FAILED {
+            return Err(io::Error::last_os_error());
+        }
+        // SAFETY: `ptr`/`len` describe the mapping created above. Advice
+        // is best effort.
+        unsafe {
+            libc::madvise(ptr, len, libc::MADV_SEQUENTIAL);
+        }
+        Ok(Self {
+            ptr: ptr as *const u8,
+            len,
+        })
+    }
+
+    #[cfg(not(unix))]
+    pub(super) fn open(file: &File) -> io::Result<Self> {
+        use std::io::Read;
+
+        let mut data = Vec::new();
+        (&*file).read_to_end(&mut data)?;
+        Ok(Self { data })
+    }
+}
+
+impl Deref for Mapped {
+    type Target = [u8];
+
+    #[cfg(unix)]
+    fn deref(&self) -> &[u8] {
+        // SAFETY: the mapping is `len` readable bytes and lives as long as
+        // `self` (or is empty with a dangling, aligned pointer).
+        unsafe { std::slice::from_raw_parts(self.ptr, self.len) }
+    }
+
+    #[cfg(not(unix))]
+    fn deref(&self) -> &[u8] {
+        &self.data
+    }
+}
+
+#[cfg(unix)]
+impl Drop for Mapped {
+    fn drop(&mut self) {
+        if self.len > 0 {
+            // SAFETY: unmapping the region mapped in `open`.
+            unsafe {
+                libc::munmap(self.ptr as *mut libc::c_void, self.len);
+            }
+        }
+    }
+}
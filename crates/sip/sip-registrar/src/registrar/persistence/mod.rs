@@ -0,0 +1,431 @@
+//! Durable, replicated location store.
+//!
+//! The registry stays the in-memory source of truth for lookups; this module
+//! makes it survive restarts. Every binding change is appended to a
+//! write-ahead log by a group-committing writer thread, a snapshot of the
+//! whole registry is written periodically so the log stays short, and the
+//! log can be streamed to a hot standby. On startup the snapshot is mapped
+//! and loaded, then the log after it is replayed.
+
+mod codec;
+mod mmap;
+mod replication;
+mod snapshot;
+mod wal;
+
+pub use replication::HotStandby;
+pub(super) use wal::Journal;
+
+use self::replication::ReplicationServer;
+use self::wal::{Command, SyncPolicy, WalHealth, Writer};
+use super::registry::UserRegistry;
+use crate::error::{RegistrarError, Result};
+use crate::types::LocationStoreConfig;
+use chrono::Utc;
+use std::net::SocketAddr;
+use std::path::{Path, PathBuf};
+use std::sync::atomic::Ordering;
+use std::sync::mpsc::{self, RecvTimeoutError, Sender};
+use std::sync::{Arc, Mutex};
+use std::thread::JoinHandle;
+use std::time::{Duration, Instant};
+use tracing::{error, info};
+
+/// What startup recovery loaded.
+#[derive(Debug, Clone, Default)]
+pub struct RecoveryStats {
+    /// Keys read from the snapshot.
+    pub snapshot_keys: u64,
+    /// WAL changes replayed on top of the snapshot.
+    pub wal_changes: u64,
+    /// Keys bound once recovery finished; expired contacts are dropped.
+    pub keys: usize,
+    pub elapsed: Duration,
+}
+
+/// Write-ahead log health. Journaling does not wait for the disk, so a
+/// failed write shows up here rather than at the change that caused it.
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct WalStats {
+    /// Batches of changes that could not be written or synced.
+    pub write_errors: u64,
+    /// Last change that may be missing from disk after a failed write, or
+    /// 0. The next snapshot that covers it clears it.
+    pub unlogged_through: u64,
+    /// Standbys disconnected for falling a full backlog behind.
+    pub dropped_standbys: u64,
+}
+
+impl WalStats {
+    /// Whether every change journaled so far is on disk or in a snapshot.
+    pub fn is_healthy(&self) -> bool {
+        self.unlogged_through == 0
+    }
+}
+
+/// A [`UserRegistry`] backed by a snapshot and write-ahead log on disk.
+///
+/// Dropping the store syncs the log and stops its threads; changes made
+/// afterwards are no longer persisted.
+pub struct LocationStore {
+    inner: Arc<Inner>,
+    writer: Option<JoinHandle<()>>,
+    snapshotter: Option<(Sender<()>, JoinHandle<()>)>,
+    replication: Option<ReplicationServer>,
+    recovery: RecoveryStats,
+}
+
+struct Inner {
+    dir: PathBuf,
+    registry: Arc<UserRegistry>,
+    wal: Sender<Command>,
+    health: Arc<WalHealth>,
+    /// Serialises snapshots.
+    snapshotting: Mutex<()>,
+}
+
+impl LocationStore {
+    /// Recover `registry` from `config.dir` and journal every later change.
+    /// The registry must be empty.
+    pub fn open(registry: Arc<UserRegistry>, config: &LocationStoreConfig) -> Result<Self> {
+        if !registry.is_empty() {
+            return Err(RegistrarError::StorageError(
+                "location store must be opened on an empty registry".to_string(),
+            ));
+        }
+        std::fs::create_dir_all(&config.dir)?;
+        let dir = config.dir.as_path();
+        let recovery = recover(dir, &registry)?;
+        info!(
+            "Recovered {} registrations from {} ({} snapshot, {} WAL changes) in {:?}",
+            recovery.stats.keys,
+            dir.display(),
+            recovery.stats.snapshot_keys,
+            recovery.stats.wal_changes,
+            recovery.stats.elapsed
+        );
+
+        let policy = match config.sync_interval_ms {
+            0 => SyncPolicy::EveryBatch,
+            ms => SyncPolicy::Interval(Duration::from_millis(ms)),
+        };
+        let next_seq = recovery.last_seq + 1;
+        let (tx, rx) = mpsc::channel();
+        let health = Arc::new(WalHealth::default());
+        let writer = Writer::create(dir, next_seq, policy, Arc::clone(&health))?.spawn(rx)?;
+        // Attached only now, so recovery itself is not journaled again.
+        registry.attach_journal(Journal::new(tx.clone()))?;
+
+        let inner = Arc::new(Inner {
+            dir: dir.to_path_buf(),
+            registry: Arc::clone(&registry),
+            wal: tx.clone(),
+            health,
+            snapshotting: Mutex::new(()),
+        });
+        let mut store = Self {
+            inner,
+            writer: Some(writer),
+            snapshotter: None,
+            replication: None,
+            recovery: recovery.stats,
+        };
+        store.snapshotter = Some(spawn_snapshotter(
+            Arc::clone(&store.inner),
+            Duration::from_secs(config.snapshot_interval.max(1)),
+        )?);
+        if let Some(listen) = config.replication_listen {
+            store.replication = Some(ReplicationServer::start(listen, registry, tx)?);
+        }
+        Ok(store)
+    }
+
+    pub fn recovery(&self) -> &RecoveryStats {
+        &self.recovery
+    }
+
+    /// Address standbys connect to, if replication is enabled.
+    pub fn replication_addr(&self) -> Option<SocketAddr> {
+        self.replication.as_ref().map(ReplicationServer::local_addr)
+    }
+
+    /// Write a snapshot now and delete the WAL segments it covers. Returns
+    /// the number of keys written.
+    pub fn snapshot(&self) -> Result<u64> {
+        self.inner.snapshot()
+    }
+
+    /// Write-ahead log failures since the store was opened.
+    pub fn wal_stats(&self) -> WalStats {
+        let health = &self.inner.health;
+        WalStats {
+            write_errors: health.write_errors.load(Ordering::Relaxed),
+            unlogged_through: health.unlogged_through.load(Ordering::Acquire),
+            dropped_standbys: health.dropped_standbys.load(Ordering::Relaxed),
+        }
+    }
+
+    /// Flush and sync every change journaled so far.
+    pub fn sync(&self) -> Result<()> {
+        self.inner.request(Command::Sync).map(|_| ())
+    }
+}
+
+impl Drop for LocationStore {
+    fn drop(&mut self) {
+        self.replication.take();
+        if let Some((stop, thread)) = self.snapshotter.take() {
+            drop(stop);
+            let _ = thread.join();
+        }
+        let _ = self.inner.wal.send(Command::Shutdown);
+        if let Some(writer) = self.writer.take() {
+            let _ = writer.join();
+        }
+    }
+}
+
+impl Inner {
+    fn request(
+        &self,
+        command: impl FnOnce(mpsc::SyncSender<Result<u64>>) -> Command,
+    ) -> Result<u64> {
+        let stopped = || RegistrarError::StorageError("location WAL stopped".to_string());
+        let (reply, result) = mpsc::sync_channel(1);
+        self.wal.send(command(reply)).map_err(|_| stopped())?;
+        result.recv().map_err(|_| stopped())?
+    }
+
+    fn snapshot(&self) -> Result<u64> {
+        let _guard = self
+            .snapshotting
+            .lock()
+            .unwrap_or_else(|poisoned| poisoned.into_inner());
+        let started = Instant::now();
+        let covered_seq = self.request(Command::Rotate)?;
+        let count = snapshot::write(&self.dir, &self.registry, covered_seq)?;
+        self.health.covered(covered_seq);
+        wal::remove_covered(&self.dir, covered_seq)?;
+        info!(
+            "Location snapshot of {} registrations through change {} took {:?}",
+            count,
+            covered_seq,
+            started.elapsed()
+        );
+        Ok(count)
+    }
+}
+
+fn spawn_snapshotter(
+    inner: Arc<Inner>,
+    interval: Duration,
+) -> Result<(Sender<()>, JoinHandle<()>)> {
+    let (stop, stopped) = mpsc::channel::<()>();
+    let thread = std::thread::Builder::new()
+        .name("registrar-snapshot".to_string())
+        .spawn(move || loop {
+            match stopped.recv_timeout(interval) {
+                Err(RecvTimeoutError::Timeout) => {
+                    if let Err(e) = inner.snapshot() {
+                        error!("Location snapshot failed: {}", e);
+                    }
+                }
+                _ => return,
+            }
+        })?;
+    Ok((stop, thread))
+}
+
+struct Recovered {
+    stats: RecoveryStats,
+    last_seq: u64,
+}
+
+fn recover(dir: &Path, registry: &UserRegistry) -> Result<Recovered> {
+    let started = Instant::now();
+    let now = Utc::now();
+    let mut stats = RecoveryStats::default();
+    let mut covered_seq = 0;
+    if let Some(snapshot) = snapshot::Snapshot::open(dir)? {
+        snapshot.for_each(|key, bindings| registry.restore(key, bindings, now))?;
+        covered_seq = snapshot.covered_seq;
+        stats.snapshot_keys = snapshot.count;
+    }
+    let last_seq = wal::replay(dir, covered_seq, |_, payload| {
+        match codec::decode_change(payload)? {
+            codec::Change::Put { key, bindings } => registry.restore(key, bindings, now),
+            codec::Change::Remove { key } => registry.forget(key),
+            codec::Change::Synced => {}
+        }
+        stats.wal_changes += 1;
+        Ok(())
+    })?;
+    stats.keys = registry.len();
+    stats.elapsed = started.elapsed();
+    Ok(Recovered { stats, last_seq })
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::registrar::registry::RegistryConfig;
+    use crate::types::{AddressOfRecord, ContactInfo, ContactReachability, Transport};
+    use std::io::{BufReader, Read};
+    use std::net::TcpStream;
+
+    fn temp_dir(name: &str) -> PathBuf {
+        let dir = std::env::temp_dir().join(format!(
+            "rvoip-location-{}-{}-{}",
+            name,
+            std::process::id(),
+            Utc::now().timestamp_nanos_opt().unwrap_or_default()
+        ));
+        std::fs::create_dir_all(&dir).unwrap();
+        dir
+    }
+
+    fn contact(uri: &str) -> ContactInfo {
+        ContactInfo {
+            uri: uri.to_string(),
+            instance_id: String::new(),
+            transport: Transport::UDP,
+            user_agent: "test".to_string(),
+            expires: Utc::now(),
+            q_value: 1.0,
+            received: None,
+            path: Vec::new(),
+            methods: vec!["INVITE".to_string()],
+            reg_id: None,
+            flow_id: None,
+            reachability: ContactReachability::Unknown,
+        }
+    }
+
+    fn empty_registry() -> Arc<UserRegistry> {
+        Arc::new(UserRegistry::with_config(RegistryConfig::default()))
+    }
+
+    async fn register(registry: &UserRegistry, n: usize) {
+        for i in 0..n {
+            let aor = AddressOfRecord::parse(&format!("sip:user{i}@example.com")).unwrap();
+            registry
+                .register_aor(&aor, contact(&format!("sip:user{i}@192.0.2.1:5060")), 600)
+                .await
+                .unwrap();
+        }
+    }
+
+    #[tokio::test]
+    async fn recovers_from_wal_then_snapshot() {
+        let dir = temp_dir("recover");
+        let config = LocationStoreConfig::new(&dir);
+        {
+            let registry = empty_registry();
+            let store = LocationStore::open(Arc::clone(&registry), &config).unwrap();
+            register(&registry, 50).await;
+            registry.unregister("sip:user7@example.com").await.unwrap();
+            store.sync().unwrap();
+        }
+
+        let registry = empty_registry();
+        let store = LocationStore::open(Arc::clone(&registry), &config).unwrap();
+        assert_eq!(store.recovery().snapshot_keys, 0);
+        assert_eq!(store.recovery().wal_changes, 51);
+        assert_eq!(registry.len(), 49);
+        assert_eq!(store.snapshot().unwrap(), 49);
+        registry.unregister("sip:user8@example.com").await.unwrap();
+        drop(store);
+
+        let registry = empty_registry();
+        let store = LocationStore::open(Arc::clone(&registry), &config).unwrap();
+        assert_eq!(store.recovery().snapshot_keys, 49);
+        assert_eq!(store.recovery().wal_changes, 1);
+        assert_eq!(registry.len(), 48);
+        let aor = AddressOfRecord::parse("sip:user9@example.com").unwrap();
+        let contacts = registry.lookup_contacts(aor.as_str()).await.unwrap();
+        assert_eq!(contacts[0].uri, "sip:user9@192.0.2.1:5060");
+        drop(store);
+        let _ = std::fs::remove_dir_all(&dir);
+    }
+
+    #[tokio::test]
+    async fn standby_follows_primary() {
+        let dir = temp_dir("primary");
+        let mut config = LocationStoreConfig::new(&dir);
+        config.replication_listen = Some("127.0.0.1:0".parse().unwrap());
+        let primary = empty_registry();
+        let store = LocationStore::open(Arc::clone(&primary), &config).unwrap();
+        register(&primary, 20).await;
+
+        let standby = empty_registry();
+        let follower =
+            HotStandby::follow(Arc::clone(&standby), store.replication_addr().unwrap()).unwrap();
+        register(&primary, 30).await;
+        primary.unregister("sip:user3@example.com").await.unwrap();
+
+        let deadline = Instant::now() + Duration::from_secs(10);
+        while !(follower.is_synced() && standby.len() == 29) {
+            assert!(Instant::now() < deadline, "standby did not catch up");
+            std::thread::sleep(Duration::from_millis(10));
+        }
+        follower.promote();
+        drop(store);
+        let _ = std::fs::remove_dir_all(&dir);
+    }
+
+    #[tokio::test]
+    async fn standby_survives_changes_during_state_transfer() {
+        let dir = temp_dir("busy-primary");
+        let mut config = LocationStoreConfig::new(&dir);
+        config.replication_listen = Some("127.0.0.1:0".parse().unwrap());
+        config.sync_interval_ms = 1000;
+        let primary = empty_registry();
+        let store = LocationStore::open(Arc::clone(&primary), &config).unwrap();
+        register(&primary, 50_000).await;
+
+        // A standby that stops reading just after the handshake stalls the
+        // state transfer on a full socket; meanwhile the primary writes far
+        // more batches than a standby may queue.
+        let stream = TcpStream::connect(store.replication_addr().unwrap()).unwrap();
+        stream
+            .set_read_timeout(Some(Duration::from_secs(10)))
+            .unwrap();
+        let mut input = BufReader::new(stream);
+        let mut hello = [0u8; 8];
+        input.read_exact(&mut hello).unwrap();
+        for i in 0..20_000 {
+            let aor = AddressOfRecord::parse(&format!("sip:busy{i}@example.com")).unwrap();
+            primary
+                .register_aor(&aor, contact("sip:busy@192.0.2.9:5060"), 600)
+                .await
+                .unwrap();
+        }
+
+        // Resume reading: the transfer, the synced marker and then every
+        // change made meanwhile must all arrive on this one connection.
+        let mut synced = false;
+        let mut frame = Vec::new();
+        loop {
+            frame.resize(8, 0);
+            input.read_exact(&mut frame).expect("stream ended early");
+            let len = u32::from_le_bytes(frame[..4].try_into().unwrap()) as usize;
+            frame.resize(8 + len, 0);
+            input
+                .read_exact(&mut frame[8..])
+                .expect("stream ended early");
+            let wal::Frame::Intact { payload, .. } = wal::read_frame(&frame) else {
+                panic!("damaged replication frame");
+            };
+            match codec::decode_change(payload).unwrap() {
+                codec::Change::Synced => synced = true,
+                codec::Change::Put { key, .. } if synced && key == "sip:busy19999@example.com" => {
+                    break;
+                }
+                _ => {}
+            }
+        }
+        assert_eq!(store.wal_stats().dropped_standbys, 0);
+        drop(store);
+        let _ = std::fs::remove_dir_all(&dir);
+    }
+}
@@ -0,0 +1,480 @@
+//! WAL streaming to a hot standby over TCP.
+//!
+//! A standby connects to the primary, which subscribes it to the WAL writer
+//! *before* transferring state, then sends every bound key as a put, a
+//! synced marker, and from then on the framed batches the writer appends.
+//! A helper thread holds the batches appended during the transfer, however
+//! long it takes, so only a standby that lags once in sync is dropped.
+//! Changes made during the transfer may arrive twice; records are whole-key
+//! upserts, so applying them again is harmless. At the synced marker the
+//! standby forgets any key the transfer did not mention, which reconciles
+//! state left over from an earlier connection.
+//!
+//! ```text
+//! stream = magic:"RVLR" version:u32 frame*      (frames as in the WAL)
+//! ```
+
+use super::codec::{self, Change};
+use super::wal::{self, Command, Frame};
+use crate::error::{RegistrarError, Result};
+use crate::registrar::registry::UserRegistry;
+use chrono::Utc;
+use std::collections::HashSet;
+use std::io::{self, BufReader, BufWriter, Read, Write};
+use std::net::{Shutdown, SocketAddr, TcpListener, TcpStream};
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+use std::sync::mpsc::{self, Receiver, RecvTimeoutError, Sender};
+use std::sync::{Arc, Mutex};
+use std::thread::JoinHandle;
+use std::time::Duration;
+use tracing::{info, warn};
+
+const MAGIC: &[u8; 4] = b"RVLR";
+const VERSION: u32 = 1;
+/// Batches an in-sync standby may fall behind before the primary drops it.
+const REPLICA_BACKLOG: usize = 1024;
+/// How often idle threads check whether they should stop.
+const POLL: Duration = Duration::from_millis(100);
+/// How long the transfer's batch holder waits for the next batch.
+const HOLD_POLL: Duration = Duration::from_millis(10);
+/// Changes a standby may fall behind during its state transfer.
+const MAX_HELD_BYTES: usize = 256 * 1024 * 1024;
+const RECONNECT_DELAY: Duration = Duration::from_millis(500);
+/// How long a write to a standby may block before the standby is treated
+/// as disconnected.
+const WRITE_TIMEOUT: Duration = Duration::from_secs(5);
+
+/// Accepts standbys and streams the WAL to each.
+pub(super) struct ReplicationServer {
+    addr: SocketAddr,
+    stop: Arc<AtomicBool>,
+    thread: Option<JoinHandle<()>>,
+}
+
+impl ReplicationServer {
+    pub(super) fn start(
+        listen: SocketAddr,
+        registry: Arc<UserRegistry>,
+        wal: Sender<Command>,
+    ) -> Result<Self> {
+        let listener = TcpListener::bind(listen)?;
+        listener.set_nonblocking(true)?;
+        let addr = listener.local_addr()?;
+        let stop = Arc::new(AtomicBool::new(false));
+        let thread = {
+            let stop = Arc::clone(&stop);
+            std::thread::Builder::new()
+                .name("registrar-repl".to_string())
+                .spawn(move || accept_loop(listener, registry, wal, stop))?
+        };
+        info!("Location replication listening on {}", addr);
+        Ok(Self {
+            addr,
+            stop,
+            thread: Some(thread),
+        })
+    }
+
+    pub(super) fn local_addr(&self) -> SocketAddr {
+        self.addr
+    }
+}
+
+impl Drop for ReplicationServer {
+    fn drop(&mut self) {
+        self.stop.store(true, Ordering::Relaxed);
+        if let Some(thread) = self.thread.take() {
+            let _ = thread.join();
+        }
+    }
+}
+
+fn accept_loop(
+    listener: TcpListener,
+    registry: Arc<UserRegistry>,
+    wal: Sender<Command>,
+    stop: Arc<AtomicBool>,
+) {
+    let mut standbys = Vec::new();
+    while !stop.load(Ordering::Relaxed) {
+        match listener.accept() {
+            Ok((stream, peer)) => {
+                info!("Location standby {} connected", peer);
+                let registry = Arc::clone(&registry);
+                let wal = wal.clone();
+                let stop = Arc::clone(&stop);
+                let spawned = std::thread::Builder::new()
+                    .name("registrar-repl-peer".to_string())
+                    .spawn(move || {
+                        if let Err(e) = serve(stream, &registry, &wal, &stop) {
+                            warn!("Location standby {} disconnected: {}", peer, e);
+                        }
+                    });
+                match spawned {
+                    Ok(thread) => standbys.push(thread),
+                    Err(e) => warn!("Failed to start standby stream: {}", e),
+                }
+            }
+            Err(e) if e.kind() == io::ErrorKind::WouldBlock => std::thread::sleep(POLL),
+            Err(e) => {
+                warn!("Location replication accept failed: {}", e);
+                std::thread::sleep(POLL);
+            }
+        }
+        standbys.retain(|thread: &JoinHandle<()>| !thread.is_finished());
+    }
+    for thread in standbys {
+        let _ = thread.join();
+    }
+}
+
+fn serve(
+    stream: TcpStream,
+    registry: &UserRegistry,
+    wal: &Sender<Command>,
+    stop: &AtomicBool,
+) -> Result<()> {
+    stream.set_nonblocking(false)?;
+    stream.set_nodelay(true)?;
+    // A standby that stops reading must not hold this thread, and with it
+    // shutdown, forever; a vanished standby host is noticed even while
+    // nothing is written.
+    stream.set_write_timeout(Some(WRITE_TIMEOUT))?;
+    set_keepalive(&stream)?;
+    // Subscribe first so nothing changed during the transfer is missed.
+    let (tx, rx) = mpsc::sync_channel(REPLICA_BACKLOG);
+    wal.send(Command::Subscribe(tx))
+        .map_err(|_| RegistrarError::StorageError("location WAL stopped".to_string()))?;
+
+    let mut out = BufWriter::with_capacity(256 * 1024, StandbyStream(stream));
+    let result = replicate(&mut out, rx, registry, stop);
+    if result.is_err() {
+        // Discard what is still buffered rather than flushing it into a
+        // stalled socket on drop.
+        let (StandbyStream(stream), _unsent) = out.into_parts();
+        let _ = stream.shutdown(Shutdown::Both);
+    }
+    result
+}
+
+/// Transfer state, then stream the WAL until stopped or disconnected.
+fn replicate(
+    out: &mut BufWriter<StandbyStream>,
+    rx: Receiver<Arc<[u8]>>,
+    registry: &UserRegistry,
+    stop: &AtomicBool,
+) -> Result<()> {
+    let transferring = AtomicBool::new(true);
+    let held = std::thread::scope(|scope| {
+        let holder = scope.spawn(|| hold_batches(rx, &transferring));
+        let transferred = transfer_state(out, registry, stop);
+        transferring.store(false, Ordering::Relaxed);
+        let held = holder.join().expect("replication holder panicked");
+        transferred.map(|()| held)
+    })?;
+    let (rx, held) = held.ok_or_else(|| {
+        RegistrarError::StorageError("standby fell behind during the state transfer".to_string())
+    })?;
+    for batch in held {
+        out.write_all(&batch)?;
+    }
+    out.flush()?;
+    stream_batches(out, rx, stop)
+}
+
+/// Socket to a standby. Writes give up after [`WRITE_TIMEOUT`] and report
+/// a standby that stopped reading as such.
+struct StandbyStream(TcpStream);
+
+impl Write for StandbyStream {
+    fn write(&mut self, buf: &[u8]) -> io::Result<usize> {
+        self.0.write(buf).map_err(|e| match e.kind() {
+            // The platform reports an expired write timeout as either.
+            io::ErrorKind::WouldBlock | io::ErrorKind::TimedOut => io::Error::new(
+                io::ErrorKind::TimedOut,
+                "standby stopped reading the stream",
+            ),
+            _ => e,
+        })
+    }
+
+    fn flush(&mut self) -> io::Result<()> {
+        self.0.flush()
+    }
+}
+
+#[cfg(unix)]
+fn set_keepalive(stream: &TcpStream) -> io::Result<()> {
+    use std::os::fd::AsRawFd;
+
+    let on: libc::c_int = 1;
+    // SAFETY: a valid socket descriptor and an option value of the size
+    // passed.
+    let rc = unsafe {
+        libc::setsockopt(
+            stream.as_raw_fd(),
+            libc::SOL_SOCKET,
+            libc::SO_KEEPALIVE,
+            (&on as *const libc::c_int).cast(),
+            std::mem::size_of::<libc::c_int>() as libc::socklen_t,
+        )
+    };
+    if rc != 0 {
+        return Err(io::Error::last_os_error());
+    }
+    Ok(())
+}
+
+#[cfg(not(unix))]
+fn set_keepalive(_stream: &TcpStream) -> io::Result<()> {
+    Ok(())
+}
+
+/// Send the handshake, every bound key and the synced marker.
+fn transfer_state(
+    out: &mut BufWriter<StandbyStream>,
+    registry: &UserRegistry,
+    stop: &AtomicBool,
+) -> Result<()> {
+    out.write_all(MAGIC)?;
+    out.write_all(&VERSION.to_le_bytes())?;
+    let mut payload = Vec::with_capacity(512);
+    let mut frame = Vec::with_capacity(512);
+    for key in registry.keys() {
+        if stop.load(Ordering::Relaxed) {
+            return Err(RegistrarError::StorageError(
+                "location store stopped during the state transfer".to_string(),
+            ));
+        }
+        payload.clear();
+        let bound = registry.with_bindings(&key, |bindings| {
+            codec::encode_put(&mut payload, &key, bindings)
+        });
+        if bound.is_some() {
+            frame.clear();
+            wal::write_frame(&mut frame, 0, &payload);
+            out.write_all(&frame)?;
+        }
+    }
+    payload.clear();
+    codec::encode_synced(&mut payload);
+    frame.clear();
+    wal::write_frame(&mut frame, 0, &payload);
+    out.write_all(&frame)?;
+    out.flush()?;
+    Ok(())
+}
+
+/// Collect batches from `rx` until the transfer is over and the channel
+/// is momentarily empty; later batches stay queued behind them. `None` if
+/// more than [`MAX_HELD_BYTES`] piled up, in which case the subscription
+/// is dropped at once rather than when the transfer ends.
+fn hold_batches(
+    rx: Receiver<Arc<[u8]>>,
+    transferring: &AtomicBool,
+) -> Option<(Receiver<Arc<[u8]>>, Vec<Arc<[u8]>>)> {
+    let mut held = Vec::new();
+    let mut bytes = 0;
+    loop {
+        match rx.recv_timeout(HOLD_POLL) {
+            Ok(batch) => {
+                bytes += batch.len();
+                if bytes > MAX_HELD_BYTES {
+                    return None;
+                }
+                held.push(batch);
+            }
+            Err(RecvTimeoutError::Timeout) if transferring.load(Ordering::Relaxed) => {}
+            // Disconnected is reported by the caller's next receive.
+            Err(_) => return Some((rx, held)),
+        }
+    }
+}
+
+/// Stream the data path after the state transfer.
+fn stream_batches(
+    out: &mut BufWriter<StandbyStream>,
+    rx: Receiver<Arc<[u8]>>,
+    stop: &AtomicBool,
+) -> Result<()> {
+    loop {
+        // Checked on every pass, not only when idle, so a steady stream
+        // of changes cannot hold off shutdown.
+        if stop.load(Ordering::Relaxed) {
+            return Ok(());
+        }
+        match rx.recv_timeout(POLL) {
+            Ok(batch) => {
+                out.write_all(&batch)?;
+                // Coalesce whatever else is already queued into one send.
+                while let Ok(batch) = rx.try_recv() {
+                    out.write_all(&batch)?;
+                }
+                out.flush()?;
+            }
+            Err(RecvTimeoutError::Timeout) => {}
+            Err(RecvTimeoutError::Disconnected) => {
+                return Err(RegistrarError::StorageError(
+                    "standby fell behind the WAL".to_string(),
+                ))
+            }
+        }
+    }
+}
+
+/// A registry kept in step with a primary's location store.
+///
+/// The standby reconnects whenever the stream breaks. [`HotStandby::promote`]
+/// stops following so the registry can take writes of its own.
+pub struct HotStandby {
+    state: Arc<StandbyState>,
+    thread: Option<JoinHandle<()>>,
+}
+
+#[derive(Default)]
+struct StandbyState {
+    stop: AtomicBool,
+    synced: AtomicBool,
+    applied: AtomicU64,
+    stream: Mutex<Option<TcpStream>>,
+}
+
+impl HotStandby {
+    /// Follow the primary at `primary`, applying its changes to `registry`.
+    pub fn follow(registry: Arc<UserRegistry>, primary: SocketAddr) -> Result<Self> {
+        let state = Arc::new(StandbyState::default());
+        let thread = {
+            let state = Arc::clone(&state);
+            std::thread::Builder::new()
+                .name("registrar-standby".to_string())
+                .spawn(move || follow_loop(&registry, primary, &state))?
+        };
+        Ok(Self {
+            state,
+            thread: Some(thread),
+        })
+    }
+
+    /// Whether the initial state transfer of the current connection is done.
+    pub fn is_synced(&self) -> bool {
+        self.state.synced.load(Ordering::Acquire)
+    }
+
+    /// Changes applied since the standby started.
+    pub fn applied_changes(&self) -> u64 {
+        self.state.applied.load(Ordering::Relaxed)
+    }
+
+    /// Stop following the primary.
+    pub fn promote(mut self) {
+        self.stop();
+    }
+
+    fn stop(&mut self) {
+        self.state.stop.store(true, Ordering::Relaxed);
+        if let Some(stream) = self.state.stream.lock().unwrap().take() {
+            let _ = stream.shutdown(Shutdown::Both);
+        }
+        if let Some(thread) = self.thread.take() {
+            let _ = thread.join();
+        }
+    }
+}
+
+impl Drop for HotStandby {
+    fn drop(&mut self) {
+        self.stop();
+    }
+}
+
+fn follow_loop(registry: &UserRegistry, primary: SocketAddr, state: &StandbyState) {
+    while !state.stop.load(Ordering::Relaxed) {
+        match TcpStream::connect_timeout(&primary, Duration::from_secs(1)) {
+            Ok(stream) => {
+                if let Err(e) = follow_stream(registry, stream, state) {
+                    if !state.stop.load(Ordering::Relaxed) {
+                        warn!("Location stream from {} broke: {}", primary, e);
+                    }
+                }
+                state.synced.store(false, Ordering::Release);
+            }
+            Err(e) => warn!("Cannot reach location primary {}: {}", primary, e),
+        }
+        if !state.stop.load(Ordering::Relaxed) {
+            std::thread::sleep(RECONNECT_DELAY);
+        }
+    }
+}
+
+fn follow_stream(registry: &UserRegistry, stream: TcpStream, state: &StandbyState) -> Result<()> {
+    {
+        let mut slot = state.stream.lock().unwrap();
+        // Promotion may have raced the connect.
+        if state.stop.load(Ordering::Relaxed) {
+            return Ok(());
+        }
+        *slot = Some(stream.try_clone()?);
+    }
+    let mut input = BufReader::with_capacity(256 * 1024, stream);
+    let mut hello = [0u8; 8];
+    input.read_exact(&mut hello)?;
+    if &hello[..4] != MAGIC || hello[4..] != VERSION.to_le_bytes() {
+        return Err(RegistrarError::StorageError(
+            "peer is not a compatible location primary".to_string(),
+        ));
+    }
+
+    // Keys sent by the state transfer; `None` once it is complete.
+    let mut transferred = Some(HashSet::new());
+    let mut buf = Vec::with_capacity(4096);
+    loop {
+        buf.resize(8, 0);
+        input.read_exact(&mut buf)?;
+        let len = u32::from_le_bytes(buf[..4].try_into().unwrap()) as usize;
+        match read_frame_body(&mut input, &mut buf, len)? {
+            Frame::Intact { payload, .. } => {
+                let now = Utc::now();
+                match codec::decode_change(payload)? {
+                    Change::Put { key, bindings } => {
+                        if let Some(keys) = transferred.as_mut() {
+                            keys.insert(key.to_string());
+                        }
+                        registry.restore(key, bindings, now);
+                    }
+                    Change::Remove { key } => {
+                        if let Some(keys) = transferred.as_mut() {
+                            keys.remove(key);
+                        }
+                        registry.forget(key);
+                    }
+                    Change::Synced => {
+                        if let Some(keys) = transferred.take() {
+                            registry.retain_keys(|key| keys.contains(key));
+                        }
+                        state.synced.store(true, Ordering::Release);
+                        info!("Location standby in sync");
+                    }
+                }
+                state.applied.fetch_add(1, Ordering::Relaxed);
+            }
+            Frame::Incomplete | Frame::Corrupt => {
+                return Err(codec::corrupt("replication frame"));
+            }
+        }
+    }
+}
+
+/// Read the `len` bytes after the header already in `buf` and check the
+/// whole frame.
+fn read_frame_body<'a>(
+    input: &mut impl Read,
+    buf: &'a mut Vec<u8>,
+    len: usize,
+) -> Result<Frame<'a>> {
+    if len > wal::MAX_FRAME {
+        return Ok(Frame::Corrupt);
+    }
+    buf.resize(8 + len, 0);
+    input.read_exact(&mut buf[8..])?;
+    Ok(wal::read_frame(buf))
+}
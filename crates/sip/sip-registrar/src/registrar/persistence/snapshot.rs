@@ -0,0 +1,147 @@
+//! Compact binary snapshots of the location store.
+//!
+//! ```text
+//! snapshot = magic:"RVLS" version:u32 covered_seq:u64
+//!            (len:varint bindings)*
+//!            count:u64 crc32:u32          (crc covers everything before it)
+//! ```
+//!
+//! A snapshot is written to a temporary file, synced and renamed over the
+//! previous one, so a crash leaves either the old or the new snapshot. It
+//! is taken while the registry keeps changing; every change after
+//! `covered_seq` is still in the WAL and replays on top of it.
+
+use super::codec::{self, Reader};
+use super::mmap::Mapped;
+use super::wal::sync_dir;
+use crate::error::{RegistrarError, Result};
+use crate::registrar::registry::{Bindings, UserRegistry};
+use std::fs::{self, File};
+use std::io::{BufWriter, Write};
+use std::path::{Path, PathBuf};
+
+const MAGIC: &[u8; 4] = b"RVLS";
+const VERSION: u32 = 1;
+const HEADER: usize = 16;
+const TRAILER: usize = 12;
+
+pub(super) fn path(dir: &Path) -> PathBuf {
+    dir.join("snapshot.bin")
+}
+
+/// Write every binding in `registry` to the snapshot in `dir`, recording
+/// that the WAL up to `covered_seq` is included. Returns the record count.
+pub(super) fn write(dir: &Path, registry: &UserRegistry, covered_seq: u64) -> Result<u64> {
+    let tmp = dir.join("snapshot.bin.tmp");
+    let file = File::create(&tmp)?;
+    let mut out = Checksummed {
+        out: BufWriter::with_capacity(1 << 20, file),
+        crc: crc32fast::Hasher::new(),
+    };
+    let mut header = Vec::with_capacity(HEADER);
+    header.extend_from_slice(MAGIC);
+    header.extend_from_slice(&VERSION.to_le_bytes());
+    header.extend_from_slice(&covered_seq.to_le_bytes());
+    out.write(&header)?;
+
+    let mut count = 0u64;
+    let mut record = Vec::with_capacity(512);
+    let mut len = Vec::with_capacity(10);
+    for key in registry.keys() {
+        record.clear();
+        len.clear();
+        // Keys removed since they were listed are skipped; their removal
+        // is in the WAL after `covered_seq`.
+        let bound = registry.with_bindings(&key, |bindings| {
+            codec::encode_bindings(&mut record, &key, bindings)
+        });
+        if bound.is_none() {
+            continue;
+        }
+        codec::put_varint(&mut len, record.len() as u64);
+        out.write(&len)?;
+        out.write(&record)?;
+        count += 1;
+    }
+
+    out.write(&count.to_le_bytes())?;
+    let crc = out.crc.finalize();
+    let mut out = out.out;
+    out.write_all(&crc.to_le_bytes())?;
+    let file = out
+        .into_inner()
+        .map_err(|e| RegistrarError::StorageError(e.to_string()))?;
+    file.sync_all()?;
+    drop(file);
+    fs::rename(&tmp, path(dir))?;
+    sync_dir(dir)?;
+    Ok(count)
+}
+
+struct Checksummed {
+    out: BufWriter<File>,
+    crc: crc32fast::Hasher,
+}
+
+impl Checksummed {
+    fn write(&mut self, bytes: &[u8]) -> Result<()> {
+        self.crc.update(bytes);
+        self.out.write_all(bytes)?;
+        Ok(())
+    }
+}
+
+/// A verified snapshot, mapped into memory.
+pub(super) struct Snapshot {
+    data: Mapped,
+    pub(super) covered_seq: u64,
+    pub(super) count: u64,
+}
+
+impl Snapshot {
+    /// Map and verify the snapshot in `dir`, if there is one.
+    pub(super) fn open(dir: &Path) -> Result<Option<Self>> {
+        let file = match File::open(path(dir)) {
+            Ok(file) => file,
+            Err(e) if e.kind() == std::io::ErrorKind::NotFound => return Ok(None),
+            Err(e) => return Err(e.into()),
+        };
+        let data = Mapped::open(&file)?;
+        if data.len() < HEADER + TRAILER || &data[..4] != MAGIC {
+            return Err(codec::corrupt("not a location snapshot"));
+        }
+        let version = u32::from_le_bytes(data[4..8].try_into().unwrap());
+        if version != VERSION {
+            return Err(RegistrarError::StorageError(format!(
+                "unsupported location snapshot version {version}"
+            )));
+        }
+        let crc_at = data.len() - 4;
+        let crc = u32::from_le_bytes(data[crc_at..].try_into().unwrap());
+        if crc32fast::hash(&data[..crc_at]) != crc {
+            return Err(codec::corrupt("snapshot checksum mismatch"));
+        }
+        Ok(Some(Self {
+            covered_seq: u64::from_le_bytes(data[8..16].try_into().unwrap()),
+            count: u64::from_le_bytes(data[crc_at - 8..crc_at].try_into().unwrap()),
+            data,
+        }))
+    }
+
+    /// Decode every record, in file order.
+    pub(super) fn for_each(&self, mut visit: impl FnMut(&str, Bindings)) -> Result<()> {
+        let mut reader = Reader::new(&self.data[HEADER..self.data.len() - TRAILER]);
+        let mut seen = 0u64;
+        while reader.remaining() > 0 {
+            let len =
+                usize::try_from(reader.varint()?).map_err(|_| codec::corrupt("record length"))?;
+            let (key, bindings) = codec::decode_bindings(reader.bytes(len)?)?;
+            visit(key, bindings);
+            seen += 1;
+        }
+        if seen != self.count {
+            return Err(codec::corrupt("snapshot record count mismatch"));
+        }
+        Ok(())
+    }
+}
@@ -0,0 +1,581 @@
+//! Write-ahead log of binding changes.
+//!
+//! The registry hands encoded changes to a [`Journal`]; a dedicated writer
+//! thread numbers them, frames them and appends each batch it drains from
+//! the channel with one write (group commit), syncing the file per batch
+//! or on an interval. The same framed batches are passed to replication
+//! subscribers. Framing:
+//!
+//! ```text
+//! frame = len:u32 crc32:u32 seq:u64 payload     (len and crc cover seq + payload)
+//! ```
+//!
+//! The log is split into segments named after their first sequence
+//! number. A snapshot rotates to a fresh segment and, once written, deletes
+//! the segments it covers. Recovery replays the segments after the
+//! snapshot and truncates a torn frame at the tail of the last one; damage
+//! with an intact frame after it is corruption, not a torn write, and fails
+//! recovery.
+//!
+//! A batch that fails to reach the file is cut back off the segment, so
+//! later batches follow the last whole frame, and is recorded in
+//! [`WalHealth`]: its changes stay in memory only until the next snapshot
+//! covers them.
+
+use super::codec;
+use crate::error::{RegistrarError, Result};
+use crate::registrar::registry::Bindings;
+use std::fs::{self, File, OpenOptions};
+use std::io::{self, Write};
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::mpsc::{self, Receiver, Sender, SyncSender, TrySendError};
+use std::sync::Arc;
+use std::thread::JoinHandle;
+use std::time::{Duration, Instant};
+use tracing::{error, warn};
+
+const FRAME_HEADER: usize = 8;
+const SEQ_LEN: usize = 8;
+/// Largest change payload accepted when reading; far above any real record.
+pub(super) const MAX_FRAME: usize = 16 * 1024 * 1024;
+/// Changes drained into one write before the batch is flushed.
+const MAX_BATCH: usize = 4096;
+
+/// Sending half held by the registry.
+pub(in crate::registrar) struct Journal {
+    tx: Sender<Command>,
+}
+
+pub(super) enum Command {
+    Append(Vec<u8>),
+    /// Seal the current segment; replies with the last sequence number in
+    /// the sealed segments.
+    Rotate(SyncSender<Result<u64>>),
+    /// Receive every later batch of frames. The subscriber is dropped if
+    /// it falls a full channel behind.
+    Subscribe(SyncSender<Arc<[u8]>>),
+    /// Flush and sync; replies with the last sequence number written.
+    Sync(SyncSender<Result<u64>>),
+    Shutdown,
+}
+
+impl Journal {
+    pub(super) fn new(tx: Sender<Command>) -> Self {
+        Self { tx }
+    }
+
+    pub(in crate::registrar) fn put(&self, key: &str, bindings: &Bindings) {
+        let mut payload = Vec::with_capacity(96 + 160 * bindings.contacts.len());
+        codec::encode_put(&mut payload, key, bindings);
+        let _ = self.tx.send(Command::Append(payload));
+    }
+
+    pub(in crate::registrar) fn remove(&self, key: &str) {
+        let mut payload = Vec::with_capacity(key.len() + 4);
+        codec::encode_remove(&mut payload, key);
+        let _ = self.tx.send(Command::Append(payload));
+    }
+}
+
+/// Append `seq` and `payload` to `out` as one frame.
+pub(super) fn write_frame(out: &mut Vec<u8>, seq: u64, payload: &[u8]) {
+    let mut crc = crc32fast::Hasher::new();
+    crc.update(&seq.to_le_bytes());
+    crc.update(payload);
+    out.extend_from_slice(&((SEQ_LEN + payload.len()) as u32).to_le_bytes());
+    out.extend_from_slice(&crc.finalize().to_le_bytes());
+    out.extend_from_slice(&seq.to_le_bytes());
+    out.extend_from_slice(payload);
+}
+
+/// Outcome of reading one frame from the front of a buffer.
+pub(super) enum Frame<'a> {
+    /// A complete, intact frame and its total encoded length.
+    Intact {
+        seq: u64,
+        payload: &'a [u8],
+        len: usize,
+    },
+    /// The buffer ends inside the frame.
+    Incomplete,
+    /// The frame fails its checksum or has an impossible length.
+    Corrupt,
+}
+
+pub(super) fn read_frame(buf: &[u8]) -> Frame<'_> {
+    if buf.len() < FRAME_HEADER {
+        return Frame::Incomplete;
+    }
+    let len = u32::from_le_bytes(buf[0..4].try_into().unwrap()) as usize;
+    if !(SEQ_LEN..=MAX_FRAME).contains(&len) {
+        return Frame::Corrupt;
+    }
+    let Some(body) = buf.get(FRAME_HEADER..FRAME_HEADER + len) else {
+        return Frame::Incomplete;
+    };
+    let crc = u32::from_le_bytes(buf[4..8].try_into().unwrap());
+    if crc32fast::hash(body) != crc {
+        return Frame::Corrupt;
+    }
+    Frame::Intact {
+        seq: u64::from_le_bytes(body[..SEQ_LEN].try_into().unwrap()),
+        payload: &body[SEQ_LEN..],
+        len: FRAME_HEADER + len,
+    }
+}
+
+fn segment_path(dir: &Path, first_seq: u64) -> PathBuf {
+    dir.join(format!("wal-{first_seq:020}.log"))
+}
+
+/// WAL segments in `dir` as `(first seq, path)`, oldest first.
+pub(super) fn segments(dir: &Path) -> Result<Vec<(u64, PathBuf)>> {
+    let mut segments = Vec::new();
+    for entry in fs::read_dir(dir)? {
+        let path = entry?.path();
+        let first_seq = path
+            .file_name()
+            .and_then(|name| name.to_str())
+            .and_then(|name| name.strip_prefix("wal-")?.strip_suffix(".log"))
+            .and_then(|seq| seq.parse::<u64>().ok());
+        if let Some(first_seq) = first_seq {
+            segments.push((first_seq, path));
+        }
+    }
+    segments.sort_unstable_by_key(|(first_seq, _)| *first_seq);
+    Ok(segments)
+}
+
+/// Replay every change after `after_seq`, passing `(seq, payload)` to
+/// `apply`. Returns the last sequence number seen, or `after_seq`.
+pub(super) fn replay(
+    dir: &Path,
+    after_seq: u64,
+    mut apply: impl FnMut(u64, &[u8]) -> Result<()>,
+) -> Result<u64> {
+    let segments = segments(dir)?;
+    let mut last_seq = after_seq;
+    for (index, (_, path)) in segments.iter().enumerate() {
+        let is_last = index + 1 == segments.len();
+        let data = fs::read(path)?;
+        let mut offset = 0;
+        while offset < data.len() {
+            match read_frame(&data[offset..]) {
+                Frame::Intact { seq, payload, len } => {
+                    if seq > last_seq {
+                        apply(seq, payload)?;
+                        last_seq = seq;
+                    }
+                    offset += len;
+                }
+                Frame::Incomplete | Frame::Corrupt
+                    if is_last && !intact_frame_after(&data[offset..]) =>
+                {
+                    // A write torn by the crash: drop it.
+                    warn!(
+                        "Truncating torn WAL tail in {} at byte {}",
+                        path.display(),
+                        offset
+                    );
+                    OpenOptions::new()
+                        .write(true)
+                        .open(path)?
+                        .set_len(offset as u64)?;
+                    break;
+                }
+                Frame::Incomplete | Frame::Corrupt => {
+                    return Err(RegistrarError::StorageError(format!(
+                        "corrupt WAL segment {} at byte {}",
+                        path.display(),
+                        offset
+                    )));
+                }
+            }
+        }
+    }
+    Ok(last_seq)
+}
+
+/// Whether an intact frame starts anywhere after the first byte of `buf`.
+/// A crash tears at most the frames being written, so nothing whole can
+/// follow a torn tail.
+fn intact_frame_after(buf: &[u8]) -> bool {
+    (1..buf.len()).any(|at| matches!(read_frame(&buf[at..]), Frame::Intact { .. }))
+}
+
+/// Delete the segments that hold only changes up to `covered_seq`.
+pub(super) fn remove_covered(dir: &Path, covered_seq: u64) -> Result<()> {
+    let segments = segments(dir)?;
+    for pair in segments.windows(2) {
+        // A segment ends just before the next one starts.
+        if pair[1].0 <= covered_seq + 1 {
+            fs::remove_file(&pair[0].1)?;
+        }
+    }
+    Ok(())
+}
+
+/// How often the writer syncs the log to disk.
+#[derive(Debug, Clone, Copy)]
+pub(super) enum SyncPolicy {
+    /// After every batch.
+    EveryBatch,
+    /// At most once per interval; a crash can lose that much.
+    Interval(Duration),
+}
+
+/// Write failures, shared by the writer thread and the store.
+#[derive(Default)]
+pub(super) struct WalHealth {
+    /// Batches that could not be written or synced.
+    pub(super) write_errors: AtomicU64,
+    /// Last change that may be missing from the log, or 0. Cleared by a
+    /// snapshot that covers it.
+    pub(super) unlogged_through: AtomicU64,
+    /// Replication subscribers dropped for falling behind.
+    pub(super) dropped_standbys: AtomicU64,
+}
+
+impl WalHealth {
+    /// Forget failures up to `covered_seq`, now held by a snapshot.
+    pub(super) fn covered(&self, covered_seq: u64) {
+        let _ = self
+            .unlogged_through
+            .fetch_update(Ordering::AcqRel, Ordering::Acquire, |seq| {
+                (seq <= covered_seq).then_some(0)
+            });
+    }
+}
+
+pub(super) struct Writer {
+    dir: PathBuf,
+    file: File,
+    /// Bytes of whole frames in the current segment.
+    len: u64,
+    /// A failed write could not be cut off the segment; batches are dropped
+    /// until the next rotation.
+    broken: bool,
+    health: Arc<WalHealth>,
+    next_seq: u64,
+    policy: SyncPolicy,
+    last_sync: Instant,
+    dirty: bool,
+    subscribers: Vec<SyncSender<Arc<[u8]>>>,
+}
+
+impl Writer {
+    /// Start a fresh segment whose first change will be `next_seq`.
+    pub(super) fn create(
+        dir: &Path,
+        next_seq: u64,
+        policy: SyncPolicy,
+        health: Arc<WalHealth>,
+    ) -> Result<Self> {
+        let file = open_segment(dir, next_seq)?;
+        Ok(Self {
+            dir: dir.to_path_buf(),
+            len: file.metadata()?.len(),
+            file,
+            broken: false,
+            health,
+            next_seq,
+            policy,
+            last_sync: Instant::now(),
+            dirty: false,
+            subscribers: Vec::new(),
+        })
+    }
+
+    pub(super) fn spawn(mut self, rx: Receiver<Command>) -> io::Result<JoinHandle<()>> {
+        std::thread::Builder::new()
+            .name("registrar-wal".to_string())
+            .spawn(move || self.run(rx))
+    }
+
+    fn run(&mut self, rx: Receiver<Command>) {
+        let mut batch = Vec::with_capacity(64 * 1024);
+        loop {
+            // Wake for the next interval sync even when idle.
+            let first = match self.policy {
+                SyncPolicy::Interval(interval) if self.dirty => {
+                    match rx.recv_timeout(interval.saturating_sub(self.last_sync.elapsed())) {
+                        Ok(command) => Some(command),
+                        Err(mpsc::RecvTimeoutError::Timeout) => None,
+                        Err(mpsc::RecvTimeoutError::Disconnected) => return,
+                    }
+                }
+                _ => match rx.recv() {
+                    Ok(command) => Some(command),
+                    Err(_) => return,
+                },
+            };
+
+            let mut next = first;
+            let mut drained = 0;
+            while let Some(command) = next {
+                match command {
+                    Command::Append(payload) => {
+                        write_frame(&mut batch, self.next_seq, &payload);
+                        self.next_seq += 1;
+                    }
+                    // Control commands see every change queued before them.
+                    control => {
+                        self.flush(&mut batch);
+                        if !self.control(control) {
+                            return;
+                        }
+                    }
+                }
+                drained += 1;
+                next = if drained < MAX_BATCH {
+                    rx.try_recv().ok()
+                } else {
+                    None
+                };
+            }
+            self.flush(&mut batch);
+        }
+    }
+
+    /// Handle a control command; `false` on shutdown.
+    fn control(&mut self, command: Command) -> bool {
+        match command {
+            Command::Append(_) => unreachable!("appends are batched"),
+            Command::Rotate(reply) => {
+                let _ = reply.send(self.rotate());
+            }
+            Command::Subscribe(subscriber) => self.subscribers.push(subscriber),
+            Command::Sync(reply) => {
+                let _ = reply.send(self.sync().map(|()| self.next_seq - 1));
+            }
+            Command::Shutdown => {
+                if let Err(e) = self.sync() {
+                    error!("Location WAL sync failed: {}", e);
+                }
+                return false;
+            }
+        }
+        true
+    }
+
+    fn flush(&mut self, batch: &mut Vec<u8>) {
+        if let Err(e) = self.write_batch(batch) {
+            error!("Location WAL write failed: {}", e);
+            self.health.write_errors.fetch_add(1, Ordering::Relaxed);
+            self.health
+                .unlogged_through
+                .fetch_max(self.next_seq - 1, Ordering::AcqRel);
+        }
+    }
+
+    fn write_batch(&mut self, batch: &mut Vec<u8>) -> Result<()> {
+        if !batch.is_empty() {
+            let frames: Arc<[u8]> = Arc::from(batch.as_slice());
+            self.subscribers.retain(
+                |subscriber| match subscriber.try_send(Arc::clone(&frames)) {
+                    Ok(()) => true,
+                    Err(TrySendError::Full(_)) => {
+                        warn!("Dropping lagging location replica");
+                        self.health.dropped_standbys.fetch_add(1, Ordering::Relaxed);
+                        false
+                    }
+                    Err(TrySendError::Disconnected(_)) => false,
+                },
+            );
+            if self.broken {
+                batch.clear();
+                return Err(RegistrarError::StorageError(
+                    "WAL segment damaged by an earlier write".to_string(),
+                ));
+            }
+            let written = self.file.write_all(batch);
+            let len = batch.len() as u64;
+            batch.clear();
+            if let Err(e) = written {
+                self.discard_partial_write();
+                return Err(e.into());
+            }
+            self.len += len;
+            self.dirty = true;
+        }
+        let due = match self.policy {
+            SyncPolicy::EveryBatch => true,
+            SyncPolicy::Interval(interval) => self.last_sync.elapsed() >= interval,
+        };
+        if self.dirty && due {
+            self.sync()?;
+        }
+        Ok(())
+    }
+
+    fn sync(&mut self) -> Result<()> {
+        if self.dirty {
+            self.file.sync_data()?;
+            self.dirty = false;
+        }
+        self.last_sync = Instant::now();
+        Ok(())
+    }
+
+    /// Cut whatever part of a failed write reached the file back off, so
+    /// the next batch follows the last whole frame.
+    fn discard_partial_write(&mut self) {
+        if let Err(e) = self.file.set_len(self.len) {
+            error!(
+                "Cannot truncate location WAL after a failed write, appends stop until the next snapshot: {}",
+                e
+            );
+            self.broken = true;
+        }
+    }
+
+    fn rotate(&mut self) -> Result<u64> {
+        self.sync()?;
+        let file = open_segment(&self.dir, self.next_seq)?;
+        self.len = file.metadata()?.len();
+        self.file = file;
+        self.broken = false;
+        Ok(self.next_seq - 1)
+    }
+}
+
+fn open_segment(dir: &Path, first_seq: u64) -> Result<File> {
+    let file = OpenOptions::new()
+        .create(true)
+        .append(true)
+        .open(segment_path(dir, first_seq))?;
+    sync_dir(dir)?;
+    Ok(file)
+}
+
+/// Make a new or renamed directory entry durable.
+pub(super) fn sync_dir(dir: &Path) -> Result<()> {
+    #[cfg(unix)]
+    File::open(dir)?.sync_all()?;
+    #[cfg(not(unix))]
+    let _ = dir;
+    Ok(())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn temp_dir(name: &str) -> PathBuf {
+        let dir = std::env::temp_dir().join(format!(
+            "rvoip-wal-{}-{}-{}",
+            name,
+            std::process::id(),
+            chrono::Utc::now().timestamp_nanos_opt().unwrap_or_default()
+        ));
+        fs::create_dir_all(&dir).unwrap();
+        dir
+    }
+
+    fn replayed(dir: &Path) -> Result<Vec<u64>> {
+        let mut seqs = Vec::new();
+        replay(dir, 0, |seq, _| {
+            seqs.push(seq);
+            Ok(())
+        })?;
+        Ok(seqs)
+    }
+
+    /// Queue the next change on `writer` and flush it.
+    fn append(writer: &mut Writer, payload: &[u8]) {
+        let mut batch = Vec::new();
+        write_frame(&mut batch, writer.next_seq, payload);
+        writer.next_seq += 1;
+        writer.flush(&mut batch);
+    }
+
+    #[test]
+    fn frames_round_trip_and_detect_damage() {
+        let mut buf = Vec::new();
+        write_frame(&mut buf, 7, b"payload");
+        let Frame::Intact { seq, payload, len } = read_frame(&buf) else {
+            panic!("intact frame expected");
+        };
+        assert_eq!((seq, payload, len), (7, &b"payload"[..], buf.len()));
+
+        assert!(matches!(
+            read_frame(&buf[..buf.len() - 1]),
+            Frame::Incomplete
+        ));
+        let last = buf.len() - 1;
+        buf[last] ^= 1;
+        assert!(matches!(read_frame(&buf), Frame::Corrupt));
+    }
+
+    #[test]
+    fn failed_writes_are_cut_off_and_reported() {
+        let dir = temp_dir("failed-write");
+        let health = Arc::new(WalHealth::default());
+        let mut writer =
+            Writer::create(&dir, 1, SyncPolicy::EveryBatch, Arc::clone(&health)).unwrap();
+        append(&mut writer, b"one");
+
+        // Half a frame reached the file before the write failed.
+        let path = segment_path(&dir, 1);
+        let mut torn = Vec::new();
+        write_frame(&mut torn, 2, b"two");
+        OpenOptions::new()
+            .append(true)
+            .open(&path)
+            .unwrap()
+            .write_all(&torn[..torn.len() / 2])
+            .unwrap();
+        writer.discard_partial_write();
+        append(&mut writer, b"three");
+        assert_eq!(replayed(&dir).unwrap(), vec![1, 2]);
+
+        // A write that fails outright, on a file that cannot be truncated
+        // either, stops appends until the next rotation.
+        writer.file = File::open(&path).unwrap();
+        append(&mut writer, b"four");
+        append(&mut writer, b"five");
+        assert!(writer.broken);
+        assert_eq!(health.write_errors.load(Ordering::Relaxed), 2);
+        assert_eq!(health.unlogged_through.load(Ordering::Relaxed), 4);
+
+        assert_eq!(writer.rotate().unwrap(), 4);
+        append(&mut writer, b"six");
+        assert!(!writer.broken);
+        health.covered(3);
+        assert_eq!(health.unlogged_through.load(Ordering::Relaxed), 4);
+        health.covered(4);
+        assert_eq!(health.unlogged_through.load(Ordering::Relaxed), 0);
+        assert_eq!(replayed(&dir).unwrap(), vec![1, 2, 5]);
+        let _ = fs::remove_dir_all(&dir);
+    }
+
+    #[test]
+    fn replay_truncates_only_a_torn_tail() {
+        let dir = temp_dir("torn-tail");
+        let path = segment_path(&dir, 1);
+        let mut data = Vec::new();
+        for seq in 1..=3 {
+            write_frame(&mut data, seq, b"change");
+        }
+        let frame_len = data.len() / 3;
+
+        // Damage in the last frame is a torn write: drop it.
+        let mut torn = data.clone();
+        torn[3 * frame_len - 1] ^= 1;
+        fs::write(&path, &torn).unwrap();
+        assert_eq!(replayed(&dir).unwrap(), vec![1, 2]);
+        assert_eq!(fs::metadata(&path).unwrap().len(), 2 * frame_len as u64);
+
+        // Damage with whole frames after it is not.
+        let mut corrupt = data.clone();
+        corrupt[frame_len + FRAME_HEADER] ^= 1;
+        fs::write(&path, &corrupt).unwrap();
+        assert!(matches!(
+            replayed(&dir),
+            Err(RegistrarError::StorageError(_))
+        ));
+        assert_eq!(fs::metadata(&path).unwrap().len(), data.len() as u64);
+        let _ = fs::remove_dir_all(&dir);
+    }
+}
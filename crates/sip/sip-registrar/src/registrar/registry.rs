@@ -1,21 +1,73 @@
 //! User registry for managing registrations
 
+use super::expiry::{bucket_of, ExpiryIndex, UNFILED};
+use super::persistence::Journal;
 use crate::error::{RegistrarError, Result};
 use crate::types::{
     AddressOfRecord, ContactInfo, ContactReachability, RegistrarConfig, UserRegistration,
 };
 use chrono::{DateTime, Duration, Utc};
+use dashmap::mapref::entry::Entry;
 use dashmap::DashMap;
 use std::cmp::Ordering;
-use std::sync::Arc;
+use std::sync::{Arc, OnceLock};
 use tracing::{debug, info, warn};
 
 /// Thread-safe authoritative registration binding store.
+///
+/// Each key holds one record with its contacts inline; the
+/// [`UserRegistration`] view is assembled when read. An expiry index keeps
+/// [`UserRegistry::expire_registrations`] proportional to the bindings that
+/// are due instead of the size of the registry.
+///
+/// When a durable location store is attached, every binding change is
+/// journaled while the key's shard is still locked, so the journal holds
+/// each key's changes in the order they were applied. Expiry and
+/// reachability are not journaled: both are recomputed after a restart.
 pub struct UserRegistry {
-    users: Arc<DashMap<String, UserRegistration>>,
+    users: Arc<DashMap<Arc<str>, Bindings>>,
+    expiry: ExpiryIndex,
+    journal: OnceLock<Journal>,
     config: RegistryConfig,
 }
 
+/// Stored bindings of one registration key.
+pub(super) struct Bindings {
+    /// The key is a canonical AoR (`register_aor`) rather than a user id.
+    pub(super) keyed_by_aor: bool,
+    pub(super) contacts: Vec<ContactInfo>,
+    pub(super) registered_at: DateTime<Utc>,
+    /// Expiry-index second the key is filed under.
+    pub(super) filed_under: i64,
+}
+
+impl Bindings {
+    fn new(keyed_by_aor: bool) -> Self {
+        Self {
+            keyed_by_aor,
+            contacts: Vec::new(),
+            registered_at: Utc::now(),
+            filed_under: UNFILED,
+        }
+    }
+
+    fn registration(&self, key: &str) -> UserRegistration {
+        let aor = self
+            .keyed_by_aor
+            .then(|| AddressOfRecord::from_canonical(key));
+        UserRegistration {
+            user_id: aor.as_ref().map_or(key, |aor| aor.user()).to_string(),
+            aor,
+            contacts: self.contacts.clone(),
+            expires: latest_expiry(&self.contacts),
+            presence_enabled: true,
+            capabilities: vec!["presence".to_string()],
+            registered_at: self.registered_at,
+            attributes: Default::default(),
+        }
+    }
+}
+
 #[derive(Debug, Clone)]
 pub struct RegistryConfig {
     pub max_contacts_per_aor: usize,
@@ -63,12 +115,14 @@ impl UserRegistry {
     pub fn with_config(config: RegistryConfig) -> Self {
         Self {
             users: Arc::new(DashMap::new()),
+            expiry: ExpiryIndex::new(),
+            journal: OnceLock::new(),
             config,
         }
     }
 
     pub async fn register(&self, key: &str, contact: ContactInfo, expires: u32) -> Result<()> {
-        self.register_binding(key, None, contact, expires).await
+        self.register_binding(key, false, contact, expires).await
     }
 
     pub async fn register_aor(
@@ -77,7 +131,7 @@ impl UserRegistry {
         contact: ContactInfo,
         expires: u32,
     ) -> Result<()> {
-        self.register_binding(aor.as_str(), Some(aor.clone()), contact, expires)
+        self.register_binding(aor.as_str(), true, contact, expires)
             .await
     }
 
@@ -96,37 +150,26 @@ impl UserRegistry {
         }
 
         let expires_at = Utc::now() + Duration::seconds(expires as i64);
-        let mut next = self
-            .users
-            .get(aor.as_str())
-            .map(|entry| entry.clone())
-            .unwrap_or_else(|| UserRegistration {
-                user_id: aor.user().to_string(),
-                aor: Some(aor.clone()),
-                contacts: Vec::new(),
-                expires: expires_at,
-                presence_enabled: true,
-                capabilities: vec!["presence".to_string()],
-                registered_at: Utc::now(),
-                attributes: Default::default(),
-            });
-
-        for mut contact in contacts {
-            if !self.config.support_path {
-                contact.path.clear();
+        self.update_bindings(aor.as_str(), true, |key, bindings| {
+            // A REGISTER's bindings are committed all or nothing
+            // (RFC 3261 §10.3), so the batch is staged on a copy.
+            let mut staged = bindings.contacts.clone();
+            for mut contact in contacts {
+                if !self.config.support_path {
+                    contact.path.clear();
+                }
+                contact.expires = expires_at;
+                self.update_contact(key, &mut staged, contact)?;
             }
-            contact.expires = expires_at;
-            self.update_contact(&mut next, contact, expires_at)?;
-        }
-
-        self.users.insert(aor.to_string(), next);
-        Ok(())
+            bindings.contacts = staged;
+            Ok(())
+        })
     }
 
     async fn register_binding(
         &self,
         key: &str,
-        aor: Option<AddressOfRecord>,
+        keyed_by_aor: bool,
         mut contact: ContactInfo,
         expires: u32,
     ) -> Result<()> {
@@ -138,37 +181,19 @@ impl UserRegistry {
             contact.path.clear();
         }
 
-        let expires_at = Utc::now() + Duration::seconds(expires as i64);
-        contact.expires = expires_at;
-        let contact_uri = contact.uri.clone();
-        let user_id = aor
-            .as_ref()
-            .map(|aor| aor.user().to_string())
-            .unwrap_or_else(|| key.to_string());
-
-        if let Some(mut registration) = self.users.get_mut(key) {
-            self.update_contact(&mut registration, contact, expires_at)?;
-        } else {
-            let mut registration = UserRegistration {
-                user_id,
-                aor,
-                contacts: Vec::new(),
-                expires: expires_at,
-                presence_enabled: true,
-                capabilities: vec!["presence".to_string()],
-                registered_at: Utc::now(),
-                attributes: Default::default(),
-            };
-            self.update_contact(&mut registration, contact, expires_at)?;
-            self.users.insert(key.to_string(), registration);
-        }
-
-        info!("Registration {} updated with contact {}", key, contact_uri);
-        Ok(())
+        contact.expires = Utc::now() + Duration::seconds(expires as i64);
+        self.update_bindings(key, keyed_by_aor, |key, bindings| {
+            self.update_contact(key, &mut bindings.contacts, contact)
+        })
     }
 
     pub async fn unregister(&self, key: &str) -> Result<()> {
-        if self.users.remove(key).is_some() {
+        // Its expiry index entry goes stale and is dropped when due.
+        let removed = self.users.remove_if(key, |key, _| {
+            self.journal_remove(key);
+            true
+        });
+        if removed.is_some() {
             info!("Registration {} removed", key);
             Ok(())
         } else {
@@ -194,10 +219,11 @@ impl UserRegistry {
 
         if entry.contacts.is_empty() {
             drop(entry);
-            self.users.remove(key);
+            self.remove_if_empty(key);
             info!("Registration {} removed (no contacts remaining)", key);
         } else {
-            entry.expires = latest_expiry(&entry.contacts);
+            let (stored_key, bindings) = entry.pair_mut();
+            self.journal_put(stored_key, bindings);
         }
 
         Ok(())
@@ -218,8 +244,9 @@ impl UserRegistry {
             .users
             .get_mut(key)
             .ok_or_else(|| RegistrarError::UserNotFound(key.to_string()))?;
+        let (stored_key, bindings) = entry.pair_mut();
 
-        let contact = entry
+        let contact = bindings
             .contacts
             .iter_mut()
             .find(|c| c.uri == contact_uri)
@@ -229,7 +256,8 @@ impl UserRegistry {
             })?;
 
         contact.expires = expires_at;
-        entry.expires = latest_expiry(&entry.contacts);
+        self.file(stored_key, bindings);
+        self.journal_put(stored_key, bindings);
 
         debug!("Refreshed registration for {}:{}", key, contact_uri);
         Ok(())
@@ -238,21 +266,27 @@ impl UserRegistry {
     pub async fn get_registration(&self, key: &str) -> Result<UserRegistration> {
         self.users
             .get(key)
-            .map(|entry| entry.clone())
+            .map(|entry| entry.registration(entry.key()))
             .ok_or_else(|| RegistrarError::UserNotFound(key.to_string()))
     }
 
     pub async fn lookup_contacts(&self, key: &str) -> Result<Vec<ContactInfo>> {
-        Ok(self.get_registration(key).await?.contacts)
+        self.users
+            .get(key)
+            .map(|entry| entry.contacts.clone())
+            .ok_or_else(|| RegistrarError::UserNotFound(key.to_string()))
     }
 
     pub async fn lookup_live_contacts(&self, key: &str, method: &str) -> Result<Vec<ContactInfo>> {
         let now = Utc::now();
         let mut contacts: Vec<_> = self
-            .lookup_contacts(key)
-            .await?
-            .into_iter()
+            .users
+            .get(key)
+            .ok_or_else(|| RegistrarError::UserNotFound(key.to_string()))?
+            .contacts
+            .iter()
             .filter(|contact| contact.is_live_for(method, now))
+            .cloned()
             .collect();
         contacts.sort_by(contact_preference);
         Ok(contacts)
@@ -284,97 +318,248 @@ impl UserRegistry {
         self.users.contains_key(key)
     }
 
+    /// Number of registered keys.
+    pub fn len(&self) -> usize {
+        self.users.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.users.is_empty()
+    }
+
     pub async fn list_all_users(&self) -> Vec<String> {
-        self.users.iter().map(|entry| entry.key().clone()).collect()
+        self.users
+            .iter()
+            .map(|entry| entry.key().to_string())
+            .collect()
     }
 
     pub async fn get_all_registrations(&self) -> Vec<UserRegistration> {
         self.users
             .iter()
-            .map(|entry| entry.value().clone())
+            .map(|entry| entry.value().registration(entry.key()))
             .collect()
     }
 
+    /// Drop expired contacts and remove keys left without any, returning
+    /// the removed keys. Only keys the expiry index has due are visited.
     pub async fn expire_registrations(&self) -> Vec<String> {
-        let now = Utc::now();
+        self.expire_due(Utc::now())
+    }
+
+    fn expire_due(&self, now: DateTime<Utc>) -> Vec<String> {
         let mut expired_users = Vec::new();
-        let keys: Vec<String> = self.users.iter().map(|entry| entry.key().clone()).collect();
-
-        for key in keys {
-            let mut should_remove = false;
-            if let Some(mut entry) = self.users.get_mut(&key) {
-                entry.contacts.retain(|contact| contact.expires > now);
-                if entry.contacts.is_empty() {
-                    should_remove = true;
-                } else {
-                    entry.expires = latest_expiry(&entry.contacts);
-                }
+
+        for (second, key) in self.expiry.take_due(now.timestamp()) {
+            let Entry::Occupied(mut entry) = self.users.entry(key) else {
+                continue;
+            };
+            let bindings = entry.get_mut();
+            if bindings.filed_under != second {
+                // Filed again (or re-registered) since this entry was made.
+                continue;
             }
+            bindings.contacts.retain(|contact| contact.expires > now);
 
-            if should_remove && self.users.remove(&key).is_some() {
+            if bindings.contacts.is_empty() {
+                let (key, _) = entry.remove_entry();
                 warn!("Registration expired for {}", key);
-                expired_users.push(key);
+                expired_users.push(key.to_string());
+            } else {
+                // Refreshed since it was filed: file it at its new earliest expiry.
+                let key = Arc::clone(entry.key());
+                let bindings = entry.get_mut();
+                bindings.filed_under = UNFILED;
+                self.file(&key, bindings);
             }
         }
 
         expired_users
     }
 
+    /// Run `update` on the bindings of `key`, creating them if needed, and
+    /// keep the key filed in the expiry index. A key the update leaves
+    /// without contacts (a rejected first binding) is removed again.
+    fn update_bindings(
+        &self,
+        key: &str,
+        keyed_by_aor: bool,
+        update: impl FnOnce(&str, &mut Bindings) -> Result<()>,
+    ) -> Result<()> {
+        let mut entry = match self.users.get_mut(key) {
+            Some(entry) => entry,
+            None => self
+                .users
+                .entry(Arc::from(key))
+                .or_insert_with(|| Bindings::new(keyed_by_aor)),
+        };
+        let (stored_key, bindings) = entry.pair_mut();
+        let result = update(stored_key, bindings);
+        if result.is_ok() {
+            self.file(stored_key, bindings);
+        }
+
+        if bindings.contacts.is_empty() {
+            drop(entry);
+            self.remove_if_empty(key);
+        } else {
+            self.journal_put(stored_key, bindings);
+        }
+        result
+    }
+
+    fn remove_if_empty(&self, key: &str) {
+        self.users.remove_if(key, |key, bindings| {
+            let empty = bindings.contacts.is_empty();
+            if empty {
+                self.journal_remove(key);
+            }
+            empty
+        });
+    }
+
+    /// Attach the journal of a durable location store. Fails if one is
+    /// already attached.
+    pub(super) fn attach_journal(&self, journal: Journal) -> Result<()> {
+        self.journal.set(journal).map_err(|_| {
+            RegistrarError::StorageError("registry already has a location store".to_string())
+        })
+    }
+
+    /// Replace the bindings of `key` with `bindings` recovered from storage
+    /// or a replication stream. Contacts that expired meanwhile are dropped.
+    pub(super) fn restore(&self, key: &str, mut bindings: Bindings, now: DateTime<Utc>) {
+        bindings.contacts.retain(|contact| contact.expires > now);
+        if bindings.contacts.is_empty() {
+            self.forget(key);
+            return;
+        }
+        bindings.filed_under = UNFILED;
+        let mut entry = match self.users.get_mut(key) {
+            Some(entry) => entry,
+            None => self
+                .users
+                .entry(Arc::from(key))
+                .or_insert_with(|| Bindings::new(bindings.keyed_by_aor)),
+        };
+        let (stored_key, stored) = entry.pair_mut();
+        *stored = bindings;
+        self.file(stored_key, stored);
+        self.journal_put(stored_key, stored);
+    }
+
+    /// Remove `key` on behalf of storage or a replication stream.
+    pub(super) fn forget(&self, key: &str) {
+        self.users.remove_if(key, |key, _| {
+            self.journal_remove(key);
+            true
+        });
+    }
+
+    /// Every key currently bound. Paired with [`Self::with_bindings`] so a
+    /// snapshot or state transfer never does I/O under a shard lock.
+    pub(super) fn keys(&self) -> Vec<Arc<str>> {
+        self.users
+            .iter()
+            .map(|entry| Arc::clone(entry.key()))
+            .collect()
+    }
+
+    /// Read the bindings of `key` under its shard lock, if it is bound.
+    pub(super) fn with_bindings<T>(
+        &self,
+        key: &str,
+        read: impl FnOnce(&Bindings) -> T,
+    ) -> Option<T> {
+        self.users.get(key).map(|entry| read(entry.value()))
+    }
+
+    /// Forget every key `keep` rejects, to reconcile a resynchronised replica.
+    pub(super) fn retain_keys(&self, mut keep: impl FnMut(&str) -> bool) {
+        let stale: Vec<Arc<str>> = self
+            .users
+            .iter()
+            .filter(|entry| !keep(entry.key()))
+            .map(|entry| Arc::clone(entry.key()))
+            .collect();
+        for key in stale {
+            self.forget(&key);
+        }
+    }
+
+    fn journal_put(&self, key: &str, bindings: &Bindings) {
+        if let Some(journal) = self.journal.get() {
+            journal.put(key, bindings);
+        }
+    }
+
+    fn journal_remove(&self, key: &str) {
+        if let Some(journal) = self.journal.get() {
+            journal.remove(key);
+        }
+    }
+
+    /// Keep `key` filed under the first whole second at or after the expiry
+    /// of its earliest contact. A later expiry leaves the filing alone; the
+    /// sweep files it again.
+    fn file(&self, key: &Arc<str>, bindings: &mut Bindings) {
+        let Some(earliest) = bindings
+            .contacts
+            .iter()
+            .map(|contact| bucket_of(contact.expires))
+            .min()
+        else {
+            return;
+        };
+        if earliest < bindings.filed_under {
+            bindings.filed_under = earliest;
+            self.expiry.file(key, earliest);
+        }
+    }
+
     fn update_contact(
         &self,
-        registration: &mut UserRegistration,
+        key: &str,
+        contacts: &mut Vec<ContactInfo>,
         contact: ContactInfo,
-        expires_at: DateTime<Utc>,
     ) -> Result<()> {
-        registration
-            .contacts
-            .retain(|existing| !same_binding(existing, &contact));
+        contacts.retain(|existing| !same_binding(existing, &contact));
 
-        self.apply_contact_limit(registration)?;
-        registration.contacts.push(contact);
-        registration.expires = registration.expires.max(expires_at);
+        self.apply_contact_limit(key, contacts)?;
+        info!("Registration {} updated with contact {}", key, contact.uri);
+        contacts.push(contact);
         Ok(())
     }
 
-    fn apply_contact_limit(&self, registration: &mut UserRegistration) -> Result<()> {
+    fn apply_contact_limit(&self, key: &str, contacts: &mut Vec<ContactInfo>) -> Result<()> {
         if self.config.max_contacts_per_aor == 0 {
             return Err(RegistrarError::MaxContactsExceeded {
-                user: registration
-                    .aor
-                    .as_ref()
-                    .map(ToString::to_string)
-                    .unwrap_or_else(|| registration.user_id.clone()),
+                user: key.to_string(),
                 max: self.config.max_contacts_per_aor,
             });
         }
 
-        if registration.contacts.len() < self.config.max_contacts_per_aor {
+        if contacts.len() < self.config.max_contacts_per_aor {
             return Ok(());
         }
 
         if self.config.remove_unavailable {
-            registration
-                .contacts
-                .retain(|contact| contact.reachability != ContactReachability::Unreachable);
-            if registration.contacts.len() < self.config.max_contacts_per_aor {
+            contacts.retain(|contact| contact.reachability != ContactReachability::Unreachable);
+            if contacts.len() < self.config.max_contacts_per_aor {
                 return Ok(());
             }
         }
 
         if self.config.remove_existing {
-            registration.contacts.sort_by(lowest_preference_first);
-            if !registration.contacts.is_empty() {
-                registration.contacts.remove(0);
+            contacts.sort_by(lowest_preference_first);
+            if !contacts.is_empty() {
+                contacts.remove(0);
             }
             return Ok(());
         }
 
         Err(RegistrarError::MaxContactsExceeded {
-            user: registration
-                .aor
-                .as_ref()
-                .map(ToString::to_string)
-                .unwrap_or_else(|| registration.user_id.clone()),
+            user: key.to_string(),
             max: self.config.max_contacts_per_aor,
         })
     }
@@ -488,4 +673,74 @@ mod tests {
         registry.unregister("bob").await.unwrap();
         assert!(!registry.is_registered("bob").await);
     }
+
+    fn short_lived_registry() -> UserRegistry {
+        UserRegistry::with_config(RegistryConfig {
+            min_expires: 1,
+            ..RegistryConfig::default()
+        })
+    }
+
+    #[tokio::test]
+    async fn test_expiry_sweep_visits_only_due_bindings() {
+        let registry = short_lived_registry();
+        registry
+            .register("alice", contact("sip:alice@192.0.2.1", 1.0), 1)
+            .await
+            .unwrap();
+        registry
+            .register("bob", contact("sip:bob@192.0.2.2", 1.0), 3600)
+            .await
+            .unwrap();
+
+        assert!(registry.expire_due(Utc::now()).is_empty());
+        let expired = registry.expire_due(Utc::now() + Duration::seconds(2));
+        assert_eq!(expired, vec!["alice".to_string()]);
+        assert!(!registry.is_registered("alice").await);
+        assert!(registry.is_registered("bob").await);
+        // Only bob's filing is left.
+        assert_eq!(registry.expiry.len(), 1);
+    }
+
+    #[tokio::test]
+    async fn test_refreshed_binding_is_filed_again() {
+        let registry = short_lived_registry();
+        let uri = "sip:alice@192.0.2.1";
+        registry
+            .register("alice", contact(uri, 1.0), 1)
+            .await
+            .unwrap();
+        registry.refresh("alice", uri, 3600).await.unwrap();
+
+        assert!(registry
+            .expire_due(Utc::now() + Duration::seconds(2))
+            .is_empty());
+        assert!(registry.is_registered("alice").await);
+        assert_eq!(registry.expiry.len(), 1);
+
+        let expired = registry.expire_due(Utc::now() + Duration::seconds(3602));
+        assert_eq!(expired, vec!["alice".to_string()]);
+    }
+
+    #[tokio::test]
+    async fn test_expired_contact_leaves_the_rest_of_the_aor() {
+        let registry = short_lived_registry();
+        let aor = AddressOfRecord::parse("sip:alice@example.com").unwrap();
+        let mut mobile = contact("sip:alice@192.0.2.1", 1.0);
+        mobile.instance_id = "device-2".to_string();
+        registry
+            .register_aor(&aor, contact("sip:alice@192.0.2.9", 1.0), 3600)
+            .await
+            .unwrap();
+        registry.register_aor(&aor, mobile, 1).await.unwrap();
+
+        assert!(registry
+            .expire_due(Utc::now() + Duration::seconds(2))
+            .is_empty());
+        let registration = registry.get_registration(aor.as_str()).await.unwrap();
+        assert_eq!(registration.user_id, "alice");
+        assert_eq!(registration.aor.as_ref(), Some(&aor));
+        assert_eq!(registration.contacts.len(), 1);
+        assert_eq!(registration.contacts[0].uri, "sip:alice@192.0.2.9");
+    }
 }
@@ -4,6 +4,8 @@ use chrono::{DateTime, Utc};
 use serde::{Deserialize, Serialize};
 use std::collections::HashMap;
 use std::fmt;
+use std::net::SocketAddr;
+use std::path::PathBuf;
 use std::str::FromStr;
 
 // ============ Registration Types ============
@@ -55,6 +57,11 @@ impl AddressOfRecord {
         Self::parse(&format!("sip:{user}@{domain}"))
     }
 
+    /// Wrap a string already in the form [`AddressOfRecord::parse`] produces.
+    pub(crate) fn from_canonical(aor: &str) -> Self {
+        Self(aor.to_string())
+    }
+
     pub fn as_str(&self) -> &str {
         &self.0
     }
@@ -460,8 +467,14 @@ pub struct RegistrarConfig {
     /// Maximum subscriptions per user
     pub max_subscriptions_per_user: usize,
 
-    /// Expiry check interval in seconds
+    /// Expiry check interval in seconds. A sweep only visits the bindings
+    /// that are due, so short intervals are cheap; a binding outlives its
+    /// expiry by at most this much plus the rounding to a whole second.
     pub expiry_check_interval: u64,
+
+    /// Durable location store. None keeps bindings in memory only.
+    #[serde(default)]
+    pub location_store: Option<LocationStoreConfig>,
 }
 
 impl Default for RegistrarConfig {
@@ -480,7 +493,52 @@ impl Default for RegistrarConfig {
             qualify_timeout: 3,
             support_path: true,
             max_subscriptions_per_user: 100,
-            expiry_check_interval: 30, // Check every 30 seconds
+            expiry_check_interval: 1, // Sweep due buckets every second
+            location_store: None,
         }
     }
 }
+
+/// Configuration of the durable location store: a write-ahead log of
+/// binding changes plus periodic snapshots, optionally streamed to a hot
+/// standby.
+#[derive(Debug, Clone, Serialize, Deserialize)]
+pub struct LocationStoreConfig {
+    /// Directory holding the snapshot and WAL segments.
+    pub dir: PathBuf,
+
+    /// Interval in seconds between snapshots; each one lets the WAL
+    /// segments it covers be deleted.
+    #[serde(default = "LocationStoreConfig::default_snapshot_interval")]
+    pub snapshot_interval: u64,
+
+    /// Sync the WAL at most this often, in milliseconds. 0 syncs every
+    /// group-committed batch; larger values trade that much data on power
+    /// loss for fewer syncs.
+    #[serde(default)]
+    pub sync_interval_ms: u64,
+
+    /// Address to stream the WAL to hot standbys from.
+    #[serde(default)]
+    pub replication_listen: Option<SocketAddr>,
+
+    /// Primary to follow as a hot standby.
+    #[serde(default)]
+    pub replicate_from: Option<SocketAddr>,
+}
+
+impl LocationStoreConfig {
+    pub fn new(dir: impl Into<PathBuf>) -> Self {
+        Self {
+            dir: dir.into(),
+            snapshot_interval: Self::default_snapshot_interval(),
+            sync_interval_ms: 0,
+            replication_listen: None,
+            replicate_from: None,
+        }
+    }
+
+    fn default_snapshot_interval() -> u64 {
+        300
+    }
+}
@@ -0,0 +1,231 @@
+//! Failover between two registrar processes sharing a replicated location
+//! store.
+//!
+//! The test re-runs its own binary twice, selected by `RVOIP_FAILOVER_ROLE`:
+//! a primary that registers bindings and streams its WAL, and a hot standby
+//! that follows it. The parent kills the primary with SIGKILL, promotes the
+//! standby and checks it serves every binding and takes new ones, then
+//! recovers the killed primary's directory to check nothing synced was lost.
+
+use chrono::{Duration, Utc};
+use rvoip_sip_registrar::{
+    AddressOfRecord, ContactInfo, ContactReachability, LocationStoreConfig, Registrar,
+    RegistrarConfig, Transport,
+};
+use std::io::{BufRead, BufReader, Write};
+use std::path::{Path, PathBuf};
+use std::process::{Child, ChildStdin, ChildStdout, Command, Stdio};
+
+const BINDINGS: usize = 2_000;
+const ROLE: &str = "RVOIP_FAILOVER_ROLE";
+const DIR: &str = "RVOIP_FAILOVER_DIR";
+const PRIMARY: &str = "RVOIP_FAILOVER_PRIMARY";
+
+fn aor(i: usize) -> AddressOfRecord {
+    AddressOfRecord::parse(&format!("sip:user{i}@example.com")).unwrap()
+}
+
+fn contact(i: usize) -> ContactInfo {
+    ContactInfo {
+        uri: format!("sip:user{i}@192.0.2.{}:5060", i % 250 + 1),
+        instance_id: format!("instance-{i}"),
+        transport: Transport::UDP,
+        user_agent: "registrar-core-test".to_string(),
+        expires: Utc::now() + Duration::minutes(10),
+        q_value: 1.0,
+        received: None,
+        path: Vec::new(),
+        methods: vec!["INVITE".to_string()],
+        reg_id: None,
+        flow_id: None,
+        reachability: ContactReachability::Unknown,
+    }
+}
+
+fn config(store: LocationStoreConfig) -> RegistrarConfig {
+    RegistrarConfig {
+        location_store: Some(store),
+        ..RegistrarConfig::default()
+    }
+}
+
+async fn assert_all_bound(registrar: &Registrar) {
+    for i in 0..BINDINGS {
+        let contacts = registrar.lookup_aor(&aor(i)).await.unwrap();
+        assert_eq!(contacts[0].uri, contact(i).uri);
+    }
+}
+
+async fn run_primary(dir: PathBuf) {
+    let mut store = LocationStoreConfig::new(dir);
+    store.replication_listen = Some("127.0.0.1:0".parse().unwrap());
+    let registrar = Registrar::open(config(store)).unwrap();
+    for i in 0..BINDINGS {
+        registrar
+            .register_aor(&aor(i), contact(i), 600)
+            .await
+            .unwrap();
+    }
+    let location = registrar.location_store().unwrap();
+    location.sync().unwrap();
+    println!("LISTEN {}", location.replication_addr().unwrap());
+    std::io::stdout().flush().unwrap();
+    // Serve until killed.
+    loop {
+        std::thread::sleep(std::time::Duration::from_secs(60));
+    }
+}
+
+async fn run_standby(dir: PathBuf, primary: &str) {
+    let mut store = LocationStoreConfig::new(dir.clone());
+    store.replicate_from = Some(primary.parse().unwrap());
+    let registrar = Registrar::open(config(store.clone())).unwrap();
+    let deadline = std::time::Instant::now() + std::time::Duration::from_secs(30);
+    while !(registrar.is_standby_synced() && registrar.list_users().await.len() == BINDINGS) {
+        assert!(std::time::Instant::now() < deadline, "standby never synced");
+        std::thread::sleep(std::time::Duration::from_millis(20));
+    }
+    println!("SYNCED");
+    std::io::stdout().flush().unwrap();
+
+    let mut line = String::new();
+    std::io::stdin().read_line(&mut line).unwrap();
+    assert_eq!(line.trim(), "PROMOTE");
+    assert!(registrar.promote());
+    assert_all_bound(&registrar).await;
+    registrar
+        .register_aor(&aor(BINDINGS), contact(BINDINGS), 600)
+        .await
+        .unwrap();
+    registrar.location_store().unwrap().sync().unwrap();
+    drop(registrar);
+
+    // The standby journaled what it replicated, plus its own write.
+    store.replicate_from = None;
+    let registrar = Registrar::open(config(store)).unwrap();
+    assert_eq!(registrar.list_users().await.len(), BINDINGS + 1);
+    assert_all_bound(&registrar).await;
+    println!("PROMOTED");
+}
+
+/// Kills the child if the test fails before it exits.
+struct Process {
+    child: Child,
+    stdout: BufReader<ChildStdout>,
+    stdin: Option<ChildStdin>,
+}
+
+impl Process {
+    fn spawn(role: &str, dir: &Path, primary: Option<&str>) -> Self {
+        let mut command = Command::new(std::env::current_exe().unwrap());
+        command
+            .args(["--exact", "primary_failover_to_standby", "--nocapture"])
+            .env(ROLE, role)
+            .env(DIR, dir)
+            .stdin(Stdio::piped())
+            .stdout(Stdio::piped());
+        if let Some(primary) = primary {
+            command.env(PRIMARY, primary);
+        }
+        let mut child = command.spawn().unwrap();
+        Self {
+            stdout: BufReader::new(child.stdout.take().unwrap()),
+            stdin: child.stdin.take(),
+            child,
+        }
+    }
+
+    /// Read lines until one contains `prefix`; returns the rest of it. The
+    /// harness prints the test name on the same line as the first output.
+    fn expect(&mut self, prefix: &str) -> String {
+        let mut line = String::new();
+        loop {
+            line.clear();
+            let read = self.stdout.read_line(&mut line).unwrap();
+            assert!(read > 0, "child exited before printing {prefix}");
+            if let Some(at) = line.find(prefix) {
+                return line[at + prefix.len()..].trim().to_string();
+            }
+        }
+    }
+}
+
+impl Drop for Process {
+    fn drop(&mut self) {
+        let _ = self.child.kill();
+        let _ = self.child.wait();
+    }
+}
+
+fn temp_dir(name: &str) -> PathBuf {
+    let dir = std::env::temp_dir().join(format!("rvoip-failover-{}-{}", name, std::process::id()));
+    let _ = std::fs::remove_dir_all(&dir);
+    dir
+}
+
+#[tokio::test]
+async fn primary_failover_to_standby() {
+    match std::env::var(ROLE).as_deref() {
+        Ok("primary") => return run_primary(std::env::var(DIR).unwrap().into()).await,
+        Ok("standby") => {
+            let primary = std::env::var(PRIMARY).unwrap();
+            return run_standby(std::env::var(DIR).unwrap().into(), &primary).await;
+        }
+        _ => {}
+    }
+
+    let primary_dir = temp_dir("primary");
+    let standby_dir = temp_dir("standby");
+    let mut primary = Process::spawn("primary", &primary_dir, None);
+    let addr = primary.expect("LISTEN");
+    let mut standby = Process::spawn("standby", &standby_dir, Some(&addr));
+    standby.expect("SYNCED");
+
+    primary.child.kill().unwrap();
+    primary.child.wait().unwrap();
+    let stdin = standby.stdin.as_mut().unwrap();
+    stdin.write_all(b"PROMOTE\n").unwrap();
+    stdin.flush().unwrap();
+    standby.expect("PROMOTED");
+    assert!(standby.child.wait().unwrap().success());
+
+    // The killed primary recovers everything it synced.
+    let recovered = Registrar::open(config(LocationStoreConfig::new(&primary_dir))).unwrap();
+    assert_eq!(recovered.list_users().await.len(), BINDINGS);
+    assert_all_bound(&recovered).await;
+    drop(recovered);
+
+    let _ = std::fs::remove_dir_all(&primary_dir);
+    let _ = std::fs::remove_dir_all(&standby_dir);
+}
+
+#[tokio::test]
+async fn stalled_standby_does_not_block_shutdown() {
+    let dir = temp_dir("stalled");
+    let mut store = LocationStoreConfig::new(&dir);
+    store.replication_listen = Some("127.0.0.1:0".parse().unwrap());
+    let registrar = Registrar::open(config(store)).unwrap();
+    // Enough state that the transfer fills the socket buffers of a
+    // standby that never reads.
+    for i in 0..50_000 {
+        registrar
+            .register_aor(&aor(i), contact(i), 600)
+            .await
+            .unwrap();
+    }
+    let addr = registrar
+        .location_store()
+        .unwrap()
+        .replication_addr()
+        .unwrap();
+    let _standby = std::net::TcpStream::connect(addr).unwrap();
+    tokio::time::sleep(std::time::Duration::from_secs(1)).await;
+
+    let closing = tokio::task::spawn_blocking(move || drop(registrar));
+    tokio::time::timeout(std::time::Duration::from_secs(30), closing)
+        .await
+        .expect("shutdown is not held up by a stalled standby")
+        .unwrap();
+
+    let _ = std::fs::remove_dir_all(&dir);
+}
@@ -0,0 +1,155 @@
+//! TCP transport fan-out benchmark.
+//!
+//! One `TcpTransport` holds `N` accepted connections and sends a
+//! pre-built response to every peer, from several tasks at once — the
+//! shape of a registrar or SBC answering thousands of TCP/TLS endpoints.
+//! Each send looks the peer up in the connection pool and queues the
+//! frame on that connection's writer task, so this is where pool lookup
+//! and write-path contention show up.
+//!
+//! `RVOIP_BENCH_TCP_CONNECTIONS` sets `N` (default 1000). 10k
+//! connections need `ulimit -n` above 20k: both ends live in this
+//! process.
+
+use criterion::{criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+use rvoip_sip_transport::transport::tcp::PoolConfig;
+use rvoip_sip_transport::{TcpTransport, Transport};
+use std::net::SocketAddr;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::Arc;
+use std::time::{Duration, Instant};
+use tokio::io::AsyncReadExt;
+use tokio::net::TcpStream;
+use tokio::runtime::Builder;
+use tokio::sync::Notify;
+
+const SENDER_TASKS: usize = 8;
+
+const SAMPLE_RESPONSE: &[u8] = b"SIP/2.0 200 OK\r\n\
+Via: SIP/2.0/TCP pc33.atlanta.example.com:5060;branch=z9hG4bKtcpbench\r\n\
+To: Bob <sip:bob@biloxi.example.com>;tag=tcpbench\r\n\
+From: Alice <sip:alice@atlanta.example.com>;tag=tcpbench\r\n\
+Call-ID: tcpbench@pc33.atlanta.example.com\r\n\
+CSeq: 1 REGISTER\r\n\
+Content-Length: 0\r\n\r\n";
+
+fn connection_count() -> usize {
+    std::env::var("RVOIP_BENCH_TCP_CONNECTIONS")
+        .ok()
+        .and_then(|v| v.parse().ok())
+        .unwrap_or(1000)
+}
+
+/// Peer side of the fan-out: N client sockets that count received bytes
+struct Peers {
+    addrs: Vec<SocketAddr>,
+    received: Arc<AtomicUsize>,
+    progress: Arc<Notify>,
+}
+
+async fn connect_peers(server: &TcpTransport, count: usize) -> Peers {
+    let server_addr = server.local_addr().expect("server addr");
+    let received = Arc::new(AtomicUsize::new(0));
+    let progress = Arc::new(Notify::new());
+    let mut addrs = Vec::with_capacity(count);
+
+    for _ in 0..count {
+        let mut stream = TcpStream::connect(server_addr).await.expect("connect");
+        addrs.push(stream.local_addr().expect("peer addr"));
+        let received = received.clone();
+        let progress = progress.clone();
+        tokio::spawn(async move {
+            let mut buf = vec![0u8; 16 * 1024];
+            while let Ok(n) = stream.read(&mut buf).await {
+                if n == 0 {
+                    break;
+                }
+                received.fetch_add(n, Ordering::Relaxed);
+                progress.notify_one();
+            }
+        });
+    }
+
+    // Wait until the server has pooled every accepted connection.
+    while !addrs.iter().all(|addr| server.has_connection_to(*addr)) {
+        tokio::time::sleep(Duration::from_millis(10)).await;
+    }
+    Peers {
+        addrs,
+        received,
+        progress,
+    }
+}
+
+fn bench_fanout(c: &mut Criterion) {
+    let rt = Builder::new_multi_thread()
+        .worker_threads(4)
+        .enable_all()
+        .build()
+        .expect("runtime");
+    let connections = connection_count();
+
+    let (server, peers) = rt.block_on(async {
+        let pool = PoolConfig {
+            max_connections: connections,
+            ..PoolConfig::default()
+        };
+        let (server, _events) =
+            TcpTransport::bind("127.0.0.1:0".parse().unwrap(), Some(1024), Some(pool))
+                .await
+                .expect("bind server");
+        let peers = connect_peers(&server, connections).await;
+        (server, peers)
+    });
+    let peers = Arc::new(peers);
+    let payload = bytes::Bytes::from_static(SAMPLE_RESPONSE);
+
+    let mut group = c.benchmark_group("transport_tcp_fanout");
+    group.throughput(Throughput::Elements(connections as u64));
+    group.bench_with_input(
+        BenchmarkId::from_parameter(connections),
+        &connections,
+        |b, _| {
+            b.iter_custom(|iters| {
+                rt.block_on(async {
+                    let start = Instant::now();
+                    for _ in 0..iters {
+                        let target = peers.received.load(Ordering::Relaxed)
+                            + peers.addrs.len() * SAMPLE_RESPONSE.len();
+                        let senders: Vec<_> = (0..SENDER_TASKS)
+                            .map(|task| {
+                                let server = server.clone();
+                                let peers = peers.clone();
+                                let payload = payload.clone();
+                                tokio::spawn(async move {
+                                    for addr in peers.addrs.iter().skip(task).step_by(SENDER_TASKS)
+                                    {
+                                        server
+                                            .send_message_raw(payload.clone(), *addr)
+                                            .await
+                                            .expect("send");
+                                    }
+                                })
+                            })
+                            .collect();
+                        for sender in senders {
+                            sender.await.expect("sender task");
+                        }
+                        while peers.received.load(Ordering::Relaxed) < target {
+                            peers.progress.notified().await;
+                        }
+                    }
+                    start.elapsed()
+                })
+            });
+        },
+    );
+    group.finish();
+
+    rt.block_on(async {
+        server.close().await.ok();
+    });
+}
+
+criterion_group!(benches, bench_fanout);
+criterion_main!(benches);
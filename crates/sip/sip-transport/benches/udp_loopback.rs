@@ -14,16 +14,30 @@
 //!   receive task + parser + `TransportEvent` channel. Closer to what
 //!   a SIP stack sees in production. Driven by a real INVITE message
 //!   so the inbound parser succeeds.
+//! - `transport_udp_reuse_port` — `UdpTransport` bound with 1, 4 and 16
+//!   `SO_REUSEPORT` receive sockets, fed by many sender sockets so the
+//!   kernel spreads flows across them. Reports messages/sec received and
+//!   parsed; this is where per-socket receive loops show (or don't) on a
+//!   multi-core box.
 
 use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
 use rvoip_sip_transport::transport::udp::UdpListener;
-use rvoip_sip_transport::{Transport, TransportEvent, UdpTransport};
-use std::time::Instant;
+use rvoip_sip_transport::{Transport, TransportEvent, UdpSocketOptions, UdpTransport};
+use std::sync::Arc;
+use std::time::{Duration, Instant};
 use tokio::net::UdpSocket;
 use tokio::runtime::Builder;
 
 const PACKET_SIZES: [usize; 4] = [200, 1024, 4096, 8000];
 const LOOPBACK: &str = "127.0.0.1:0";
+const RECEIVE_SOCKET_COUNTS: [usize; 3] = [1, 4, 16];
+/// Distinct source sockets (flows) in the reuse-port bench
+const REUSE_PORT_SENDERS: usize = 32;
+/// Datagrams each sender sends per iteration; small enough that one burst
+/// fits a single receive socket's buffer on loopback
+const REUSE_PORT_BURST_PER_SENDER: usize = 2;
+/// Requested `SO_RCVBUF` per receive socket (capped by `net.core.rmem_max`)
+const REUSE_PORT_RECV_BUFFER: usize = 1 << 20;
 
 /// Real INVITE used to drive the full-stack bench; the transport parses
 /// inbound bytes before emitting `TransportEvent::MessageReceived`.
@@ -124,9 +138,87 @@ fn bench_full_stack_roundtrip(c: &mut Criterion) {
     group.finish();
 }
 
+fn bench_reuse_port_throughput(c: &mut Criterion) {
+    let rt = Builder::new_multi_thread()
+        .enable_all()
+        .build()
+        .expect("runtime");
+    let burst = REUSE_PORT_SENDERS * REUSE_PORT_BURST_PER_SENDER;
+
+    let mut group = c.benchmark_group("transport_udp_reuse_port");
+    group.throughput(Throughput::Elements(burst as u64));
+    for &sockets in &RECEIVE_SOCKET_COUNTS {
+        group.bench_with_input(
+            BenchmarkId::from_parameter(sockets),
+            &sockets,
+            |b, &sockets| {
+                b.iter_custom(|iters| {
+                    rt.block_on(async {
+                        let options = UdpSocketOptions::new(Some(REUSE_PORT_RECV_BUFFER), None)
+                            .with_receive_sockets(sockets);
+                        let (transport, mut events) = UdpTransport::bind_with_socket_options(
+                            LOOPBACK.parse().unwrap(),
+                            Some(4 * burst),
+                            options,
+                        )
+                        .await
+                        .expect("bind transport");
+                        let transport_addr = transport.local_addr().expect("local addr");
+                        let mut senders = Vec::with_capacity(REUSE_PORT_SENDERS);
+                        for _ in 0..REUSE_PORT_SENDERS {
+                            senders.push(Arc::new(
+                                UdpSocket::bind(LOOPBACK).await.expect("bind sender"),
+                            ));
+                        }
+
+                        let start = Instant::now();
+                        for _ in 0..iters {
+                            for sender in &senders {
+                                let sender = sender.clone();
+                                tokio::spawn(async move {
+                                    for _ in 0..REUSE_PORT_BURST_PER_SENDER {
+                                        sender
+                                            .send_to(SAMPLE_INVITE, transport_addr)
+                                            .await
+                                            .expect("send");
+                                    }
+                                });
+                            }
+                            let mut received = 0;
+                            while received < burst {
+                                match tokio::time::timeout(Duration::from_secs(5), events.recv())
+                                    .await
+                                {
+                                    Ok(Some(TransportEvent::MessageReceived {
+                                        message, ..
+                                    })) => {
+                                        black_box(message);
+                                        received += 1;
+                                    }
+                                    Ok(Some(_other)) => continue,
+                                    Ok(None) => panic!("transport channel closed"),
+                                    Err(_) => panic!(
+                                        "{received}/{burst} datagrams received; \
+                                         the kernel dropped some (socket buffers too small?)"
+                                    ),
+                                }
+                            }
+                        }
+                        let elapsed = start.elapsed();
+                        transport.close().await.ok();
+                        elapsed
+                    })
+                });
+            },
+        );
+    }
+    group.finish();
+}
+
 criterion_group!(
     benches,
     bench_listener_roundtrip,
-    bench_full_stack_roundtrip
+    bench_full_stack_roundtrip,
+    bench_reuse_port_throughput
 );
 criterion_main!(benches);
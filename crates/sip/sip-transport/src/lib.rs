@@ -18,12 +18,14 @@ mod tests;
 
 // Re-export commonly used types and functions
 pub use error::{Error, Result};
-pub use resolver::{select_transport_for_uri, ResolvedTarget, Resolver, ResolverError};
+pub use resolver::{
+    select_transport_for_uri, CachingResolver, ResolvedTarget, Resolver, ResolverError,
+};
 pub use transport::tcp::TcpTransport;
 pub use transport::tls::TlsTransport;
 pub use transport::udp::{UdpParseConfig, UdpParseDispatch, UdpSocketOptions, UdpTransport};
 pub use transport::ws::WebSocketTransport;
-pub use transport::{Transport, TransportEvent, TransportReceiveTiming};
+pub use transport::{Transport, TransportEvent, TransportReceiveTiming, WireCache};
 
 // Simplified helper functions
 /// Bind a UDP transport to the specified address
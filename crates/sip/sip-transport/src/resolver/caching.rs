@@ -0,0 +1,575 @@
+//! TTL-aware result cache in front of any [`Resolver`].
+//!
+//! [`CachingResolver`] caches the final candidate list per URI key
+//! (scheme, host, port, `;transport=`) so repeated requests towards the
+//! same trunk skip the NAPTR → SRV → A/AAAA ladder entirely:
+//!
+//! - Positive results live until the earliest candidate `expires`
+//!   deadline (the DNS TTL), clamped to [`CachingResolverConfig::min_ttl`]
+//!   and [`CachingResolverConfig::max_ttl`]. Candidates without a
+//!   deadline (IP literals, resolvers that do not report TTLs) use
+//!   [`CachingResolverConfig::default_ttl`].
+//! - Once an entry is within [`CachingResolverConfig::prefetch_before`] of
+//!   expiring, the next hit still returns it but starts a background
+//!   refresh (stale-while-revalidate), so a busy key never blocks on DNS.
+//! - Hard failures — `NoCandidates` (NXDOMAIN / no records),
+//!   `InvalidHost`, `Forbidden` — and empty candidate lists are cached for
+//!   [`CachingResolverConfig::negative_ttl`]. Transient `Dns` errors are
+//!   not cached, and a failed refresh keeps the previous entry until it
+//!   expires.
+//! - Concurrent misses for one key share a single lookup.
+//!
+//! Lookups run as spawned tasks, so a caller that gives up (e.g. its
+//! transaction timed out) does not cancel the lookup other callers are
+//! waiting on; the task ends when the inner resolver returns.
+
+use std::collections::HashMap;
+use std::sync::{Arc, Mutex};
+use std::time::Duration;
+
+use async_trait::async_trait;
+use rvoip_sip_core::Uri;
+use tokio::sync::watch;
+use tokio::time::Instant;
+use tracing::debug;
+
+use super::{ResolvedTarget, Resolver, ResolverError};
+
+type LookupResult = Result<Vec<ResolvedTarget>, ResolverError>;
+
+/// Tuning for [`CachingResolver`].
+#[derive(Debug, Clone)]
+pub struct CachingResolverConfig {
+    /// Lifetime of results that carry no TTL deadline.
+    pub default_ttl: Duration,
+    /// Lower bound on a positive entry's lifetime, so zero-TTL records
+    /// do not turn every request into a lookup.
+    pub min_ttl: Duration,
+    /// Upper bound on a positive entry's lifetime.
+    pub max_ttl: Duration,
+    /// Lifetime of cached hard failures (NXDOMAIN and friends).
+    pub negative_ttl: Duration,
+    /// Start a background refresh on hits this close to expiry. Capped
+    /// at half of the entry's lifetime.
+    pub prefetch_before: Duration,
+    /// Maximum number of cached keys. When full, expired entries are
+    /// dropped first, then the one expiring soonest.
+    pub max_entries: usize,
+}
+
+impl Default for CachingResolverConfig {
+    fn default() -> Self {
+        Self {
+            default_ttl: Duration::from_secs(60),
+            min_ttl: Duration::from_secs(5),
+            max_ttl: Duration::from_secs(3600),
+            negative_ttl: Duration::from_secs(30),
+            prefetch_before: Duration::from_secs(10),
+            max_entries: 4096,
+        }
+    }
+}
+
+/// Cache key: the URI parts RFC 3263 resolution depends on.
+#[derive(Debug, Clone, PartialEq, Eq, Hash)]
+struct CacheKey {
+    scheme: String,
+    host: String,
+    port: Option<u16>,
+    transport: Option<String>,
+}
+
+impl CacheKey {
+    fn from_uri(uri: &Uri) -> Self {
+        Self {
+            scheme: uri.scheme().to_string(),
+            host: uri.host.to_string().to_ascii_lowercase(),
+            port: uri.port,
+            transport: uri.transport().map(str::to_ascii_lowercase),
+        }
+    }
+}
+
+#[derive(Debug)]
+enum CachedResult {
+    Positive {
+        targets: Vec<ResolvedTarget>,
+        prefetch_at: Instant,
+    },
+    Negative(ResolverError),
+}
+
+#[derive(Debug)]
+struct CacheEntry {
+    result: CachedResult,
+    expires_at: Instant,
+}
+
+#[derive(Debug, Default)]
+struct CacheState {
+    entries: Mutex<HashMap<CacheKey, CacheEntry>>,
+    in_flight: Mutex<HashMap<CacheKey, watch::Receiver<Option<LookupResult>>>>,
+}
+
+/// [`Resolver`] wrapper that caches results of an inner resolver. See the
+/// module docs for the caching rules.
+pub struct CachingResolver {
+    inner: Arc<dyn Resolver>,
+    config: CachingResolverConfig,
+    state: Arc<CacheState>,
+}
+
+impl std::fmt::Debug for CachingResolver {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("CachingResolver")
+            .field("config", &self.config)
+            .field("entries", &self.len())
+            .finish_non_exhaustive()
+    }
+}
+
+impl CachingResolver {
+    /// Wrap `inner` with the default cache configuration.
+    pub fn new(inner: Arc<dyn Resolver>) -> Self {
+        Self::with_config(inner, CachingResolverConfig::default())
+    }
+
+    pub fn with_config(inner: Arc<dyn Resolver>, config: CachingResolverConfig) -> Self {
+        Self {
+            inner,
+            config,
+            state: Arc::new(CacheState::default()),
+        }
+    }
+
+    /// Number of cached keys, including expired ones not yet evicted.
+    pub fn len(&self) -> usize {
+        self.state.entries.lock().map_or(0, |entries| entries.len())
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    /// Drop the cached result for `uri`, if any.
+    pub fn invalidate(&self, uri: &Uri) {
+        if let Ok(mut entries) = self.state.entries.lock() {
+            entries.remove(&CacheKey::from_uri(uri));
+        }
+    }
+
+    /// Drop every cached result.
+    pub fn clear(&self) {
+        if let Ok(mut entries) = self.state.entries.lock() {
+            entries.clear();
+        }
+    }
+
+    /// Cached result for `key` if still valid; `prefetch` is set when the
+    /// entry is due for a background refresh.
+    fn cached(&self, key: &CacheKey, now: Instant) -> Option<(LookupResult, bool)> {
+        let entries = self.state.entries.lock().ok()?;
+        let entry = entries.get(key)?;
+        if now >= entry.expires_at {
+            return None;
+        }
+        Some(match &entry.result {
+            CachedResult::Positive {
+                targets,
+                prefetch_at,
+            } => (Ok(targets.clone()), now >= *prefetch_at),
+            CachedResult::Negative(error) => (Err(error.clone()), false),
+        })
+    }
+
+    /// Subscribe to the in-flight lookup for `key`, starting one if none
+    /// is running.
+    fn lookup(&self, key: CacheKey, uri: &Uri) -> watch::Receiver<Option<LookupResult>> {
+        let mut in_flight = match self.state.in_flight.lock() {
+            Ok(in_flight) => in_flight,
+            Err(poisoned) => poisoned.into_inner(),
+        };
+        if let Some(rx) = in_flight.get(&key) {
+            // A closed sender means the lookup task died without
+            // answering; start over rather than hand out a dead channel.
+            if rx.has_changed().is_ok() {
+                return rx.clone();
+            }
+        }
+
+        let (tx, rx) = watch::channel(None);
+        in_flight.insert(key.clone(), rx.clone());
+        drop(in_flight);
+
+        let inner = self.inner.clone();
+        let config = self.config.clone();
+        let guard = InFlightGuard {
+            state: self.state.clone(),
+            key,
+            rx: rx.clone(),
+            tx,
+        };
+        let uri = uri.clone();
+        tokio::spawn(async move {
+            let result = inner.resolve(&uri).await;
+            guard.state.store(&config, &guard.key, &result);
+            let _ = guard.tx.send(Some(result));
+        });
+        rx
+    }
+}
+
+/// Owned by a lookup task; unregisters the lookup from `in_flight`
+/// however the task ends, including a panicking resolver or a cancelled
+/// task, so later lookups of the key start afresh.
+struct InFlightGuard {
+    state: Arc<CacheState>,
+    key: CacheKey,
+    /// Receiver registered for this lookup, to tell it apart from a
+    /// newer one under the same key
+    rx: watch::Receiver<Option<LookupResult>>,
+    tx: watch::Sender<Option<LookupResult>>,
+}
+
+impl Drop for InFlightGuard {
+    fn drop(&mut self) {
+        let mut in_flight = match self.state.in_flight.lock() {
+            Ok(in_flight) => in_flight,
+            Err(poisoned) => poisoned.into_inner(),
+        };
+        if in_flight
+            .get(&self.key)
+            .is_some_and(|rx| rx.same_channel(&self.rx))
+        {
+            in_flight.remove(&self.key);
+        }
+    }
+}
+
+impl CacheState {
+    fn store(&self, config: &CachingResolverConfig, key: &CacheKey, result: &LookupResult) {
+        let now = Instant::now();
+        let entry = match result {
+            Ok(targets) if !targets.is_empty() => {
+                let ttl = targets
+                    .iter()
+                    .filter_map(|target| target.expires)
+                    .min()
+                    .map_or(config.default_ttl, |deadline| {
+                        deadline.saturating_duration_since(std::time::Instant::now())
+                    })
+                    .clamp(config.min_ttl, config.max_ttl.max(config.min_ttl));
+                let prefetch = config.prefetch_before.min(ttl / 2);
+                CacheEntry {
+                    result: CachedResult::Positive {
+                        targets: targets.clone(),
+                        prefetch_at: now + (ttl - prefetch),
+                    },
+                    expires_at: now + ttl,
+                }
+            }
+            Ok(_) => CacheEntry {
+                result: CachedResult::Positive {
+                    targets: Vec::new(),
+                    prefetch_at: now + config.negative_ttl,
+                },
+                expires_at: now + config.negative_ttl,
+            },
+            // Transient: keep whatever is cached (a refresh that failed
+            // leaves the previous answer in place until it expires).
+            Err(ResolverError::Dns(error)) => {
+                debug!(?key, %error, "DNS lookup failed; result not cached");
+                return;
+            }
+            Err(error) => CacheEntry {
+                result: CachedResult::Negative(error.clone()),
+                expires_at: now + config.negative_ttl,
+            },
+        };
+
+        let Ok(mut entries) = self.entries.lock() else {
+            return;
+        };
+        if entries.len() >= config.max_entries && !entries.contains_key(key) {
+            entries.retain(|_, entry| entry.expires_at > now);
+            if entries.len() >= config.max_entries {
+                let soonest = entries
+                    .iter()
+                    .min_by_key(|(_, entry)| entry.expires_at)
+                    .map(|(key, _)| key.clone());
+                if let Some(soonest) = soonest {
+                    entries.remove(&soonest);
+                }
+            }
+        }
+        if config.max_entries > 0 {
+            entries.insert(key.clone(), entry);
+        }
+    }
+}
+
+#[async_trait]
+impl Resolver for CachingResolver {
+    async fn resolve(&self, uri: &Uri) -> Result<Vec<ResolvedTarget>, ResolverError> {
+        let key = CacheKey::from_uri(uri);
+        if let Some((result, prefetch)) = self.cached(&key, Instant::now()) {
+            if prefetch {
+                // Refresh in the background; this caller uses the
+                // still-valid entry.
+                let _ = self.lookup(key, uri);
+            }
+            return result;
+        }
+
+        let mut rx = self.lookup(key, uri);
+        let result = match rx.wait_for(Option::is_some).await {
+            Ok(result) => result.clone(),
+            Err(_) => None,
+        };
+        result.unwrap_or_else(|| Err(ResolverError::Dns("resolver lookup aborted".to_string())))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::net::SocketAddr;
+    use std::str::FromStr;
+    use std::sync::atomic::{AtomicUsize, Ordering};
+
+    use crate::transport::TransportType;
+
+    /// Inner resolver returning a fixed result after `delay`, counting
+    /// calls.
+    struct CountingResolver {
+        calls: AtomicUsize,
+        delay: Duration,
+        ttl: Option<Duration>,
+        fail: Mutex<Option<ResolverError>>,
+    }
+
+    impl CountingResolver {
+        fn new(ttl: Option<Duration>) -> Arc<Self> {
+            Arc::new(Self {
+                calls: AtomicUsize::new(0),
+                delay: Duration::from_millis(50),
+                ttl,
+                fail: Mutex::new(None),
+            })
+        }
+
+        fn calls(&self) -> usize {
+            self.calls.load(Ordering::SeqCst)
+        }
+
+        fn fail_with(&self, error: Option<ResolverError>) {
+            *self.fail.lock().unwrap() = error;
+        }
+    }
+
+    #[async_trait]
+    impl Resolver for CountingResolver {
+        async fn resolve(&self, _uri: &Uri) -> LookupResult {
+            self.calls.fetch_add(1, Ordering::SeqCst);
+            tokio::time::sleep(self.delay).await;
+            if let Some(error) = self.fail.lock().unwrap().clone() {
+                return Err(error);
+            }
+            let addr: SocketAddr = "192.0.2.10:5060".parse().unwrap();
+            Ok(vec![ResolvedTarget {
+                addr,
+                transport: TransportType::Udp,
+                expires: self.ttl.map(|ttl| std::time::Instant::now() + ttl),
+            }])
+        }
+    }
+
+    fn uri(s: &str) -> Uri {
+        Uri::from_str(s).expect("valid URI")
+    }
+
+    fn config() -> CachingResolverConfig {
+        CachingResolverConfig {
+            default_ttl: Duration::from_secs(60),
+            min_ttl: Duration::from_secs(1),
+            max_ttl: Duration::from_secs(600),
+            negative_ttl: Duration::from_secs(30),
+            prefetch_before: Duration::from_secs(10),
+            max_entries: 16,
+        }
+    }
+
+    #[tokio::test(start_paused = true)]
+    async fn test_concurrent_misses_share_one_lookup() {
+        let inner = CountingResolver::new(None);
+        let cache = Arc::new(CachingResolver::with_config(inner.clone(), config()));
+        let target = uri("sip:trunk.example.com");
+
+        let lookups: Vec<_> = (0..8)
+            .map(|_| {
+                let cache = cache.clone();
+                let target = target.clone();
+                tokio::spawn(async move { cache.resolve(&target).await })
+            })
+            .collect();
+        for lookup in lookups {
+            assert_eq!(lookup.await.unwrap().unwrap().len(), 1);
+        }
+        assert_eq!(inner.calls(), 1);
+
+        // Served from cache; keys ignore user part and host case.
+        cache
+            .resolve(&uri("sip:bob@TRUNK.example.com"))
+            .await
+            .unwrap();
+        assert_eq!(inner.calls(), 1);
+        // A different transport is a different key.
+        cache
+            .resolve(&uri("sip:trunk.example.com;transport=tcp"))
+            .await
+            .unwrap();
+        assert_eq!(inner.calls(), 2);
+    }
+
+    #[tokio::test(start_paused = true)]
+    async fn test_entry_expires_and_prefetches_before_expiry() {
+        // No TTL reported: default_ttl (60s) applies, prefetch at 50s.
+        let inner = CountingResolver::new(None);
+        let cache = CachingResolver::with_config(inner.clone(), config());
+        let target = uri("sip:trunk.example.com");
+
+        cache.resolve(&target).await.unwrap();
+        tokio::time::advance(Duration::from_secs(45)).await;
+        cache.resolve(&target).await.unwrap();
+        assert_eq!(inner.calls(), 1);
+
+        // Inside the prefetch window: answered from cache, refreshed in
+        // the background.
+        tokio::time::advance(Duration::from_secs(6)).await;
+        cache.resolve(&target).await.unwrap();
+        tokio::time::sleep(Duration::from_secs(1)).await;
+        assert_eq!(inner.calls(), 2);
+
+        // The refresh restarted the lifetime: still cached past the
+        // original expiry.
+        tokio::time::advance(Duration::from_secs(20)).await;
+        cache.resolve(&target).await.unwrap();
+        assert_eq!(inner.calls(), 2);
+
+        // Past the refreshed expiry: a blocking lookup.
+        tokio::time::advance(Duration::from_secs(60)).await;
+        cache.resolve(&target).await.unwrap();
+        assert_eq!(inner.calls(), 3);
+    }
+
+    #[tokio::test(start_paused = true)]
+    async fn test_ttl_is_clamped() {
+        let inner = CountingResolver::new(Some(Duration::ZERO));
+        let cache = CachingResolver::with_config(inner.clone(), config());
+        let target = uri("sip:trunk.example.com");
+
+        cache.resolve(&target).await.unwrap();
+        cache.resolve(&target).await.unwrap();
+        assert_eq!(inner.calls(), 1, "zero TTL is raised to min_ttl");
+        tokio::time::advance(Duration::from_secs(2)).await;
+        cache.resolve(&target).await.unwrap();
+        assert_eq!(inner.calls(), 2);
+    }
+
+    #[tokio::test(start_paused = true)]
+    async fn test_hard_failures_are_cached_negatively() {
+        let inner = CountingResolver::new(None);
+        inner.fail_with(Some(ResolverError::NoCandidates));
+        let cache = CachingResolver::with_config(inner.clone(), config());
+        let target = uri("sip:missing.example.com");
+
+        for _ in 0..3 {
+            let err = cache.resolve(&target).await.unwrap_err();
+            assert!(matches!(err, ResolverError::NoCandidates));
+        }
+        assert_eq!(inner.calls(), 1);
+
+        inner.fail_with(None);
+        tokio::time::advance(Duration::from_secs(31)).await;
+        cache.resolve(&target).await.unwrap();
+        assert_eq!(inner.calls(), 2);
+    }
+
+    #[tokio::test(start_paused = true)]
+    async fn test_transient_failures_are_not_cached() {
+        let inner = CountingResolver::new(None);
+        inner.fail_with(Some(ResolverError::Dns("timeout".to_string())));
+        let cache = CachingResolver::with_config(inner.clone(), config());
+        let target = uri("sip:trunk.example.com");
+
+        assert!(cache.resolve(&target).await.is_err());
+        assert!(cache.resolve(&target).await.is_err());
+        assert_eq!(inner.calls(), 2);
+        assert!(cache.is_empty());
+
+        // A failed refresh keeps the previous answer.
+        inner.fail_with(None);
+        cache.resolve(&target).await.unwrap();
+        inner.fail_with(Some(ResolverError::Dns("timeout".to_string())));
+        tokio::time::advance(Duration::from_secs(55)).await;
+        cache.resolve(&target).await.unwrap();
+        tokio::time::sleep(Duration::from_secs(1)).await;
+        assert!(cache.resolve(&target).await.is_ok());
+        tokio::time::sleep(Duration::from_secs(1)).await;
+        assert_eq!(inner.calls(), 5);
+    }
+
+    /// Inner resolver whose first lookup panics
+    struct PanicOnceResolver {
+        calls: AtomicUsize,
+    }
+
+    #[async_trait]
+    impl Resolver for PanicOnceResolver {
+        async fn resolve(&self, _uri: &Uri) -> LookupResult {
+            if self.calls.fetch_add(1, Ordering::SeqCst) == 0 {
+                panic!("resolver failure");
+            }
+            Ok(vec![ResolvedTarget {
+                addr: "192.0.2.10:5060".parse().unwrap(),
+                transport: TransportType::Udp,
+                expires: None,
+            }])
+        }
+    }
+
+    #[tokio::test]
+    async fn test_panicked_lookup_does_not_poison_key() {
+        let inner = Arc::new(PanicOnceResolver {
+            calls: AtomicUsize::new(0),
+        });
+        let cache = CachingResolver::with_config(inner.clone(), config());
+        let target = uri("sip:trunk.example.com");
+
+        let err = cache.resolve(&target).await.unwrap_err();
+        assert!(matches!(err, ResolverError::Dns(_)));
+        assert!(cache.state.in_flight.lock().unwrap().is_empty());
+
+        assert_eq!(cache.resolve(&target).await.unwrap().len(), 1);
+        assert_eq!(inner.calls.load(Ordering::SeqCst), 2);
+    }
+
+    #[tokio::test(start_paused = true)]
+    async fn test_cache_is_bounded() {
+        let inner = CountingResolver::new(None);
+        let cache = CachingResolver::with_config(
+            inner.clone(),
+            CachingResolverConfig {
+                max_entries: 2,
+                ..config()
+            },
+        );
+        for host in ["a.example.com", "b.example.com", "c.example.com"] {
+            cache.resolve(&uri(&format!("sip:{host}"))).await.unwrap();
+        }
+        assert_eq!(cache.len(), 2);
+
+        cache.invalidate(&uri("sip:c.example.com"));
+        assert_eq!(cache.len(), 1);
+    }
+}
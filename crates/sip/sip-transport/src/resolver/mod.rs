@@ -11,7 +11,8 @@
 //! The reference implementation [`hickory::HickoryResolver`] (behind the
 //! `dns` cargo feature) walks the full RFC 3263 §4 ladder
 //! NAPTR → SRV → A/AAAA, with the §4.2 short-circuits for IP literals
-//! and explicit ports.
+//! and explicit ports. [`caching::CachingResolver`] wraps any resolver
+//! with a TTL-aware result cache.
 //!
 //! Callers that already have a pre-resolved `SocketAddr` (the
 //! transport-manager and proxy paths) **do not** need a `Resolver` — the
@@ -27,11 +28,14 @@ use thiserror::Error;
 
 use crate::transport::TransportType;
 
+pub mod caching;
 pub mod srv;
 
 #[cfg(feature = "dns")]
 pub mod hickory;
 
+pub use caching::{CachingResolver, CachingResolverConfig};
+
 #[cfg(feature = "dns")]
 pub use hickory::HickoryResolver;
 
@@ -66,7 +70,7 @@ impl ResolvedTarget {
 /// URI shapes RFC 3263 explicitly rejects (e.g. `sips:` with
 /// `;transport=udp`). `NoCandidates` is a hard failure of the ladder —
 /// all NAPTR/SRV/A paths produced nothing usable.
-#[derive(Debug, Error)]
+#[derive(Debug, Clone, Error)]
 pub enum ResolverError {
     #[error("DNS lookup failed: {0}")]
     Dns(String),
@@ -0,0 +1,145 @@
+//! Pool of reusable send buffers
+//!
+//! Transports serialize outgoing messages with
+//! [`WireFormat::write_to`](rvoip_sip_core::types::wire::WireFormat::write_to)
+//! into a buffer taken from a [`BufferPool`] and hand the filled slice to
+//! the socket. The buffer goes back to the pool when the guard drops, so
+//! a busy transport stops allocating per message once the pool is warm.
+
+use std::ops::{Deref, DerefMut};
+use std::sync::Mutex;
+
+use bytes::BytesMut;
+
+/// Initial capacity of a pooled buffer: a typical INVITE with SDP
+const DEFAULT_BUFFER_CAPACITY: usize = 4096;
+/// Buffers that grew beyond this (a large body) are dropped rather than
+/// kept around
+const MAX_RETAINED_CAPACITY: usize = 64 * 1024;
+
+/// Free list of send buffers shared by one transport's senders
+#[derive(Debug)]
+pub struct BufferPool {
+    free: Mutex<Vec<BytesMut>>,
+    max_pooled: usize,
+}
+
+impl BufferPool {
+    /// Create a pool that keeps at most `max_pooled` idle buffers
+    pub fn new(max_pooled: usize) -> Self {
+        Self {
+            free: Mutex::new(Vec::with_capacity(max_pooled)),
+            max_pooled,
+        }
+    }
+
+    /// Take an empty buffer, allocating one if the pool is empty
+    pub fn take(&self) -> PooledBuffer<'_> {
+        PooledBuffer {
+            buf: self.take_owned(),
+            pool: self,
+        }
+    }
+
+    /// Take an empty buffer without a guard, for buffers that outlive the
+    /// borrow (e.g. queued to a writer task). Hand it back with
+    /// [`recycle`](Self::recycle) once written.
+    pub fn take_owned(&self) -> BytesMut {
+        self.free
+            .lock()
+            .ok()
+            .and_then(|mut free| free.pop())
+            .unwrap_or_else(|| BytesMut::with_capacity(DEFAULT_BUFFER_CAPACITY))
+    }
+
+    /// Number of idle buffers
+    pub fn idle(&self) -> usize {
+        self.free.lock().map_or(0, |free| free.len())
+    }
+
+    /// Return a buffer to the pool
+    pub fn recycle(&self, mut buf: BytesMut) {
+        // A buffer whose contents were split off or frozen no longer owns
+        // its whole allocation; only plain, reasonably sized ones return.
+        if buf.capacity() < DEFAULT_BUFFER_CAPACITY || buf.capacity() > MAX_RETAINED_CAPACITY {
+            return;
+        }
+        buf.clear();
+        if let Ok(mut free) = self.free.lock() {
+            if free.len() < self.max_pooled {
+                free.push(buf);
+            }
+        }
+    }
+}
+
+impl Default for BufferPool {
+    fn default() -> Self {
+        Self::new(32)
+    }
+}
+
+/// A buffer borrowed from a [`BufferPool`]; returned to it on drop
+#[derive(Debug)]
+pub struct PooledBuffer<'a> {
+    buf: BytesMut,
+    pool: &'a BufferPool,
+}
+
+impl Deref for PooledBuffer<'_> {
+    type Target = BytesMut;
+
+    fn deref(&self) -> &BytesMut {
+        &self.buf
+    }
+}
+
+impl DerefMut for PooledBuffer<'_> {
+    fn deref_mut(&mut self) -> &mut BytesMut {
+        &mut self.buf
+    }
+}
+
+impl Drop for PooledBuffer<'_> {
+    fn drop(&mut self) {
+        self.pool.recycle(std::mem::take(&mut self.buf));
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use bytes::BufMut;
+
+    #[test]
+    fn test_buffers_are_reused() {
+        let pool = BufferPool::new(2);
+        let ptr = {
+            let mut buf = pool.take();
+            buf.put_slice(b"OPTIONS sip:a@b SIP/2.0\r\n");
+            buf.as_ptr()
+        };
+        assert_eq!(pool.idle(), 1);
+
+        let buf = pool.take();
+        assert!(buf.is_empty());
+        assert_eq!(buf.as_ptr(), ptr);
+        assert_eq!(pool.idle(), 0);
+    }
+
+    #[test]
+    fn test_pool_is_bounded() {
+        let pool = BufferPool::new(1);
+        let a = pool.take();
+        let b = pool.take();
+        drop(a);
+        drop(b);
+        assert_eq!(pool.idle(), 1);
+
+        // Oversized buffers are not retained.
+        let mut big = pool.take();
+        big.reserve(MAX_RETAINED_CAPACITY + 1);
+        drop(big);
+        assert_eq!(pool.idle(), 0);
+    }
+}
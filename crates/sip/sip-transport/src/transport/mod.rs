@@ -4,13 +4,18 @@ use std::time::Instant;
 
 use crate::error::Result;
 use bytes::Bytes;
-use rvoip_sip_core::Message;
+use rvoip_sip_core::types::wire::WireFormat;
+use rvoip_sip_core::{Message, Request};
 
+pub mod buffer_pool;
+pub mod shard;
+pub(crate) mod stream_writer;
 pub mod tcp;
 pub mod tls;
 pub mod udp;
 pub mod ws;
 
+pub use buffer_pool::{BufferPool, PooledBuffer};
 pub use tcp::TcpTransport;
 pub use tls::TlsTransport;
 pub use udp::{UdpParseConfig, UdpParseDispatch, UdpSocketOptions, UdpTransport};
@@ -281,6 +286,36 @@ pub trait Transport: Send + Sync + fmt::Debug {
         ))
     }
 
+    /// Send a request that goes out more than once unchanged, such as a
+    /// client transaction's request on Timer A / Timer E.
+    ///
+    /// `wire` keeps the serialized request between calls. The default
+    /// serializes it once and sends it with
+    /// [`Transport::send_message_raw`], falling back to
+    /// [`Transport::send_message`] on transports without a raw path.
+    /// Transports that choose a transport per request or rewrite it on
+    /// the way out override this, so every send makes the same choice as
+    /// `send_message`.
+    async fn send_request_cached(
+        &self,
+        request: &Request,
+        wire: &WireCache,
+        destination: SocketAddr,
+    ) -> Result<()> {
+        let selected = self.default_transport_type();
+        let (_, bytes) = wire.get_or_try_insert_with(selected, || {
+            let bytes = wire.serialized().unwrap_or_else(|| request.to_wire());
+            Ok::<_, crate::error::Error>((selected, bytes))
+        })?;
+        match self.send_message_raw(bytes, destination).await {
+            Err(crate::error::Error::NotImplemented(_)) => {
+                self.send_message(Message::Request(request.clone()), destination)
+                    .await
+            }
+            result => result,
+        }
+    }
+
     /// Forward a serialized SIP message verbatim while pushing or
     /// popping the top `Via` header in-place at the byte level.
     ///
@@ -316,6 +351,75 @@ pub trait Transport: Send + Sync + fmt::Debug {
         let rewritten = apply_via_rewrite(bytes, rewrite)?;
         self.send_message_raw(rewritten, destination).await
     }
+
+    /// Hand received messages straight to the shards behind `sink`
+    /// instead of sending them through the event channel. Returns whether
+    /// the transport took the sink; the default keeps using the event
+    /// channel and returns `false`. Events other than parsed messages, and
+    /// messages a stopped sink hands back, still go through the channel.
+    fn attach_shard_sink(&self, _sink: std::sync::Arc<dyn shard::ShardSink>) -> bool {
+        false
+    }
+}
+
+/// Serialized form of a request sent with
+/// [`Transport::send_request_cached`].
+///
+/// The bytes are keyed by the transport selected for the request and
+/// record the transport they were built for, which differs when an
+/// oversized UDP request fails over to TCP and its top Via is rewritten.
+/// A different selection rebuilds them. A caller that already holds the
+/// request's serialized form can seed it with
+/// [`WireCache::set_serialized`] so it is not serialized again.
+#[derive(Debug, Default)]
+pub struct WireCache {
+    cached: std::sync::Mutex<Option<CachedWire>>,
+    serialized: std::sync::OnceLock<Bytes>,
+}
+
+#[derive(Debug)]
+struct CachedWire {
+    selected: TransportType,
+    sent_on: TransportType,
+    bytes: Bytes,
+}
+
+impl WireCache {
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// The transport and bytes cached for `selected`, built with `build`
+    /// when nothing or another selection's bytes are cached.
+    pub fn get_or_try_insert_with<E>(
+        &self,
+        selected: TransportType,
+        build: impl FnOnce() -> std::result::Result<(TransportType, Bytes), E>,
+    ) -> std::result::Result<(TransportType, Bytes), E> {
+        let mut cached = self.cached.lock().unwrap_or_else(|e| e.into_inner());
+        if let Some(wire) = cached.as_ref().filter(|wire| wire.selected == selected) {
+            return Ok((wire.sent_on, wire.bytes.clone()));
+        }
+        let (sent_on, bytes) = build()?;
+        *cached = Some(CachedWire {
+            selected,
+            sent_on,
+            bytes: bytes.clone(),
+        });
+        Ok((sent_on, bytes))
+    }
+
+    /// Record `bytes` as the request serialized unchanged. Only the first
+    /// call has an effect; `bytes` must be exactly what `to_wire` on the
+    /// request would produce.
+    pub fn set_serialized(&self, bytes: Bytes) {
+        let _ = self.serialized.set(bytes);
+    }
+
+    /// The serialized request recorded with [`WireCache::set_serialized`]
+    pub fn serialized(&self) -> Option<Bytes> {
+        self.serialized.get().cloned()
+    }
 }
 
 /// Direction-specific Via-stack edit for
@@ -0,0 +1,135 @@
+//! Transaction shard selection shared by transports and the transaction layer
+//!
+//! A sharded transaction engine owns each transaction on one worker, chosen
+//! by the branch of the top Via: the branch is the transaction key, so the
+//! owning shard can be found from a received message, a request being sent,
+//! or a bare transaction key alike. Transports that fan received datagrams
+//! out to parse workers can use the same function before parsing, so parse
+//! worker `k` only ever produces events for transaction shard `k` when both
+//! have the same count, and can hand those events straight to the shard
+//! through a [`ShardSink`].
+
+use std::fmt;
+
+use rvoip_sip_core::parser::scan::find_message_field;
+use rvoip_sip_core::{HeaderName, Message, TypedHeader};
+
+use super::TransportEvent;
+
+const FNV_OFFSET_BASIS: u64 = 0xcbf2_9ce4_8422_2325;
+const FNV_PRIME: u64 = 0x0000_0100_0000_01b3;
+
+/// Hash a Via branch value (FNV-1a). Stable across processes and threads.
+pub fn branch_shard_hash(branch: &[u8]) -> u64 {
+    branch
+        .trim_ascii()
+        .iter()
+        .fold(FNV_OFFSET_BASIS, |hash, byte| {
+            (hash ^ u64::from(*byte)).wrapping_mul(FNV_PRIME)
+        })
+}
+
+/// Shard hash of a parsed message, or `None` if its top Via has no branch
+pub fn message_shard_hash(message: &Message) -> Option<u64> {
+    match message.header(&HeaderName::Via)? {
+        TypedHeader::Via(via) => via
+            .branch()
+            .map(|branch| branch_shard_hash(branch.as_bytes())),
+        _ => None,
+    }
+}
+
+/// Shard hash of an unparsed message, read from the branch of its first
+/// Via header (or the compact `v` form); the head is scanned only as far as
+/// that header and nothing is parsed or indexed
+pub fn datagram_shard_hash(packet: &[u8]) -> Option<u64> {
+    let field = find_message_field(packet, b"Via", Some(b'v'))?;
+    top_via_branch(field.value(packet)).map(branch_shard_hash)
+}
+
+/// Branch parameter of the first via-parm of a Via header value
+fn top_via_branch(value: &[u8]) -> Option<&[u8]> {
+    let top = value.split(|byte| *byte == b',').next()?;
+    top.split(|byte| *byte == b';').skip(1).find_map(|param| {
+        let eq = param.iter().position(|byte| *byte == b'=')?;
+        let branch = param[eq + 1..].trim_ascii();
+        (param[..eq].trim_ascii().eq_ignore_ascii_case(b"branch") && !branch.is_empty())
+            .then_some(branch)
+    })
+}
+
+/// Map a shard hash onto one of `shards` workers
+pub fn shard_index(hash: u64, shards: usize) -> usize {
+    if shards <= 1 {
+        return 0;
+    }
+    (hash % shards as u64) as usize
+}
+
+/// Ingress queues of a set of transaction shards, which a transport can
+/// deliver parsed messages to directly instead of through its event
+/// channel. Messages are routed with [`shard_index`] over
+/// [`message_shard_hash`].
+#[async_trait::async_trait]
+pub trait ShardSink: Send + Sync + fmt::Debug {
+    /// Number of shards behind this sink
+    fn shard_count(&self) -> usize;
+
+    /// Queue `event` on `shard`, waiting while that shard's queue is full.
+    /// Hands the event back if the shard no longer accepts events, so the
+    /// transport can fall back to its event channel.
+    async fn deliver(
+        &self,
+        shard: usize,
+        event: TransportEvent,
+    ) -> std::result::Result<(), TransportEvent>;
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    const INVITE: &[u8] = b"INVITE sip:bob@example.com SIP/2.0\r\n\
+        Via: SIP/2.0/UDP 10.0.0.1:5060;branch=z9hG4bK776asdhds\r\n\
+        Via: SIP/2.0/UDP 10.0.0.2:5060;branch=z9hG4bKother\r\n\
+        From: <sip:alice@example.com>;tag=1928301774\r\n\
+        To: <sip:bob@example.com>\r\n\
+        Call-ID: a84b4c76e66710@pc33.example.com\r\n\
+        CSeq: 314159 INVITE\r\n\
+        Content-Length: 0\r\n\r\n";
+
+    #[test]
+    fn test_datagram_and_parsed_hashes_agree() {
+        let message = rvoip_sip_core::parse_message(INVITE).expect("parse INVITE");
+        let parsed = message_shard_hash(&message).expect("parsed branch");
+        assert_eq!(datagram_shard_hash(INVITE), Some(parsed));
+        assert_eq!(parsed, branch_shard_hash(b"z9hG4bK776asdhds"));
+    }
+
+    #[test]
+    fn test_compact_form_multi_value_and_missing_branch() {
+        let compact = b"BYE sip:bob@example.com SIP/2.0\r\n\
+            v: SIP/2.0/UDP 10.0.0.1;rport ; Branch = z9hG4bKabc ,SIP/2.0/UDP h2;branch=z9hG4bKdef\r\n\
+            Content-Length: 0\r\n\r\n";
+        assert_eq!(
+            datagram_shard_hash(compact),
+            Some(branch_shard_hash(b"z9hG4bKabc"))
+        );
+        assert_eq!(
+            datagram_shard_hash(b"OPTIONS sip:a@b SIP/2.0\r\nVia: SIP/2.0/UDP h\r\n\r\n"),
+            None
+        );
+        assert_eq!(
+            datagram_shard_hash(b"OPTIONS sip:a@b SIP/2.0\r\n\r\n"),
+            None
+        );
+    }
+
+    #[test]
+    fn test_shard_index_is_in_range() {
+        for hash in [0, 1, u64::MAX, branch_shard_hash(b"x")] {
+            assert_eq!(shard_index(hash, 1), 0);
+            assert!(shard_index(hash, 6) < 6);
+        }
+    }
+}
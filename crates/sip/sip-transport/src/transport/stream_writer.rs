@@ -0,0 +1,184 @@
+//! Coalescing writes for stream transports
+//!
+//! TCP and TLS connections each have one writer task that owns the write
+//! half and drains an MPSC queue of outgoing frames. Senders only enqueue,
+//! so they never wait on a lock held across socket I/O, and everything
+//! queued by the time the writer wakes goes out in one vectored write —
+//! a burst of messages to one peer costs one syscall (and, for TLS, one
+//! record flush) instead of one per message.
+
+use std::io::{self, IoSlice};
+
+use tokio::io::{AsyncWrite, AsyncWriteExt};
+
+/// Frames a connection's write queue holds before senders wait
+pub(crate) const WRITE_QUEUE_CAPACITY: usize = 256;
+/// Frames taken off the queue per write
+pub(crate) const MAX_WRITE_BATCH: usize = 64;
+/// Slices passed to a single `write_vectored` call (below every
+/// platform's `IOV_MAX`)
+const MAX_IOVECS: usize = 64;
+
+/// Write every buffer of `batch`, in order, using vectored writes.
+///
+/// Writers without vectored support would only take the first buffer per
+/// call, so for them a multi-frame batch is copied into one buffer first.
+pub(crate) async fn write_all_batch<W, B>(writer: &mut W, batch: &[B]) -> io::Result<()>
+where
+    W: AsyncWrite + Unpin + ?Sized,
+    B: AsRef<[u8]>,
+{
+    if batch.len() > 1 && !writer.is_write_vectored() {
+        let total = batch.iter().map(|buf| buf.as_ref().len()).sum();
+        let mut joined = Vec::with_capacity(total);
+        for buf in batch {
+            joined.extend_from_slice(buf.as_ref());
+        }
+        return writer.write_all(&joined).await;
+    }
+
+    // Position of the first unwritten byte: buffer index and offset in it.
+    let mut index = 0;
+    let mut offset = 0;
+    loop {
+        while index < batch.len() && offset == batch[index].as_ref().len() {
+            index += 1;
+            offset = 0;
+        }
+        if index == batch.len() {
+            return Ok(());
+        }
+
+        let mut slices = [IoSlice::new(&[]); MAX_IOVECS];
+        let mut count = 0;
+        for (i, buf) in batch[index..].iter().enumerate() {
+            let buf = if i == 0 {
+                &buf.as_ref()[offset..]
+            } else {
+                buf.as_ref()
+            };
+            if buf.is_empty() {
+                continue;
+            }
+            slices[count] = IoSlice::new(buf);
+            count += 1;
+            if count == MAX_IOVECS {
+                break;
+            }
+        }
+
+        let mut written = writer.write_vectored(&slices[..count]).await?;
+        if written == 0 {
+            return Err(io::ErrorKind::WriteZero.into());
+        }
+        while written > 0 {
+            let remaining = batch[index].as_ref().len() - offset;
+            if written < remaining {
+                offset += written;
+                break;
+            }
+            written -= remaining;
+            index += 1;
+            offset = 0;
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::pin::Pin;
+    use std::task::{Context, Poll};
+
+    /// Writer accepting at most `limit` bytes per call
+    struct Trickle {
+        out: Vec<u8>,
+        limit: usize,
+        vectored: bool,
+        calls: usize,
+    }
+
+    impl AsyncWrite for Trickle {
+        fn poll_write(
+            mut self: Pin<&mut Self>,
+            _cx: &mut Context<'_>,
+            buf: &[u8],
+        ) -> Poll<io::Result<usize>> {
+            let n = buf.len().min(self.limit);
+            self.out.extend_from_slice(&buf[..n]);
+            self.calls += 1;
+            Poll::Ready(Ok(n))
+        }
+
+        fn poll_write_vectored(
+            mut self: Pin<&mut Self>,
+            _cx: &mut Context<'_>,
+            bufs: &[IoSlice<'_>],
+        ) -> Poll<io::Result<usize>> {
+            let mut n = 0;
+            for buf in bufs {
+                let take = buf.len().min(self.limit - n);
+                self.out.extend_from_slice(&buf[..take]);
+                n += take;
+                if n == self.limit {
+                    break;
+                }
+            }
+            self.calls += 1;
+            Poll::Ready(Ok(n))
+        }
+
+        fn is_write_vectored(&self) -> bool {
+            self.vectored
+        }
+
+        fn poll_flush(self: Pin<&mut Self>, _cx: &mut Context<'_>) -> Poll<io::Result<()>> {
+            Poll::Ready(Ok(()))
+        }
+
+        fn poll_shutdown(self: Pin<&mut Self>, _cx: &mut Context<'_>) -> Poll<io::Result<()>> {
+            Poll::Ready(Ok(()))
+        }
+    }
+
+    fn frames() -> Vec<Vec<u8>> {
+        vec![
+            b"OPTIONS sip:a@b SIP/2.0\r\n\r\n".to_vec(),
+            Vec::new(),
+            b"\r\n\r\n".to_vec(),
+            b"BYE sip:a@b SIP/2.0\r\n\r\n".to_vec(),
+        ]
+    }
+
+    #[tokio::test]
+    async fn test_partial_vectored_writes_keep_order() {
+        let batch = frames();
+        let expected = batch.concat();
+        for limit in [1, 3, 7, 1024] {
+            let mut writer = Trickle {
+                out: Vec::new(),
+                limit,
+                vectored: true,
+                calls: 0,
+            };
+            write_all_batch(&mut writer, &batch).await.unwrap();
+            assert_eq!(writer.out, expected, "limit {limit}");
+        }
+    }
+
+    #[tokio::test]
+    async fn test_batch_is_one_write_when_writer_takes_it_all() {
+        let batch = frames();
+        for vectored in [true, false] {
+            let mut writer = Trickle {
+                out: Vec::new(),
+                limit: usize::MAX,
+                vectored,
+                calls: 0,
+            };
+            write_all_batch(&mut writer, &batch).await.unwrap();
+            assert_eq!(writer.out, batch.concat());
+            assert_eq!(writer.calls, 1);
+        }
+    }
+}
@@ -1,18 +1,54 @@
 use crate::error::{Error, Result};
-use bytes::{Buf, BufMut, BytesMut};
+use crate::transport::stream_writer::{write_all_batch, MAX_WRITE_BATCH, WRITE_QUEUE_CAPACITY};
+use crate::transport::BufferPool;
+use bytes::{Buf, BufMut, Bytes, BytesMut};
+use rvoip_sip_core::parser::scan::scan_message_head;
+use rvoip_sip_core::types::wire::WireFormat;
 use rvoip_sip_core::{parse_message, Message};
 use std::io;
 use std::net::SocketAddr;
-use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+use std::sync::Arc;
+use std::time::{Duration, Instant};
 use tokio::io::{AsyncReadExt, AsyncWriteExt};
 use tokio::net::tcp::{OwnedReadHalf, OwnedWriteHalf};
 use tokio::net::TcpStream;
-use tokio::sync::Mutex;
+use tokio::sync::{mpsc, oneshot, Mutex};
+use tokio::task::AbortHandle;
 use tracing::{debug, trace, warn};
 
 // Buffer sizes
 const INITIAL_BUFFER_SIZE: usize = 8192;
 const MAX_MESSAGE_SIZE: usize = 65535;
+/// Idle send buffers kept per connection. Buffers return to the pool
+/// once the writer task has written them, so a connection that sends in
+/// bursts needs a few; thousands of connections each keeping many would
+/// not be worth the memory.
+const SEND_BUFFERS_PER_CONNECTION: usize = 4;
+/// RFC 5626 §3.5.1 client keep-alive ping
+const KEEPALIVE_PING: &[u8] = b"\r\n\r\n";
+
+/// One entry of a connection's write queue
+#[derive(Debug)]
+enum WriteOp {
+    /// Serialized message in a buffer from the connection's pool
+    Frame(BytesMut),
+    /// Bytes written verbatim (pre-built messages, keep-alive frames)
+    Raw(Bytes),
+    /// Shut down the write half once everything queued before it is
+    /// written
+    Shutdown(oneshot::Sender<io::Result<()>>),
+}
+
+impl AsRef<[u8]> for WriteOp {
+    fn as_ref(&self) -> &[u8] {
+        match self {
+            WriteOp::Frame(buf) => buf,
+            WriteOp::Raw(bytes) => bytes,
+            WriteOp::Shutdown(_) => &[],
+        }
+    }
+}
 
 /// A frame pulled off a stream-oriented SIP connection. RFC 5626 §3.5.1
 /// introduces two non-SIP frames the wire may carry — a single CRLF
@@ -44,11 +80,18 @@ pub enum ReceivedFrame {
 /// bidirectional SIP-over-TCP and for RFC 5626 §3.5.1 keep-alive,
 /// where a ping task writes while the reader simultaneously awaits a
 /// pong.
+///
+/// The write half belongs to a writer task fed by a bounded queue:
+/// senders enqueue whole frames (RFC 3261 §7.5 requires atomic message
+/// delivery over stream transports) and the writer coalesces whatever
+/// is queued into vectored writes. A send therefore completes once the
+/// frame is queued; a write failure closes the connection and later
+/// sends fail with [`Error::TransportClosed`].
 pub struct TcpConnection {
-    /// Owned write half. Held under a mutex so concurrent senders
-    /// serialise their writes (RFC 3261 §7.5 requires atomic message
-    /// delivery over stream transports).
-    write_half: Mutex<OwnedWriteHalf>,
+    /// Write queue drained by the writer task
+    write_tx: mpsc::Sender<WriteOp>,
+    /// Handle to stop the writer task without flushing
+    writer: AbortHandle,
     /// Owned read half. Expected to be consumed by a single reader
     /// task; concurrent `receive_frame` callers serialise via the
     /// mutex but that usage pattern is not recommended.
@@ -58,10 +101,22 @@ pub struct TcpConnection {
     local_addr: SocketAddr,
     /// The peer's address
     peer_addr: SocketAddr,
-    /// Whether the connection is closed
-    closed: AtomicBool,
+    /// Whether the connection is closed; also set by the writer task
+    /// when a write fails
+    closed: Arc<AtomicBool>,
     /// Buffer for receiving data
     recv_buffer: Mutex<BytesMut>,
+    /// Reusable serialization buffers for outgoing messages, shared with
+    /// the writer task that returns them
+    send_buffers: Arc<BufferPool>,
+    /// Reference point for the activity timestamps below
+    created: Instant,
+    /// Milliseconds after `created` a SIP message was last sent or
+    /// received (idle reaping)
+    last_activity_ms: AtomicU64,
+    /// Milliseconds after `created` anything, keep-alives included, was
+    /// last queued for sending (keep-alive scheduling)
+    last_sent_ms: AtomicU64,
 }
 
 impl TcpConnection {
@@ -73,17 +128,36 @@ impl TcpConnection {
         Self::from_stream(stream, addr)
     }
 
-    /// Creates a TCP connection from an existing stream
+    /// Creates a TCP connection from an existing stream and starts its
+    /// writer task. Must be called within a Tokio runtime.
     pub fn from_stream(stream: TcpStream, peer_addr: SocketAddr) -> Result<Self> {
         let local_addr = stream.local_addr().map_err(Error::LocalAddrFailed)?;
         let (read_half, write_half) = stream.into_split();
+        let (write_tx, write_rx) = mpsc::channel(WRITE_QUEUE_CAPACITY);
+        let closed = Arc::new(AtomicBool::new(false));
+        let send_buffers = Arc::new(BufferPool::new(SEND_BUFFERS_PER_CONNECTION));
+
+        let writer = tokio::spawn(run_writer(
+            write_half,
+            write_rx,
+            closed.clone(),
+            send_buffers.clone(),
+            peer_addr,
+        ))
+        .abort_handle();
+
         Ok(Self {
-            write_half: Mutex::new(write_half),
+            write_tx,
+            writer,
             read_half: Mutex::new(read_half),
             local_addr,
             peer_addr,
-            closed: AtomicBool::new(false),
+            closed,
             recv_buffer: Mutex::new(BytesMut::with_capacity(INITIAL_BUFFER_SIZE)),
+            send_buffers,
+            created: Instant::now(),
+            last_activity_ms: AtomicU64::new(0),
+            last_sent_ms: AtomicU64::new(0),
         })
     }
 
@@ -103,54 +177,91 @@ impl TcpConnection {
             return Err(Error::TransportClosed);
         }
 
-        let message_bytes = message.to_bytes();
-        let mut writer = self.write_half.lock().await;
-
-        writer.write_all(&message_bytes).await.map_err(|e| {
-            if e.kind() == io::ErrorKind::BrokenPipe || e.kind() == io::ErrorKind::ConnectionReset {
-                self.closed.store(true, Ordering::Relaxed);
-                Error::ConnectionReset
-            } else {
-                Error::SendFailed(self.peer_addr, e)
-            }
-        })?;
-
-        writer
-            .flush()
-            .await
-            .map_err(|e| Error::SendFailed(self.peer_addr, e))?;
+        let mut message_bytes = self.send_buffers.take_owned();
+        message.write_to(&mut message_bytes);
+        let len = message_bytes.len();
+        self.touch();
+        self.enqueue(WriteOp::Frame(message_bytes)).await?;
 
-        trace!("Sent {} bytes to {}", message_bytes.len(), self.peer_addr);
+        trace!("Queued {} bytes to {}", len, self.peer_addr);
         Ok(())
     }
 
     /// Writes raw bytes over the connection without any SIP framing.
-    /// Used for RFC 5626 §3.5.1 CRLFCRLF keep-alive pings / CRLF pongs.
-    /// Mirrors `send_message` for error handling — a broken pipe marks
-    /// the connection closed so the next send fails fast.
+    /// Used for pre-built messages and RFC 5626 §3.5.1 CRLFCRLF
+    /// keep-alive pings / CRLF pongs.
     pub async fn send_raw_bytes(&self, data: &[u8]) -> Result<()> {
+        self.send_bytes(Bytes::copy_from_slice(data)).await
+    }
+
+    /// [`send_raw_bytes`](Self::send_raw_bytes) for bytes the caller
+    /// already owns; queued without copying.
+    pub async fn send_bytes(&self, data: Bytes) -> Result<()> {
         if self.is_closed() {
             return Err(Error::TransportClosed);
         }
 
-        let mut writer = self.write_half.lock().await;
+        let len = data.len();
+        self.enqueue(WriteOp::Raw(data)).await?;
 
-        writer.write_all(data).await.map_err(|e| {
-            if e.kind() == io::ErrorKind::BrokenPipe || e.kind() == io::ErrorKind::ConnectionReset {
-                self.closed.store(true, Ordering::Relaxed);
-                Error::ConnectionReset
-            } else {
-                Error::SendFailed(self.peer_addr, e)
-            }
-        })?;
+        trace!("Queued {} raw bytes to {}", len, self.peer_addr);
+        Ok(())
+    }
 
-        writer
-            .flush()
-            .await
-            .map_err(|e| Error::SendFailed(self.peer_addr, e))?;
+    /// Queue an RFC 5626 §3.5.1 CRLFCRLF keep-alive ping without waiting.
+    /// A full write queue means traffic is flowing, so the ping is
+    /// skipped rather than queued behind it.
+    pub fn keepalive_ping(&self) -> Result<()> {
+        if self.is_closed() {
+            return Err(Error::TransportClosed);
+        }
+        self.last_sent_ms
+            .store(self.elapsed_ms(), Ordering::Relaxed);
+        match self
+            .write_tx
+            .try_send(WriteOp::Raw(Bytes::from_static(KEEPALIVE_PING)))
+        {
+            Ok(()) | Err(mpsc::error::TrySendError::Full(_)) => Ok(()),
+            Err(mpsc::error::TrySendError::Closed(_)) => Err(Error::TransportClosed),
+        }
+    }
 
-        trace!("Sent {} raw bytes to {}", data.len(), self.peer_addr);
-        Ok(())
+    /// Time since a SIP message was last sent or received. Keep-alive
+    /// frames do not count.
+    pub fn idle_for(&self) -> Duration {
+        self.since(&self.last_activity_ms)
+    }
+
+    /// Time since anything, keep-alive pings included, was last sent
+    pub fn send_idle_for(&self) -> Duration {
+        self.since(&self.last_sent_ms)
+    }
+
+    fn elapsed_ms(&self) -> u64 {
+        self.created.elapsed().as_millis() as u64
+    }
+
+    fn since(&self, stamp: &AtomicU64) -> Duration {
+        Duration::from_millis(
+            self.elapsed_ms()
+                .saturating_sub(stamp.load(Ordering::Relaxed)),
+        )
+    }
+
+    /// Record SIP traffic on the connection
+    fn touch(&self) {
+        let now = self.elapsed_ms();
+        self.last_activity_ms.store(now, Ordering::Relaxed);
+        self.last_sent_ms.store(now, Ordering::Relaxed);
+    }
+
+    async fn enqueue(&self, op: WriteOp) -> Result<()> {
+        self.last_sent_ms
+            .store(self.elapsed_ms(), Ordering::Relaxed);
+        self.write_tx
+            .send(op)
+            .await
+            .map_err(|_| Error::TransportClosed)
     }
 
     /// Receives a SIP message from the connection.
@@ -213,6 +324,8 @@ impl TcpConnection {
                 return Ok(Some(ReceivedFrame::KeepAlivePong));
             }
             if let Some((frame, raw_bytes)) = self.try_parse_message(&mut recv_buffer)? {
+                self.last_activity_ms
+                    .store(self.elapsed_ms(), Ordering::Relaxed);
                 return Ok(Some(ReceivedFrame::Message(frame, raw_bytes)));
             }
 
@@ -268,16 +381,15 @@ impl TcpConnection {
             return Ok(None);
         }
 
-        // First check if we have headers and body
-        if let Some(double_crlf_pos) = self.find_double_crlf(buffer) {
-            // Found header/body separator, now check Content-Length
-            let header_slice = &buffer[0..double_crlf_pos + 4]; // Include the separator
-
-            // Try to extract Content-Length
-            let content_length = self.extract_content_length(header_slice);
+        // One pre-pass finds the header/body separator and the
+        // Content-Length header (long or compact form, last one wins).
+        let head = scan_message_head(buffer);
+        if let Some(body_start) = head.end() {
+            // Default to 0 if not found
+            let content_length = head.content_length(buffer).unwrap_or(0);
 
             // Calculate total message length
-            let total_length = double_crlf_pos + 4 + content_length;
+            let total_length = body_start + content_length;
 
             // Check if we have the complete message
             if buffer.len() >= total_length {
@@ -319,40 +431,6 @@ impl TcpConnection {
         Ok(None)
     }
 
-    /// Finds the position of the double CRLF (end of headers)
-    fn find_double_crlf(&self, buffer: &BytesMut) -> Option<usize> {
-        for i in 0..buffer.len().saturating_sub(3) {
-            if buffer[i] == b'\r'
-                && buffer[i + 1] == b'\n'
-                && buffer[i + 2] == b'\r'
-                && buffer[i + 3] == b'\n'
-            {
-                return Some(i);
-            }
-        }
-        None
-    }
-
-    /// Extracts the Content-Length value from the header section
-    fn extract_content_length(&self, header_slice: &[u8]) -> usize {
-        let header_str = String::from_utf8_lossy(header_slice);
-
-        // Simple parsing to extract Content-Length
-        for line in header_str.lines() {
-            let line = line.trim();
-            if line.to_lowercase().starts_with("content-length:") {
-                if let Some(value_str) = line.split(':').nth(1) {
-                    if let Ok(length) = value_str.trim().parse::<usize>() {
-                        return length;
-                    }
-                }
-            }
-        }
-
-        // Default to 0 if not found
-        0
-    }
-
     /// Closes the TCP connection
     pub async fn close(&self) -> Result<()> {
         if self.closed.swap(true, Ordering::Relaxed) {
@@ -361,15 +439,26 @@ impl TcpConnection {
         }
 
         // Shutting down the write half closes the socket from both
-        // directions (read half will return EOF on its next poll).
-        let mut writer = self.write_half.lock().await;
-        if let Err(e) = writer.shutdown().await {
-            if e.kind() != io::ErrorKind::NotConnected {
-                return Err(Error::IoError(e));
-            }
+        // directions (read half will return EOF on its next poll). The
+        // writer does it after flushing what is already queued; if the
+        // writer already stopped, the socket is going away regardless.
+        let (ack_tx, ack_rx) = oneshot::channel();
+        if self.write_tx.send(WriteOp::Shutdown(ack_tx)).await.is_err() {
+            return Ok(());
+        }
+        match ack_rx.await {
+            Ok(Err(e)) if e.kind() != io::ErrorKind::NotConnected => Err(Error::IoError(e)),
+            _ => Ok(()),
         }
+    }
 
-        Ok(())
+    /// Tears the connection down without flushing: marks it closed and
+    /// stops the writer task, dropping whatever is still queued. For a
+    /// [`close`](Self::close) that cannot finish because the peer stopped
+    /// reading.
+    pub fn abort(&self) {
+        self.closed.store(true, Ordering::Relaxed);
+        self.writer.abort();
     }
 
     /// Returns whether the connection is closed
@@ -378,6 +467,40 @@ impl TcpConnection {
     }
 }
 
+/// Writer task of one connection: drains the write queue in batches until
+/// the connection shuts down, the queue closes (connection dropped) or a
+/// write fails
+async fn run_writer(
+    mut writer: OwnedWriteHalf,
+    mut queue: mpsc::Receiver<WriteOp>,
+    closed: Arc<AtomicBool>,
+    send_buffers: Arc<BufferPool>,
+    peer_addr: SocketAddr,
+) {
+    let mut batch = Vec::with_capacity(MAX_WRITE_BATCH);
+    while queue.recv_many(&mut batch, MAX_WRITE_BATCH).await > 0 {
+        if let Err(e) = write_all_batch(&mut writer, &batch).await {
+            closed.store(true, Ordering::Relaxed);
+            debug!("Write to {} failed, closing connection: {}", peer_addr, e);
+            return;
+        }
+
+        let mut shutdown = None;
+        for op in batch.drain(..) {
+            match op {
+                WriteOp::Frame(buf) => send_buffers.recycle(buf),
+                WriteOp::Raw(_) => {}
+                WriteOp::Shutdown(ack) => shutdown = Some(ack),
+            }
+        }
+        if let Some(ack) = shutdown {
+            let _ = ack.send(writer.shutdown().await);
+            return;
+        }
+    }
+    let _ = writer.shutdown().await;
+}
+
 impl Drop for TcpConnection {
     fn drop(&mut self) {
         if !self.is_closed() {
@@ -103,10 +103,7 @@ impl TcpTransport {
                         // via `send_raw`) can find it, then spawn the unified
                         // reader.
                         let arc = Arc::new(connection);
-                        inner
-                            .connection_pool
-                            .add_connection(peer_addr, arc.clone())
-                            .await;
+                        inner.connection_pool.add_connection(peer_addr, arc.clone());
                         transport.clone().spawn_connection_handler(arc);
                     }
                     Err(e) => {
@@ -226,14 +223,16 @@ impl TcpTransport {
                 })
                 .await;
 
-            inner.connection_pool.remove_connection(&peer_addr).await;
+            inner
+                .connection_pool
+                .release_connection(&peer_addr, &connection);
         });
     }
 
     /// Connects to a remote address and returns a connection
     async fn connect_to(&self, addr: SocketAddr) -> Result<Arc<TcpConnection>> {
         // Check if there's already a connection in the pool
-        if let Some(conn) = self.inner.connection_pool.get_connection(&addr).await {
+        if let Some(conn) = self.inner.connection_pool.get_connection(&addr) {
             trace!("Reusing existing connection to {}", addr);
             return Ok(conn);
         }
@@ -249,8 +248,7 @@ impl TcpTransport {
         let connection_arc = Arc::new(connection);
         self.inner
             .connection_pool
-            .add_connection(addr, connection_arc.clone())
-            .await;
+            .add_connection(addr, connection_arc.clone());
         self.clone()
             .spawn_connection_handler(connection_arc.clone());
 
@@ -299,7 +297,7 @@ impl Transport for TcpTransport {
         // general-purpose verbatim-bytes path (unlike `send_raw`,
         // which is RFC 5626 keep-alive on already-open flows only).
         let connection = self.connect_to(destination).await?;
-        connection.send_raw_bytes(&bytes).await
+        connection.send_bytes(bytes).await
     }
 
     async fn close(&self) -> Result<()> {
@@ -333,19 +331,14 @@ impl Transport for TcpTransport {
         // — never open a fresh TCP dial for a bare-bytes write. If the
         // flow is gone, the caller (typically a ping task in dialog-
         // core) terminates; a fresh flow is the upper layer's job.
-        let Some(connection) = self
-            .inner
-            .connection_pool
-            .get_connection(&destination)
-            .await
-        else {
+        let Some(connection) = self.inner.connection_pool.get_connection(&destination) else {
             return Err(Error::InvalidState(format!(
                 "No active TCP connection to {} for send_raw",
                 destination
             )));
         };
 
-        connection.send_raw_bytes(&data).await
+        connection.send_bytes(data).await
     }
 }
 
@@ -371,6 +364,7 @@ mod tests {
         let config = PoolConfig {
             max_connections: 10,
             idle_timeout: Duration::from_secs(10),
+            keepalive_interval: None,
         };
 
         let (transport, _rx) =
@@ -1,119 +1,182 @@
 use super::TcpConnection;
-use std::collections::HashMap;
+use dashmap::DashMap;
 use std::net::SocketAddr;
-use std::sync::Arc;
-use std::time::{Duration, Instant};
-use tokio::sync::Mutex;
-use tokio::time::interval;
+use std::sync::{Arc, Weak};
+use std::time::Duration;
+use tokio::sync::Notify;
+use tokio::time::{interval, MissedTickBehavior};
 use tracing::{debug, error, info, trace};
 
+/// Upper bound on the maintenance period, whatever the timeouts
+const MAX_MAINTENANCE_PERIOD: Duration = Duration::from_secs(60);
+/// Lower bound on the maintenance period, for very short test timeouts
+const MIN_MAINTENANCE_PERIOD: Duration = Duration::from_millis(100);
+/// A full pool is trimmed to `max_connections - max_connections / N`, so
+/// one eviction sweep makes room for a burst of new connections
+const EVICTION_HEADROOM_DIVISOR: usize = 64;
+/// How long a pool-initiated close may wait for a connection's queued
+/// writes to flush before its writer is aborted
+const CLOSE_TIMEOUT: Duration = Duration::from_secs(5);
+
 /// Configuration for the TCP connection pool
 #[derive(Clone, Debug)]
 pub struct PoolConfig {
-    /// Maximum number of connections to keep in the pool
+    /// Maximum number of connections to keep in the pool. Going over it
+    /// wakes the maintenance task, which closes the connections idle the
+    /// longest.
     pub max_connections: usize,
-    /// Timeout after which idle connections are closed
+    /// Timeout after which idle connections are closed. Only SIP
+    /// messages count as activity; keep-alive frames do not.
     pub idle_timeout: Duration,
+    /// Send an RFC 5626 §3.5.1 CRLFCRLF ping on connections that have
+    /// sent nothing for this long. `None` disables pings.
+    pub keepalive_interval: Option<Duration>,
 }
 
 impl Default for PoolConfig {
     fn default() -> Self {
         Self {
-            max_connections: 100,
+            max_connections: 10_000,
             idle_timeout: Duration::from_secs(300), // 5 minutes
+            keepalive_interval: None,
         }
     }
 }
 
-/// Connection metadata for tracking last activity and other details
-struct ConnectionMeta {
-    /// The actual connection
-    connection: Arc<TcpConnection>,
-    /// When the connection was last used
-    last_activity: Instant,
+impl PoolConfig {
+    /// How often the maintenance task looks for idle connections and
+    /// due keep-alives
+    fn maintenance_period(&self) -> Duration {
+        let mut period = (self.idle_timeout / 2).min(MAX_MAINTENANCE_PERIOD);
+        if let Some(keepalive) = self.keepalive_interval {
+            period = period.min(keepalive / 2);
+        }
+        period.max(MIN_MAINTENANCE_PERIOD)
+    }
 }
 
-/// Connection pool for managing TCP connections
+/// Connection pool for managing TCP connections.
+///
+/// Connections live in a sharded concurrent map, so lookups on the send
+/// path take a short shard read lock and never wait on another sender's
+/// I/O. Clones share the same pool. A background task, stopped when the
+/// last clone is dropped, reaps connections that are closed or idle past
+/// [`PoolConfig::idle_timeout`], sends keep-alive pings, and closes the
+/// longest-idle connections when the pool grows past
+/// [`PoolConfig::max_connections`].
+#[derive(Clone)]
 pub struct ConnectionPool {
+    inner: Arc<PoolInner>,
+}
+
+struct PoolInner {
     /// Configuration for the pool
     config: PoolConfig,
     /// Active connections by remote address
-    connections: Mutex<HashMap<SocketAddr, ConnectionMeta>>,
+    connections: DashMap<SocketAddr, Arc<TcpConnection>>,
+    /// Wakes the maintenance task when the pool is over capacity
+    over_capacity: Arc<Notify>,
 }
 
 impl ConnectionPool {
-    /// Creates a new connection pool with the given configuration
+    /// Creates a new connection pool with the given configuration. Must
+    /// be called within a Tokio runtime.
     pub fn new(config: PoolConfig) -> Self {
         let pool = Self {
-            config,
-            connections: Mutex::new(HashMap::new()),
+            inner: Arc::new(PoolInner {
+                config,
+                connections: DashMap::new(),
+                over_capacity: Arc::new(Notify::new()),
+            }),
         };
 
-        // Start the cleanup task
-        pool.spawn_cleanup_task();
+        // Start the maintenance task
+        pool.spawn_maintenance_task();
 
         pool
     }
 
-    /// Adds a connection to the pool
-    pub async fn add_connection(&self, addr: SocketAddr, connection: Arc<TcpConnection>) {
-        let mut connections = self.connections.lock().await;
-
-        // If the pool is full and this is a new connection, try to remove the oldest one
-        if connections.len() >= self.config.max_connections && !connections.contains_key(&addr) {
-            if let Some((oldest_addr, _)) = connections
-                .iter()
-                .min_by_key(|(_, meta)| meta.last_activity)
-            {
-                let oldest_addr = *oldest_addr;
-                debug!(
-                    "Pool is full, removing oldest connection to {}",
-                    oldest_addr
-                );
-                connections.remove(&oldest_addr);
-            }
-        }
+    /// Pool configuration
+    pub fn config(&self) -> &PoolConfig {
+        &self.inner.config
+    }
 
-        // Add or update the connection
-        connections.insert(
-            addr,
-            ConnectionMeta {
-                connection,
-                last_activity: Instant::now(),
-            },
-        );
+    /// Number of pooled connections
+    pub fn len(&self) -> usize {
+        self.inner.connections.len()
+    }
 
-        trace!(
-            "Added connection to {} to pool (size: {})",
-            addr,
-            connections.len()
-        );
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
     }
 
-    /// Gets a connection from the pool if it exists
-    pub async fn get_connection(&self, addr: &SocketAddr) -> Option<Arc<TcpConnection>> {
-        let mut connections = self.connections.lock().await;
+    /// Adds a connection to the pool. Going over
+    /// [`PoolConfig::max_connections`] leaves eviction to the maintenance
+    /// task rather than scanning the pool on this path.
+    pub fn add_connection(&self, addr: SocketAddr, connection: Arc<TcpConnection>) {
+        let connections = &self.inner.connections;
+
+        // Add or update the connection
+        connections.insert(addr, connection);
 
-        if let Some(meta) = connections.get_mut(addr) {
-            // Update the last activity time
-            meta.last_activity = Instant::now();
-            trace!("Found connection to {} in pool", addr);
-            return Some(meta.connection.clone());
+        let size = connections.len();
+        if size > self.inner.config.max_connections {
+            self.inner.over_capacity.notify_one();
         }
 
-        trace!("No connection to {} in pool", addr);
-        None
+        trace!("Added connection to {} to pool (size: {})", addr, size);
     }
 
-    /// Removes a connection from the pool
-    pub async fn remove_connection(&self, addr: &SocketAddr) {
-        let mut connections = self.connections.lock().await;
+    /// Gets an open connection from the pool if it exists. A closed
+    /// connection found under `addr` is dropped from the pool.
+    pub fn get_connection(&self, addr: &SocketAddr) -> Option<Arc<TcpConnection>> {
+        let connection = self
+            .inner
+            .connections
+            .get(addr)
+            .map(|entry| entry.value().clone());
+
+        match connection {
+            Some(connection) if !connection.is_closed() => {
+                trace!("Found connection to {} in pool", addr);
+                Some(connection)
+            }
+            Some(connection) => {
+                trace!("Dropping closed connection to {} from pool", addr);
+                self.release_connection(addr, &connection);
+                None
+            }
+            None => {
+                trace!("No connection to {} in pool", addr);
+                None
+            }
+        }
+    }
 
-        if connections.remove(addr).is_some() {
+    /// Removes a connection from the pool
+    pub fn remove_connection(&self, addr: &SocketAddr) {
+        if self.inner.connections.remove(addr).is_some() {
             trace!(
                 "Removed connection to {} from pool (size: {})",
                 addr,
-                connections.len()
+                self.inner.connections.len()
+            );
+        }
+    }
+
+    /// Removes `connection` from the pool if it is still the one pooled
+    /// under `addr`, leaving a newer connection to the same peer alone
+    pub fn release_connection(&self, addr: &SocketAddr, connection: &Arc<TcpConnection>) {
+        if self
+            .inner
+            .connections
+            .remove_if(addr, |_, pooled| Arc::ptr_eq(pooled, connection))
+            .is_some()
+        {
+            trace!(
+                "Released connection to {} (size: {})",
+                addr,
+                self.inner.connections.len()
             );
         }
     }
@@ -121,159 +184,219 @@ impl ConnectionPool {
     /// Non-blocking check for whether the pool currently holds a
     /// connection to `addr`. Used by `TcpTransport::has_connection_to`
     /// and the URI-aware multiplexer's response-routing path (RFC 3261
-    /// §17.2 / §18.2.2). Returns `false` conservatively when the pool
-    /// lock is busy — the multiplexer will just try the next candidate.
+    /// §17.2 / §18.2.2).
     pub fn has_connection(&self, addr: &SocketAddr) -> bool {
-        match self.connections.try_lock() {
-            Ok(guard) => guard.contains_key(addr),
-            Err(_) => false,
-        }
+        self.inner.connections.contains_key(addr)
     }
 
     /// Closes all connections in the pool
     pub async fn close_all(&self) {
-        let mut connections = self.connections.lock().await;
+        let connections: Vec<(SocketAddr, Arc<TcpConnection>)> = self
+            .inner
+            .connections
+            .iter()
+            .map(|entry| (*entry.key(), entry.value().clone()))
+            .collect();
+        self.inner.connections.clear();
 
         info!(
             "Closing all connections in pool (count: {})",
             connections.len()
         );
 
-        // Close each connection
-        for (addr, meta) in connections.drain() {
-            if let Err(e) = meta.connection.close().await {
-                error!("Error closing connection to {}: {}", addr, e);
-            }
-        }
+        // Close them concurrently, so one stalled peer costs at most
+        // CLOSE_TIMEOUT overall
+        futures_util::future::join_all(
+            connections.iter().map(|(addr, connection)| {
+                close_bounded(*addr, connection, CLOSE_TIMEOUT, "pooled")
+            }),
+        )
+        .await;
     }
 
-    /// Spawns a task to periodically clean up idle connections
-    fn spawn_cleanup_task(&self) {
-        let pool = Arc::new(self.clone());
+    /// Spawns a task that periodically reaps idle connections and sends
+    /// keep-alive pings, and evicts connections whenever the pool goes
+    /// over capacity. It holds only a weak reference, so it ends once the
+    /// pool is dropped.
+    fn spawn_maintenance_task(&self) {
+        let pool = Arc::downgrade(&self.inner);
+        let over_capacity = self.inner.over_capacity.clone();
+        let period = self.inner.config.maintenance_period();
 
         tokio::spawn(async move {
-            let mut cleanup_interval = interval(Duration::from_secs(60));
+            let mut maintenance_interval = interval(period);
+            maintenance_interval.set_missed_tick_behavior(MissedTickBehavior::Delay);
+            // The first tick completes immediately.
+            maintenance_interval.tick().await;
 
             loop {
-                cleanup_interval.tick().await;
-                pool.cleanup_idle_connections().await;
+                let periodic = tokio::select! {
+                    _ = maintenance_interval.tick() => true,
+                    _ = over_capacity.notified() => false,
+                };
+                let Some(inner) = Weak::upgrade(&pool) else {
+                    break;
+                };
+                if periodic {
+                    inner.maintain().await;
+                }
+                inner.evict_excess().await;
             }
         });
     }
+}
 
-    /// Cleans up idle connections that have exceeded the timeout
-    async fn cleanup_idle_connections(&self) {
-        let mut connections = self.connections.lock().await;
-        let now = Instant::now();
+impl PoolInner {
+    /// Close connections that are closed or idle past the timeout, and
+    /// ping the ones due a keep-alive
+    async fn maintain(&self) {
         let idle_timeout = self.config.idle_timeout;
+        let keepalive = self.config.keepalive_interval;
+
+        // Collect first: map guards must not be held across awaits.
+        let mut idle = Vec::new();
+        let mut pings = 0usize;
+        for entry in self.connections.iter() {
+            let connection = entry.value();
+            if connection.is_closed() || connection.idle_for() > idle_timeout {
+                idle.push((*entry.key(), connection.clone()));
+            } else if keepalive.is_some_and(|interval| connection.send_idle_for() >= interval) {
+                if let Err(e) = connection.keepalive_ping() {
+                    debug!("Keep-alive ping to {} failed: {}", entry.key(), e);
+                }
+                pings += 1;
+            }
+        }
+        if pings > 0 {
+            trace!("Sent {} keep-alive pings", pings);
+        }
 
-        // Collect addresses of connections to remove
-        let idle_addrs: Vec<SocketAddr> = connections
-            .iter()
-            .filter(|(_, meta)| now.duration_since(meta.last_activity) > idle_timeout)
-            .map(|(addr, _)| *addr)
-            .collect();
-
-        if !idle_addrs.is_empty() {
-            debug!("Cleaning up {} idle connections", idle_addrs.len());
+        if !idle.is_empty() {
+            debug!("Cleaning up {} idle connections", idle.len());
 
             // Remove and close idle connections
-            for addr in idle_addrs {
-                if let Some(meta) = connections.remove(&addr) {
-                    if let Err(e) = meta.connection.close().await {
-                        error!("Error closing idle connection to {}: {}", addr, e);
-                    }
-                }
+            for (addr, connection) in idle {
+                self.connections
+                    .remove_if(&addr, |_, pooled| Arc::ptr_eq(pooled, &connection));
+                close_in_background(addr, connection, "idle");
             }
 
-            trace!("Pool size after cleanup: {}", connections.len());
+            trace!("Pool size after cleanup: {}", self.connections.len());
         }
     }
-}
 
-impl Clone for ConnectionPool {
-    fn clone(&self) -> Self {
-        Self {
-            config: self.config.clone(),
-            connections: Mutex::new(HashMap::new()),
+    /// Close the longest-idle connections of a pool over capacity, leaving
+    /// some headroom below the limit
+    async fn evict_excess(&self) {
+        let max = self.config.max_connections;
+        let size = self.connections.len();
+        if size <= max {
+            return;
         }
-    }
-}
+        let target = max - max / EVICTION_HEADROOM_DIVISOR;
 
-#[cfg(test)]
-mod tests {
-    use super::*;
-    use crate::error::Result;
-    use std::net::{IpAddr, Ipv4Addr};
-    use tokio::sync::Mutex as TokioMutex;
-
-    // Use a wrapper around Arc<TcpConnection> for the tests. The mock
-    // is constructed by the basic tests below but its methods aren't
-    // exercised in this iteration — the original integration tests
-    // were simplified out. Kept for the upcoming pool-behaviour tests.
-    #[allow(dead_code)]
-    #[derive(Clone)]
-    struct MockConnectionWrapper {
-        peer_addr: SocketAddr,
-        local_addr: SocketAddr,
-        closed: Arc<TokioMutex<bool>>,
-    }
-
-    #[allow(dead_code)]
-    impl MockConnectionWrapper {
-        fn new(peer_addr: SocketAddr) -> Self {
-            Self {
-                peer_addr,
-                local_addr: SocketAddr::new(IpAddr::V4(Ipv4Addr::new(127, 0, 0, 1)), 0),
-                closed: Arc::new(TokioMutex::new(false)),
-            }
+        // Collect first: map guards must not be held across awaits.
+        let mut candidates: Vec<(Duration, SocketAddr, Arc<TcpConnection>)> = self
+            .connections
+            .iter()
+            .map(|entry| (entry.value().idle_for(), *entry.key(), entry.value().clone()))
+            .collect();
+        let count = candidates.len().saturating_sub(target);
+        if count < candidates.len() {
+            candidates.select_nth_unstable_by(count, |a, b| b.0.cmp(&a.0));
+            candidates.truncate(count);
         }
 
-        fn peer_addr(&self) -> SocketAddr {
-            self.peer_addr
+        debug!(
+            "Pool over capacity ({} > {}), evicting {} idlest connections",
+            size,
+            max,
+            candidates.len()
+        );
+        for (_, addr, connection) in candidates {
+            self.connections
+                .remove_if(&addr, |_, pooled| Arc::ptr_eq(pooled, &connection));
+            close_in_background(addr, connection, "evicted");
         }
+    }
+}
 
-        fn local_addr(&self) -> Result<SocketAddr> {
-            Ok(self.local_addr)
-        }
+/// Close a connection dropped from the pool on its own task, so a peer
+/// that stopped reading never holds up the maintenance task
+fn close_in_background(addr: SocketAddr, connection: Arc<TcpConnection>, kind: &'static str) {
+    tokio::spawn(async move { close_bounded(addr, &connection, CLOSE_TIMEOUT, kind).await });
+}
 
-        async fn close(&self) -> Result<()> {
-            let mut closed = self.closed.lock().await;
-            *closed = true;
-            Ok(())
+/// Close `connection`, aborting its writer if the queued writes have not
+/// flushed within `limit`
+async fn close_bounded(addr: SocketAddr, connection: &TcpConnection, limit: Duration, kind: &str) {
+    match tokio::time::timeout(limit, connection.close()).await {
+        Ok(Ok(())) => {}
+        Ok(Err(e)) => error!("Error closing {} connection to {}: {}", kind, addr, e),
+        Err(_) => {
+            debug!(
+                "Closing {} connection to {} timed out; aborting its writer",
+                kind, addr
+            );
+            connection.abort();
         }
+    }
+}
 
-        async fn is_closed(&self) -> bool {
-            let closed = self.closed.lock().await;
-            *closed
-        }
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use bytes::Bytes;
+    use tokio::io::AsyncReadExt;
+    use tokio::net::TcpListener;
+
+    /// Open a loopback connection; the accepted peer socket is returned
+    /// so it stays open for the duration of the test.
+    async fn connect() -> (Arc<TcpConnection>, tokio::net::TcpStream) {
+        let listener = TcpListener::bind("127.0.0.1:0").await.unwrap();
+        let addr = listener.local_addr().unwrap();
+        let (connection, accepted) = tokio::join!(TcpConnection::connect(addr), listener.accept());
+        (Arc::new(connection.unwrap()), accepted.unwrap().0)
     }
 
     #[tokio::test]
     async fn test_connection_pool_basics() {
         let config = PoolConfig {
             max_connections: 5,
-            idle_timeout: Duration::from_secs(1),
+            idle_timeout: Duration::from_secs(300),
+            keepalive_interval: None,
         };
 
         let pool = ConnectionPool::new(config);
-
-        // Create some addresses to test with
-        let addr1 = SocketAddr::new(IpAddr::V4(Ipv4Addr::new(192, 168, 1, 1)), 5060);
-        let addr2 = SocketAddr::new(IpAddr::V4(Ipv4Addr::new(192, 168, 1, 2)), 5060);
-
-        // Create mock connection objects, wrapped in a way that TcpConnection would be
-        let _conn1 = Arc::new(MockConnectionWrapper::new(addr1));
-        let _conn2 = Arc::new(MockConnectionWrapper::new(addr2));
-
-        // Here we simulate the connection pool behavior without actually testing the add_connection logic
-        // Instead, just check if we can retrieve, remove connections, etc.
-
-        // Skip testing this particular functionality since it requires actual TcpConnection instances
-        // This would be better tested in integration tests with real connections
+        let (conn1, _peer1) = connect().await;
+        let (conn2, _peer2) = connect().await;
+        let addr1 = conn1.peer_addr();
+        let addr2 = conn2.peer_addr();
+
+        pool.add_connection(addr1, conn1.clone());
+        pool.add_connection(addr2, conn2.clone());
+        assert_eq!(pool.len(), 2);
+        assert!(pool.has_connection(&addr1));
+        assert!(Arc::ptr_eq(&pool.get_connection(&addr1).unwrap(), &conn1));
+
+        // Releasing a connection that was replaced leaves the new one.
+        let (replacement, _peer3) = connect().await;
+        pool.add_connection(addr1, replacement.clone());
+        pool.release_connection(&addr1, &conn1);
+        assert!(Arc::ptr_eq(
+            &pool.get_connection(&addr1).unwrap(),
+            &replacement
+        ));
+
+        // Closed connections are not handed out.
+        conn2.close().await.unwrap();
+        assert!(pool.get_connection(&addr2).is_none());
+        assert!(!pool.has_connection(&addr2));
 
         // Close all connections
         pool.close_all().await;
+        assert!(pool.is_empty());
+        assert!(replacement.is_closed());
     }
 
     #[tokio::test]
@@ -281,24 +404,104 @@ mod tests {
         let config = PoolConfig {
             max_connections: 2,
             idle_timeout: Duration::from_secs(300),
+            keepalive_interval: None,
         };
 
         let pool = ConnectionPool::new(config);
 
-        // Create addresses for testing
-        let addr1 = SocketAddr::new(IpAddr::V4(Ipv4Addr::new(192, 168, 1, 1)), 5060);
-        let addr2 = SocketAddr::new(IpAddr::V4(Ipv4Addr::new(192, 168, 1, 2)), 5060);
-        let addr3 = SocketAddr::new(IpAddr::V4(Ipv4Addr::new(192, 168, 1, 3)), 5060);
+        // Verify pool configuration
+        assert_eq!(pool.config().max_connections, 2);
+
+        let mut connections = Vec::new();
+        let mut peers = Vec::new();
+        for _ in 0..3 {
+            let (connection, peer) = connect().await;
+            peers.push(peer);
+            pool.add_connection(connection.peer_addr(), connection.clone());
+            connections.push(connection);
+            tokio::time::sleep(Duration::from_millis(5)).await;
+        }
+
+        // The idlest connection is evicted and shut down, not just dropped.
+        tokio::time::timeout(Duration::from_secs(2), async {
+            while pool.len() > 2 {
+                tokio::time::sleep(Duration::from_millis(5)).await;
+            }
+        })
+        .await
+        .expect("pool trimmed to capacity");
+        assert!(!pool.has_connection(&connections[0].peer_addr()));
+        assert!(connections[0].is_closed());
+        assert!(pool.has_connection(&connections[2].peer_addr()));
+
+        let mut buf = [0u8; 8];
+        assert_eq!(peers[0].read(&mut buf).await.unwrap(), 0);
+    }
+
+    #[tokio::test]
+    async fn test_idle_connections_are_reaped_and_clones_share_state() {
+        let pool = ConnectionPool::new(PoolConfig {
+            max_connections: 10,
+            idle_timeout: Duration::from_millis(200),
+            keepalive_interval: None,
+        });
+        let (connection, mut peer) = connect().await;
+        pool.clone()
+            .add_connection(connection.peer_addr(), connection.clone());
+        assert!(pool.has_connection(&connection.peer_addr()));
+
+        tokio::time::sleep(Duration::from_millis(600)).await;
+        assert!(pool.is_empty());
+        assert!(connection.is_closed());
+
+        // The reaper shut the socket down.
+        let mut buf = [0u8; 8];
+        assert_eq!(peer.read(&mut buf).await.unwrap(), 0);
+    }
 
-        // Create mock connections
-        let _conn1 = Arc::new(MockConnectionWrapper::new(addr1));
-        let _conn2 = Arc::new(MockConnectionWrapper::new(addr2));
-        let _conn3 = Arc::new(MockConnectionWrapper::new(addr3));
+    #[tokio::test]
+    async fn test_close_of_stalled_peer_is_bounded() {
+        let (connection, _peer) = connect().await;
+        // The peer never reads: once the socket buffers fill, the writer
+        // is stuck and a graceful close cannot complete.
+        for _ in 0..32 {
+            connection
+                .send_bytes(Bytes::from(vec![0u8; 1 << 20]))
+                .await
+                .unwrap();
+        }
 
-        // Skip testing this particular functionality since it requires actual TcpConnection instances
-        // This would be better tested in integration tests with real connections
+        tokio::time::timeout(
+            Duration::from_secs(2),
+            close_bounded(
+                connection.peer_addr(),
+                &connection,
+                Duration::from_millis(100),
+                "test",
+            ),
+        )
+        .await
+        .expect("close gives up and aborts the writer");
+        assert!(connection.is_closed());
+    }
 
-        // Verify pool configuration
-        assert_eq!(pool.config.max_connections, 2);
+    #[tokio::test]
+    async fn test_keepalive_pings_idle_connections() {
+        let pool = ConnectionPool::new(PoolConfig {
+            max_connections: 10,
+            idle_timeout: Duration::from_secs(300),
+            keepalive_interval: Some(Duration::from_millis(200)),
+        });
+        let (connection, mut peer) = connect().await;
+        pool.add_connection(connection.peer_addr(), connection.clone());
+
+        let mut buf = [0u8; 4];
+        tokio::time::timeout(Duration::from_secs(2), peer.read_exact(&mut buf))
+            .await
+            .expect("keep-alive ping within 2s")
+            .unwrap();
+        assert_eq!(&buf, b"\r\n\r\n");
+        // Pings are not activity: the connection still counts as idle.
+        assert!(connection.idle_for() >= Duration::from_millis(200));
     }
 }
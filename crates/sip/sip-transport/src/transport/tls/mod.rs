@@ -8,7 +8,9 @@ use std::sync::Arc;
 
 use async_trait::async_trait;
 use bytes::{Buf, Bytes, BytesMut};
+use dashmap::DashMap;
 use rvoip_sip_core::types::uri::Host;
+use rvoip_sip_core::types::wire::WireFormat;
 use tokio::io::{AsyncRead, AsyncReadExt, AsyncWrite, AsyncWriteExt};
 use tokio::net::{TcpListener, TcpStream};
 use tokio::sync::mpsc;
@@ -29,8 +31,12 @@ use tokio_rustls::{TlsAcceptor, TlsConnector};
 use tracing::{debug, error, info, trace, warn};
 
 use crate::error::{Error, Result};
+use crate::transport::stream_writer::{write_all_batch, MAX_WRITE_BATCH, WRITE_QUEUE_CAPACITY};
 use crate::transport::{Transport, TransportEvent, TransportType};
 
+/// Write channels of open TLS connections, keyed by remote address
+type TlsConnections = Arc<DashMap<SocketAddr, mpsc::Sender<Bytes>>>;
+
 /// Builder-friendly TLS client configuration. Mirrors the knobs we
 /// expect to expose through `session-core::Config` once Step 1C wires
 /// it up.
@@ -95,8 +101,9 @@ pub struct TlsTransport {
     /// Active TLS connections, keyed by remote address. Used by
     /// `send_message` to find the right write-side mpsc channel.
     /// Connection-lifetime: removed by the per-connection reader task
-    /// on EOF/error.
-    connections: Arc<tokio::sync::Mutex<Vec<(SocketAddr, mpsc::Sender<Bytes>)>>>,
+    /// on EOF/error. Sharded, so concurrent sends to different peers do
+    /// not serialise on one lock.
+    connections: TlsConnections,
 
     /// Transport event sender.
     event_tx: Option<mpsc::Sender<TransportEvent>>,
@@ -219,7 +226,7 @@ impl TlsTransport {
             local_addr: actual_addr,
             acceptor: Some(acceptor),
             connector,
-            connections: Arc::new(tokio::sync::Mutex::new(Vec::new())),
+            connections: Arc::new(DashMap::new()),
             event_tx: Some(tx),
             closed: Arc::new(AtomicBool::new(false)),
         };
@@ -272,7 +279,7 @@ impl TlsTransport {
                 local_addr,
                 acceptor: None,
                 connector,
-                connections: Arc::new(tokio::sync::Mutex::new(Vec::new())),
+                connections: Arc::new(DashMap::new()),
                 event_tx: Some(tx),
                 closed: Arc::new(AtomicBool::new(false)),
             },
@@ -285,7 +292,7 @@ impl TlsTransport {
         listener: TcpListener,
         addr: SocketAddr,
         acceptor: TlsAcceptor,
-        connections: Arc<tokio::sync::Mutex<Vec<(SocketAddr, mpsc::Sender<Bytes>)>>>,
+        connections: TlsConnections,
         event_tx: mpsc::Sender<TransportEvent>,
     ) {
         loop {
@@ -339,22 +346,22 @@ impl TlsTransport {
         tls_stream: S,
         remote_addr: SocketAddr,
         local_addr: SocketAddr,
-        connections: Arc<tokio::sync::Mutex<Vec<(SocketAddr, mpsc::Sender<Bytes>)>>>,
+        connections: TlsConnections,
         event_tx: mpsc::Sender<TransportEvent>,
     ) where
         S: AsyncRead + AsyncWrite + Send + Unpin + 'static,
     {
         let (mut reader, mut writer) = tokio::io::split(tls_stream);
-        let (tx, mut rx) = mpsc::channel::<Bytes>(100);
+        let (tx, mut rx) = mpsc::channel::<Bytes>(WRITE_QUEUE_CAPACITY);
 
-        {
-            let mut connections_guard = connections.lock().await;
-            connections_guard.push((remote_addr, tx.clone()));
-        }
+        connections.insert(remote_addr, tx.clone());
 
+        // Everything queued while the previous batch was being written
+        // goes out in one vectored write and one record flush.
         let write_task = tokio::spawn(async move {
-            while let Some(data) = rx.recv().await {
-                if let Err(e) = writer.write_all(&data).await {
+            let mut batch = Vec::with_capacity(MAX_WRITE_BATCH);
+            while rx.recv_many(&mut batch, MAX_WRITE_BATCH).await > 0 {
+                if let Err(e) = write_all_batch(&mut writer, &batch).await {
                     error!("Failed to write to TLS stream: {}", e);
                     break;
                 }
@@ -362,6 +369,7 @@ impl TlsTransport {
                     error!("Failed to flush TLS stream: {}", e);
                     break;
                 }
+                batch.clear();
             }
         });
 
@@ -450,10 +458,9 @@ impl TlsTransport {
             })
             .await;
 
-        {
-            let mut connections_guard = connections.lock().await;
-            connections_guard.retain(|(addr, _)| *addr != remote_addr);
-        }
+        // Only this connection's entry: a newer connection to the same
+        // peer may already have replaced it.
+        connections.remove_if(&remote_addr, |_, registered| registered.same_channel(&tx));
 
         debug!("TLS connection closed: {}", remote_addr);
     }
@@ -470,14 +477,11 @@ impl TlsTransport {
         // Fast path: existing connection. Clone the bytes for the fast
         // path send so we still have the original on hand for the
         // auto-dial fallback when the channel is closed.
-        {
-            let connections_guard = self.connections.lock().await;
-            if let Some((_, tx)) = connections_guard.iter().find(|(a, _)| *a == addr) {
-                if tx.send(data.clone()).await.is_ok() {
-                    return Ok(());
-                }
-                // Sender closed — fall through to reconnect.
+        if let Some(tx) = self.connection_sender(&addr) {
+            if tx.send(data.clone()).await.is_ok() {
+                return Ok(());
             }
+            // Sender closed — fall through to reconnect.
         }
 
         if self.role == TlsRole::ServerOnly {
@@ -493,16 +497,12 @@ impl TlsTransport {
             None => self.connect(addr).await?,
         }
 
-        let connections_guard = self.connections.lock().await;
-        let (_, tx) = connections_guard
-            .iter()
-            .find(|(a, _)| *a == addr)
-            .ok_or_else(|| {
-                Error::Other(format!(
-                    "TLS auto-dial succeeded but no connection registered for {}",
-                    addr
-                ))
-            })?;
+        let tx = self.connection_sender(&addr).ok_or_else(|| {
+            Error::Other(format!(
+                "TLS auto-dial succeeded but no connection registered for {}",
+                addr
+            ))
+        })?;
         tx.send(data).await.map_err(|_| {
             Error::Other(format!(
                 "Failed to push bytes to TLS write channel for {}",
@@ -511,6 +511,14 @@ impl TlsTransport {
         })
     }
 
+    /// Write channel of the open connection to `addr`, cloned so no map
+    /// guard is held while the caller awaits the send
+    fn connection_sender(&self, addr: &SocketAddr) -> Option<mpsc::Sender<Bytes>> {
+        self.connections
+            .get(addr)
+            .map(|entry| entry.value().clone())
+    }
+
     /// Connect to a remote address. The SNI `ServerName` is derived
     /// from `remote_addr` — IP literal for IP destinations, falls back
     /// to "localhost" for the loopback IP (so default rustls hostname
@@ -536,14 +544,8 @@ impl TlsTransport {
         }
 
         // Already connected? — short-circuit.
-        {
-            let connections_guard = self.connections.lock().await;
-            if connections_guard
-                .iter()
-                .any(|(addr, _)| *addr == remote_addr)
-            {
-                return Ok(());
-            }
+        if self.connections.contains_key(&remote_addr) {
+            return Ok(());
         }
 
         debug!("TLS dial → {} (SNI {:?})", remote_addr, server_name);
@@ -582,14 +584,8 @@ impl TlsTransport {
         // `connect` + `send_message` race can lose the very first
         // outgoing bytes.
         for _ in 0..50 {
-            {
-                let connections_guard = self.connections.lock().await;
-                if connections_guard
-                    .iter()
-                    .any(|(addr, _)| *addr == remote_addr)
-                {
-                    return Ok(());
-                }
+            if self.connections.contains_key(&remote_addr) {
+                return Ok(());
             }
             tokio::time::sleep(std::time::Duration::from_millis(2)).await;
         }
@@ -610,14 +606,13 @@ impl Transport for TlsTransport {
         message: rvoip_sip_core::Message,
         destination: SocketAddr,
     ) -> Result<()> {
-        // `Message::to_bytes` produces wire-format SIP (header CRLFs +
+        // `WireFormat::to_wire` produces wire-format SIP (header CRLFs +
         // trailing CRLF separator + body) — required by RFC 3261 §7.2.
         // `to_string()` is for display/debug only and omits the final
         // separator, which then breaks Content-Length framing on the
         // peer's read side.
         let server_name = tls_server_name_for_message(&message, destination);
-        let bytes = message.to_bytes();
-        self.send_to_addr(bytes.into(), destination, server_name)
+        self.send_to_addr(message.to_wire(), destination, server_name)
             .await
     }
 
@@ -639,14 +634,9 @@ impl Transport for TlsTransport {
     }
 
     fn has_connection_to(&self, remote_addr: SocketAddr) -> bool {
-        // `try_lock` so this is non-blocking — the multiplexer may call
-        // it from inside its own dispatch path. A momentary lock-busy
-        // is acceptable to report `false` (the multiplexer will fall
-        // through to its default transport).
-        match self.connections.try_lock() {
-            Ok(guard) => guard.iter().any(|(addr, _)| *addr == remote_addr),
-            Err(_) => false,
-        }
+        // Non-blocking — the multiplexer may call it from inside its own
+        // dispatch path.
+        self.connections.contains_key(&remote_addr)
     }
 
     async fn send_raw(&self, destination: SocketAddr, data: Bytes) -> Result<()> {
@@ -657,8 +647,7 @@ impl Transport for TlsTransport {
         // RFC 5626 keep-alive: only reuse an existing TLS connection.
         // A fresh dial would defeat the purpose — the flow we'd keep
         // alive is already gone.
-        let connections_guard = self.connections.lock().await;
-        let Some((_, tx)) = connections_guard.iter().find(|(a, _)| *a == destination) else {
+        let Some(tx) = self.connection_sender(&destination) else {
             return Err(Error::InvalidState(format!(
                 "No active TLS connection to {} for send_raw",
                 destination
@@ -955,29 +944,12 @@ fn try_parse_one(buffer: &mut BytesMut) -> Option<(rvoip_sip_core::Message, byte
         return None;
     }
 
-    // End-of-headers = double CRLF.
-    let header_end =
-        (0..buffer.len().saturating_sub(3)).find(|&i| &buffer[i..i + 4] == b"\r\n\r\n")?;
-    let body_start = header_end + 4;
-
-    // Pull Content-Length from the header section. SIP allows the
-    // compact form "l:" but the bulk of senders use the long form.
-    let content_length = {
-        let header_str = std::str::from_utf8(&buffer[..header_end + 4]).ok()?;
-        let mut len = 0usize;
-        for line in header_str.lines() {
-            let trimmed = line.trim();
-            let lower = trimmed.to_ascii_lowercase();
-            if lower.starts_with("content-length:") || lower.starts_with("l:") {
-                if let Some(value) = trimmed.split(':').nth(1) {
-                    if let Ok(n) = value.trim().parse::<usize>() {
-                        len = n;
-                    }
-                }
-            }
-        }
-        len
-    };
+    // End-of-headers = double CRLF, found by the shared head pre-pass
+    // along with the Content-Length header. SIP allows the compact form
+    // "l:" but the bulk of senders use the long form.
+    let head = rvoip_sip_core::parser::scan::scan_message_head(buffer);
+    let body_start = head.end()?;
+    let content_length = head.content_length(buffer).unwrap_or(0);
 
     let total = body_start + content_length;
     if buffer.len() < total {
@@ -2,6 +2,7 @@ use bytes::Bytes;
 use std::io::ErrorKind;
 use std::net::SocketAddr;
 use std::sync::Arc;
+use tokio::io::Interest;
 use tokio::net::UdpSocket;
 use tracing::trace;
 // `error!` is only reached from the `#[cfg(test)] pub fn default()`
@@ -18,6 +19,131 @@ use tracing::error;
 const MAX_UDP_PACKET_SIZE: usize = 65_507;
 // Buffer size for receiving packets
 const UDP_BUFFER_SIZE: usize = 8192;
+/// Most datagrams one [`UdpListener::receive_batch`] call returns
+pub const MAX_RECEIVE_BATCH: usize = 64;
+
+/// Reusable receive buffers for [`UdpListener::receive_batch`]
+///
+/// Holds one `UDP_BUFFER_SIZE` slot per datagram so a whole batch is read
+/// with a single `recvmmsg` call on Linux. The buffers are allocated once
+/// and reused for every batch; each datagram is still copied out into an
+/// exactly-sized `Bytes`, as [`UdpListener::receive`] does.
+pub struct UdpReceiveBatch {
+    buffers: Box<[u8]>,
+    #[cfg(target_os = "linux")]
+    addrs: Box<[libc::sockaddr_storage]>,
+    /// `(slot, length, source)` of each datagram in the last batch
+    received: Vec<(usize, usize, SocketAddr)>,
+}
+
+impl UdpReceiveBatch {
+    /// Create buffers for up to `capacity` datagrams per batch, clamped to
+    /// `1..=MAX_RECEIVE_BATCH`.
+    pub fn new(capacity: usize) -> Self {
+        let capacity = capacity.clamp(1, MAX_RECEIVE_BATCH);
+        Self {
+            buffers: vec![0u8; capacity * UDP_BUFFER_SIZE].into_boxed_slice(),
+            // SAFETY: `sockaddr_storage` is plain data; all-zero is valid.
+            #[cfg(target_os = "linux")]
+            addrs: vec![unsafe { std::mem::zeroed() }; capacity].into_boxed_slice(),
+            received: Vec::with_capacity(capacity),
+        }
+    }
+
+    /// Most datagrams one batch can hold
+    pub fn capacity(&self) -> usize {
+        self.buffers.len() / UDP_BUFFER_SIZE
+    }
+
+    /// Datagrams in the last batch
+    pub fn len(&self) -> usize {
+        self.received.len()
+    }
+
+    /// Whether the last batch was empty
+    pub fn is_empty(&self) -> bool {
+        self.received.is_empty()
+    }
+
+    /// Datagrams of the last batch with their source addresses, in
+    /// receive order
+    pub fn iter(&self) -> impl Iterator<Item = (&[u8], SocketAddr)> + '_ {
+        self.received.iter().map(|&(slot, len, src)| {
+            let start = slot * UDP_BUFFER_SIZE;
+            (&self.buffers[start..start + len], src)
+        })
+    }
+
+    /// Read every ready datagram, up to capacity, with one `recvmmsg`
+    #[cfg(target_os = "linux")]
+    fn try_fill(&mut self, socket: &UdpSocket) -> std::io::Result<usize> {
+        use std::os::fd::AsRawFd;
+
+        self.received.clear();
+        let capacity = self.capacity();
+        // SAFETY: `iovec` and `mmsghdr` are plain data; all-zero is valid.
+        let mut iovecs: [libc::iovec; MAX_RECEIVE_BATCH] = unsafe { std::mem::zeroed() };
+        let mut headers: [libc::mmsghdr; MAX_RECEIVE_BATCH] = unsafe { std::mem::zeroed() };
+        for (i, buf) in self.buffers.chunks_mut(UDP_BUFFER_SIZE).enumerate() {
+            iovecs[i].iov_base = buf.as_mut_ptr().cast();
+            iovecs[i].iov_len = buf.len();
+            let header = &mut headers[i].msg_hdr;
+            header.msg_name = (&mut self.addrs[i] as *mut libc::sockaddr_storage).cast();
+            header.msg_namelen = std::mem::size_of::<libc::sockaddr_storage>() as libc::socklen_t;
+            header.msg_iov = &mut iovecs[i];
+            header.msg_iovlen = 1;
+        }
+
+        // SAFETY: the first `capacity` headers point at live, disjoint
+        // buffers and address slots owned by `self`, which outlive the call.
+        let count = unsafe {
+            libc::recvmmsg(
+                socket.as_raw_fd(),
+                headers.as_mut_ptr(),
+                capacity as _,
+                libc::MSG_DONTWAIT as _,
+                std::ptr::null_mut(),
+            )
+        };
+        if count < 0 {
+            return Err(std::io::Error::last_os_error());
+        }
+
+        for (slot, (header, addr)) in headers
+            .iter()
+            .zip(self.addrs.iter())
+            .take(count as usize)
+            .enumerate()
+        {
+            // SAFETY: the kernel wrote a valid address of `msg_namelen` bytes.
+            let source =
+                unsafe { socket2::SockAddr::new(*addr, header.msg_hdr.msg_namelen) }.as_socket();
+            // A datagram without an IP source cannot be answered; drop it.
+            if let Some(source) = source {
+                self.received.push((slot, header.msg_len as usize, source));
+            }
+        }
+        Ok(self.received.len())
+    }
+
+    /// Read every ready datagram, up to capacity, one `recv_from` at a time
+    #[cfg(not(target_os = "linux"))]
+    fn try_fill(&mut self, socket: &UdpSocket) -> std::io::Result<usize> {
+        self.received.clear();
+        for (slot, buf) in self.buffers.chunks_mut(UDP_BUFFER_SIZE).enumerate() {
+            match socket.try_recv_from(buf) {
+                Ok((len, src)) => self.received.push((slot, len, src)),
+                Err(error)
+                    if error.kind() == ErrorKind::WouldBlock && !self.received.is_empty() =>
+                {
+                    break
+                }
+                Err(error) => return Err(error),
+            }
+        }
+        Ok(self.received.len())
+    }
+}
 
 /// UDP listener for receiving SIP messages
 pub struct UdpListener {
@@ -109,6 +235,30 @@ impl UdpListener {
         }
     }
 
+    /// Waits for the socket to become readable, then receives every ready
+    /// datagram into `batch`, up to its capacity.
+    ///
+    /// On Linux the whole batch is one `recvmmsg` syscall; elsewhere it is
+    /// a `recv_from` per datagram. Returns the number of datagrams received,
+    /// which is at least one.
+    pub async fn receive_batch(&self, batch: &mut UdpReceiveBatch) -> Result<usize> {
+        loop {
+            self.socket.readable().await.map_err(Error::ReceiveFailed)?;
+            match self
+                .socket
+                .try_io(Interest::READABLE, || batch.try_fill(&self.socket))
+            {
+                Ok(0) => continue,
+                Ok(count) => {
+                    trace!("Received {} datagrams on {}", count, self.local_addr);
+                    return Ok(count);
+                }
+                Err(error) if error.kind() == ErrorKind::WouldBlock => continue,
+                Err(error) => return Err(Error::ReceiveFailed(error)),
+            }
+        }
+    }
+
     /// Creates a default dummy listener (used for testing)
     #[cfg(test)]
     pub fn default() -> Self {
@@ -209,4 +359,33 @@ mod tests {
         assert_eq!(src.ip(), sender_socket.local_addr().unwrap().ip());
         assert!(listener.try_receive().unwrap().is_none());
     }
+
+    #[tokio::test]
+    async fn test_udp_listener_receive_batch() {
+        let listener = UdpListener::bind("127.0.0.1:0".parse().unwrap())
+            .await
+            .unwrap();
+        let addr = listener.local_addr().unwrap();
+        let sender_socket = UdpSocket::bind("127.0.0.1:0").await.unwrap();
+        let sender_addr = sender_socket.local_addr().unwrap();
+
+        let payloads: Vec<Vec<u8>> = (0..5).map(|i| format!("BATCH {i}").into_bytes()).collect();
+        for payload in &payloads {
+            sender_socket.send_to(payload, addr).await.unwrap();
+        }
+
+        // Small capacity forces the datagrams across several batches.
+        let mut batch = UdpReceiveBatch::new(2);
+        let mut received = Vec::new();
+        while received.len() < payloads.len() {
+            let count = listener.receive_batch(&mut batch).await.unwrap();
+            assert!((1..=2).contains(&count));
+            assert_eq!(batch.len(), count);
+            for (packet, src) in batch.iter() {
+                assert_eq!(src, sender_addr);
+                received.push(packet.to_vec());
+            }
+        }
+        assert_eq!(received, payloads);
+    }
 }
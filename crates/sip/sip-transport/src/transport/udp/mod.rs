@@ -2,14 +2,14 @@ mod listener;
 mod sender;
 mod socket;
 
-pub use listener::UdpListener;
+pub use listener::{UdpListener, UdpReceiveBatch};
 pub use sender::UdpSender;
-pub use socket::UdpSocketOptions;
+pub use socket::{UdpSocketOptions, MAX_RECEIVE_SOCKETS};
 
 use std::fmt;
 use std::net::SocketAddr;
 use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
-use std::sync::Arc;
+use std::sync::{Arc, OnceLock};
 use std::time::Instant;
 
 use bytes::Bytes;
@@ -19,7 +19,10 @@ use tracing::{debug, error, info, trace, warn};
 
 use crate::diagnostics;
 use crate::error::{Error, Result};
-use crate::transport::{Transport, TransportEvent, TransportReceiveTiming, TransportType};
+use crate::transport::{
+    shard, BufferPool, Transport, TransportEvent, TransportReceiveTiming, TransportType,
+};
+use rvoip_sip_core::types::wire::WireFormat;
 use rvoip_sip_core::Message;
 
 // Default channel capacity
@@ -28,6 +31,9 @@ const DEFAULT_PARSE_WORKERS: usize = 1;
 const MAX_PARSE_WORKERS: usize = 64;
 const UDP_RECEIVE_DRAIN_BATCH: usize = 64;
 
+/// Shard sink attached after bind, shared with the receive and parse tasks
+type ShardSinkSlot = Arc<OnceLock<Arc<dyn shard::ShardSink>>>;
+
 /// RFC 3261 §18.1.1 — outbound SIP requests larger than this MUST be
 /// shipped over a congestion-controlled transport (TCP) rather than UDP
 /// when path MTU is unknown. This is the safe default; deployments
@@ -41,6 +47,13 @@ pub enum UdpParseDispatch {
     SourceHash,
     /// Spread datagrams across workers in receive order.
     RoundRobin,
+    /// Hash the top Via branch with
+    /// [`datagram_shard_hash`](crate::transport::shard::datagram_shard_hash),
+    /// falling back to the source hash for datagrams without one. With as
+    /// many parse workers as transaction shards, worker `k` feeds only
+    /// shard `k`, and one source's transactions still spread across
+    /// workers.
+    TransactionShard,
 }
 
 impl Default for UdpParseDispatch {
@@ -134,6 +147,17 @@ impl UdpParseConfig {
 }
 
 /// UDP transport for SIP messages
+///
+/// By default one socket is bound and its receive loop hands datagrams to
+/// the parse workers described by [`UdpParseConfig`]. With
+/// [`UdpSocketOptions::receive_sockets`] above one, the transport binds that
+/// many `SO_REUSEPORT` sockets on the same address instead (Linux and
+/// FreeBSD; other platforms bind one socket). The kernel
+/// hashes each flow onto one socket, so a source's datagrams stay in order,
+/// and each socket's receive loop batch-receives (`recvmmsg` on Linux) and
+/// parses inline: no hop through a worker queue, and receive work runs on
+/// as many runtime threads as there are sockets. Parse worker settings are
+/// not used in that mode. Outgoing messages are sent from the first socket.
 #[derive(Clone)]
 pub struct UdpTransport {
     inner: Arc<UdpTransportInner>,
@@ -142,9 +166,15 @@ pub struct UdpTransport {
 struct UdpTransportInner {
     sender: UdpSender,
     listener: Arc<UdpListener>,
+    /// Further `SO_REUSEPORT` sockets bound to the listener's address, each
+    /// with its own inline-parsing receive loop
+    reuse_port_listeners: Vec<Arc<UdpListener>>,
     closed: AtomicBool,
     events_tx: mpsc::Sender<TransportEvent>,
-    receive_task: tokio::sync::Mutex<Option<tokio::task::JoinHandle<()>>>,
+    /// Transaction shards parsed messages go to instead of `events_tx`,
+    /// once attached with [`Transport::attach_shard_sink`]
+    shard_sink: ShardSinkSlot,
+    receive_tasks: tokio::sync::Mutex<Vec<tokio::task::JoinHandle<()>>>,
     parse_tasks: tokio::sync::Mutex<Vec<tokio::task::JoinHandle<()>>>,
     shutdown_tx: tokio::sync::watch::Sender<bool>,
     shutdown_rx: tokio::sync::watch::Receiver<bool>,
@@ -158,6 +188,8 @@ struct UdpTransportInner {
     parse_worker_count: usize,
     parse_worker_queue_capacity: usize,
     parse_dispatch: UdpParseDispatch,
+    /// Reusable serialization buffers for outgoing messages
+    send_buffers: BufferPool,
 }
 
 #[derive(Debug)]
@@ -249,9 +281,23 @@ impl UdpTransport {
         // Create the UDP listener
         let listener = UdpListener::bind_with_socket_options(addr, socket_options).await?;
         let local_addr = listener.local_addr()?;
+        let receive_sockets = socket_options.effective_receive_sockets();
+        if receive_sockets < socket_options.receive_sockets {
+            warn!(
+                requested = socket_options.receive_sockets,
+                receive_sockets, "Binding fewer UDP receive sockets than requested"
+            );
+        }
+        // Further sockets join the first one's (possibly ephemeral) port.
+        let mut reuse_port_listeners = Vec::with_capacity(receive_sockets - 1);
+        for _ in 1..receive_sockets {
+            let listener =
+                UdpListener::bind_with_socket_options(local_addr, socket_options).await?;
+            reuse_port_listeners.push(Arc::new(listener));
+        }
         info!(
-            "SIP UDP transport bound to {} (MTU threshold {} bytes, socket options {:?})",
-            local_addr, safe_max_bytes, socket_options
+            "SIP UDP transport bound to {} (MTU threshold {} bytes, {} receive socket(s), socket options {:?})",
+            local_addr, safe_max_bytes, receive_sockets, socket_options
         );
 
         // Create the UDP sender (shares same socket)
@@ -265,9 +311,11 @@ impl UdpTransport {
             inner: Arc::new(UdpTransportInner {
                 sender,
                 listener: Arc::new(listener),
+                reuse_port_listeners,
                 closed: AtomicBool::new(false),
                 events_tx: events_tx.clone(),
-                receive_task: tokio::sync::Mutex::new(None),
+                shard_sink: ShardSinkSlot::default(),
+                receive_tasks: tokio::sync::Mutex::new(Vec::new()),
                 parse_tasks: tokio::sync::Mutex::new(Vec::new()),
                 shutdown_tx,
                 shutdown_rx,
@@ -276,6 +324,7 @@ impl UdpTransport {
                 parse_worker_count,
                 parse_worker_queue_capacity,
                 parse_dispatch,
+                send_buffers: BufferPool::default(),
             }),
         };
 
@@ -304,9 +353,11 @@ impl UdpTransport {
             inner: Arc::new(UdpTransportInner {
                 sender,
                 listener: Arc::new(listener),
+                reuse_port_listeners: Vec::new(),
                 closed: AtomicBool::new(true), // Mark as closed
                 events_tx,
-                receive_task: tokio::sync::Mutex::new(None),
+                shard_sink: ShardSinkSlot::default(),
+                receive_tasks: tokio::sync::Mutex::new(Vec::new()),
                 parse_tasks: tokio::sync::Mutex::new(Vec::new()),
                 shutdown_tx,
                 shutdown_rx,
@@ -315,6 +366,7 @@ impl UdpTransport {
                 parse_worker_count: 1,
                 parse_worker_queue_capacity: DEFAULT_CHANNEL_CAPACITY,
                 parse_dispatch: UdpParseDispatch::SourceHash,
+                send_buffers: BufferPool::default(),
             }),
         }
     }
@@ -333,8 +385,18 @@ impl UdpTransport {
         )
     }
 
+    /// Number of sockets receiving on the bound address
+    pub fn receive_socket_count(&self) -> usize {
+        1 + self.inner.reuse_port_listeners.len()
+    }
+
     // Spawns a task to receive packets from the UDP socket
     async fn spawn_receive_loop(&self) {
+        if !self.inner.reuse_port_listeners.is_empty() {
+            self.spawn_inline_receive_loops().await;
+            return;
+        }
+
         let worker_count = self.inner.parse_worker_count;
         let queue_capacity = self.inner.parse_worker_queue_capacity;
         let dispatch = self.inner.parse_dispatch;
@@ -347,9 +409,10 @@ impl UdpTransport {
             worker_senders.push(tx);
 
             let events_tx = self.inner.events_tx.clone();
+            let shard_sink = self.inner.shard_sink.clone();
             let shutdown_rx = self.inner.shutdown_rx.clone();
             worker_handles.push(tokio::spawn(async move {
-                udp_parse_worker(worker_id, rx, events_tx, shutdown_rx).await;
+                udp_parse_worker(worker_id, rx, events_tx, shard_sink, shutdown_rx).await;
             }));
         }
 
@@ -451,21 +514,115 @@ impl UdpTransport {
         });
 
         // Store the task handle
-        let mut task_guard = self.inner.receive_task.lock().await;
-        *task_guard = Some(handle);
+        let mut task_guard = self.inner.receive_tasks.lock().await;
+        *task_guard = vec![handle];
+    }
+
+    // Spawns one inline-parsing receive loop per SO_REUSEPORT socket
+    async fn spawn_inline_receive_loops(&self) {
+        let listeners = std::iter::once(&self.inner.listener)
+            .chain(&self.inner.reuse_port_listeners)
+            .cloned();
+        // The last loop to exit reports the transport closed.
+        let running = Arc::new(AtomicUsize::new(self.receive_socket_count()));
+        let handles = listeners
+            .enumerate()
+            .map(|(socket_id, listener)| {
+                let events_tx = self.inner.events_tx.clone();
+                let shard_sink = self.inner.shard_sink.clone();
+                let shutdown_rx = self.inner.shutdown_rx.clone();
+                tokio::spawn(udp_inline_receive_loop(
+                    socket_id,
+                    listener,
+                    events_tx,
+                    shard_sink,
+                    shutdown_rx,
+                    Arc::clone(&running),
+                ))
+            })
+            .collect();
+
+        let mut task_guard = self.inner.receive_tasks.lock().await;
+        *task_guard = handles;
     }
 }
 
-fn enqueue_udp_datagram(
+/// Receive loop of one `SO_REUSEPORT` socket: batch-receive whatever the
+/// socket has ready and parse each datagram on this task. `running` counts
+/// the transport's live loops; the last one out sends `Closed`.
+async fn udp_inline_receive_loop(
+    socket_id: usize,
+    listener: Arc<UdpListener>,
+    events_tx: mpsc::Sender<TransportEvent>,
+    shard_sink: ShardSinkSlot,
+    mut shutdown_rx: tokio::sync::watch::Receiver<bool>,
+    running: Arc<AtomicUsize>,
+) {
+    let local_addr = listener.local_addr().unwrap_or_else(|_| {
+        "0.0.0.0:0"
+            .parse()
+            .expect("hardcoded socket address must parse")
+    });
+    let mut batch = UdpReceiveBatch::new(UDP_RECEIVE_DRAIN_BATCH);
+    let mut last_receive_completed_at: Option<Instant> = None;
+    loop {
+        let receive_poll_started = diagnostics::enabled().then(Instant::now);
+        tokio::select! {
+            _ = shutdown_rx.changed() => {
+                if *shutdown_rx.borrow() {
+                    debug!(socket_id, "UDP receive loop received shutdown signal");
+                    break;
+                }
+            }
+            result = listener.receive_batch(&mut batch) => {
+                match result {
+                    Ok(_) => {
+                        let receive_completed_at = Instant::now();
+                        if let Some(started) = receive_poll_started {
+                            diagnostics::record_udp_receive_poll(
+                                receive_completed_at.duration_since(started),
+                            );
+                        }
+                        for (packet, src) in batch.iter() {
+                            let datagram = received_udp_datagram(
+                                Bytes::copy_from_slice(packet),
+                                src,
+                                local_addr,
+                                receive_completed_at,
+                                &mut last_receive_completed_at,
+                            );
+                            process_udp_datagram(socket_id, datagram, &events_tx, &shard_sink)
+                                .await;
+                        }
+                        if events_tx.is_closed() {
+                            break;
+                        }
+                    }
+                    Err(e) => {
+                        error!(socket_id, "Error receiving UDP packet: {}", e);
+                        let _ = events_tx.try_send(TransportEvent::Error {
+                            error: format!("Error receiving packet: {}", e),
+                        });
+                    }
+                }
+            }
+        }
+    }
+
+    if running.fetch_sub(1, Ordering::AcqRel) == 1 {
+        let _ = events_tx.try_send(TransportEvent::Closed);
+    }
+    info!(socket_id, "UDP receive loop terminated");
+}
+
+/// Record receive diagnostics for one datagram and wrap it for parsing
+fn received_udp_datagram(
     packet: Bytes,
     src: SocketAddr,
     local_addr: SocketAddr,
-    worker_senders: &[mpsc::Sender<UdpDatagram>],
-    dispatch: UdpParseDispatch,
-    round_robin_worker: &AtomicUsize,
     receive_completed_at: Instant,
     last_receive_completed_at: &mut Option<Instant>,
-) -> bool {
+) -> UdpDatagram {
     if let Some(previous) = *last_receive_completed_at {
         diagnostics::record_udp_receive_loop_gap(
             local_addr,
@@ -476,8 +633,7 @@ fn enqueue_udp_datagram(
     diagnostics::record_udp_datagram_received();
     trace!("Received UDP datagram from {}", src);
     let received_at = diagnostics::enabled().then_some(receive_completed_at);
-    let worker_index = udp_worker_index(src, worker_senders.len(), dispatch, round_robin_worker);
-    let datagram = UdpDatagram {
+    UdpDatagram {
         packet,
         source: src,
         local_addr,
@@ -485,7 +641,33 @@ fn enqueue_udp_datagram(
             received_at: Some(received_at),
             ..Default::default()
         }),
-    };
+    }
+}
+
+fn enqueue_udp_datagram(
+    packet: Bytes,
+    src: SocketAddr,
+    local_addr: SocketAddr,
+    worker_senders: &[mpsc::Sender<UdpDatagram>],
+    dispatch: UdpParseDispatch,
+    round_robin_worker: &AtomicUsize,
+    receive_completed_at: Instant,
+    last_receive_completed_at: &mut Option<Instant>,
+) -> bool {
+    let worker_index = udp_worker_index(
+        src,
+        &packet,
+        worker_senders.len(),
+        dispatch,
+        round_robin_worker,
+    );
+    let datagram = received_udp_datagram(
+        packet,
+        src,
+        local_addr,
+        receive_completed_at,
+        last_receive_completed_at,
+    );
     match worker_senders[worker_index].try_send(datagram) {
         Ok(()) => diagnostics::record_udp_worker_queue_enqueued(),
         Err(TrySendError::Full(_)) => {
@@ -509,6 +691,7 @@ async fn udp_parse_worker(
     worker_id: usize,
     mut rx: mpsc::Receiver<UdpDatagram>,
     events_tx: mpsc::Sender<TransportEvent>,
+    shard_sink: ShardSinkSlot,
     mut shutdown_rx: tokio::sync::watch::Receiver<bool>,
 ) {
     loop {
@@ -523,7 +706,7 @@ async fn udp_parse_worker(
                 let Some(datagram) = maybe_datagram else {
                     break;
                 };
-                process_udp_datagram(worker_id, datagram, &events_tx).await;
+                process_udp_datagram(worker_id, datagram, &events_tx, &shard_sink).await;
             }
         }
     }
@@ -534,6 +717,7 @@ async fn process_udp_datagram(
     worker_id: usize,
     mut datagram: UdpDatagram,
     events_tx: &mpsc::Sender<TransportEvent>,
+    shard_sink: &ShardSinkSlot,
 ) {
     debug!("Received SIP message from {}", datagram.source);
     if let Some(timing) = datagram.timing.as_mut() {
@@ -556,13 +740,24 @@ async fn process_udp_datagram(
         Ok(message) => {
             diagnostics::record_udp_parse_ok();
             diagnostics::record_inbound_message(&message, datagram.source, datagram.local_addr);
-            TransportEvent::MessageReceived {
+            let shard = shard_sink.get().map(|sink| {
+                let hash = shard::message_shard_hash(&message).unwrap_or_default();
+                (sink, shard::shard_index(hash, sink.shard_count()))
+            });
+            let event = TransportEvent::MessageReceived {
                 message,
                 source: datagram.source,
                 destination: datagram.local_addr,
                 transport_type: TransportType::Udp,
                 raw_bytes: Some(datagram.packet),
                 timing: datagram.timing,
+            };
+            match shard {
+                Some((sink, shard)) => match sink.deliver(shard, event).await {
+                    Ok(()) => return,
+                    Err(event) => event,
+                },
+                None => event,
             }
         }
         Err(e) => {
@@ -592,6 +787,7 @@ async fn process_udp_datagram(
 
 fn udp_worker_index(
     source: SocketAddr,
+    packet: &[u8],
     worker_count: usize,
     dispatch: UdpParseDispatch,
     round_robin_worker: &AtomicUsize,
@@ -599,8 +795,16 @@ fn udp_worker_index(
     if worker_count <= 1 {
         return 0;
     }
-    if dispatch == UdpParseDispatch::RoundRobin {
-        return round_robin_worker.fetch_add(1, Ordering::Relaxed) % worker_count;
+    match dispatch {
+        UdpParseDispatch::RoundRobin => {
+            return round_robin_worker.fetch_add(1, Ordering::Relaxed) % worker_count;
+        }
+        UdpParseDispatch::TransactionShard => {
+            if let Some(hash) = shard::datagram_shard_hash(packet) {
+                return shard::shard_index(hash, worker_count);
+            }
+        }
+        UdpParseDispatch::SourceHash => {}
     }
     let ip_hash = match source.ip() {
         std::net::IpAddr::V4(ip) => u32::from(ip) as usize,
@@ -625,8 +829,9 @@ impl Transport for UdpTransport {
             return Err(Error::TransportClosed);
         }
 
-        // Convert message to bytes
-        let bytes = message.to_bytes();
+        // Serialize into a pooled buffer; it returns to the pool once sent
+        let mut bytes = self.inner.send_buffers.take();
+        message.write_to(&mut bytes);
 
         debug!("Sending {} byte message to {}", bytes.len(), destination);
         info!(
@@ -690,9 +895,9 @@ impl Transport for UdpTransport {
         let _ = self.inner.shutdown_tx.send(true);
         self.inner.closed.store(true, Ordering::Relaxed);
 
-        // Step 2: Take the receive task handle and wait for it to finish
-        let mut task_guard = self.inner.receive_task.lock().await;
-        if let Some(handle) = task_guard.take() {
+        // Step 2: Take the receive task handles and wait for them to finish
+        let mut task_guard = self.inner.receive_tasks.lock().await;
+        for handle in task_guard.drain(..) {
             debug!("Waiting for UDP receive loop to terminate...");
             // Wait for the task to finish (with timeout to prevent hanging)
             match tokio::time::timeout(std::time::Duration::from_secs(2), handle).await {
@@ -734,6 +939,10 @@ impl Transport for UdpTransport {
     fn max_safe_message_size(&self) -> usize {
         self.inner.safe_max_bytes
     }
+
+    fn attach_shard_sink(&self, sink: Arc<dyn shard::ShardSink>) -> bool {
+        self.inner.shard_sink.set(sink).is_ok()
+    }
 }
 
 impl fmt::Debug for UdpTransport {
@@ -796,13 +1005,135 @@ mod tests {
         transport.close().await.ok();
     }
 
+    #[derive(Debug)]
+    struct ChannelShardSink(Vec<mpsc::Sender<TransportEvent>>);
+
+    #[async_trait::async_trait]
+    impl shard::ShardSink for ChannelShardSink {
+        fn shard_count(&self) -> usize {
+            self.0.len()
+        }
+
+        async fn deliver(
+            &self,
+            shard: usize,
+            event: TransportEvent,
+        ) -> std::result::Result<(), TransportEvent> {
+            self.0[shard].send(event).await.map_err(|e| e.0)
+        }
+    }
+
+    #[tokio::test]
+    async fn attached_shard_sink_receives_messages_on_their_shard() {
+        let (transport, mut rx) = UdpTransport::bind("127.0.0.1:0".parse().unwrap(), None)
+            .await
+            .expect("bind");
+        let (shard_txs, mut shard_rxs): (Vec<_>, Vec<_>) =
+            (0..2).map(|_| mpsc::channel(8)).unzip();
+        assert!(transport.attach_shard_sink(Arc::new(ChannelShardSink(shard_txs))));
+        assert!(!transport.attach_shard_sink(Arc::new(ChannelShardSink(Vec::new()))));
+
+        let branch = "z9hG4bKsharded";
+        let sender = tokio::net::UdpSocket::bind("127.0.0.1:0").await.unwrap();
+        let message = format!(
+            "OPTIONS sip:bob@127.0.0.1 SIP/2.0\r\n\
+             Via: SIP/2.0/UDP 127.0.0.1;branch={branch}\r\n\
+             Max-Forwards: 70\r\n\
+             To: <sip:bob@127.0.0.1>\r\n\
+             From: <sip:alice@127.0.0.1>;tag=sharded\r\n\
+             Call-ID: sharded@127.0.0.1\r\n\
+             CSeq: 1 OPTIONS\r\n\
+             Content-Length: 0\r\n\r\n"
+        );
+        sender
+            .send_to(message.as_bytes(), transport.local_addr().unwrap())
+            .await
+            .unwrap();
+
+        let shard = shard::shard_index(shard::branch_shard_hash(branch.as_bytes()), 2);
+        let event = tokio::time::timeout(
+            std::time::Duration::from_secs(5),
+            shard_rxs[shard].recv(),
+        )
+        .await
+        .expect("datagram within timeout")
+        .expect("shard channel open");
+        assert!(matches!(event, TransportEvent::MessageReceived { .. }));
+        assert!(rx.try_recv().is_err());
+        transport.close().await.ok();
+    }
+
+    #[tokio::test]
+    async fn reuse_port_sockets_receive_and_parse_every_flow() {
+        let options = UdpSocketOptions::default().with_receive_sockets(4);
+        let (transport, mut rx) =
+            UdpTransport::bind_with_socket_options("127.0.0.1:0".parse().unwrap(), None, options)
+                .await
+                .expect("bind with receive sockets");
+        assert_eq!(
+            transport.receive_socket_count(),
+            options.effective_receive_sockets()
+        );
+        let addr = transport.local_addr().unwrap();
+
+        // Many source ports so the kernel spreads flows across sockets.
+        let mut senders = Vec::new();
+        for i in 0..16 {
+            let sender = tokio::net::UdpSocket::bind("127.0.0.1:0").await.unwrap();
+            let message = format!(
+                "OPTIONS sip:bob@127.0.0.1 SIP/2.0\r\n\
+                 Via: SIP/2.0/UDP 127.0.0.1;branch=z9hG4bKreuse{i}\r\n\
+                 Max-Forwards: 70\r\n\
+                 To: <sip:bob@127.0.0.1>\r\n\
+                 From: <sip:alice@127.0.0.1>;tag=reuse{i}\r\n\
+                 Call-ID: reuse{i}@127.0.0.1\r\n\
+                 CSeq: 1 OPTIONS\r\n\
+                 Content-Length: 0\r\n\r\n"
+            );
+            sender.send_to(message.as_bytes(), addr).await.unwrap();
+            senders.push(sender);
+        }
+
+        let mut sources = std::collections::HashSet::new();
+        while sources.len() < senders.len() {
+            let event = tokio::time::timeout(std::time::Duration::from_secs(5), rx.recv())
+                .await
+                .expect("datagram within timeout")
+                .expect("event channel open");
+            if let TransportEvent::MessageReceived {
+                source,
+                destination,
+                ..
+            } = event
+            {
+                assert_eq!(destination, addr);
+                sources.insert(source);
+            }
+        }
+        transport.close().await.ok();
+
+        // One shutdown reports Closed as often as a single-socket
+        // transport does, however many receive loops there were.
+        let (single, mut single_rx) = UdpTransport::bind("127.0.0.1:0".parse().unwrap(), None)
+            .await
+            .expect("bind single socket");
+        single.close().await.ok();
+        assert_eq!(count_closed(&mut rx), count_closed(&mut single_rx));
+    }
+
+    fn count_closed(rx: &mut mpsc::Receiver<TransportEvent>) -> usize {
+        std::iter::from_fn(|| rx.try_recv().ok())
+            .filter(|event| matches!(event, TransportEvent::Closed))
+            .count()
+    }
+
     #[test]
     fn round_robin_worker_index_cycles_across_workers() {
         let round_robin = AtomicUsize::new(0);
         let source = "127.0.0.1:5060".parse().unwrap();
 
         let observed: Vec<usize> = (0..8)
-            .map(|_| udp_worker_index(source, 4, UdpParseDispatch::RoundRobin, &round_robin))
+            .map(|_| udp_worker_index(source, b"", 4, UdpParseDispatch::RoundRobin, &round_robin))
             .collect();
 
         assert_eq!(observed, vec![0, 1, 2, 3, 0, 1, 2, 3]);
@@ -813,12 +1144,56 @@ mod tests {
         let round_robin = AtomicUsize::new(0);
         let source = "127.0.0.1:5060".parse().unwrap();
 
-        let first = udp_worker_index(source, 4, UdpParseDispatch::SourceHash, &round_robin);
+        let first = udp_worker_index(source, b"", 4, UdpParseDispatch::SourceHash, &round_robin);
         for _ in 0..8 {
             assert_eq!(
-                udp_worker_index(source, 4, UdpParseDispatch::SourceHash, &round_robin),
+                udp_worker_index(source, b"", 4, UdpParseDispatch::SourceHash, &round_robin),
                 first
             );
         }
     }
+
+    #[test]
+    fn transaction_worker_index_matches_transaction_shard() {
+        let round_robin = AtomicUsize::new(0);
+        let packet = b"BYE sip:bob@127.0.0.1 SIP/2.0\r\n\
+            Via: SIP/2.0/UDP 127.0.0.1:5070;branch=z9hG4bK3848276298\r\n\
+            Call-ID: 3848276298220188511@127.0.0.1\r\n\
+            Content-Length: 0\r\n\r\n";
+        let expected = shard::shard_index(shard::branch_shard_hash(b"z9hG4bK3848276298"), 4);
+
+        // A transaction lands on the same worker whatever port it came from.
+        for port in 5060..5068 {
+            let source = SocketAddr::from(([127, 0, 0, 1], port));
+            assert_eq!(
+                udp_worker_index(
+                    source,
+                    packet,
+                    4,
+                    UdpParseDispatch::TransactionShard,
+                    &round_robin
+                ),
+                expected
+            );
+        }
+
+        // Without a branch the source hash is used.
+        let source = "127.0.0.1:5060".parse().unwrap();
+        assert_eq!(
+            udp_worker_index(
+                source,
+                b"\r\n",
+                4,
+                UdpParseDispatch::TransactionShard,
+                &round_robin
+            ),
+            udp_worker_index(
+                source,
+                b"\r\n",
+                4,
+                UdpParseDispatch::SourceHash,
+                &round_robin
+            )
+        );
+    }
 }
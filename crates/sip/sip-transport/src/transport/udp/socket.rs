@@ -3,16 +3,41 @@ use std::net::{SocketAddr, UdpSocket as StdUdpSocket};
 
 use socket2::{Domain, Protocol, Socket, Type};
 
+/// Maximum number of receive sockets one UDP transport binds.
+pub const MAX_RECEIVE_SOCKETS: usize = 64;
+
+/// Whether this platform lets several UDP sockets share one address with
+/// the kernel spreading datagrams across them: `SO_REUSEPORT` on Linux,
+/// `SO_REUSEPORT_LB` on FreeBSD. macOS and the other BSDs accept
+/// `SO_REUSEPORT` but deliver unicast datagrams to a single socket, so
+/// they bind one.
+pub(crate) const REUSE_PORT_SUPPORTED: bool = cfg!(any(target_os = "linux", target_os = "freebsd"));
+
 /// Optional UDP socket sizing applied before bind.
 ///
 /// Defaults preserve platform behavior. Server deployments can set these when
 /// expected call bursts exceed the OS default UDP queue depth.
-#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
 pub struct UdpSocketOptions {
     /// Requested `SO_RCVBUF` size in bytes.
     pub recv_buffer_size: Option<usize>,
     /// Requested `SO_SNDBUF` size in bytes.
     pub send_buffer_size: Option<usize>,
+    /// Number of sockets bound to the address with `SO_REUSEPORT`.
+    ///
+    /// With more than one, the kernel hashes each flow onto one of the
+    /// sockets and every socket has its own receive loop that parses
+    /// inline, so receive work spreads across runtime threads. `1` (the
+    /// default) binds a single socket whose receive loop feeds the parse
+    /// workers. Only Linux and FreeBSD balance unicast datagrams across
+    /// such sockets; elsewhere one socket is always bound.
+    pub receive_sockets: usize,
+}
+
+impl Default for UdpSocketOptions {
+    fn default() -> Self {
+        Self::new(None, None)
+    }
 }
 
 impl UdpSocketOptions {
@@ -21,6 +46,24 @@ impl UdpSocketOptions {
         Self {
             recv_buffer_size,
             send_buffer_size,
+            receive_sockets: 1,
+        }
+    }
+
+    /// Return these options with a different receive socket count.
+    pub const fn with_receive_sockets(mut self, receive_sockets: usize) -> Self {
+        self.receive_sockets = receive_sockets;
+        self
+    }
+
+    /// Receive sockets the transport actually binds: the requested count
+    /// clamped to `1..=MAX_RECEIVE_SOCKETS`, or one where the kernel does
+    /// not balance datagrams across reuse-port sockets.
+    pub fn effective_receive_sockets(&self) -> usize {
+        if REUSE_PORT_SUPPORTED {
+            self.receive_sockets.clamp(1, MAX_RECEIVE_SOCKETS)
+        } else {
+            1
         }
     }
 }
@@ -48,6 +91,16 @@ pub(crate) fn bind_std_udp_socket(
     // (e.g. re-login after a failed REGISTER) can race the OS socket release
     // and fail with EADDRINUSE.
     socket.set_reuse_address(true)?;
+    // Every socket sharing the address needs the option before bind, the
+    // first one included.
+    #[cfg(target_os = "linux")]
+    if options.effective_receive_sockets() > 1 {
+        socket.set_reuse_port(true)?;
+    }
+    #[cfg(target_os = "freebsd")]
+    if options.effective_receive_sockets() > 1 {
+        socket.set_reuse_port_lb(true)?;
+    }
     socket.bind(&addr.into())?;
     socket.set_nonblocking(true)?;
     Ok(socket.into())
@@ -82,4 +135,37 @@ mod tests {
             bind_std_udp_socket(addr, UdpSocketOptions::default()).expect("rebind same port");
         assert_eq!(rebind.local_addr().unwrap().port(), addr.port());
     }
+
+    #[test]
+    fn receive_sockets_share_one_port() {
+        let options = UdpSocketOptions::default().with_receive_sockets(4);
+        if options.effective_receive_sockets() == 1 {
+            return;
+        }
+        let first = bind_std_udp_socket("127.0.0.1:0".parse().unwrap(), options)
+            .expect("bind first receive socket");
+        let addr = first.local_addr().unwrap();
+        let others: Vec<_> = (1..4)
+            .map(|_| bind_std_udp_socket(addr, options).expect("bind shared receive socket"))
+            .collect();
+        for socket in &others {
+            assert_eq!(socket.local_addr().unwrap(), addr);
+        }
+    }
+
+    #[test]
+    fn receive_socket_count_is_clamped() {
+        let options = UdpSocketOptions::default();
+        assert_eq!(options.receive_sockets, 1);
+        assert_eq!(
+            options.with_receive_sockets(0).effective_receive_sockets(),
+            1
+        );
+        assert!(
+            options
+                .with_receive_sockets(MAX_RECEIVE_SOCKETS * 2)
+                .effective_receive_sockets()
+                <= MAX_RECEIVE_SOCKETS
+        );
+    }
 }
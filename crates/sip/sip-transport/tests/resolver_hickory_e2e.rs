@@ -1,7 +1,8 @@
 //! RFC 3263 end-to-end smoke: run a real `hickory-server` authoritative
 //! DNS instance bound to `127.0.0.1:0` with a fixture zone, point
 //! `HickoryResolver` at it, and verify the NAPTR → SRV → A ladder
-//! produces the expected ordered candidate list.
+//! produces the expected ordered candidate list, and that
+//! `CachingResolver` serves repeat lookups without going back to DNS.
 
 #![cfg(feature = "dns")]
 
@@ -17,7 +18,7 @@ use hickory_server::store::in_memory::InMemoryZoneHandler;
 use hickory_server::zone_handler::{AxfrPolicy, Catalog, ZoneHandler, ZoneType};
 use hickory_server::Server;
 use rvoip_sip_core::Uri;
-use rvoip_sip_transport::resolver::{HickoryResolver, Resolver};
+use rvoip_sip_transport::resolver::{CachingResolver, HickoryResolver, Resolver, ResolverError};
 use rvoip_sip_transport::transport::TransportType;
 use tokio::net::UdpSocket;
 
@@ -172,3 +173,37 @@ async fn hickory_client_resolves_naptr_then_srv_then_a() {
 
     server.abort();
 }
+
+#[tokio::test]
+async fn caching_resolver_serves_repeat_lookups_from_cache() {
+    let (_addr, resolver, server) = spin_up_fixture().await;
+    let cache = CachingResolver::new(Arc::new(resolver));
+
+    let uri = Uri::from_str("sip:example.test").unwrap();
+    let first = cache.resolve(&uri).await.expect("first lookup");
+    assert!(!first.is_empty());
+    assert!(
+        first.iter().all(|c| c.expires.is_some()),
+        "DNS-backed candidates must carry a TTL deadline — got {:?}",
+        first
+    );
+
+    // A name the zone does not have is cached negatively.
+    let missing = Uri::from_str("sip:missing.example.test").unwrap();
+    let err = cache.resolve(&missing).await.unwrap_err();
+    assert!(
+        matches!(err, ResolverError::NoCandidates),
+        "expected NoCandidates, got {err:?}"
+    );
+
+    // With the DNS server gone, both answers still come from the cache.
+    server.abort();
+    let _ = server.await;
+    let second = cache.resolve(&uri).await.expect("cached lookup");
+    assert_eq!(first, second);
+    assert!(matches!(
+        cache.resolve(&missing).await,
+        Err(ResolverError::NoCandidates)
+    ));
+    assert_eq!(cache.len(), 2);
+}